@@ -93,3 +93,136 @@ int db__driver_commit_transaction(void)
 
     return DB_OK;
 }
+
+int db__driver_prepare(dbPrepared *prepared)
+{
+    PGresult *res;
+    dbString sql;
+    const char *s;
+    char quote, buf[32], *name;
+    int n;
+    static int count = 0;
+
+    /* replace '?' parameter markers by $1, $2, ... */
+    db_init_string(&sql);
+    quote = '\0';
+    n = 0;
+    buf[1] = '\0';
+    for (s = db_get_string(&prepared->sql); *s; s++) {
+        if (quote) {
+            if (*s == quote)
+                quote = '\0';
+        }
+        else if (*s == '\'' || *s == '"')
+            quote = *s;
+        else if (*s == '?') {
+            snprintf(buf, sizeof(buf), "$%d", ++n);
+            db_append_string(&sql, buf);
+            buf[1] = '\0';
+            continue;
+        }
+        buf[0] = *s;
+        db_append_string(&sql, buf);
+    }
+
+    if (n != prepared->nparams) {
+        db_d_append_error(_("Statement has %d parameters, %d expected"), n,
+                          prepared->nparams);
+        db_d_report_error();
+        db_free_string(&sql);
+        return DB_FAILED;
+    }
+
+    G_asprintf(&name, "grass_stmt_%d", ++count);
+    G_debug(3, "db__driver_prepare(): %s: '%s'", name, db_get_string(&sql));
+
+    res = PQprepare(pg_conn, name, db_get_string(&sql), n, NULL);
+
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        db_d_append_error("%s\n%s\n%s", _("Unable to prepare:"),
+                          db_get_string(&sql), PQerrorMessage(pg_conn));
+        db_d_report_error();
+        PQclear(res);
+        db_free_string(&sql);
+        G_free(name);
+        return DB_FAILED;
+    }
+
+    PQclear(res);
+    db_free_string(&sql);
+    prepared->data = name;
+
+    return DB_OK;
+}
+
+int db__driver_execute_prepared(dbPrepared *prepared)
+{
+    PGresult *res;
+    const char **values;
+    char *buf;
+    dbValue *value;
+    int i, stat;
+
+    values = (const char **)G_calloc(prepared->nparams + 1, sizeof(char *));
+    buf = (char *)G_calloc(prepared->nparams + 1, 32);
+
+    /* parameters are passed in text format */
+    for (i = 0; i < prepared->nparams; i++) {
+        value = &prepared->value[i];
+        if (value->isNull)
+            values[i] = NULL;
+        else if (prepared->ctype[i] == DB_C_TYPE_INT) {
+            snprintf(buf + 32 * i, 32, "%d", value->i);
+            values[i] = buf + 32 * i;
+        }
+        else if (prepared->ctype[i] == DB_C_TYPE_DOUBLE) {
+            snprintf(buf + 32 * i, 32, "%.17g", value->d);
+            values[i] = buf + 32 * i;
+        }
+        else
+            values[i] = db_get_string(&value->s);
+    }
+
+    res = PQexecPrepared(pg_conn, (char *)prepared->data, prepared->nparams,
+                         values, NULL, NULL, 0);
+
+    stat = DB_OK;
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        db_d_append_error("%s\n%s\n%s", _("Unable to execute:"),
+                          db_get_string(&prepared->sql),
+                          PQerrorMessage(pg_conn));
+        db_d_report_error();
+        stat = DB_FAILED;
+    }
+
+    PQclear(res);
+    G_free(values);
+    G_free(buf);
+
+    return stat;
+}
+
+int db__driver_close_prepared(dbPrepared *prepared)
+{
+    PGresult *res;
+    char *sql;
+    int stat;
+
+    G_asprintf(&sql, "DEALLOCATE %s", (char *)prepared->data);
+    res = PQexec(pg_conn, sql);
+
+    stat = DB_OK;
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        db_d_append_error("%s\n%s\n%s", _("Unable to execute:"), sql,
+                          PQerrorMessage(pg_conn));
+        db_d_report_error();
+        stat = DB_FAILED;
+    }
+
+    PQclear(res);
+    G_free(sql);
+    G_free(prepared->data);
+    prepared->data = NULL;
+
+    return stat;
+}
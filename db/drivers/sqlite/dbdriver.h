@@ -17,6 +17,9 @@
         db_driver_execute_immediate = db__driver_execute_immediate;   \
         db_driver_begin_transaction = db__driver_begin_transaction;   \
         db_driver_commit_transaction = db__driver_commit_transaction; \
+        db_driver_prepare = db__driver_prepare;                       \
+        db_driver_execute_prepared = db__driver_execute_prepared;     \
+        db_driver_close_prepared = db__driver_close_prepared;         \
         db_driver_fetch = db__driver_fetch;                           \
         db_driver_get_num_rows = db__driver_get_num_rows;             \
         db_driver_create_index = db__driver_create_index;             \
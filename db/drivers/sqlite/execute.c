@@ -135,3 +135,113 @@ int db__driver_commit_transaction(void)
 
     return DB_OK;
 }
+
+/**
+ * \fn int db__driver_prepare (dbPrepared *prepared)
+ *
+ * \brief Low level SQLite prepare statement for bulk execution.
+ *
+ * \param[in,out] prepared prepared statement, data is set to sqlite3_stmt
+ * \return int DB_FAILED on error; DB_OK on success
+ */
+
+int db__driver_prepare(dbPrepared *prepared)
+{
+    int ret;
+    sqlite3_stmt *stmt;
+
+    G_debug(3, "prepare: %s", db_get_string(&prepared->sql));
+
+    ret = sqlite3_prepare_v2(sqlite, db_get_string(&prepared->sql), -1, &stmt,
+                             NULL);
+
+    if (ret != SQLITE_OK) {
+        db_d_append_error("%s\n%s", _("Error in sqlite3_prepare():"),
+                          (char *)sqlite3_errmsg(sqlite));
+        db_d_report_error();
+        return DB_FAILED;
+    }
+
+    if (sqlite3_bind_parameter_count(stmt) != prepared->nparams) {
+        db_d_append_error(_("Statement has %d parameters, %d expected"),
+                          sqlite3_bind_parameter_count(stmt),
+                          prepared->nparams);
+        db_d_report_error();
+        sqlite3_finalize(stmt);
+        return DB_FAILED;
+    }
+
+    prepared->data = stmt;
+
+    return DB_OK;
+}
+
+/**
+ * \fn int db__driver_execute_prepared (dbPrepared *prepared)
+ *
+ * \brief Low level SQLite execute prepared statement with current values.
+ *
+ * \param[in] prepared prepared statement
+ * \return int DB_FAILED on error; DB_OK on success
+ */
+
+int db__driver_execute_prepared(dbPrepared *prepared)
+{
+    int i, ret;
+    sqlite3_stmt *stmt;
+    dbValue *value;
+
+    stmt = (sqlite3_stmt *)prepared->data;
+
+    for (i = 0; i < prepared->nparams; i++) {
+        value = &prepared->value[i];
+        if (value->isNull)
+            ret = sqlite3_bind_null(stmt, i + 1);
+        else if (prepared->ctype[i] == DB_C_TYPE_INT)
+            ret = sqlite3_bind_int(stmt, i + 1, value->i);
+        else if (prepared->ctype[i] == DB_C_TYPE_DOUBLE)
+            ret = sqlite3_bind_double(stmt, i + 1, value->d);
+        else
+            /* value is kept until the statement is reset */
+            ret = sqlite3_bind_text(stmt, i + 1, db_get_string(&value->s), -1,
+                                    SQLITE_STATIC);
+
+        if (ret != SQLITE_OK) {
+            db_d_append_error("%s\n%s", _("Error in sqlite3_bind():"),
+                              (char *)sqlite3_errmsg(sqlite));
+            db_d_report_error();
+            sqlite3_reset(stmt);
+            return DB_FAILED;
+        }
+    }
+
+    sqlite3_step(stmt);
+    /* get real result code */
+    ret = sqlite3_reset(stmt);
+
+    if (ret != SQLITE_OK) {
+        db_d_append_error("%s\n%s", _("Error in sqlite3_step():"),
+                          (char *)sqlite3_errmsg(sqlite));
+        db_d_report_error();
+        return DB_FAILED;
+    }
+
+    return DB_OK;
+}
+
+/**
+ * \fn int db__driver_close_prepared (dbPrepared *prepared)
+ *
+ * \brief Low level SQLite finalize prepared statement.
+ *
+ * \param[in] prepared prepared statement
+ * \return int DB_FAILED on error; DB_OK on success
+ */
+
+int db__driver_close_prepared(dbPrepared *prepared)
+{
+    sqlite3_finalize((sqlite3_stmt *)prepared->data);
+    prepared->data = NULL;
+
+    return DB_OK;
+}
@@ -0,0 +1,30 @@
+/***********************************************************
+ *
+ * MODULE:       SQLite driver
+ *
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Entry point of in-process driver
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ *
+ **************************************************************/
+
+#include <grass/gis.h>
+#include <grass/dbmi.h>
+#include "globals.h"
+#include "dbdriver.h"
+
+/* called by db_start_driver() after loading libsqlite into the client */
+int db_driver_local_main(void)
+{
+    char *argv[] = {"sqlite", NULL};
+
+    init_dbdriver();
+
+    return db_driver_local(1, argv);
+}
@@ -5,7 +5,7 @@
  * PURPOSE:      Calculate Broadband Albedo (0.3-3 Micrometers)
  *               from Surface Reflectance (Modis, AVHRR, Landsat, Aster).
  *
- * COPYRIGHT:    (C) 2004-2014 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2004-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU Lesser General
  *               Public License. Read the file COPYING that comes with GRASS
@@ -37,13 +37,60 @@ double bb_alb_noaa(double redchan, double nirchan);
 double bb_alb_modis(double redchan, double nirchan, double chan3, double chan4,
                     double chan5, double chan6, double chan7);
 
+enum { MODIS, AVHRR, LANDSAT, LANDSAT8, ASTER };
+
+/* broad band albedo of one row, before the histogram stretch */
+static void albedo_row(void **inrast, const RASTER_MAP_TYPE *in_data_type,
+                       int nfiles, int ncols, int sensor, DCELL *outrast)
+{
+    DCELL de;
+    DCELL d[MAXFILES];
+    int i, col;
+
+    for (col = 0; col < ncols; col++) {
+        for (i = 1; i <= nfiles; i++) {
+            switch (in_data_type[i]) {
+            case CELL_TYPE:
+                d[i] = (double)((CELL *)inrast[i])[col];
+                break;
+            case FCELL_TYPE:
+                d[i] = (double)((FCELL *)inrast[i])[col];
+                break;
+            case DCELL_TYPE:
+                d[i] = (double)((DCELL *)inrast[i])[col];
+                break;
+            }
+        }
+        switch (sensor) {
+        case MODIS:
+            de = bb_alb_modis(d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
+            break;
+        case AVHRR:
+            de = bb_alb_noaa(d[1], d[2]);
+            break;
+        case LANDSAT:
+            de = bb_alb_landsat(d[1], d[2], d[3], d[4], d[5], d[6]);
+            break;
+        case LANDSAT8:
+            de = bb_alb_landsat8(d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
+            break;
+        case ASTER:
+            de = bb_alb_aster(d[1], d[2], d[3], d[4], d[5], d[6]);
+            break;
+        default:
+            Rast_set_d_null_value(&de, 1);
+        }
+        outrast[col] = de;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     struct Cell_head cellhd; /*region+header info */
     int nrows, ncols;
-    int row, col;
+    int row, col, row0, nbuf, block_rows, nprocs;
     struct GModule *module;
-    struct Option *input, *output;
+    struct Option *input, *output, *opt_nprocs;
     struct Flag *flag1, *flag2, *flag3;
     struct Flag *flag4, *flag5, *flag6;
     struct Flag *flag7;
@@ -60,10 +107,9 @@ int main(int argc, char *argv[])
     int outfd;
     char **ptr;
     int i = 0;
-    int modis = 0, aster = 0, avhrr = 0;
-    int landsat = 0, landsat8 = 0;
-    void *inrast[MAXFILES];
-    unsigned char *outrast;
+    int sensor = -1;
+    void **inrast;
+    DCELL **outrast;
 
     RASTER_MAP_TYPE in_data_type[MAXFILES]; /* 0=numbers  1=text */
     RASTER_MAP_TYPE out_data_type = DCELL_TYPE;
@@ -100,6 +146,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("ASTER"));
     G_add_keyword(_("AVHRR"));
     G_add_keyword(_("MODIS"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Computes broad band albedo from surface reflectance.");
 
@@ -110,6 +157,8 @@ int main(int argc, char *argv[])
 
     output = G_define_standard_option(G_OPT_R_OUTPUT);
 
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /* Define the different flags */
 
     flag1 = G_define_flag();
@@ -156,11 +205,21 @@ int main(int argc, char *argv[])
 
     result = output->answer;
 
-    modis = (flag1->answer);
-    avhrr = (flag2->answer);
-    landsat = (flag3->answer);
-    landsat8 = (flag4->answer);
-    aster = (flag5->answer);
+    if (flag1->answer)
+        sensor = MODIS;
+    else if (flag2->answer)
+        sensor = AVHRR;
+    else if (flag3->answer)
+        sensor = LANDSAT;
+    else if (flag4->answer)
+        sensor = LANDSAT8;
+    else if (flag5->answer)
+        sensor = ASTER;
+
+    nprocs = G_set_omp_num_threads(opt_nprocs);
+    /* rows read at once and processed in parallel */
+    block_rows = 4 * nprocs;
+    inrast = G_calloc((size_t)block_rows * MAXFILES, sizeof(void *));
 
     for (; *ptr != NULL; ptr++) {
         if (nfiles >= MAXFILES)
@@ -173,7 +232,9 @@ int main(int argc, char *argv[])
 
         Rast_get_cellhd(name, "", &cellhd);
 
-        inrast[nfiles] = Rast_allocate_buf(in_data_type[nfiles]);
+        for (row = 0; row < block_rows; row++)
+            inrast[row * MAXFILES + nfiles] =
+                Rast_allocate_buf(in_data_type[nfiles]);
         nfiles++;
     }
     nfiles--;
@@ -183,7 +244,9 @@ int main(int argc, char *argv[])
     /* Allocate output buffer, use input map data_type */
     nrows = Rast_window_rows();
     ncols = Rast_window_cols();
-    outrast = Rast_allocate_buf(out_data_type);
+    outrast = G_malloc(block_rows * sizeof(DCELL *));
+    for (row = 0; row < block_rows; row++)
+        outrast[row] = Rast_allocate_buf(out_data_type);
 
     /* Create New raster files */
     outfd = Rast_open_new(result, 1);
@@ -195,60 +258,51 @@ int main(int argc, char *argv[])
         histogram[i] = 0;
 
     if (flag6->answer || flag7->answer) {
-        DCELL de;
-        DCELL d[MAXFILES];
-
         /* Process pixels histogram */
-        for (row = 0; row < nrows; row++) {
-            G_percent(row, nrows, 2);
-            /* read input map */
-            for (i = 1; i <= nfiles; i++)
-                Rast_get_row(infd[i], inrast[i], row, in_data_type[i]);
+        for (row0 = 0; row0 < nrows; row0 += block_rows) {
+            G_percent(row0, nrows, 2);
+
+            nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
+
+            /* read input map, reading rows is not thread-safe */
+            for (row = 0; row < nbuf; row++)
+                for (i = 1; i <= nfiles; i++)
+                    Rast_get_row(infd[i], inrast[row * MAXFILES + i],
+                                 row0 + row, in_data_type[i]);
 
             /*process the data */
-            for (col = 0; col < ncols; col++) {
-                for (i = 1; i <= nfiles; i++) {
-                    switch (in_data_type[i]) {
-                    case CELL_TYPE:
-                        d[i] = (double)((CELL *)inrast[i])[col];
-                        break;
-                    case FCELL_TYPE:
-                        d[i] = (double)((FCELL *)inrast[i])[col];
-                        break;
-                    case DCELL_TYPE:
-                        d[i] = (double)((DCELL *)inrast[i])[col];
-                        break;
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1) private(i)
+            {
+                int temp, row_histogram[100];
+
+                for (i = 0; i < 100; i++)
+                    row_histogram[i] = 0;
+
+#pragma omp for schedule(dynamic)
+                for (row = 0; row < nbuf; row++) {
+                    int c;
+
+                    albedo_row(&inrast[row * MAXFILES], in_data_type, nfiles,
+                               ncols, sensor, outrast[row]);
+                    for (c = 0; c < ncols; c++) {
+                        if (Rast_is_d_null_value(&outrast[row][c])) {
+                            /*Do nothing */
+                        }
+                        else {
+                            temp = (int)(outrast[row][c] * 100);
+                            if (temp > 0 && temp < 100) {
+                                row_histogram[temp]++;
+                            }
+                        }
                     }
                 }
-                if (modis) {
-                    de = bb_alb_modis(d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
-                }
-                else if (avhrr) {
-                    de = bb_alb_noaa(d[1], d[2]);
-                }
-                else if (landsat) {
-                    de = bb_alb_landsat(d[1], d[2], d[3], d[4], d[5], d[6]);
-                }
-                else if (landsat8) {
-                    de = bb_alb_landsat8(d[1], d[2], d[3], d[4], d[5], d[6],
-                                         d[7]);
-                }
-                else if (aster) {
-                    de = bb_alb_aster(d[1], d[2], d[3], d[4], d[5], d[6]);
-                }
-                if (Rast_is_d_null_value(&de)) {
-                    /*Do nothing */
-                }
-                else {
-                    int temp;
 
-                    temp = (int)(de * 100);
-                    if (temp > 0) {
-                        histogram[temp] = histogram[temp] + 1.0;
-                    }
-                }
+#pragma omp critical
+                for (i = 0; i < 100; i++)
+                    histogram[i] += row_histogram[i];
             }
         }
+        G_percent(1, 1, 1);
 
         G_message("Calculating histogram of albedo");
 
@@ -354,57 +408,43 @@ int main(int argc, char *argv[])
     /* End of processing histogram */
 
     /* Process pixels */
-    for (row = 0; row < nrows; row++) {
-        DCELL de;
-        DCELL d[MAXFILES];
+    for (row0 = 0; row0 < nrows; row0 += block_rows) {
+        G_percent(row0, nrows, 2);
+
+        nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
 
-        G_percent(row, nrows, 2);
-        /* read input map */
-        for (i = 1; i <= nfiles; i++)
-            Rast_get_row(infd[i], inrast[i], row, in_data_type[i]);
+        /* read input map, reading rows is not thread-safe */
+        for (row = 0; row < nbuf; row++)
+            for (i = 1; i <= nfiles; i++)
+                Rast_get_row(infd[i], inrast[row * MAXFILES + i], row0 + row,
+                             in_data_type[i]);
 
         /*process the data */
-        for (col = 0; col < ncols; col++) {
-            for (i = 1; i <= nfiles; i++) {
-                switch (in_data_type[i]) {
-                case CELL_TYPE:
-                    d[i] = (double)((CELL *)inrast[i])[col];
-                    break;
-                case FCELL_TYPE:
-                    d[i] = (double)((FCELL *)inrast[i])[col];
-                    break;
-                case DCELL_TYPE:
-                    d[i] = (double)((DCELL *)inrast[i])[col];
-                    break;
-                }
-            }
-            if (modis) {
-                de = bb_alb_modis(d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
-            }
-            else if (avhrr) {
-                de = bb_alb_noaa(d[1], d[2]);
-            }
-            else if (landsat) {
-                de = bb_alb_landsat(d[1], d[2], d[3], d[4], d[5], d[6]);
-            }
-            else if (landsat8) {
-                de = bb_alb_landsat8(d[1], d[2], d[3], d[4], d[5], d[6], d[7]);
-            }
-            else if (aster) {
-                de = bb_alb_aster(d[1], d[2], d[3], d[4], d[5], d[6]);
-            }
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic) private(col)
+        for (row = 0; row < nbuf; row++) {
+            albedo_row(&inrast[row * MAXFILES], in_data_type, nfiles, ncols,
+                       sensor, outrast[row]);
             if (flag6->answer || flag7->answer) {
                 /* Post-Process Albedo */
-                de = a * de + b;
+                for (col = 0; col < ncols; col++)
+                    outrast[row][col] = a * outrast[row][col] + b;
             }
-            ((DCELL *)outrast)[col] = de;
         }
-        Rast_put_row(outfd, outrast, out_data_type);
+
+        for (row = 0; row < nbuf; row++)
+            Rast_put_row(outfd, outrast[row], out_data_type);
     }
+    G_percent(1, 1, 1);
+
     for (i = 1; i <= nfiles; i++) {
-        G_free(inrast[i]);
+        for (row = 0; row < block_rows; row++)
+            G_free(inrast[row * MAXFILES + i]);
         Rast_close(infd[i]);
     }
+    G_free(inrast);
+    for (row = 0; row < block_rows; row++)
+        G_free(outrast[row]);
     G_free(outrast);
     Rast_close(outfd);
 
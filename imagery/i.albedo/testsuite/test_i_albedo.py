@@ -125,6 +125,32 @@ class TestIAlbedo(TestCase):
             msg="Aggressive mode should shift the mean",
         )
 
+    def test_aggressive_mode_nprocs(self):
+        """Histogram stretch must not depend on the number of threads."""
+        bands = [f"test_b{i}" for i in [1, 2, 3, 4, 5, 7]]
+        self.runModule("g.region", rows=100, cols=100)
+        for idx, band in enumerate(bands):
+            self.runModule(
+                "r.mapcalc",
+                expression=f"{band}=0.1*({idx + 1})+rand(0,0.15)",
+                seed=42,
+                overwrite=True,
+            )
+        for nprocs in (1, 4):
+            self.assertModule(
+                "i.albedo",
+                input=",".join(bands),
+                output=f"test_albedo_nprocs_{nprocs}",
+                flags="lc",
+                nprocs=nprocs,
+                overwrite=True,
+            )
+        self.assertRastersNoDifference(
+            actual="test_albedo_nprocs_4",
+            reference="test_albedo_nprocs_1",
+            precision=0,
+        )
+
     def test_linearity(self):
         """Validate linear reflectance scaling by comparing that doubled input results to doubled output expectations."""
 
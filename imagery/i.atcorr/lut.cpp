@@ -0,0 +1,239 @@
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+extern "C" {
+#include <grass/gis.h>
+#include <grass/glocale.h>
+}
+
+#include "6s.h"
+#include "lut.h"
+
+TILut::TILut(bool use_alt, bool use_vis, double alt_min, double alt_max,
+             double vis_min, double vis_max)
+    : use_alt(use_alt), use_vis(use_vis), alt0(0), nalt(1), vis0(0),
+      nvis(1), ncomputed(0)
+{
+    if (use_alt) {
+        alt0 = (int)floor(alt_min / BIN_ALT);
+        nalt = (int)ceil(alt_max / BIN_ALT) - alt0 + 1;
+    }
+    if (use_vis) {
+        /* negative visibility is set to 0 */
+        vis0 = (int)floor((vis_min > 0 ? vis_min : 0) / BIN_VIS);
+        nvis = (int)ceil((vis_max > 0 ? vis_max : 0) / BIN_VIS) - vis0 + 1;
+    }
+    if (nalt < 1)
+        nalt = 1;
+    if (nvis < 1)
+        nvis = 1;
+
+    index.assign((size_t)nalt * nvis, -1);
+}
+
+/* node i before position x and weight t of the next node */
+void TILut::locate(double x, int n, int &i, double &t)
+{
+    if (!(x > 0)) {
+        i = 0;
+        t = 0;
+    }
+    else if (x >= n - 1) {
+        i = n - 1;
+        t = 0;
+    }
+    else {
+        i = (int)x;
+        t = x - i;
+    }
+}
+
+void TILut::require_node(int i, int j)
+{
+    int &k = index[(size_t)i * nvis + j];
+
+    if (k >= 0)
+        return;
+
+    std::pair<int, int> key(alt0 + i, vis0 + j);
+    std::map<std::pair<int, int>, TransformInput>::iterator it =
+        nodes.find(key);
+
+    if (it == nodes.end()) {
+        double height = key.first * BIN_ALT / 1000.;
+        double vis = key.second * BIN_VIS / 1000.;
+
+        /* re-compute transformation inputs */
+        if (use_alt && use_vis)
+            pre_compute_hv(height, vis);
+        else if (use_vis)
+            pre_compute_v(vis);
+        else
+            pre_compute_h(height);
+        it = nodes.insert(std::make_pair(key, compute())).first;
+        ncomputed++;
+    }
+
+    k = values.size();
+    values.push_back(it->second);
+}
+
+void TILut::require(double alt, double vis)
+{
+    int i, j;
+    double s, t;
+
+    locate(use_alt ? alt / BIN_ALT - alt0 : 0, nalt, i, s);
+    locate(use_vis ? vis / BIN_VIS - vis0 : 0, nvis, j, t);
+
+    require_node(i, j);
+    if (s > 0)
+        require_node(i + 1, j);
+    if (t > 0) {
+        require_node(i, j + 1);
+        if (s > 0)
+            require_node(i + 1, j + 1);
+    }
+}
+
+/* add a weighted node to the inputs that vary with altitude and
+   visibility */
+static void add_node(TransformInput &ti, const TransformInput &node,
+                     double w)
+{
+    int i, j;
+
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < 3; j++)
+            ti.ainr[i][j] += w * node.ainr[i][j];
+    ti.sb += w * node.sb;
+    ti.seb += w * node.seb;
+    ti.tgasm += w * node.tgasm;
+    ti.sutott += w * node.sutott;
+    ti.sdtott += w * node.sdtott;
+    ti.sast += w * node.sast;
+    ti.srotot += w * node.srotot;
+    ti.xmus += w * node.xmus;
+}
+
+void TILut::interpolate(double alt, double vis, TransformInput &ti) const
+{
+    int i, j;
+    double s, t;
+    const TransformInput *node;
+
+    locate(use_alt ? alt / BIN_ALT - alt0 : 0, nalt, i, s);
+    locate(use_vis ? vis / BIN_VIS - vis0 : 0, nvis, j, t);
+
+    node = &values[index[(size_t)i * nvis + j]];
+    if (s == 0 && t == 0) {
+        ti = *node;
+        return;
+    }
+
+    /* the geometry and the band do not change */
+    ti = TransformInput();
+    ti.iwave = node->iwave;
+    ti.asol = node->asol;
+
+    add_node(ti, *node, (1 - s) * (1 - t));
+    if (s > 0)
+        add_node(ti, values[index[(size_t)(i + 1) * nvis + j]], s * (1 - t));
+    if (t > 0) {
+        add_node(ti, values[index[(size_t)i * nvis + j + 1]], (1 - s) * t);
+        if (s > 0)
+            add_node(ti, values[index[(size_t)(i + 1) * nvis + j + 1]],
+                     s * t);
+    }
+}
+
+/* nodes are valid for the same 6S parameters and bins only, the
+   geometrical conditions (date, time and angles of a scene) change every
+   node and are part of the parameters */
+std::string TILut::header(const std::string &params) const
+{
+    std::ostringstream s;
+
+    s << "i.atcorr lookup table" << std::endl;
+    s << "bins " << BIN_ALT << " " << BIN_VIS << std::endl;
+    s << "maps " << use_alt << " " << use_vis << std::endl;
+    s << "parameters " << params.size() << std::endl;
+    s << params << std::endl;
+
+    return s.str();
+}
+
+bool TILut::load(const char *name, const std::string &params)
+{
+    std::ifstream in(name, std::ios::binary);
+
+    if (!in.is_open())
+        return false;
+
+    std::string h = header(params);
+    std::string buf(h.size(), '\0');
+
+    in.read(&buf[0], buf.size());
+    if (!in || buf != h) {
+        G_warning(_("Lookup table <%s> was computed for other parameters "
+                    "and will be replaced"),
+                  name);
+        return false;
+    }
+
+    size_t n, k;
+    int i, j;
+    std::pair<int, int> key;
+    TransformInput ti;
+
+    in >> n;
+    for (k = 0; k < n && in; k++) {
+        in >> key.first >> key.second >> ti.iwave >> ti.asol;
+        for (i = 0; i < 2; i++)
+            for (j = 0; j < 3; j++)
+                in >> ti.ainr[i][j];
+        in >> ti.sb >> ti.seb >> ti.tgasm >> ti.sutott >> ti.sdtott >>
+            ti.sast >> ti.srotot >> ti.xmus;
+        if (in)
+            nodes[key] = ti;
+    }
+    if (!in) {
+        /* computed again like a table for other parameters */
+        G_warning(_("Unable to read lookup table <%s>, it will be replaced"),
+                  name);
+        nodes.clear();
+        return false;
+    }
+
+    G_verbose_message(_("%d nodes read from lookup table <%s>"), (int)n,
+                      name);
+
+    return true;
+}
+
+void TILut::save(const char *name, const std::string &params) const
+{
+    std::ofstream out(name, std::ios::binary);
+    std::map<std::pair<int, int>, TransformInput>::const_iterator it;
+    int i, j;
+
+    out << header(params) << nodes.size() << std::endl;
+    out << std::setprecision(17);
+    for (it = nodes.begin(); it != nodes.end(); ++it) {
+        const TransformInput &ti = it->second;
+
+        out << it->first.first << " " << it->first.second << " " << ti.iwave
+            << " " << ti.asol;
+        for (i = 0; i < 2; i++)
+            for (j = 0; j < 3; j++)
+                out << " " << ti.ainr[i][j];
+        out << " " << ti.sb << " " << ti.seb << " " << ti.tgasm << " "
+            << ti.sutott << " " << ti.sdtott << " " << ti.sast << " "
+            << ti.srotot << " " << ti.xmus << std::endl;
+    }
+
+    if (!out)
+        G_warning(_("Unable to write lookup table <%s>"), name);
+}
@@ -0,0 +1,64 @@
+#ifndef LUT_H
+#define LUT_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "transform.h"
+
+/* Nodes of the lookup table for altitude and visibility.
+   altitude range: appr. 0 - 9000
+   bin 10: change between bins is 0.05 - 0.16%
+   bin 100: change between bins is 0.5 - 1.5%
+   bin 1000: change between bins is 6 - 13% */
+#define BIN_ALT 10 /* unit is meters */
+/* visibility range: 0 - 50000
+   bin 10: change between bins is 0.004 - 0.16%
+   bin 100: change between bins is 0.01 - 1.6%
+   bin 1000: change between bins is 0.1 - 13% */
+#define BIN_VIS 100 /* unit is meters */
+
+/* Lookup table of transformation inputs on a grid of altitudes and
+   visibilities, for an elevation and/or a visibility map.
+
+   Nodes are computed with the 6S model when they are first needed, which
+   is not thread-safe, or read from a file written by a previous run with
+   the same parameters. The inputs of pixels are then interpolated
+   bilinearly between the nodes around them, which is thread-safe. */
+class TILut {
+    bool use_alt, use_vis; /* altitude and/or visibility vary */
+    int alt0, nalt;        /* first altitude node and number of nodes */
+    int vis0, nvis;        /* first visibility node and number of nodes */
+    std::vector<int> index; /* value of each node of the ranges, -1 if none */
+    std::vector<TransformInput> values; /* values of the nodes in index */
+    std::map<std::pair<int, int>, TransformInput> nodes; /* all nodes */
+    int ncomputed; /* number of nodes computed by 6S */
+
+    static void locate(double x, int n, int &i, double &t);
+    void require_node(int i, int j);
+    std::string header(const std::string &params) const;
+
+public:
+    /* ranges of the maps, altitude and visibility in meters */
+    TILut(bool use_alt, bool use_vis, double alt_min, double alt_max,
+          double vis_min, double vis_max);
+
+    /* read nodes from a file, false if it does not exist, cannot be read
+       or was written for other parameters */
+    bool load(const char *name, const std::string &params);
+    /* write all nodes to a file */
+    void save(const char *name, const std::string &params) const;
+
+    /* compute the nodes needed to interpolate the inputs of a pixel,
+       altitude and visibility in meters */
+    void require(double alt, double vis);
+    /* interpolate the inputs of a pixel, its nodes must have been required
+     */
+    void interpolate(double alt, double vis, TransformInput &ti) const;
+
+    int computed() const { return ncomputed; }
+};
+
+#endif /* LUT_H */
@@ -32,39 +32,28 @@
 * input elevation/visibility map: efficient cache with dynamic memory
 * allocation: Markus Metz, Apr 2011
 
+* lookup table of transformation inputs, parallel rows, 2026
+
 ***************************************************************************/
 
 #include <cstdlib>
-#include <map>
 #include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 extern "C" {
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/glocale.h>
-#include <grass/rbtree.h>
 }
 
 #include "transform.h"
 #include "6s.h"
+#include "lut.h"
 
 /* MODIS surface reflectance (MOD09) uses pre-computed 6S parameters
- * for 10 aerosol optical depths. Here we use finer grain. */
-
-/* TICache: create bins for altitude and visibility */
-/* altitude range: appr. 0 - 9000
- * bin 10: change between bins is 0.05 - 0.16%
- * bin 100: change between bins is 0.5 - 1.5%
- * bin 1000: change between bins is 6 - 13%*/
-#define BIN_ALT 10 /* unit is meters */
-/* visibility range: 0 - 50000
- * bin 10: change between bins is 0.004 - 0.16%
- * bin 100: change between bins is 0.01 - 1.6%
- * bin 1000: change between bins is 0.1 - 13%*/
-#define BIN_VIS 100 /* unit is meters */
-
-/* uncomment to disable cache usage */
-/* #define _NO_OPTIMIZE_ */
+ * for 10 aerosol optical depths. Here we use finer grain, see lut.h. */
 
 /* Input options and flags */
 struct Options {
@@ -77,9 +66,11 @@ struct Options {
     struct Option *ivis; /* an input visibility map in km (same purpose and
                             effect as ialt) */
     struct Option *icnd; /* the input conditions file */
+    struct Option *ilut; /* lookup table file, read and updated */
     struct Option *oimg; /* output image name */
     struct Option
         *oscl; /* scale the output data (reflectance values) to this range */
+    struct Option *nprocs; /* number of threads */
 
     /* flags */
     struct Flag *oint; /* output data as integer */
@@ -96,17 +87,12 @@ struct ScaleRange {
     int max;
 };
 
-struct RBitem {
-    int alt;           /* elevation */
-    int vis;           /* visibility */
-    TransformInput ti; /* transformation parameters */
-};
-
 /* function prototypes */
 static void adjust_region(const char *);
-static void write_fp_to_cell(int, FCELL *);
-static void process_raster(int, InputMask, ScaleRange, int, int, int, bool,
-                           ScaleRange);
+static void read_range(const char *, double &, double &);
+static void write_fp_to_cell(int, FCELL *, CELL *);
+static void process_raster(int, InputMask, ScaleRange, int, int, TILut *, int,
+                           bool, ScaleRange, int);
 static void copy_colors(const char *, char *);
 static void define_module(void);
 static struct Options define_options(void);
@@ -126,125 +112,40 @@ static void adjust_region(const char *name)
     Rast_set_window(&iimg_head);
 }
 
-/* Rounds a floating point cell value */
-static CELL round_c(FCELL x)
+/* Read the range of a raster map, 0 if it has no values */
+static void read_range(const char *name, double &min, double &max)
 {
-    if (x >= 0.0)
-        return (CELL)(x + .5);
+    struct FPRange range;
+    DCELL dmin, dmax;
 
-    return (CELL)(-(-x + .5));
-}
+    Rast_read_fp_range(name, "", &range);
+    Rast_get_fp_range_min_max(&range, &dmin, &dmax);
+    if (Rast_is_d_null_value(&dmin) || Rast_is_d_null_value(&dmax))
+        dmin = dmax = 0;
 
-/* round height, input and output unit is meters */
-static int round_h(double x)
-{
-    x /= BIN_ALT;
-    x = floor(x + 0.5);
-    x *= BIN_ALT;
-
-    return x;
+    min = dmin;
+    max = dmax;
 }
 
-/* round visibility, input unit is km, output unit is meters */
-static int round_v(double x)
+/* Rounds a floating point cell value */
+static CELL round_c(FCELL x)
 {
-    x *= 1000. / BIN_VIS;
-    x = floor(x + 0.5);
-    x *= BIN_VIS;
+    if (x >= 0.0)
+        return (CELL)(x + .5);
 
-    return x;
+    return (CELL)(-(-x + .5));
 }
 
 /* Converts the buffer to cell and write it to disk */
-static void write_fp_to_cell(int ofd, FCELL *buf)
+static void write_fp_to_cell(int ofd, FCELL *buf, CELL *cbuf)
 {
-    CELL *cbuf;
     int col;
 
-    cbuf = (CELL *)Rast_allocate_buf(CELL_TYPE);
-
     for (col = 0; col < Rast_window_cols(); col++)
         cbuf[col] = round_c(buf[col]);
     Rast_put_row(ofd, cbuf, CELL_TYPE);
 }
 
-/* compare function for RB tree */
-static int compare_hv(const void *ti_a, const void *ti_b)
-{
-    struct RBitem *a, *b;
-
-    a = (struct RBitem *)ti_a;
-    b = (struct RBitem *)ti_b;
-
-    /* check most common case first
-     * also faster if either an altitude or a visibility map is given,
-     * but not both */
-    if (a->alt == b->alt) {
-        if (a->vis == b->vis)
-            return 0;
-        if (a->vis > b->vis)
-            return 1;
-        else if (a->vis < b->vis)
-            return -1;
-    }
-    else if (a->alt > b->alt)
-        return 1;
-    else if (a->alt < b->alt)
-        return -1;
-
-    /* should not be reached */
-    return 0;
-}
-
-/* Cache for transformation input parameters */
-class TICache {
-    struct RB_TREE *RBTree;
-    unsigned int tree_size;
-
-private:
-    struct RBitem set_alt_vis(double alt, double vis)
-    {
-        struct RBitem rbitem = {};
-        /* alt and vis must be in meters */
-        rbitem.alt = (alt < 0 ? (int)(alt - 0.5) : (int)(alt + 0.5));
-        rbitem.vis = (int)(vis + 0.5);
-
-        return rbitem;
-    }
-
-public:
-    TICache()
-    {
-        RBTree = rbtree_create(compare_hv, sizeof(struct RBitem));
-        tree_size = 0;
-    }
-    int search(double alt, double vis, TransformInput *ti)
-    {
-        struct RBitem search_ti = set_alt_vis(alt, vis);
-        struct RBitem *found_ti;
-
-        found_ti = (struct RBitem *)rbtree_find(RBTree, &search_ti);
-        if (found_ti) {
-            *ti = found_ti->ti;
-            return 1;
-        }
-        else
-            return 0;
-    }
-
-    void add(const TransformInput &ti, double alt, double vis)
-    {
-        struct RBitem insert_ti = set_alt_vis(alt, vis);
-
-        /* add safety check here */
-        tree_size++;
-
-        insert_ti.ti = ti;
-
-        rbtree_insert(RBTree, &insert_ti);
-    }
-};
-
 /* Process the raster and do atmospheric corrections.
    Params:
    * INPUT FILE
@@ -253,192 +154,150 @@ public:
    iscale: input file's range (default is min = 0, max = 255)
    ialt_fd: height map file descriptor, negative if global value is used
    ivis_fd: visibility map file descriptor, negative if global value is used
+   lut: lookup table for the height and/or visibility map, NULL if global
+   values are used
 
    * OUTPUT FILE
    ofd: output file descriptor
    oflt: if true use FCELL_TYPE for output
    oscale: output file's range (default is min = 0, max = 255)
+
+   nprocs: number of threads
  */
 static void process_raster(int ifd, InputMask imask, ScaleRange iscale,
-                           int ialt_fd, int ivis_fd, int ofd, bool oint,
-                           ScaleRange oscale)
+                           int ialt_fd, int ivis_fd, TILut *lut, int ofd,
+                           bool oint, ScaleRange oscale, int nprocs)
 {
     FCELL *buf;        /* buffer for the input values */
     FCELL *alt = NULL; /* buffer for the elevation values */
     FCELL *vis = NULL; /* buffer for the visibility values */
-    int cur_alt = -100000;
-    int cur_vis = -100000;
-    int row, col, nrows, ncols;
-    /* switch on optimization automatically if elevation and/or visibility map
-     * is given */
-    bool optimize = (ialt_fd >= 0 || ivis_fd >= 0);
-
-#ifdef _NO_OPTIMIZE_
-    optimize = false;
-#endif
+    CELL *cbuf = NULL; /* buffer for the integer output values */
+    int row, nrows, ncols, block_rows, n, i;
+    int negative_vis = 0, low_vis = 0, overflow = 0, unstable = 0;
+    size_t k, ncells;
 
     /* do initial computation with global elevation and visibility values */
     TransformInput ti;
 
     ti = compute();
 
-    /* use a cache to increase computation speed when an elevation map
-     * and/or a visibility map is given */
-    TICache ticache;
+    nrows = Rast_window_rows();
+    ncols = Rast_window_cols();
+    /* rows read at once, processed in parallel */
+    block_rows = 4 * nprocs;
 
     /* allocate memory for buffers */
-    buf = (FCELL *)Rast_allocate_buf(FCELL_TYPE);
+    buf = (FCELL *)G_malloc((size_t)block_rows * ncols * sizeof(FCELL));
     if (ialt_fd >= 0)
-        alt = (FCELL *)Rast_allocate_buf(FCELL_TYPE);
+        alt = (FCELL *)G_malloc((size_t)block_rows * ncols * sizeof(FCELL));
     if (ivis_fd >= 0)
-        vis = (FCELL *)Rast_allocate_buf(FCELL_TYPE);
+        vis = (FCELL *)G_malloc((size_t)block_rows * ncols * sizeof(FCELL));
+    if (oint)
+        cbuf = Rast_allocate_c_buf();
 
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
-
-    for (row = 0; row < nrows; row++) {
+    for (row = 0; row < nrows; row += n) {
         G_percent(row, nrows, 1); /* keep the user informed of our progress */
 
-        /* read the next row */
-        Rast_get_row(ifd, buf, row, FCELL_TYPE);
+        n = nrows - row < block_rows ? nrows - row : block_rows;
+        ncells = (size_t)n * ncols;
+
+        /* read the next rows of input, elevation and visibility values */
+        for (i = 0; i < n; i++) {
+            Rast_get_row(ifd, buf + (size_t)i * ncols, row + i, FCELL_TYPE);
+            if (alt)
+                Rast_get_row(ialt_fd, alt + (size_t)i * ncols, row + i,
+                             FCELL_TYPE);
+            if (vis)
+                Rast_get_row(ivis_fd, vis + (size_t)i * ncols, row + i,
+                             FCELL_TYPE);
+        }
 
-        /* read the next row of elevation values */
-        if (ialt_fd >= 0)
-            Rast_get_row(ialt_fd, alt, row, FCELL_TYPE);
-
-        /* read the next row of elevation values */
-        if (ivis_fd >= 0)
-            Rast_get_row(ivis_fd, vis, row, FCELL_TYPE);
-
-        /* loop over all the values in the row */
-        for (col = 0; col < ncols; col++) {
-            if ((vis && Rast_is_f_null_value(&vis[col])) ||
-                (alt && Rast_is_f_null_value(&alt[col])) ||
-                Rast_is_f_null_value(&buf[col])) {
-                Rast_set_f_null_value(&buf[col], 1);
+        /* compute the missing nodes of the lookup table, the 6S model
+         * is not thread-safe */
+        for (k = 0; lut && k < ncells; k++) {
+            if ((vis && Rast_is_f_null_value(&vis[k])) ||
+                (alt && Rast_is_f_null_value(&alt[k])) ||
+                Rast_is_f_null_value(&buf[k])) {
+                Rast_set_f_null_value(&buf[k], 1);
                 continue;
             }
-            if (ialt_fd >= 0) {
-                alt[col] = round_h(alt[col]); /* in meters */
-            }
-            if (ivis_fd >= 0) {
-                if (vis[col] < 0) {
+            if (vis) {
+                if (vis[k] < 0) {
                     /* negative visibility is invalid */
-                    G_warning(_("Negative visibility!"));
-                    vis[col] = 0;
+                    negative_vis = 1;
+                    vis[k] = 0;
                 }
-                if (vis[col] < 5.0) {
-                    /* too low visibility, text comes from 6S main.f L109-113 */
-                    G_warning(_("The visibility must be better than 5.0km, "
-                                "for smaller values calculations might be no "
-                                "more valid!"));
+                if (vis[k] < 5.0) {
+                    /* too low visibility */
+                    low_vis = 1;
                 }
-                vis[col] = round_v(vis[col]); /* from km to meters */
+                vis[k] *= 1000.; /* from km to meters */
             }
+            lut->require(alt ? alt[k] : 0, vis ? vis[k] : 0);
+        }
 
-            /* check if altitude or visibility has changed */
-            if ((ialt_fd >= 0) && (ivis_fd >= 0) &&
-                ((cur_vis != vis[col]) || (cur_alt != alt[col]))) {
-                cur_alt = alt[col];
-                cur_vis = vis[col];
-                if (optimize) {
-                    int in_cache = ticache.search(cur_alt, cur_vis, &ti);
-
-                    if (!in_cache) {
-                        pre_compute_hv(
-                            alt[col] / 1000.,
-                            vis[col] /
-                                1000.); /* re-compute transformation inputs */
-                        ti = compute(); /* ... */
-
-                        ticache.add(ti, cur_alt, cur_vis);
-                    }
-                }
-                else {
-                    pre_compute_hv(
-                        alt[col] / 1000.,
-                        vis[col] /
-                            1000.); /* re-compute transformation inputs */
-                    ti = compute(); /* ... */
-                }
-            }
-            else {
-                if ((ivis_fd >= 0) && (cur_vis != vis[col])) {
-                    cur_vis = vis[col];
-
-                    if (optimize) {
-                        int in_cache = ticache.search(cur_alt, cur_vis, &ti);
-
-                        if (!in_cache) {
-                            pre_compute_v(
-                                vis[col] /
-                                1000.); /* re-compute transformation inputs */
-                            ti = compute(); /* ... */
-
-                            ticache.add(ti, cur_alt, cur_vis);
-                        }
-                    }
-                    else {
-                        pre_compute_v(
-                            vis[col] /
-                            1000.);     /* re-compute transformation inputs */
-                        ti = compute(); /* ... */
-                    }
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic) reduction(+ : overflow, unstable)
+        for (i = 0; i < n; i++) {
+            TransformInput pti = ti;
+            FCELL *b = buf + (size_t)i * ncols;
+            size_t offset = (size_t)i * ncols;
+            int col;
+
+            /* loop over all the values in the row */
+            for (col = 0; col < ncols; col++) {
+                if (Rast_is_f_null_value(&b[col]))
+                    continue;
+
+                /* transformation inputs of the elevation and visibility */
+                if (lut)
+                    lut->interpolate(alt ? alt[offset + col] : 0,
+                                     vis ? vis[offset + col] : 0, pti);
+
+                /* transform from iscale.[min,max] to [0,1] */
+                b[col] = (b[col] - iscale.min) /
+                         ((double)iscale.max - (double)iscale.min);
+                b[col] = transform(pti, imask, b[col]);
+                if (Rast_is_f_null_value(&b[col])) {
+                    unstable++;
+                    continue;
                 }
+                /* transform from [0,1] to oscale.[min,max] */
+                b[col] = b[col] * ((double)oscale.max - (double)oscale.min) +
+                         oscale.min;
 
-                if ((ialt_fd >= 0) && (cur_alt != alt[col])) {
-                    cur_alt = alt[col];
-
-                    if (optimize) {
-                        int in_cache = ticache.search(alt[col], cur_vis, &ti);
-
-                        if (!in_cache) {
-                            pre_compute_h(
-                                alt[col] /
-                                1000.); /* re-compute transformation inputs */
-                            ti = compute(); /* ... */
-
-                            ticache.add(ti, cur_alt, cur_vis);
-                        }
-                    }
-                    else {
-                        pre_compute_h(
-                            alt[col] /
-                            1000.);     /* re-compute transformation inputs */
-                        ti = compute(); /* ... */
-                    }
-                }
+                if (oint && (b[col] > (double)oscale.max))
+                    overflow++;
             }
-            G_debug(3, "Computed r%d (%d), c%d (%d)", row, nrows, col, ncols);
-            /* transform from iscale.[min,max] to [0,1] */
-            buf[col] = (buf[col] - iscale.min) /
-                       ((double)iscale.max - (double)iscale.min);
-            buf[col] = transform(ti, imask, buf[col]);
-            if (Rast_is_f_null_value(&buf[col]))
-                G_fatal_error(_("Numerical instability in 6S"));
-            /* transform from [0,1] to oscale.[min,max] */
-            buf[col] = buf[col] * ((double)oscale.max - (double)oscale.min) +
-                       oscale.min;
-
-            if (oint && (buf[col] > (double)oscale.max))
-                G_warning(
-                    _("The output data will overflow. Reflectance > 100%%"));
         }
+        if (unstable)
+            G_fatal_error(_("Numerical instability in 6S"));
 
         /* write output */
-        if (oint)
-            write_fp_to_cell(ofd, buf);
-        else
-            Rast_put_row(ofd, buf, FCELL_TYPE);
+        for (i = 0; i < n; i++) {
+            if (oint)
+                write_fp_to_cell(ofd, buf + (size_t)i * ncols, cbuf);
+            else
+                Rast_put_row(ofd, buf + (size_t)i * ncols, FCELL_TYPE);
+        }
     }
     G_percent(1, 1, 1);
 
+    if (negative_vis)
+        G_warning(_("Negative visibility!"));
+    if (low_vis)
+        /* text comes from 6S main.f L109-113 */
+        G_warning(_("The visibility must be better than 5.0km, "
+                    "for smaller values calculations might be no "
+                    "more valid!"));
+    if (overflow)
+        G_warning(_("The output data will overflow. Reflectance > 100%%"));
+
     /* free allocated memory */
     G_free(buf);
-    if (ialt_fd >= 0)
-        G_free(alt);
-    if (ivis_fd >= 0)
-        G_free(vis);
+    G_free(alt);
+    G_free(vis);
+    G_free(cbuf);
 }
 
 /* Copy the colors from map named iname to the map named oname */
@@ -467,6 +326,7 @@ static void define_module(void)
     G_add_keyword(_("radiance"));
     G_add_keyword(_("reflectance"));
     G_add_keyword(_("satellite"));
+    G_add_keyword(_("parallel"));
 
     /*
        " Incorporated into Grass by Christo A. Zietsman, January 2003.\n"
@@ -518,6 +378,15 @@ static struct Options define_options(void)
     opts.icnd->required = YES;
     opts.icnd->description = _("Name of input text file with 6S parameters");
 
+    opts.ilut = G_define_standard_option(G_OPT_F_INPUT);
+    opts.ilut->key = "lut";
+    opts.ilut->required = NO;
+    opts.ilut->label =
+        _("Name of lookup table file for elevation and visibility maps");
+    opts.ilut->description = _("Reused if it was written for the same 6S "
+                               "parameters, created or updated otherwise");
+    opts.ilut->guisection = _("Input");
+
     opts.oimg = G_define_standard_option(G_OPT_R_OUTPUT);
 
     opts.oscl = G_define_option();
@@ -529,6 +398,8 @@ static struct Options define_options(void)
     opts.oscl->description = _("Rescale output raster map");
     opts.oscl->guisection = _("Output");
 
+    opts.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     opts.oint = G_define_flag();
     opts.oint->key = 'i';
     opts.oint->description = _("Output raster map as integer");
@@ -594,6 +465,9 @@ int main(int argc, char *argv[])
     int oimg_fd;              /* output image's file descriptor */
     int ialt_fd = -1;         /* input elevation map's file descriptor */
     int ivis_fd = -1;         /* input visibility map's file descriptor */
+    TILut *lut = NULL;        /* lookup table for elevation and visibility */
+    bool lut_loaded = false;  /* lookup table was read from a file */
+    int nprocs;               /* number of threads */
     struct History hist;
     struct Cell_head orig_window;
 
@@ -608,6 +482,8 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv) < 0)
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(opts.nprocs);
+
     G_get_set_window(&orig_window);
     adjust_region(opts.iimg->answer);
 
@@ -643,9 +519,34 @@ int main(int argc, char *argv[])
     read_scale(opts.iscl, iscale);
     read_scale(opts.oscl, oscale);
 
+    /* the contents of the input conditions file identify a lookup table */
+    std::ifstream icnd(opts.icnd->answer, std::ios::binary);
+    std::ostringstream params;
+
+    params << icnd.rdbuf();
+    icnd.close();
+
     /* initialize this 6s computation and parse the input conditions file */
     init_6S(opts.icnd->answer);
 
+    /* a lookup table of transformation inputs is used when an elevation map
+     * and/or a visibility map is given */
+    if (ialt_fd >= 0 || ivis_fd >= 0) {
+        double alt_min = 0, alt_max = 0, vis_min = 0, vis_max = 0;
+
+        if (ialt_fd >= 0)
+            read_range(opts.ialt->answer, alt_min, alt_max);
+        if (ivis_fd >= 0) {
+            read_range(opts.ivis->answer, vis_min, vis_max);
+            vis_min *= 1000.; /* from km to meters */
+            vis_max *= 1000.;
+        }
+        lut = new TILut(ialt_fd >= 0, ivis_fd >= 0, alt_min, alt_max, vis_min,
+                        vis_max);
+        if (opts.ilut->answer)
+            lut_loaded = lut->load(opts.ilut->answer, params.str());
+    }
+
     InputMask imask =
         RADIANCE; /* the input mask tells us what transformations if any
                      needs to be done to make our input values, reflectance
@@ -660,8 +561,16 @@ int main(int argc, char *argv[])
     /* process the input raster and produce our atmospheric corrected output
      * raster. */
     G_message(_("Atmospheric correction..."));
-    process_raster(iimg_fd, imask, iscale, ialt_fd, ivis_fd, oimg_fd,
-                   opts.oint->answer, oscale);
+    process_raster(iimg_fd, imask, iscale, ialt_fd, ivis_fd, lut, oimg_fd,
+                   opts.oint->answer, oscale, nprocs);
+
+    if (lut) {
+        G_verbose_message(_("%d nodes of the lookup table computed by 6S"),
+                          lut->computed());
+        if (opts.ilut->answer && (!lut_loaded || lut->computed() > 0))
+            lut->save(opts.ilut->answer, params.str());
+        delete lut;
+    }
 
     /* Close the input and output file descriptors */
     Rast_short_history(opts.oimg->answer, "raster", &hist);
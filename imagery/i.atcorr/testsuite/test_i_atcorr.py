@@ -0,0 +1,188 @@
+"""
+Name:       i.atcorr test
+Purpose:    Tests the lookup table of transformation inputs for elevation
+            and visibility maps against the exact 6S computation, its
+            reuse from a file and parallel correction of rows.
+
+Author:     GRASS Development Team
+Copyright:  (C) 2026 by the GRASS Development Team
+Licence:    This program is free software under the GNU General Public
+            License (>=v2). Read the file COPYING that comes with GRASS
+            for details.
+"""
+
+import os
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import tempfile, tempname
+
+# 6S parameters of the Landsat ETM+ example of the manual, the visibility
+# (km) and the elevation (negative, km) are filled in
+PARAMETERS = """8
+2 19 13.00 -47.410 -20.234
+1
+1
+{visibility}
+{elevation}
+-1000
+64
+"""
+VISIBILITY = 15
+ELEVATION = 600
+
+# values between the nodes of the lookup table, which are every 10 m of
+# elevation and every 100 m of visibility
+ELEVATIONS = [123.4, 456.7, 789.1]
+VISIBILITIES = [8.25, 23.75]
+
+# the output is reflectance scaled to 0-255, the tolerance is 0.1 % of it,
+# less than the change of the output between two nodes
+TOLERANCE = 0.255
+
+
+def zones(values, axis):
+    """Expression giving values in zones of columns or rows"""
+    expression = str(values[-1])
+    for i in range(len(values) - 2, -1, -1):
+        expression = f"if({axis}() <= {(i + 1) * 20}, {values[i]}, {expression})"
+    return expression
+
+
+class TestLookupTable(TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        # i.atcorr sets the region to the input map
+        cls.runModule("g.region", n=50, s=0, e=60, w=0, res=1)
+        cls.input = tempname(10)
+        cls.elevation = tempname(10)
+        cls.visibility = tempname(10)
+        cls.maps = [cls.input, cls.elevation, cls.visibility]
+        cls.files = []
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.input} = if(row() == 5 && col() == 7, null(), "
+            "10 + (row() * 7 + col() * 3) % 100)",
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.elevation} = {zones(ELEVATIONS, 'col')}",
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.visibility} = {zones(VISIBILITIES, 'row')}",
+        )
+        cls.parameters = cls.write_parameters(VISIBILITY, ELEVATION)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.maps)
+        for name in cls.files:
+            if os.path.exists(name):
+                os.remove(name)
+
+    @classmethod
+    def write_parameters(cls, visibility, elevation):
+        """Write a 6S parameters file"""
+        name = tempfile(create=False)
+        cls.files.append(name)
+        with open(name, "w") as f:
+            f.write(
+                PARAMETERS.format(visibility=visibility, elevation=-elevation / 1000)
+            )
+        return name
+
+    def lut_file(self):
+        name = tempfile(create=False)
+        self.files.append(name)
+        return name
+
+    def atcorr(self, parameters, **kwargs):
+        """Correct the input, return the name of the output"""
+        output = tempname(10)
+        self.maps.append(output)
+        self.assertModule(
+            "i.atcorr",
+            flags="r",
+            input=self.input,
+            parameters=parameters,
+            output=output,
+            **kwargs,
+        )
+        return output
+
+    def exact(self, values, axis, parameter):
+        """Output of the global values of each zone, computed by 6S"""
+        kwargs = {"visibility": VISIBILITY, "elevation": ELEVATION}
+        outputs = []
+        for value in values:
+            kwargs[parameter] = value
+            outputs.append(self.atcorr(self.write_parameters(**kwargs)))
+        reference = tempname(10)
+        self.maps.append(reference)
+        self.runModule("r.mapcalc", expression=f"{reference} = {zones(outputs, axis)}")
+        return reference
+
+    def test_elevation(self):
+        """Interpolated elevations are close to the exact output"""
+        reference = self.exact(ELEVATIONS, "col", "elevation")
+        output = self.atcorr(
+            self.parameters, elevation=self.elevation, lut=self.lut_file()
+        )
+        self.assertRastersNoDifference(output, reference, precision=TOLERANCE)
+
+    def test_visibility(self):
+        """Interpolated visibilities are close to the exact output"""
+        reference = self.exact(VISIBILITIES, "row", "visibility")
+        output = self.atcorr(
+            self.parameters, visibility=self.visibility, lut=self.lut_file()
+        )
+        self.assertRastersNoDifference(output, reference, precision=TOLERANCE)
+
+    def test_lut_reuse(self):
+        """Nodes read from the file give the same output as computed ones"""
+        lut = self.lut_file()
+        maps = {"elevation": self.elevation, "visibility": self.visibility}
+        computed = self.atcorr(self.parameters, **maps)
+        saved = self.atcorr(self.parameters, lut=lut, **maps)
+        self.assertFileExists(lut)
+        read = self.atcorr(self.parameters, lut=lut, **maps)
+        self.assertRastersNoDifference(saved, computed, precision=0)
+        self.assertRastersNoDifference(read, computed, precision=0)
+
+    def test_lut_other_maps(self):
+        """A file of an elevation map is replaced for a visibility map"""
+        lut = self.lut_file()
+        self.atcorr(self.parameters, elevation=self.elevation, lut=lut)
+        computed = self.atcorr(self.parameters, visibility=self.visibility)
+        replaced = self.atcorr(self.parameters, visibility=self.visibility, lut=lut)
+        read = self.atcorr(self.parameters, visibility=self.visibility, lut=lut)
+        self.assertRastersNoDifference(replaced, computed, precision=0)
+        self.assertRastersNoDifference(read, computed, precision=0)
+
+    def test_lut_truncated(self):
+        """A file that cannot be read is computed again"""
+        lut = self.lut_file()
+        computed = self.atcorr(self.parameters, elevation=self.elevation, lut=lut)
+        with open(lut) as f:
+            text = f.read()
+        with open(lut, "w") as f:
+            f.write(text[: len(text) // 2])
+        replaced = self.atcorr(self.parameters, elevation=self.elevation, lut=lut)
+        read = self.atcorr(self.parameters, elevation=self.elevation, lut=lut)
+        self.assertRastersNoDifference(replaced, computed, precision=0)
+        self.assertRastersNoDifference(read, computed, precision=0)
+
+    def test_nprocs(self):
+        """Output with several threads is identical to one thread"""
+        maps = {"elevation": self.elevation, "visibility": self.visibility}
+        for kwargs in ({}, maps):
+            serial = self.atcorr(self.parameters, nprocs=1, **kwargs)
+            parallel = self.atcorr(self.parameters, nprocs=4, **kwargs)
+            self.assertRastersNoDifference(parallel, serial, precision=0)
+
+
+if __name__ == "__main__":
+    test()
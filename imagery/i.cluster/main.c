@@ -10,7 +10,7 @@
  *               Glynn Clements <glynn gclements.plus.com>,
  *               Jan-Oliver Wagner <jan intevation.de>
  * PURPOSE:      builds pixel clusters based on multi-image pixel values
- * COPYRIGHT:    (C) 1999-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 1999-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -50,12 +50,64 @@ time_t start_time;
 
 static int interrupted = 0;
 
+/* rows read at once for the signatures from all cells */
+#define STREAM_ROWS 64
+
+/* k-means iterations over all cells of the image, starting from the
+ * clustering of the sample; each iteration is a pass over the rows which
+ * assigns the cells to the classes and computes the signatures from them */
+static int stream_cells(int nrows, int ncols)
+{
+    int row, row0, nbuf, n, count;
+    DCELL **x;
+
+    x = (DCELL **)G_malloc(ref.nfiles * sizeof(DCELL *));
+    for (n = 0; n < ref.nfiles; n++)
+        x[n] = (DCELL *)G_malloc((size_t)STREAM_ROWS * ncols * sizeof(DCELL));
+
+    for (C.iteration = 1;; C.iteration++) {
+        I_cluster_stream_begin(&C);
+        count = 0;
+        G_message(_("Computing signatures from all cells (iteration %d)..."),
+                  C.iteration);
+        for (row0 = 0; row0 < nrows; row0 += STREAM_ROWS) {
+            G_percent(row0, nrows, 2);
+            nbuf = nrows - row0 < STREAM_ROWS ? nrows - row0 : STREAM_ROWS;
+            for (row = 0; row < nbuf; row++)
+                for (n = 0; n < ref.nfiles; n++)
+                    Rast_get_d_row(cellfd[n], x[n] + (size_t)row * ncols,
+                                   row0 + row);
+            count += I_cluster_stream_points(&C, x, nbuf * ncols);
+        }
+        G_percent(nrows, nrows, 2);
+        I_cluster_stream_end(&C);
+
+        if (C.stream_changes >= 0 && count > 0) {
+            C.percent_stable = (count - C.stream_changes) * 100.0 / count;
+            fprintf(report,
+                    _("Iteration %d over all cells: %.2f%% cells stable%s"),
+                    C.iteration, C.percent_stable, HOST_NEWLINE);
+            if (C.percent_stable >= conv)
+                break;
+        }
+        if (C.iteration >= iters)
+            break;
+    }
+
+    for (n = 0; n < ref.nfiles; n++)
+        G_free(x[n]);
+    G_free(x);
+
+    return count;
+}
+
 int main(int argc, char *argv[])
 {
     int count;
     int n;
     int row, nrows;
     int col, ncols;
+    int batch_size;
     DCELL *x;
     struct Cell_head window;
     FILE *fd;
@@ -65,8 +117,9 @@ int main(int argc, char *argv[])
     struct {
         struct Option *group_name, *subgroup_name, *out_sig, *seed_sig, *class,
             *sample_interval, *iterations, *separation, *convergence, *min_size,
-            *report_file;
+            *report_file, *batch_size, *nprocs;
     } parm;
+    struct Flag *all_cells;
 
     G_gisinit(argv[0]);
 
@@ -74,6 +127,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("imagery"));
     G_add_keyword(_("classification"));
     G_add_keyword(_("signatures"));
+    G_add_keyword(_("parallel"));
     module->label = _("Generates spectral signatures for land cover "
                       "types in an image using a clustering algorithm.");
     module->description =
@@ -152,12 +206,30 @@ int main(int argc, char *argv[])
     parm.min_size->answer = "17";
     parm.min_size->guisection = _("Settings");
 
+    parm.batch_size = G_define_option();
+    parm.batch_size->key = "batch_size";
+    parm.batch_size->type = TYPE_INTEGER;
+    parm.batch_size->required = NO;
+    parm.batch_size->label =
+        _("Number of sample points reassigned per iteration");
+    parm.batch_size->description =
+        _("Mini-batches for large samples, 0 reassigns all points");
+    parm.batch_size->answer = "0";
+    parm.batch_size->guisection = _("Settings");
+
     parm.report_file = G_define_standard_option(G_OPT_F_OUTPUT);
     parm.report_file->key = "reportfile";
     parm.report_file->required = NO;
     parm.report_file->description =
         _("Name for output file containing final report");
 
+    parm.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
+    all_cells = G_define_flag();
+    all_cells->key = 'a';
+    all_cells->description =
+        _("Refine the clustering by iterations over all cells");
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
@@ -233,6 +305,14 @@ int main(int argc, char *argv[])
                       parm.min_size->answer);
     }
 
+    if (sscanf(parm.batch_size->answer, "%d", &batch_size) != 1 ||
+        batch_size < 0) {
+        G_fatal_error(_("Illegal value of batch_size (%s)"),
+                      parm.batch_size->answer);
+    }
+    C.batch_size = batch_size;
+    C.nprocs = G_set_omp_num_threads(parm.nprocs);
+
     if ((reportfile = parm.report_file->answer) == NULL)
         report = fopen(G_DEV_NULL, "w");
     else
@@ -286,6 +366,9 @@ int main(int argc, char *argv[])
             HOST_NEWLINE);
     fprintf(report, _(" Col sampling interval:        %d%s"), sample_cols,
             HOST_NEWLINE);
+    if (batch_size > 0)
+        fprintf(report, _(" Mini-batch size:              %d%s"), batch_size,
+                HOST_NEWLINE);
     fprintf(report, "%s", HOST_NEWLINE);
     fflush(report);
 
@@ -320,16 +403,25 @@ int main(int argc, char *argv[])
         G_fatal_error(_("Not enough non-zero sample data points. Check "
                         "your current region (and mask)."));
 
-    for (n = 0; n < ref.nfiles; n++) {
+    for (n = 0; n < ref.nfiles; n++)
         G_free(cell[n]);
-        Rast_close(cellfd[n]);
-    }
     G_free(x);
 
     start_time = time(NULL);
     I_cluster_exec(&C, maxclass, iters, conv, sep, mcs, checkpoint,
                    &interrupted);
 
+    if (all_cells->answer) {
+        fprintf(report, "%s", HOST_NEWLINE);
+        count = stream_cells(nrows, ncols);
+        fprintf(report,
+                _("%sSignatures computed from all %d cells in %d "
+                  "iterations%s"),
+                HOST_NEWLINE, count, C.iteration, HOST_NEWLINE);
+    }
+    for (n = 0; n < ref.nfiles; n++)
+        Rast_close(cellfd[n]);
+
     fprintf(report, _("%s########## final results #############%s"),
             HOST_NEWLINE, HOST_NEWLINE);
     fprintf(report, _("%d classes (convergence=%.1f%%)%s"),
@@ -287,6 +287,86 @@ class TestIClusterWithSyntheticData(TestCase):
                 f"Class has {count} pixels, less than min_size={min_size}",
             )
 
+    def test_all_cells(self):
+        """Test that signatures from all cells count every cell."""
+        sig_file = self.signature_file + "_all"
+        self.assertModule(
+            "i.cluster",
+            group=self.group_name,
+            subgroup=self.subgroup_name,
+            signaturefile=sig_file,
+            classes=self.num_classes,
+            sample=(4, 4),
+            batch_size=200,
+            iterations=100,
+            nprocs=2,
+            flags="a",
+            overwrite=True,
+        )
+        self.addCleanup(
+            self.runModule, "g.remove", flags="f", type="raster", name=sig_file
+        )
+        parent_dir_info = find_file("sig", element="signatures")
+        sig_path = os.path.join(parent_dir_info["file"], sig_file, "sig")
+        npoints = self.parse_signature_npoints(sig_path)
+
+        self.assertEqual(sum(npoints), 100 * 100)
+
+    def test_all_cells_in_memory(self):
+        """Test that iterations over all cells match clustering in memory."""
+        group = self.group_name + "_zones"
+        maps = [f"{name}_zones" for name in self.input_maps]
+        # three zones of columns with distinct values and a small variation
+        for i, name in enumerate(maps):
+            self.runModule(
+                "r.mapcalc",
+                expression=f"{name} = 40 * (if(col() <= 30, 0, if(col() <= 60, 1, "
+                f"2)) + {i}) + (row() * {i + 1} + col()) % 5",
+                overwrite=True,
+            )
+        self.addCleanup(self.runModule, "g.remove", flags="f", type="raster", name=maps)
+        self.runModule("i.group", group=group, subgroup=group, input=",".join(maps))
+        self.addCleanup(self.runModule, "g.remove", flags="f", type="group", name=group)
+
+        signatures = []
+        for name, sample, flags in (
+            ("_memory", (1, 1), ""),
+            ("_all_full", (1, 1), "a"),
+            ("_all_sparse", (3, 3), "a"),
+        ):
+            sig_file = self.signature_file + name
+            self.assertModule(
+                "i.cluster",
+                group=group,
+                subgroup=group,
+                signaturefile=sig_file,
+                classes=self.num_classes,
+                sample=sample,
+                convergence=100,
+                iterations=50,
+                flags=flags,
+                overwrite=True,
+            )
+            self.addCleanup(self.runModule, "i.signatures", remove=sig_file, type="sig")
+            parent_dir_info = find_file("sig", element="signatures")
+            sig_path = os.path.join(parent_dir_info["file"], sig_file, "sig")
+            signatures.append(
+                sorted(
+                    zip(
+                        self.parse_signature_means(sig_path),
+                        self.parse_signature_npoints(sig_path),
+                    )
+                )
+            )
+
+        memory = signatures[0]
+        self.assertEqual([n for m, n in memory], [3000, 3000, 4000])
+        for streamed in signatures[1:]:
+            self.assertEqual([n for m, n in streamed], [n for m, n in memory])
+            for (means, _), (reference, _) in zip(streamed, memory):
+                for value, expected in zip(means, reference):
+                    self.assertAlmostEqual(value, expected, delta=1e-3)
+
 
 if __name__ == "__main__":
     test()
@@ -5,7 +5,7 @@
  * PURPOSE:      Calculates the emissivity from NDVI (empirical)
  *               as seen in Caselles and Colles (1997).
  *
- * COPYRIGHT:    (C) 2002-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2002-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -25,17 +25,16 @@ double emissivity_generic(double ndvi);
 int main(int argc, char *argv[])
 {
     int nrows, ncols;
-    int row, col;
+    int row, row0, nbuf, block_rows, nprocs;
     struct GModule *module;
-    struct Option *input, *output;
+    struct Option *input, *output, *opt_nprocs;
     struct History history; /*metadata */
 
     /************************************/
     char *result1;   /*output raster name */
     int infd, outfd; /*File Descriptors */
     char *ndvi;
-    void *inr;
-    DCELL *outr;
+    DCELL **inr, **outr;
 
     /************************************/
     G_gisinit(argv[0]);
@@ -44,6 +43,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("emissivity"));
     G_add_keyword(_("land flux"));
     G_add_keyword(_("energy balance"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Computes emissivity from NDVI, generic method for sparse land.");
 
@@ -54,6 +54,8 @@ int main(int argc, char *argv[])
     output = G_define_standard_option(G_OPT_R_OUTPUT);
     output->description = _("Name of the output emissivity layer");
 
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /********************/
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
@@ -61,42 +63,63 @@ int main(int argc, char *argv[])
     ndvi = input->answer;
     result1 = output->answer;
 
+    nprocs = G_set_omp_num_threads(opt_nprocs);
+    /* rows read at once and processed in parallel */
+    block_rows = 4 * nprocs;
+
     /***************************************************/
     infd = Rast_open_old(ndvi, "");
-    inr = Rast_allocate_d_buf();
+    inr = G_malloc(block_rows * sizeof(DCELL *));
+    outr = G_malloc(block_rows * sizeof(DCELL *));
+    for (row = 0; row < block_rows; row++) {
+        inr[row] = Rast_allocate_d_buf();
+        outr[row] = Rast_allocate_d_buf();
+    }
 
     /***************************************************/
     nrows = Rast_window_rows();
     ncols = Rast_window_cols();
-    outr = Rast_allocate_d_buf();
 
     /* Create New raster files */
     outfd = Rast_open_new(result1, DCELL_TYPE);
 
     /* Process pixels */
-    for (row = 0; row < nrows; row++) {
-        DCELL d;
-        DCELL d_ndvi;
+    for (row0 = 0; row0 < nrows; row0 += block_rows) {
+        G_percent(row0, nrows, 2);
 
-        G_percent(row, nrows, 2);
+        nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
 
-        /* read input maps */
-        Rast_get_row(infd, inr, row, DCELL_TYPE);
+        /* read input maps, reading rows is not thread-safe */
+        for (row = 0; row < nbuf; row++)
+            Rast_get_d_row(infd, inr[row], row0 + row);
 
         /*process the data */
-        for (col = 0; col < ncols; col++) {
-            d_ndvi = ((DCELL *)inr)[col];
-            if (Rast_is_d_null_value(&d_ndvi))
-                Rast_set_d_null_value(&outr[col], 1);
-            else {
-
-                /****************************/
-                /* calculate emissivity     */
-                d = emissivity_generic(d_ndvi);
-                outr[col] = d;
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) schedule(dynamic)
+        for (row = 0; row < nbuf; row++) {
+            int col;
+
+            for (col = 0; col < ncols; col++) {
+                DCELL d_ndvi = inr[row][col];
+
+                if (Rast_is_d_null_value(&d_ndvi))
+                    Rast_set_d_null_value(&outr[row][col], 1);
+                else {
+
+                    /****************************/
+                    /* calculate emissivity     */
+                    outr[row][col] = emissivity_generic(d_ndvi);
+                }
             }
         }
-        Rast_put_row(outfd, outr, DCELL_TYPE);
+
+        for (row = 0; row < nbuf; row++)
+            Rast_put_d_row(outfd, outr[row]);
+    }
+    G_percent(1, 1, 1);
+
+    for (row = 0; row < block_rows; row++) {
+        G_free(inr[row]);
+        G_free(outr[row]);
     }
     G_free(inr);
     Rast_close(infd);
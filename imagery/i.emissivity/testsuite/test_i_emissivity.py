@@ -139,6 +139,33 @@ class TestIEmissivity(TestCase):
         self.assertRasterExists(self.output_raster)
         self.assertRasterMinMax(self.output_raster, 0, 1)
 
+    def test_nprocs(self):
+        """Output with several threads is identical to one thread"""
+        self.runModule("g.region", rows=100, cols=100)
+        self.addCleanup(self.runModule, "g.region", rows=10, cols=10)
+        self.runModule(
+            "r.mapcalc",
+            expression=f"{self.input_raster} = if(row() == 7, null(), "
+            "-0.2 + 0.01 * ((row() * 3 + col() * 7) % 120))",
+            overwrite=True,
+        )
+        outputs = []
+        for nprocs in (1, 4):
+            output = f"emissivity_nprocs_{nprocs}"
+            self.temp_rasters.append(output)
+            outputs.append(output)
+            self.assertModule(
+                "i.emissivity",
+                input=self.input_raster,
+                output=output,
+                nprocs=nprocs,
+                overwrite=True,
+            )
+        self.assertRastersNoDifference(
+            actual=outputs[1], reference=outputs[0], precision=0
+        )
+
+
 
 if __name__ == "__main__":
     test()
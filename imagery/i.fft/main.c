@@ -9,7 +9,7 @@
  * PURPOSE:      processes a single input raster map layer
  *               and constructs the real and imaginary Fourier
  *               components in frequency space
- * COPYRIGHT:    (C) 1999-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 1999-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -40,6 +40,22 @@
 #include <grass/gmath.h>
 #include <grass/glocale.h>
 
+/* rows transformed at once */
+#define BLOCK_ROWS 64
+
+/* frequency of row or column i of the rotated output and vice versa:
+ * the halves are swapped, the low frequencies are in the center */
+static int rotate(int i, int n)
+{
+    int h = n / 2;
+
+    if (i < h)
+        return i + h;
+    if (i < 2 * h)
+        return i - h;
+    return i;
+}
+
 static void fft_colors(const char *name)
 {
     struct Colors wave, colors;
@@ -59,18 +75,20 @@ int main(int argc, char *argv[])
     /* Global variable & function declarations */
     struct GModule *module;
     struct {
-        struct Option *orig, *real, *imag;
+        struct Option *orig, *real, *imag, *memory, *nprocs;
     } opt;
     const char *Cellmap_real, *Cellmap_imag;
     const char *Cellmap_orig;
     int inputfd, realfd, imagfd; /* the input and output file descriptors */
     struct Cell_head window;
     DCELL *cell_real, *cell_imag;
-    int rows, cols; /* number of rows & columns */
-    long totsize;   /* Total number of data points */
-    double(
-        *data)[2]; /* Data structure containing real & complex values of FFT */
-    int i, j;      /* Loop control variables */
+    int rows, cols;   /* number of rows & columns */
+    int hcols;        /* number of columns of the half spectrum */
+    double *block;    /* rows of the input map */
+    double(*half)[2]; /* rows k and -k of the half spectrum */
+    struct G_math_fft2d *fft;
+    int i, j, k, n; /* Loop control variables */
+    int nprocs;
 
     G_gisinit(argv[0]);
 
@@ -78,10 +96,10 @@ int main(int argc, char *argv[])
     G_add_keyword(_("imagery"));
     G_add_keyword(_("transformation"));
     G_add_keyword(_("Fast Fourier Transform"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Fast Fourier Transform (FFT) for image processing.");
 
-    /* define options */
     /* define options */
     opt.orig = G_define_standard_option(G_OPT_R_INPUT);
 
@@ -95,12 +113,17 @@ int main(int argc, char *argv[])
     opt.imag->description =
         _("Name for output imaginary part arrays stored as raster map");
 
+    opt.memory = G_define_standard_option(G_OPT_MEMORYMB);
+
+    opt.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
     Cellmap_orig = opt.orig->answer;
     Cellmap_real = opt.real->answer;
     Cellmap_imag = opt.imag->answer;
+    nprocs = G_set_omp_num_threads(opt.nprocs);
 
     inputfd = Rast_open_old(Cellmap_orig, "");
 
@@ -114,71 +137,61 @@ int main(int argc, char *argv[])
     /* get the rows and columns in the current window */
     rows = Rast_window_rows();
     cols = Rast_window_cols();
-    totsize = rows * cols;
+    hcols = cols / 2 + 1;
 
-    /* Allocate appropriate memory for the structure containing
-       the real and complex components of the FFT.  data[...][0] will
-       contain the real, and data[...][1] the complex component.
+    /* Only the nonnegative frequencies of the rows are kept, the others
+       are their complex conjugates. The half spectrum is kept in memory
+       or in a temporary file.
      */
-    data = G_malloc(rows * cols * 2 * sizeof(double));
+    fft = G_math_fft2d_create(rows, cols, atoi(opt.memory->answer), nprocs);
 
-    /* allocate the space for one row of cell map data */
+    /* allocate the space for the rows of cell map data */
+    block = G_malloc((size_t)BLOCK_ROWS * cols * sizeof(double));
+    half = G_malloc(2 * (size_t)hcols * sizeof(*half));
     cell_real = Rast_allocate_d_buf();
     cell_imag = Rast_allocate_d_buf();
 
-#define C(i, j) ((i) * cols + (j))
-
-    /* Read in cell map values */
+    /* Read in cell map values and transform the rows */
     G_message(_("Reading the raster map <%s>..."), Cellmap_orig);
-    for (i = 0; i < rows; i++) {
-        Rast_get_d_row(inputfd, cell_real, i);
-        for (j = 0; j < cols; j++) {
-            data[C(i, j)][0] = cell_real[j];
-            data[C(i, j)][1] = 0.0;
-        }
+    for (i = 0; i < rows; i += n) {
+        n = rows - i < BLOCK_ROWS ? rows - i : BLOCK_ROWS;
+        for (k = 0; k < n; k++)
+            Rast_get_d_row(inputfd, block + (size_t)k * cols, i + k);
+        G_math_fft2d_forward_rows(fft, i, n, block);
 
-        G_percent(i + 1, rows, 2);
+        G_percent(i + n, rows, 2);
     }
 
     /* close input cell map */
     Rast_close(inputfd);
 
-    /* perform FFT */
+    /* perform FFT of the columns */
     G_message(_("Starting FFT..."));
-    fft2(-1, data, totsize, cols, rows);
+    G_math_fft2d_columns(fft, -1);
 
     /* open the output cell maps */
     realfd = Rast_open_fp_new(Cellmap_real);
     imagfd = Rast_open_fp_new(Cellmap_imag);
 
-#define SWAP1(a, b)        \
-    do {                   \
-        double temp = (a); \
-        (a) = (b);         \
-        (b) = temp;        \
-    } while (0)
-
-#define SWAP2(a, b)                        \
-    do {                                   \
-        SWAP1(data[(a)][0], data[(b)][0]); \
-        SWAP1(data[(a)][1], data[(b)][1]); \
-    } while (0)
-
     /* rotate the data array for standard display */
-    G_message(_("Rotating data..."));
-    for (i = 0; i < rows; i++)
-        for (j = 0; j < cols / 2; j++)
-            SWAP2(C(i, j), C(i, j + cols / 2));
-    for (i = 0; i < rows / 2; i++)
-        for (j = 0; j < cols; j++)
-            SWAP2(C(i, j), C(i + rows / 2, j));
-
     G_message(_("Writing transformed data..."));
 
     for (i = 0; i < rows; i++) {
+        k = rotate(i, rows);
+        G_math_fft2d_get_rows(fft, k, 1, half);
+        G_math_fft2d_get_rows(fft, (rows - k) % rows, 1, half + hcols);
+
         for (j = 0; j < cols; j++) {
-            cell_real[j] = data[C(i, j)][0];
-            cell_imag[j] = data[C(i, j)][1];
+            int c = rotate(j, cols);
+
+            if (c < hcols) {
+                cell_real[j] = half[c][0];
+                cell_imag[j] = half[c][1];
+            }
+            else {
+                cell_real[j] = half[hcols + cols - c][0];
+                cell_imag[j] = -half[hcols + cols - c][1];
+            }
         }
         Rast_put_d_row(realfd, cell_real);
         Rast_put_d_row(imagfd, cell_imag);
@@ -197,7 +210,9 @@ int main(int argc, char *argv[])
     fft_colors(Cellmap_imag);
 
     /* Release memory resources */
-    G_free(data);
+    G_free(block);
+    G_free(half);
+    G_math_fft2d_destroy(fft);
 
     G_done_msg(_("FFT is now complete"));
 
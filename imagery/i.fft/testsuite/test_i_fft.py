@@ -36,6 +36,9 @@ class TestIFFT(TestCase):
             "imag_2",
             "combined_real",
             "combined_imag",
+            "real_file",
+            "imag_file",
+            "reconstructed_file",
         ]
         cls.runModule(
             "g.remove",
@@ -193,6 +196,62 @@ class TestIFFT(TestCase):
             "Imaginary component should have valid values",
         )
 
+    def test_out_of_core(self):
+        """Check that a spectrum kept in a temporary file gives the same result."""
+        self.runModule("g.region", n=10, s=0, e=10, w=0, rows=400, cols=401)
+        self.runModule(
+            "r.mapcalc",
+            expression=f"{self.input_raster} = sin(row() * 3) + col() % 7",
+            overwrite=True,
+        )
+        self.assertModule(
+            "i.fft",
+            input=self.input_raster,
+            real=self.real_output,
+            imaginary=self.imag_output,
+            overwrite=True,
+        )
+        # the half spectrum of 400 x 201 complex values needs more than 1 MB
+        self.assertModule(
+            "i.fft",
+            input=self.input_raster,
+            real="real_file",
+            imaginary="imag_file",
+            memory=1,
+            nprocs=2,
+            overwrite=True,
+        )
+        self.assertTrue(
+            np.allclose(
+                array.array(self.real_output), array.array("real_file"), atol=1e-4
+            ),
+            "Real components differ",
+        )
+        self.assertTrue(
+            np.allclose(
+                array.array(self.imag_output), array.array("imag_file"), atol=1e-4
+            ),
+            "Imaginary components differ",
+        )
+
+        self.assertModule(
+            "i.ifft",
+            real="real_file",
+            imaginary="imag_file",
+            output="reconstructed_file",
+            memory=1,
+            nprocs=2,
+            overwrite=True,
+        )
+        self.assertTrue(
+            np.allclose(
+                array.array(self.input_raster),
+                array.array("reconstructed_file"),
+                atol=1e-4,
+            ),
+            "Reconstructed raster does not match the original",
+        )
+
     def test_large_raster_performance(self):
         """Assess performance with a larger raster."""
         self.runModule("g.region", n=90, s=-90, e=180, w=-180, rows=1000, cols=1000)
@@ -8,7 +8,7 @@
  *               Glynn Clements <glynn gclements.plus.com>
  * PURPOSE:      processes the real and imaginary Fourier
  *               components in frequency space and construct raster map
- * COPYRIGHT:    (C) 1999-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 1999-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -37,6 +37,42 @@
 #include <grass/glocale.h>
 #include <grass/gmath.h>
 
+/* rows transformed at once */
+#define BLOCK_ROWS 64
+
+/* row or column of the rotated input with frequency i and vice versa:
+ * the halves are swapped, the low frequencies are in the center */
+static int rotate(int i, int n)
+{
+    int h = n / 2;
+
+    if (i < h)
+        return i + h;
+    if (i < 2 * h)
+        return i - h;
+    return i;
+}
+
+/* read a row of the real and imaginary parts, masked cells are zero */
+static void read_row(int realfd, int imagfd, int maskfd, int row,
+                     DCELL *cell_real, DCELL *cell_imag, CELL *maskbuf)
+{
+    int j, cols = Rast_window_cols();
+
+    Rast_get_d_row(realfd, cell_real, row);
+    Rast_get_d_row(imagfd, cell_imag, row);
+    if (maskfd < 0)
+        return;
+
+    Rast_get_c_row(maskfd, maskbuf, row);
+    for (j = 0; j < cols; j++) {
+        if (maskbuf[j] == 0) {
+            cell_real[j] = 0.0;
+            cell_imag[j] = 0.0;
+        }
+    }
+}
+
 static void fft_colors(const char *name)
 {
     struct Colors colors;
@@ -55,21 +91,23 @@ int main(int argc, char *argv[])
     /* Global variable & function declarations */
     struct GModule *module;
     struct {
-        struct Option *orig, *real, *imag;
+        struct Option *orig, *real, *imag, *memory, *nprocs;
     } opt;
     const char *Cellmap_real, *Cellmap_imag;
     const char *Cellmap_orig;
     int realfd, imagfd, outputfd,
         maskfd; /* the input and output file descriptors */
     struct Cell_head realhead, imaghead;
-    DCELL *cell_real, *cell_imag;
-    CELL *maskbuf;
+    DCELL *cell_real[2], *cell_imag[2];
+    CELL *maskbuf = NULL;
 
-    int i, j;       /* Loop control variables */
-    int rows, cols; /* number of rows & columns */
-    long totsize;   /* Total number of data points */
-    double(
-        *data)[2]; /* Data structure containing real & complex values of FFT */
+    int i, j, k, n;   /* Loop control variables */
+    int rows, cols;   /* number of rows & columns */
+    int hcols;        /* number of columns of the half spectrum */
+    double *block;    /* rows of the output map */
+    double(*half)[2]; /* rows of the half spectrum */
+    struct G_math_fft2d *fft;
+    int nprocs;
 
     G_gisinit(argv[0]);
 
@@ -78,6 +116,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("imagery"));
     G_add_keyword(_("transformation"));
     G_add_keyword(_("Fast Fourier Transform"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Inverse Fast Fourier Transform (IFFT) for image processing.");
 
@@ -95,6 +134,10 @@ int main(int argc, char *argv[])
     opt.orig = G_define_standard_option(G_OPT_R_OUTPUT);
     opt.orig->description = _("Name for output raster map");
 
+    opt.memory = G_define_standard_option(G_OPT_MEMORYMB);
+
+    opt.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /*call parser */
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
@@ -102,6 +145,7 @@ int main(int argc, char *argv[])
     Cellmap_real = opt.real->answer;
     Cellmap_imag = opt.imag->answer;
     Cellmap_orig = opt.orig->answer;
+    nprocs = G_set_omp_num_threads(opt.nprocs);
 
     /* get and compare the original window data */
     Rast_get_cellhd(Cellmap_real, "", &realhead);
@@ -124,105 +168,91 @@ int main(int argc, char *argv[])
     /* get the rows and columns in the current window */
     rows = Rast_window_rows();
     cols = Rast_window_cols();
-    totsize = rows * cols;
+    hcols = cols / 2 + 1;
 
-    /* Allocate appropriate memory for the structure containing
-       the real and complex components of the FFT.  DATA[0] will
-       contain the real, and DATA[1] the complex component.
+    /* The output is the real part of the inverse transform, which is the
+       inverse transform of the Hermitian part (X(k) + conj(X(-k))) / 2 of
+       the input. Only the nonnegative frequencies of its rows are kept in
+       memory or in a temporary file.
      */
-    data = G_malloc(rows * cols * 2 * sizeof(double));
-
-    /* allocate the space for one row of cell map data */
-    cell_real = Rast_allocate_d_buf();
-    cell_imag = Rast_allocate_d_buf();
-
-#define C(i, j) ((i) * cols + (j))
+    fft = G_math_fft2d_create(rows, cols, atoi(opt.memory->answer), nprocs);
+
+    /* allocate the space for the rows of cell map data */
+    block = G_malloc((size_t)BLOCK_ROWS * cols * sizeof(double));
+    half = G_malloc((size_t)BLOCK_ROWS * hcols * sizeof(*half));
+    for (i = 0; i < 2; i++) {
+        cell_real[i] = Rast_allocate_d_buf();
+        cell_imag[i] = Rast_allocate_d_buf();
+    }
+    maskfd = Rast_maskfd();
+    if (maskfd >= 0)
+        maskbuf = Rast_allocate_c_buf();
 
-    /* Read in cell map values */
+    /* Read in and rotate cell map values, rows of frequency k and -k
+       are read together */
     G_message(_("Reading raster maps..."));
-    for (i = 0; i < rows; i++) {
-        Rast_get_d_row(realfd, cell_real, i);
-        Rast_get_d_row(imagfd, cell_imag, i);
-        for (j = 0; j < cols; j++) {
-            data[C(i, j)][0] = cell_real[j];
-            data[C(i, j)][1] = cell_imag[j];
+    for (k = 0; k < rows; k += n) {
+        n = rows - k < BLOCK_ROWS ? rows - k : BLOCK_ROWS;
+        for (i = 0; i < n; i++) {
+            double(*h)[2] = half + (size_t)i * hcols;
+
+            read_row(realfd, imagfd, maskfd, rotate(k + i, rows),
+                     cell_real[0], cell_imag[0], maskbuf);
+            read_row(realfd, imagfd, maskfd,
+                     rotate((rows - k - i) % rows, rows), cell_real[1],
+                     cell_imag[1], maskbuf);
+
+            for (j = 0; j < hcols; j++) {
+                int c0 = rotate(j, cols), c1 = rotate((cols - j) % cols, cols);
+
+                h[j][0] = 0.5 * (cell_real[0][c0] + cell_real[1][c1]);
+                h[j][1] = 0.5 * (cell_imag[0][c0] - cell_imag[1][c1]);
+            }
         }
-        G_percent(i + 1, rows, 2);
+        G_math_fft2d_put_rows(fft, k, n, half);
+
+        G_percent(k + n, rows, 2);
     }
 
     /* close input cell maps */
     Rast_close(realfd);
     Rast_close(imagfd);
-
-    /* Read in cell map values */
-    G_message(_("Masking raster maps..."));
-    maskfd = Rast_maskfd();
     if (maskfd >= 0) {
-        maskbuf = Rast_allocate_c_buf();
-
-        for (i = 0; i < rows; i++) {
-            Rast_get_c_row(maskfd, maskbuf, i);
-            for (j = 0; j < cols; j++) {
-                if (maskbuf[j] == 0) {
-                    data[C(i, j)][0] = 0.0;
-                    data[C(i, j)][1] = 0.0;
-                }
-            }
-            G_percent(i + 1, rows, 2);
-        }
-
         Rast_close(maskfd);
         G_free(maskbuf);
     }
 
-#define SWAP1(a, b)        \
-    do {                   \
-        double temp = (a); \
-        (a) = (b);         \
-        (b) = temp;        \
-    } while (0)
-
-#define SWAP2(a, b)                        \
-    do {                                   \
-        SWAP1(data[(a)][0], data[(b)][0]); \
-        SWAP1(data[(a)][1], data[(b)][1]); \
-    } while (0)
-
-    /* rotate the data array for standard display */
-    G_message(_("Rotating data..."));
-    for (i = 0; i < rows; i++)
-        for (j = 0; j < cols / 2; j++)
-            SWAP2(C(i, j), C(i, j + cols / 2));
-    for (i = 0; i < rows / 2; i++)
-        for (j = 0; j < cols; j++)
-            SWAP2(C(i, j), C(i + rows / 2, j));
-
-    /* perform inverse FFT */
+    /* perform inverse FFT of the columns */
     G_message(_("Starting Inverse FFT..."));
-    fft2(1, data, totsize, cols, rows);
+    G_math_fft2d_columns(fft, 1);
 
     /* open the output cell map */
     outputfd = Rast_open_fp_new(Cellmap_orig);
 
-    /* Write out result to a new cell map */
+    /* Transform the rows and write out result to a new cell map */
     G_message(_("Writing raster map <%s>..."), Cellmap_orig);
-    for (i = 0; i < rows; i++) {
-        for (j = 0; j < cols; j++)
-            cell_real[j] = data[C(i, j)][0];
-        Rast_put_d_row(outputfd, cell_real);
+    for (i = 0; i < rows; i += n) {
+        n = rows - i < BLOCK_ROWS ? rows - i : BLOCK_ROWS;
+        G_math_fft2d_inverse_rows(fft, i, n, block);
+        for (k = 0; k < n; k++)
+            Rast_put_d_row(outputfd, block + (size_t)k * cols);
 
-        G_percent(i + 1, rows, 2);
+        G_percent(i + n, rows, 2);
     }
 
     Rast_close(outputfd);
 
-    G_free(cell_real);
-    G_free(cell_imag);
+    for (i = 0; i < 2; i++) {
+        G_free(cell_real[i]);
+        G_free(cell_imag[i]);
+    }
 
     fft_colors(Cellmap_orig);
 
     /* Release memory resources */
-    G_free(data);
+    G_free(block);
+    G_free(half);
+    G_math_fft2d_destroy(fft);
 
     G_done_msg(" ");
 
@@ -10,7 +10,7 @@
  * PURPOSE:      Calculate TOA Radiance or Reflectance and Kinetic Temperature
  *               for Landsat 1/2/3/4/5 MS, 4/5 TM, 7 ETM+, and 8 OLI/TIRS
  *
- * COPYRIGHT:    (C) 2006-2013 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2006-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General
  *               Public License (>=v2). Read the file COPYING that
@@ -28,6 +28,56 @@
 
 #define QCALMAX 65536 /* L1-7=256 but L8=65536 */
 
+/* radiance, temperature or reflectance of one row of a band */
+static void toar_row(void *inrast, RASTER_MAP_TYPE in_data_type, int ncols,
+                     band_data *band, int radiance, int method, double scale,
+                     DCELL *outrast)
+{
+    void *ptr;
+    double qcal, rad, ref;
+    int col;
+
+    for (col = 0; col < ncols; col++) {
+        switch (in_data_type) {
+        case CELL_TYPE:
+            ptr = (void *)((CELL *)inrast + col);
+            qcal = (double)((CELL *)inrast)[col];
+            break;
+        case FCELL_TYPE:
+            ptr = (void *)((FCELL *)inrast + col);
+            qcal = (double)((FCELL *)inrast)[col];
+            break;
+        case DCELL_TYPE:
+            ptr = (void *)((DCELL *)inrast + col);
+            qcal = (double)((DCELL *)inrast)[col];
+            break;
+        default:
+            ptr = NULL;
+            qcal = -1.;
+        }
+        if (Rast_is_null_value(ptr, in_data_type) || qcal < band->qcalmin) {
+            Rast_set_d_null_value(outrast + col, 1);
+        }
+        else {
+            rad = lsat_qcal2rad(qcal, band);
+            if (radiance) {
+                ref = rad;
+            }
+            else {
+                if (band->thermal) {
+                    ref = lsat_rad2temp(rad, band);
+                }
+                else {
+                    ref = lsat_rad2ref(rad, band) * scale;
+                    if (ref < 0. && method > DOS)
+                        ref = 0.;
+                }
+            }
+            outrast[col] = ref;
+        }
+    }
+}
+
 int main(int argc, char *argv[])
 {
     struct History history;
@@ -36,15 +86,17 @@ int main(int argc, char *argv[])
 
     struct Cell_head cellhd, orig_cellhd;
 
-    void *inrast, *outrast;
+    void *inrast, **inrows;
+    DCELL **outrows;
     int infd, outfd;
     void *ptr;
-    int nrows, ncols, row, col;
+    int nrows, ncols, row, col, row0, nbuf, block_rows, nprocs;
 
     RASTER_MAP_TYPE in_data_type;
 
     struct Option *input_prefix, *output_prefix, *metfn, *sensor, *adate,
-        *pdate, *elev, *bgain, *metho, *perc, *dark, *atmo, *lsatmet, *oscale;
+        *pdate, *elev, *bgain, *metho, *perc, *dark, *atmo, *lsatmet, *oscale,
+        *opt_nprocs;
     char *inputname, *met, *outputname, *sensorname;
     struct Flag *frad, *print_meta, *named;
 
@@ -52,7 +104,7 @@ int main(int argc, char *argv[])
     char band_in[GNAME_MAX], band_out[GNAME_MAX];
     int i, j, q, method, pixel, dn_dark[MAX_BANDS], dn_mode[MAX_BANDS], dn_sat;
     int overwrite;
-    double qcal, rad, ref, percent, ref_mode, rayleigh, scale;
+    double percent, ref_mode, rayleigh, scale;
     unsigned long hist[QCALMAX], h_max;
 
     struct Colors colors;
@@ -75,6 +127,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("atmospheric correction"));
     G_add_keyword(_("satellite"));
     G_add_keyword(_("Landsat"));
+    G_add_keyword(_("parallel"));
     module->overwrite = TRUE;
 
     /* It defines the different parameters */
@@ -208,6 +261,8 @@ int main(int argc, char *argv[])
     oscale->required = NO;
     oscale->description = _("Scale factor for output");
 
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /* define the different flags */
     frad = G_define_flag();
     frad->key = 'r';
@@ -238,6 +293,10 @@ int main(int argc, char *argv[])
 
     overwrite = G_check_overwrite(argc, argv);
 
+    nprocs = G_set_omp_num_threads(opt_nprocs);
+    /* rows read at once and processed in parallel */
+    block_rows = 4 * nprocs;
+
     Rast_get_window(&orig_cellhd);
 
     G_zero(&lsat, sizeof(lsat));
@@ -565,9 +624,13 @@ int main(int argc, char *argv[])
         if ((outfd = Rast_open_new(band_out, DCELL_TYPE)) < 0)
             G_fatal_error(_("Unable to create raster map <%s>"), band_out);
 
-        /* allocate input and output buffer */
-        inrast = Rast_allocate_buf(in_data_type);
-        outrast = Rast_allocate_buf(DCELL_TYPE);
+        /* allocate input and output buffers */
+        inrows = G_malloc(block_rows * sizeof(void *));
+        outrows = G_malloc(block_rows * sizeof(DCELL *));
+        for (row = 0; row < block_rows; row++) {
+            inrows[row] = Rast_allocate_buf(in_data_type);
+            outrows[row] = Rast_allocate_d_buf();
+        }
 
         nrows = Rast_window_rows();
         ncols = Rast_window_cols();
@@ -577,51 +640,22 @@ int main(int argc, char *argv[])
                              : (lsat.band[i].thermal) ? _("temperature")
                                                       : _("reflectance")),
                             band_in, band_out);
-        for (row = 0; row < nrows; row++) {
-            G_percent(row, nrows, 2);
-
-            Rast_get_row(infd, inrast, row, in_data_type);
-            for (col = 0; col < ncols; col++) {
-                switch (in_data_type) {
-                case CELL_TYPE:
-                    ptr = (void *)((CELL *)inrast + col);
-                    qcal = (double)((CELL *)inrast)[col];
-                    break;
-                case FCELL_TYPE:
-                    ptr = (void *)((FCELL *)inrast + col);
-                    qcal = (double)((FCELL *)inrast)[col];
-                    break;
-                case DCELL_TYPE:
-                    ptr = (void *)((DCELL *)inrast + col);
-                    qcal = (double)((DCELL *)inrast)[col];
-                    break;
-                default:
-                    ptr = NULL;
-                    qcal = -1.;
-                }
-                if (Rast_is_null_value(ptr, in_data_type) ||
-                    qcal < lsat.band[i].qcalmin) {
-                    Rast_set_d_null_value((DCELL *)outrast + col, 1);
-                }
-                else {
-                    rad = lsat_qcal2rad(qcal, &lsat.band[i]);
-                    if (frad->answer) {
-                        ref = rad;
-                    }
-                    else {
-                        if (lsat.band[i].thermal) {
-                            ref = lsat_rad2temp(rad, &lsat.band[i]);
-                        }
-                        else {
-                            ref = lsat_rad2ref(rad, &lsat.band[i]) * scale;
-                            if (ref < 0. && method > DOS)
-                                ref = 0.;
-                        }
-                    }
-                    ((DCELL *)outrast)[col] = ref;
-                }
-            }
-            Rast_put_row(outfd, outrast, DCELL_TYPE);
+        for (row0 = 0; row0 < nrows; row0 += block_rows) {
+            G_percent(row0, nrows, 2);
+
+            nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
+
+            /* reading rows is not thread-safe */
+            for (row = 0; row < nbuf; row++)
+                Rast_get_row(infd, inrows[row], row0 + row, in_data_type);
+
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) schedule(dynamic)
+            for (row = 0; row < nbuf; row++)
+                toar_row(inrows[row], in_data_type, ncols, &lsat.band[i],
+                         frad->answer, method, scale, outrows[row]);
+
+            for (row = 0; row < nbuf; row++)
+                Rast_put_d_row(outfd, outrows[row]);
         }
         G_percent(1, 1, 1);
 
@@ -631,9 +665,13 @@ int main(int argc, char *argv[])
             ref_mode = lsat_rad2ref(ref_mode, &lsat.band[i]);
         }
 
-        G_free(inrast);
+        for (row = 0; row < block_rows; row++) {
+            G_free(inrows[row]);
+            G_free(outrows[row]);
+        }
+        G_free(inrows);
         Rast_close(infd);
-        G_free(outrast);
+        G_free(outrows);
         Rast_close(outfd);
 
         /*
@@ -291,6 +291,37 @@ class TestLandsatTOARBasic(TestCase):
             precision=1e-6,
         )
 
+    def test_nprocs(self):
+        """Output with several threads is identical to one thread"""
+        for method in ("uncorrected", "dos1"):
+            outputs = {}
+            for nprocs in (1, 4):
+                prefix = f"{self.output_prefix}{method}_nprocs{nprocs}_"
+                outputs[nprocs] = prefix
+                self.addCleanup(
+                    self.runModule,
+                    "g.remove",
+                    flags="f",
+                    type="raster",
+                    pattern=f"{prefix}*",
+                )
+                self.assertModule(
+                    "i.landsat.toar",
+                    input=self.input_prefix,
+                    output=prefix,
+                    metfile=self.metfile,
+                    method=method,
+                    nprocs=nprocs,
+                    overwrite=True,
+                )
+            for band in ("1", "10"):
+                self.assertRastersNoDifference(
+                    actual=f"{outputs[4]}{band}",
+                    reference=f"{outputs[1]}{band}",
+                    precision=0,
+                )
+
+
 
 if __name__ == "__main__":
     test()
@@ -1,25 +1,54 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include "global.h"
+#include "local_proto.h"
+
+/* columns evaluated together */
+#define CHUNK 256
 
 static double chisq[] = {18.465, 14.860, 13.277, 11.668, 9.488, 7.779,
                          5.989,  4.878,  3.357,  2.195,  1.649, 1.064,
                          0.711,  0.429,  0.297,  0.0};
 
-int classify(CELL *class, CELL *reject, int ncols)
+void init_classify_work(struct classify_work *w)
+{
+    w->x = (DCELL **)G_malloc(Ref.nfiles * sizeof(DCELL *));
+    w->ll = (double *)G_malloc((size_t)S.nsigs * CHUNK * sizeof(double));
+    w->tmp = I_alloc_discriminant_work(&D);
+}
+
+void free_classify_work(struct classify_work *w)
+{
+    G_free(w->x);
+    G_free(w->ll);
+    G_free(w->tmp);
+}
+
+/* classify one row, cell[band] are the values of the bands,
+ * w is the work space of the calling thread */
+int classify(DCELL **cell, CELL *class, CELL *reject, int ncols,
+             struct classify_work *w)
 {
-    int i, j;
+    int i;
     int nfiles = Ref.nfiles;
     int c;
     int cc = 0;
     int band;
-    int col;
+    int col, col0, n;
     int valid_data;
-    double max, tot, sum;
+    double max, tot;
     double rej;
-    struct One_Sig *s;
 
     for (col = 0; col < ncols; col++) {
+        /* discriminant functions of all classes for the next chunk */
+        col0 = col - col % CHUNK;
+        if (col == col0) {
+            n = ncols - col0 < CHUNK ? ncols - col0 : CHUNK;
+            for (band = 0; band < nfiles; band++)
+                w->x[band] = cell[band] + col0;
+            I_discriminant_batch(&D, w->x, n, w->ll, w->tmp);
+        }
+
         valid_data = 0;
         for (band = 0; band < nfiles; band++)
             if ((valid_data = !Rast_is_d_null_value(&cell[band][col])))
@@ -37,6 +66,9 @@ int classify(CELL *class, CELL *reject, int ncols)
             /* The following test is designed to speed up the search for the
              * most probable class.  In fact if the B[] array is sorted, the
              * search  could  be terminated sooner.
+             * The discriminant functions are already evaluated for the
+             * chunk, the test is kept so that the classes are the same as
+             * those of the cell by cell search.
              */
             if (B[c] <= max)
                 continue;
@@ -54,22 +86,7 @@ int classify(CELL *class, CELL *reject, int ncols)
                All  principal  minors  must also have non-negative determinants.
              */
 
-            s = &S.sig[c];
-
-            tot = 0.0;
-            for (band = 0; band < nfiles; band++) {
-                double p;
-
-                p = P[band] = cell[band][col] - s->mean[band];
-                tot += p * p * s->var[band][band];
-            }
-            tot = B[c] - 0.5 * tot;
-
-            sum = 0.0;
-            for (i = 0; i < nfiles - 1; i++)
-                for (j = i + 1; j < nfiles; j++)
-                    sum += P[j] * P[i] * s->var[j][i];
-            tot -= sum;
+            tot = w->ll[(size_t)c * n + col - col0];
             if (tot > max) {
                 cc = c;
                 max = tot;
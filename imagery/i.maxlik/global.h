@@ -6,10 +6,11 @@ extern char *sigfile;
 extern struct Ref Ref;
 extern struct Signature S;
 extern DCELL **cell;
+extern int block_rows;
 extern int *cellfd;
 extern CELL *class_cell, *reject_cell;
 extern int class_fd, reject_fd;
 extern char *reject_name;
 extern char class_name[GNAME_MAX];
 extern double *B;
-extern double *P;
+extern struct I_discriminant D;
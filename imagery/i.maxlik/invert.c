@@ -49,6 +49,10 @@ int invert_signatures(void)
     G_free(ik);
     G_free(jk);
 
+    I_init_discriminant(&D, S.nbands, S.nsigs);
+    for (c = 0; c < S.nsigs; c++)
+        I_set_discriminant(&D, c, B[c], S.sig[c].mean, S.sig[c].var, 1);
+
     return bad ? 0 : 1;
 }
 
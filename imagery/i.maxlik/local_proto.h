@@ -1,5 +1,13 @@
 /* classify.c */
-int classify(CELL *, CELL *, int);
+struct classify_work {
+    DCELL **x;   /* columns of a chunk in each band */
+    double *ll;  /* discriminant functions of a chunk */
+    double *tmp; /* work space of I_discriminant_batch() */
+};
+
+void init_classify_work(struct classify_work *);
+void free_classify_work(struct classify_work *);
+int classify(DCELL **, CELL *, CELL *, int, struct classify_work *);
 
 /* hist.c */
 int make_history(char *, char *, char *, char *);
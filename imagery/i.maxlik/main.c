@@ -10,7 +10,7 @@
  *               Glynn Clements <glynn gclements.plus.com>,
  *               Jan-Oliver Wagner <jan intevation.de>
  * PURPOSE:      maximum likelihood classification of image groups
- * COPYRIGHT:    (C) 1999-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 1999-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -19,6 +19,9 @@
  *****************************************************************************/
 
 #include <stdlib.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/glocale.h>
@@ -31,13 +34,14 @@ char *sigfile;
 struct Ref Ref;
 struct Signature S;
 DCELL **cell;
+int block_rows;
 int *cellfd;
 CELL *class_cell, *reject_cell;
 int class_fd, reject_fd;
 char *reject_name;
 char class_name[GNAME_MAX];
 double *B;
-double *P;
+struct I_discriminant D;
 CELL cat;
 
 int main(int argc, char *argv[])
@@ -46,12 +50,14 @@ int main(int argc, char *argv[])
     struct Colors colr;
     struct Ref group_ref;
     int nrows, ncols;
-    int row;
+    int row, row0, nbuf;
     int band;
     int i;
+    int nprocs;
+    struct classify_work *work;
     struct GModule *module;
     struct {
-        struct Option *group, *subgroup, *sigfile, *class, *reject;
+        struct Option *group, *subgroup, *sigfile, *class, *reject, *nprocs;
     } parm;
     char xmapset[GMAPSET_MAX];
 
@@ -62,6 +68,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("classification"));
     G_add_keyword(_("Maximum Likelihood Classification"));
     G_add_keyword("MLC");
+    G_add_keyword(_("parallel"));
     module->label =
         _("Classifies the cell spectral reflectances in imagery data.");
     module->description =
@@ -93,6 +100,8 @@ int main(int argc, char *argv[])
     parm.reject->description =
         _("Name for output raster map holding reject threshold results");
 
+    parm.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
@@ -108,32 +117,66 @@ int main(int argc, char *argv[])
     if (G_legal_filename(class_name) < 0)
         G_fatal_error(_("<%s> is an illegal file name"), class_name);
 
+    nprocs = G_set_omp_num_threads(parm.nprocs);
+    /* rows read at once and classified in parallel */
+    block_rows = 4 * nprocs;
+
     open_files();
 
     nrows = Rast_window_rows();
     ncols = Rast_window_cols();
 
-    for (row = 0; row < nrows; row++) {
-        G_percent(row, nrows, 2);
-
-        for (band = 0; band < Ref.nfiles; band++)
-            Rast_get_d_row(cellfd[band], cell[band], row);
-
-        classify(class_cell, reject_cell, ncols);
-        if (S.have_oclass) {
-            for (int col = 0; col < ncols; col++) {
-                /* Predicted classes start at 1 but signature array is 0 based
-                 */
-                if (Rast_is_c_null_value(&class_cell[col]) == 0)
-                    class_cell[col] = S.sig[class_cell[col] - 1].oclass;
+    work = G_malloc(nprocs * sizeof(struct classify_work));
+    for (i = 0; i < nprocs; i++)
+        init_classify_work(&work[i]);
+
+    for (row0 = 0; row0 < nrows; row0 += block_rows) {
+        G_percent(row0, nrows, 2);
+
+        nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
+
+        /* reading rows is not thread-safe */
+        for (row = 0; row < nbuf; row++)
+            for (band = 0; band < Ref.nfiles; band++)
+                Rast_get_d_row(cellfd[band], cell[row * Ref.nfiles + band],
+                               row0 + row);
+
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) schedule(dynamic)
+        for (row = 0; row < nbuf; row++) {
+            int t = 0;
+            CELL *class_row = class_cell + (size_t)row * ncols;
+
+#if defined(_OPENMP)
+            t = omp_get_thread_num();
+#endif
+            classify(&cell[row * Ref.nfiles], class_row,
+                     reject_cell ? reject_cell + (size_t)row * ncols : NULL,
+                     ncols, &work[t]);
+            if (S.have_oclass) {
+                for (int col = 0; col < ncols; col++) {
+                    /* Predicted classes start at 1 but signature array is 0
+                     * based */
+                    if (Rast_is_c_null_value(&class_row[col]) == 0)
+                        class_row[col] = S.sig[class_row[col] - 1].oclass;
+                }
             }
         }
-        Rast_put_row(class_fd, class_cell, CELL_TYPE);
-        if (reject_fd > 0)
-            Rast_put_row(reject_fd, reject_cell, CELL_TYPE);
+
+        for (row = 0; row < nbuf; row++) {
+            Rast_put_row(class_fd, class_cell + (size_t)row * ncols,
+                         CELL_TYPE);
+            if (reject_fd > 0)
+                Rast_put_row(reject_fd, reject_cell + (size_t)row * ncols,
+                             CELL_TYPE);
+        }
     }
     G_percent(nrows, nrows, 2);
 
+    for (i = 0; i < nprocs; i++)
+        free_classify_work(&work[i]);
+    G_free(work);
+    I_free_discriminant(&D);
+
     Rast_close(class_fd);
     if (reject_fd > 0)
         Rast_close(reject_fd);
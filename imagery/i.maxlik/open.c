@@ -57,23 +57,26 @@ int open_files(void)
     B = (double *)G_malloc(S.nsigs * sizeof(double));
     invert_signatures();
 
-    cell = (DCELL **)G_malloc(Ref.nfiles * sizeof(DCELL *));
+    /* block_rows rows of each band: cell[row * Ref.nfiles + band] */
+    cell = (DCELL **)G_malloc(block_rows * Ref.nfiles * sizeof(DCELL *));
     cellfd = (int *)G_malloc(Ref.nfiles * sizeof(int));
-    P = (double *)G_malloc(Ref.nfiles * sizeof(double));
-    for (n = 0; n < Ref.nfiles; n++) {
+    for (n = 0; n < block_rows * Ref.nfiles; n++)
         cell[n] = Rast_allocate_d_buf();
+    for (n = 0; n < Ref.nfiles; n++) {
         name = Ref.file[n].name;
         mapset = Ref.file[n].mapset;
         cellfd[n] = Rast_open_old(name, mapset);
     }
 
     class_fd = Rast_open_c_new(class_name);
-    class_cell = Rast_allocate_c_buf();
+    class_cell = (CELL *)G_malloc((size_t)block_rows * Rast_window_cols() *
+                                  sizeof(CELL));
 
     reject_cell = NULL;
     if (reject_name) {
         reject_fd = Rast_open_c_new(reject_name);
-        reject_cell = Rast_allocate_c_buf();
+        reject_cell = (CELL *)G_malloc((size_t)block_rows *
+                                       Rast_window_cols() * sizeof(CELL));
     }
 
     return 0;
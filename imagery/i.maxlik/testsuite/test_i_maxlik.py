@@ -218,5 +218,119 @@ class SuccessTest(TestCase):
         res.close()
 
 
+class NprocsTest(TestCase):
+    """Test that the classification does not depend on the number of threads"""
+
+    @classmethod
+    def setUpClass(cls):
+        """Generate bands and signatures on a region of several row blocks"""
+        cls.use_temp_region()
+        # more columns than evaluated together, not a multiple of them
+        cls.runModule("g.region", n=150, s=0, e=700, w=0, res=1)
+        if os.name == "nt":
+            cls.libc = ctypes.cdll.LoadLibrary(ctypes.util.find_library("msvcrt"))
+        else:
+            cls.libc = ctypes.cdll.LoadLibrary(ctypes.util.find_library("c"))
+        cls.mpath = utils.decode(G_mapset_path())
+        cls.mapset_name = Mapset().name
+        cls.sig_name = tempname(10)
+        cls.sig_dir = f"{cls.mpath}/signatures/sig/{cls.sig_name}"
+        cls.b1 = tempname(10)
+        cls.b2 = tempname(10)
+        cls.group = tempname(10)
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.b1}=col() / 7.0 + rand(-10.0, 10.0)",
+            seed=1,
+            quiet=True,
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.b2}=if(row() == 30, null(), "
+            "row() / 1.5 + rand(-10.0, 10.0))",
+            seed=2,
+            quiet=True,
+        )
+        Rg = Ref()
+        I_init_group_ref(ctypes.byref(Rg))
+        I_add_file_to_group_ref(cls.b1, cls.mapset_name, ctypes.byref(Rg))
+        I_add_file_to_group_ref(cls.b2, cls.mapset_name, ctypes.byref(Rg))
+        I_put_group_ref(cls.group, ctypes.byref(Rg))
+        I_put_subgroup_ref(cls.group, cls.group, ctypes.byref(Rg))
+
+        So = Signature()
+        I_init_signatures(ctypes.byref(So), 2)
+        So.title = b"Overlapping classes"
+        So.semantic_labels[0] = ctypes.create_string_buffer(b"band1")
+        So.semantic_labels[1] = ctypes.create_string_buffer(b"band2")
+        classes = [
+            (25, 25, 60, 10, 40),
+            (50, 50, 90, -20, 70),
+            (75, 75, 50, 5, 120),
+            (60, 20, 30, 0, 30),
+        ]
+        for i, (m1, m2, v11, v21, v22) in enumerate(classes):
+            I_new_signature(ctypes.byref(So))
+            So.sig[i].status = 1
+            So.sig[i].have_color = 0
+            So.sig[i].npoints = 100
+            So.sig[i].desc = f"class {i + 1}".encode()
+            So.sig[i].mean[0] = m1
+            So.sig[i].mean[1] = m2
+            So.sig[i].var[0][0] = v11
+            So.sig[i].var[1][0] = v21
+            So.sig[i].var[1][1] = v22
+        p_new_sigfile = I_fopen_signature_file_new(cls.sig_name)
+        I_write_signatures(p_new_sigfile, ctypes.byref(So))
+        cls.libc.fclose(p_new_sigfile)
+
+        cls.class1 = tempname(10)
+        cls.reject1 = tempname(10)
+        cls.runModule(
+            "i.maxlik",
+            group=cls.group,
+            subgroup=cls.group,
+            signaturefile=cls.sig_name,
+            output=cls.class1,
+            reject=cls.reject1,
+            nprocs=1,
+            quiet=True,
+        )
+        cls.outputs = [cls.b1, cls.b2, cls.class1, cls.reject1]
+
+    @classmethod
+    def tearDownClass(cls):
+        """Remove the temporary region and generated data"""
+        cls.del_temp_region()
+        shutil.rmtree(cls.sig_dir, ignore_errors=True)
+        cls.runModule(
+            "g.remove", flags="f", type="raster", name=cls.outputs, quiet=True
+        )
+        cls.runModule("g.remove", flags="f", type="group", name=cls.group, quiet=True)
+
+    def test_reference(self):
+        """All classes are assigned in the reference"""
+        self.assertRasterMinMax(map=self.class1, refmin=1, refmax=4)
+
+    def test_nprocs(self):
+        """Classes and reject thresholds are identical with several threads"""
+        for nprocs in (2, 4, 7):
+            output = tempname(10)
+            reject = tempname(10)
+            self.outputs.extend([output, reject])
+            self.assertModule(
+                "i.maxlik",
+                group=self.group,
+                subgroup=self.group,
+                signaturefile=self.sig_name,
+                output=output,
+                reject=reject,
+                nprocs=nprocs,
+                quiet=True,
+            )
+            self.assertRastersNoDifference(output, reference=self.class1, precision=0)
+            self.assertRastersNoDifference(reject, reference=self.reject1, precision=0)
+
+
 if __name__ == "__main__":
     test()
@@ -13,12 +13,12 @@
 #include <math.h>
 #include "global.h"
 
-void p_bilinear(struct cache *ibuffer,   /* input buffer                */
-                void *obufptr,           /* ptr in output buffer        */
-                int cell_type,           /* raster map type of obufptr  */
-                double *row_idx,         /* row index                   */
-                double *col_idx,         /* column index                */
-                struct Cell_head *cellhd /* information of output map   */
+void p_bilinear(struct R_block_cache *ibuffer, /* input buffer */
+                void *obufptr,                 /* ptr in output buffer */
+                int cell_type,                 /* raster map type of obufptr */
+                double *row_idx,               /* row index */
+                double *col_idx,               /* column index */
+                struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
@@ -27,6 +27,7 @@ void p_bilinear(struct cache *ibuffer,   /* input buffer                */
     double t, u;  /* intermediate slope            */
     DCELL result; /* result of interpolation       */
     DCELL c[2][2];
+    DCELL w[4];
 
     /* cut indices to integer */
     row = (int)floor(*row_idx - 0.5);
@@ -39,9 +40,10 @@ void p_bilinear(struct cache *ibuffer,   /* input buffer                */
         return;
     }
 
+    Rast_get_block_cache_d_window(ibuffer, row, col, 2, 2, w);
     for (i = 0; i < 2; i++)
         for (j = 0; j < 2; j++) {
-            const DCELL *cellp = CPTR(ibuffer, row + i, col + j);
+            const DCELL *cellp = &w[i * 2 + j];
 
             if (Rast_is_d_null_value(cellp)) {
                 Rast_set_null_value(obufptr, 1, cell_type);
@@ -12,17 +12,17 @@
 #include <math.h>
 #include "global.h"
 
-void p_cubic_f(struct cache *ibuffer,   /* input buffer                */
-               void *obufptr,           /* ptr in output buffer        */
-               int cell_type,           /* raster map type of obufptr  */
-               double *row_idx,         /* row index                   */
-               double *col_idx,         /* column index                */
-               struct Cell_head *cellhd /* cell header of input layer  */
+void p_cubic_f(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double *row_idx,               /* row index */
+               double *col_idx,               /* column index */
+               struct Cell_head *cellhd       /* cell header of input layer */
 )
 {
     /* start nearest neighbor to do some basic tests */
     int row, col; /* row/col of nearest neighbor   */
-    DCELL *cellp, cell;
+    DCELL cell;
 
     /* cut indices to integer */
     row = (int)floor(*row_idx);
@@ -34,13 +34,12 @@ void p_cubic_f(struct cache *ibuffer,   /* input buffer                */
         return;
     }
 
-    cellp = CPTR(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
     /* if nearest is null, all the other interps will be null */
-    if (Rast_is_d_null_value(cellp)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
-    cell = *cellp;
 
     p_cubic(ibuffer, obufptr, cell_type, row_idx, col_idx, cellhd);
     /* fallback to bilinear if cubic is null */
@@ -1,4 +1,4 @@
-/* cache for raster data, code taken from r.proj */
+/* cache for the elevation map, code taken from r.proj */
 
 /* These next defines determine the size of the sub-window that will
  * be held in memory.  Larger values will require
@@ -25,7 +25,7 @@ struct cache {
     int *refs;
 };
 
-typedef void (*func)(struct cache *, void *, int, double *, double *,
+typedef void (*func)(struct R_block_cache *, void *, int, double *, double *,
                      struct Cell_head *);
 
 #define BKIDX(c, y, x) ((y) * (c)->stride + (x))
@@ -17,17 +17,17 @@
 #include <math.h>
 #include "global.h"
 
-void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
-               void *obufptr,           /* ptr in output buffer          */
-               int cell_type,           /* raster map type of obufptr    */
-               double *row_idx,         /* row index (decimal)           */
-               double *col_idx,         /* column index (decimal)        */
-               struct Cell_head *cellhd /* information of output map     */
+void p_lanczos(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double *row_idx,               /* row index (decimal) */
+               double *col_idx,               /* column index (decimal) */
+               struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
     int col; /* column indices for interp     */
-    int i, j, k;
+    int k;
     DCELL t, u;   /* intermediate slope            */
     DCELL result; /* result of interpolation       */
     DCELL cell[25];
@@ -43,16 +43,11 @@ void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    k = 0;
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 5; j++) {
-            const DCELL *cellp = CPTR(ibuffer, row - 2 + i, col - 2 + j);
-
-            if (Rast_is_d_null_value(cellp)) {
-                Rast_set_null_value(obufptr, 1, cell_type);
-                return;
-            }
-            cell[k++] = *cellp;
+    Rast_get_block_cache_d_window(ibuffer, row - 2, col - 2, 5, 5, cell);
+    for (k = 0; k < 25; k++) {
+        if (Rast_is_d_null_value(&cell[k])) {
+            Rast_set_null_value(obufptr, 1, cell_type);
+            return;
         }
     }
 
@@ -65,17 +60,17 @@ void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
     Rast_set_d_value(obufptr, result, cell_type);
 }
 
-void p_lanczos_f(struct cache *ibuffer,   /* input buffer                  */
-                 void *obufptr,           /* ptr in output buffer          */
-                 int cell_type,           /* raster map type of obufptr    */
-                 double *row_idx,         /* row index (decimal)           */
-                 double *col_idx,         /* column index (decimal)        */
-                 struct Cell_head *cellhd /* information of output map     */
+void p_lanczos_f(struct R_block_cache *ibuffer, /* input buffer */
+                 void *obufptr,                 /* ptr in output buffer */
+                 int cell_type,                 /* raster map type of obufptr */
+                 double *row_idx,               /* row index (decimal) */
+                 double *col_idx,               /* column index (decimal) */
+                 struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
     int col; /* column indices for interp     */
-    DCELL *cellp, cell;
+    DCELL cell;
 
     /* cut indices to integer */
     row = (int)floor(*row_idx);
@@ -87,13 +82,12 @@ void p_lanczos_f(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    cellp = CPTR(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
     /* if nearest is null, all the other interps will be null */
-    if (Rast_is_d_null_value(cellp)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
-    cell = *cellp;
 
     p_lanczos(ibuffer, obufptr, cell_type, row_idx, col_idx, cellhd);
     /* fallback to bicubic if lanczos is null */
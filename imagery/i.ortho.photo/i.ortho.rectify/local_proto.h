@@ -45,22 +45,22 @@ int get_target(char *);
 
 /* declare resampling methods */
 /* bilinear.c */
-extern void p_bilinear(struct cache *, void *, int, double *, double *,
+extern void p_bilinear(struct R_block_cache *, void *, int, double *, double *,
                        struct Cell_head *);
 /* cubic.c */
-extern void p_cubic(struct cache *, void *, int, double *, double *,
+extern void p_cubic(struct R_block_cache *, void *, int, double *, double *,
                     struct Cell_head *);
 /* nearest.c */
-extern void p_nearest(struct cache *, void *, int, double *, double *,
+extern void p_nearest(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
 /* bilinear_f.c */
-extern void p_bilinear_f(struct cache *, void *, int, double *, double *,
-                         struct Cell_head *);
+extern void p_bilinear_f(struct R_block_cache *, void *, int, double *,
+                         double *, struct Cell_head *);
 /* cubic_f.c */
-extern void p_cubic_f(struct cache *, void *, int, double *, double *,
+extern void p_cubic_f(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
 /* lanczos.c */
-extern void p_lanczos(struct cache *, void *, int, double *, double *,
+extern void p_lanczos(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
-extern void p_lanczos_f(struct cache *, void *, int, double *, double *,
+extern void p_lanczos_f(struct R_block_cache *, void *, int, double *, double *,
                         struct Cell_head *);
@@ -23,7 +23,7 @@ int rectify(struct Ortho_Image_Group *group, char *name, char *mapset,
     void *trast, *tptr;
     double n1, e1, z1;
     double nx, ex, nx1, ex1, zx1;
-    struct cache *ibuffer;
+    struct R_block_cache *ibuffer;
 
     select_current_env();
     Rast_get_cellhd(name, mapset, &cellhd);
@@ -36,9 +36,7 @@ int rectify(struct Ortho_Image_Group *group, char *name, char *mapset,
     map_type = Rast_get_map_type(infd);
     cell_size = Rast_cell_size(map_type);
 
-    ibuffer = readcell(infd, seg_mb_img, 0);
-
-    Rast_close(infd); /* (pmx) 17 april 2000 */
+    ibuffer = Rast_open_block_cache(infd, seg_mb_img);
 
     G_message(_("Rectify <%s@%s> (project <%s>)"), name, mapset, G_location());
     select_target_env();
@@ -112,8 +110,8 @@ int rectify(struct Ortho_Image_Group *group, char *name, char *mapset,
     Rast_close(outfd); /* (pmx) 17 april 2000 */
     G_free(trast);
 
-    close(ibuffer->fd);
-    release_cache(ibuffer);
+    Rast_close_block_cache(ibuffer);
+    Rast_close(infd);
 
     Rast_get_cellhd(result, G_mapset(), &cellhd);
 
@@ -8,7 +8,7 @@
  *
  * PURPOSE:      Principal Component Analysis transform of raster data.
  *
- * COPYRIGHT:    (C) 2004-2011 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2004-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -29,12 +29,22 @@
 
 #undef PCA_DEBUG
 
+/* transformation of the input bands */
+struct pca {
+    int bands;       /* number of input bands */
+    int fbands;      /* number of components for filtering, 0 for none */
+    double **eigmat; /* eigenvectors, one per row */
+    double *mu;      /* mean of each band */
+    double *stddev;  /* standard deviation of each band or NULL */
+};
+
 /* function prototypes */
 static CELL round_c(double);
 static int set_output_scale(struct Option *, int *, int *, int *);
-static int calc_mu_cov(int *, double **, double *, double *, int);
+static int calc_mu_cov(int *, double **, double *, double *, int, double,
+                       int);
 static int write_pca(double **, double *, double *, int *, char *, int, int,
-                     int, int, int);
+                     int, int, int, int);
 
 #ifdef PCA_DEBUG
 static int dump_eigen(int, double **, double *);
@@ -53,11 +63,14 @@ int main(int argc, char *argv[])
     double **eigmat;
     int *inp_fd;
     int scale, scale_max, scale_min;
+    double sample; /* fraction of rows for the covariance matrix */
+    int nprocs;
     struct Ref ref;
     const char *mapset;
 
     struct GModule *module;
-    struct Option *opt_in, *opt_out, *opt_scale, *opt_filt;
+    struct Option *opt_in, *opt_out, *opt_scale, *opt_filt, *opt_sample,
+        *opt_seed, *opt_nprocs;
     struct Flag *flag_norm, *flag_filt;
 
     /* initialize GIS engine */
@@ -68,6 +81,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("transformation"));
     G_add_keyword(_("PCA"));
     G_add_keyword(_("principal components analysis"));
+    G_add_keyword(_("parallel"));
     module->description = _("Principal components analysis (PCA) "
                             "for image processing.");
     module->overwrite = 1;
@@ -101,6 +115,22 @@ int main(int argc, char *argv[])
     opt_filt->label = _("Cumulative percent importance for filtering");
     opt_filt->guisection = _("Filter");
 
+    opt_sample = G_define_option();
+    opt_sample->key = "sample";
+    opt_sample->type = TYPE_DOUBLE;
+    opt_sample->required = NO;
+    opt_sample->options = "0-100";
+    opt_sample->answer = "100";
+    opt_sample->label =
+        _("Percentage of rows used to compute the covariance matrix");
+    opt_sample->description =
+        _("Rows are selected at random, a smaller sample is faster but "
+          "approximate");
+
+    opt_seed = G_define_standard_option(G_OPT_M_SEED);
+
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     flag_norm = G_define_flag();
     flag_norm->key = 'n';
     flag_norm->label = (_("Normalize (center and scale) input maps"));
@@ -145,6 +175,18 @@ int main(int argc, char *argv[])
     if (bands < 2)
         G_fatal_error(_("Sorry, at least 2 input bands must be provided"));
 
+    nprocs = G_set_omp_num_threads(opt_nprocs);
+
+    sample = atof(opt_sample->answer) / 100.;
+    if (!(sample > 0.))
+        G_fatal_error(_("'%s' must be > 0"), opt_sample->key);
+    if (sample < 1.) {
+        if (opt_seed->answer)
+            G_srand48(atol(opt_seed->answer));
+        else
+            G_srand48_auto();
+    }
+
     /* default values */
     scale = 1;
     scale_min = 0;
@@ -185,7 +227,7 @@ int main(int argc, char *argv[])
         inp_fd[i] = Rast_open_old(ref.file[i].name, ref.file[i].mapset);
     }
 
-    if (!calc_mu_cov(inp_fd, covar, mu, stddev, bands))
+    if (!calc_mu_cov(inp_fd, covar, mu, stddev, bands, sample, nprocs))
         G_fatal_error(_("No non-null values"));
 
     G_math_d_copy(covar[0], eigmat[0], bands * bands);
@@ -232,7 +274,7 @@ int main(int argc, char *argv[])
 
     /* write output images */
     write_pca(eigmat, mu, stddev, inp_fd, opt_out->answer, bands, scale,
-              scale_min, scale_max, pcbands);
+              scale_min, scale_max, pcbands, nprocs);
 
     /* write colors and history to output */
     for (i = 0; i < bands; i++) {
@@ -303,58 +345,143 @@ static int set_output_scale(struct Option *scale_opt, int *scale,
     return 0;
 }
 
+/* index of element i, j <= i of a lower triangular matrix */
+#define TRI(i, j) ((i) * ((i) + 1) / 2 + (j))
+
+/* sum of products of two vectors, the partial sums are independent and can
+ * be vectorized */
+static double dot(const double *a, const double *b, int n)
+{
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    int k;
+
+    for (k = 0; k + 3 < n; k += 4) {
+        s0 += a[k] * b[k];
+        s1 += a[k + 1] * b[k + 1];
+        s2 += a[k + 2] * b[k + 2];
+        s3 += a[k + 3] * b[k + 3];
+    }
+    for (; k < n; k++)
+        s0 += a[k] * b[k];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+/* cells where none of the maps has a null value */
+static void valid_cells(DCELL **x, int cols, int bands, char *valid)
+{
+    int i, col;
+
+    for (col = 0; col < cols; col++) {
+        for (i = 0; i < bands; i++)
+            if (Rast_is_d_null_value(&x[i][col]))
+                break;
+        valid[col] = (i == bands);
+    }
+}
+
+/* number of valid cells, means and co-moments (sums of products of the
+ * deviations from the means) of one row, the input values are replaced by
+ * the deviations */
+static void row_stats(DCELL **x, char *valid, int cols, int bands,
+                      double *stats)
+{
+    int i, j, col, n;
+    double sum, mean;
+
+    valid_cells(x, cols, bands, valid);
+    n = 0;
+    for (col = 0; col < cols; col++)
+        n += valid[col];
+
+    stats[0] = n;
+    for (i = 0; i < bands + TRI(bands, 0); i++)
+        stats[i + 1] = 0.;
+    if (n == 0)
+        return;
+
+    for (i = 0; i < bands; i++) {
+        sum = 0.;
+        for (col = 0; col < cols; col++)
+            if (valid[col])
+                sum += x[i][col];
+        mean = stats[i + 1] = sum / n;
+
+        for (col = 0; col < cols; col++)
+            x[i][col] = valid[col] ? x[i][col] - mean : 0.;
+    }
+
+    for (i = 0; i < bands; i++)
+        for (j = 0; j <= i; j++)
+            stats[1 + bands + TRI(i, j)] = dot(x[i], x[j], cols);
+}
+
 static int calc_mu_cov(int *fds, double **covar, double *mu, double *stddev,
-                       int bands)
+                       int bands, double sample, int nprocs)
 {
-    int i, j;
-    int row, col;
+    int i, j, r, k;
     int rows = Rast_window_rows();
     int cols = Rast_window_cols();
-    off_t count = 0;
-    DCELL **rowbuf = (DCELL **)G_malloc(bands * sizeof(DCELL *));
-    double **sum2 = (double **)G_calloc(bands, sizeof(double *));
-    double *sumsq, *sd, *sum;
+    int block_rows = 4 * nprocs;
+    int nrows, nbuf;
+    int nstats = 1 + bands + TRI(bands, 0);
+    int *sel = (int *)G_malloc(rows * sizeof(int));
+    DCELL **rowbuf =
+        (DCELL **)G_malloc(block_rows * bands * sizeof(DCELL *));
+    char *valid = (char *)G_malloc((size_t)block_rows * cols);
+    double *stats = (double *)G_malloc(block_rows * nstats * sizeof(double));
+    double *comom = (double *)G_calloc(TRI(bands, 0), sizeof(double));
+    double *delta = (double *)G_malloc(bands * sizeof(double));
+    double count = 0., f;
     int ret = 1;
 
-    if (stddev) {
-        sumsq = (double *)G_calloc(bands, sizeof(double));
-        sd = (double *)G_calloc(bands, sizeof(double));
-    }
-    else {
-        sumsq = NULL;
-        sd = NULL;
-    }
-
-    for (i = 0; i < bands; i++) {
+    for (i = 0; i < block_rows * bands; i++)
         rowbuf[i] = Rast_allocate_d_buf();
-        sum2[i] = (double *)G_calloc(bands, sizeof(double));
-    }
-    sum = mu;
+    for (i = 0; i < bands; i++)
+        mu[i] = 0.;
+
+    /* rows of the random sample */
+    nrows = 0;
+    for (r = 0; r < rows; r++)
+        if (sample >= 1. || G_drand48() < sample)
+            sel[nrows++] = r;
 
     G_message(_("Computing covariance matrix..."));
 
-    for (row = 0; row < rows; row++) {
-        G_percent(row, rows, 2);
-        for (i = 0; i < bands; i++)
-            Rast_get_d_row(fds[i], rowbuf[i], row);
+    for (k = 0; k < nrows; k += block_rows) {
+        G_percent(k, nrows, 2);
+
+        nbuf = nrows - k < block_rows ? nrows - k : block_rows;
 
-        for (col = 0; col < cols; col++) {
-            /* ignore cells where any of the maps has null value */
+        /* reading rows is not thread-safe */
+        for (r = 0; r < nbuf; r++)
             for (i = 0; i < bands; i++)
-                if (Rast_is_d_null_value(&rowbuf[i][col]))
-                    break;
-            if (i != bands)
-                continue;
-            count++;
-            for (i = 0; i < bands; i++) {
+                Rast_get_d_row(fds[i], rowbuf[r * bands + i], sel[k + r]);
 
-                sum[i] += rowbuf[i][col];
-                if (stddev)
-                    sumsq[i] += rowbuf[i][col] * rowbuf[i][col];
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) schedule(dynamic)
+        for (r = 0; r < nbuf; r++)
+            row_stats(&rowbuf[r * bands], valid + (size_t)r * cols, cols,
+                      bands, stats + r * nstats);
 
-                for (j = 0; j <= i; j++)
-                    sum2[i][j] += rowbuf[i][col] * rowbuf[j][col];
+        /* add the rows in order with the pairwise update of Chan et al.,
+         * results do not depend on the number of threads */
+        for (r = 0; r < nbuf; r++) {
+            const double *s = stats + r * nstats;
+
+            if (s[0] == 0.)
+                continue;
+
+            f = s[0] / (count + s[0]);
+            for (i = 0; i < bands; i++) {
+                delta[i] = s[1 + i] - mu[i];
+                mu[i] += delta[i] * f;
             }
+            f *= count;
+            for (i = 0; i < bands; i++)
+                for (j = 0; j <= i; j++)
+                    comom[TRI(i, j)] +=
+                        s[1 + bands + TRI(i, j)] + delta[i] * delta[j] * f;
+            count += s[0];
         }
     }
     G_percent(1, 1, 1);
@@ -365,46 +492,117 @@ static int calc_mu_cov(int *fds, double **covar, double *mu, double *stddev,
     }
 
     for (i = 0; i < bands; i++) {
-        if (stddev) {
-            sd[i] = sqrt(count * sumsq[i] - sum[i] * sum[i]);
-            stddev[i] =
-                sqrt((sumsq[i] - sum[i] * sum[i] / count) / (count - 1));
-        }
+        if (stddev)
+            stddev[i] = sqrt(comom[TRI(i, i)] / (count - 1));
         for (j = 0; j <= i; j++) {
             if (stddev)
-                covar[i][j] =
-                    (count * sum2[i][j] - sum[i] * sum[j]) / (sd[i] * sd[j]);
+                covar[i][j] = comom[TRI(i, j)] /
+                              sqrt(comom[TRI(i, i)] * comom[TRI(j, j)]);
             else
-                covar[i][j] =
-                    (sum2[i][j] - sum[i] * sum[j] / count) / (count - 1);
+                covar[i][j] = comom[TRI(i, j)] / (count - 1);
             G_debug(3, "covar[%d][%d] = %f", i, j, covar[i][j]);
             if (j != i)
                 covar[j][i] = covar[i][j];
         }
     }
-    for (i = 0; i < bands; i++)
-        mu[i] = sum[i] / count;
 
 free_exit:
-    for (i = 0; i < bands; i++) {
-        G_free(sum2[i]);
+    for (i = 0; i < block_rows * bands; i++)
         G_free(rowbuf[i]);
-    }
     G_free(rowbuf);
-    G_free(sum2);
-    G_free(sd);
-    G_free(sumsq);
+    G_free(sel);
+    G_free(valid);
+    G_free(stats);
+    G_free(comom);
+    G_free(delta);
 
     return ret;
 }
 
+/* principal components or filtered bands of one row, the input values are
+ * replaced by the standardized values */
+static void project_row(const struct pca *P, DCELL **in, DCELL **out,
+                        DCELL *pcs, char *valid, int cols)
+{
+    int i, j, col;
+    int bands = P->bands, fbands = P->fbands;
+    double e;
+
+    valid_cells(in, cols, bands, valid);
+
+    for (j = 0; j < bands; j++) {
+        DCELL *x = in[j];
+        double mu = P->mu[j];
+
+        if (P->stddev) {
+            double sd = P->stddev[j];
+
+            for (col = 0; col < cols; col++)
+                x[col] = (x[col] - mu) / sd;
+        }
+        else {
+            for (col = 0; col < cols; col++)
+                x[col] -= mu;
+        }
+    }
+
+    /* the terms of each cell are added in the same order as before */
+    if (fbands) {
+        for (i = 0; i < fbands; i++) {
+            DCELL *y = pcs + (size_t)i * cols;
+
+            for (col = 0; col < cols; col++)
+                y[col] = 0.;
+            for (j = 0; j < bands; j++) {
+                e = P->eigmat[i][j];
+                for (col = 0; col < cols; col++)
+                    y[col] += e * in[j][col];
+            }
+        }
+    }
+
+    for (i = 0; i < bands; i++) {
+        DCELL *y = out[i];
+
+        for (col = 0; col < cols; col++)
+            y[col] = 0.;
+
+        if (fbands) {
+            for (j = 0; j < fbands; j++) {
+                const DCELL *pc = pcs + (size_t)j * cols;
+
+                e = P->eigmat[j][i];
+                for (col = 0; col < cols; col++)
+                    y[col] += e * pc[col];
+            }
+            if (P->stddev) {
+                for (col = 0; col < cols; col++)
+                    y[col] = y[col] * P->stddev[i] + P->mu[i];
+            }
+            else {
+                for (col = 0; col < cols; col++)
+                    y[col] += P->mu[i];
+            }
+        }
+        else {
+            for (j = 0; j < bands; j++) {
+                e = P->eigmat[i][j];
+                for (col = 0; col < cols; col++)
+                    y[col] += e * in[j][col];
+            }
+        }
+
+        for (col = 0; col < cols; col++)
+            if (!valid[col])
+                Rast_set_d_null_value(&y[col], 1);
+    }
+}
+
 static int write_pca(double **eigmat, double *mu, double *stddev, int *inp_fd,
                      char *out_basename, int bands, int scale, int scale_min,
-                     int scale_max, int fbands)
+                     int scale_max, int fbands, int nprocs)
 {
-    int i, j;
-    void **outbuf = (void **)G_malloc(bands * sizeof(void *));
-    void **outptr = (void **)G_malloc(bands * sizeof(void *));
+    int i, r;
     double *min = (double *)G_malloc(bands * sizeof(double));
     double *max = (double *)G_malloc(bands * sizeof(double));
     double *old_range = (double *)G_calloc(bands, sizeof(double));
@@ -412,35 +610,54 @@ static int write_pca(double **eigmat, double *mu, double *stddev, int *inp_fd,
     int pass;
     int rows = Rast_window_rows();
     int cols = Rast_window_cols();
+    int block_rows = 4 * nprocs;
+    int nbuf, row0;
+    struct pca P;
 
     /* why CELL_TYPE when scaling output ? */
     int outmap_type = (scale) ? CELL_TYPE : DCELL_TYPE;
-    int outcell_mapsiz = Rast_cell_size(outmap_type);
     int *out_fd = (int *)G_malloc(bands * sizeof(int));
-    DCELL **inbuf = (DCELL **)G_malloc(bands * sizeof(DCELL *));
+    DCELL **inbuf = (DCELL **)G_malloc(block_rows * bands * sizeof(DCELL *));
+    DCELL **outbuf =
+        (DCELL **)G_malloc(block_rows * bands * sizeof(DCELL *));
+    CELL **cellbuf = NULL;
+    char *valid = (char *)G_malloc((size_t)block_rows * cols);
     DCELL *pcs = NULL;
 
     /* 2 passes for rescale.  1 pass for no rescale */
     int PASSES = (scale) ? 2 : 1;
 
+    P.bands = bands;
+    P.fbands = fbands;
+    P.eigmat = eigmat;
+    P.mu = mu;
+    P.stddev = stddev;
+
     if (fbands)
-        pcs = (DCELL *)G_malloc(fbands * sizeof(DCELL));
+        pcs = (DCELL *)G_malloc((size_t)block_rows * fbands * cols *
+                                sizeof(DCELL));
 
-    /* allocate memory for row buffers */
+    /* open output raster maps */
     for (i = 0; i < bands; i++) {
         char name[GNAME_MAX];
 
-        /* open output raster maps */
         snprintf(name, sizeof(name), "%s.%d", out_basename, i + 1);
         out_fd[i] = Rast_open_new(name, outmap_type);
+        min[i] = max[i] = old_range[i] = 0;
+    }
 
+    /* allocate memory for row buffers */
+    if (scale)
+        cellbuf = (CELL **)G_malloc(block_rows * bands * sizeof(CELL *));
+    for (i = 0; i < block_rows * bands; i++) {
         inbuf[i] = Rast_allocate_d_buf();
-        outbuf[i] = Rast_allocate_buf(outmap_type);
-        min[i] = max[i] = old_range[i] = 0;
+        outbuf[i] = Rast_allocate_d_buf();
+        if (scale)
+            cellbuf[i] = Rast_allocate_c_buf();
     }
 
     for (pass = 1; pass <= PASSES; pass++) {
-        int row, col;
+        int col;
         int first = 1;
 
         if (scale && (pass == PASSES)) {
@@ -454,122 +671,92 @@ static int write_pca(double **eigmat, double *mu, double *stddev, int *inp_fd,
             G_message(_("Calculating principal components..."));
         }
 
-        for (row = 0; row < rows; row++) {
+        for (row0 = 0; row0 < rows; row0 += block_rows) {
+            G_percent(row0, rows, 2);
 
-            G_percent(row, rows, 2);
+            nbuf = rows - row0 < block_rows ? rows - row0 : block_rows;
 
-            for (i = 0; i < bands; i++) {
-                Rast_get_d_row(inp_fd[i], inbuf[i], row);
-                outptr[i] = outbuf[i];
-            }
-            for (col = 0; col < cols; col++) {
-                /* ignore cells where any of the maps has null value */
+            /* reading rows is not thread-safe */
+            for (r = 0; r < nbuf; r++)
                 for (i = 0; i < bands; i++)
-                    if (Rast_is_d_null_value(&inbuf[i][col]))
-                        break;
+                    Rast_get_d_row(inp_fd[i], inbuf[r * bands + i], row0 + r);
 
-                if (i != bands) {
-                    for (i = 0; i < bands; i++) {
-                        Rast_set_null_value(outptr[i], 1, outmap_type);
-                        outptr[i] = G_incr_void_ptr(outptr[i], outcell_mapsiz);
-                    }
-                    continue;
-                }
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic) private(i, col)
+            for (r = 0; r < nbuf; r++) {
+                project_row(&P, &inbuf[r * bands], &outbuf[r * bands],
+                            pcs ? pcs + (size_t)r * fbands * cols : NULL,
+                            valid + (size_t)r * cols, cols);
 
-                if (fbands) {
-                    /* calculate all PC scores */
-                    for (i = 0; i < fbands; i++) {
-                        DCELL dval = 0.;
-
-                        for (j = 0; j < bands; j++) {
-                            /* corresp. cell of j-th band */
-                            if (stddev)
-                                dval += eigmat[i][j] *
-                                        ((inbuf[j][col] - mu[j]) / stddev[j]);
-                            else
-                                dval += eigmat[i][j] * (inbuf[j][col] - mu[j]);
-                        }
-                        pcs[i] = dval;
-                    }
-                }
+                if (!scale || pass == 1)
+                    continue;
 
                 for (i = 0; i < bands; i++) {
-                    DCELL dval = 0.;
-
-                    if (fbands) {
-                        for (j = 0; j < fbands; j++) {
-                            /* corresp. PC score of j-th band */
-                            dval += eigmat[j][i] * pcs[j];
-                        }
-                        if (stddev)
-                            dval = dval * stddev[i] + mu[i];
+                    const DCELL *y = outbuf[r * bands + i];
+                    CELL *c = cellbuf[r * bands + i];
+
+                    for (col = 0; col < cols; col++) {
+                        if (Rast_is_d_null_value(&y[col]))
+                            Rast_set_c_null_value(&c[col], 1);
+                        else if (min[i] == max[i])
+                            c[col] = 1;
                         else
-                            dval += mu[i];
-                    }
-                    else {
-                        for (j = 0; j < bands; j++) {
-                            /* corresp. cell of j-th band */
-                            if (stddev)
-                                dval += eigmat[i][j] *
-                                        ((inbuf[j][col] - mu[j]) / stddev[j]);
-                            else
-                                dval += eigmat[i][j] * (inbuf[j][col] - mu[j]);
-                        }
-                    }
-
-                    /* the cell entry is complete */
-                    if (scale && (pass == 1)) {
-                        if (first)
-                            min[i] = max[i] = dval;
-                        if (dval < min[i])
-                            min[i] = dval;
-
-                        if (dval > max[i])
-                            max[i] = dval;
-                    }
-                    else if (scale) {
-
-                        if (min[i] == max[i]) {
-                            Rast_set_c_value(outptr[i], 1, CELL_TYPE);
-                        }
-                        else {
                             /* map data to 0, (new_range-1) and then adding
                              * new_min */
-                            CELL tmpcell = round_c(
-                                (new_range * (dval - min[i]) / old_range[i]) +
-                                scale_min);
-
-                            Rast_set_c_value(outptr[i], tmpcell, outmap_type);
-                        }
+                            c[col] = round_c((new_range * (y[col] - min[i]) /
+                                              old_range[i]) +
+                                             scale_min);
                     }
-                    else { /* (!scale) */
+                }
+            }
 
-                        Rast_set_d_value(outptr[i], dval, outmap_type);
+            if (scale && pass == 1) {
+                /* the range is found in the order of the cells */
+                for (r = 0; r < nbuf; r++) {
+                    for (col = 0; col < cols; col++) {
+                        if (!valid[(size_t)r * cols + col])
+                            continue;
+                        for (i = 0; i < bands; i++) {
+                            DCELL dval = outbuf[r * bands + i][col];
+
+                            if (first)
+                                min[i] = max[i] = dval;
+                            if (dval < min[i])
+                                min[i] = dval;
+                            if (dval > max[i])
+                                max[i] = dval;
+                        }
+                        first = 0;
                     }
-                    outptr[i] = G_incr_void_ptr(outptr[i], outcell_mapsiz);
                 }
-                first = 0;
             }
+
             if (pass == PASSES) {
-                for (i = 0; i < bands; i++)
-                    Rast_put_row(out_fd[i], outbuf[i], outmap_type);
+                for (r = 0; r < nbuf; r++)
+                    for (i = 0; i < bands; i++)
+                        Rast_put_row(out_fd[i],
+                                     scale ? (void *)cellbuf[r * bands + i]
+                                           : (void *)outbuf[r * bands + i],
+                                     outmap_type);
             }
         }
         G_percent(1, 1, 1);
-
-        /* close output file */
-        if (pass == PASSES) {
-            for (i = 0; i < bands; i++) {
-                Rast_close(out_fd[i]);
-                G_free(inbuf[i]);
-                G_free(outbuf[i]);
-            }
-        }
     }
 
+    /* close output file */
+    for (i = 0; i < bands; i++)
+        Rast_close(out_fd[i]);
+
+    for (i = 0; i < block_rows * bands; i++) {
+        G_free(inbuf[i]);
+        G_free(outbuf[i]);
+        if (scale)
+            G_free(cellbuf[i]);
+    }
     G_free(inbuf);
     G_free(outbuf);
-    G_free(outptr);
+    G_free(cellbuf);
+    G_free(valid);
     G_free(min);
     G_free(max);
     G_free(old_range);
@@ -9,7 +9,16 @@ Licence:    This program is free software under the GNU General Public
                 for details.
 """
 
+import re
+
 from grass.gunittest.case import TestCase
+from grass.script.core import read_command
+
+
+def eigenvalues(raster):
+    """Eigenvalues written to the history of a component"""
+    history = read_command("r.info", flags="h", map=raster)
+    return [float(value) for value in re.findall(r"PC\d+\s+(\S+) \(", history)]
 
 
 class TestReport(TestCase):
@@ -27,6 +36,9 @@ class TestReport(TestCase):
             type="raster",
             name="lsat7_2002_pca.1,lsat7_2002_pca.2,lsat7_2002_pca.3,lsat7_2002_pca.4,lsat7_2002_pca.6",
         )
+        cls.runModule(
+            "g.remove", flags="f", type="raster", pattern="lsat7_2002_pca_*"
+        )
         cls.del_temp_region()
 
     def test_pca_sample(self):
@@ -168,6 +180,79 @@ class TestReport(TestCase):
                 sep="=",
             )
 
+    def test_pca_nprocs(self):
+        """Testing pca with several threads and a sample of rows"""
+        bands = "lsat7_2002_10,lsat7_2002_20,lsat7_2002_30,lsat7_2002_40"
+
+        for nprocs in (1, 3):
+            self.assertModule(
+                "i.pca",
+                input=bands,
+                output=f"lsat7_2002_pca_p{nprocs}",
+                rescale="0,0",
+                nprocs=nprocs,
+            )
+        for i in range(1, 5):
+            self.assertRastersNoDifference(
+                actual=f"lsat7_2002_pca_p3.{i}",
+                reference=f"lsat7_2002_pca_p1.{i}",
+                precision=0,
+            )
+
+        # the same seed selects the same rows with any number of threads
+        for nprocs in (1, 2):
+            self.assertModule(
+                "i.pca",
+                input=bands,
+                output=f"lsat7_2002_pca_s{nprocs}",
+                rescale="0,0",
+                sample=50,
+                seed=1,
+                nprocs=nprocs,
+            )
+        for i in range(1, 5):
+            self.assertRastersNoDifference(
+                actual=f"lsat7_2002_pca_s2.{i}",
+                reference=f"lsat7_2002_pca_s1.{i}",
+                precision=0,
+            )
+
+        # eigenvalues of half of the rows are close to those of all rows
+        full = eigenvalues("lsat7_2002_pca_p1.1")
+        sampled = eigenvalues("lsat7_2002_pca_s1.1")
+        self.assertEqual(len(sampled), len(full))
+        self.assertNotEqual(sampled, full, msg="Rows must be sampled")
+        for i in range(2):
+            self.assertAlmostEqual(sampled[i], full[i], delta=0.1 * full[i])
+
+    def test_pca_offset(self):
+        """Testing pca of bands with a large constant offset"""
+        bands = ["lsat7_2002_10", "lsat7_2002_20", "lsat7_2002_30", "lsat7_2002_40"]
+        shifted = []
+        for band in bands:
+            name = f"lsat7_2002_pca_offset_{band}"
+            self.runModule("r.mapcalc", expression=f"{name} = double({band}) + 1e6")
+            shifted.append(name)
+
+        self.assertModule(
+            "i.pca", input=bands, output="lsat7_2002_pca_o1", rescale="0,0"
+        )
+        self.assertModule(
+            "i.pca", input=shifted, output="lsat7_2002_pca_o2", rescale="0,0"
+        )
+
+        # the covariance matrix and the centered components do not depend
+        # on the offset
+        reference = eigenvalues("lsat7_2002_pca_o1.1")
+        for actual, expected in zip(eigenvalues("lsat7_2002_pca_o2.1"), reference):
+            # written with two decimals
+            self.assertAlmostEqual(actual, expected, delta=0.011)
+        for i in range(1, 5):
+            self.assertRastersNoDifference(
+                actual=f"lsat7_2002_pca_o2.{i}",
+                reference=f"lsat7_2002_pca_o1.{i}",
+                precision=1e-4,
+            )
 
 if __name__ == "__main__":
     from grass.gunittest.main import test
@@ -6,6 +6,7 @@
 extern func interpolate; /* interpolation routine */
 
 extern int seg_mb_img;
+extern int nprocs;
 
 struct Image_Group {
     char name[GNAME_MAX];
@@ -17,11 +17,6 @@ int georef_window(struct Image_Group *, struct Cell_head *, struct Cell_head *,
 /* rectify.c */
 int rectify(struct Image_Group *, char *, char *, char *, int, char *);
 
-/* readcell.c */
-struct cache *readcell(int, int);
-block *get_block(struct cache *, int);
-void release_cache(struct cache *);
-
 /* report.c */
 int report(time_t, int);
 
@@ -30,22 +25,22 @@ int get_target(char *);
 
 /* declare resampling methods */
 /* bilinear.c */
-extern void p_bilinear(struct cache *, void *, int, double *, double *,
+extern void p_bilinear(struct R_block_cache *, void *, int, double *, double *,
                        struct Cell_head *);
 /* cubic.c */
-extern void p_cubic(struct cache *, void *, int, double *, double *,
+extern void p_cubic(struct R_block_cache *, void *, int, double *, double *,
                     struct Cell_head *);
 /* nearest.c */
-extern void p_nearest(struct cache *, void *, int, double *, double *,
+extern void p_nearest(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
 /* bilinear_f.c */
-extern void p_bilinear_f(struct cache *, void *, int, double *, double *,
-                         struct Cell_head *);
+extern void p_bilinear_f(struct R_block_cache *, void *, int, double *,
+                         double *, struct Cell_head *);
 /* cubic_f.c */
-extern void p_cubic_f(struct cache *, void *, int, double *, double *,
+extern void p_cubic_f(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
 /* lanczos.c */
-extern void p_lanczos(struct cache *, void *, int, double *, double *,
+extern void p_lanczos(struct R_block_cache *, void *, int, double *, double *,
                       struct Cell_head *);
-extern void p_lanczos_f(struct cache *, void *, int, double *, double *,
+extern void p_lanczos_f(struct R_block_cache *, void *, int, double *, double *,
                         struct Cell_head *);
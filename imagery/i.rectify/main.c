@@ -14,7 +14,7 @@
  * PURPOSE:      calculate a transformation matrix and then convert x,y cell
  *               coordinates to standard map coordinates for each pixel in the
  *               image (control points can come from g.gui.gcp)
- * COPYRIGHT:    (C) 2002-2020 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2002-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -29,6 +29,7 @@
 #include <grass/gis.h>
 
 int seg_mb_img;
+int nprocs;
 
 func interpolate;
 
@@ -72,6 +73,7 @@ int main(int argc, char *argv[])
         *ext,           /* extension */
         *tres,          /* target resolution */
         *mem,           /* amount of memory for cache */
+        *threads,       /* number of threads */
         *interpol;      /* interpolation method:
                            nearest neighbor, bilinear, cubic */
     struct Flag *c, *a, *t;
@@ -83,6 +85,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("imagery"));
     G_add_keyword(_("rectify"));
     G_add_keyword(_("geometry"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Rectifies an image by computing a coordinate "
           "transformation for each pixel in the image based on the "
@@ -116,6 +119,8 @@ int main(int argc, char *argv[])
 
     mem = G_define_standard_option(G_OPT_MEMORYMB);
 
+    threads = G_define_standard_option(G_OPT_M_NPROCS);
+
     ipolname = make_ipol_list();
 
     interpol = G_define_option();
@@ -142,6 +147,8 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(threads);
+
     /* get the method */
     for (method = 0; (ipolname = menu[method].name); method++)
         if (strcmp(ipolname, interpol->answer) == 0)
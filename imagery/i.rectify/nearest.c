@@ -6,16 +6,16 @@
 #include <math.h>
 #include "global.h"
 
-void p_nearest(struct cache *ibuffer,   /* input buffer                  */
-               void *obufptr,           /* ptr in output buffer          */
-               int cell_type,           /* raster map type of obufptr    */
-               double *row_idx,         /* row index in input matrix     */
-               double *col_idx,         /* column index in input matrix  */
-               struct Cell_head *cellhd /* cell header of input layer    */
+void p_nearest(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double *row_idx,               /* row index in input matrix */
+               double *col_idx,               /* column index in input matrix */
+               struct Cell_head *cellhd       /* cell header of input layer */
 )
 {
     int row, col; /* row/col of nearest neighbor   */
-    DCELL *cellp;
+    DCELL cell;
 
     /* cut indices to integer and get nearest cell */
     /* the row_idx, col_idx correction for bilinear/bicubic does not apply here
@@ -29,12 +29,12 @@ void p_nearest(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    cellp = CPTR(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
 
-    if (Rast_is_d_null_value(cellp)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
 
-    Rast_set_d_value(obufptr, *cellp, cell_type);
+    Rast_set_d_value(obufptr, cell, cell_type);
 }
@@ -11,19 +11,62 @@
 #include <unistd.h>
 #include "global.h"
 
+/* output rows rectified at once, rows and columns of a tile rectified by
+ * one thread */
+#define BAND_ROWS 64
+#define TILE_ROWS 16
+#define TILE_COLS 64
+
+/* rectify the cells of a tile of the output map, obuf is the first cell of
+ * the tile in a buffer of output rows */
+static void rectify_tile(struct Image_Group *group, int order,
+                         struct R_block_cache *ibuffer,
+                         struct Cell_head *cellhd, RASTER_MAP_TYPE map_type,
+                         void *obuf, int row0, int nrows, int col0, int ncols)
+{
+    int row, col, cell_size = Rast_cell_size(map_type);
+    double row_idx, col_idx;
+    double n1, e1, nx, ex;
+    void *tptr;
+
+    for (row = row0; row < row0 + nrows; row++) {
+        n1 = target_window.north - (row + 0.5) * target_window.ns_res;
+
+        tptr = (unsigned char *)obuf +
+               (size_t)(row - row0) * target_window.cols * cell_size;
+        for (col = col0; col < col0 + ncols; col++) {
+            e1 = target_window.west + (col + 0.5) * target_window.ew_res;
+
+            /* backwards transformation of target cell center */
+            if (order == 0)
+                I_georef_tps(e1, n1, &ex, &nx, group->E21_t, group->N21_t,
+                             &group->control_points, 0);
+            else
+                I_georef(e1, n1, &ex, &nx, group->E21, group->N21, order);
+
+            /* convert to row/column indices of source raster */
+            row_idx = (cellhd->north - nx) / cellhd->ns_res;
+            col_idx = (ex - cellhd->west) / cellhd->ew_res;
+
+            /* resample data point */
+            interpolate(ibuffer, tptr, map_type, &row_idx, &col_idx, cellhd);
+
+            tptr = G_incr_void_ptr(tptr, cell_size);
+        }
+    }
+}
+
 int rectify(struct Image_Group *group, char *name, char *mapset, char *result,
             int order, char *interp_method)
 {
     struct Cell_head cellhd;
     int ncols, nrows;
-    int row, col;
-    double row_idx, col_idx;
+    int row, i;
     int infd, outfd;
     RASTER_MAP_TYPE map_type;
     int cell_size;
-    void *trast, *tptr;
-    double n1, e1, nx, ex;
-    struct cache *ibuffer;
+    void *trast;
+    struct R_block_cache *ibuffer;
 
     select_current_env();
     Rast_get_cellhd(name, mapset, &cellhd);
@@ -36,9 +79,7 @@ int rectify(struct Image_Group *group, char *name, char *mapset, char *result,
     map_type = Rast_get_map_type(infd);
     cell_size = Rast_cell_size(map_type);
 
-    ibuffer = readcell(infd, seg_mb_img);
-
-    Rast_close(infd); /* (pmx) 17 april 2000 */
+    ibuffer = Rast_open_block_cache(infd, seg_mb_img);
 
     G_message(_("Rectify <%s@%s> (location <%s>)"), name, mapset, G_location());
     select_target_env();
@@ -60,43 +101,43 @@ int rectify(struct Image_Group *group, char *name, char *mapset, char *result,
      */
 
     outfd = Rast_open_new(result, map_type);
-    trast = Rast_allocate_output_buf(map_type);
+    trast = G_malloc((size_t)BAND_ROWS * ncols * cell_size);
 
-    for (row = 0; row < nrows; row++) {
-        n1 = target_window.north - (row + 0.5) * target_window.ns_res;
+    for (row = 0; row < nrows; row += BAND_ROWS) {
+        int brows = nrows - row < BAND_ROWS ? nrows - row : BAND_ROWS;
+        int ntilecols = (ncols + TILE_COLS - 1) / TILE_COLS;
+        int ntiles = ((brows + TILE_ROWS - 1) / TILE_ROWS) * ntilecols;
 
         G_percent(row, nrows, 2);
 
-        Rast_set_null_value(trast, ncols, map_type);
-        tptr = trast;
-        for (col = 0; col < ncols; col++) {
-            e1 = target_window.west + (col + 0.5) * target_window.ew_res;
-
-            /* backwards transformation of target cell center */
-            if (order == 0)
-                I_georef_tps(e1, n1, &ex, &nx, group->E21_t, group->N21_t,
-                             &group->control_points, 0);
-            else
-                I_georef(e1, n1, &ex, &nx, group->E21, group->N21, order);
-
-            /* convert to row/column indices of source raster */
-            row_idx = (cellhd.north - nx) / cellhd.ns_res;
-            col_idx = (ex - cellhd.west) / cellhd.ew_res;
-
-            /* resample data point */
-            interpolate(ibuffer, tptr, map_type, &row_idx, &col_idx, &cellhd);
-
-            tptr = G_incr_void_ptr(tptr, cell_size);
+        /* tiles of the band are rectified in parallel, the input blocks
+         * are shared through the thread-safe block cache */
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic)
+        for (i = 0; i < ntiles; i++) {
+            int r0 = (i / ntilecols) * TILE_ROWS;
+            int c0 = (i % ntilecols) * TILE_COLS;
+            int tr = brows - r0 < TILE_ROWS ? brows - r0 : TILE_ROWS;
+            int tc = ncols - c0 < TILE_COLS ? ncols - c0 : TILE_COLS;
+
+            rectify_tile(group, order, ibuffer, &cellhd, map_type,
+                         (unsigned char *)trast +
+                             ((size_t)r0 * ncols + c0) * cell_size,
+                         row + r0, tr, c0, tc);
         }
-        Rast_put_row(outfd, trast, map_type);
+
+        for (i = 0; i < brows; i++)
+            Rast_put_row(outfd,
+                         (unsigned char *)trast + (size_t)i * ncols * cell_size,
+                         map_type);
     }
     G_percent(1, 1, 1);
 
     Rast_close(outfd); /* (pmx) 17 april 2000 */
     G_free(trast);
 
-    close(ibuffer->fd);
-    release_cache(ibuffer);
+    Rast_close_block_cache(ibuffer);
+    Rast_close(infd);
 
     Rast_get_cellhd(result, G_mapset(), &cellhd);
 
@@ -36,6 +36,10 @@
 #define ORM_MS 2 /* mean shift */
 #define ORM_WS 3 /* watershed */
 
+/* regions are grown in tiles of TILE_SIZE x TILE_SIZE cells with nprocs > 1
+ */
+#define TILE_SIZE 256
+
 /* row/col list */
 struct rc {
     struct rc *next;
@@ -47,6 +51,13 @@ struct rclist {
     struct rc *tail, *head;
 };
 
+/* list of free region IDs */
+struct idlist {
+    int *ids;
+    int nids, nalloc;
+    CELL cellmax;
+};
+
 /* input and output files, as well as some other processing info */
 struct globals {
     /* input */
@@ -58,6 +69,8 @@ struct globals {
     int nbands;      /* number of rasters in the image group */
     size_t datasize; /* nbands * sizeof(double) */
     int mb;          /* amount of memory to use in MB */
+    int nprocs;      /* number of threads */
+    int tile_batch;  /* number of tiles grown at once in memory */
 
     char *seeds, *bounds_map; /* optional segment seeds and polygon
                                  constraints/boundaries */
@@ -112,12 +125,14 @@ struct globals {
 
     /* region growing internal structure */
     struct RG_TREE *reg_tree; /* search tree with region stats */
+    struct idlist free_ids;   /* IDs of merged regions */
     LARGEINT min_reg_size;    /* minimum region size */
     struct reg_stats rs, rs_i, rs_k;
     struct ngbr_stats ns;
 
     /* processing flags */
     FLAG *candidate_flag,
+        *seam_flag, /* cells of segments cut by tiles */
         *null_flag; /*TODO, need some way to remember mask/NULL values.  Was
                        using -1, 0, 1 in int array.  Better to use 2 FLAG
                        structures, better readability? */
@@ -5,7 +5,7 @@
  *               based on the GSoC project by
  *               Eric Momsen <eric.momsen at gmail com>
  * PURPOSE:      Object recognition, segments an image group.
- * COPYRIGHT:    (C) 2012 by Eric Momsen, and the GRASS Development Team
+ * COPYRIGHT:    (C) 2012-2026 by Eric Momsen, and the GRASS Development Team
  *
  *               This program is free software under the GNU General
  *               Public License (>=v2). Read the COPYING file that
@@ -38,6 +38,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("segmentation"));
     G_add_keyword(_("classification"));
     G_add_keyword(_("object recognition"));
+    G_add_keyword(_("parallel"));
     module->description = _("Identifies segments (objects) from imagery data.");
 
     parse_args(argc, argv, &globals);
@@ -32,31 +32,328 @@ static double gauss_kernel(double diff2, double var)
     return exp(-diff2 / (2 * var));
 }
 
+/* rows of a strip per thread */
+#define STRIP_ROWS 16
+
+/* band values of the rows of a strip and of the rows around it within the
+ * spatial radius: for each row one array per band over the columns of the
+ * processing window, so that the cells of a row are processed together */
+struct ms_rows {
+    int row1, row2;     /* first row, last row + 1 */
+    int col_min, ncols; /* first column and number of columns */
+    int nbands;
+    DCELL *val; /* band values, 0 for NULL cells */
+    char *null; /* NULL flags */
+};
+
+/* mean shift settings */
+struct ms_par {
+    int row_min, row_max;      /* rows of the processing window */
+    int radiusc;               /* spatial radius in cells */
+    double hspat2, sigmaspat2; /* spatial bandwidth squared, variance */
+    double hspec2, sigmaspec2; /* range bandwidth squared, variance */
+    int do_gauss, do_adaptive;
+    int manhattan;   /* manhattan instead of euclidean distance */
+    double max_diff; /* max possible difference */
+};
+
+static DCELL *row_val(const struct ms_rows *rows, int row)
+{
+    return rows->val + (size_t)(row - rows->row1) * rows->nbands * rows->ncols;
+}
+
+static char *row_null(const struct ms_rows *rows, int row)
+{
+    return rows->null + (size_t)(row - rows->row1) * rows->ncols;
+}
+
+static void load_rows(struct globals *globals, SEGMENT *seg,
+                      struct ms_rows *rows, int row1, int row2, DCELL *buf)
+{
+    int row, col, n;
+    DCELL *val;
+    char *null;
+
+    rows->row1 = row1;
+    rows->row2 = row2;
+
+    for (row = row1; row < row2; row++) {
+        Segment_get_row(seg, (void *)buf, row);
+
+        null = row_null(rows, row);
+        for (col = 0; col < rows->ncols; col++)
+            null[col] =
+                (FLAG_GET(globals->null_flag, row, rows->col_min + col)) != 0;
+
+        val = row_val(rows, row);
+        for (n = 0; n < rows->nbands; n++) {
+            const DCELL *b = buf + (size_t)rows->col_min * rows->nbands + n;
+
+            for (col = 0; col < rows->ncols; col++)
+                val[col] = null[col] ? 0 : b[(size_t)col * rows->nbands];
+            val += rows->ncols;
+        }
+    }
+}
+
+/* spectral distances between cells of x and y for columns c1 to c2 - 1,
+ * the arrays of the bands are stride apart; the same as
+ * calculate_euclidean_similarity() and calculate_manhattan_similarity()
+ * for each cell */
+static void spectral_dist(const DCELL *x, const DCELL *y, size_t stride,
+                          int nbands, int c1, int c2,
+                          const struct ms_par *par, double *dist)
+{
+    int n, c;
+    double diff;
+
+    for (c = c1; c < c2; c++)
+        dist[c] = 0.;
+
+    for (n = nbands - 1; n >= 0; n--) {
+        const DCELL *xn = x + n * stride, *yn = y + n * stride;
+
+        if (par->manhattan) {
+            for (c = c1; c < c2; c++)
+                dist[c] += fabs(xn[c] - yn[c]);
+        }
+        else {
+            for (c = c1; c < c2; c++) {
+                diff = xn[c] - yn[c];
+                dist[c] += diff * diff;
+            }
+        }
+    }
+
+    for (c = c1; c < c2; c++)
+        dist[c] = dist[c] > 0 ? dist[c] / par->max_diff : 0.;
+}
+
+/* window rows around a row */
+static void window_rows(const struct ms_par *par, int row, int *mwrow1,
+                        int *mwrow2)
+{
+    *mwrow1 = row - par->radiusc;
+    *mwrow2 = *mwrow1 + par->radiusc * 2 + 1;
+    if (*mwrow1 < par->row_min)
+        *mwrow1 = par->row_min;
+    if (*mwrow2 > par->row_max)
+        *mwrow2 = par->row_max;
+}
+
+/* window columns of cells c1 to c2 - 1 with a neighbor dc columns off */
+static int window_cols(int ncols, int dc, int *c1, int *c2)
+{
+    *c1 = dc < 0 ? -dc : 0;
+    *c2 = dc > 0 ? ncols - dc : ncols;
+
+    return *c1 < *c2;
+}
+
+/* spectral distances of the cells of a row to their neighbors for the
+ * estimation of the range bandwidth
+ * est: count, minimum, minimum excluding zero, sum of distances */
+static void estimate_row(const struct ms_rows *rows, const struct ms_par *par,
+                         int row, double *dist, double *est)
+{
+    int nc = rows->ncols, nb = rows->nbands;
+    int mwrow, mwrow1, mwrow2, dc, c, c1, c2;
+    double diff, diff2;
+    double *count = est, *mindiff = est + nc, *mindiffzero = est + 2 * nc,
+           *avgdiff = est + 3 * nc;
+    const char *null;
+
+    for (c = 0; c < nc; c++) {
+        count[c] = 0;
+        mindiff[c] = mindiffzero[c] = par->max_diff;
+        avgdiff[c] = 0;
+    }
+
+    /* neighbors in the same order as for a single cell */
+    window_rows(par, row, &mwrow1, &mwrow2);
+    for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
+        for (dc = -par->radiusc; dc <= par->radiusc; dc++) {
+            if (mwrow == row && dc == 0)
+                continue;
+
+            diff = mwrow - row;
+            diff2 = diff * diff;
+            diff = dc;
+            diff2 += diff * diff;
+
+            if (diff2 > par->hspat2 || !window_cols(nc, dc, &c1, &c2))
+                continue;
+
+            spectral_dist(row_val(rows, row), row_val(rows, mwrow) + dc, nc,
+                          nb, c1, c2, par, dist);
+
+            null = row_null(rows, mwrow) + dc;
+            for (c = c1; c < c2; c++) {
+                if (null[c])
+                    continue;
+                if (mindiff[c] > dist[c])
+                    mindiff[c] = dist[c];
+                if (mindiffzero[c] > dist[c] && dist[c] > 0)
+                    mindiffzero[c] = dist[c];
+                avgdiff[c] += sqrt(dist[c]);
+                count[c]++;
+            }
+        }
+    }
+}
+
+/* mean shift of the cells of a row
+ * out: new band values, one array per band
+ * change: spectral distance between old and new values */
+static void shift_row(const struct ms_rows *rows, const struct ms_par *par,
+                      int row, double *work, double *out, double *change)
+{
+    int nc = rows->ncols, nb = rows->nbands;
+    int mwrow, mwrow1, mwrow2, dc, c, c1, c2, n;
+    double diff, diff2, w, avgdiff, hspecad;
+    double *dist = work, *wsum = work + nc, *hspecad2 = work + 2 * nc,
+           *sum = work + 3 * nc, *count = work + 4 * nc, *wc = work + 5 * nc;
+    const DCELL *x = row_val(rows, row);
+    const char *null;
+
+    window_rows(par, row, &mwrow1, &mwrow2);
+
+    for (c = 0; c < nc; c++)
+        hspecad2[c] = par->hspec2;
+
+    if (par->do_adaptive) {
+        /* adapt initial range bandwidth */
+        for (c = 0; c < nc; c++)
+            sum[c] = count[c] = 0;
+
+        for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
+            for (dc = -par->radiusc; dc <= par->radiusc; dc++) {
+                if (mwrow == row && dc == 0)
+                    continue;
+
+                diff = mwrow - row;
+                diff2 = diff * diff;
+                diff = dc;
+                diff2 += diff * diff;
+
+                if (diff2 > par->hspat2 || !window_cols(nc, dc, &c1, &c2))
+                    continue;
+
+                spectral_dist(x, row_val(rows, mwrow) + dc, nc, nb, c1, c2,
+                              par, dist);
+
+                null = row_null(rows, mwrow) + dc;
+                for (c = c1; c < c2; c++) {
+                    if (null[c])
+                        continue;
+                    sum[c] += sqrt(dist[c]);
+                    count[c]++;
+                }
+            }
+        }
+
+        for (c = 0; c < nc; c++) {
+            hspecad2[c] = 0;
+            if (sum[c] > 0) {
+                avgdiff = sum[c] / count[c];
+                /* OTB-like, contrast enhancing,
+                 * conductance parameter is the initial range bandwidth */
+                hspecad =
+                    exp(-avgdiff * avgdiff / (2 * par->hspec2)) * avgdiff;
+                hspecad2[c] = hspecad * hspecad;
+            }
+        }
+    }
+
+    /* actual mean shift */
+    for (c = 0; c < nc; c++)
+        wsum[c] = 0;
+    for (c = 0; c < nb * nc; c++)
+        out[c] = 0;
+
+    for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
+        for (dc = -par->radiusc; dc <= par->radiusc; dc++) {
+            const DCELL *y = row_val(rows, mwrow) + dc;
+
+            diff = mwrow - row;
+            diff2 = diff * diff;
+            diff = dc;
+            diff2 += diff * diff;
+
+            if (diff2 > par->hspat2 || !window_cols(nc, dc, &c1, &c2))
+                continue;
+
+            w = 1;
+            if (par->do_gauss)
+                w = gauss_kernel(diff2, par->sigmaspat2);
+
+            /* check spectral distance */
+            spectral_dist(x, y, nc, nb, c1, c2, par, dist);
+
+            /* weights are 0 for cells not in the window, adding 0 does not
+             * change the sums */
+            null = row_null(rows, mwrow) + dc;
+            for (c = c1; c < c2; c++) {
+                wc[c] = 0;
+                if (!null[c] && dist[c] <= hspecad2[c]) {
+                    wc[c] = w;
+                    if (par->do_gauss)
+                        wc[c] *= gauss_kernel(dist[c], par->sigmaspec2);
+                }
+                wsum[c] += wc[c];
+            }
+            for (n = 0; n < nb; n++) {
+                const DCELL *yn = y + n * nc;
+                double *o = out + n * nc;
+
+                for (c = c1; c < c2; c++)
+                    o[c] += wc[c] * yn[c];
+            }
+        }
+    }
+
+    for (n = 0; n < nb; n++) {
+        const DCELL *xn = x + n * nc;
+        double *o = out + n * nc;
+
+        for (c = 0; c < nc; c++)
+            o[c] = wsum[c] > 0 ? o[c] / wsum[c] : xn[c];
+    }
+
+    spectral_dist(x, out, nc, nb, 0, nc, par, change);
+}
+
 int mean_shift(struct globals *globals)
 {
     int row, col, t, n;
-    int mwrow, mwrow1, mwrow2, mwnrows, mwcol, mwcol1, mwcol2, mwncols, radiusc;
+    int row1, row2, srows, nrows, ncols, nprocs;
     double hspat, hspec, hspat2, hspec2, sigmaspat2, sigmaspec2;
-    double hspecad, hspecad2;
-    double ka2;
-    double w, wsum;
     LARGEINT n_changes;
     double alpha2, maxdiff2;
-    struct ngbr_stats Rin, Rout, Rn;
-    double diff, diff2;
+    struct ngbr_stats Rout;
+    struct ms_rows rows;
+    struct ms_par par;
+    DCELL *rowbuf;
+    double *out, *change, *est;
     SEGMENT *seg_tmp;
-    double mindiff, mindiffzero, mindiffavg, mindiffzeroavg;
-    double avgdiff, avgdiffavg;
-    LARGEINT nvalid, count;
-    int do_gauss = 0, do_adaptive, do_progressive;
+    double mindiffavg, mindiffzeroavg;
+    double avgdiffavg;
+    LARGEINT nvalid;
+    int do_progressive;
 
-    Rin.mean = G_malloc(globals->datasize);
     Rout.mean = G_malloc(globals->datasize);
-    Rn.mean = G_malloc(globals->datasize);
 
     alpha2 = globals->alpha * globals->alpha;
-    do_adaptive = globals->ms_adaptive;
     do_progressive = globals->ms_progressive;
+    nprocs = globals->nprocs;
+
+    par.row_min = globals->row_min;
+    par.row_max = globals->row_max;
+    par.do_gauss = 0;
+    par.do_adaptive = globals->ms_adaptive;
+    par.manhattan =
+        globals->calculate_similarity == calculate_manhattan_similarity;
+    par.max_diff = globals->max_diff;
 
     globals->candidate_count = 0;
     flag_clear_all(globals->candidate_flag);
@@ -81,8 +378,28 @@ int mean_shift(struct globals *globals)
 
     hspat2 = hspat * hspat;
     sigmaspat2 = hspat2 / 9.;
-    radiusc = hspat; /* radius in cells truncated to integer */
-    mwnrows = mwncols = radiusc * 2 + 1;
+    par.radiusc = hspat; /* radius in cells truncated to integer */
+    par.hspat2 = hspat2;
+    par.sigmaspat2 = sigmaspat2;
+
+    /* strips of rows are processed in parallel, with the rows within the
+     * spatial radius around them */
+    nrows = globals->row_max - globals->row_min;
+    ncols = globals->col_max - globals->col_min;
+    srows = STRIP_ROWS * nprocs;
+    if (srows > nrows)
+        srows = nrows;
+
+    rows.col_min = globals->col_min;
+    rows.ncols = ncols;
+    rows.nbands = globals->nbands;
+    rows.val = NULL;
+    rows.null = NULL;
+
+    rowbuf = G_malloc((size_t)globals->ncols * globals->datasize);
+    out = G_malloc((size_t)srows * ncols * globals->datasize);
+    change = G_malloc((size_t)srows * ncols * sizeof(double));
+    est = G_malloc((size_t)srows * 4 * ncols * sizeof(double));
 
     /* estimate spectral bandwidth for given spatial bandwidth */
     mindiffavg = mindiffzeroavg = 0;
@@ -91,75 +408,51 @@ int mean_shift(struct globals *globals)
 
     G_message(_("Estimating spectral bandwidth for spatial bandwidth %g..."),
               hspat);
+    rows.val = G_realloc(rows.val, (size_t)(srows + 2 * par.radiusc) * ncols *
+                                       globals->datasize);
+    rows.null = G_realloc(rows.null, (size_t)(srows + 2 * par.radiusc) * ncols);
     G_percent_reset();
-    for (row = globals->row_min; row < globals->row_max; row++) {
-        G_percent(row - globals->row_min, globals->row_max - globals->row_min,
-                  4);
-
-        mwrow1 = row - radiusc;
-        mwrow2 = mwrow1 + mwnrows;
-        if (mwrow1 < globals->row_min)
-            mwrow1 = globals->row_min;
-        if (mwrow2 > globals->row_max)
-            mwrow2 = globals->row_max;
-
-        for (col = globals->col_min; col < globals->col_max; col++) {
-            if ((FLAG_GET(globals->null_flag, row, col)))
-                continue;
-
-            /* get current band values */
-            Segment_get(globals->bands_in, (void *)Rin.mean, row, col);
-
-            mwcol1 = col - radiusc;
-            mwcol2 = mwcol1 + mwncols;
-            if (mwcol1 < globals->col_min)
-                mwcol1 = globals->col_min;
-            if (mwcol2 > globals->col_max)
-                mwcol2 = globals->col_max;
-
-            /* get minimum spectral distance for this cell */
-            count = 0;
-            mindiff = globals->max_diff;
-            mindiffzero = globals->max_diff;
-            avgdiff = 0;
-            for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
-                for (mwcol = mwcol1; mwcol < mwcol2; mwcol++) {
-                    if ((FLAG_GET(globals->null_flag, mwrow, mwcol)))
-                        continue;
-                    if (mwrow == row && mwcol == col)
-                        continue;
-
-                    diff = mwrow - row;
-                    diff2 = diff * diff;
-                    diff = mwcol - col;
-                    diff2 += diff * diff;
-
-                    if (diff2 <= hspat2) {
-
-                        Segment_get(globals->bands_in, (void *)Rn.mean, mwrow,
-                                    mwcol);
+    for (row1 = globals->row_min; row1 < globals->row_max; row1 += srows) {
+        G_percent(row1 - globals->row_min, nrows, 4);
+
+        row2 = row1 + srows;
+        if (row2 > globals->row_max)
+            row2 = globals->row_max;
+        load_rows(globals, globals->bands_in, &rows,
+                  MAX(row1 - par.radiusc, globals->row_min),
+                  MIN(row2 + par.radiusc, globals->row_max), rowbuf);
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+        {
+            double *dist = G_malloc(ncols * sizeof(double));
+
+#pragma omp for schedule(dynamic)
+            for (row = row1; row < row2; row++)
+                estimate_row(&rows, &par, row, dist,
+                             est + (size_t)(row - row1) * 4 * ncols);
+
+            G_free(dist);
+        }
 
-                        /* get spectral distance */
-                        diff2 =
-                            (globals->calculate_similarity)(&Rin, &Rn, globals);
+        /* sums in the order of the cells */
+        for (row = row1; row < row2; row++) {
+            const double *count = est + (size_t)(row - row1) * 4 * ncols;
+            const double *mindiff = count + ncols;
+            const double *mindiffzero = count + 2 * ncols;
+            const double *avgdiff = count + 3 * ncols;
 
-                        if (mindiff > diff2)
-                            mindiff = diff2;
-                        if (mindiffzero > diff2 && diff2 > 0)
-                            mindiffzero = diff2;
-                        avgdiff += sqrt(diff2);
-                        count++;
-                    }
+            for (col = 0; col < ncols; col++) {
+                if ((FLAG_GET(globals->null_flag, row, globals->col_min + col)))
+                    continue;
+                if (count[col]) {
+                    nvalid++;
+                    if (mindiff[col] > 0)
+                        mindiffavg += sqrt(mindiff[col]);
+                    mindiffzeroavg += sqrt(mindiffzero[col]);
+                    if (avgdiff[col] > 0)
+                        avgdiffavg += avgdiff[col] / count[col];
                 }
             }
-            if (count) {
-                nvalid++;
-                if (mindiff > 0)
-                    mindiffavg += sqrt(mindiff);
-                mindiffzeroavg += sqrt(mindiffzero);
-                if (avgdiff > 0)
-                    avgdiffavg += avgdiff / count;
-            }
         }
     }
     G_percent(1, 1, 1);
@@ -193,7 +486,7 @@ int mean_shift(struct globals *globals)
     else {
         G_message(_("Estimated range bandwidth: %g"), mindiffzeroavg);
     }
-    if (do_adaptive) {
+    if (par.do_adaptive) {
         /* bandwidth is now standard deviation for adaptive bandwidth
          * using a gaussian function with range bandwidth used as
          * bandwidth for the gaussian function
@@ -205,6 +498,8 @@ int mean_shift(struct globals *globals)
 
     hspec2 = hspec * hspec;
     sigmaspec2 = hspec2 / 9.;
+    par.hspec2 = hspec2;
+    par.sigmaspec2 = sigmaspec2;
 
     if (!do_progressive) {
         G_message(_("Spatial bandwidth: %g"), hspat);
@@ -235,17 +530,25 @@ int mean_shift(struct globals *globals)
                 hspat *= 1.1;
             hspat2 = hspat * hspat;
             sigmaspat2 = hspat2 / 9.;
-            radiusc = hspat; /* radius in cells truncated to integer */
-            mwnrows = mwncols = radiusc * 2 + 1;
+            par.radiusc = hspat; /* radius in cells truncated to integer */
+            par.hspat2 = hspat2;
+            par.sigmaspat2 = sigmaspat2;
 
             /* spectral bandwidth: reduce by 0.7 */
             if (t > 1)
                 hspec *= 0.9;
             hspec2 = hspec * hspec;
             sigmaspec2 = hspec2 / 9.;
+            par.hspec2 = hspec2;
+            par.sigmaspec2 = sigmaspec2;
 
             G_verbose_message(_("Spatial bandwidth: %g"), hspat);
             G_verbose_message(_("Range bandwidth: %g"), hspec);
+
+            rows.val = G_realloc(rows.val, (size_t)(srows + 2 * par.radiusc) *
+                                               ncols * globals->datasize);
+            rows.null =
+                G_realloc(rows.null, (size_t)(srows + 2 * par.radiusc) * ncols);
         }
 
         n_changes = 0;
@@ -258,141 +561,54 @@ int mean_shift(struct globals *globals)
 
         /*process candidate cells */
         G_percent_reset();
-        for (row = globals->row_min; row < globals->row_max; row++) {
-            G_percent(row - globals->row_min,
-                      globals->row_max - globals->row_min, 4);
-
-            mwrow1 = row - radiusc;
-            mwrow2 = mwrow1 + mwnrows;
-            if (mwrow1 < globals->row_min)
-                mwrow1 = globals->row_min;
-            if (mwrow2 > globals->row_max)
-                mwrow2 = globals->row_max;
-
-            for (col = globals->col_min; col < globals->col_max; col++) {
-                if ((FLAG_GET(globals->null_flag, row, col)))
-                    continue;
-
-                /* get current band values */
-                Segment_get(globals->bands_in, (void *)Rin.mean, row, col);
-
-                /* init output */
-                for (n = 0; n < globals->nbands; n++)
-                    Rout.mean[n] = 0.;
-
-                mwcol1 = col - radiusc;
-                mwcol2 = mwcol1 + mwncols;
-                if (mwcol1 < globals->col_min)
-                    mwcol1 = globals->col_min;
-                if (mwcol2 > globals->col_max)
-                    mwcol2 = globals->col_max;
-
-                hspecad2 = hspec2;
-
-                if (do_adaptive) {
-                    /* adapt initial range bandwidth */
-
-                    ka2 = hspec2; /* OTB: conductance parameter */
-
-                    avgdiff = 0;
-                    count = 0;
-                    for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
-                        for (mwcol = mwcol1; mwcol < mwcol2; mwcol++) {
-                            if ((FLAG_GET(globals->null_flag, mwrow, mwcol)))
-                                continue;
-                            if (mwrow == row && mwcol == col)
-                                continue;
-
-                            diff = mwrow - row;
-                            diff2 = diff * diff;
-                            diff = mwcol - col;
-                            diff2 += diff * diff;
-
-                            if (diff2 <= hspat2) {
-
-                                Segment_get(globals->bands_in, (void *)Rn.mean,
-                                            mwrow, mwcol);
-
-                                /* get spectral distance */
-                                diff2 = (globals->calculate_similarity)(
-                                    &Rin, &Rn, globals);
+        for (row1 = globals->row_min; row1 < globals->row_max; row1 += srows) {
+            G_percent(row1 - globals->row_min, nrows, 4);
+
+            row2 = row1 + srows;
+            if (row2 > globals->row_max)
+                row2 = globals->row_max;
+            load_rows(globals, globals->bands_in, &rows,
+                      MAX(row1 - par.radiusc, globals->row_min),
+                      MIN(row2 + par.radiusc, globals->row_max), rowbuf);
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+            {
+                double *work = G_malloc(6 * ncols * sizeof(double));
+
+#pragma omp for schedule(dynamic)
+                for (row = row1; row < row2; row++)
+                    shift_row(&rows, &par, row, work,
+                              out + (size_t)(row - row1) * globals->nbands *
+                                        ncols,
+                              change + (size_t)(row - row1) * ncols);
+
+                G_free(work);
+            }
 
-                                avgdiff += sqrt(diff2);
-                                count++;
-                            }
-                        }
-                    }
-                    hspecad2 = 0;
-                    if (avgdiff > 0) {
-                        avgdiff /= count;
-                        hspecad = hspec;
-                        /* OTB-like, contrast enhancing */
-                        hspecad = exp(-avgdiff * avgdiff / (2 * ka2)) * avgdiff;
-                        /* preference for large regions, from Perona Malik 1990
-                         * if the settings are right, it could be used to reduce
-                         * noise */
-                        /* hspecad = 1 / (1 + (avgdiff * avgdiff / (2 *
-                         * hspec2))); */
-                        hspecad2 = hspecad * hspecad;
-                        G_debug(1, "avg spectral diff: %g", avgdiff);
-                        G_debug(1, "initial hspec2: %g", hspec2);
-                        G_debug(1, "adapted hspec2: %g", hspecad2);
-                    }
-                }
+            /* put new band values */
+            for (row = row1; row < row2; row++) {
+                const double *o =
+                    out + (size_t)(row - row1) * globals->nbands * ncols;
+                const double *diff2 = change + (size_t)(row - row1) * ncols;
 
-                /* actual mean shift */
-                wsum = 0;
-                for (mwrow = mwrow1; mwrow < mwrow2; mwrow++) {
-                    for (mwcol = mwcol1; mwcol < mwcol2; mwcol++) {
-                        if ((FLAG_GET(globals->null_flag, mwrow, mwcol)))
-                            continue;
-                        diff = mwrow - row;
-                        diff2 = diff * diff;
-                        diff = mwcol - col;
-                        diff2 += diff * diff;
-
-                        if (diff2 <= hspat2) {
-                            w = 1;
-                            if (do_gauss)
-                                w = gauss_kernel(diff2, sigmaspat2);
-
-                            Segment_get(globals->bands_in, (void *)Rn.mean,
-                                        mwrow, mwcol);
-
-                            /* check spectral distance */
-                            diff2 = (globals->calculate_similarity)(&Rin, &Rn,
-                                                                    globals);
-                            if (diff2 <= hspecad2) {
-                                if (do_gauss)
-                                    w *= gauss_kernel(diff2, sigmaspec2);
-                                wsum += w;
-                                for (n = 0; n < globals->nbands; n++)
-                                    Rout.mean[n] += w * Rn.mean[n];
-                            }
-                        }
-                    }
-                }
+                for (col = 0; col < ncols; col++) {
+                    if ((FLAG_GET(globals->null_flag, row,
+                                  globals->col_min + col)))
+                        continue;
 
-                if (wsum > 0) {
-                    for (n = 0; n < globals->nbands; n++)
-                        Rout.mean[n] /= wsum;
-                }
-                else {
                     for (n = 0; n < globals->nbands; n++)
-                        Rout.mean[n] = Rin.mean[n];
+                        Rout.mean[n] = o[(size_t)n * ncols + col];
+                    Segment_put(globals->bands_out, (void *)Rout.mean, row,
+                                globals->col_min + col);
+
+                    /* if the squared difference between old and new band
+                     * values is larger than alpha2, then increase n_changes
+                     */
+                    if (diff2[col] > alpha2)
+                        n_changes++;
+                    if (maxdiff2 < diff2[col])
+                        maxdiff2 = diff2[col];
                 }
-
-                /* put new band values */
-                Segment_put(globals->bands_out, (void *)Rout.mean, row, col);
-
-                /* if the squared difference between old and new band values
-                 * is larger than alpha2, then increase n_changes */
-
-                diff2 = (globals->calculate_similarity)(&Rin, &Rout, globals);
-                if (diff2 > alpha2)
-                    n_changes++;
-                if (maxdiff2 < diff2)
-                    maxdiff2 = diff2;
             }
         }
         G_percent(1, 1, 1);
@@ -408,6 +624,14 @@ int mean_shift(struct globals *globals)
     else
         G_message(_("Mean shift converged after %d iterations"), t);
 
+    G_free(Rout.mean);
+    G_free(rows.val);
+    G_free(rows.null);
+    G_free(rowbuf);
+    G_free(out);
+    G_free(change);
+    G_free(est);
+
     /* identify connected components */
     cluster_bands(globals);
 
@@ -516,11 +516,35 @@ static int read_seed(struct globals *globals, SEGMENT *seeds_seg, struct rc *Ri,
 
 static int manage_memory(int srows, int scols, struct globals *globals)
 {
-    double reg_size_mb, segs_mb;
+    double reg_size_mb, segs_mb, tile_mb, mb;
     LARGEINT reg_size_count;
     int nseg, nseg_total;
 
-    segs_mb = globals->mb;
+    mb = globals->mb;
+
+    /* tiles grown in parallel are kept in memory: band values in the
+     * tile segment and as input, region IDs, flags of the cells */
+    globals->tile_batch = 0;
+    if (globals->method == ORM_RG && globals->nprocs > 1 && !globals->seeds &&
+        (globals->nrows > TILE_SIZE || globals->ncols > TILE_SIZE)) {
+        tile_mb = (double)TILE_SIZE * TILE_SIZE *
+                  (2 * globals->datasize + sizeof(CELL) + 1 + 2 / 8.);
+        tile_mb /= (1024. * 1024.);
+
+        /* at most half of the memory is used for tiles */
+        globals->tile_batch = 4 * globals->nprocs;
+        if (globals->tile_batch * tile_mb > mb / 2)
+            globals->tile_batch = mb / 2 / tile_mb;
+        if (globals->tile_batch < 1)
+            globals->tile_batch = 1;
+        mb -= globals->tile_batch * tile_mb;
+        if (mb < 1)
+            mb = 1;
+        G_verbose_message(_("%d tiles are grown at once"),
+                          globals->tile_batch);
+    }
+
+    segs_mb = mb;
     if (globals->method == ORM_RG) {
 
         /* minimum region size to store in search tree */
@@ -530,12 +554,12 @@ static int manage_memory(int srows, int scols, struct globals *globals)
         reg_size_mb /= (1024. * 1024.);
 
         /* put aside some memory for segment structures */
-        segs_mb = globals->mb * 0.1;
+        segs_mb = mb * 0.1;
         if (segs_mb > 10)
             segs_mb = 10;
 
         /* calculate number of region stats that can be kept in memory */
-        reg_size_count = (globals->mb - segs_mb) / reg_size_mb;
+        reg_size_count = (mb - segs_mb) / reg_size_mb;
         if (reg_size_count < 1)
             reg_size_count = 1;
         globals->min_reg_size = 3;
@@ -548,7 +572,7 @@ static int manage_memory(int srows, int scols, struct globals *globals)
             reg_size_count =
                 (double)globals->notnullcells / globals->min_reg_size;
             /* recalculate segs_mb */
-            segs_mb = globals->mb - reg_size_count * reg_size_mb;
+            segs_mb = mb - reg_size_count * reg_size_mb;
             if (segs_mb < 10)
                 segs_mb = 10;
         }
@@ -16,7 +16,7 @@ int parse_args(int argc, char *argv[], struct globals *globals)
 #endif
         *mem;
     struct Flag *diagonal, *weighted, *ms_a, *ms_p;
-    struct Option *gof, *endt;
+    struct Option *gof, *endt, *nprocs;
     int bands;
 
     /* required parameters */
@@ -117,6 +117,8 @@ int parse_args(int argc, char *argv[], struct globals *globals)
 
     mem = G_define_standard_option(G_OPT_MEMORYMB);
 
+    nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /* TODO input for distance function */
 
     /* debug parameters */
@@ -179,6 +181,8 @@ int parse_args(int argc, char *argv[], struct globals *globals)
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    globals->nprocs = G_set_omp_num_threads(nprocs);
+
     /* Check and save parameters */
 
     for (bands = 0; group->answers[bands] != NULL; bands++)
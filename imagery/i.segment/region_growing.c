@@ -17,14 +17,18 @@
 
 #define EPSILON 1.0e-8
 
-struct idlist {
-    int *ids;
-    int nids, nalloc;
-    CELL cellmax;
+/* cells that are candidates in each pass */
+#define RG_ALL   0 /* all cells */
+#define RG_TILE  1 /* all cells of a tile, no final merging */
+#define RG_SEAMS 2 /* cells of segments cut by the borders of tiles */
+
+struct tile {
+    int row, col;      /* first row and column of the tile */
+    struct globals tg; /* processing info for the cells of the tile */
+    DCELL *orig;       /* input band values of the cells */
+    char *cut;         /* segments touching another tile, by ID */
 };
 
-static struct idlist idlist;
-
 /* internal functions */
 static int merge_regions(struct ngbr_stats *, struct reg_stats *, /* Ri */
                          struct ngbr_stats *, struct reg_stats *, /* Rk */
@@ -42,42 +46,48 @@ static int find_best_neighbor(struct ngbr_stats *, struct reg_stats *,
                               struct globals *);
 static int calculate_reg_stats(int, int, struct reg_stats *, struct globals *);
 
-void init_free_ids(void)
+static void init_free_ids(struct globals *globals)
 {
-    idlist.nalloc = 10;
-    idlist.nids = 0;
+    struct idlist *idlist = &globals->free_ids;
+
+    idlist->nalloc = 10;
+    idlist->nids = 0;
 
-    idlist.ids = G_malloc(idlist.nalloc * sizeof(int));
+    idlist->ids = G_malloc(idlist->nalloc * sizeof(int));
 
-    idlist.cellmax = ((CELL)1 << (sizeof(CELL) * 8 - 2)) - 1;
-    idlist.cellmax += ((CELL)1 << (sizeof(CELL) * 8 - 2));
+    idlist->cellmax = ((CELL)1 << (sizeof(CELL) * 8 - 2)) - 1;
+    idlist->cellmax += ((CELL)1 << (sizeof(CELL) * 8 - 2));
 
     return;
 }
 
-void add_free_id(int id)
+static void add_free_id(struct globals *globals, int id)
 {
+    struct idlist *idlist = &globals->free_ids;
+
     if (id <= 0)
         return;
 
-    if (idlist.nalloc <= idlist.nids) {
-        idlist.nalloc = idlist.nids + 10;
-        idlist.ids = G_realloc(idlist.ids, idlist.nalloc * sizeof(int));
+    if (idlist->nalloc <= idlist->nids) {
+        idlist->nalloc = idlist->nids + 10;
+        idlist->ids = G_realloc(idlist->ids, idlist->nalloc * sizeof(int));
     }
-    idlist.ids[idlist.nids++] = id;
+    idlist->ids[idlist->nids++] = id;
 
     return;
 }
 
-int get_free_id(struct globals *globals)
+static int get_free_id(struct globals *globals)
 {
-    if (idlist.nids > 0) {
-        idlist.nids--;
+    struct idlist *idlist = &globals->free_ids;
+
+    if (idlist->nids > 0) {
+        idlist->nids--;
 
-        return idlist.ids[idlist.nids];
+        return idlist->ids[idlist->nids];
     }
 
-    if (globals->max_rid == idlist.cellmax)
+    if (globals->max_rid == idlist->cellmax)
         G_fatal_error(_("Too many objects: integer overflow"));
 
     globals->max_rid++;
@@ -85,13 +95,15 @@ int get_free_id(struct globals *globals)
     return globals->max_rid;
 }
 
-void free_free_ids(void)
+static void free_free_ids(struct globals *globals)
 {
-    if (idlist.nalloc) {
-        G_free(idlist.ids);
-        idlist.ids = NULL;
-        idlist.nalloc = 0;
-        idlist.nids = 0;
+    struct idlist *idlist = &globals->free_ids;
+
+    if (idlist->nalloc) {
+        G_free(idlist->ids);
+        idlist->ids = NULL;
+        idlist->nalloc = 0;
+        idlist->nids = 0;
     }
 
     return;
@@ -183,11 +195,24 @@ static int dump_Ri(struct ngbr_stats *Ri, struct reg_stats *Ri_rs,
 }
 #endif /* unused */
 
-int region_growing(struct globals *globals)
+/* cell of a segment not yet processed in the current pass, segments that
+ * were not cut by tiles are not processed when merging across tiles */
+static int is_candidate(struct globals *globals, int mode, int row, int col)
+{
+    if (FLAG_GET(globals->candidate_flag, row, col))
+        return 1;
+
+    return mode == RG_SEAMS && !(FLAG_GET(globals->seam_flag, row, col));
+}
+
+/* grow regions in passes until no more regions are merged, then assign IDs
+ * to single cells and merge small segments except for a tile
+ * divisor is the sum of rows and columns of the input maps */
+static int grow_regions(struct globals *globals, double divisor, int mode)
 {
     int row, col, t;
     double threshold, adjthresh, Ri_similarity, Rk_similarity;
-    double alpha2, divisor; /* threshold parameters */
+    double alpha2; /* threshold parameters */
     int n_merges, do_merge; /* number of merges on that iteration */
     int pathflag; /* =1 if we didn't find mutually best neighbors, continue with
                      Rk */
@@ -206,14 +231,11 @@ int region_growing(struct globals *globals)
     struct NB_TREE *tmpnbtree;
 
     /* CELL cellmax; */
-    struct Cell_head cellhd;
-
-    G_verbose_message("Running region growing algorithm");
 
     /* cellmax = ((CELL) 1 << (sizeof(CELL) * 8 - 2)) - 1;
        cellmax += ((CELL) 1 << (sizeof(CELL) * 8 - 2)); */
 
-    init_free_ids();
+    init_free_ids(globals);
 
     /* init neighbor stats */
     Ri.mean = G_malloc(globals->datasize);
@@ -239,15 +261,15 @@ int region_growing(struct globals *globals)
     threshold = alpha2;
     G_debug(1, "Squared threshold: %g", threshold);
 
-    Rast_get_cellhd(globals->Ref.file[0].name, globals->Ref.file[0].mapset,
-                    &cellhd);
-    divisor = cellhd.rows + cellhd.cols;
-
     /* TODO: renumber seeds */
 
     while (t < globals->end_t && n_merges > 1) {
 
-        G_message(_("Processing pass %d..."), ++t);
+        t++;
+        if (mode == RG_SEAMS)
+            G_message(_("Merging segments across tiles, pass %d..."), t);
+        else if (mode == RG_ALL)
+            G_message(_("Processing pass %d..."), t);
 
         n_merges = 0;
         globals->candidate_count = 0;
@@ -256,7 +278,9 @@ int region_growing(struct globals *globals)
         /* Set candidate flag to true/1 for all non-NULL cells */
         for (row = globals->row_min; row < globals->row_max; row++) {
             for (col = globals->col_min; col < globals->col_max; col++) {
-                if (!(FLAG_GET(globals->null_flag, row, col))) {
+                if (!(FLAG_GET(globals->null_flag, row, col)) &&
+                    (mode != RG_SEAMS ||
+                     FLAG_GET(globals->seam_flag, row, col))) {
 
                     FLAG_SET(globals->candidate_flag, row, col);
                     globals->candidate_count++;
@@ -268,10 +292,12 @@ int region_growing(struct globals *globals)
                 globals->candidate_count);
 
         /*process candidate cells */
-        G_percent_reset();
+        if (mode != RG_TILE)
+            G_percent_reset();
         for (row = globals->row_min; row < globals->row_max; row++) {
-            G_percent(row - globals->row_min,
-                      globals->row_max - globals->row_min, 4);
+            if (mode != RG_TILE)
+                G_percent(row - globals->row_min,
+                          globals->row_max - globals->row_min, 4);
             for (col = globals->col_min; col < globals->col_max; col++) {
                 if (!(FLAG_GET(globals->candidate_flag, row, col)))
                     continue;
@@ -323,7 +349,7 @@ int region_growing(struct globals *globals)
                 }
 
                 if (/* !(t & 1) && */ Ri_nn == 1 &&
-                    !(FLAG_GET(globals->candidate_flag, Rk.row, Rk.col)) &&
+                    !is_candidate(globals, mode, Rk.row, Rk.col) &&
                     compare_double(Ri_similarity, threshold) == -1) {
                     /* this is slow ??? */
                     int smaller = Rk.count;
@@ -358,7 +384,7 @@ int region_growing(struct globals *globals)
                     /* optional check if Rk is candidate
                      * to prevent backwards merging */
                     if (candidates_only &&
-                        !(FLAG_GET(globals->candidate_flag, Rk.row, Rk.col))) {
+                        !is_candidate(globals, mode, Rk.row, Rk.col)) {
 
                         Ri_similarity = 2;
                     }
@@ -523,42 +549,50 @@ int region_growing(struct globals *globals)
                 } /* end pathflag */
             } /* next col */
         } /* next row */
-        G_percent(1, 1, 1);
 
-        /* finished one pass for processing candidate pixels */
-        G_verbose_message("%d merges", n_merges);
+        if (mode != RG_TILE) {
+            G_percent(1, 1, 1);
+
+            /* finished one pass for processing candidate pixels */
+            G_verbose_message("%d merges", n_merges);
+        }
 
         G_debug(4, "Finished pass %d", t);
     }
 
     /*end t loop */ /*TODO, should there be a max t that it can iterate for?
                        Include t in G_message? */
-    if (n_merges > 1)
+    if (mode != RG_TILE && n_merges > 1)
         G_message(_("Segmentation processes stopped at %d due to reaching max "
                     "iteration limit, more merges may be possible"),
                   t);
-    else
+    else if (mode != RG_TILE)
         G_message(_("Segmentation converged after %d iterations"), t);
 
-    /* assign region IDs to remaining 0 IDs */
-    G_message(_("Assigning region IDs to remaining single-cell regions..."));
-    for (row = globals->row_min; row < globals->row_max; row++) {
-        G_percent(row - globals->row_min, globals->row_max - globals->row_min,
-                  4);
-        for (col = globals->col_min; col < globals->col_max; col++) {
-            if (!(FLAG_GET(globals->null_flag, row, col))) {
-                /* get segment id */
-                Segment_get(&globals->rid_seg, (void *)&Ri.id, row, col);
-                if (Ri.id == 0) {
-                    Ri.id = get_free_id(globals);
-                    Segment_put(&globals->rid_seg, (void *)&Ri.id, row, col);
+    /* assign region IDs to remaining 0 IDs,
+     * for tiles after merging across tiles */
+    if (mode != RG_TILE) {
+        G_message(
+            _("Assigning region IDs to remaining single-cell regions..."));
+        for (row = globals->row_min; row < globals->row_max; row++) {
+            G_percent(row - globals->row_min,
+                      globals->row_max - globals->row_min, 4);
+            for (col = globals->col_min; col < globals->col_max; col++) {
+                if (!(FLAG_GET(globals->null_flag, row, col))) {
+                    /* get segment id */
+                    Segment_get(&globals->rid_seg, (void *)&Ri.id, row, col);
+                    if (Ri.id == 0) {
+                        Ri.id = get_free_id(globals);
+                        Segment_put(&globals->rid_seg, (void *)&Ri.id, row,
+                                    col);
+                    }
                 }
             }
         }
+        G_percent(1, 1, 1);
     }
-    G_percent(1, 1, 1);
 
-    free_free_ids();
+    free_free_ids(globals);
 
     /* ******************************************************************************************
      */
@@ -567,7 +601,7 @@ int region_growing(struct globals *globals)
     /* ******************************************************************************************
      */
 
-    if (globals->min_segment_size > 1) {
+    if (mode != RG_TILE && globals->min_segment_size > 1) {
         G_message(_("Merging segments smaller than %d cells..."),
                   globals->min_segment_size);
 
@@ -685,6 +719,253 @@ int region_growing(struct globals *globals)
     return TRUE;
 }
 
+/* allocate the processing info of a tile, all data are kept in memory */
+static void init_tile(struct globals *globals, struct tile *tile)
+{
+    struct globals *tg = &tile->tg;
+
+    *tg = *globals;
+
+    tg->null_flag = flag_create(TILE_SIZE, TILE_SIZE);
+    tg->candidate_flag = flag_create(TILE_SIZE, TILE_SIZE);
+
+    /* one segment of the size of the tile: memory cache */
+    if (Segment_open(&tg->bands_seg, NULL, TILE_SIZE, TILE_SIZE, TILE_SIZE,
+                     TILE_SIZE, globals->datasize, 1) != 1 ||
+        Segment_open(&tg->rid_seg, NULL, TILE_SIZE, TILE_SIZE, TILE_SIZE,
+                     TILE_SIZE, sizeof(CELL), 1) != 1)
+        G_fatal_error(_("Unable to allocate memory for tiles"));
+
+    tg->bands_val = G_malloc(globals->datasize);
+    tg->second_val = G_malloc(globals->datasize);
+    tg->rs.sum = G_malloc(globals->datasize);
+    tg->rs.mean = G_malloc(globals->datasize);
+
+    tile->orig = G_malloc((size_t)TILE_SIZE * TILE_SIZE * globals->datasize);
+    tile->cut = G_malloc((size_t)TILE_SIZE * TILE_SIZE + 1);
+}
+
+static void free_tile(struct tile *tile)
+{
+    struct globals *tg = &tile->tg;
+
+    flag_destroy(tg->null_flag);
+    flag_destroy(tg->candidate_flag);
+    Segment_close(&tg->bands_seg);
+    Segment_close(&tg->rid_seg);
+    G_free(tg->bands_val);
+    G_free(tg->second_val);
+    G_free(tg->rs.sum);
+    G_free(tg->rs.mean);
+    G_free(tile->orig);
+    G_free(tile->cut);
+}
+
+/* copy band values, region IDs and NULL flags of a tile */
+static void load_tile(struct globals *globals, struct tile *tile, int row,
+                      int col)
+{
+    struct globals *tg = &tile->tg;
+    int r, c;
+    CELL rid;
+    DCELL *orig;
+
+    tile->row = row;
+    tile->col = col;
+
+    tg->nrows = globals->row_max - row;
+    if (tg->nrows > TILE_SIZE)
+        tg->nrows = TILE_SIZE;
+    tg->ncols = globals->col_max - col;
+    if (tg->ncols > TILE_SIZE)
+        tg->ncols = TILE_SIZE;
+    tg->row_min = tg->col_min = 0;
+    tg->row_max = tg->nrows;
+    tg->col_max = tg->ncols;
+
+    tg->max_rid = 0;
+    tg->reg_tree = rgtree_create(globals->nbands, globals->datasize);
+
+    flag_clear_all(tg->null_flag);
+    orig = tile->orig;
+    for (r = 0; r < tg->nrows; r++) {
+        for (c = 0; c < tg->ncols; c++) {
+            Segment_get(&globals->bands_seg, (void *)orig, row + r, col + c);
+            Segment_put(&tg->bands_seg, (void *)orig, r, c);
+            orig += globals->nbands;
+            Segment_get(&globals->rid_seg, (void *)&rid, row + r, col + c);
+            Segment_put(&tg->rid_seg, (void *)&rid, r, c);
+            if (FLAG_GET(globals->null_flag, row + r, col + c))
+                FLAG_SET(tg->null_flag, r, c);
+        }
+    }
+}
+
+/* cell of a tile next to another tile */
+static int at_border(struct globals *globals, struct tile *tile, int r, int c)
+{
+    struct globals *tg = &tile->tg;
+
+    return (r == 0 && tile->row > globals->row_min) ||
+           (r == tg->nrows - 1 && tile->row + r < globals->row_max - 1) ||
+           (c == 0 && tile->col > globals->col_min) ||
+           (c == tg->ncols - 1 && tile->col + c < globals->col_max - 1);
+}
+
+/* copy the segments of a tile back, with IDs following those assigned
+ * before
+ * segments touching another tile are split into single cells with their
+ * input values, to be grown again across tiles */
+static void store_tile(struct globals *globals, struct tile *tile)
+{
+    struct globals *tg = &tile->tg;
+    struct RG_TRAV trav;
+    struct reg_stats *rs;
+    int r, c;
+    CELL rid, offset, cellmax;
+    DCELL *orig;
+
+    cellmax = ((CELL)1 << (sizeof(CELL) * 8 - 2)) - 1;
+    cellmax += ((CELL)1 << (sizeof(CELL) * 8 - 2));
+
+    offset = globals->max_rid;
+    if (tg->max_rid > cellmax - offset)
+        G_fatal_error(_("Too many objects: integer overflow"));
+
+    memset(tile->cut, 0, tg->max_rid + 1);
+    for (r = 0; r < tg->nrows; r++) {
+        for (c = 0; c < tg->ncols; c++) {
+            if (!(FLAG_GET(tg->null_flag, r, c)) &&
+                at_border(globals, tile, r, c)) {
+                Segment_get(&tg->rid_seg, (void *)&rid, r, c);
+                tile->cut[rid] = 1;
+            }
+        }
+    }
+
+    orig = tile->orig;
+    for (r = 0; r < tg->nrows; r++) {
+        for (c = 0; c < tg->ncols; c++, orig += globals->nbands) {
+            if (FLAG_GET(tg->null_flag, r, c))
+                continue;
+
+            Segment_get(&tg->rid_seg, (void *)&rid, r, c);
+            if (tile->cut[rid] && (rid > 0 || at_border(globals, tile, r, c))) {
+                FLAG_SET(globals->seam_flag, tile->row + r, tile->col + c);
+                rid = 0;
+                Segment_put(&globals->bands_seg, (void *)orig, tile->row + r,
+                            tile->col + c);
+            }
+            else {
+                /* single cells keep ID 0 */
+                if (rid > 0)
+                    rid += offset;
+                /* small segments store their sums in the band values */
+                Segment_get(&tg->bands_seg, (void *)globals->bands_val, r, c);
+                Segment_put(&globals->bands_seg, (void *)globals->bands_val,
+                            tile->row + r, tile->col + c);
+            }
+            Segment_put(&globals->rid_seg, (void *)&rid, tile->row + r,
+                        tile->col + c);
+        }
+    }
+
+    /* segments in the search tree */
+    rgtree_init_trav(&trav, tg->reg_tree);
+    while ((rs = rgtree_traverse(&trav)) != NULL) {
+        if (tile->cut[rs->id])
+            continue;
+        globals->rs.id = rs->id + offset;
+        globals->rs.count = rs->count;
+        memcpy(globals->rs.sum, rs->sum, globals->datasize);
+        memcpy(globals->rs.mean, rs->mean, globals->datasize);
+        rgtree_insert(globals->reg_tree, &(globals->rs));
+    }
+    rgtree_destroy(tg->reg_tree);
+    tg->reg_tree = NULL;
+
+    globals->max_rid += tg->max_rid;
+}
+
+/* grow regions in tiles, the tiles of a batch are processed in parallel
+ * and copied back in the order of the tiles */
+static void grow_tiles(struct globals *globals, double divisor)
+{
+    int i, n, t, ntiles, ntile_cols, nbatch;
+    struct tile *tiles;
+
+    ntile_cols =
+        (globals->col_max - globals->col_min + TILE_SIZE - 1) / TILE_SIZE;
+    ntiles =
+        (globals->row_max - globals->row_min + TILE_SIZE - 1) / TILE_SIZE *
+        ntile_cols;
+
+    /* tiles in memory are part of the memory budget */
+    nbatch = globals->tile_batch;
+    if (nbatch > ntiles)
+        nbatch = ntiles;
+
+    G_message(_("Growing segments in %d tiles..."), ntiles);
+
+    tiles = G_malloc(nbatch * sizeof(struct tile));
+    for (i = 0; i < nbatch; i++)
+        init_tile(globals, &tiles[i]);
+
+    for (t = 0; t < ntiles; t += nbatch) {
+        G_percent(t, ntiles, 2);
+
+        n = ntiles - t;
+        if (n > nbatch)
+            n = nbatch;
+
+        for (i = 0; i < n; i++)
+            load_tile(globals, &tiles[i],
+                      globals->row_min + (t + i) / ntile_cols * TILE_SIZE,
+                      globals->col_min + (t + i) % ntile_cols * TILE_SIZE);
+
+#pragma omp parallel for num_threads(globals->nprocs) schedule(dynamic)
+        for (i = 0; i < n; i++)
+            grow_regions(&tiles[i].tg, divisor, RG_TILE);
+
+        for (i = 0; i < n; i++)
+            store_tile(globals, &tiles[i]);
+    }
+    G_percent(1, 1, 1);
+
+    for (i = 0; i < nbatch; i++)
+        free_tile(&tiles[i]);
+    G_free(tiles);
+}
+
+int region_growing(struct globals *globals)
+{
+    struct Cell_head cellhd;
+    double divisor;
+    int ret;
+
+    G_verbose_message("Running region growing algorithm");
+
+    Rast_get_cellhd(globals->Ref.file[0].name, globals->Ref.file[0].mapset,
+                    &cellhd);
+    divisor = cellhd.rows + cellhd.cols;
+
+    /* segments are first grown in tiles in parallel, those cut by the
+     * tiles are grown again over the whole window; seeds can extend over
+     * several tiles */
+    if (globals->nprocs > 1 && !globals->seeds &&
+        (globals->row_max - globals->row_min > TILE_SIZE ||
+         globals->col_max - globals->col_min > TILE_SIZE)) {
+        globals->seam_flag = flag_create(globals->nrows, globals->ncols);
+        grow_tiles(globals, divisor);
+        ret = grow_regions(globals, divisor, RG_SEAMS);
+        flag_destroy(globals->seam_flag);
+
+        return ret;
+    }
+
+    return grow_regions(globals, divisor, RG_ALL);
+}
+
 static void free_item(void *p)
 {
     G_free(p);
@@ -1196,7 +1477,7 @@ static int merge_regions(struct ngbr_stats *Ri, struct reg_stats *Ri_rs,
             /* remove from tree */
             rgtree_remove(globals->reg_tree, Rk_rs);
         }
-        add_free_id(Rk->id);
+        add_free_id(globals, Rk->id);
     }
     else {
 
@@ -1206,7 +1487,7 @@ static int merge_regions(struct ngbr_stats *Ri, struct reg_stats *Ri_rs,
             /* remove from tree */
             rgtree_remove(globals->reg_tree, Ri_rs);
         }
-        add_free_id(Ri->id);
+        add_free_id(globals, Ri->id);
 
         /* magic switch */
         Ri_rs->id = Rk->id;
@@ -21,10 +21,11 @@ class TestReport(TestCase):
             "g.region", n=220000, s=219456, w=637033, e=638000, align=map_input
         )
         cls.use_temp_region()
+        cls.runModule("i.group", group="ortho", input=map_input)
 
     @classmethod
     def tearDownClass(cls):
-        map_output = "test"
+        map_output = "test,test_p2,test_p4,test_ms1,test_ms2"
         group = "ortho"
         cls.runModule("g.remove", flags="f", type="raster", name=map_output)
         cls.runModule("g.remove", flags="f", type="group", name=group)
@@ -32,11 +33,9 @@ class TestReport(TestCase):
 
     def test_isegment(self):
         """Testing i.segment"""
-        map_input = "ortho_2001_t792_1m"
         map_output = "test"
         group = "ortho"
 
-        self.assertModule("i.group", group=group, input=map_input)
         self.assertModule(
             "i.segment", group=group, threshold=0.01, minsize=1, output=map_output
         )
@@ -47,6 +46,47 @@ class TestReport(TestCase):
             msg="Number of segments must be > 0",
         )
 
+    def test_isegment_nprocs(self):
+        """Testing i.segment with tiles grown in parallel"""
+        group = "ortho"
+
+        for nprocs in (2, 4):
+            self.assertModule(
+                "i.segment",
+                group=group,
+                threshold=0.02,
+                minsize=5,
+                output="test_p%d" % nprocs,
+                nprocs=nprocs,
+            )
+        self.assertRasterMinMax(
+            map="test_p2",
+            refmin=1,
+            refmax=500000,
+            msg="Number of segments must be > 0",
+        )
+        self.assertRastersNoDifference(
+            actual="test_p4", reference="test_p2", precision=0
+        )
+
+    def test_isegment_meanshift_nprocs(self):
+        """Testing i.segment mean shift with several threads"""
+        group = "ortho"
+
+        for nprocs in (1, 2):
+            self.assertModule(
+                "i.segment",
+                group=group,
+                method="mean_shift",
+                threshold=0.05,
+                minsize=5,
+                output="test_ms%d" % nprocs,
+                nprocs=nprocs,
+            )
+        self.assertRastersNoDifference(
+            actual="test_ms2", reference="test_ms1", precision=0
+        )
+
 
 if __name__ == "__main__":
     from grass.gunittest.main import test
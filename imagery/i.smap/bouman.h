@@ -26,6 +26,7 @@ struct parms {
     char *sigfile;
     int blocksize;
     int ml;
+    int nprocs;
 };
 
 /* parse.c */
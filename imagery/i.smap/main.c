@@ -10,7 +10,7 @@
  *               Jan-Oliver Wagner <jan intevation.de>
  * PURPOSE:      segment multispectral images using a spectral class model
  *               known as a Gaussian mixture distribution
- * COPYRIGHT:    (C) 1999-2008 by the GRASS Development Team
+ * COPYRIGHT:    (C) 1999-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -39,6 +39,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("supervised classification"));
     G_add_keyword(_("segmentation"));
     G_add_keyword(_("SMAP"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Performs contextual image classification "
           "using sequential maximum a posteriori (SMAP) estimation.");
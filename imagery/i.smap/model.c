@@ -8,11 +8,15 @@
 
 #define PI M_PI
 
+/* subclasses of all classes */
+static struct I_discriminant D;
+
 void extract_init(struct SigSet *S)
 {
     int m;
     int i;
     int b1, b2;
+    int n;
     int nbands;
     double *lambda;
     double **tmp_mat;
@@ -20,6 +24,12 @@ void extract_init(struct SigSet *S)
     struct SubSig *SubS;
 
     nbands = S->nbands;
+    n = 0;
+    for (m = 0; m < S->nclasses; m++)
+        n += S->ClassSig[m].nsubclasses;
+    I_init_discriminant(&D, nbands, n);
+    n = 0;
+
     /* allocate scratch memory */
     lambda = G_alloc_vector(nbands);
     tmp_mat = G_alloc_matrix(nbands, nbands);
@@ -63,103 +73,107 @@ void extract_init(struct SigSet *S)
 
             /* Precomputes the inverse of tex->R */
             invert(SubS->Rinv, nbands);
+            I_set_discriminant(&D, n++, SubS->cnst, SubS->means, SubS->Rinv,
+                               0);
         }
     }
     G_free_vector(lambda);
     G_free_matrix(tmp_mat);
 }
 
+void extract_free(void)
+{
+    I_free_discriminant(&D);
+}
+
 void extract(DCELL ***img,          /* multispectral image, img[band][i][j] */
              struct Region *region, /* region to extract */
              LIKELIHOOD ***ll,      /* log likelihood, ll[i][j][class] */
-             struct SigSet *S       /* class signatures */
+             struct SigSet *S,      /* class signatures */
+             int nprocs             /* number of threads */
 )
 {
-    int i, j;            /* column and row indexes */
-    int m;               /* class index */
-    int k;               /* subclass index */
-    int b1, b2;          /* spectral index */
-    int no_data;         /* no data flag */
-    int max_nsubclasses; /* maximum number of subclasses */
-    int nbands;          /* number of spectral bands */
-    double *subll;       /* log likelihood of subclasses */
-    double *diff;
-    double maxlike = 0.0L;
-    double subsum;
-    struct ClassSig *C;
-    struct SubSig *SubS;
-
-    nbands = S->nbands;
-
-    /* determine the maximum number of subclasses */
-    max_nsubclasses = 0;
-    for (m = 0; m < S->nclasses; m++)
-        if (S->ClassSig[m].nsubclasses > max_nsubclasses)
-            max_nsubclasses = S->ClassSig[m].nsubclasses;
-
-    /* allocate memory */
-    diff = (double *)G_malloc(nbands * sizeof(double));
-    subll = (double *)G_malloc(max_nsubclasses * sizeof(double));
+    int nbands = S->nbands; /* number of spectral bands */
+    int width = region->xmax - region->xmin;
 
     /* Compute log likelihood at each pixel and for every class. */
 
-    /* for each pixel */
-    for (i = region->ymin; i < region->ymax; i++)
-        for (j = region->xmin; j < region->xmax; j++) {
-
-            /* Check for no data condition */
-            no_data = 1;
-            for (b1 = 0; (b1 < nbands) && no_data; b1++)
-                no_data = no_data && (Rast_is_d_null_value(&img[b1][i][j]));
+    /* rows in parallel */
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+    {
+        int i, j;      /* column and row indexes */
+        int m;         /* class index */
+        int k, k0;     /* subclass index */
+        int b1;        /* spectral index */
+        int no_data;   /* no data flag */
+        double *subll; /* log likelihood of subclasses of the row */
+        double *work;  /* work space of the discriminant functions */
+        DCELL **x;     /* bands of the row */
+        double maxlike = 0.0L;
+        double subsum;
+        struct ClassSig *C;
+
+        /* allocate memory */
+        subll = (double *)G_malloc((size_t)D.n * width * sizeof(double));
+        work = I_alloc_discriminant_work(&D);
+        x = (DCELL **)G_malloc(nbands * sizeof(DCELL *));
+
+#pragma omp for schedule(dynamic)
+        for (i = region->ymin; i < region->ymax; i++) {
+            /* log likelihood of each subclass at each pixel of the row,
+             * subll[k * width + j - xmin] */
+            for (b1 = 0; b1 < nbands; b1++)
+                x[b1] = img[b1][i] + region->xmin;
+            I_discriminant_batch(&D, x, width, subll, work);
+
+            for (j = region->xmin; j < region->xmax; j++) {
+                double *sub = subll + j - region->xmin;
+
+                /* Check for no data condition */
+                no_data = 1;
+                for (b1 = 0; (b1 < nbands) && no_data; b1++)
+                    no_data =
+                        no_data && (Rast_is_d_null_value(&img[b1][i][j]));
+
+                if (no_data) {
+                    for (m = 0; m < S->nclasses; m++)
+                        ll[i][j][m] = 0.0;
+                    continue;
+                }
 
-            if (no_data) {
-                for (m = 0; m < S->nclasses; m++)
-                    ll[i][j][m] = 0.0;
-            }
-            else {
                 /* for each class */
-                for (m = 0; m < S->nclasses; m++) {
+                for (m = 0, k0 = 0; m < S->nclasses; m++) {
                     C = &(S->ClassSig[m]);
 
-                    /* compute log likelihood for each subclass */
-                    for (k = 0; k < C->nsubclasses; k++) {
-                        SubS = &(C->SubSig[k]);
-                        subll[k] = SubS->cnst;
-                        for (b1 = 0; b1 < nbands; b1++) {
-                            diff[b1] = img[b1][i][j] - SubS->means[b1];
-                            subll[k] -=
-                                0.5 * diff[b1] * diff[b1] * SubS->Rinv[b1][b1];
-                        }
-                        for (b1 = 0; b1 < nbands; b1++)
-                            for (b2 = b1 + 1; b2 < nbands; b2++)
-                                subll[k] -=
-                                    diff[b1] * diff[b2] * SubS->Rinv[b1][b2];
-                    }
-
                     /* shortcut for one subclass */
                     if (C->nsubclasses == 1) {
-                        ll[i][j][m] = subll[0];
+                        ll[i][j][m] = sub[(size_t)k0 * width];
                     }
                     /* compute mixture likelihood */
                     else {
                         /* find the most likely subclass */
                         for (k = 0; k < C->nsubclasses; k++) {
                             if (k == 0)
-                                maxlike = subll[k];
-                            if (subll[k] > maxlike)
-                                maxlike = subll[k];
+                                maxlike = sub[(size_t)(k0 + k) * width];
+                            if (sub[(size_t)(k0 + k) * width] > maxlike)
+                                maxlike = sub[(size_t)(k0 + k) * width];
                         }
 
                         /* Sum weighted subclass likelihoods */
                         subsum = 0;
                         for (k = 0; k < C->nsubclasses; k++)
-                            subsum += exp(subll[k] - maxlike) * C->SubSig[k].pi;
+                            subsum +=
+                                exp(sub[(size_t)(k0 + k) * width] - maxlike) *
+                                C->SubSig[k].pi;
 
                         ll[i][j][m] = log(subsum) + maxlike;
                     }
+                    k0 += C->nsubclasses;
                 }
             }
         }
-    G_free((char *)diff);
-    G_free((char *)subll);
+        G_free(subll);
+        G_free(work);
+        G_free(x);
+    }
 }
@@ -7,7 +7,7 @@
 int parse(int argc, char *argv[], struct parms *parms)
 {
     struct Option *group, *subgroup, *sigfile, *output, *goodness;
-    struct Option *blocksize;
+    struct Option *blocksize, *nprocs;
     struct Flag *ml;
 
     group = G_define_standard_option(G_OPT_I_GROUP);
@@ -40,6 +40,8 @@ int parse(int argc, char *argv[], struct parms *parms)
     blocksize->type = TYPE_INTEGER;
     blocksize->answer = "1024";
 
+    nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     ml = G_define_flag();
     ml->key = 'm';
     ml->description = _("Use maximum likelihood estimation (instead of smap)");
@@ -48,6 +50,7 @@ int parse(int argc, char *argv[], struct parms *parms)
         exit(EXIT_FAILURE);
 
     parms->ml = ml->answer;
+    parms->nprocs = G_set_omp_num_threads(nprocs);
 
     parms->output_map = output->answer;
     parms->group = group->answer;
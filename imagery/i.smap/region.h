@@ -35,5 +35,7 @@ int read_block(DCELL ***, struct Region *, struct files *);
 #ifdef GRASS_IMAGERY_H
 /* model.c */
 void extract_init(struct SigSet *);
-void extract(DCELL ***, struct Region *, LIKELIHOOD ***, struct SigSet *);
+void extract_free(void);
+void extract(DCELL ***, struct Region *, LIKELIHOOD ***, struct SigSet *,
+             int);
 #endif
@@ -103,7 +103,7 @@ int segment(struct SigSet *S, /* class parameters */
         read_block(img, &region, files);
 
         shift_ll(ll_pym, &region, block_size);
-        extract(img, &region, ll_pym[0], S);
+        extract(img, &region, ll_pym[0], S, parms->nprocs);
 
         if (ml)
             MLE(sf_pym[0], ll_pym[0], &region, nclasses, goodness);
@@ -115,6 +115,7 @@ int segment(struct SigSet *S, /* class parameters */
 
     } while (increment_reg(&region, wd, ht, block_size));
 
+    extract_free();
     write_img(sf_pym[0], goodness, wd, ht, S, parms, files);
 
     return 0;
@@ -155,6 +155,15 @@ class TestISmap(TestCase):
         self.assertRastersEqual(baseline, bs1)
         self.assertRastersEqual(baseline, bs2)
 
+    def test_nprocs(self):
+        """Ensure the number of threads doesn't affect results"""
+        baseline = self._run_smap(f"{self.output_map}_np1", nprocs=1)
+        np4 = self._run_smap(f"{self.output_map}_np4", nprocs=4, blocksize=256)
+
+        self.temp_rasters.extend([baseline, np4])
+
+        self.assertRastersEqual(baseline, np4)
+
 
 if __name__ == "__main__":
     test()
@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /*  ARVI is resistant to atmospheric effects (in comparison to the NDVI) and
    is accomplished by a self correcting process for the atmospheric effect in
@@ -8,16 +7,21 @@
    the red channels. (Kaufman and Tanre 1996) */
 
 /* Atmospheric Resistant Vegetation Index */
-double ar_vi(double redchan, double nirchan, double bluechan)
+void ar_vi(const FCELL *redchan, const FCELL *nirchan, const FCELL *bluechan,
+           FCELL *result, int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col], blue = bluechan[col];
+
+        result[col] = (nir - (2 * red - blue)) / (nir + (2 * red - blue));
     }
-    else {
-        result = (nirchan - (2 * redchan - bluechan)) /
-                 (nirchan + (2 * redchan - bluechan));
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -0,0 +1,149 @@
+"""Benchmarking of i.vi
+
+Throughput of i.vi in MB/s of the input bands read by each run on a
+synthetic multi-band image. Each index is given only the bands it needs.
+To compare two builds of i.vi, save the results with the build before the
+change and compare them with the build after the change:
+
+    python benchmark_i_vi.py --save before.json
+    python benchmark_i_vi.py --compare before.json
+
+Each index is computed in a separate run, which works with every version
+of i.vi. The "all" result is the time to compute all the indices: the sum
+of the separate runs, or one run with all indices if i.vi supports several
+indices per run. Its throughput is given for the four input bands in both
+cases.
+
+@author GRASS Development Team
+"""
+
+import argparse
+from subprocess import DEVNULL
+from types import SimpleNamespace
+
+import grass.benchmark as bm
+from grass.pygrass.modules import Module
+
+BANDS = ["red", "nir", "green", "blue"]
+# bands needed by each index
+VINAMES = {
+    "arvi": ["red", "nir", "blue"],
+    "dvi": ["red", "nir"],
+    "evi": ["red", "nir", "blue"],
+    "gemi": ["red", "nir"],
+    "msavi2": ["red", "nir"],
+    "ndvi": ["red", "nir"],
+    "ndwi": ["green", "nir"],
+    "savi": ["red", "nir"],
+    "sr": ["red", "nir"],
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--save", help="Save results to a JSON file")
+    parser.add_argument("--compare", help="Compare with results in a JSON file")
+    args = parser.parse_args()
+
+    results = []
+    # Users can add more or modify existing reference maps
+    benchmark(5000, "i.vi_25M", results)
+    benchmark(10000, "i.vi_100M", results)
+
+    print_results(results)
+    if args.save:
+        bm.save_results_to_file(results, args.save)
+    if args.compare:
+        compare(bm.load_results_from_file(args.compare).results, results)
+
+
+def benchmark(size, label, results):
+    references = {band: f"i_vi_reference_map_{band}" for band in BANDS}
+    output = "benchmark_i_vi"
+    # FCELL bands
+    band_megabytes = size * size * 4 / 1e6
+    megabytes = len(BANDS) * band_megabytes
+
+    generate_map(rows=size, cols=size, fname=references)
+    nprocs = "nprocs" in Module("i.vi", run_=False).inputs
+
+    total = 0
+    for viname, bands in VINAMES.items():
+        module = Module(
+            "i.vi",
+            viname=viname,
+            output=output,
+            run_=False,
+            stdout_=DEVNULL,
+            overwrite=True,
+            **{band: references[band] for band in bands},
+        )
+        if nprocs:
+            module.update(nprocs=1)
+        result = bm.benchmark_single(module, label=f"{label}_{viname}", repeat=3)
+        result.mbps = len(bands) * band_megabytes / result.time
+        results.append(result)
+        total += result.time
+
+    outputs = [f"{output}_{viname}" for viname in VINAMES]
+    if nprocs:
+        module = Module(
+            "i.vi",
+            viname=list(VINAMES),
+            output=outputs,
+            run_=False,
+            stdout_=DEVNULL,
+            overwrite=True,
+            **references,
+        )
+        parallel = bm.benchmark_nprocs(
+            module, label=f"{label}_all", max_nprocs=8, repeat=3
+        )
+        for n, time in zip(parallel.nprocs, parallel.times):
+            print(f"{label}_all: {megabytes / time:.0f} MB/s with {n} thread(s)")
+        # single thread, as the separate runs
+        total = parallel.times[0]
+    results.append(
+        SimpleNamespace(label=f"{label}_all", time=total, mbps=megabytes / total)
+    )
+
+    Module(
+        "g.remove", quiet=True, flags="f", type="raster", name=list(references.values())
+    )
+    Module("g.remove", quiet=True, flags="f", type="raster", name=[output, *outputs])
+
+
+def generate_map(rows, cols, fname):
+    Module("g.region", flags="p", s=0, n=rows, w=0, e=cols, res=1)
+    print("Generating reference maps using r.mapcalc...")
+    for i, name in enumerate(fname.values()):
+        # reflectance with about 1% of null cells
+        Module(
+            "r.mapcalc",
+            expression=f"{name} = if(rand(0, 100) == 0, null(), "
+            "float(rand(0.0, 1.0)))",
+            seed=i + 1,
+            overwrite=True,
+        )
+
+
+def print_results(results):
+    for result in results:
+        print(f"{result.label}: {result.mbps:.1f} MB/s ({result.time:.3f}s)")
+
+
+def compare(before, after):
+    before = {result.label: result for result in before}
+    print(f"{'':20} {'before MB/s':>12} {'after MB/s':>12} {'speedup':>8}")
+    for result in after:
+        if result.label not in before:
+            continue
+        old = before[result.label]
+        print(
+            f"{result.label:20} {old.mbps:12.1f} {result.mbps:12.1f} "
+            f"{old.time / result.time:8.2f}"
+        )
+
+
+if __name__ == "__main__":
+    main()
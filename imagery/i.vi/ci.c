@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /*From
  * https://karnieli-rsl.com/image.ashx?i=901711.pdf&fn=1997-Karnieli_CI_IJRS_97.pdf
@@ -10,15 +9,21 @@
  * Ben Gurion University, Sede-Boker Campus 84990, Israel. (Received 26 January
  * 1996; in ® nal form 19 July 1996) */
 /* Crust Index */
-double c_i(double bluechan, double redchan)
+void c_i(const FCELL *bluechan, const FCELL *redchan, FCELL *result,
+         int ncols)
 {
-    double result;
+    int col;
 
-    if ((redchan + bluechan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double blue = bluechan[col], red = redchan[col];
+
+        result[col] = 1 - (red - blue) / (red + blue);
     }
-    else {
-        result = 1 - (redchan - bluechan) / (redchan + bluechan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double blue = bluechan[col], red = redchan[col];
+
+        result[col] = (red + blue) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -1,22 +1,27 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* EVI: Enhanced Vegetation Index
  * Huete A.R., Liu H.Q., Batchily K., vanLeeuwen W. (1997)
  * A comparison of vegetation indices global set of TM images for EOS-MODIS
  * Remote Sensing of Environment, 59:440-451.
  */
-double e_vi(double bluechan, double redchan, double nirchan)
+void e_vi(const FCELL *bluechan, const FCELL *redchan, const FCELL *nirchan,
+          FCELL *result, int ncols)
 {
-    double tmp, result;
+    int col;
 
-    tmp = nirchan + 6.0 * redchan - 7.5 * bluechan + 1.0;
-    if (tmp == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double blue = bluechan[col], red = redchan[col], nir = nirchan[col];
+
+        result[col] = 2.5 * (nir - red) / (nir + 6.0 * red - 7.5 * blue + 1.0);
     }
-    else {
-        result = 2.5 * (nirchan - redchan) / tmp;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double blue = bluechan[col], red = redchan[col], nir = nirchan[col];
+        double tmp = nir + 6.0 * red - 7.5 * blue + 1.0;
+
+        result[col] = tmp == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
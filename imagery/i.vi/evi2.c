@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* EVI2: Enhanced Vegetation Index
  * Zhangyan Jiang ; Alfredo R. Huete ; Youngwook Kim and Kamel Didan
@@ -9,16 +8,22 @@
  * Sustainability IV, 667905 (October 09, 2007) doi:10.1117/12.734933
  * https://doi.org/10.1117/12.734933
  */
-double e_vi2(double redchan, double nirchan)
+void e_vi2(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double tmp, result;
+    int col;
 
-    tmp = nirchan + 2.4 * redchan + 1.0;
-    if (tmp == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = 2.5 * (nir - red) / (nir + 2.4 * red + 1.0);
     }
-    else {
-        result = 2.5 * (nirchan - redchan) / tmp;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+        double tmp = nir + 2.4 * red + 1.0;
+
+        result[col] = tmp == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
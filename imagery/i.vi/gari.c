@@ -1,15 +1,18 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /*GARI: green atmospherically resistant vegetation index */
-double ga_ri(double redchan, double nirchan, double bluechan, double greenchan)
+void ga_ri(const FCELL *redchan, const FCELL *nirchan, const FCELL *bluechan,
+           const FCELL *greenchan, FCELL *result, int ncols)
 {
-    double result;
+    int col;
 
-    {
-        result = (nirchan - (greenchan - (bluechan - redchan))) /
-                 (nirchan + (greenchan - (bluechan - redchan)));
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+        double blue = bluechan[col], green = greenchan[col];
+
+        result[col] = (nir - (green - (blue - red))) /
+                      (nir + (green - (blue - red)));
     }
-    return result;
 }
@@ -1,25 +1,26 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* GEMI: Global Environmental Monitoring Index
  */
-double ge_mi(double redchan, double nirchan)
+void ge_mi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+        double num = 2 * ((nir * nir) - (red * red)) + 1.5 * nir + 0.5 * red;
+        double den = nir + red + 0.5;
+
+        result[col] = ((num / den) * (1 - 0.25 * num / den)) -
+                      ((red - 0.125) / (1 - red));
     }
-    else {
-        result = (((2 * ((nirchan * nirchan) - (redchan * redchan)) +
-                    1.5 * nirchan + 0.5 * redchan) /
-                   (nirchan + redchan + 0.5)) *
-                  (1 - 0.25 *
-                           (2 * ((nirchan * nirchan) - (redchan * redchan)) +
-                            1.5 * nirchan + 0.5 * redchan) /
-                           (nirchan + redchan + 0.5))) -
-                 ((redchan - 0.125) / (1 - redchan));
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -1,19 +1,25 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* Green Vegetation Index */
-double g_vi(double bluechan, double greenchan, double redchan, double nirchan,
-            double chan5chan, double chan7chan)
+void g_vi(const FCELL *bluechan, const FCELL *greenchan, const FCELL *redchan,
+          const FCELL *nirchan, const FCELL *chan5chan, const FCELL *chan7chan,
+          FCELL *result, int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = -0.2848 * bluechan[col] - 0.2435 * greenchan[col] -
+                      0.5436 * red + 0.7243 * nir + 0.0840 * chan5chan[col] -
+                      0.1800 * chan7chan[col];
     }
-    else {
-        result = (-0.2848 * bluechan - 0.2435 * greenchan - 0.5436 * redchan +
-                  0.7243 * nirchan + 0.0840 * chan5chan - 0.1800 * chan7chan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
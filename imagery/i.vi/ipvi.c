@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /*
    IPVI: Infrared Percentage Vegetation Index
@@ -9,15 +8,21 @@
    IPVI = --------
    NIR+red
  */
-double ip_vi(double redchan, double nirchan)
+void ip_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = nir / (nir + red);
     }
-    else {
-        result = (nirchan) / (nirchan + redchan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -7,7 +7,7 @@
  * PURPOSE:      Calculates 16 vegetation and related indices
  *               based on biophysical parameters.
  *
- * COPYRIGHT:    (C) 2002-2019 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2002-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -35,54 +35,205 @@
 #include <grass/raster.h>
 #include <grass/glocale.h>
 
-double c_i(double bluechan, double redchan);
-double s_r(double redchan, double nirchan);
-double nd_vi(double redchan, double nirchan);
-double nd_wi(double greenchan, double nirchan);
-double ip_vi(double redchan, double nirchan);
-double d_vi(double redchan, double nirchan);
-double e_vi(double bluechan, double redchan, double nirchan);
-double e_vi2(double redchan, double nirchan);
-double p_vi(double redchan, double nirchan, double soil_line_slope);
-double wd_vi(double redchan, double nirchan);
-double sa_vi(double redchan, double nirchan);
-double msa_vi(double redchan, double nirchan, double soil_line_slope,
-              double soil_line_intercept, double soil_noise_reduction_factor);
-double msa_vi2(double redchan, double nirchan);
-double ge_mi(double redchan, double nirchan);
-double ar_vi(double redchan, double nirchan, double bluechan);
-double g_vi(double bluechan, double greenchan, double redchan, double nirchan,
-            double chan5chan, double chan7chan);
-double ga_ri(double redchan, double nirchan, double bluechan, double greenchan);
-double va_ri(double redchan, double greenchan, double bluechan);
+/* input bands */
+enum { RED, NIR, GREEN, BLUE, CHAN5, CHAN7, NBANDS };
+
+/* vegetation indices, in the order of the viname options */
+enum {
+    ARVI,
+    CI,
+    DVI,
+    EVI,
+    EVI2,
+    GVI,
+    GARI,
+    GEMI,
+    IPVI,
+    MSAVI,
+    MSAVI2,
+    NDVI,
+    NDWI,
+    PVI,
+    SAVI,
+    SR,
+    VARI,
+    WDVI,
+    NVI
+};
+
+static const char *vi_names[NVI] = {
+    "arvi",  "ci",     "dvi",  "evi",  "evi2", "gvi",  "gari", "gemi", "ipvi",
+    "msavi", "msavi2", "ndvi", "ndwi", "pvi",  "savi", "sr",   "vari", "wdvi"};
+
+/* soil line parameters */
+struct soil_line {
+    FCELL slope, inter, noise;
+};
+
+/* The index functions compute one row. The formula is evaluated for all
+ * cells and the special values are selected in a second loop, so that
+ * both loops have no branches and are vectorized. */
+void c_i(const FCELL *bluechan, const FCELL *redchan, FCELL *result,
+         int ncols);
+void s_r(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+         int ncols);
+void nd_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void nd_wi(const FCELL *greenchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void ip_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void d_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+          int ncols);
+void e_vi(const FCELL *bluechan, const FCELL *redchan, const FCELL *nirchan,
+          FCELL *result, int ncols);
+void e_vi2(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void p_vi(const FCELL *redchan, const FCELL *nirchan, double soil_line_slope,
+          FCELL *result, int ncols);
+void wd_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void sa_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void msa_vi(const FCELL *redchan, const FCELL *nirchan,
+            double soil_line_slope, double soil_line_intercept,
+            double soil_noise_reduction_factor, FCELL *result, int ncols);
+void msa_vi2(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+             int ncols);
+void ge_mi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols);
+void ar_vi(const FCELL *redchan, const FCELL *nirchan, const FCELL *bluechan,
+           FCELL *result, int ncols);
+void g_vi(const FCELL *bluechan, const FCELL *greenchan, const FCELL *redchan,
+          const FCELL *nirchan, const FCELL *chan5chan, const FCELL *chan7chan,
+          FCELL *result, int ncols);
+void ga_ri(const FCELL *redchan, const FCELL *nirchan, const FCELL *bluechan,
+           const FCELL *greenchan, FCELL *result, int ncols);
+void va_ri(const FCELL *redchan, const FCELL *greenchan,
+           const FCELL *bluechan, FCELL *result, int ncols);
+
+/* all indices of one row
+ * band[b] is the row of band b or NULL if not given, out[k] the row of
+ * index vi[k], null a buffer for the null mask of the row */
+static void vi_row(FCELL **band, int ncols, const int *vi, int nvi,
+                   FCELL **out, char *null, const struct soil_line *soil)
+{
+    FCELL fnull, *o;
+    int b, k, col;
+
+    Rast_set_f_null_value(&fnull, 1);
+
+    /* a cell is null if any given band is null */
+    for (col = 0; col < ncols; col++)
+        null[col] = 0;
+    for (b = 0; b < NBANDS; b++) {
+        const FCELL *d = band[b];
+
+        if (!d)
+            continue;
+#pragma omp simd
+        for (col = 0; col < ncols; col++)
+            null[col] |= Rast_is_f_null_value(&d[col]);
+    }
+
+    for (k = 0; k < nvi; k++) {
+        o = out[k];
+
+        switch (vi[k]) {
+        case ARVI:
+            ar_vi(band[RED], band[NIR], band[BLUE], o, ncols);
+            break;
+        case CI: /* calculate crust_index */
+            c_i(band[BLUE], band[RED], o, ncols);
+            break;
+        case DVI:
+            d_vi(band[RED], band[NIR], o, ncols);
+            break;
+        case EVI:
+            e_vi(band[BLUE], band[RED], band[NIR], o, ncols);
+            break;
+        case EVI2:
+            e_vi2(band[RED], band[NIR], o, ncols);
+            break;
+        case GVI:
+            g_vi(band[BLUE], band[GREEN], band[RED], band[NIR], band[CHAN5],
+                 band[CHAN7], o, ncols);
+            break;
+        case GARI:
+            ga_ri(band[RED], band[NIR], band[BLUE], band[GREEN], o, ncols);
+            break;
+        case GEMI:
+            ge_mi(band[RED], band[NIR], o, ncols);
+            break;
+        case IPVI:
+            ip_vi(band[RED], band[NIR], o, ncols);
+            break;
+        case MSAVI:
+            msa_vi(band[RED], band[NIR], soil->slope, soil->inter,
+                   soil->noise, o, ncols);
+            break;
+        case MSAVI2:
+            msa_vi2(band[RED], band[NIR], o, ncols);
+            break;
+        case NDVI:
+            nd_vi(band[RED], band[NIR], o, ncols);
+            /* TODO: why this? */
+#pragma omp simd
+            for (col = 0; col < ncols; col++)
+                o[col] = band[RED][col] + band[NIR][col] < 0.001 ? fnull
+                                                                 : o[col];
+            break;
+        case NDWI:
+            nd_wi(band[GREEN], band[NIR], o, ncols);
+            break;
+        case PVI:
+            p_vi(band[RED], band[NIR], soil->slope, o, ncols);
+            break;
+        case SAVI:
+            sa_vi(band[RED], band[NIR], o, ncols);
+            break;
+        case SR: /* calculate simple_ratio */
+            s_r(band[RED], band[NIR], o, ncols);
+            break;
+        case VARI:
+            va_ri(band[RED], band[GREEN], band[BLUE], o, ncols);
+            break;
+        case WDVI:
+            wd_vi(band[RED], band[NIR], o, ncols);
+            break;
+        }
+
+#pragma omp simd
+        for (col = 0; col < ncols; col++)
+            o[col] = null[col] ? fnull : o[col];
+    }
+}
 
 int main(int argc, char *argv[])
 {
     int nrows, ncols;
-    int row, col;
+    int row, row0, nbuf, block_rows;
+    int b, k, nvi, nout, nprocs;
     char *viflag; /*Switch for particular index */
     char *desc;
     struct GModule *module;
     struct {
         struct Option *viname, *red, *nir, *green, *blue, *chan5, *chan7,
-            *sl_slope, *sl_int, *sl_red, *bits, *output;
+            *sl_slope, *sl_int, *sl_red, *bits, *output, *nprocs;
     } opt;
     struct History history; /*metadata */
     struct Colors colors;   /*Color rules */
 
     char *result; /*output raster name */
-    int infd_redchan, infd_nirchan, infd_greenchan;
-    int infd_bluechan, infd_chan5chan, infd_chan7chan;
-    int outfd;
-    char *bluechan, *greenchan, *redchan, *nirchan, *chan5chan, *chan7chan;
-    FCELL *inrast_redchan, *inrast_nirchan, *inrast_greenchan;
-    FCELL *inrast_bluechan, *inrast_chan5chan, *inrast_chan7chan;
-    FCELL *outrast;
-    RASTER_MAP_TYPE data_type_redchan;
-    RASTER_MAP_TYPE data_type_nirchan, data_type_greenchan;
-    RASTER_MAP_TYPE data_type_bluechan;
-    RASTER_MAP_TYPE data_type_chan5chan, data_type_chan7chan;
-    FCELL soil_slope, soil_inter, soil_noise, dnbits;
+    char *bandname[NBANDS];
+    int infd[NBANDS];
+    RASTER_MAP_TYPE data_type[NBANDS];
+    int *vi, *outfd;
+    FCELL **inrast, **outrast;
+    char *null;
+    struct soil_line soil;
+    FCELL dnbits;
+    double dnscale;
     CELL val1, val2;
 
     G_gisinit(argv[0]);
@@ -92,18 +243,22 @@ int main(int argc, char *argv[])
     G_add_keyword(_("vegetation index"));
     G_add_keyword(_("biophysical parameters"));
     G_add_keyword(_("NDVI"));
+    G_add_keyword(_("parallel"));
     module->label = _("Calculates different types of vegetation indices.");
     module->description = _("Uses red and nir bands mostly, "
                             "and some indices require additional bands.");
 
     /* Define the different options */
-    opt.output = G_define_standard_option(G_OPT_R_OUTPUT);
+    opt.output = G_define_standard_option(G_OPT_R_OUTPUTS);
+    opt.output->description = _("Name for output raster map, one per index");
 
     opt.viname = G_define_option();
     opt.viname->key = "viname";
     opt.viname->type = TYPE_STRING;
     opt.viname->required = YES;
-    opt.viname->description = _("Type of vegetation index");
+    opt.viname->description =
+        _("Type of vegetation index, several indices are computed in one "
+          "pass over the input maps");
     desc = NULL;
     G_asprintf(&desc,
                "arvi;%s;ci;%s;dvi;%s;evi;%s;evi2;%s;gvi;%s;gari;%s;gemi;%s;"
@@ -129,6 +284,7 @@ int main(int argc, char *argv[])
                           "msavi2,ndvi,ndwi,pvi,savi,sr,vari,wdvi";
     opt.viname->answer = "ndvi";
     opt.viname->key_desc = _("type");
+    opt.viname->multiple = YES;
 
     opt.red = G_define_standard_option(G_OPT_R_INPUT);
     opt.red->key = "red";
@@ -208,413 +364,255 @@ int main(int argc, char *argv[])
           "bits (i.e. 8 for Landsat -> [0-255])");
     opt.bits->options = "7,8,10,16";
     opt.bits->answer = "8";
+    opt.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
 
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
-    viflag = opt.viname->answer;
-    redchan = opt.red->answer;
-    nirchan = opt.nir->answer;
-    greenchan = opt.green->answer;
-    bluechan = opt.blue->answer;
-    chan5chan = opt.chan5->answer;
-    chan7chan = opt.chan7->answer;
+    bandname[RED] = opt.red->answer;
+    bandname[NIR] = opt.nir->answer;
+    bandname[GREEN] = opt.green->answer;
+    bandname[BLUE] = opt.blue->answer;
+    bandname[CHAN5] = opt.chan5->answer;
+    bandname[CHAN7] = opt.chan7->answer;
+    soil.slope = soil.inter = soil.noise = 0.;
     if (opt.sl_slope->answer)
-        soil_slope = atof(opt.sl_slope->answer);
+        soil.slope = atof(opt.sl_slope->answer);
     if (opt.sl_int->answer)
-        soil_inter = atof(opt.sl_int->answer);
+        soil.inter = atof(opt.sl_int->answer);
     if (opt.sl_red->answer)
-        soil_noise = atof(opt.sl_red->answer);
+        soil.noise = atof(opt.sl_red->answer);
+    dnbits = 0.;
     if (opt.bits->answer)
         dnbits = atof(opt.bits->answer);
-    result = opt.output->answer;
-    G_verbose_message(_("Calculating %s..."), viflag);
-
-    if (!strcasecmp(viflag, "ci") &&
-        (!(opt.blue->answer) || !(opt.red->answer)))
-        G_fatal_error(_("ci index requires blue and red maps"));
-
-    if (!strcasecmp(viflag, "sr") && (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("sr index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "ndvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("ndvi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "ndwi") &&
-        (!(opt.green->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("ndwi index requires green and nir maps"));
-
-    if (!strcasecmp(viflag, "ipvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("ipvi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "dvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("dvi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "pvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.sl_slope->answer)))
-        G_fatal_error(
-            _("pvi index requires red and nir maps and soil line slope"));
-
-    if (!strcasecmp(viflag, "wdvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("wdvi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "savi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("savi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "msavi") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.sl_slope->answer) ||
-         !(opt.sl_int->answer) || !(opt.sl_red->answer)))
-        G_fatal_error(_("msavi index requires red and nir maps, and 3 "
-                        "parameters related to soil line"));
-
-    if (!strcasecmp(viflag, "msavi2") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("msavi2 index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "gemi") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("gemi index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "arvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.blue->answer)))
-        G_fatal_error(_("arvi index requires blue, red and nir maps"));
-
-    if (!strcasecmp(viflag, "evi") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.blue->answer)))
-        G_fatal_error(_("evi index requires blue, red and nir maps"));
-
-    if (!strcasecmp(viflag, "evi2") &&
-        (!(opt.red->answer) || !(opt.nir->answer)))
-        G_fatal_error(_("evi2 index requires red and nir maps"));
-
-    if (!strcasecmp(viflag, "vari") &&
-        (!(opt.red->answer) || !(opt.green->answer) || !(opt.blue->answer)))
-        G_fatal_error(_("vari index requires blue, green and red maps"));
-
-    if (!strcasecmp(viflag, "gari") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.green->answer) ||
-         !(opt.blue->answer)))
-        G_fatal_error(_("gari index requires blue, green, red and nir maps"));
-
-    if (!strcasecmp(viflag, "gvi") &&
-        (!(opt.red->answer) || !(opt.nir->answer) || !(opt.green->answer) ||
-         !(opt.blue->answer) || !(opt.chan5->answer) || !(opt.chan7->answer)))
-        G_fatal_error(_(
-            "gvi index requires blue, green, red, nir, chan5 and chan7 maps"));
-
-    if (redchan) {
-        infd_redchan = Rast_open_old(redchan, "");
-        data_type_redchan = Rast_map_type(redchan, "");
-        inrast_redchan = Rast_allocate_buf(data_type_redchan);
+    dnscale = 1.0 / (pow(2, dnbits) - 1);
+
+    for (nvi = 0; opt.viname->answers[nvi]; nvi++)
+        ;
+    for (nout = 0; opt.output->answers[nout]; nout++)
+        ;
+    if (nout != nvi)
+        G_fatal_error(_("The number of output maps (%d) must match the number "
+                        "of indices (%d)"),
+                      nout, nvi);
+
+    vi = G_malloc(nvi * sizeof(int));
+    for (k = 0; k < nvi; k++) {
+        viflag = opt.viname->answers[k];
+        G_verbose_message(_("Calculating %s..."), viflag);
+
+        if (!strcasecmp(viflag, "ci") &&
+            (!(opt.blue->answer) || !(opt.red->answer)))
+            G_fatal_error(_("ci index requires blue and red maps"));
+
+        if (!strcasecmp(viflag, "sr") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("sr index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "ndvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("ndvi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "ndwi") &&
+            (!(opt.green->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("ndwi index requires green and nir maps"));
+
+        if (!strcasecmp(viflag, "ipvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("ipvi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "dvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("dvi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "pvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer) ||
+             !(opt.sl_slope->answer)))
+            G_fatal_error(
+                _("pvi index requires red and nir maps and soil line slope"));
+
+        if (!strcasecmp(viflag, "wdvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("wdvi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "savi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("savi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "msavi") &&
+            (!(opt.red->answer) || !(opt.nir->answer) ||
+             !(opt.sl_slope->answer) || !(opt.sl_int->answer) ||
+             !(opt.sl_red->answer)))
+            G_fatal_error(_("msavi index requires red and nir maps, and 3 "
+                            "parameters related to soil line"));
+
+        if (!strcasecmp(viflag, "msavi2") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("msavi2 index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "gemi") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("gemi index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "arvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer) || !(opt.blue->answer)))
+            G_fatal_error(_("arvi index requires blue, red and nir maps"));
+
+        if (!strcasecmp(viflag, "evi") &&
+            (!(opt.red->answer) || !(opt.nir->answer) || !(opt.blue->answer)))
+            G_fatal_error(_("evi index requires blue, red and nir maps"));
+
+        if (!strcasecmp(viflag, "evi2") &&
+            (!(opt.red->answer) || !(opt.nir->answer)))
+            G_fatal_error(_("evi2 index requires red and nir maps"));
+
+        if (!strcasecmp(viflag, "vari") &&
+            (!(opt.red->answer) || !(opt.green->answer) || !(opt.blue->answer)))
+            G_fatal_error(_("vari index requires blue, green and red maps"));
+
+        if (!strcasecmp(viflag, "gari") &&
+            (!(opt.red->answer) || !(opt.nir->answer) || !(opt.green->answer) ||
+             !(opt.blue->answer)))
+            G_fatal_error(
+                _("gari index requires blue, green, red and nir maps"));
+
+        if (!strcasecmp(viflag, "gvi") &&
+            (!(opt.red->answer) || !(opt.nir->answer) ||
+             !(opt.green->answer) || !(opt.blue->answer) ||
+             !(opt.chan5->answer) || !(opt.chan7->answer)))
+            G_fatal_error(_("gvi index requires blue, green, red, nir, chan5 "
+                            "and chan7 maps"));
+
+        for (vi[k] = 0; vi[k] < NVI; vi[k]++)
+            if (!strcasecmp(viflag, vi_names[vi[k]]))
+                break;
     }
 
-    if (nirchan) {
-        infd_nirchan = Rast_open_old(nirchan, "");
-        data_type_nirchan = Rast_map_type(nirchan, "");
-        inrast_nirchan = Rast_allocate_buf(data_type_nirchan);
-    }
+    nprocs = G_set_omp_num_threads(opt.nprocs);
+    /* rows read at once and processed in parallel */
+    block_rows = 4 * nprocs;
 
-    if (greenchan) {
-        infd_greenchan = Rast_open_old(greenchan, "");
-        data_type_greenchan = Rast_map_type(greenchan, "");
-        inrast_greenchan = Rast_allocate_buf(data_type_greenchan);
-    }
+    nrows = Rast_window_rows();
+    ncols = Rast_window_cols();
 
-    if (bluechan) {
-        infd_bluechan = Rast_open_old(bluechan, "");
-        data_type_bluechan = Rast_map_type(bluechan, "");
-        inrast_bluechan = Rast_allocate_buf(data_type_bluechan);
+    /* each input map is read once for all indices */
+    inrast = G_calloc((size_t)block_rows * NBANDS, sizeof(FCELL *));
+    for (b = 0; b < NBANDS; b++) {
+        if (!bandname[b])
+            continue;
+        infd[b] = Rast_open_old(bandname[b], "");
+        data_type[b] = Rast_map_type(bandname[b], "");
+        for (row = 0; row < block_rows; row++)
+            inrast[row * NBANDS + b] = Rast_allocate_f_buf();
     }
 
-    if (chan5chan) {
-        infd_chan5chan = Rast_open_old(chan5chan, "");
-        data_type_chan5chan = Rast_map_type(chan5chan, "");
-        inrast_chan5chan = Rast_allocate_buf(data_type_chan5chan);
+    /* Create New raster files */
+    outfd = G_malloc(nvi * sizeof(int));
+    outrast = G_malloc((size_t)block_rows * nvi * sizeof(FCELL *));
+    for (k = 0; k < nvi; k++) {
+        outfd[k] = Rast_open_new(opt.output->answers[k], FCELL_TYPE);
+        for (row = 0; row < block_rows; row++)
+            outrast[row * nvi + k] = Rast_allocate_f_buf();
     }
+    null = G_malloc((size_t)block_rows * ncols);
 
-    if (chan7chan) {
-        infd_chan7chan = Rast_open_old(chan7chan, "");
-        data_type_chan7chan = Rast_map_type(chan7chan, "");
-        inrast_chan7chan = Rast_allocate_buf(data_type_chan7chan);
-    }
+    /* Process pixels */
+    for (row0 = 0; row0 < nrows; row0 += block_rows) {
+        G_percent(row0, nrows, 2);
 
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
+        nbuf = nrows - row0 < block_rows ? nrows - row0 : block_rows;
 
-    /* Create New raster files */
-    outfd = Rast_open_new(result, FCELL_TYPE);
-    outrast = Rast_allocate_f_buf();
+        /* read input maps, reading rows is not thread-safe */
+        for (row = 0; row < nbuf; row++)
+            for (b = 0; b < NBANDS; b++)
+                if (bandname[b])
+                    Rast_get_f_row(infd[b], inrast[row * NBANDS + b],
+                                   row0 + row);
 
-    /* Process pixels */
-    for (row = 0; row < nrows; row++) {
-        FCELL d_bluechan;
-        FCELL d_greenchan;
-        FCELL d_redchan;
-        FCELL d_nirchan;
-        FCELL d_chan5chan;
-        FCELL d_chan7chan;
-
-        G_percent(row, nrows, 2);
-
-        /* read input maps */
-        if (redchan) {
-            Rast_get_row(infd_redchan, inrast_redchan, row, data_type_redchan);
-        }
-        if (nirchan) {
-            Rast_get_row(infd_nirchan, inrast_nirchan, row, data_type_nirchan);
-        }
-        if (bluechan) {
-            Rast_get_row(infd_bluechan, inrast_bluechan, row,
-                         data_type_bluechan);
-        }
-        if (greenchan) {
-            Rast_get_row(infd_greenchan, inrast_greenchan, row,
-                         data_type_greenchan);
-        }
-        if (chan5chan) {
-            Rast_get_row(infd_chan5chan, inrast_chan5chan, row,
-                         data_type_chan5chan);
-        }
-        if (chan7chan) {
-            Rast_get_row(infd_chan7chan, inrast_chan7chan, row,
-                         data_type_chan7chan);
-        }
         /* process the data */
-        for (col = 0; col < ncols; col++) {
-            if (redchan) {
-                switch (data_type_redchan) {
-                case CELL_TYPE:
-                    d_redchan = (double)((CELL *)inrast_redchan)[col];
-                    if (opt.bits->answer)
-                        d_redchan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_redchan = (double)((FCELL *)inrast_redchan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_redchan = ((DCELL *)inrast_redchan)[col];
-                    break;
-                }
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic) private(b)
+        for (row = 0; row < nbuf; row++) {
+            FCELL **band = &inrast[row * NBANDS];
+            int col;
+
+            /* digital numbers */
+            for (b = 0; b < NBANDS; b++) {
+                if (!bandname[b] || data_type[b] != CELL_TYPE ||
+                    !opt.bits->answer)
+                    continue;
+#pragma omp simd
+                for (col = 0; col < ncols; col++)
+                    band[b][col] *= dnscale;
             }
-            if (nirchan) {
-                switch (data_type_nirchan) {
-                case CELL_TYPE:
-                    d_nirchan = (double)((CELL *)inrast_nirchan)[col];
-                    if (opt.bits->answer)
-                        d_nirchan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_nirchan = (double)((FCELL *)inrast_nirchan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_nirchan = ((DCELL *)inrast_nirchan)[col];
-                    break;
-                }
-            }
-            if (greenchan) {
-                switch (data_type_greenchan) {
-                case CELL_TYPE:
-                    d_greenchan = (double)((CELL *)inrast_greenchan)[col];
-                    if (opt.bits->answer)
-                        d_greenchan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_greenchan = (double)((FCELL *)inrast_greenchan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_greenchan = ((DCELL *)inrast_greenchan)[col];
-                    break;
-                }
-            }
-            if (bluechan) {
-                switch (data_type_bluechan) {
-                case CELL_TYPE:
-                    d_bluechan = (double)((CELL *)inrast_bluechan)[col];
-                    if (opt.bits->answer)
-                        d_bluechan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_bluechan = (double)((FCELL *)inrast_bluechan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_bluechan = ((DCELL *)inrast_bluechan)[col];
-                    break;
-                }
-            }
-            if (chan5chan) {
-                switch (data_type_chan5chan) {
-                case CELL_TYPE:
-                    d_chan5chan = (double)((CELL *)inrast_chan5chan)[col];
-                    if (opt.bits->answer)
-                        d_chan5chan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_chan5chan = (double)((FCELL *)inrast_chan5chan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_chan5chan = ((DCELL *)inrast_chan5chan)[col];
-                    break;
-                }
-            }
-            if (chan7chan) {
-                switch (data_type_chan7chan) {
-                case CELL_TYPE:
-                    d_chan7chan = (double)((CELL *)inrast_chan7chan)[col];
-                    if (opt.bits->answer)
-                        d_chan7chan *= 1.0 / (pow(2, dnbits) - 1);
-                    break;
-                case FCELL_TYPE:
-                    d_chan7chan = (double)((FCELL *)inrast_chan7chan)[col];
-                    break;
-                case DCELL_TYPE:
-                    d_chan7chan = ((DCELL *)inrast_chan7chan)[col];
-                    break;
-                }
-            }
-
-            if (Rast_is_f_null_value(&d_redchan) ||
-                ((nirchan) && Rast_is_f_null_value(&d_nirchan)) ||
-                ((greenchan) && Rast_is_f_null_value(&d_greenchan)) ||
-                ((bluechan) && Rast_is_f_null_value(&d_bluechan)) ||
-                ((chan5chan) && Rast_is_f_null_value(&d_chan5chan)) ||
-                ((chan7chan) && Rast_is_f_null_value(&d_chan7chan))) {
-                Rast_set_f_null_value(&outrast[col], 1);
-            }
-            else {
-                /* calculate crust_index        */
-                if (!strcasecmp(viflag, "ci"))
-                    outrast[col] = c_i(d_bluechan, d_redchan);
-
-                /* calculate simple_ratio        */
-                if (!strcasecmp(viflag, "sr"))
-                    outrast[col] = s_r(d_redchan, d_nirchan);
 
-                /* calculate ndvi                    */
-                if (!strcasecmp(viflag, "ndvi")) {
-                    if (d_redchan + d_nirchan < 0.001) /* TODO: why this? */
-                        Rast_set_f_null_value(&outrast[col], 1);
-                    else
-                        outrast[col] = nd_vi(d_redchan, d_nirchan);
-                }
-
-                if (!strcasecmp(viflag, "ndwi"))
-                    outrast[col] = nd_wi(d_greenchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "ipvi"))
-                    outrast[col] = ip_vi(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "dvi"))
-                    outrast[col] = d_vi(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "evi"))
-                    outrast[col] = e_vi(d_bluechan, d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "evi2"))
-                    outrast[col] = e_vi2(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "pvi"))
-                    outrast[col] = p_vi(d_redchan, d_nirchan, soil_slope);
-
-                if (!strcasecmp(viflag, "wdvi"))
-                    outrast[col] = wd_vi(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "savi"))
-                    outrast[col] = sa_vi(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "msavi"))
-                    outrast[col] = msa_vi(d_redchan, d_nirchan, soil_slope,
-                                          soil_inter, soil_noise);
-
-                if (!strcasecmp(viflag, "msavi2"))
-                    outrast[col] = msa_vi2(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "gemi"))
-                    outrast[col] = ge_mi(d_redchan, d_nirchan);
-
-                if (!strcasecmp(viflag, "arvi"))
-                    outrast[col] = ar_vi(d_redchan, d_nirchan, d_bluechan);
-
-                if (!strcasecmp(viflag, "gvi"))
-                    outrast[col] = g_vi(d_bluechan, d_greenchan, d_redchan,
-                                        d_nirchan, d_chan5chan, d_chan7chan);
-
-                if (!strcasecmp(viflag, "gari"))
-                    outrast[col] =
-                        ga_ri(d_redchan, d_nirchan, d_bluechan, d_greenchan);
-
-                if (!strcasecmp(viflag, "vari"))
-                    outrast[col] = va_ri(d_redchan, d_greenchan, d_bluechan);
-            }
+            vi_row(band, ncols, vi, nvi, &outrast[row * nvi],
+                   &null[(size_t)row * ncols], &soil);
         }
-        Rast_put_f_row(outfd, outrast);
+
+        for (row = 0; row < nbuf; row++)
+            for (k = 0; k < nvi; k++)
+                Rast_put_f_row(outfd[k], outrast[row * nvi + k]);
     }
     G_percent(1, 1, 1);
 
-    if (redchan) {
-        G_free(inrast_redchan);
-        Rast_close(infd_redchan);
-    }
-    if (nirchan) {
-        G_free(inrast_nirchan);
-        Rast_close(infd_nirchan);
-    }
-    if (greenchan) {
-        G_free(inrast_greenchan);
-        Rast_close(infd_greenchan);
-    }
-    if (bluechan) {
-        G_free(inrast_bluechan);
-        Rast_close(infd_bluechan);
-    }
-    if (chan5chan) {
-        G_free(inrast_chan5chan);
-        Rast_close(infd_chan5chan);
-    }
-    if (chan7chan) {
-        G_free(inrast_chan7chan);
-        Rast_close(infd_chan7chan);
+    for (b = 0; b < NBANDS; b++) {
+        if (!bandname[b])
+            continue;
+        for (row = 0; row < block_rows; row++)
+            G_free(inrast[row * NBANDS + b]);
+        Rast_close(infd[b]);
     }
+    G_free(inrast);
 
+    for (k = 0; k < nvi; k++) {
+        for (row = 0; row < block_rows; row++)
+            G_free(outrast[row * nvi + k]);
+        Rast_close(outfd[k]);
+    }
     G_free(outrast);
-    Rast_close(outfd);
+    G_free(outfd);
+    G_free(null);
+
+    for (k = 0; k < nvi; k++) {
+        result = opt.output->answers[k];
 
-    if (!strcasecmp(viflag, "ndvi")) {
-        /* apply predefined NDVI color table */
-        const char *style = "ndvi";
+        if (vi[k] == NDVI) {
+            /* apply predefined NDVI color table */
+            const char *style = "ndvi";
 
-        if (G_find_color_rule("ndvi")) {
-            Rast_make_fp_colors(&colors, style, -1.0, 1.0);
+            if (G_find_color_rule("ndvi")) {
+                Rast_make_fp_colors(&colors, style, -1.0, 1.0);
+            }
+            else
+                G_fatal_error(_("Unknown color request '%s'"), style);
         }
-        else
-            G_fatal_error(_("Unknown color request '%s'"), style);
-    }
-    else if (!strcasecmp(viflag, "ndwi")) {
-        /* apply predefined NDWI color table */
-        const char *style = "ndwi";
+        else if (vi[k] == NDWI) {
+            /* apply predefined NDWI color table */
+            const char *style = "ndwi";
 
-        if (G_find_color_rule("ndwi")) {
-            Rast_make_fp_colors(&colors, style, -1.0, 1.0);
+            if (G_find_color_rule("ndwi")) {
+                Rast_make_fp_colors(&colors, style, -1.0, 1.0);
+            }
+            else
+                G_fatal_error(_("Unknown color request '%s'"), style);
         }
-        else
-            G_fatal_error(_("Unknown color request '%s'"), style);
-    }
-    else {
-        /* Color from -1.0 to +1.0 in grey */
-        Rast_init_colors(&colors);
-        val1 = -1;
-        val2 = 1;
-        Rast_add_c_color_rule(&val1, 0, 0, 0, &val2, 255, 255, 255, &colors);
-    }
-    Rast_write_colors(result, G_mapset(), &colors);
+        else {
+            /* Color from -1.0 to +1.0 in grey */
+            Rast_init_colors(&colors);
+            val1 = -1;
+            val2 = 1;
+            Rast_add_c_color_rule(&val1, 0, 0, 0, &val2, 255, 255, 255,
+                                  &colors);
+        }
+        Rast_write_colors(result, G_mapset(), &colors);
+        Rast_free_colors(&colors);
 
-    Rast_short_history(result, "raster", &history);
-    Rast_command_history(&history);
-    Rast_write_history(result, &history);
+        Rast_short_history(result, "raster", &history);
+        Rast_command_history(&history);
+        Rast_write_history(result, &history);
+    }
+    G_free(vi);
 
     exit(EXIT_SUCCESS);
 }
@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* MSAVI: Modified Soil Adjusted Vegetation Index
  *
@@ -12,21 +11,28 @@
  *      which is set to minimize soil noise (0.08 in
  *      original papers).
  */
-double msa_vi(double redchan, double nirchan, double soil_line_slope,
-              double soil_line_intercept, double soil_noise_reduction_factor)
+void msa_vi(const FCELL *redchan, const FCELL *nirchan,
+            double soil_line_slope, double soil_line_intercept,
+            double soil_noise_reduction_factor, FCELL *result, int ncols)
 {
-    double result, a, s, X;
+    double a, s, X;
+    int col;
 
     s = soil_line_slope;
     a = soil_line_intercept;
     X = soil_noise_reduction_factor;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] =
+            s * (nir - s * red - a) / (a * nir + red - a * s + X * (1 + s + s));
     }
-    else {
-        result = s * (nirchan - s * redchan - a) /
-                 (a * nirchan + redchan - a * s + X * (1 + s + s));
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -1,22 +1,26 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* MSAVI2: second Modified Soil Adjusted Vegetation Index
  *      MSAVI2 = (1/2)*(2(NIR+1)-sqrt((2*NIR+1)^2-8(NIR-red)))
  */
-double msa_vi2(double redchan, double nirchan)
+void msa_vi2(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+             int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0 ||
-        (2 * nirchan + 1) * (2 * nirchan + 1) <= 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+        double tmp = (2 * nir + 1) * (2 * nir + 1);
+
+        result[col] = 0.5 * (2 * nir + 1 - sqrt(tmp - 8 * (nir - red)));
     }
-    else {
-        result = 0.5 * (2 * nirchan + 1 -
-                        sqrt((2 * nirchan + 1) * (2 * nirchan + 1) -
-                             8 * (nirchan - redchan)));
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+        double tmp = (2 * nir + 1) * (2 * nir + 1);
+
+        result[col] = ((nir + red) == 0.0) | (tmp <= 0.0) ? -1.0 : result[col];
     }
-    return result;
 }
@@ -1,18 +1,24 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* Normalized Difference Water Index
  * after McFeeters (1996), https://doi.org/10.3390/rs5073544 */
-double nd_wi(double greenchan, double nirchan)
+void nd_wi(const FCELL *greenchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double result;
+    int col;
 
-    if ((greenchan + nirchan) == 0.0) {
-        result = -1.0; /* TODO: -1 or 0 */
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double green = greenchan[col], nir = nirchan[col];
+
+        result[col] = (green - nir) / (green + nir);
     }
-    else {
-        result = (greenchan - nirchan) / (greenchan + nirchan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double green = greenchan[col], nir = nirchan[col];
+
+        /* TODO: -1 or 0 */
+        result[col] = (green + nir) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
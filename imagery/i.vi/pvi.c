@@ -1,6 +1,5 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /*
    PVI: Perpendicular Vegetation Index
@@ -10,17 +9,22 @@
    to the soil line therefore a=1
 
  */
-double p_vi(double redchan, double nirchan, double soil_line_slope)
+void p_vi(const FCELL *redchan, const FCELL *nirchan, double soil_line_slope,
+          FCELL *result, int ncols)
 {
-    double result, a;
+    double sin_a = sin(soil_line_slope), cos_a = cos(soil_line_slope);
+    int col;
 
-    a = soil_line_slope;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+        result[col] = sin_a * nir - cos_a * red;
     }
-    else {
-        result = (sin(a) * nirchan) - (cos(a) * redchan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
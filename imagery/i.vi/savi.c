@@ -1,17 +1,22 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* Soil Adjusted Vegetation Index */
-double sa_vi(double redchan, double nirchan)
+void sa_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double result;
+    int col;
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = ((1 + 0.5) * (nir - red)) / (nir + red + 0.5);
     }
-    else {
-        result = ((1 + 0.5) * (nirchan - redchan)) / (nirchan + redchan + 0.5);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
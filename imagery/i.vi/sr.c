@@ -1,17 +1,22 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* Simple Vegetation ratio */
-double s_r(double redchan, double nirchan)
+void s_r(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+         int ncols)
 {
-    double result;
+    int col;
 
-    if ((redchan) == 0.0) {
-        result = -1.0;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = nir / red;
     }
-    else {
-        result = (nirchan / redchan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col];
+
+        result[col] = red == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -32,6 +32,7 @@ class TestReport(TestCase):
             type="raster",
             name="ipvi,ndwi,dvi,sr,evi,evi2,gari,gemi",
         )
+        cls.runModule("g.remove", flags="f", type="raster", pattern="vi_multi_*")
         cls.del_temp_region()
 
     def test_vinameipvi(self):
@@ -159,6 +160,73 @@ class TestReport(TestCase):
             msg="gemi in degrees must be between -221.69 and 0.97",
         )
 
+    def test_vinamevari(self):
+        """Testing viname vari against its formula"""
+        self.assertModule(
+            "i.vi",
+            blue=self.blue,
+            green=self.green,
+            red=self.red,
+            viname="vari",
+            output="vi_multi_vari",
+        )
+        # i.vi scales the digital numbers of CELL maps by 1 / (2^8 - 1)
+        # (storage_bit=8) to float bands, then computes in double
+        green, red, blue = (
+            f"double(float({band} * (1.0 / 255)))"
+            for band in (self.green, self.red, self.blue)
+        )
+        denominator = f"({green} + {red} - {blue})"
+        reference = f"float(({green} - {red}) / {denominator})"
+        # difference relative to the reference, absolute where it is below 1
+        self.runModule(
+            "r.mapcalc",
+            expression=f"vi_multi_vari_diff = if({denominator} == 0, null(), "
+            f"(vi_multi_vari - {reference}) / max(1, abs({reference})))",
+        )
+        self.assertRasterMinMax(
+            map="vi_multi_vari_diff",
+            refmin=-1e-6,
+            refmax=1e-6,
+            msg="vari must be (green - red) / (green + red - blue)",
+        )
+
+    def test_multiple_vinames(self):
+        """Testing several indices in one run against single runs"""
+        vinames = ["ndvi", "savi", "evi", "gemi"]
+        outputs = [f"vi_multi_{viname}" for viname in vinames]
+        self.assertModule(
+            "i.vi",
+            blue=self.blue,
+            red=self.red,
+            nir=self.nir,
+            viname=vinames,
+            output=outputs,
+            nprocs=4,
+        )
+        for viname, output in zip(vinames, outputs):
+            single = f"vi_multi_single_{viname}"
+            self.assertModule(
+                "i.vi",
+                blue=self.blue,
+                red=self.red,
+                nir=self.nir,
+                viname=viname,
+                output=single,
+                nprocs=1,
+            )
+            self.assertRastersNoDifference(actual=output, reference=single, precision=0)
+
+    def test_output_count(self):
+        """Testing that one output is required per index"""
+        self.assertModuleFail(
+            "i.vi",
+            red=self.red,
+            nir=self.nir,
+            viname="ndvi,dvi",
+            output="vi_multi_fail",
+        )
+
 
 if __name__ == "__main__":
     from grass.gunittest.main import test
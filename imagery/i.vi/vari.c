@@ -1,17 +1,22 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
-/*VARI: Visible Atmospherically Resistant Index */
-double va_ri(double redchan, double bluechan, double greenchan)
+/* VARI: Visible Atmospherically Resistant Index
+ * VARI is the Visible Atmospherically Resistant Index, it was
+ * designed to introduce an atmospheric self-correction
+ * Gitelson A.A., Kaufman Y.J., Stark R., Rundquist D., 2002.
+ * Novel algorithms for estimation of vegetation fraction
+ * Remote Sensing of Environment (80), pp76-87.  */
+void va_ri(const FCELL *redchan, const FCELL *greenchan,
+           const FCELL *bluechan, FCELL *result, int ncols)
 {
-    /* VARI is the Visible Atmospherically Resistant Index, it was
-     * designed to introduce an atmospheric self-correction
-     * Gitelson A.A., Kaufman Y.J., Stark R., Rundquist D., 2002.
-     * Novel algorithms for estimation of vegetation fraction
-     * Remote Sensing of Environment (80), pp76-87.  */
-    double result;
+    int col;
 
-    result = (greenchan - redchan) / (greenchan + redchan - bluechan);
-    return result;
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], green = greenchan[col];
+        double blue = bluechan[col];
+
+        result[col] = (green - red) / (green + red - blue);
+    }
 }
@@ -1,19 +1,23 @@
-#include <stdio.h>
 #include <math.h>
-#include <stdlib.h>
+#include <grass/gis.h>
 
 /* Weighted Difference Vegetation Index */
-double wd_vi(double redchan, double nirchan)
+void wd_vi(const FCELL *redchan, const FCELL *nirchan, FCELL *result,
+           int ncols)
 {
-    double result;
-
     double a = 1; /*slope of soil line */
+    int col;
+
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
 
-    if ((nirchan + redchan) == 0.0) {
-        result = -1.0;
+        result[col] = nir - a * red;
     }
-    else {
-        result = (nirchan - a * redchan);
+#pragma omp simd
+    for (col = 0; col < ncols; col++) {
+        double red = redchan[col], nir = nirchan[col];
+
+        result[col] = (nir + red) == 0.0 ? -1.0 : result[col];
     }
-    return result;
 }
@@ -27,6 +27,13 @@ struct Cluster {
     int merge1, merge2;
     int iteration;         /* number of iterations */
     double percent_stable; /* percentage stable */
+
+    int nprocs;     /* number of threads */
+    int batch_size; /* points reassigned per iteration, 0 for all */
+
+    double **stream_mean; /* centers of the previous streamed pass */
+    int stream_changes;   /* streamed points nearest to another center than
+                             in the previous pass, -1 in the first pass */
 };
 
 #include <grass/defs/cluster.h>
@@ -43,12 +43,16 @@
 #define DB_PROC_OPEN_UPDATE_CURSOR   207
 #define DB_PROC_UPDATE               208
 #define DB_PROC_ROWS                 209
+#define DB_PROC_FETCH_BATCH          210
 #define DB_PROC_BIND_UPDATE          220
 #define DB_PROC_BIND_INSERT          221
 
 #define DB_PROC_EXECUTE_IMMEDIATE    301
 #define DB_PROC_BEGIN_TRANSACTION    302
 #define DB_PROC_COMMIT_TRANSACTION   303
+#define DB_PROC_PREPARE              304
+#define DB_PROC_EXECUTE_PREPARED     305
+#define DB_PROC_CLOSE_PREPARED       306
 
 #define DB_PROC_CREATE_TABLE         401
 #define DB_PROC_DESCRIBE_TABLE       402
@@ -141,6 +145,12 @@
 /* static buffer for SQL statements */
 #define DB_SQL_MAX                   65536
 
+/* default number of rows transferred by one batch fetch */
+#define DB_FETCH_BATCH_SIZE          1000
+
+/* default number of rows sent by one bulk execution */
+#define DB_BULK_SIZE                 1000
+
 typedef void *dbAddress;
 typedef int dbToken;
 
@@ -273,6 +283,41 @@ typedef struct {
     dbCatVal *value;
 } dbCatValArray;
 
+/* batch of fetched rows stored by column */
+typedef struct {
+    int nrows;       /* number of rows in the batch */
+    int alloc;       /* number of allocated rows per column */
+    int ncols;       /* number of columns */
+    int *ctype;      /* C type of each column DB_C_TYPE_* */
+    dbValue **value; /* column values, value[col][row] */
+} dbBatch;
+
+/* attribute cache, rows of selected columns keyed by category */
+typedef struct {
+    int n_rows;      /* number of cached rows */
+    dbCatValI *rows; /* category/row index pairs sorted by category */
+    dbBatch batch;   /* cached values, column 0 is the key column */
+} dbAttrCache;
+
+/* prepared statement (driver side) */
+typedef struct {
+    dbString sql;   /* statement, parameters marked by '?' */
+    int nparams;    /* number of parameters */
+    int *ctype;     /* C type of each parameter DB_C_TYPE_* */
+    dbValue *value; /* parameter values of the row being executed */
+    void *data;     /* driver specific data, NULL if the statement is
+                       executed by substituting the values into sql */
+} dbPrepared;
+
+/* bulk execution of prepared statement (client side) */
+typedef struct {
+    dbDriver *driver;
+    dbToken token;  /* token of prepared statement in driver */
+    dbBatch params; /* pending rows of parameters, value[param][row] */
+    int n_ok;       /* number of successfully executed rows */
+    int n_failed;   /* number of rows which failed */
+} dbBulk;
+
 /* parameters of connection */
 typedef struct _db_connection {
     char *driverName;
@@ -47,6 +47,11 @@ double I_cluster_separation(struct Cluster *, int, int);
 /* c_sig.c */
 int I_cluster_signatures(struct Cluster *);
 
+/* c_stream.c */
+int I_cluster_stream_begin(struct Cluster *);
+int I_cluster_stream_points(struct Cluster *, DCELL **, int);
+int I_cluster_stream_end(struct Cluster *);
+
 /* c_sum2.c */
 int I_cluster_sum2(struct Cluster *);
 
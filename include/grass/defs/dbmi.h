@@ -4,6 +4,7 @@
 void db_Cstring_to_lowercase(char *);
 void db_Cstring_to_uppercase(char *);
 int db_add_column(dbDriver *, dbString *, dbColumn *);
+int db_add_bulk_row(dbBulk *);
 void db__add_cursor_to_driver_state(dbCursor *);
 int db_alloc_cursor_column_flags(dbCursor *);
 int db_alloc_cursor_table(dbCursor *, int);
@@ -14,6 +15,8 @@ dbIndex *db_alloc_index_array(int);
 int db_alloc_index_columns(dbIndex *, int);
 dbString *db_alloc_string_array(int);
 dbTable *db_alloc_table(int);
+int db_alloc_batch(dbBatch *, int, int);
+dbValue *db_attr_cache_get_value(dbAttrCache *, int, int);
 int db_append_string(dbString *, const char *);
 void db_auto_print_errors(int);
 void db_auto_print_protocol_errors(int);
@@ -33,6 +36,7 @@ void db_char_to_uppercase(char *);
 void db_clear_error(void);
 dbTable *db_clone_table(dbTable *);
 void db__close_all_cursors(void);
+int db_close_bulk(dbBulk *);
 int db_close_cursor(dbCursor *);
 int db_close_database(dbDriver *);
 int db_close_database_shutdown_driver(dbDriver *);
@@ -88,7 +92,11 @@ int db_describe_table(dbDriver *, dbString *, dbTable **);
 int db_d_execute_immediate(void);
 int db_d_begin_transaction(void);
 int db_d_commit_transaction(void);
+int db_d_prepare(void);
+int db_d_execute_prepared(void);
+int db_d_close_prepared(void);
 int db_d_fetch(void);
+int db_d_fetch_batch(void);
 int db_d_find_database(void);
 int db_d_get_num_rows(void);
 int db_d_grant_on_table(void);
@@ -106,6 +114,7 @@ int db_d_open_select_cursor(void);
 int db_d_open_update_cursor(void);
 void db_double_quote_string(dbString *);
 int db_driver(int, char **);
+int db_driver_local(int, char **);
 
 int db_driver_mkdir(const char *, int, int);
 int db_drop_column(dbDriver *, dbString *, dbString *);
@@ -118,9 +127,11 @@ int db_d_version(void);
 int db_enlarge_string(dbString *, int);
 void db_error(const char *);
 int db_execute_immediate(dbDriver *, dbString *);
+int db_execute_bulk(dbBulk *);
 int db_begin_transaction(dbDriver *);
 int db_commit_transaction(dbDriver *);
 int db_fetch(dbCursor *, int, int *);
+int db_fetch_batch(dbCursor *, int, dbBatch *, int *);
 int db_find_database(dbDriver *, dbHandle *, int *);
 dbAddress db_find_token(dbToken);
 void db_free(void *);
@@ -136,6 +147,8 @@ void db_free_index_array(dbIndex *, int);
 void db_free_string(dbString *);
 void db_free_string_array(dbString *, int);
 void db_free_table(dbTable *);
+void db_free_attr_cache(dbAttrCache *);
+void db_free_batch(dbBatch *);
 int db_get_column(dbDriver *, const char *, const char *, dbColumn **);
 dbValue *db_get_column_default_value(dbColumn *);
 const char *db_get_column_description(dbColumn *);
@@ -147,6 +160,8 @@ int db_get_column_scale(dbColumn *);
 int db_get_column_select_priv(dbColumn *);
 int db_get_column_sqltype(dbColumn *);
 int db_get_column_update_priv(dbColumn *);
+dbValue *db_get_batch_value(dbBatch *, int, int);
+dbValue *db_get_bulk_param(dbBulk *, int);
 dbValue *db_get_column_value(dbColumn *);
 int db_get_connection(dbConnection *);
 int db_get_cursor_number_of_columns(dbCursor *);
@@ -190,6 +205,7 @@ const char *db_get_value_string(dbValue *);
 int db_get_value_year(dbValue *);
 int db_grant_on_table(dbDriver *, const char *, int, int);
 int db_has_dbms(void);
+void db_init_batch(dbBatch *);
 void db_init_column(dbColumn *);
 void db_init_cursor(dbCursor *);
 void db__init_driver_state(void);
@@ -208,6 +224,7 @@ int db_list_tables(dbDriver *, dbString **, int *, int);
 void *db_malloc(int);
 void db__mark_database_closed(void);
 void db__mark_database_open(const char *, const char *);
+int db__local_driver_active(void);
 void db_memory_error(void);
 dbToken db_new_token(dbAddress);
 int db_nocase_compare(const char *, const char *);
@@ -217,6 +234,7 @@ int db_open_insert_cursor(dbDriver *, dbCursor *);
 int db_open_select_cursor(dbDriver *, dbString *, dbCursor *, int);
 int db_open_update_cursor(dbDriver *, dbString *_name, dbString *, dbCursor *,
                           int);
+int db_prepare_bulk(dbDriver *, dbString *, int, const int *, dbBulk *);
 void db_print_column_definition(FILE *, dbColumn *);
 void db_print_error(void);
 void db_print_index(FILE *, dbIndex *);
@@ -279,6 +297,8 @@ int db__send_value(dbValue *, int);
 int db_select_CatValArray(dbDriver *, const char *, const char *, const char *,
                           const char *, dbCatValArray *);
 int db_select_int(dbDriver *, const char *, const char *, const char *, int **);
+int db_select_attr_cache(dbDriver *, const char *, const char *, const char *,
+                         const char *, dbAttrCache *);
 int db_select_value(dbDriver *, const char *, const char *, int, const char *,
                     dbValue *);
 int db_set_column_description(dbColumn *, const char *);
@@ -318,6 +338,7 @@ int db_set_index_table_name(dbIndex *, const char *);
 int db_set_index_type_non_unique(dbIndex *);
 int db_set_index_type_unique(dbIndex *);
 void db__set_protocol_fds(FILE *, FILE *);
+int db__set_local_driver(int (*)(void));
 int db_set_string(dbString *, const char *);
 int db_set_string_no_copy(dbString *, char *);
 int db_set_table_column(dbTable *, int, dbColumn *);
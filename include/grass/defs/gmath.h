@@ -21,6 +21,16 @@ void G_free_imatrix(int **);
 extern int fft(int, double *[2], int, int, int);
 extern int fft2(int, double (*)[2], int, int, int);
 
+/* fft2d.c */
+struct G_math_fft2d *G_math_fft2d_create(int, int, int, int);
+void G_math_fft2d_destroy(struct G_math_fft2d *);
+void G_math_fft2d_forward_rows(struct G_math_fft2d *, int, int,
+                               const double *);
+void G_math_fft2d_inverse_rows(struct G_math_fft2d *, int, int, double *);
+void G_math_fft2d_columns(struct G_math_fft2d *, int);
+void G_math_fft2d_put_rows(struct G_math_fft2d *, int, int, double (*)[2]);
+void G_math_fft2d_get_rows(struct G_math_fft2d *, int, int, double (*)[2]);
+
 /* gauss.c */
 extern double G_math_rand_gauss(double);
 
@@ -4,6 +4,8 @@
 /* do_proj.c */
 int GPJ_init_transform(const struct pj_info *, const struct pj_info *,
                        struct pj_info *);
+struct pj_info *GPJ_copy_transform(const struct pj_info *);
+void GPJ_free_transform_copy(struct pj_info *);
 int GPJ_transform(const struct pj_info *, const struct pj_info *,
                   const struct pj_info *, int, double *, double *, double *);
 int GPJ_transform_array(const struct pj_info *, const struct pj_info *,
@@ -13,6 +13,15 @@ int I_free_double2(double **);
 double ***I_alloc_double3(int, int, int);
 int I_free_double3(double ***);
 
+/* discriminant.c */
+void I_init_discriminant(struct I_discriminant *, int, int);
+void I_set_discriminant(struct I_discriminant *, int, double, const double *,
+                        double **, int);
+void I_free_discriminant(struct I_discriminant *);
+double *I_alloc_discriminant_work(const struct I_discriminant *);
+void I_discriminant_batch(const struct I_discriminant *, DCELL *const *, int,
+                          double *, double *);
+
 /* eol.c */
 int I_get_to_eol(char *, int, FILE *);
 
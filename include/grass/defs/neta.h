@@ -35,7 +35,7 @@ void NetA_degree_centrality(dglGraph_s *graph, double *degree);
 int NetA_eigenvector_centrality(dglGraph_s *graph, int iterations, double error,
                                 double *eigenvector);
 int NetA_betweenness_closeness(dglGraph_s *graph, double *betweenness,
-                               double *closeness);
+                               double *closeness, int nprocs);
 
 /*path.c */
 int NetA_distance_from_points(dglGraph_s *graph, struct ilist *from, int *dst,
@@ -45,6 +45,10 @@ int NetA_distance_to_points(dglGraph_s *graph, struct ilist *to, int *dst,
 int NetA_find_path(dglGraph_s *graph, int from, int to, int *edges,
                    struct ilist *list);
 
+/*matrix.c */
+int NetA_distance_matrix(dglGraph_s *graph, int nnodes, struct ilist *from,
+                         dglInt32_t **dst, dglInt32_t ***prev, int nprocs);
+
 /*timetables.c */
 
 /*Structure containing all information about a timetable.
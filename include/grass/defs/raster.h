@@ -37,6 +37,13 @@ int Rast__check_for_auto_masking(void);
 void Rast_suppress_masking(void);
 void Rast_unsuppress_masking(void);
 
+/* block_cache.c */
+struct R_block_cache *Rast_open_block_cache(int, int);
+void Rast_close_block_cache(struct R_block_cache *);
+void Rast_get_block_cache_d_window(struct R_block_cache *, int, int, int, int,
+                                   DCELL *);
+DCELL Rast_get_block_cache_d_value(struct R_block_cache *, int, int);
+
 /* cats.c */
 int Rast_read_cats(const char *, const char *, struct Categories *);
 int Rast_read_vector_cats(const char *, const char *, struct Categories *);
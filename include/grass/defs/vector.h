@@ -412,6 +412,11 @@ int Vect_net_shortest_path(struct Map_info *, int, int, struct ilist *,
                            double *);
 int Vect_net_ttb_shortest_path(struct Map_info *, int, int, int, int, int,
                                struct ilist *, double *);
+int Vect_net_build_ch(struct Map_info *);
+void Vect_net_free_ch(struct Map_info *);
+int Vect_net_build_csr(struct Map_info *, int, int, int, const char *,
+                       const char *, const char *, int);
+void Vect_net_free_csr(struct Map_info *);
 dglGraph_s *Vect_net_get_graph(struct Map_info *);
 int Vect_net_get_line_cost(struct Map_info *, int, int, double *);
 int Vect_net_get_node_cost(struct Map_info *, int, double *);
@@ -57,6 +57,11 @@ typedef struct {
     unsigned int *index; /*the index number */
 } G_math_spvector;
 
+/*!
+ * \brief Two-dimensional FFT of real data by rows and columns
+ * */
+struct G_math_fft2d;
+
 #include <grass/defs/gmath.h>
 
 #endif /* GRASS_GMATH_H */
@@ -99,6 +99,16 @@ struct SigSet {
     struct ClassSig *ClassSig;
 };
 
+/*! Gaussian discriminant functions of classes, see I_discriminant_batch() */
+struct I_discriminant {
+    int nbands;   /* band count */
+    int n;        /* function (class) count */
+    int ncoef;    /* coefficients per function */
+    double *cnst; /* constant term of each function [n] */
+    double *mean; /* means [n][nbands] */
+    double *coef; /* inverse covariance [n][ncoef]: diagonal, then i < j */
+};
+
 /* IClass */
 
 /*! Holds statistical values for creating histograms and raster maps for one
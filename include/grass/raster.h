@@ -243,6 +243,7 @@ struct FP_stats {
 
 struct GDAL_link;
 struct R_vrt;
+struct R_block_cache;
 
 /*** prototypes ***/
 #include <grass/defs/raster.h>
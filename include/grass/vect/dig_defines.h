@@ -24,6 +24,10 @@
 #define GV_CIDX_ELEMENT        "cidx"
 /*! \brief External format (OGR), feature index */
 #define GV_FIDX_ELEMENT        "fidx"
+/*! \brief Network graph, contraction hierarchy */
+#define GV_CH_ELEMENT          "ch"
+/*! \brief Network graph, compressed sparse row graph */
+#define GV_CSR_ELEMENT         "csr"
 /*! \brief Color table */
 #define GV_COLR_ELEMENT        "colr"
 /*! \brief Name of directory for alternative color tables */
@@ -1232,6 +1232,23 @@ struct Graph_info {
        \brief Edge and node costs multiplicator
      */
     int cost_multip;
+    /*!
+       \brief Contraction hierarchy (see Vect_net_build_ch())
+     */
+    dglCHIndex_s *ch;
+    /*!
+       \brief Workspace of shortest path queries on contraction hierarchy
+     */
+    dglCHQuery_s *ch_query;
+    /*!
+       \brief Compressed sparse row graph (see Vect_net_build_csr())
+     */
+    dglCSRGraph_s *csr;
+    /*!
+       \brief Workspace of shortest path queries on compressed sparse row
+       graph
+     */
+    dglCSRQuery_s *csr_query;
 };
 
 /*! \brief
@@ -0,0 +1,517 @@
+/*!
+ * \file kdflat.c
+ *
+ * \brief Static k-d tree in flat arrays
+ *
+ * The tree is built at once from an array of points by median splits.
+ * Items are stored in tree order: the node of the range [lo, hi) of the
+ * arrays is at mid = lo + (hi - lo) / 2, items in [lo, mid) are not
+ * larger in the split dimension, items in [mid + 1, hi) are not smaller.
+ * There are no links to children, nodes of a subtree are next to each
+ * other in memory. The tree can not be modified, all queries are
+ * thread-safe.
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include "kdtree.h"
+
+/* ranges with more items are built by separate tasks */
+#define KD_TASK_SIZE 16384
+/* queries of a batch handed to a thread at once */
+#define KD_CHUNK     256
+/* the tree depth is below 64, one range per level is on the stack */
+#define KD_STACK     128
+
+struct kdbuild {
+    const double *c;    /* input coordinates */
+    int ndims;          /* number of dimensions */
+    size_t *idx;        /* input items in tree order */
+    unsigned char *dim; /* split dimensions */
+};
+
+/* range of the tree to be searched and its squared distance to the query */
+struct kdrange {
+    size_t lo, hi;
+    double dist;
+};
+
+#define KEY(b, j, dim) ((b)->c[(b)->idx[j] * (b)->ndims + (dim)])
+
+/* split dimension with the largest extent of the range */
+static int split_dim(const struct kdbuild *b, size_t lo, size_t hi)
+{
+    int i, dim = 0;
+    size_t j;
+    double v, min, max, extent = -1.;
+
+    for (i = 0; i < b->ndims; i++) {
+        min = max = KEY(b, lo, i);
+        for (j = lo + 1; j < hi; j++) {
+            v = KEY(b, j, i);
+            if (min > v)
+                min = v;
+            else if (max < v)
+                max = v;
+        }
+        if (extent < max - min) {
+            extent = max - min;
+            dim = i;
+        }
+    }
+
+    return dim;
+}
+
+static void swap_idx(struct kdbuild *b, ptrdiff_t i, ptrdiff_t j)
+{
+    size_t tmp = b->idx[i];
+
+    b->idx[i] = b->idx[j];
+    b->idx[j] = tmp;
+}
+
+/* move the item k of [lo, hi) in dimension dim to position k, smaller
+ * items to the left, larger items to the right (Hoare's selection) */
+static void select_item(struct kdbuild *b, size_t lo, size_t hi, size_t k,
+                        int dim)
+{
+    ptrdiff_t l = lo, r = hi - 1, i, j, m;
+    double pivot;
+
+    while (l < r) {
+        /* median of three */
+        m = l + (r - l) / 2;
+        if (KEY(b, m, dim) < KEY(b, l, dim))
+            swap_idx(b, m, l);
+        if (KEY(b, r, dim) < KEY(b, l, dim))
+            swap_idx(b, r, l);
+        if (KEY(b, r, dim) < KEY(b, m, dim))
+            swap_idx(b, r, m);
+        pivot = KEY(b, m, dim);
+
+        i = l;
+        j = r;
+        while (i <= j) {
+            while (KEY(b, i, dim) < pivot)
+                i++;
+            while (KEY(b, j, dim) > pivot)
+                j--;
+            if (i <= j) {
+                swap_idx(b, i, j);
+                i++;
+                j--;
+            }
+        }
+        /* items in (j, i) are equal to the pivot */
+        if ((ptrdiff_t)k <= j)
+            r = j;
+        else if ((ptrdiff_t)k >= i)
+            l = i;
+        else
+            break;
+    }
+}
+
+static void build(struct kdbuild *b, size_t lo, size_t hi)
+{
+    size_t mid;
+    int dim;
+
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        dim = split_dim(b, lo, hi);
+        select_item(b, lo, hi, mid, dim);
+        b->dim[mid] = dim;
+
+        if (hi - lo > KD_TASK_SIZE) {
+#pragma omp task firstprivate(lo, mid)
+            build(b, lo, mid);
+        }
+        else
+            build(b, lo, mid);
+        lo = mid + 1;
+    }
+}
+
+/*!
+ * \brief Build a static k-d tree from an array of points
+ *
+ * Subtrees of large ranges are built in parallel by nprocs threads.
+ *
+ * \param ndims number of dimensions
+ * \param c coordinates of the points, ndims values per point
+ * \param uid unique ids of the points, NULL to use the index of a point
+ * \param n number of points
+ * \param nprocs number of threads
+ *
+ * \return new k-d tree, to be freed with kdflat_destroy()
+ */
+struct kdflat *kdflat_build(char ndims, const double *c, const int *uid,
+                            size_t n, int nprocs)
+{
+    struct kdflat *t;
+    struct kdbuild b;
+    size_t i;
+
+    if (ndims < 1)
+        G_fatal_error(_("Invalid number of dimensions %d for k-d tree"),
+                      (int)ndims);
+
+    t = G_malloc(sizeof(struct kdflat));
+    t->ndims = ndims;
+    t->count = n;
+    t->c = G_malloc((n ? n : 1) * ndims * sizeof(double));
+    t->uid = G_malloc((n ? n : 1) * sizeof(int));
+    t->dim = G_calloc(n ? n : 1, sizeof(unsigned char));
+
+    b.c = c;
+    b.ndims = ndims;
+    b.idx = G_malloc((n ? n : 1) * sizeof(size_t));
+    b.dim = t->dim;
+    for (i = 0; i < n; i++)
+        b.idx[i] = i;
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1 && n > KD_TASK_SIZE)
+    {
+#pragma omp single
+        build(&b, 0, n);
+    }
+
+    for (i = 0; i < n; i++) {
+        memcpy(t->c + i * ndims, c + b.idx[i] * ndims, ndims * sizeof(double));
+        t->uid[i] = uid ? uid[b.idx[i]] : (int)b.idx[i];
+    }
+    G_free(b.idx);
+
+    return t;
+}
+
+/*!
+ * \brief Destroy a static k-d tree
+ */
+void kdflat_destroy(struct kdflat *t)
+{
+    G_free(t->c);
+    G_free(t->uid);
+    G_free(t->dim);
+    G_free(t);
+}
+
+/* squared distance of item i to c, stops early beyond maxdist */
+static double item_dist(const struct kdflat *t, size_t i, const double *c,
+                        double maxdist)
+{
+    const double *p = t->c + i * t->ndims;
+    double diff, dist = 0.;
+    int j;
+
+    for (j = 0; j < t->ndims && dist <= maxdist; j++) {
+        diff = c[j] - p[j];
+        dist += diff * diff;
+    }
+
+    return dist;
+}
+
+/*!
+ * \brief Find k nearest neighbors
+ *
+ * Results are stored in uid and d (squared distances) sorted by distance.
+ * Optionally a unique id to be skipped can be given, useful when searching
+ * for the nearest neighbors of an item that is also in the tree.
+ *
+ * \return number of neighbors found
+ */
+int kdflat_knn(const struct kdflat *t, const double *c, int *uid, double *d,
+               int k, const int *skip)
+{
+    struct kdrange s[KD_STACK];
+    size_t lo, hi, mid;
+    int i, top, found = 0, dim;
+    double diff, dist, maxdist = INFINITY;
+
+    if (k < 1 || t->count == 0)
+        return 0;
+
+    s[0].lo = 0;
+    s[0].hi = t->count;
+    s[0].dist = 0.;
+    top = 1;
+    while (top) {
+        top--;
+        if (s[top].dist > maxdist)
+            continue;
+        lo = s[top].lo;
+        hi = s[top].hi;
+
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+
+            if (!skip || t->uid[mid] != *skip) {
+                dist = item_dist(t, mid, c, maxdist);
+                if (found < k || dist < maxdist) {
+                    i = found < k ? found++ : k - 1;
+                    while (i > 0 && d[i - 1] > dist) {
+                        d[i] = d[i - 1];
+                        uid[i] = uid[i - 1];
+                        i--;
+                    }
+                    d[i] = dist;
+                    uid[i] = t->uid[mid];
+                    if (found == k) {
+                        maxdist = d[k - 1];
+                        if (maxdist == 0.)
+                            return found;
+                    }
+                }
+            }
+
+            /* go down the near side, the other side is searched later */
+            dim = t->dim[mid];
+            diff = c[dim] - t->c[mid * t->ndims + dim];
+            if (diff < 0) {
+                s[top].lo = mid + 1;
+                s[top].hi = hi;
+                hi = mid;
+            }
+            else {
+                s[top].lo = lo;
+                s[top].hi = mid;
+                lo = mid + 1;
+            }
+            s[top].dist = diff * diff;
+            if (s[top].lo < s[top].hi && s[top].dist <= maxdist)
+                top++;
+        }
+    }
+
+    return found;
+}
+
+/*!
+ * \brief Initialize scratch space for radius searches
+ *
+ * A scratch space must not be used by more than one thread at the same
+ * time, it is reused by subsequent searches.
+ */
+void kdscratch_init(struct kdscratch *s)
+{
+    s->uid = NULL;
+    s->d = NULL;
+    s->n = 0;
+    s->alloc = 0;
+}
+
+/*!
+ * \brief Free scratch space for radius searches
+ */
+void kdscratch_free(struct kdscratch *s)
+{
+    G_free(s->uid);
+    G_free(s->d);
+    kdscratch_init(s);
+}
+
+/* append the items within maxdist of c to s, returns number appended */
+static size_t dnn(const struct kdflat *t, const double *c, double maxdist,
+                  const int *skip, struct kdscratch *s)
+{
+    size_t s_lo[KD_STACK], lo, hi, mid, n0 = s->n;
+    size_t s_hi[KD_STACK];
+    int top, dim;
+    double diff, dist, maxdistsq = maxdist * maxdist;
+
+    if (t->count == 0)
+        return 0;
+
+    s_lo[0] = 0;
+    s_hi[0] = t->count;
+    top = 1;
+    while (top) {
+        top--;
+        lo = s_lo[top];
+        hi = s_hi[top];
+
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+
+            if (!skip || t->uid[mid] != *skip) {
+                dist = item_dist(t, mid, c, maxdistsq);
+                if (dist <= maxdistsq) {
+                    if (s->n == s->alloc) {
+                        s->alloc = s->alloc ? 2 * s->alloc : 64;
+                        s->uid = G_realloc(s->uid, s->alloc * sizeof(int));
+                        s->d = G_realloc(s->d, s->alloc * sizeof(double));
+                    }
+                    s->uid[s->n] = t->uid[mid];
+                    s->d[s->n] = dist;
+                    s->n++;
+                }
+            }
+
+            dim = t->dim[mid];
+            diff = c[dim] - t->c[mid * t->ndims + dim];
+            if (diff < 0) {
+                if (-diff <= maxdist && mid + 1 < hi) {
+                    s_lo[top] = mid + 1;
+                    s_hi[top++] = hi;
+                }
+                hi = mid;
+            }
+            else {
+                if (diff <= maxdist && lo < mid) {
+                    s_lo[top] = lo;
+                    s_hi[top++] = mid;
+                }
+                lo = mid + 1;
+            }
+        }
+    }
+
+    return s->n - n0;
+}
+
+/*!
+ * \brief Find all neighbors within distance aka radius search
+ *
+ * Results are stored in s->uid and s->d (squared distances) in no
+ * particular order, the scratch space is reused by the next search.
+ * Optionally a unique id to be skipped can be given.
+ *
+ * \return number of neighbors found
+ */
+int kdflat_dnn(const struct kdflat *t, const double *c, double maxdist,
+               const int *skip, struct kdscratch *s)
+{
+    s->n = 0;
+
+    return (int)dnn(t, c, maxdist, skip, s);
+}
+
+/*!
+ * \brief Find k nearest neighbors of many points in parallel
+ *
+ * The neighbors of query point i are stored in uid[i * k] and d[i * k]
+ * as with kdflat_knn(), their number in found[i].
+ *
+ * \param c coordinates of n query points
+ * \param skip unique ids to skip, one per query point, or NULL
+ * \param nprocs number of threads
+ */
+void kdflat_knn_batch(const struct kdflat *t, const double *c, size_t n,
+                      int k, const int *skip, int *uid, double *d, int *found,
+                      int nprocs)
+{
+    size_t i;
+
+#pragma omp parallel for schedule(dynamic, KD_CHUNK) num_threads(nprocs) \
+    if (nprocs > 1 && n > KD_CHUNK)
+    for (i = 0; i < n; i++)
+        found[i] = kdflat_knn(t, c + i * t->ndims, uid + i * k, d + i * k, k,
+                              skip ? &skip[i] : NULL);
+}
+
+/*!
+ * \brief Find all neighbors within distance of many points in parallel
+ *
+ * Each thread collects the neighbors in its own scratch space, the
+ * results are then copied in the order of the query points: the
+ * neighbors of query point i are in [first[i], first[i + 1]) of *puid
+ * and *pd (squared distances), in no particular order.
+ * The calling fn must free *puid and *pd.
+ *
+ * \param c coordinates of n query points
+ * \param skip unique ids to skip, one per query point, or NULL
+ * \param first n + 1 offsets of the results of the query points
+ * \param pd squared distances, NULL if not needed
+ * \param nprocs number of threads
+ *
+ * \return total number of neighbors found
+ */
+size_t kdflat_dnn_batch(const struct kdflat *t, const double *c, size_t n,
+                        double maxdist, const int *skip, size_t *first,
+                        int **puid, double **pd, int nprocs)
+{
+    struct kdscratch *s;
+    size_t nchunks, ch, *offset, total;
+    int *thread, th;
+
+    if (nprocs < 1)
+        nprocs = 1;
+    nchunks = (n + KD_CHUNK - 1) / KD_CHUNK;
+    if ((size_t)nprocs > nchunks)
+        nprocs = nchunks > 0 ? nchunks : 1;
+
+    s = G_malloc(nprocs * sizeof(struct kdscratch));
+    for (th = 0; th < nprocs; th++)
+        kdscratch_init(&s[th]);
+    thread = G_malloc((nchunks ? nchunks : 1) * sizeof(int));
+    offset = G_malloc((nchunks ? nchunks : 1) * sizeof(size_t));
+
+    first[0] = 0;
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1) private(ch, th)
+    {
+        struct kdscratch *ts;
+        size_t i, end;
+
+#if defined(_OPENMP)
+        th = omp_get_thread_num();
+#else
+        th = 0;
+#endif
+        ts = &s[th];
+
+#pragma omp for schedule(dynamic)
+        for (ch = 0; ch < nchunks; ch++) {
+            thread[ch] = th;
+            offset[ch] = ts->n;
+            end = (ch + 1) * KD_CHUNK < n ? (ch + 1) * KD_CHUNK : n;
+            for (i = ch * KD_CHUNK; i < end; i++)
+                first[i + 1] = dnn(t, c + i * t->ndims, maxdist,
+                                   skip ? &skip[i] : NULL, ts);
+        }
+    }
+
+    for (ch = 0; ch < n; ch++)
+        first[ch + 1] += first[ch];
+    total = first[n];
+
+    *puid = G_malloc((total ? total : 1) * sizeof(int));
+    if (pd)
+        *pd = G_malloc((total ? total : 1) * sizeof(double));
+    for (ch = 0; ch < nchunks; ch++) {
+        size_t start = first[ch * KD_CHUNK];
+        size_t count = first[(ch + 1) * KD_CHUNK < n ? (ch + 1) * KD_CHUNK
+                                                      : n] -
+                       start;
+
+        if (count == 0)
+            continue;
+        memcpy(*puid + start, s[thread[ch]].uid + offset[ch],
+               count * sizeof(int));
+        if (pd)
+            memcpy(*pd + start, s[thread[ch]].d + offset[ch],
+                   count * sizeof(double));
+    }
+
+    for (th = 0; th < nprocs; th++)
+        kdscratch_free(&s[th]);
+    G_free(s);
+    G_free(thread);
+    G_free(offset);
+
+    return total;
+}
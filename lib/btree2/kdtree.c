@@ -698,7 +698,7 @@ int kdtree_dnn(struct kdtree *t, double *c, int **puid, double **pd,
 
                 if (dist <= maxdistsq) {
                     if (found + 1 >= k) {
-                        k = found + 10;
+                        k = found + 10 + found / 2;
                         uid = G_realloc(uid, k * sizeof(int));
                         d = G_realloc(d, k * sizeof(double));
                     }
@@ -807,7 +807,7 @@ int kdtree_rnn(struct kdtree *t, double *c, int **puid, int *skip)
 
                 if (inside) {
                     if (found + 1 >= k) {
-                        k = found + 10;
+                        k = found + 10 + found / 2;
                         uid = G_realloc(uid, k * sizeof(int));
                     }
                     i = found;
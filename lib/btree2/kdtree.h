@@ -179,3 +179,100 @@ int kdtree_init_trav(struct kdtrav *trav, struct kdtree *tree);
  * returns 1, 0 when finished
  */
 int kdtree_traverse(struct kdtrav *trav, double *c, int *uid);
+
+/*!
+ * \brief Static k-d tree
+ *
+ * Built at once from an array of points by median splits, items are
+ * stored in flat arrays in tree order. Queries are thread-safe.
+ */
+struct kdflat {
+    unsigned char ndims; /*!< number of dimensions */
+    size_t count;        /*!< number of items in the tree */
+    double *c;           /*!< coordinates, ndims values per item */
+    int *uid;            /*!< unique ids of the items */
+    unsigned char *dim;  /*!< split dimensions of the items */
+};
+
+/*!
+ * \brief Scratch space for radius searches of a static k-d tree
+ *
+ * One per thread, reused by subsequent searches
+ */
+struct kdscratch {
+    int *uid;     /*!< unique ids of the neighbors */
+    double *d;    /*!< squared distances to the neighbors */
+    size_t n;     /*!< number of neighbors */
+    size_t alloc; /*!< allocated number of neighbors */
+};
+
+/*! build a static k-d tree from n points with coordinates c
+ * uid may be NULL to use the index of a point as uid
+ * large trees are built in parallel by nprocs threads */
+struct kdflat *kdflat_build(char ndims,      /*!< number of dimensions */
+                            const double *c, /*!< coordinates */
+                            const int *uid,  /*!< unique ids or NULL */
+                            size_t n,        /*!< number of points */
+                            int nprocs       /*!< number of threads */
+);
+
+/*! destroy a static k-d tree */
+void kdflat_destroy(struct kdflat *t);
+
+/*! find k nearest neighbors, see kdtree_knn() */
+int kdflat_knn(const struct kdflat *t, /*!< static k-d tree */
+               const double *c,        /*!< coordinates */
+               int *uid,               /*!< unique ids of the neighbors */
+               double *d,              /*!< squared distances */
+               int k,                  /*!< number of neighbors to find */
+               const int *skip         /*!< unique id to skip */
+);
+
+/*! initialize scratch space for radius searches */
+void kdscratch_init(struct kdscratch *s);
+
+/*! free scratch space for radius searches */
+void kdscratch_free(struct kdscratch *s);
+
+/*! find all nearest neighbors within distance aka radius search
+ * results are stored in s->uid and s->d (squared distances)
+ * in no particular order, the scratch space is reused by the next search
+ * optionally an uid to be skipped can be given */
+int kdflat_dnn(
+    const struct kdflat *t, /*!< static k-d tree */
+    const double *c,        /*!< coordinates */
+    double maxdist,         /*!< radius to search around the coordinates */
+    const int *skip,        /*!< unique id to skip */
+    struct kdscratch *s     /*!< scratch space of the calling thread */
+);
+
+/*! find k nearest neighbors of n points in parallel
+ * results of point i are stored in uid[i * k] and d[i * k],
+ * their number in found[i] */
+void kdflat_knn_batch(
+    const struct kdflat *t, /*!< static k-d tree */
+    const double *c,        /*!< coordinates of the points */
+    size_t n,               /*!< number of points */
+    int k,                  /*!< number of neighbors to find */
+    const int *skip,        /*!< unique ids to skip, one per point, or NULL */
+    int *uid,               /*!< unique ids of the neighbors */
+    double *d,              /*!< squared distances to the neighbors */
+    int *found,             /*!< number of neighbors found */
+    int nprocs              /*!< number of threads */
+);
+
+/*! find all nearest neighbors within distance of n points in parallel
+ * results of point i are in [first[i], first[i + 1]) of *puid and *pd
+ * memory is allocated as needed, the calling fn must free the memory
+ * returns the total number of neighbors */
+size_t kdflat_dnn_batch(
+    const struct kdflat *t, /*!< static k-d tree */
+    const double *c,        /*!< coordinates of the points */
+    size_t n,               /*!< number of points */
+    double maxdist,         /*!< radius to search around the points */
+    const int *skip,        /*!< unique ids to skip, one per point, or NULL */
+    size_t *first,          /*!< n + 1 offsets of the results */
+    int **puid,             /*!< unique ids of the neighbors */
+    double **pd,            /*!< squared distances or NULL */
+    int nprocs              /*!< number of threads */
+);
@@ -0,0 +1,400 @@
+/*****************************************************************************
+ *
+ * MODULE:       Grass btree2 Library
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Unit tests and benchmark of the static k-d tree
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/kdtree.h>
+
+/*- Parameters and global variables -----------------------------------------*/
+typedef struct {
+    struct Option *unit, *npoints, *ndims, *k, *nprocs;
+    struct Flag *testunit, *bench;
+} paramType;
+
+paramType param; /*Parameters */
+
+/*- prototypes --------------------------------------------------------------*/
+static void set_params(void); /*Fill the paramType structure */
+
+/* ************************************************************************* */
+/* Set up the arguments we are expecting ********************************** */
+
+/* ************************************************************************* */
+void set_params(void)
+{
+    param.unit = G_define_option();
+    param.unit->key = "unit";
+    param.unit->type = TYPE_STRING;
+    param.unit->required = NO;
+    param.unit->multiple = YES;
+    param.unit->options = "knn,dnn";
+    param.unit->description = "Choose the unit tests to run";
+
+    param.npoints = G_define_option();
+    param.npoints->key = "npoints";
+    param.npoints->type = TYPE_INTEGER;
+    param.npoints->required = NO;
+    param.npoints->answer = "1000000";
+    param.npoints->description = "The number of points for the benchmark";
+
+    param.ndims = G_define_option();
+    param.ndims->key = "ndims";
+    param.ndims->type = TYPE_INTEGER;
+    param.ndims->required = NO;
+    param.ndims->answer = "2";
+    param.ndims->options = "1-255";
+    param.ndims->description = "The number of dimensions";
+
+    param.k = G_define_option();
+    param.k->key = "k";
+    param.k->type = TYPE_INTEGER;
+    param.k->required = NO;
+    param.k->answer = "8";
+    param.k->description = "The number of nearest neighbors to find";
+
+    param.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
+    param.testunit = G_define_flag();
+    param.testunit->key = 'u';
+    param.testunit->description = "Run all unit tests";
+
+    param.bench = G_define_flag();
+    param.bench->key = 'b';
+    param.bench->description =
+        "Benchmark the static k-d tree against the dynamic k-d tree";
+}
+
+static double compute_time_difference(struct timeval start,
+                                      struct timeval end)
+{
+    return (double)(end.tv_sec - start.tv_sec) +
+           (double)(end.tv_usec - start.tv_usec) / 1000000;
+}
+
+/* random points on a coarse grid, i.e. with duplicate coordinates */
+static double *random_points(size_t n, int ndims, double step)
+{
+    double *c = G_malloc(n * ndims * sizeof(double));
+    size_t i;
+
+    for (i = 0; i < n * ndims; i++) {
+        c[i] = G_drand48() * 100.;
+        if (step > 0)
+            c[i] = floor(c[i] / step) * step;
+    }
+
+    return c;
+}
+
+static double sq_dist(const double *a, const double *b, int ndims)
+{
+    double diff, dist = 0.;
+    int i;
+
+    for (i = 0; i < ndims; i++) {
+        diff = a[i] - b[i];
+        dist += diff * diff;
+    }
+
+    return dist;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
+
+/* ************************************************************************* */
+/* k nearest neighbors are compared with a brute force search ************** */
+/* ************************************************************************* */
+static int unit_test_knn(int ndims, int k, int nprocs)
+{
+    int sum = 0, j, *uid, *found, *skip;
+    size_t i, q, n = 5000, nq = 500;
+    double *c, *d, *all, step;
+    struct kdflat *t;
+
+    G_message(_("\n++ Running static k-d tree knn unit test ++"));
+
+    for (step = 0; step < 2; step++) {
+        c = random_points(n, ndims, step * 5.);
+        t = kdflat_build(ndims, c, NULL, n, nprocs);
+
+        uid = G_malloc(nq * k * sizeof(int));
+        d = G_malloc(nq * k * sizeof(double));
+        found = G_malloc(nq * sizeof(int));
+        skip = G_malloc(nq * sizeof(int));
+        all = G_malloc(n * sizeof(double));
+
+        /* query the first points, skipping themselves */
+        for (q = 0; q < nq; q++)
+            skip[q] = q;
+        kdflat_knn_batch(t, c, nq, k, skip, uid, d, found, nprocs);
+
+        for (q = 0; q < nq; q++) {
+            for (i = 0; i < n; i++)
+                all[i] = i == q ? INFINITY : sq_dist(c + q * ndims,
+                                                     c + i * ndims, ndims);
+            qsort(all, n, sizeof(double), cmp_double);
+
+            if (found[q] != k) {
+                G_warning("Error: found %d of %d neighbors", found[q], k);
+                sum++;
+                continue;
+            }
+            for (j = 0; j < k; j++) {
+                if (d[q * k + j] != all[j] ||
+                    d[q * k + j] != sq_dist(c + q * ndims,
+                                            c + (size_t)uid[q * k + j] * ndims,
+                                            ndims) ||
+                    uid[q * k + j] == (int)q) {
+                    G_warning("Error: neighbor %d of point %lu", j,
+                              (unsigned long)q);
+                    sum++;
+                    break;
+                }
+            }
+        }
+
+        G_free(uid);
+        G_free(d);
+        G_free(found);
+        G_free(skip);
+        G_free(all);
+        G_free(c);
+        kdflat_destroy(t);
+    }
+
+    if (sum > 0)
+        G_warning(_("\n-- Static k-d tree knn unit test failure --"));
+    else
+        G_message(_("\n-- Static k-d tree knn unit test finished successfully "
+                    "--"));
+
+    return sum;
+}
+
+/* ************************************************************************* */
+/* neighbors within distance are compared with a brute force search ******** */
+/* ************************************************************************* */
+static int unit_test_dnn(int ndims, int nprocs)
+{
+    int sum = 0, *uid;
+    size_t i, j, q, count, n = 5000, nq = 500, *first;
+    double *c, *d, maxdist = 10., dist, step;
+    struct kdflat *t;
+    struct kdscratch s;
+
+    G_message(_("\n++ Running static k-d tree dnn unit test ++"));
+
+    kdscratch_init(&s);
+    for (step = 0; step < 2; step++) {
+        c = random_points(n, ndims, step * 5.);
+        t = kdflat_build(ndims, c, NULL, n, nprocs);
+        first = G_malloc((nq + 1) * sizeof(size_t));
+
+        kdflat_dnn_batch(t, c, nq, maxdist, NULL, first, &uid, &d, nprocs);
+
+        for (q = 0; q < nq; q++) {
+            count = 0;
+            for (i = 0; i < n; i++) {
+                if (sq_dist(c + q * ndims, c + i * ndims, ndims) <=
+                    maxdist * maxdist)
+                    count++;
+            }
+            if (count != first[q + 1] - first[q] ||
+                (int)count != kdflat_dnn(t, c + q * ndims, maxdist, NULL, &s)) {
+                G_warning("Error: found %lu of %lu neighbors of point %lu",
+                          (unsigned long)(first[q + 1] - first[q]),
+                          (unsigned long)count, (unsigned long)q);
+                sum++;
+                continue;
+            }
+            for (j = first[q]; j < first[q + 1]; j++) {
+                dist = sq_dist(c + q * ndims, c + (size_t)uid[j] * ndims,
+                               ndims);
+                if (d[j] != dist || dist > maxdist * maxdist) {
+                    G_warning("Error: neighbor %d of point %lu", uid[j],
+                              (unsigned long)q);
+                    sum++;
+                    break;
+                }
+            }
+        }
+
+        G_free(uid);
+        G_free(d);
+        G_free(first);
+        G_free(c);
+        kdflat_destroy(t);
+    }
+    kdscratch_free(&s);
+
+    if (sum > 0)
+        G_warning(_("\n-- Static k-d tree dnn unit test failure --"));
+    else
+        G_message(_("\n-- Static k-d tree dnn unit test finished successfully "
+                    "--"));
+
+    return sum;
+}
+
+/* ************************************************************************* */
+/* static k-d tree against incremental build of the dynamic k-d tree ******* */
+/* ************************************************************************* */
+static void bench_kdtree(size_t n, int ndims, int k, int nprocs)
+{
+    struct timeval tstart, tend;
+    struct kdtree *kdt;
+    struct kdflat *t;
+    double *c, *d;
+    int *uid, *found;
+    size_t i;
+
+    G_message(_("\n++ Running k-d tree benchmark ++"));
+
+    c = random_points(n, ndims, 0);
+    uid = G_malloc(n * k * sizeof(int));
+    d = G_malloc(n * k * sizeof(double));
+    found = G_malloc(n * sizeof(int));
+
+    gettimeofday(&tstart, NULL);
+    kdt = kdtree_create(ndims, NULL);
+    for (i = 0; i < n; i++)
+        kdtree_insert(kdt, c + i * ndims, i, 1);
+    kdtree_optimize(kdt, 2);
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdtree_insert + kdtree_optimize: %g\n",
+           compute_time_difference(tstart, tend));
+
+    gettimeofday(&tstart, NULL);
+    for (i = 0; i < n; i++) {
+        int skip = i;
+
+        found[i] = kdtree_knn(kdt, c + i * ndims, uid + i * k, d + i * k, k,
+                              &skip);
+    }
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdtree_knn: %g\n",
+           compute_time_difference(tstart, tend));
+    kdtree_destroy(kdt);
+
+    gettimeofday(&tstart, NULL);
+    t = kdflat_build(ndims, c, NULL, n, 1);
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdflat_build: %g\n",
+           compute_time_difference(tstart, tend));
+    kdflat_destroy(t);
+
+    gettimeofday(&tstart, NULL);
+    t = kdflat_build(ndims, c, NULL, n, nprocs);
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdflat_build with %d threads: %g\n", nprocs,
+           compute_time_difference(tstart, tend));
+
+    gettimeofday(&tstart, NULL);
+    for (i = 0; i < n; i++) {
+        int skip = i;
+
+        found[i] = kdflat_knn(t, c + i * ndims, uid + i * k, d + i * k, k,
+                              &skip);
+    }
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdflat_knn: %g\n",
+           compute_time_difference(tstart, tend));
+
+    gettimeofday(&tstart, NULL);
+    kdflat_knn_batch(t, c, n, k, NULL, uid, d, found, nprocs);
+    gettimeofday(&tend, NULL);
+    printf("Computation time kdflat_knn_batch with %d threads: %g\n", nprocs,
+           compute_time_difference(tstart, tend));
+
+    kdflat_destroy(t);
+    G_free(c);
+    G_free(uid);
+    G_free(d);
+    G_free(found);
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/* ************************************************************************* */
+int main(int argc, char *argv[])
+{
+    struct GModule *module;
+    int returnstat = 0, i, ndims, k, nprocs;
+    size_t npoints;
+
+    /* Initialize GRASS */
+    G_gisinit(argv[0]);
+
+    module = G_define_module();
+    G_add_keyword(_("btree2"));
+    G_add_keyword(_("unit test"));
+    G_add_keyword(_("benchmark"));
+    module->description =
+        "Performs unit tests and benchmarks for the k-d tree library";
+
+    /* Get parameters from user */
+    set_params();
+
+    if (G_parser(argc, argv))
+        exit(EXIT_FAILURE);
+
+    nprocs = G_set_omp_num_threads(param.nprocs);
+    npoints = strtoul(param.npoints->answer, NULL, 10);
+    ndims = atoi(param.ndims->answer);
+    k = atoi(param.k->answer);
+    if (k < 1)
+        G_fatal_error(_("Option %s must be a positive number"), param.k->key);
+
+    G_srand48(1);
+
+    /*Run the unit tests */
+    if (param.testunit->answer) {
+        returnstat += unit_test_knn(ndims, k, nprocs);
+        returnstat += unit_test_dnn(ndims, nprocs);
+    }
+
+    /*Run single tests */
+    if (!param.testunit->answer) {
+        i = 0;
+        if (param.unit->answers)
+            while (param.unit->answers[i]) {
+                if (strcmp(param.unit->answers[i], "knn") == 0)
+                    returnstat += unit_test_knn(ndims, k, nprocs);
+                if (strcmp(param.unit->answers[i], "dnn") == 0)
+                    returnstat += unit_test_dnn(ndims, nprocs);
+                i++;
+            }
+    }
+
+    if (param.bench->answer)
+        bench_kdtree(npoints, ndims, k, nprocs);
+
+    if (returnstat != 0)
+        G_warning("Errors detected while testing the k-d tree library");
+    else
+        G_message("\n-- k-d tree library tests finished successfully --");
+
+    return (returnstat);
+}
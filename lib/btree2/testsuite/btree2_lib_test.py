@@ -0,0 +1,22 @@
+"""Test of the static k-d tree of the btree2 library"""
+
+from grass.gunittest.case import TestCase
+
+
+class KdtreeLibraryTest(TestCase):
+    def test_knn(self):
+        self.assertModule("test.btree2.lib", unit="knn")
+        self.assertModule("test.btree2.lib", unit="knn", ndims=3, k=1)
+
+    def test_dnn(self):
+        self.assertModule("test.btree2.lib", unit="dnn")
+        self.assertModule("test.btree2.lib", unit="dnn", ndims=1)
+
+    def test_threads(self):
+        self.assertModule("test.btree2.lib", flags="u", nprocs=4)
+
+
+if __name__ == "__main__":
+    from grass.gunittest.main import test
+
+    test()
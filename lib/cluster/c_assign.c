@@ -13,6 +13,7 @@
 
 #include <math.h>
 #include <grass/cluster.h>
+#include "local_proto.h"
 
 /*!
    \brief Assign cluster
@@ -25,37 +26,62 @@
  */
 int I_cluster_assign(struct Cluster *C, int *interrupted)
 {
-    int p, c;
-    int class, band;
-    double d, q;
-    double dmin;
+    int b, c, band;
+    size_t nsums = (size_t)C->nbands * C->nclasses;
+    int *count;  /* count of each block, count[block][class] */
+    double *sum; /* sums of each block, sum[block][band][class] */
 
     G_debug(3, "I_cluster_assign(npoints=%d,nclasses=%d,nbands=%d)", C->npoints,
             C->nclasses, C->nbands);
 
-    for (p = 0; p < C->npoints; p++) {
-        if (*interrupted)
-            return -1;
-
-        dmin = HUGE_VAL;
-        class = 0;
-        for (c = 0; c < C->nclasses; c++) {
-            d = 0.0;
-            for (band = 0; band < C->nbands; band++) {
-                q = C->points[band][p];
-                q -= C->mean[band][c];
-                d += q * q;
-            }
-            if (c == 0 || d < dmin) {
-                class = c;
-                dmin = d;
+    count = G_calloc((size_t)NBLOCKS * C->nclasses, sizeof(int));
+    sum = G_calloc(NBLOCKS * nsums, sizeof(double));
+
+#pragma omp parallel for num_threads(C->nprocs) if (C->nprocs > 1) \
+    schedule(dynamic) private(c, band)
+    for (b = 0; b < NBLOCKS; b++) {
+        int p, class;
+        double d, q, dmin;
+        int *bcount = count + (size_t)b * C->nclasses;
+        double *bsum = sum + b * nsums;
+
+        for (p = BLOCK_START(b, C->npoints);
+             p < BLOCK_START(b + 1, C->npoints); p++) {
+            if (*interrupted)
+                break;
+
+            dmin = HUGE_VAL;
+            class = 0;
+            for (c = 0; c < C->nclasses; c++) {
+                d = 0.0;
+                for (band = 0; band < C->nbands; band++) {
+                    q = C->points[band][p];
+                    q -= C->mean[band][c];
+                    d += q * q;
+                }
+                if (c == 0 || d < dmin) {
+                    class = c;
+                    dmin = d;
+                }
             }
+            C->class[p] = class;
+            bcount[class]++;
+            for (band = 0; band < C->nbands; band++)
+                bsum[band * C->nclasses + class] += C->points[band][p];
         }
-        C->class[p] = class;
-        C->count[class]++;
-        for (band = 0; band < C->nbands; band++)
-            C->sum[band][class] += C->points[band][p];
     }
 
-    return 0;
+    if (!*interrupted) {
+        for (b = 0; b < NBLOCKS; b++)
+            for (c = 0; c < C->nclasses; c++) {
+                C->count[c] += count[(size_t)b * C->nclasses + c];
+                for (band = 0; band < C->nbands; band++)
+                    C->sum[band][c] += sum[b * nsums + band * C->nclasses + c];
+            }
+    }
+
+    G_free(count);
+    G_free(sum);
+
+    return *interrupted ? -1 : 0;
 }
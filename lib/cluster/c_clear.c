@@ -33,7 +33,11 @@ int I_cluster_clear(struct Cluster *C)
     C->sumdiff = NULL;
     C->sum2 = NULL;
     C->mean = NULL;
+    C->stream_mean = NULL;
+    C->stream_changes = -1;
     C->nbands = 0;
+    C->nprocs = 1;
+    C->batch_size = 0;
     I_init_signatures(&C->S, 0);
 
     return 0;
@@ -13,6 +13,7 @@
 
 #include <grass/cluster.h>
 #include <grass/glocale.h>
+#include "local_proto.h"
 
 /*!
    \param C pointer to Cluster structure
@@ -34,6 +35,8 @@ int I_cluster_exec(struct Cluster *C, int maxclass, int iterations,
                    int (*checkpoint)(struct Cluster *, int), int *interrupted)
 {
     int changes;
+    int n, first, step;
+    int cycle_points = 0, cycle_changes = 0;
 
     /* set interrupted to false */
     *interrupted = 0;
@@ -93,9 +96,16 @@ int I_cluster_exec(struct Cluster *C, int maxclass, int iterations,
         if (*interrupted)
             return -2;
 
-        /* if too many points have changed class, re-assign points */
-        C->percent_stable = (C->npoints - changes) * 100.0;
-        C->percent_stable /= (double)C->npoints;
+        /* if too many points have changed class, re-assign points,
+         * with mini-batches count the changes of all batches of a cycle
+         * through the points */
+        n = I__cluster_batch(C, &first, &step);
+        if (first == 0)
+            cycle_points = cycle_changes = 0;
+        cycle_points += n;
+        cycle_changes += changes;
+        C->percent_stable = (cycle_points - cycle_changes) * 100.0;
+        C->percent_stable /= (double)cycle_points;
 
         if (checkpoint)
             (*checkpoint)(C, 3);
@@ -103,7 +113,7 @@ int I_cluster_exec(struct Cluster *C, int maxclass, int iterations,
         if (C->iteration >= iterations)
             break;
 
-        if (C->percent_stable < convergence)
+        if (first < step - 1 || C->percent_stable < convergence)
             continue;
 
         /* otherwise merge non-distinct classes */
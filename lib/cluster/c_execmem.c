@@ -60,6 +60,7 @@ int I_cluster_exec_free(struct Cluster *C)
     I_free_double2(C->sum);
     I_free_double2(C->sumdiff);
     I_free_double2(C->mean);
+    I_free_double2(C->stream_mean);
 
     C->class = NULL;
     C->count = NULL;
@@ -68,6 +69,7 @@ int I_cluster_exec_free(struct Cluster *C)
     C->sumdiff = NULL;
     C->sum2 = NULL;
     C->mean = NULL;
+    C->stream_mean = NULL;
 
     return 0;
 }
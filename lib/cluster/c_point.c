@@ -138,14 +138,18 @@ static int extend(struct Cluster *C, int n)
 {
     int band;
 
-    while ((C->npoints + n) > C->np) {
-        C->np += 128;
-        for (band = 0; band < C->nbands; band++) {
-            C->points[band] =
-                (DCELL *)I_realloc(C->points[band], C->np * sizeof(DCELL));
-            if (C->points[band] == NULL)
-                return 0;
-        }
+    if ((C->npoints + n) <= C->np)
+        return 1;
+
+    /* grow by half of the size, adding a constant number of points would
+     * copy the arrays too often for large samples */
+    while ((C->npoints + n) > C->np)
+        C->np += C->np / 2 + 128;
+    for (band = 0; band < C->nbands; band++) {
+        C->points[band] = (DCELL *)I_realloc(C->points[band],
+                                             (size_t)C->np * sizeof(DCELL));
+        if (C->points[band] == NULL)
+            return 0;
     }
     return 1;
 }
@@ -13,9 +13,27 @@
 
 #include <math.h>
 #include <grass/cluster.h>
+#include "local_proto.h"
+
+/* points reassigned in the current iteration, all points or a mini-batch
+ * of every step-th point: first, first + step, ... */
+int I__cluster_batch(const struct Cluster *C, int *first, int *step)
+{
+    int nbatches = 1;
+
+    if (C->batch_size > 0 && C->batch_size < C->npoints)
+        nbatches = (C->npoints + C->batch_size - 1) / C->batch_size;
+    *step = nbatches;
+    *first = C->iteration > 0 ? (C->iteration - 1) % nbatches : 0;
+
+    return (C->npoints - *first + nbatches - 1) / nbatches;
+}
 
 /*!
-   \brief ?
+   \brief Reassign points to the nearest class
+
+   With a batch size (mini-batch), only a part of the points is reassigned,
+   the other points are reassigned in the following iterations.
 
    \param C pointer to Cluster structure
    \param interrupted
@@ -24,13 +42,14 @@
  */
 int I_cluster_reassign(struct Cluster *C, int *interrupted)
 {
-    double min, d, z;
-    double q;
-    int c, np;
-    int old;
-    int p, band, class;
+    int c, b;
+    int band;
+    int n, first, step;
     int changes;
-    int first;
+    size_t nsums = (size_t)C->nbands * C->nclasses;
+    int *countdiff;  /* change in count of each block */
+    double *sumdiff; /* change in sums of each block */
+    int nchanges[NBLOCKS];
 
     changes = 0;
     for (c = 0; c < C->nclasses; c++) {
@@ -39,49 +58,83 @@ int I_cluster_reassign(struct Cluster *C, int *interrupted)
             C->sumdiff[band][c] = 0;
     }
 
-    min = HUGE_VAL;
-    class = 0;
-    for (p = 0; p < C->npoints; p++) {
-        if (*interrupted)
-            return 0;
-        if (C->class[p] < 0) /* point to be ignored */
-            continue;
-
-        /* find minimum distance to center of all classes */
-        first = 1;
-        for (c = 0; c < C->nclasses; c++) {
-            d = 0;
-            np = C->count[c];
-            if (np == 0)
+    n = I__cluster_batch(C, &first, &step);
+    countdiff = G_calloc((size_t)NBLOCKS * C->nclasses, sizeof(int));
+    sumdiff = G_calloc(NBLOCKS * nsums, sizeof(double));
+
+#pragma omp parallel for num_threads(C->nprocs) if (C->nprocs > 1) \
+    schedule(dynamic) private(c, band)
+    for (b = 0; b < NBLOCKS; b++) {
+        double min, d, z;
+        double q;
+        int i, p, np;
+        int old, class;
+        int first_class;
+        int *bcountdiff = countdiff + (size_t)b * C->nclasses;
+        double *bsumdiff = sumdiff + b * nsums;
+
+        nchanges[b] = 0;
+        min = HUGE_VAL;
+        class = 0;
+        for (i = BLOCK_START(b, n); i < BLOCK_START(b + 1, n); i++) {
+            if (*interrupted)
+                break;
+            p = first + i * step;
+            if (C->class[p] < 0) /* point to be ignored */
                 continue;
-            for (band = 0; band < C->nbands; band++) {
-                z = C->points[band][p] * np - C->sum[band][c];
-                d += z * z;
-            }
-            d /= (np * np);
 
-            if (first || (d < min)) {
-                class = c;
-                min = d;
-                first = 0;
+            /* find minimum distance to center of all classes */
+            first_class = 1;
+            for (c = 0; c < C->nclasses; c++) {
+                d = 0;
+                np = C->count[c];
+                if (np == 0)
+                    continue;
+                for (band = 0; band < C->nbands; band++) {
+                    z = C->points[band][p] * np - C->sum[band][c];
+                    d += z * z;
+                }
+                d /= ((double)np * np);
+
+                if (first_class || (d < min)) {
+                    class = c;
+                    min = d;
+                    first_class = 0;
+                }
             }
-        }
 
-        if (C->class[p] != class) {
-            old = C->class[p];
-            C->class[p] = class;
-            changes++;
+            if (C->class[p] != class) {
+                old = C->class[p];
+                C->class[p] = class;
+                nchanges[b]++;
+
+                bcountdiff[class]++;
+                bcountdiff[old]--;
 
-            C->countdiff[class]++;
-            C->countdiff[old]--;
+                for (band = 0; band < C->nbands; band++) {
+                    q = C->points[band][p];
+                    bsumdiff[band * C->nclasses + class] += q;
+                    bsumdiff[band * C->nclasses + old] -= q;
+                }
+            }
+        }
+    }
 
-            for (band = 0; band < C->nbands; band++) {
-                q = C->points[band][p];
-                C->sumdiff[band][class] += q;
-                C->sumdiff[band][old] -= q;
+    if (!*interrupted) {
+        for (b = 0; b < NBLOCKS; b++) {
+            changes += nchanges[b];
+            for (c = 0; c < C->nclasses; c++) {
+                C->countdiff[c] += countdiff[(size_t)b * C->nclasses + c];
+                for (band = 0; band < C->nbands; band++)
+                    C->sumdiff[band][c] +=
+                        sumdiff[b * nsums + band * C->nclasses + c];
             }
         }
     }
+    G_free(countdiff);
+    G_free(sumdiff);
+    if (*interrupted)
+        return 0;
 
     if (changes) {
         for (c = 0; c < C->nclasses; c++) {
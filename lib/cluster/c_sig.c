@@ -12,6 +12,7 @@
  */
 
 #include <grass/cluster.h>
+#include "local_proto.h"
 
 /*!
    \brief Create signatures
@@ -22,11 +23,11 @@
  */
 int I_cluster_signatures(struct Cluster *C)
 {
-    int c, p, band1, band2;
+    int c, b, band1, band2;
     int n;
-    double m1, m2;
-    double p1, p2;
     double dn;
+    size_t nvar = (size_t)C->nclasses * C->nbands * C->nbands;
+    double *var; /* sums of each block, var[block][class][band1][band2] */
 
     /*
        fprintf (stderr, "c_sig: 1\n");
@@ -38,28 +39,52 @@ int I_cluster_signatures(struct Cluster *C)
         I_new_signature(&C->S);
     }
 
-    for (p = 0; p < C->npoints; p++) {
-        c = C->class[p];
-        if (c < 0)
-            continue;
-        /*
-           if (c >= C->nclasses)
-           fprintf (stderr, " class[%d]=%d ** illegal **\n", p, c);
-         */
-        dn = n = C->count[c];
-        if (n < 2)
-            continue;
-        for (band1 = 0; band1 < C->nbands; band1++) {
-            m1 = C->sum[band1][c] / dn;
-            p1 = C->points[band1][p];
-            for (band2 = 0; band2 <= band1; band2++) {
-                m2 = C->sum[band2][c] / dn;
-                p2 = C->points[band2][p];
-                C->S.sig[c].var[band1][band2] += (p1 - m1) * (p2 - m2);
+    var = G_calloc(NBLOCKS * nvar, sizeof(double));
+
+#pragma omp parallel for num_threads(C->nprocs) if (C->nprocs > 1) \
+    schedule(dynamic) private(c, band1, band2)
+    for (b = 0; b < NBLOCKS; b++) {
+        int p;
+        double m1, m2;
+        double p1, p2;
+        double *bvar;
+
+        for (p = BLOCK_START(b, C->npoints);
+             p < BLOCK_START(b + 1, C->npoints); p++) {
+            c = C->class[p];
+            if (c < 0)
+                continue;
+            /*
+               if (c >= C->nclasses)
+               fprintf (stderr, " class[%d]=%d ** illegal **\n", p, c);
+             */
+            if (C->count[c] < 2)
+                continue;
+            bvar = var + b * nvar + (size_t)c * C->nbands * C->nbands;
+            for (band1 = 0; band1 < C->nbands; band1++) {
+                m1 = C->sum[band1][c] / C->count[c];
+                p1 = C->points[band1][p];
+                for (band2 = 0; band2 <= band1; band2++) {
+                    m2 = C->sum[band2][c] / C->count[c];
+                    p2 = C->points[band2][p];
+                    bvar[band1 * C->nbands + band2] += (p1 - m1) * (p2 - m2);
+                }
             }
         }
     }
 
+    for (c = 0; c < C->nclasses; c++)
+        for (b = 0; b < NBLOCKS; b++) {
+            const double *bvar =
+                var + b * nvar + (size_t)c * C->nbands * C->nbands;
+
+            for (band1 = 0; band1 < C->nbands; band1++)
+                for (band2 = 0; band2 <= band1; band2++)
+                    C->S.sig[c].var[band1][band2] +=
+                        bvar[band1 * C->nbands + band2];
+        }
+    G_free(var);
+
     for (c = 0; c < C->nclasses; c++) {
         dn = n = C->S.sig[c].npoints = C->count[c];
         if (n == 0)
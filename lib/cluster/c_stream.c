@@ -0,0 +1,229 @@
+/*!
+   \file cluster/c_stream.c
+
+   \brief Cluster library - Signatures of streamed points
+
+   The points are not kept in memory, e.g. all cells of an image can be read
+   row by row and assigned to the nearest class of a clustering result.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2). Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <math.h>
+#include <grass/cluster.h>
+#include "local_proto.h"
+
+/* minimum number of points of a block */
+#define BLOCK_POINTS 1024
+
+/*!
+   \brief Begin to compute signatures from streamed points
+
+   The class means of the signatures computed by I_cluster_exec() or by
+   the previous streamed pass are the centers the points are assigned to.
+   From the second pass on, the centers of the previous pass are kept to
+   count the points which changed their class in
+   <tt>C->stream_changes</tt>.
+
+   \param C pointer to Cluster structure
+
+   \return 0
+ */
+int I_cluster_stream_begin(struct Cluster *C)
+{
+    int c, band1, band2;
+
+    if (C->stream_mean == NULL) {
+        C->stream_mean = I_alloc_double2(C->nbands, C->nclasses);
+        C->stream_changes = -1;
+    }
+    else {
+        for (band1 = 0; band1 < C->nbands; band1++)
+            for (c = 0; c < C->nclasses; c++)
+                C->stream_mean[band1][c] = C->mean[band1][c];
+        C->stream_changes = 0;
+    }
+
+    for (c = 0; c < C->nclasses; c++) {
+        C->count[c] = 0;
+        for (band1 = 0; band1 < C->nbands; band1++) {
+            C->mean[band1][c] = C->S.sig[c].mean[band1];
+            C->sum[band1][c] = 0;
+            for (band2 = 0; band2 <= band1; band2++)
+                C->S.sig[c].var[band1][band2] = 0;
+        }
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Assign points to the nearest class
+
+   Points with NULL values in any band are skipped. Sums over the points
+   relative to the class means are added to the count, the sums and the
+   covariance matrices of the classes. From the second pass on, the points
+   nearest to another center than in the previous pass are added to
+   <tt>C->stream_changes</tt>.
+
+   \param C pointer to Cluster structure
+   \param x values of the points, x[band][point]
+   \param n number of points
+
+   \return number of points assigned
+ */
+int I_cluster_stream_points(struct Cluster *C, DCELL **x, int n)
+{
+    int b, c, band1, band2, nblocks, total;
+    int nbands = C->nbands;
+    size_t nstats = (size_t)C->nclasses * (nbands + nbands * nbands);
+    int *count;    /* count of each block, count[block][class] */
+    int *changes;  /* points of each block which changed their class */
+    double *stats; /* sums of each block, [block][class][band + band^2] */
+
+    nblocks = (n + BLOCK_POINTS - 1) / BLOCK_POINTS;
+    if (nblocks > NBLOCKS)
+        nblocks = NBLOCKS;
+    if (nblocks < 1)
+        return 0;
+
+    count = G_calloc((size_t)nblocks * C->nclasses, sizeof(int));
+    changes = G_calloc(nblocks, sizeof(int));
+    stats = G_calloc(nblocks * nstats, sizeof(double));
+
+#pragma omp parallel for num_threads(C->nprocs) if (C->nprocs > 1) \
+    schedule(dynamic) private(c, band1, band2)
+    for (b = 0; b < nblocks; b++) {
+        int p, class, previous;
+        double d, q, dmin;
+        double *s, *v;
+
+        for (p = (int)((long long)b * n / nblocks);
+             p < (int)((long long)(b + 1) * n / nblocks); p++) {
+            for (band1 = 0; band1 < nbands; band1++)
+                if (Rast_is_d_null_value(&x[band1][p]))
+                    break;
+            if (band1 < nbands)
+                continue;
+
+            dmin = HUGE_VAL;
+            class = 0;
+            for (c = 0; c < C->nclasses; c++) {
+                d = 0.0;
+                for (band1 = 0; band1 < nbands; band1++) {
+                    q = x[band1][p] - C->mean[band1][c];
+                    d += q * q;
+                }
+                if (c == 0 || d < dmin) {
+                    class = c;
+                    dmin = d;
+                }
+            }
+
+            if (C->stream_changes >= 0) {
+                previous = 0;
+                for (c = 0; c < C->nclasses; c++) {
+                    d = 0.0;
+                    for (band1 = 0; band1 < nbands; band1++) {
+                        q = x[band1][p] - C->stream_mean[band1][c];
+                        d += q * q;
+                    }
+                    if (c == 0 || d < dmin) {
+                        previous = c;
+                        dmin = d;
+                    }
+                }
+                if (previous != class)
+                    changes[b]++;
+            }
+
+            count[(size_t)b * C->nclasses + class]++;
+            s = stats + b * nstats +
+                (size_t)class * (nbands + nbands * nbands);
+            v = s + nbands;
+            for (band1 = 0; band1 < nbands; band1++) {
+                q = x[band1][p] - C->mean[band1][class];
+                s[band1] += q;
+                for (band2 = 0; band2 <= band1; band2++)
+                    v[band1 * nbands + band2] +=
+                        q * (x[band2][p] - C->mean[band2][class]);
+            }
+        }
+    }
+
+    total = 0;
+    for (c = 0; c < C->nclasses; c++)
+        for (b = 0; b < nblocks; b++) {
+            const double *s =
+                stats + b * nstats + (size_t)c * (nbands + nbands * nbands);
+            const double *v = s + nbands;
+
+            C->count[c] += count[(size_t)b * C->nclasses + c];
+            total += count[(size_t)b * C->nclasses + c];
+            for (band1 = 0; band1 < nbands; band1++) {
+                C->sum[band1][c] += s[band1];
+                for (band2 = 0; band2 <= band1; band2++)
+                    C->S.sig[c].var[band1][band2] += v[band1 * nbands + band2];
+            }
+        }
+
+    if (C->stream_changes >= 0)
+        for (b = 0; b < nblocks; b++)
+            C->stream_changes += changes[b];
+
+    G_free(count);
+    G_free(changes);
+    G_free(stats);
+
+    return total;
+}
+
+/*!
+   \brief Compute the signatures of the streamed points
+
+   The signatures and the count, sums and sums of squares of the classes
+   are replaced by those of the streamed points.
+
+   \param C pointer to Cluster structure
+
+   \return 0
+ */
+int I_cluster_stream_end(struct Cluster *C)
+{
+    int c, band1, band2, n;
+    double m, *s;
+    struct One_Sig *sig;
+
+    s = G_malloc(C->nbands * sizeof(double));
+
+    for (c = 0; c < C->nclasses; c++) {
+        sig = &C->S.sig[c];
+        n = sig->npoints = C->count[c];
+        sig->status = 0;
+
+        /* sums were taken relative to the centers */
+        for (band1 = 0; band1 < C->nbands; band1++) {
+            m = C->mean[band1][c];
+            s[band1] = C->sum[band1][c];
+            C->sum[band1][c] = n * m + s[band1];
+            C->sum2[band1][c] =
+                sig->var[band1][band1] + 2 * m * s[band1] + n * m * m;
+            sig->mean[band1] = n > 0 ? m + s[band1] / n : m;
+        }
+        if (n < 2)
+            continue;
+        for (band1 = 0; band1 < C->nbands; band1++)
+            for (band2 = 0; band2 <= band1; band2++)
+                sig->var[band1][band2] =
+                    (sig->var[band1][band2] - s[band1] * s[band2] / n) /
+                    (n - 1);
+        sig->status = 1;
+    }
+
+    G_free(s);
+
+    return 0;
+}
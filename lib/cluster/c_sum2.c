@@ -12,6 +12,7 @@
  */
 
 #include <grass/cluster.h>
+#include "local_proto.h"
 
 /*!
    \brief Compute sum of squares for each class
@@ -22,25 +23,43 @@
  */
 int I_cluster_sum2(struct Cluster *C)
 {
-    int p, band, class;
-    double q;
+    int b, band, class;
+    size_t nsums = (size_t)C->nbands * C->nclasses;
+    double *sum2; /* sums of each block, sum2[block][band][class] */
 
     G_debug(3, "I_cluster_sum2(npoints=%d,nclasses=%d,nbands=%d)", C->npoints,
             C->nclasses, C->nbands);
 
-    for (class = 0; class < C->nclasses; class ++)
-        for (band = 0; band < C->nbands; band++)
-            C->sum2[band][class] = 0;
+    sum2 = G_calloc(NBLOCKS * nsums, sizeof(double));
 
-    for (p = 0; p < C->npoints; p++) {
-        class = C->class[p];
-        if (class < 0)
-            continue;
-        for (band = 0; band < C->nbands; band++) {
-            q = C->points[band][p];
-            C->sum2[band][class] += q * q;
+#pragma omp parallel for num_threads(C->nprocs) if (C->nprocs > 1) \
+    schedule(dynamic) private(band, class)
+    for (b = 0; b < NBLOCKS; b++) {
+        int p;
+        double q;
+        double *bsum2 = sum2 + b * nsums;
+
+        for (p = BLOCK_START(b, C->npoints);
+             p < BLOCK_START(b + 1, C->npoints); p++) {
+            class = C->class[p];
+            if (class < 0)
+                continue;
+            for (band = 0; band < C->nbands; band++) {
+                q = C->points[band][p];
+                bsum2[band * C->nclasses + class] += q * q;
+            }
         }
     }
 
+    for (class = 0; class < C->nclasses; class ++)
+        for (band = 0; band < C->nbands; band++) {
+            C->sum2[band][class] = 0;
+            for (b = 0; b < NBLOCKS; b++)
+                C->sum2[band][class] +=
+                    sum2[b * nsums + band * C->nclasses + class];
+        }
+
+    G_free(sum2);
+
     return 0;
 }
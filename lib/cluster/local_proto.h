@@ -0,0 +1,17 @@
+#ifndef GRASS_CLUSTER_LOCAL_PROTO_H
+#define GRASS_CLUSTER_LOCAL_PROTO_H
+
+#include <grass/cluster.h>
+
+/* The points are divided into NBLOCKS blocks processed in parallel, the
+ * partial sums of the blocks are added in order, so that the results do not
+ * depend on the number of threads. */
+#define NBLOCKS 64
+
+/* first point of block b of n points */
+#define BLOCK_START(b, n) ((int)((long long)(b) * (n) / NBLOCKS))
+
+/* c_reassign.c */
+int I__cluster_batch(const struct Cluster *, int *, int *);
+
+#endif
@@ -0,0 +1,108 @@
+/*!
+   \file lib/db/dbmi_base/batch.c
+
+   \brief DBMI Library (base) - batch of fetched rows
+
+   Rows fetched by db_fetch_batch() are stored by column, i.e. all
+   values of one column are contiguous in memory.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2). Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <grass/gis.h>
+#include <grass/dbmi.h>
+#include <grass/glocale.h>
+
+/*!
+   \brief Initialize dbBatch
+
+   \param batch pointer to dbBatch to be initialized
+ */
+void db_init_batch(dbBatch *batch)
+{
+    G_zero(batch, sizeof(dbBatch));
+}
+
+/*!
+   \brief Allocate (or enlarge) dbBatch
+
+   Existing values are preserved, newly allocated values are
+   initialized to zero.
+
+   \param batch pointer to dbBatch
+   \param ncols number of columns
+   \param nrows number of rows
+
+   \return DB_OK on success
+   \return DB_FAILED if the number of columns differs from the one
+   already allocated
+ */
+int db_alloc_batch(dbBatch *batch, int ncols, int nrows)
+{
+    int col;
+
+    if (batch->value && batch->ncols != ncols) {
+        db_error(_("Batch has wrong number of columns"));
+        return DB_FAILED;
+    }
+
+    if (!batch->value) {
+        batch->ncols = ncols;
+        batch->ctype = (int *)G_calloc(ncols, sizeof(int));
+        batch->value = (dbValue **)G_calloc(ncols, sizeof(dbValue *));
+    }
+
+    if (nrows <= batch->alloc)
+        return DB_OK;
+
+    for (col = 0; col < ncols; col++) {
+        batch->value[col] = (dbValue *)G_realloc(batch->value[col],
+                                                 nrows * sizeof(dbValue));
+        G_zero(batch->value[col] + batch->alloc,
+               (nrows - batch->alloc) * sizeof(dbValue));
+    }
+    batch->alloc = nrows;
+
+    return DB_OK;
+}
+
+/*!
+   \brief Free allocated dbBatch
+
+   \param batch pointer to dbBatch
+ */
+void db_free_batch(dbBatch *batch)
+{
+    int col, row;
+
+    for (col = 0; col < batch->ncols; col++) {
+        for (row = 0; row < batch->alloc; row++)
+            db_free_string(&batch->value[col][row].s);
+        G_free(batch->value[col]);
+    }
+    G_free(batch->value);
+    G_free(batch->ctype);
+
+    db_init_batch(batch);
+}
+
+/*!
+   \brief Get value stored in dbBatch
+
+   \param batch pointer to dbBatch
+   \param col column index
+   \param row row index
+
+   \return pointer to dbValue
+   \return NULL if column or row is out of range
+ */
+dbValue *db_get_batch_value(dbBatch *batch, int col, int row)
+{
+    if (col < 0 || col >= batch->ncols || row < 0 || row >= batch->nrows)
+        return NULL;
+
+    return &batch->value[col][row];
+}
@@ -186,6 +186,10 @@ dbDbmscap *db_read_dbmscap(void)
             continue;
 #endif
 
+        /* skip libraries of in-process drivers (lib<driver>.so) */
+        if (strncmp(ent->d_name, "lib", 3) == 0)
+            continue;
+
         /* Remove '.exe' from name (windows extension) */
         name = G_str_replace(ent->d_name, ".exe", "");
 
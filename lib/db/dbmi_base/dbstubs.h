@@ -32,6 +32,9 @@ extern int db__driver_grant_on_table(dbString *, int, int);
 extern int db__driver_get_num_rows(dbCursor *);
 extern int db__driver_begin_transaction(void);
 extern int db__driver_commit_transaction(void);
+extern int db__driver_prepare(dbPrepared *);
+extern int db__driver_execute_prepared(dbPrepared *);
+extern int db__driver_close_prepared(dbPrepared *);
 extern int db__driver_update(dbCursor *);
 
 #ifdef DB_DRIVER_C
@@ -71,6 +74,9 @@ int (*db_driver_grant_on_table)(dbString *, int,
 int (*db_driver_get_num_rows)(dbCursor *) = db__driver_get_num_rows;
 int (*db_driver_begin_transaction)(void) = db__driver_begin_transaction;
 int (*db_driver_commit_transaction)(void) = db__driver_commit_transaction;
+int (*db_driver_prepare)(dbPrepared *) = db__driver_prepare;
+int (*db_driver_execute_prepared)(dbPrepared *) = db__driver_execute_prepared;
+int (*db_driver_close_prepared)(dbPrepared *) = db__driver_close_prepared;
 int (*db_driver_update)(dbCursor *) = db__driver_update;
 #else
 extern int (*db_driver_add_column)(dbString *, dbColumn *);
@@ -104,6 +110,9 @@ extern int (*db_driver_grant_on_table)(dbString *, int, int);
 extern int (*db_driver_get_num_rows)(dbCursor *);
 extern int (*db_driver_begin_transaction)(void);
 extern int (*db_driver_commit_transaction)(void);
+extern int (*db_driver_prepare)(dbPrepared *);
+extern int (*db_driver_execute_prepared)(dbPrepared *);
+extern int (*db_driver_close_prepared)(dbPrepared *);
 extern int (*db_driver_update)(dbCursor *);
 #endif
 
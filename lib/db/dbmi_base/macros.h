@@ -89,6 +89,16 @@
         if (db__recv_int(x) != DB_OK) \
             DB_RETURN_ERR             \
     }
+#define DB_SEND_INT_ARRAY(x, n)                \
+    {                                          \
+        if (db__send_int_array(x, n) != DB_OK) \
+            DB_RETURN_ERR                      \
+    }
+#define DB_RECV_INT_ARRAY(x, n)                \
+    {                                          \
+        if (db__recv_int_array(x, n) != DB_OK) \
+            DB_RETURN_ERR                      \
+    }
 
 #define DB_SEND_FLOAT(x)                \
     {                                   \
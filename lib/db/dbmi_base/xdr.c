@@ -26,8 +26,24 @@
 #include <unistd.h>
 #endif
 
+#include <string.h>
+#include <grass/gis.h>
+
 static FILE *_send, *_recv;
 
+/* in-process driver: data are exchanged through memory buffers and the
+   driver is called directly when the client waits for a reply */
+struct local_buffer {
+    char *data;
+    size_t len;
+    size_t pos;
+    size_t alloc;
+};
+
+static struct local_buffer _request, _reply;
+static int (*_local_step)(void);
+static int _in_driver;
+
 #if USE_READN
 
 static ssize_t readn(int fd, void *buf, size_t count)
@@ -66,6 +82,54 @@ static ssize_t writen(int fd, const void *buf, size_t count)
 
 #endif
 
+static void local_put(struct local_buffer *b, const void *buf, size_t size)
+{
+    if (b->len + size > b->alloc) {
+        b->alloc = b->len + size + 4096;
+        b->data = G_realloc(b->data, b->alloc);
+    }
+    memcpy(b->data + b->len, buf, size);
+    b->len += size;
+}
+
+static int local_get(struct local_buffer *b, void *buf, size_t size)
+{
+    if (b->len - b->pos < size)
+        return 0;
+    memcpy(buf, b->data + b->pos, size);
+    b->pos += size;
+    if (b->pos == b->len)
+        b->pos = b->len = 0;
+
+    return 1;
+}
+
+static int local_send(const void *buf, size_t size)
+{
+    local_put(_in_driver ? &_reply : &_request, buf, size);
+
+    return 1;
+}
+
+static int local_recv(void *buf, size_t size)
+{
+    if (_in_driver)
+        return local_get(&_request, buf, size);
+
+    /* run the driver until it has replied */
+    while (_reply.len - _reply.pos < size) {
+        int stat;
+
+        _in_driver = 1;
+        stat = _local_step();
+        _in_driver = 0;
+        if (stat != DB_OK)
+            break;
+    }
+
+    return local_get(&_reply, buf, size);
+}
+
 /*!
    \brief ?
 
@@ -78,6 +142,43 @@ void db__set_protocol_fds(FILE *send, FILE *recv)
     _recv = recv;
 }
 
+/*!
+   \brief Register in-process driver
+
+   While registered, the protocol of driver with NULL send/recv
+   streams is exchanged in memory and <i>step</i> is called to let the
+   driver process the pending request. Only one in-process driver can be
+   registered at a time.
+
+   \param step driver routine processing one step of the protocol, or
+   NULL to unregister the driver
+
+   \return DB_OK on success
+   \return DB_FAILED if another in-process driver is already registered
+ */
+int db__set_local_driver(int (*step)(void))
+{
+    if (step && _local_step)
+        return DB_FAILED;
+
+    _local_step = step;
+    _request.len = _request.pos = 0;
+    _reply.len = _reply.pos = 0;
+
+    return DB_OK;
+}
+
+/*!
+   \brief Check if in-process driver is registered
+
+   \return 1 if registered
+   \return 0 otherwise
+ */
+int db__local_driver_active(void)
+{
+    return _local_step != NULL;
+}
+
 /*!
    \brief ?
 
@@ -88,6 +189,9 @@ void db__set_protocol_fds(FILE *send, FILE *recv)
  */
 int db__send(const void *buf, size_t size)
 {
+    if (!_send && _local_step)
+        return local_send(buf, size);
+
 #if USE_STDIO
     return fwrite(buf, 1, size, _send) == size;
 #elif USE_READN
@@ -99,6 +203,9 @@ int db__send(const void *buf, size_t size)
 
 int db__recv(void *buf, size_t size)
 {
+    if (!_recv && _local_step)
+        return local_recv(buf, size);
+
 #if USE_STDIO
 #ifdef USE_BUFFERED_IO
     fflush(_send);
@@ -0,0 +1,183 @@
+/*!
+ * \file db/dbmi_client/attr_cache.c
+ *
+ * \brief DBMI Library (client) - attribute cache keyed by category
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/dbmi.h>
+#include <grass/glocale.h>
+
+static int cmpcat(const void *pa, const void *pb)
+{
+    const dbCatValI *p1 = pa;
+    const dbCatValI *p2 = pb;
+
+    if (p1->cat < p2->cat)
+        return -1;
+    if (p1->cat > p2->cat)
+        return 1;
+    return 0;
+}
+
+/*!
+   \brief Select attributes of all (or selected) records into cache
+
+   All rows are read with db_fetch_batch() and kept by column in
+   memory, so that the attributes of a vector feature can be looked up
+   by category without any further request to the driver.
+
+   \param driver DB driver
+   \param tab table name
+   \param key key column name (must be integer)
+   \param cols comma separated list of columns to be cached
+   \param where where statement (or NULL)
+   \param[out] cache dbAttrCache to store within
+
+   \return number of cached rows
+   \return -1 on error
+ */
+int db_select_attr_cache(dbDriver *driver, const char *tab, const char *key,
+                         const char *cols, const char *where,
+                         dbAttrCache *cache)
+{
+    int row, more;
+    dbString stmt;
+    dbCursor cursor;
+    dbBatch batch;
+    dbValue *value;
+
+    G_debug(3, "db_select_attr_cache()");
+
+    G_zero(cache, sizeof(dbAttrCache));
+    db_init_batch(&cache->batch);
+
+    if (key == NULL || strlen(key) == 0) {
+        G_warning(_("Missing key column name"));
+        return -1;
+    }
+
+    if (cols == NULL || strlen(cols) == 0) {
+        G_warning(_("Missing column name"));
+        return -1;
+    }
+
+    db_init_string(&stmt);
+    db_set_string(&stmt, "SELECT ");
+    db_append_string(&stmt, key);
+    db_append_string(&stmt, ", ");
+    db_append_string(&stmt, cols);
+    db_append_string(&stmt, " FROM ");
+    db_append_string(&stmt, tab);
+    if (where != NULL && strlen(where) > 0) {
+        db_append_string(&stmt, " WHERE ");
+        db_append_string(&stmt, where);
+    }
+
+    G_debug(3, "  SQL: %s", db_get_string(&stmt));
+
+    if (db_open_select_cursor(driver, &stmt, &cursor, DB_SEQUENTIAL) != DB_OK) {
+        db_free_string(&stmt);
+        return -1;
+    }
+    db_free_string(&stmt);
+
+    if (db_sqltype_to_Ctype(db_get_column_sqltype(db_get_table_column(
+            db_get_cursor_table(&cursor), 0))) != DB_C_TYPE_INT) {
+        G_warning(_("Key column type is not integer"));
+        db_close_cursor(&cursor);
+        return -1;
+    }
+
+    /* fetch the data, appending batches to the cache */
+    more = 1;
+    db_init_batch(&batch);
+    while (more) {
+        if (db_fetch_batch(&cursor, DB_FETCH_BATCH_SIZE, &batch, &more) !=
+            DB_OK) {
+            db_free_batch(&batch);
+            db_close_cursor(&cursor);
+            db_free_attr_cache(cache);
+            return -1;
+        }
+        if (batch.nrows == 0)
+            break;
+
+        if (cache->batch.alloc < cache->n_rows + batch.nrows) {
+            db_alloc_batch(&cache->batch, batch.ncols,
+                           2 * (cache->n_rows + batch.nrows));
+            memcpy(cache->batch.ctype, batch.ctype, batch.ncols * sizeof(int));
+            cache->rows = (dbCatValI *)G_realloc(
+                cache->rows, cache->batch.alloc * sizeof(dbCatValI));
+        }
+
+        for (row = 0; row < batch.nrows; row++) {
+            int col;
+
+            for (col = 0; col < batch.ncols; col++) {
+                value = &cache->batch.value[col][cache->n_rows];
+                db_copy_value(value, &batch.value[col][row]);
+                /* empty strings are not copied */
+                if (!db_get_string(&value->s))
+                    db_init_string(&value->s);
+            }
+            cache->rows[cache->n_rows].cat =
+                db_get_value_int(&batch.value[0][row]);
+            cache->rows[cache->n_rows].val = cache->n_rows;
+            cache->n_rows++;
+        }
+        cache->batch.nrows = cache->n_rows;
+    }
+
+    db_free_batch(&batch);
+    db_close_cursor(&cursor);
+
+    qsort(cache->rows, cache->n_rows, sizeof(dbCatValI), cmpcat);
+
+    return cache->n_rows;
+}
+
+/*!
+   \brief Find cached value by category
+
+   \param cache pointer to dbAttrCache
+   \param cat category
+   \param col column index in cache (0 is the key column, 1 the first
+   column given to db_select_attr_cache())
+
+   \return pointer to dbValue
+   \return NULL if category is not found or column is out of range
+ */
+dbValue *db_attr_cache_get_value(dbAttrCache *cache, int cat, int col)
+{
+    dbCatValI key, *found;
+
+    key.cat = cat;
+    found = bsearch(&key, cache->rows, cache->n_rows, sizeof(dbCatValI),
+                    cmpcat);
+    if (found == NULL)
+        return NULL;
+
+    return db_get_batch_value(&cache->batch, col, found->val);
+}
+
+/*!
+   \brief Free attribute cache
+
+   \param cache pointer to dbAttrCache
+ */
+void db_free_attr_cache(dbAttrCache *cache)
+{
+    db_free_batch(&cache->batch);
+    G_free(cache->rows);
+    cache->rows = NULL;
+    cache->n_rows = 0;
+}
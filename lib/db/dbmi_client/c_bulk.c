@@ -0,0 +1,220 @@
+/*!
+ * \file db/dbmi_client/c_bulk.c
+ *
+ * \brief DBMI Library (client) - bulk execution of prepared statement
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ */
+
+#include <grass/gis.h>
+#include <grass/dbmi.h>
+#include <grass/glocale.h>
+#include "macros.h"
+
+/*!
+   \brief Prepare SQL statement for bulk execution
+
+   The statement (typically INSERT or UPDATE) is prepared once by the
+   driver, parameters are marked by '?' and bound to values of each
+   row added by db_add_bulk_row(). Rows are sent to the driver in
+   batches of DB_BULK_SIZE rows. Drivers which do not support prepared
+   statements execute each row by substituting the values into the
+   statement.
+
+   The statements should be enclosed in a transaction
+   (db_begin_transaction(), db_commit_transaction()) to avoid a commit
+   per row.
+
+   \code
+   int ctype[] = {DB_C_TYPE_DOUBLE, DB_C_TYPE_INT};
+
+   db_set_string(&stmt, "UPDATE tab SET val = ? WHERE cat = ?");
+   db_prepare_bulk(driver, &stmt, 2, ctype, &bulk);
+   for (...) {
+       db_set_value_double(db_get_bulk_param(&bulk, 0), val);
+       db_set_value_int(db_get_bulk_param(&bulk, 1), cat);
+       db_add_bulk_row(&bulk);
+   }
+   db_close_bulk(&bulk);
+   \endcode
+
+   \param driver DB driver
+   \param sql SQL statement with parameter markers
+   \param nparams number of parameters
+   \param ctype C type of each parameter (DB_C_TYPE_INT,
+   DB_C_TYPE_DOUBLE or DB_C_TYPE_STRING)
+   \param[out] bulk dbBulk to be initialized
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_prepare_bulk(dbDriver *driver, dbString *sql, int nparams,
+                    const int *ctype, dbBulk *bulk)
+{
+    int ret_code;
+    int i;
+
+    G_zero(bulk, sizeof(dbBulk));
+    db_init_batch(&bulk->params);
+    bulk->driver = driver;
+
+    for (i = 0; i < nparams; i++) {
+        if (ctype[i] != DB_C_TYPE_INT && ctype[i] != DB_C_TYPE_DOUBLE &&
+            ctype[i] != DB_C_TYPE_STRING) {
+            db_error(_("Unsupported type of statement parameter"));
+            return DB_FAILED;
+        }
+    }
+
+    /* start the procedure call */
+    db__set_protocol_fds(driver->send, driver->recv);
+    DB_START_PROCEDURE_CALL(DB_PROC_PREPARE);
+
+    /* send the argument(s) to the procedure */
+    DB_SEND_STRING(sql);
+    DB_SEND_INT_ARRAY(ctype, nparams);
+
+    /* get the return code for the procedure call */
+    DB_RECV_RETURN_CODE(&ret_code);
+
+    if (ret_code != DB_OK)
+        return ret_code; /* ret_code SHOULD == DB_FAILED */
+
+    /* get the results */
+    DB_RECV_TOKEN(&bulk->token);
+
+    if (db_alloc_batch(&bulk->params, nparams, DB_BULK_SIZE) != DB_OK)
+        return DB_FAILED;
+    for (i = 0; i < nparams; i++)
+        bulk->params.ctype[i] = ctype[i];
+
+    return DB_OK;
+}
+
+/*!
+   \brief Get parameter value of the row being added
+
+   \param bulk pointer to dbBulk
+   \param param parameter index
+
+   \return pointer to dbValue
+   \return NULL if the index is out of range
+ */
+dbValue *db_get_bulk_param(dbBulk *bulk, int param)
+{
+    if (param < 0 || param >= bulk->params.ncols)
+        return NULL;
+
+    return &bulk->params.value[param][bulk->params.nrows];
+}
+
+/*!
+   \brief Add row of parameter values set by db_get_bulk_param()
+
+   Pending rows are executed when DB_BULK_SIZE rows were added.
+
+   \param bulk pointer to dbBulk
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_add_bulk_row(dbBulk *bulk)
+{
+    bulk->params.nrows++;
+    if (bulk->params.nrows < bulk->params.alloc)
+        return DB_OK;
+
+    return db_execute_bulk(bulk);
+}
+
+/*!
+   \brief Execute pending rows
+
+   The number of successfully executed rows and failed rows is
+   accumulated in bulk->n_ok and bulk->n_failed.
+
+   \param bulk pointer to dbBulk
+
+   \return DB_OK on success
+   \return DB_FAILED if any row failed
+ */
+int db_execute_bulk(dbBulk *bulk)
+{
+    int ret_code;
+    int row, param, nrows, n_ok;
+    dbBatch *params;
+
+    params = &bulk->params;
+    nrows = params->nrows;
+    if (nrows == 0)
+        return DB_OK;
+    params->nrows = 0;
+
+    /* start the procedure call */
+    db__set_protocol_fds(bulk->driver->send, bulk->driver->recv);
+    DB_START_PROCEDURE_CALL(DB_PROC_EXECUTE_PREPARED);
+
+    /* send the argument(s) to the procedure */
+    DB_SEND_TOKEN(&bulk->token);
+    /* the driver reads the rows with these types even if the token is
+     * invalid */
+    DB_SEND_INT_ARRAY(params->ctype, params->ncols);
+    DB_SEND_INT(nrows);
+    for (row = 0; row < nrows; row++) {
+        for (param = 0; param < params->ncols; param++) {
+            if (db__send_value(&params->value[param][row],
+                               params->ctype[param]) != DB_OK)
+                return db_get_error_code();
+        }
+    }
+
+    /* get the return code for the procedure call */
+    DB_RECV_RETURN_CODE(&ret_code);
+
+    if (ret_code != DB_OK) {
+        bulk->n_failed += nrows;
+        return ret_code; /* ret_code SHOULD == DB_FAILED */
+    }
+
+    /* get the results */
+    DB_RECV_INT(&n_ok);
+    bulk->n_ok += n_ok;
+    bulk->n_failed += nrows - n_ok;
+
+    return n_ok == nrows ? DB_OK : DB_FAILED;
+}
+
+/*!
+   \brief Execute pending rows and release prepared statement
+
+   \param bulk pointer to dbBulk
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_close_bulk(dbBulk *bulk)
+{
+    int ret_code, stat;
+
+    stat = db_execute_bulk(bulk);
+    db_free_batch(&bulk->params);
+
+    /* start the procedure call */
+    db__set_protocol_fds(bulk->driver->send, bulk->driver->recv);
+    DB_START_PROCEDURE_CALL(DB_PROC_CLOSE_PREPARED);
+
+    /* send the argument(s) to the procedure */
+    DB_SEND_TOKEN(&bulk->token);
+
+    /* get the return code for the procedure call */
+    DB_RECV_RETURN_CODE(&ret_code);
+
+    if (ret_code != DB_OK)
+        return ret_code; /* ret_code SHOULD == DB_FAILED */
+
+    return stat;
+}
@@ -0,0 +1,94 @@
+/*!
+ * \file db/dbmi_client/c_fetch_batch.c
+ *
+ * \brief DBMI Library (client) - fetch batch of rows
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ */
+
+#include <grass/dbmi.h>
+#include "macros.h"
+
+static void copy_value(dbValue *dst, dbValue *src)
+{
+    db_copy_value(dst, src);
+    /* db_copy_value() keeps the old string if source has none */
+    if (src->s.nalloc == 0 && dst->s.nalloc > 0)
+        dst->s.string[0] = '\0';
+}
+
+/*!
+   \brief Fetch next rows from open cursor in one procedure call
+
+   Up to <i>nrows</i> rows are fetched sequentially (DB_NEXT) and
+   stored by column in <i>batch</i>, replacing its previous
+   content. On return batch->nrows is set to number of fetched rows
+   and <i>more</i> to zero if the end of data was reached, in which case
+   the cursor should not be fetched again.
+
+   The values are also available in the cursor table which holds the
+   last fetched row, as with db_fetch().
+
+   \param cursor pointer to dbCursor
+   \param nrows maximum number of rows to fetch (DB_FETCH_BATCH_SIZE
+   is used if <= 0)
+   \param[in,out] batch pointer to initialized dbBatch
+   \param[out] more get more (0 for no more data to be fetched)
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_fetch_batch(dbCursor *cursor, int nrows, dbBatch *batch, int *more)
+{
+    int ret_code;
+    int row, col, ncols;
+    dbTable *table;
+
+    if (nrows <= 0)
+        nrows = DB_FETCH_BATCH_SIZE;
+
+    table = cursor->table;
+    ncols = db_get_table_number_of_columns(table);
+    if (db_alloc_batch(batch, ncols, nrows) != DB_OK)
+        return DB_FAILED;
+    for (col = 0; col < ncols; col++)
+        batch->ctype[col] = db_sqltype_to_Ctype(
+            db_get_column_sqltype(db_get_table_column(table, col)));
+    batch->nrows = 0;
+    *more = 1;
+
+    /* start the procedure call */
+    db__set_protocol_fds(cursor->driver->send, cursor->driver->recv);
+    DB_START_PROCEDURE_CALL(DB_PROC_FETCH_BATCH);
+
+    /* send the argument(s) to the procedure */
+    DB_SEND_TOKEN(&cursor->token);
+    DB_SEND_INT(nrows);
+
+    /* get the return code for the procedure call */
+    DB_RECV_RETURN_CODE(&ret_code);
+
+    if (ret_code != DB_OK)
+        return ret_code; /* ret_code SHOULD == DB_FAILED */
+
+    /* get the results */
+    for (row = 0; row < nrows; row++) {
+        DB_RECV_INT(more);
+        if (*more < 0)
+            return DB_FAILED;
+        if (!*more)
+            break;
+
+        DB_RECV_TABLE_DATA(table);
+        for (col = 0; col < ncols; col++)
+            copy_value(&batch->value[col][row],
+                       db_get_column_value(db_get_table_column(table, col)));
+        batch->nrows++;
+    }
+
+    return DB_OK;
+}
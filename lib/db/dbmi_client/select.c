@@ -103,7 +103,7 @@ static int cmpvaluestring(const void *pa, const void *pb)
 int db_select_int(dbDriver *driver, const char *tab, const char *col,
                   const char *where, int **pval)
 {
-    int type, more, alloc, count;
+    int type, more, row, alloc, count;
     int *val;
     char *buf = NULL;
     const char *sval;
@@ -112,6 +112,7 @@ int db_select_int(dbDriver *driver, const char *tab, const char *col,
     dbColumn *column;
     dbValue *value;
     dbTable *table;
+    dbBatch batch;
 
     G_debug(3, "db_select_int()");
 
@@ -143,41 +144,44 @@ int db_select_int(dbDriver *driver, const char *tab, const char *col,
     if (column == NULL) {
         return -1;
     }
-    value = db_get_column_value(column);
     type = db_get_column_sqltype(column);
     type = db_sqltype_to_Ctype(type);
 
     /* fetch the data */
     count = 0;
-    while (1) {
-        if (db_fetch(&cursor, DB_NEXT, &more) != DB_OK)
+    more = 1;
+    db_init_batch(&batch);
+    while (more) {
+        if (db_fetch_batch(&cursor, DB_FETCH_BATCH_SIZE, &batch, &more) !=
+            DB_OK)
             return (-1);
 
-        if (!more)
-            break;
-
-        if (count == alloc) {
-            alloc += 1000;
+        if (count + batch.nrows > alloc) {
+            alloc = count + batch.nrows + 1000;
             val = (int *)G_realloc(val, alloc * sizeof(int));
         }
 
-        switch (type) {
-        case (DB_C_TYPE_INT):
-            val[count] = db_get_value_int(value);
-            break;
-        case (DB_C_TYPE_STRING):
-            sval = db_get_value_string(value);
-            val[count] = atoi(sval);
-            break;
-        case (DB_C_TYPE_DOUBLE):
-            val[count] = (int)db_get_value_double(value);
-            break;
-        default:
-            return (-1);
+        for (row = 0; row < batch.nrows; row++) {
+            value = db_get_batch_value(&batch, 0, row);
+            switch (type) {
+            case (DB_C_TYPE_INT):
+                val[count] = db_get_value_int(value);
+                break;
+            case (DB_C_TYPE_STRING):
+                sval = db_get_value_string(value);
+                val[count] = atoi(sval);
+                break;
+            case (DB_C_TYPE_DOUBLE):
+                val[count] = (int)db_get_value_double(value);
+                break;
+            default:
+                return (-1);
+            }
+            count++;
         }
-        count++;
     }
 
+    db_free_batch(&batch);
     db_close_cursor(&cursor);
     db_free_string(&stmt);
 
@@ -270,13 +274,14 @@ int db_select_CatValArray(dbDriver *driver, const char *tab, const char *key,
                           const char *col, const char *where,
                           dbCatValArray *cvarr)
 {
-    int i, type, more, nrows, ncols;
+    int i, row, type, more, nrows, ncols;
     char *buf = NULL;
     dbString stmt;
     dbCursor cursor;
     dbColumn *column;
     dbValue *value;
     dbTable *table;
+    dbBatch batch;
 
     G_debug(3, "db_select_CatValArray ()");
 
@@ -352,18 +357,23 @@ int db_select_CatValArray(dbDriver *driver, const char *tab, const char *key,
     cvarr->ctype = type;
 
     /* fetch the data */
-    for (i = 0; i < nrows; i++) {
-        if (db_fetch(&cursor, DB_NEXT, &more) != DB_OK)
-            return (-1);
+    more = 1;
+    db_init_batch(&batch);
+    for (i = 0, row = 0; i < nrows; i++, row++) {
+        if (row == batch.nrows) {
+            if (!more ||
+                db_fetch_batch(&cursor, DB_FETCH_BATCH_SIZE, &batch, &more) !=
+                    DB_OK ||
+                batch.nrows == 0)
+                return (-1);
+            row = 0;
+        }
 
-        column = db_get_table_column(table, 0); /* first column */
-        value = db_get_column_value(column);
+        value = db_get_batch_value(&batch, 0, row); /* first column */
         cvarr->value[i].cat = db_get_value_int(value);
 
-        if (ncols == 2) {
-            column = db_get_table_column(table, 1);
-            value = db_get_column_value(column);
-        }
+        if (ncols == 2)
+            value = db_get_batch_value(&batch, 1, row);
         cvarr->value[i].isNull = value->isNull;
         switch (type) {
         case (DB_C_TYPE_INT):
@@ -402,6 +412,7 @@ int db_select_CatValArray(dbDriver *driver, const char *tab, const char *key,
     }
     cvarr->n_values = nrows;
 
+    db_free_batch(&batch);
     db_close_cursor(&cursor);
     db_free_string(&stmt);
 
@@ -40,6 +40,15 @@ int db_shutdown_driver(dbDriver *driver)
     db__set_protocol_fds(driver->send, driver->recv);
     DB_START_PROCEDURE_CALL(DB_PROC_SHUTDOWN_DRIVER);
 
+    if (driver->send == NULL) {
+        /* in-process driver, see db_start_driver() */
+        db__set_local_driver(NULL);
+        db_unset_error_handler_driver(driver);
+        db_free(driver);
+
+        return 0;
+    }
+
     /* close the communication FILEs */
     fclose(driver->send);
     fclose(driver->recv);
@@ -20,6 +20,8 @@
 #include <windows.h>
 #include <process.h>
 #include <fcntl.h>
+#else
+#include <dlfcn.h>
 #endif
 
 #include <grass/spawn.h>
@@ -28,6 +30,15 @@
 #define READ  0
 #define WRITE 1
 
+/* suffix of drivers built as shared library, set by the build */
+#ifndef DB_DRIVER_SUFFIX
+#ifdef __APPLE__
+#define DB_DRIVER_SUFFIX ".dylib"
+#else
+#define DB_DRIVER_SUFFIX ".so"
+#endif
+#endif
+
 static void close_on_exec(int fd)
 {
 #ifndef _WIN32
@@ -37,12 +48,72 @@ static void close_on_exec(int fd)
 #endif
 }
 
+/* try to load driver as shared library into this process */
+static int start_local_driver(dbDriver *driver)
+{
+#ifndef _WIN32
+    const char *startup, *mode, *base;
+    char *path;
+    void *handle;
+    int (*local_main)(void);
+
+    mode = getenv("GRASS_DB_DRIVER_INPROCESS");
+    if (!mode || atoi(mode) == 0)
+        return DB_FAILED;
+
+    /* only one driver may run in process at a time */
+    if (db__local_driver_active())
+        return DB_FAILED;
+
+    /* lib<driver>.so next to driver executable */
+    startup = driver->dbmscap.startup;
+    base = strrchr(startup, '/');
+    base = base ? base + 1 : startup;
+    G_asprintf(&path, "%.*slib%s%s", (int)(base - startup), startup, base,
+               DB_DRIVER_SUFFIX);
+
+    handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        G_debug(1, "Unable to load in-process driver <%s>: %s", path,
+                dlerror());
+        G_free(path);
+        return DB_FAILED;
+    }
+    G_free(path);
+
+    local_main = (int (*)(void))dlsym(handle, "db_driver_local_main");
+    if (!local_main || local_main() != DB_OK) {
+        G_debug(1, "Unable to start in-process driver <%s>",
+                driver->dbmscap.driverName);
+        return DB_FAILED;
+    }
+
+    G_debug(2, "Driver <%s> started in process", driver->dbmscap.driverName);
+
+    /* NULL streams mark the in-process driver */
+    driver->pid = 0;
+    driver->send = NULL;
+    driver->recv = NULL;
+
+    return DB_OK;
+#else
+    return DB_FAILED;
+#endif
+}
+
 /*!
    \brief Initialize a new dbDriver for db transaction.
 
    If <i>name</i> is NULL, the db name will be assigned
    connection.driverName.
 
+   If the environment variable GRASS_DB_DRIVER_INPROCESS is set to 1 and
+   the driver is available as shared library (currently SQLite), the
+   driver is loaded into the calling process and called directly
+   instead of being run as a child process reached through pipes. Only
+   one driver can run in process at a time, other drivers are started
+   as child processes.
+
    \param name driver name
 
    \return pointer to dbDriver structure
@@ -133,6 +204,10 @@ dbDriver *db_start_driver(const char *name)
     /* free the dbmscap list */
     db_free_dbmscap(list);
 
+    /* run the driver in this process if requested and available */
+    if (start_local_driver(driver) == DB_OK)
+        return driver;
+
     /* run the driver as a child process and create pipes to its stdin, stdout
      */
 
@@ -0,0 +1,63 @@
+/*!
+ * \file db/dbmi_driver/d_fetch_batch.c
+ *
+ * \brief DBMI Library (driver) - fetch batch of rows
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ */
+
+#include <grass/dbmi.h>
+#include "macros.h"
+#include "dbstubs.h"
+
+/*!
+   \brief Fetch up to given number of rows in one procedure call
+
+   Rows are fetched sequentially by the driver's fetch routine, so that
+   every driver supports batch fetching. Each row is preceded by a flag
+   which is 1 for a row, 0 for end of data and -1 for a fetch error.
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_d_fetch_batch(void)
+{
+    dbToken token;
+    dbCursor *cursor;
+    int stat;
+    int more;
+    int nrows, row;
+
+    /* get the arg(s) */
+    DB_RECV_TOKEN(&token);
+    DB_RECV_INT(&nrows);
+    cursor = (dbCursor *)db_find_token(token);
+    if (cursor == NULL || !db_test_cursor_type_fetch(cursor)) {
+        db_error("not a fetchable cursor");
+        DB_SEND_FAILURE();
+        return DB_FAILED;
+    }
+
+    DB_SEND_SUCCESS();
+
+    /* results */
+    for (row = 0; row < nrows; row++) {
+        /* call the procedure */
+        stat = db_driver_fetch(cursor, DB_NEXT, &more);
+        if (stat != DB_OK) {
+            DB_SEND_INT(-1);
+            return DB_OK;
+        }
+
+        DB_SEND_INT(more);
+        if (!more)
+            break;
+        DB_SEND_TABLE_DATA(cursor->table);
+    }
+
+    return DB_OK;
+}
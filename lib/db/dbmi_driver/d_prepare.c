@@ -0,0 +1,310 @@
+/*!
+ * \file db/dbmi_driver/d_prepare.c
+ *
+ * \brief DBMI Library (driver) - prepared statements
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public
+ * License (>=v2). Read the file COPYING that comes with GRASS
+ * for details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/dbmi.h>
+#include <grass/glocale.h>
+#include "macros.h"
+#include "dbstubs.h"
+
+/* find next parameter marker outside of quotes */
+static const char *next_param(const char *s)
+{
+    char quote = '\0';
+
+    for (; *s; s++) {
+        if (quote) {
+            if (*s == quote)
+                quote = '\0';
+        }
+        else if (*s == '\'' || *s == '"')
+            quote = *s;
+        else if (*s == '?')
+            return s;
+    }
+
+    return NULL;
+}
+
+static void append_n(dbString *dst, const char *s, int n)
+{
+    char *buf;
+
+    buf = G_malloc(n + 1);
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    db_append_string(dst, buf);
+    G_free(buf);
+}
+
+static void append_value(dbString *dst, dbValue *value, int ctype,
+                         dbString *tmp)
+{
+    char buf[64];
+
+    if (value->isNull) {
+        db_append_string(dst, "NULL");
+        return;
+    }
+
+    switch (ctype) {
+    case DB_C_TYPE_INT:
+        snprintf(buf, sizeof(buf), "%d", value->i);
+        db_append_string(dst, buf);
+        break;
+    case DB_C_TYPE_DOUBLE:
+        snprintf(buf, sizeof(buf), "%.17g", value->d);
+        db_append_string(dst, buf);
+        break;
+    default:
+        db_copy_string(tmp, &value->s);
+        db_double_quote_string(tmp);
+        db_append_string(dst, "'");
+        db_append_string(dst, db_get_string(tmp));
+        db_append_string(dst, "'");
+        break;
+    }
+}
+
+/* execute prepared statement by drivers which do not support it */
+static int execute_substituted(dbPrepared *prepared)
+{
+    dbString sql, tmp;
+    const char *s, *p;
+    int param, stat;
+
+    db_init_string(&sql);
+    db_init_string(&tmp);
+
+    s = db_get_string(&prepared->sql);
+    for (param = 0; (p = next_param(s)) && param < prepared->nparams;
+         param++) {
+        append_n(&sql, s, p - s);
+        append_value(&sql, &prepared->value[param], prepared->ctype[param],
+                     &tmp);
+        s = p + 1;
+    }
+    db_append_string(&sql, s);
+
+    G_debug(3, "execute_substituted(): %s", db_get_string(&sql));
+    stat = db_driver_execute_immediate(&sql);
+
+    db_free_string(&sql);
+    db_free_string(&tmp);
+
+    return stat;
+}
+
+/* parameters of rows sent by the client match the statement */
+static int valid_params(dbPrepared *prepared, const int *ctype, int nparams)
+{
+    int param;
+
+    if (prepared == NULL || prepared->nparams != nparams)
+        return 0;
+
+    for (param = 0; param < nparams; param++)
+        if (prepared->ctype[param] != ctype[param])
+            return 0;
+
+    return 1;
+}
+
+static void free_prepared(dbPrepared *prepared)
+{
+    int i;
+
+    for (i = 0; i < prepared->nparams; i++)
+        db_free_string(&prepared->value[i].s);
+    db_free_string(&prepared->sql);
+    db_free(prepared->ctype);
+    G_free(prepared->value);
+    G_free(prepared);
+}
+
+/*!
+   \brief Prepare statement for bulk execution
+
+   If the driver does not prepare the statement itself (the data of
+   dbPrepared is left NULL), each row is executed by substituting the
+   parameter values into the statement.
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_d_prepare(void)
+{
+    dbPrepared *prepared;
+    dbToken token;
+    const char *p;
+    int stat, n;
+
+    prepared = (dbPrepared *)G_calloc(1, sizeof(dbPrepared));
+    db_init_string(&prepared->sql);
+
+    /* get the arg(s) */
+    DB_RECV_STRING(&prepared->sql);
+    DB_RECV_INT_ARRAY(&prepared->ctype, &prepared->nparams);
+    prepared->value =
+        (dbValue *)G_calloc(prepared->nparams + 1, sizeof(dbValue));
+
+    /* call the procedure */
+    stat = db_driver_prepare(prepared);
+
+    if (stat == DB_OK && prepared->data == NULL) {
+        for (n = 0, p = db_get_string(&prepared->sql); (p = next_param(p));
+             p++)
+            n++;
+        if (n != prepared->nparams) {
+            db_d_append_error(_("Statement has %d parameters, %d expected"), n,
+                              prepared->nparams);
+            db_d_report_error();
+            stat = DB_FAILED;
+        }
+    }
+
+    token = -1;
+    if (stat == DB_OK) {
+        token = db_new_token((dbAddress)prepared);
+        if (token < 0) {
+            db_driver_close_prepared(prepared);
+            stat = DB_FAILED;
+        }
+    }
+
+    /* send the return code */
+    if (stat != DB_OK) {
+        free_prepared(prepared);
+        DB_SEND_FAILURE();
+        return DB_OK;
+    }
+    DB_SEND_SUCCESS();
+
+    /* send results */
+    DB_SEND_TOKEN(&token);
+    return DB_OK;
+}
+
+/*!
+   \brief Execute rows of prepared statement
+
+   All rows are executed even if some of them fail, the number of
+   successfully executed rows is sent back.
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_d_execute_prepared(void)
+{
+    dbPrepared *prepared;
+    dbToken token;
+    dbValue value;
+    int *ctype;
+    int nparams, nrows, row, param, n_ok;
+
+    /* get the arg(s) */
+    DB_RECV_TOKEN(&token);
+    DB_RECV_INT_ARRAY(&ctype, &nparams);
+    DB_RECV_INT(&nrows);
+    prepared = (dbPrepared *)db_find_token(token);
+    if (!valid_params(prepared, ctype, nparams)) {
+        db_error("** invalid prepared statement **");
+
+        /* read and discard the rows sent by the client */
+        G_zero(&value, sizeof(dbValue));
+        db_init_string(&value.s);
+        for (row = 0; row < nrows; row++) {
+            for (param = 0; param < nparams; param++) {
+                if (db__recv_value(&value, ctype[param]) != DB_OK) {
+                    db_free_string(&value.s);
+                    db_free(ctype);
+                    return db_get_error_code();
+                }
+            }
+        }
+        db_free_string(&value.s);
+        db_free(ctype);
+
+        DB_SEND_FAILURE();
+        return DB_OK;
+    }
+
+    /* call the procedure for each row */
+    n_ok = 0;
+    for (row = 0; row < nrows; row++) {
+        for (param = 0; param < nparams; param++) {
+            if (db__recv_value(&prepared->value[param], ctype[param]) !=
+                DB_OK) {
+                db_free(ctype);
+                return db_get_error_code();
+            }
+        }
+
+        if (prepared->data) {
+            if (db_driver_execute_prepared(prepared) == DB_OK)
+                n_ok++;
+        }
+        else if (execute_substituted(prepared) == DB_OK)
+            n_ok++;
+    }
+    db_free(ctype);
+
+    /* send the return code */
+    DB_SEND_SUCCESS();
+
+    /* send results */
+    DB_SEND_INT(n_ok);
+    return DB_OK;
+}
+
+/*!
+   \brief Release prepared statement
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_d_close_prepared(void)
+{
+    dbPrepared *prepared;
+    dbToken token;
+    int stat;
+
+    /* get the arg(s) */
+    DB_RECV_TOKEN(&token);
+    prepared = (dbPrepared *)db_find_token(token);
+    if (prepared == NULL) {
+        db_error("** invalid prepared statement **");
+        DB_SEND_FAILURE();
+        return DB_OK;
+    }
+
+    /* call the procedure */
+    stat = DB_OK;
+    if (prepared->data)
+        stat = db_driver_close_prepared(prepared);
+
+    /* get rid of the statement */
+    db_drop_token(token);
+    free_prepared(prepared);
+
+    /* send the return code */
+    if (stat != DB_OK) {
+        DB_SEND_FAILURE();
+        return DB_OK;
+    }
+    DB_SEND_SUCCESS();
+
+    /* no results */
+    return DB_OK;
+}
@@ -26,6 +26,21 @@
 #define DB_DRIVER_C
 #include "dbstubs.h"
 
+/* state of in-process driver, see db_driver_local() */
+static int local_pending = -1;
+static int local_done;
+
+static int find_procedure(int procnum)
+{
+    int i;
+
+    for (i = 0; procedure[i].routine; i++)
+        if (procedure[i].procnum == procnum)
+            break;
+
+    return i;
+}
+
 /*!
    \brief Get driver (?)
 
@@ -144,9 +159,7 @@ int db_driver(int argc, char *argv[])
         db_clear_error();
 
         /* find this procedure */
-        for (i = 0; procedure[i].routine; i++)
-            if (procedure[i].procnum == procnum)
-                break;
+        i = find_procedure(procnum);
 
         /* if found, call it */
         if (procedure[i].routine) {
@@ -163,3 +176,89 @@ int db_driver(int argc, char *argv[])
 
     exit(stat == DB_OK ? 0 : 1);
 }
+
+/*!
+   \brief Process one step of the protocol of in-process driver
+
+   The first step acknowledges the procedure number sent by the
+   client, the second one calls the procedure once the client has sent
+   its arguments.
+
+   \return DB_OK on success
+   \return DB_FAILED on failure (driver is no longer usable)
+ */
+static int local_step(void)
+{
+    int stat;
+    int procnum;
+    int i;
+
+    if (local_done)
+        return DB_FAILED;
+
+    if (local_pending < 0) {
+        /* get the procedure number */
+        if (db__recv_procnum(&procnum) != DB_OK)
+            return DB_FAILED;
+
+        if (procnum == DB_PROC_SHUTDOWN_DRIVER) {
+            db__send_procedure_ok(procnum);
+            db_driver_finish();
+            local_done = 1;
+            return DB_OK;
+        }
+        db_clear_error();
+
+        /* find this procedure */
+        i = find_procedure(procnum);
+        if (procedure[i].routine) {
+            stat = db__send_procedure_ok(procnum);
+            local_pending = i;
+        }
+        else
+            stat = db__send_procedure_not_implemented(procnum);
+    }
+    else {
+        /* arguments are available, call the procedure */
+        i = local_pending;
+        local_pending = -1;
+        stat = (*procedure[i].routine)();
+    }
+
+    if (stat != DB_OK)
+        local_done = 1;
+
+    return stat;
+}
+
+/*!
+   \brief Start driver in the process of the client
+
+   Instead of reading procedure calls from a pipe, the driver is called
+   directly from the client whenever the client waits for a reply (see
+   db_start_driver()). The driver must have set its db_driver_*
+   routines before.
+
+   \param argc, argv arguments
+
+   \return DB_OK on success
+   \return DB_FAILED on failure
+ */
+int db_driver_local(int argc, char *argv[])
+{
+    local_pending = -1;
+    local_done = 0;
+
+    db_clear_error();
+    db__init_driver_state();
+
+    if (db__set_local_driver(local_step) != DB_OK)
+        return DB_FAILED;
+
+    if (db_driver_init(argc, argv) != DB_OK) {
+        db__set_local_driver(NULL);
+        return DB_FAILED;
+    }
+
+    return DB_OK;
+}
@@ -13,7 +13,11 @@ extern int db_d_drop_table(void);
 extern int db_d_execute_immediate(void);
 extern int db_d_begin_transaction(void);
 extern int db_d_commit_transaction(void);
+extern int db_d_prepare(void);
+extern int db_d_execute_prepared(void);
+extern int db_d_close_prepared(void);
 extern int db_d_fetch(void);
+extern int db_d_fetch_batch(void);
 extern int db_d_get_num_rows(void);
 extern int db_d_find_database(void);
 extern int db_d_grant_on_table(void);
@@ -33,6 +37,7 @@ static struct {
     int procnum;
     int (*routine)(void);
 } procedure[] = {{DB_PROC_FETCH, db_d_fetch},
+                 {DB_PROC_FETCH_BATCH, db_d_fetch_batch},
                  {DB_PROC_ROWS, db_d_get_num_rows},
                  {DB_PROC_UPDATE, db_d_update},
                  {DB_PROC_INSERT, db_d_insert},
@@ -40,6 +45,9 @@ static struct {
                  {DB_PROC_EXECUTE_IMMEDIATE, db_d_execute_immediate},
                  {DB_PROC_BEGIN_TRANSACTION, db_d_begin_transaction},
                  {DB_PROC_COMMIT_TRANSACTION, db_d_commit_transaction},
+                 {DB_PROC_PREPARE, db_d_prepare},
+                 {DB_PROC_EXECUTE_PREPARED, db_d_execute_prepared},
+                 {DB_PROC_CLOSE_PREPARED, db_d_close_prepared},
                  {DB_PROC_OPEN_SELECT_CURSOR, db_d_open_select_cursor},
                  {DB_PROC_OPEN_UPDATE_CURSOR, db_d_open_update_cursor},
                  {DB_PROC_BIND_UPDATE, db_d_bind_update},
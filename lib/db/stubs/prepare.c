@@ -0,0 +1,20 @@
+#include <grass/dbmi.h>
+#include <grass/dbstubs.h>
+
+/* Implemented only in some drivers, statements not prepared by the
+   driver are executed with substituted values by db_d_execute_prepared() */
+int db__driver_prepare(dbPrepared *prepared UNUSED)
+{
+    return DB_OK;
+}
+
+int db__driver_execute_prepared(dbPrepared *prepared UNUSED)
+{
+    db_procedure_not_implemented("db_execute_prepared");
+    return DB_FAILED;
+}
+
+int db__driver_close_prepared(dbPrepared *prepared UNUSED)
+{
+    return DB_OK;
+}
@@ -0,0 +1,496 @@
+/*!
+   \file lib/gmath/fft2d.c
+
+   \brief GRASS gmath library - Two dimensional FFT of real data by rows
+   and columns
+
+   The transform of rows x cols real values is computed first along the
+   rows with real-to-complex transforms, which give the cols / 2 + 1
+   nonnegative frequencies of each row (the others follow from Hermitian
+   symmetry), and then along the columns of this half spectrum. The half
+   spectrum is kept in memory or, if it does not fit into the given
+   memory, in a temporary file whose columns are transformed by strips.
+   The transforms of single rows and columns are planned once and
+   executed in parallel.
+
+   If the environment variable GRASS_FFTW_WISDOM names a file, plans are
+   measured instead of estimated and the FFTW wisdom is loaded from and
+   saved to this file, which makes planning of the same sizes fast.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <grass/config.h>
+
+#if defined(HAVE_FFTW3_H) || defined(HAVE_FFTW_H) || defined(HAVE_DFFTW_H)
+
+#if defined(HAVE_FFTW3_H)
+#include <fftw3.h>
+#define c_re(c) ((c)[0])
+#define c_im(c) ((c)[1])
+#elif defined(HAVE_FFTW_H)
+#include <fftw.h>
+#elif defined(HAVE_DFFTW_H)
+#include <dfftw.h>
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <grass/gis.h>
+#include <grass/gmath.h>
+#include <grass/glocale.h>
+
+/* columns transformed by one thread at once */
+#define GROUP 8
+
+struct G_math_fft2d {
+    int rows, cols;        /* size of the real data */
+    int hcols;             /* columns of the half spectrum */
+    int ld;                /* leading dimension of columns in work */
+    int nprocs;            /* number of threads */
+    double norm;           /* scale of the column transforms */
+    fftw_complex *data;    /* half spectrum in memory, NULL if in file */
+    FILE *fp;              /* temporary file with the half spectrum */
+    char *tempfile;        /* name of the temporary file */
+    int strip;             /* columns of a strip read from the file */
+    fftw_complex *buf;     /* strip or rows read from the file */
+    double **real;         /* real row of each thread */
+    fftw_complex **work;   /* complex rows or GROUP columns of each thread */
+    fftw_plan row_forward; /* real-to-complex transform of a row */
+    fftw_plan row_inverse; /* complex-to-real transform of a row */
+    fftw_plan col_forward; /* forward transform of a column */
+    fftw_plan col_inverse; /* inverse transform of a column */
+};
+
+static int thread_num(void)
+{
+#if defined(_OPENMP)
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+static void *work_alloc(size_t size)
+{
+#if defined(HAVE_FFTW3_H)
+    void *p = fftw_malloc(size);
+
+    if (!p)
+        G_fatal_error(_("Out of memory"));
+
+    return p;
+#else
+    return G_malloc(size);
+#endif
+}
+
+static void work_free(void *p)
+{
+#if defined(HAVE_FFTW3_H)
+    fftw_free(p);
+#else
+    G_free(p);
+#endif
+}
+
+static void make_plans(struct G_math_fft2d *F)
+{
+#if defined(HAVE_FFTW3_H)
+    const char *wisdom = getenv("GRASS_FFTW_WISDOM");
+    unsigned flags = FFTW_ESTIMATE;
+
+    if (wisdom && *wisdom) {
+        fftw_import_wisdom_from_filename(wisdom);
+        flags = FFTW_MEASURE;
+    }
+
+    F->row_forward =
+        fftw_plan_dft_r2c_1d(F->cols, F->real[0], F->work[0], flags);
+    F->row_inverse =
+        fftw_plan_dft_c2r_1d(F->cols, F->work[0], F->real[0], flags);
+    F->col_forward = fftw_plan_dft_1d(F->rows, F->work[0], F->work[0],
+                                      FFTW_FORWARD, flags);
+    F->col_inverse = fftw_plan_dft_1d(F->rows, F->work[0], F->work[0],
+                                      FFTW_BACKWARD, flags);
+
+    if (wisdom && *wisdom && !fftw_export_wisdom_to_filename(wisdom))
+        G_warning(_("Unable to write FFTW wisdom to <%s>"), wisdom);
+#else
+    /* no real transforms, rows are transformed as complex data */
+    F->row_forward = fftw_create_plan(F->cols, FFTW_FORWARD, FFTW_ESTIMATE);
+    F->row_inverse = fftw_create_plan(F->cols, FFTW_BACKWARD, FFTW_ESTIMATE);
+    F->col_forward = fftw_create_plan(F->rows, FFTW_FORWARD,
+                                      FFTW_ESTIMATE | FFTW_IN_PLACE);
+    F->col_inverse = fftw_create_plan(F->rows, FFTW_BACKWARD,
+                                      FFTW_ESTIMATE | FFTW_IN_PLACE);
+#endif
+}
+
+/* half spectrum of a real row, work holds at least cols values */
+static void row_forward(const struct G_math_fft2d *F, double *real,
+                        fftw_complex *work)
+{
+#if defined(HAVE_FFTW3_H)
+    fftw_execute_dft_r2c(F->row_forward, real, work);
+#else
+    fftw_complex *in = work + F->cols;
+    int i;
+
+    for (i = 0; i < F->cols; i++) {
+        c_re(in[i]) = real[i];
+        c_im(in[i]) = 0.0;
+    }
+    fftw_one(F->row_forward, in, work);
+#endif
+}
+
+/* real row of a half spectrum, the half spectrum is destroyed */
+static void row_inverse(const struct G_math_fft2d *F, fftw_complex *work,
+                        double *real)
+{
+#if defined(HAVE_FFTW3_H)
+    fftw_execute_dft_c2r(F->row_inverse, work, real);
+#else
+    fftw_complex *out = work + F->cols;
+    int i;
+
+    for (i = F->hcols; i < F->cols; i++) {
+        c_re(work[i]) = c_re(work[F->cols - i]);
+        c_im(work[i]) = -c_im(work[F->cols - i]);
+    }
+    fftw_one(F->row_inverse, work, out);
+    for (i = 0; i < F->cols; i++)
+        real[i] = c_re(out[i]);
+#endif
+}
+
+static void column(const struct G_math_fft2d *F, int i_sign,
+                   fftw_complex *work)
+{
+#if defined(HAVE_FFTW3_H)
+    fftw_execute_dft(i_sign < 0 ? F->col_forward : F->col_inverse, work,
+                     work);
+#else
+    fftw_one(i_sign < 0 ? F->col_forward : F->col_inverse, work, NULL);
+#endif
+}
+
+static void read_rows(struct G_math_fft2d *F, int row, int nrows, int col,
+                      int ncols, fftw_complex *p)
+{
+    int i;
+
+    for (i = 0; i < nrows; i++) {
+        G_fseek(F->fp,
+                ((off_t)(row + i) * F->hcols + col) * sizeof(fftw_complex),
+                SEEK_SET);
+        if (fread(p + (size_t)i * ncols, sizeof(fftw_complex), ncols,
+                  F->fp) != (size_t)ncols)
+            G_fatal_error(_("Unable to read temporary file <%s>"),
+                          F->tempfile);
+    }
+}
+
+static void write_rows(struct G_math_fft2d *F, int row, int nrows, int col,
+                       int ncols, const fftw_complex *p)
+{
+    int i;
+
+    for (i = 0; i < nrows; i++) {
+        G_fseek(F->fp,
+                ((off_t)(row + i) * F->hcols + col) * sizeof(fftw_complex),
+                SEEK_SET);
+        if (fwrite(p + (size_t)i * ncols, sizeof(fftw_complex), ncols,
+                   F->fp) != (size_t)ncols)
+            G_fatal_error(_("Unable to write temporary file <%s>"),
+                          F->tempfile);
+    }
+}
+
+/* rows of the half spectrum in memory or read into buf */
+static fftw_complex *get_block(struct G_math_fft2d *F, int row, int nrows)
+{
+    if (F->data)
+        return F->data + (size_t)row * F->hcols;
+
+    F->buf = G_realloc(F->buf, (size_t)nrows * F->hcols * sizeof(fftw_complex));
+
+    return F->buf;
+}
+
+/*!
+   \brief Create a two-dimensional FFT of real data
+
+   The half spectrum of cols / 2 + 1 complex values per row is kept in
+   memory if it needs at most memory_mb MB, otherwise in a temporary file.
+   Transforms of rows and columns are run by nprocs threads.
+
+   Rows are transformed with G_math_fft2d_forward_rows() and columns with
+   G_math_fft2d_columns() for the forward transform, for the inverse
+   transform the half spectrum is set with G_math_fft2d_put_rows(), then
+   columns and rows are transformed. Like fft2(), the transforms are
+   scaled by 1 / sqrt(rows * cols).
+
+   \param rows number of rows
+   \param cols number of columns
+   \param memory_mb memory in MB for the half spectrum
+   \param nprocs number of threads
+
+   \return pointer to the FFT
+ */
+struct G_math_fft2d *G_math_fft2d_create(int rows, int cols, int memory_mb,
+                                         int nprocs)
+{
+    struct G_math_fft2d *F;
+    size_t size, memory;
+    int i, n;
+
+    F = G_calloc(1, sizeof(struct G_math_fft2d));
+    F->rows = rows;
+    F->cols = cols;
+    F->hcols = cols / 2 + 1;
+    /* keep the alignment of the columns in work */
+    F->ld = (rows + 3) & ~3;
+    F->nprocs = nprocs > 1 ? nprocs : 1;
+    F->norm = 1.0 / sqrt((double)rows * cols);
+
+    size = (size_t)rows * F->hcols * sizeof(fftw_complex);
+    memory = (size_t)(memory_mb > 0 ? memory_mb : 1) << 20;
+    if (size <= memory)
+        F->data = G_malloc(size);
+    else {
+        F->tempfile = G_tempfile();
+        if (!(F->fp = fopen(F->tempfile, "w+b")))
+            G_fatal_error(_("Unable to open temporary file <%s>"),
+                          F->tempfile);
+        F->strip = memory / ((size_t)rows * sizeof(fftw_complex));
+        if (F->strip < GROUP)
+            F->strip = GROUP;
+        G_verbose_message(_("Half spectrum of %.0f MB is kept in a temporary "
+                            "file, columns are transformed by strips of %d"),
+                          (double)size / (1 << 20), F->strip);
+    }
+
+    /* complex work for GROUP columns, or for a complex row without real
+     * transforms */
+    n = GROUP * F->ld > 2 * cols ? GROUP * F->ld : 2 * cols;
+    F->real = G_malloc(F->nprocs * sizeof(double *));
+    F->work = G_malloc(F->nprocs * sizeof(fftw_complex *));
+    for (i = 0; i < F->nprocs; i++) {
+        F->real[i] = work_alloc(cols * sizeof(double));
+        F->work[i] = work_alloc(n * sizeof(fftw_complex));
+    }
+
+    make_plans(F);
+
+    return F;
+}
+
+/*!
+   \brief Destroy a two-dimensional FFT
+
+   The temporary file is removed.
+
+   \param F pointer to the FFT
+ */
+void G_math_fft2d_destroy(struct G_math_fft2d *F)
+{
+    int i;
+
+    fftw_destroy_plan(F->row_forward);
+    fftw_destroy_plan(F->row_inverse);
+    fftw_destroy_plan(F->col_forward);
+    fftw_destroy_plan(F->col_inverse);
+
+    for (i = 0; i < F->nprocs; i++) {
+        work_free(F->real[i]);
+        work_free(F->work[i]);
+    }
+    G_free(F->real);
+    G_free(F->work);
+
+    if (F->fp) {
+        fclose(F->fp);
+        remove(F->tempfile);
+        G_free(F->tempfile);
+    }
+    G_free(F->data);
+    G_free(F->buf);
+    G_free(F);
+}
+
+/*!
+   \brief Transform rows of real data
+
+   \param F pointer to the FFT
+   \param row first row
+   \param nrows number of rows
+   \param in nrows * cols values, row by row
+ */
+void G_math_fft2d_forward_rows(struct G_math_fft2d *F, int row, int nrows,
+                               const double *in)
+{
+    fftw_complex *block = get_block(F, row, nrows);
+    int i;
+
+#pragma omp parallel for num_threads(F->nprocs) if (F->nprocs > 1) \
+    schedule(dynamic)
+    for (i = 0; i < nrows; i++) {
+        int t = thread_num();
+
+        memcpy(F->real[t], in + (size_t)i * F->cols,
+               F->cols * sizeof(double));
+        row_forward(F, F->real[t], F->work[t]);
+        memcpy(block + (size_t)i * F->hcols, F->work[t],
+               F->hcols * sizeof(fftw_complex));
+    }
+
+    if (!F->data)
+        write_rows(F, row, nrows, 0, F->hcols, block);
+}
+
+/*!
+   \brief Transform rows of the half spectrum to real data
+
+   \param F pointer to the FFT
+   \param row first row
+   \param nrows number of rows
+   \param[out] out nrows * cols values, row by row
+ */
+void G_math_fft2d_inverse_rows(struct G_math_fft2d *F, int row, int nrows,
+                               double *out)
+{
+    fftw_complex *block = get_block(F, row, nrows);
+    int i;
+
+    if (!F->data)
+        read_rows(F, row, nrows, 0, F->hcols, block);
+
+#pragma omp parallel for num_threads(F->nprocs) if (F->nprocs > 1) \
+    schedule(dynamic)
+    for (i = 0; i < nrows; i++) {
+        int t = thread_num();
+
+        memcpy(F->work[t], block + (size_t)i * F->hcols,
+               F->hcols * sizeof(fftw_complex));
+        row_inverse(F, F->work[t], F->real[t]);
+        memcpy(out + (size_t)i * F->cols, F->real[t],
+               F->cols * sizeof(double));
+    }
+}
+
+/*!
+   \brief Transform the columns of the half spectrum
+
+   \param F pointer to the FFT
+   \param i_sign direction of transform, -1 is forward, +1 is inverse
+ */
+void G_math_fft2d_columns(struct G_math_fft2d *F, int i_sign)
+{
+    fftw_complex *strip;
+    int col, ncols, stride, ngroups, g;
+
+    if (!F->data)
+        F->buf = G_realloc(F->buf, (size_t)F->rows * F->strip *
+                                       sizeof(fftw_complex));
+
+    for (col = 0; col < F->hcols; col += ncols) {
+        if (F->data) {
+            ncols = F->hcols;
+            stride = F->hcols;
+            strip = F->data;
+        }
+        else {
+            G_percent(col, F->hcols, 10);
+            ncols = F->hcols - col < F->strip ? F->hcols - col : F->strip;
+            stride = ncols;
+            strip = F->buf;
+            read_rows(F, 0, F->rows, col, ncols, strip);
+        }
+        ngroups = (ncols + GROUP - 1) / GROUP;
+
+#pragma omp parallel for num_threads(F->nprocs) if (F->nprocs > 1) \
+    schedule(dynamic)
+        for (g = 0; g < ngroups; g++) {
+            fftw_complex *work = F->work[thread_num()];
+            int c0 = g * GROUP, n = ncols - c0 < GROUP ? ncols - c0 : GROUP;
+            int r, c;
+
+            for (r = 0; r < F->rows; r++) {
+                const fftw_complex *p = strip + (size_t)r * stride + c0;
+
+                for (c = 0; c < n; c++) {
+                    c_re(work[c * F->ld + r]) = c_re(p[c]);
+                    c_im(work[c * F->ld + r]) = c_im(p[c]);
+                }
+            }
+            for (c = 0; c < n; c++)
+                column(F, i_sign, work + c * F->ld);
+            for (r = 0; r < F->rows; r++) {
+                fftw_complex *p = strip + (size_t)r * stride + c0;
+
+                for (c = 0; c < n; c++) {
+                    c_re(p[c]) = c_re(work[c * F->ld + r]) * F->norm;
+                    c_im(p[c]) = c_im(work[c * F->ld + r]) * F->norm;
+                }
+            }
+        }
+
+        if (!F->data)
+            write_rows(F, 0, F->rows, col, ncols, strip);
+    }
+    if (!F->data)
+        G_percent(1, 1, 1);
+}
+
+/*!
+   \brief Set rows of the half spectrum
+
+   \param F pointer to the FFT
+   \param row first row
+   \param nrows number of rows
+   \param in nrows * (cols / 2 + 1) values, row by row
+ */
+void G_math_fft2d_put_rows(struct G_math_fft2d *F, int row, int nrows,
+                           double (*in)[2])
+{
+    if (F->data)
+        memcpy(F->data + (size_t)row * F->hcols, in,
+               (size_t)nrows * F->hcols * sizeof(fftw_complex));
+    else
+        write_rows(F, row, nrows, 0, F->hcols, (fftw_complex *)in);
+}
+
+/*!
+   \brief Get rows of the half spectrum
+
+   The values of the columns cols / 2 + 1 to cols - 1 of row r are the
+   complex conjugates of the values of column cols - c of row
+   (rows - r) % rows.
+
+   \param F pointer to the FFT
+   \param row first row
+   \param nrows number of rows
+   \param[out] out nrows * (cols / 2 + 1) values, row by row
+ */
+void G_math_fft2d_get_rows(struct G_math_fft2d *F, int row, int nrows,
+                           double (*out)[2])
+{
+    if (F->data)
+        memcpy(out, F->data + (size_t)row * F->hcols,
+               (size_t)nrows * F->hcols * sizeof(fftw_complex));
+    else
+        read_rows(F, row, nrows, 0, F->hcols, (fftw_complex *)out);
+}
+
+#endif /* HAVE_FFT */
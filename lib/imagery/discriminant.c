@@ -0,0 +1,165 @@
+/*!
+   \file lib/imagery/discriminant.c
+
+   \brief Imagery library - Gaussian discriminant functions of pixels
+
+   The discriminant functions of classes with normal distributions are
+   evaluated for batches of pixels. Bands are stored as separate arrays
+   (one row per band), the pixels of a batch are processed together in the
+   inner loops, which the compiler can vectorize. The terms of each pixel
+   are added in the same order as by the per pixel classifiers of i.maxlik
+   and i.smap.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <grass/gis.h>
+#include <grass/imagery.h>
+
+/* pixels evaluated together */
+#define BATCH 64
+
+/*!
+   \brief Initialize discriminant functions
+
+   The functions are set with I_set_discriminant().
+
+   \param D discriminant functions
+   \param nbands number of bands
+   \param n number of functions (classes)
+ */
+void I_init_discriminant(struct I_discriminant *D, int nbands, int n)
+{
+    D->nbands = nbands;
+    D->n = n;
+    D->ncoef = nbands * (nbands + 1) / 2;
+    D->cnst = G_calloc(n, sizeof(double));
+    D->mean = G_calloc((size_t)n * nbands, sizeof(double));
+    D->coef = G_calloc((size_t)n * D->ncoef, sizeof(double));
+}
+
+/*!
+   \brief Set a discriminant function
+
+   The function of pixel x is
+   cnst - 0.5 * sum_b d_b^2 inv_bb - sum_{i<j} d_i d_j inv_ij
+   with d = x - mean. The elements inv_ij are taken from the upper triangle
+   of the matrix or, if lower is nonzero, from the lower triangle (inv_ji),
+   which may differ from the upper one by rounding.
+
+   \param D discriminant functions
+   \param k index of the function
+   \param cnst constant term
+   \param mean mean of each band
+   \param inv inverse covariance matrix
+   \param lower use the lower triangle of inv
+ */
+void I_set_discriminant(struct I_discriminant *D, int k, double cnst,
+                        const double *mean, double **inv, int lower)
+{
+    int i, j, nbands = D->nbands;
+    double *a = D->coef + (size_t)k * D->ncoef;
+
+    D->cnst[k] = cnst;
+    for (i = 0; i < nbands; i++) {
+        D->mean[(size_t)k * nbands + i] = mean[i];
+        *a++ = inv[i][i];
+    }
+    for (i = 0; i < nbands - 1; i++)
+        for (j = i + 1; j < nbands; j++)
+            *a++ = lower ? inv[j][i] : inv[i][j];
+}
+
+/*!
+   \brief Free discriminant functions
+
+   \param D discriminant functions
+ */
+void I_free_discriminant(struct I_discriminant *D)
+{
+    G_free(D->cnst);
+    G_free(D->mean);
+    G_free(D->coef);
+    D->cnst = D->mean = D->coef = NULL;
+    D->n = 0;
+}
+
+/*!
+   \brief Allocate work space for I_discriminant_batch()
+
+   Each thread needs its own work space, free it with G_free().
+
+   \param D discriminant functions
+
+   \return work space
+ */
+double *I_alloc_discriminant_work(const struct I_discriminant *D)
+{
+    return G_malloc((size_t)(D->nbands + 2) * BATCH * sizeof(double));
+}
+
+/*!
+   \brief Evaluate all discriminant functions for pixels
+
+   Pixels with NULL values give NaN.
+
+   \param D discriminant functions
+   \param x values of the pixels, x[band][pixel]
+   \param npix number of pixels
+   \param[out] out values of the functions, out[k * npix + pixel]
+   \param work work space from I_alloc_discriminant_work()
+ */
+void I_discriminant_batch(const struct I_discriminant *D, DCELL *const *x,
+                          int npix, double *out, double *work)
+{
+    int nbands = D->nbands;
+    int p0, m, k, b, i, j, q;
+    double *d = work;
+    double *qd = work + (size_t)nbands * BATCH;
+    double *qo = qd + BATCH;
+
+    for (p0 = 0; p0 < npix; p0 += BATCH) {
+        m = npix - p0 < BATCH ? npix - p0 : BATCH;
+
+        for (k = 0; k < D->n; k++) {
+            const double *mean = D->mean + (size_t)k * nbands;
+            const double *a = D->coef + (size_t)k * D->ncoef;
+            double *o = out + (size_t)k * npix + p0;
+            double cnst = D->cnst[k];
+
+            for (q = 0; q < m; q++)
+                qd[q] = qo[q] = 0.0;
+
+            /* squared differences */
+            for (b = 0; b < nbands; b++) {
+                const DCELL *xb = x[b] + p0;
+                double *db = d + (size_t)b * BATCH;
+                double mb = mean[b], ab = *a++;
+
+                for (q = 0; q < m; q++) {
+                    db[q] = xb[q] - mb;
+                    qd[q] += db[q] * db[q] * ab;
+                }
+            }
+
+            /* cross terms */
+            for (i = 0; i < nbands - 1; i++) {
+                const double *di = d + (size_t)i * BATCH;
+
+                for (j = i + 1; j < nbands; j++) {
+                    const double *dj = d + (size_t)j * BATCH;
+                    double aij = *a++;
+
+                    for (q = 0; q < m; q++)
+                        qo[q] += di[q] * dj[q] * aij;
+                }
+            }
+
+            for (q = 0; q < m; q++)
+                o[q] = cnst - 0.5 * qd[q] - qo[q];
+        }
+    }
+}
@@ -428,6 +428,49 @@ void nCorrectGrad(double **N, double lambda, int xNum, int yNum, double deltaX,
     return;
 }
 
+/*----------------------------------------------------------------------------*/
+/* Normal matrix in sparse format */
+
+/* Converts the symmetric band normal matrix N (upper band of width BW) to
+ * a full sparse matrix for the sparse Krylov solvers of gmath. Only a few
+ * elements in each row of the band are nonzero, the wider the band, the
+ * less memory and work for a matrix-vector product compared to the band. */
+G_math_spvector **normalToSparse(double **N, int parNum, int BW)
+{
+    int i, j, first, last, count;
+    double val;
+    G_math_spvector **Nsp;
+    G_math_spvector *v;
+
+    Nsp = G_math_alloc_spmatrix(parNum);
+
+    for (i = 0; i < parNum; i++) {
+        first = i - BW + 1 > 0 ? i - BW + 1 : 0;
+        last = i + BW - 1 < parNum - 1 ? i + BW - 1 : parNum - 1;
+
+        count = 0;
+        for (j = first; j <= last; j++) {
+            val = j < i ? N[j][i - j] : N[i][j - i];
+            if (val != 0.)
+                count++;
+        }
+
+        v = G_math_alloc_spvector(count);
+        count = 0;
+        for (j = first; j <= last; j++) {
+            val = j < i ? N[j][i - j] : N[i][j - i];
+            if (val != 0.) {
+                v->index[count] = j;
+                v->values[count] = val;
+                count++;
+            }
+        }
+        G_math_add_spvector(Nsp, v, i);
+    }
+
+    return Nsp;
+}
+
 /*----------------------------------------------------------------------------*/
 /* Observations estimation */
 
@@ -182,6 +182,8 @@ void nCorrectLapl(double **N,     /* Normal Matrix () */
 void nCorrectGrad(double **N, double lambda, int xNum, int yNum, double deltaX,
                   double deltaY);
 
+G_math_spvector **normalToSparse(double **N, int parNum, int BW);
+
 void obsEstimateBicubic(double **obsV, /*  */
                         double *obsE,  /*  */
                         double *parV,  /*  */
@@ -978,6 +978,77 @@ int GPJ_init_transform(const struct pj_info *info_in,
     return 1;
 }
 
+#if defined(HAVE_PROJ_H) && PROJ_VERSION_MAJOR >= 6
+/* a copied transformation object with its own PROJ context */
+struct trans_copy {
+    struct pj_info info; /* must be first */
+    PJ_CONTEXT *ctx;
+};
+#endif
+
+/**
+ * \brief Copy a transformation object for use in another thread
+ *
+ * PROJ objects can not be used by several threads at the same time.
+ * The copy gets its own PROJ context and can be used by one thread
+ * while the original or other copies are used by other threads.
+ * Copies must be made before the threads are started and freed with
+ * GPJ_free_transform_copy().
+ *
+ * \param info_trans pointer to pj_info struct initialized with
+ *        GPJ_init_transform()
+ *
+ * \return copy of the transformation object
+ * \return NULL if copies are not supported (PROJ < 6) or on failure
+ */
+struct pj_info *GPJ_copy_transform(const struct pj_info *info_trans)
+{
+#if defined(HAVE_PROJ_H) && PROJ_VERSION_MAJOR >= 6
+    struct trans_copy *t;
+
+    if (info_trans->pj == NULL)
+        G_fatal_error(_("No transformation object"));
+
+    t = G_malloc(sizeof(struct trans_copy));
+    t->info = *info_trans;
+    t->ctx = proj_context_create();
+    t->info.pj = proj_clone(t->ctx, info_trans->pj);
+    if (t->info.pj == NULL) {
+        G_warning(_("proj_clone() failed for '%s'"), info_trans->def);
+        proj_context_destroy(t->ctx);
+        G_free(t);
+        return NULL;
+    }
+
+    return &t->info;
+#else
+    G_debug(1, "Copies of transformation objects need PROJ 6+");
+    (void)info_trans;
+
+    return NULL;
+#endif
+}
+
+/**
+ * \brief Free a copy of a transformation object
+ *
+ * \param info_copy copy returned by GPJ_copy_transform()
+ */
+void GPJ_free_transform_copy(struct pj_info *info_copy)
+{
+#if defined(HAVE_PROJ_H) && PROJ_VERSION_MAJOR >= 6
+    struct trans_copy *t = (struct trans_copy *)info_copy;
+
+    if (!t)
+        return;
+    proj_destroy(t->info.pj);
+    proj_context_destroy(t->ctx);
+    G_free(t);
+#else
+    (void)info_copy;
+#endif
+}
+
 /* TODO: rename pj_ to GPJ_ to avoid symbol clash with PROJ lib */
 
 /**
@@ -1210,7 +1281,11 @@ int GPJ_transform(const struct pj_info *info_in, const struct pj_info *info_out,
  * output CRS (PJ_FWD) or from output CRS to input CRS (PJ_INV).
  * The easting, northing, and height of the point are contained in the
  * pointers passed to the function; these will be overwritten by the
- * coordinates of the transformed point.
+ * coordinates of the transformed point. All points are passed to PROJ
+ * at once, points that can not be transformed are set to HUGE_VAL.
+ * Several threads can transform arrays at the same time if each thread
+ * uses its own copy of the transformation object, see
+ * GPJ_copy_transform().
  *
  * \param info_in pointer to pj_info struct for input co-ordinate system
  * \param info_out pointer to pj_info struct for output co-ordinate system
@@ -1231,20 +1306,21 @@ int GPJ_transform_array(const struct pj_info *info_in,
 {
     int ok;
     int i;
-    int has_z = 1;
 
 #ifdef HAVE_PROJ_H
     /* PROJ 5+ variant */
     int in_is_ll, out_is_ll, in_deg2rad, out_rad2deg;
-    PJ_COORD c;
+    double meters_in, meters_out;
 
     if (info_trans->pj == NULL)
         G_fatal_error(_("No transformation object"));
 
+    /* unit factors are local, arrays can be transformed by several threads
+     * with their own transformation objects */
     in_deg2rad = out_rad2deg = 1;
     if (dir == PJ_FWD) {
         /* info_in -> info_out */
-        METERS_in = info_in->meters;
+        meters_in = info_in->meters;
         in_is_ll = !strncmp(info_in->proj, "ll", 2);
 #if PROJ_VERSION_MAJOR >= 6
         /* PROJ 6+: conversion to radians is not always needed:
@@ -1255,7 +1331,7 @@ int GPJ_transform_array(const struct pj_info *info_in,
         }
 #endif
         if (info_out->pj) {
-            METERS_out = info_out->meters;
+            meters_out = info_out->meters;
             out_is_ll = !strncmp(info_out->proj, "ll", 2);
 #if PROJ_VERSION_MAJOR >= 6
             /* PROJ 6+: conversion to radians is not always needed:
@@ -1267,13 +1343,13 @@ int GPJ_transform_array(const struct pj_info *info_in,
 #endif
         }
         else {
-            METERS_out = 1.0;
+            meters_out = 1.0;
             out_is_ll = 1;
         }
     }
     else {
         /* info_out -> info_in */
-        METERS_out = info_in->meters;
+        meters_out = info_in->meters;
         out_is_ll = !strncmp(info_in->proj, "ll", 2);
 #if PROJ_VERSION_MAJOR >= 6
         /* PROJ 6+: conversion to radians is not always needed:
@@ -1284,7 +1360,7 @@ int GPJ_transform_array(const struct pj_info *info_in,
         }
 #endif
         if (info_out->pj) {
-            METERS_in = info_out->meters;
+            meters_in = info_out->meters;
             in_is_ll = !strncmp(info_out->proj, "ll", 2);
 #if PROJ_VERSION_MAJOR >= 6
             /* PROJ 6+: conversion to degrees is not always needed:
@@ -1296,115 +1372,44 @@ int GPJ_transform_array(const struct pj_info *info_in,
 #endif
         }
         else {
-            METERS_in = 1.0;
+            meters_in = 1.0;
             in_is_ll = 1;
         }
     }
 
-    if (z == NULL) {
-        z = G_malloc(sizeof(double) * n);
-        /* they say memset is only guaranteed for chars ;-( */
-        for (i = 0; i < n; i++)
-            z[i] = 0.0;
-        has_z = 0;
-    }
-    ok = 0;
+    /* prepare */
     if (in_is_ll) {
-        c.lpzt.t = 0;
-        if (out_is_ll) {
-            /* what is more costly ?
-             * calling proj_trans for each point
-             * or having three loops over all points ?
-             * proj_trans_array() itself calls proj_trans() in a loop
-             * -> one loop over all points is better than
-             *    three loops over all points
-             */
-            for (i = 0; i < n; i++) {
-                if (in_deg2rad) {
-                    /* convert degrees to radians */
-                    c.lpzt.lam = (*x) / RAD_TO_DEG;
-                    c.lpzt.phi = (*y) / RAD_TO_DEG;
-                }
-                else {
-                    c.lpzt.lam = (*x);
-                    c.lpzt.phi = (*y);
-                }
-                c.lpzt.z = z[i];
-                c = proj_trans(info_trans->pj, dir, c);
-                if ((ok = proj_errno(info_trans->pj)) < 0)
-                    break;
-                if (out_rad2deg) {
-                    /* convert radians to degrees */
-                    x[i] = c.lp.lam * RAD_TO_DEG;
-                    y[i] = c.lp.phi * RAD_TO_DEG;
-                }
-                else {
-                    x[i] = c.lp.lam;
-                    y[i] = c.lp.phi;
-                }
-            }
-        }
-        else {
-            for (i = 0; i < n; i++) {
-                if (in_deg2rad) {
-                    /* convert degrees to radians */
-                    c.lpzt.lam = (*x) / RAD_TO_DEG;
-                    c.lpzt.phi = (*y) / RAD_TO_DEG;
-                }
-                else {
-                    c.lpzt.lam = (*x);
-                    c.lpzt.phi = (*y);
-                }
-                c.lpzt.z = z[i];
-                c = proj_trans(info_trans->pj, dir, c);
-                if ((ok = proj_errno(info_trans->pj)) < 0)
-                    break;
-
-                /* convert to map units */
-                x[i] = c.xy.x / METERS_out;
-                y[i] = c.xy.y / METERS_out;
-            }
-        }
+        if (in_deg2rad)
+            DIVIDE_LOOP(x, y, n, RAD_TO_DEG);
     }
-    else {
-        c.xyzt.t = 0;
+    else
+        MULTIPLY_LOOP(x, y, n, meters_in);
+
+    /* transform all points with one call, points that can not be
+     * transformed are set to HUGE_VAL */
+    proj_errno_reset(info_trans->pj);
+    proj_trans_generic(info_trans->pj, dir, x, sizeof(double), n, y,
+                       sizeof(double), n, z, z ? sizeof(double) : 0,
+                       z ? n : 0, NULL, 0, 0);
+    ok = proj_errno(info_trans->pj);
+
+    /* output */
+    for (i = 0; i < n; i++) {
+        if (x[i] == HUGE_VAL || y[i] == HUGE_VAL)
+            continue;
         if (out_is_ll) {
-            for (i = 0; i < n; i++) {
-                /* convert to meters */
-                c.xyzt.x = x[i] * METERS_in;
-                c.xyzt.y = y[i] * METERS_in;
-                c.xyzt.z = z[i];
-                c = proj_trans(info_trans->pj, dir, c);
-                if ((ok = proj_errno(info_trans->pj)) < 0)
-                    break;
-                if (out_rad2deg) {
-                    /* convert radians to degrees */
-                    x[i] = c.lp.lam * RAD_TO_DEG;
-                    y[i] = c.lp.phi * RAD_TO_DEG;
-                }
-                else {
-                    x[i] = c.lp.lam;
-                    y[i] = c.lp.phi;
-                }
+            if (out_rad2deg) {
+                /* convert radians to degrees */
+                x[i] *= RAD_TO_DEG;
+                y[i] *= RAD_TO_DEG;
             }
         }
         else {
-            for (i = 0; i < n; i++) {
-                /* convert to meters */
-                c.xyzt.x = x[i] * METERS_in;
-                c.xyzt.y = y[i] * METERS_in;
-                c.xyzt.z = z[i];
-                c = proj_trans(info_trans->pj, dir, c);
-                if ((ok = proj_errno(info_trans->pj)) < 0)
-                    break;
-                /* convert to map units */
-                x[i] = c.xy.x / METERS_out;
-                y[i] = c.xy.y / METERS_out;
-            }
+            /* convert to map units */
+            x[i] /= meters_out;
+            y[i] /= meters_out;
         }
     }
-    if (!has_z)
-        G_free(z);
 
     if (ok < 0) {
         G_warning(_("proj_trans() failed: %s"), proj_errno_string(ok));
@@ -1412,6 +1417,7 @@ int GPJ_transform_array(const struct pj_info *info_in,
 #else
     /* PROJ 4 variant */
     const struct pj_info *p_in, *p_out;
+    int has_z = 1;
 
     if (dir == PJ_FWD) {
         p_in = info_in;
@@ -0,0 +1,327 @@
+/*!
+   \file lib/raster/block_cache.c
+
+   \brief Raster library - Random access to a raster map by cached blocks
+
+   The map is divided into blocks of 64 x 64 cells kept in the type of the
+   map. Blocks are read on first access directly from the map and are
+   replaced by the clock (second chance) algorithm when the cache is full.
+   Lookups are thread-safe if the system has POSIX threads. Blocks are
+   loaded under a write lock; lookups of loaded blocks share a read lock
+   and mark their slots as referenced with atomic stores, or take the write
+   lock as well if the compiler has no C11 atomics.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <grass/config.h>
+#ifdef HAVE_PTHREAD_H
+#define _XOPEN_SOURCE 500
+#endif
+
+#include <string.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#if !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define ATOMIC_REF
+#endif
+#endif
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+
+#define L2BDIM 6
+#define BDIM   (1 << (L2BDIM))
+#define HI(i)  ((i) >> (L2BDIM))
+#define LO(i)  ((i) & ((BDIM) - 1))
+
+/* reference bits are set by concurrent lookups under the read lock */
+#ifdef ATOMIC_REF
+typedef atomic_uchar ref_bit;
+
+#define GET_REF(c, s) atomic_load_explicit(&(c)->ref[s], memory_order_relaxed)
+#define SET_REF(c, s, v) \
+    atomic_store_explicit(&(c)->ref[s], (v), memory_order_relaxed)
+#else
+typedef unsigned char ref_bit;
+
+#define GET_REF(c, s)    ((c)->ref[s])
+#define SET_REF(c, s, v) ((c)->ref[s] = (v))
+#endif
+
+struct R_block_cache {
+    int fd;                /* raster map open for reading */
+    RASTER_MAP_TYPE type;  /* type of the map and of the blocks */
+    size_t cell_size;      /* size of a cell */
+    size_t block_size;     /* size of a block */
+    int rows, cols;        /* input window */
+    int nx, ny;            /* number of blocks */
+    int nslots;            /* number of blocks kept in memory */
+    int *slot;             /* slot of each block, -1 if not loaded */
+    int *block;            /* block in each slot, -1 if free */
+    ref_bit *ref;          /* reference bits of the slots */
+    int hand;              /* clock hand */
+    unsigned char *data;   /* blocks of the slots */
+    unsigned char *band;   /* last BDIM rows read from the map */
+    int band_row;          /* block row in band, -1 if none */
+#ifdef HAVE_PTHREAD_H
+    pthread_rwlock_t lock; /* write lock for loading blocks */
+#endif
+};
+
+/*!
+   \brief Open a block cache for random access to a raster map
+
+   The raster map must be open for reading with Rast_open_old() and must
+   not be read otherwise while the cache is in use, rows are read in the
+   current input window when blocks are needed. Closing the cache does not
+   close the map.
+
+   \param fd file descriptor of the raster map
+   \param memory_mb memory for cached blocks in MB, 0 for a default size
+
+   \return pointer to the block cache
+ */
+struct R_block_cache *Rast_open_block_cache(int fd, int memory_mb)
+{
+    struct R_block_cache *c;
+    size_t nblocks, nslots;
+    int i;
+
+    c = G_calloc(1, sizeof(struct R_block_cache));
+    c->fd = fd;
+    c->type = Rast_get_map_type(fd);
+    c->cell_size = Rast_cell_size(c->type);
+    c->block_size = (size_t)BDIM * BDIM * c->cell_size;
+    c->rows = Rast_input_window_rows();
+    c->cols = Rast_input_window_cols();
+    c->nx = (c->cols + BDIM - 1) / BDIM;
+    c->ny = (c->rows + BDIM - 1) / BDIM;
+    nblocks = (size_t)c->nx * c->ny;
+
+    if (memory_mb > 0)
+        nslots = ((size_t)memory_mb << 20) / c->block_size;
+    else
+        nslots = 2 * ((size_t)c->nx + c->ny); /* guess */
+    if (nslots > nblocks)
+        nslots = nblocks;
+    if (nslots < 1)
+        nslots = 1;
+    c->nslots = nslots;
+
+    G_verbose_message(_("%.2f percent of the raster map are kept in memory"),
+                      100.0 * nslots / nblocks);
+
+    c->slot = G_malloc(nblocks * sizeof(int));
+    for (i = 0; (size_t)i < nblocks; i++)
+        c->slot[i] = -1;
+    c->block = G_malloc(nslots * sizeof(int));
+    for (i = 0; i < c->nslots; i++)
+        c->block[i] = -1;
+    c->ref = G_malloc(nslots * sizeof(ref_bit));
+    for (i = 0; i < c->nslots; i++) {
+#ifdef ATOMIC_REF
+        atomic_init(&c->ref[i], 0);
+#else
+        c->ref[i] = 0;
+#endif
+    }
+    c->data = G_malloc(nslots * c->block_size);
+    c->band = G_malloc((size_t)BDIM * c->cols * c->cell_size);
+    c->band_row = -1;
+
+#ifdef HAVE_PTHREAD_H
+    if (pthread_rwlock_init(&c->lock, NULL) != 0)
+        G_fatal_error(_("Unable to initialize lock of block cache"));
+#endif
+
+    return c;
+}
+
+/*!
+   \brief Close a block cache
+
+   \param c block cache
+ */
+void Rast_close_block_cache(struct R_block_cache *c)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_rwlock_destroy(&c->lock);
+#endif
+    G_free(c->slot);
+    G_free(c->block);
+    G_free(c->ref);
+    G_free(c->data);
+    G_free(c->band);
+    G_free(c);
+}
+
+/* read the rows of a block row unless they were read last */
+static void read_band(struct R_block_cache *c, int by)
+{
+    int y, row;
+
+    if (c->band_row == by)
+        return;
+
+    for (y = 0; y < BDIM; y++) {
+        row = by * BDIM + y;
+        if (row >= c->rows)
+            break;
+        Rast_get_row(c->fd, c->band + (size_t)y * c->cols * c->cell_size, row,
+                     c->type);
+    }
+    c->band_row = by;
+}
+
+/* slot not referenced since the clock hand passed it last */
+static int replace_slot(struct R_block_cache *c)
+{
+    int s;
+
+    for (;;) {
+        s = c->hand;
+        if (++c->hand == c->nslots)
+            c->hand = 0;
+        if (c->block[s] < 0 || !GET_REF(c, s))
+            return s;
+        SET_REF(c, s, 0);
+    }
+}
+
+static int load_block(struct R_block_cache *c, int b, int referenced)
+{
+    int s, y, by = b / c->nx, bx = b % c->nx, nrows, ncols;
+    unsigned char *p;
+
+    s = replace_slot(c);
+    if (c->block[s] >= 0)
+        c->slot[c->block[s]] = -1;
+
+    read_band(c, by);
+    nrows = c->rows - by * BDIM < BDIM ? c->rows - by * BDIM : BDIM;
+    ncols = c->cols - bx * BDIM < BDIM ? c->cols - bx * BDIM : BDIM;
+    p = c->data + s * c->block_size;
+    for (y = 0; y < nrows; y++)
+        memcpy(p + (size_t)y * BDIM * c->cell_size,
+               c->band + ((size_t)y * c->cols + bx * BDIM) * c->cell_size,
+               ncols * c->cell_size);
+
+    c->block[s] = b;
+    c->slot[b] = s;
+    SET_REF(c, s, referenced);
+
+    return s;
+}
+
+/* load a missing block, with enough space the other blocks of its row,
+ * which are likely needed next, are loaded as well but not referenced */
+static int load_missing(struct R_block_cache *c, int b)
+{
+    int s, bx, b0;
+
+    s = load_block(c, b, 1);
+
+    if (c->nslots >= 2 * c->nx) {
+        b0 = b - b % c->nx;
+        for (bx = 0; bx < c->nx; bx++) {
+            if (c->slot[b0 + bx] < 0)
+                load_block(c, b0 + bx, 0);
+        }
+        s = c->slot[b];
+    }
+
+    return s;
+}
+
+static DCELL slot_value(const struct R_block_cache *c, int s, int row,
+                        int col)
+{
+    return Rast_get_d_value(c->data + s * c->block_size +
+                                ((size_t)LO(row) * BDIM + LO(col)) *
+                                    c->cell_size,
+                            c->type);
+}
+
+/*!
+   \brief Get a window of cell values from a block cache
+
+   Values are stored row by row in buf, cells outside of the input window
+   are set to NULL. This is faster than getting the values one by one.
+
+   \param c block cache
+   \param row first row
+   \param col first column
+   \param nrows number of rows
+   \param ncols number of columns
+   \param[out] buf nrows * ncols values
+ */
+void Rast_get_block_cache_d_window(struct R_block_cache *c, int row, int col,
+                                   int nrows, int ncols, DCELL *buf)
+{
+    int r, cc, b, s, write_locked = 0;
+    DCELL *p = buf;
+
+#ifdef HAVE_PTHREAD_H
+#ifdef ATOMIC_REF
+    pthread_rwlock_rdlock(&c->lock);
+#else
+    /* reference bits can be set only under the write lock */
+    pthread_rwlock_wrlock(&c->lock);
+    write_locked = 1;
+#endif
+#endif
+
+    for (r = row; r < row + nrows; r++) {
+        for (cc = col; cc < col + ncols; cc++, p++) {
+            if (r < 0 || r >= c->rows || cc < 0 || cc >= c->cols) {
+                Rast_set_d_null_value(p, 1);
+                continue;
+            }
+            b = HI(r) * c->nx + HI(cc);
+            s = c->slot[b];
+            if (s < 0) {
+                if (!write_locked) {
+#ifdef HAVE_PTHREAD_H
+                    pthread_rwlock_unlock(&c->lock);
+                    pthread_rwlock_wrlock(&c->lock);
+#endif
+                    write_locked = 1;
+                    s = c->slot[b];
+                }
+                if (s < 0)
+                    s = load_missing(c, b);
+            }
+            else
+                SET_REF(c, s, 1);
+            *p = slot_value(c, s, r, cc);
+        }
+    }
+
+#ifdef HAVE_PTHREAD_H
+    pthread_rwlock_unlock(&c->lock);
+#endif
+}
+
+/*!
+   \brief Get a cell value from a block cache
+
+   \param c block cache
+   \param row row of the input window
+   \param col column of the input window
+
+   \return cell value, NULL outside of the input window
+ */
+DCELL Rast_get_block_cache_d_value(struct R_block_cache *c, int row, int col)
+{
+    DCELL val;
+
+    Rast_get_block_cache_d_window(c, row, col, 1, 1, &val);
+
+    return val;
+}
@@ -0,0 +1,127 @@
+"""Test of the raster block cache
+
+@copyright 2026 by the GRASS Development Team
+
+@license This program is free software under the GNU General Public License (>=v2).
+Read the file COPYING that comes with GRASS
+for details
+"""
+
+import math
+import random
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+
+from grass.script.core import tempname
+from grass.pygrass import utils  # noqa: F401 (initializes the library)
+
+from grass.lib.gis import DCELL
+from grass.lib.raster import (
+    Rast_close,
+    Rast_close_block_cache,
+    Rast_get_block_cache_d_value,
+    Rast_get_block_cache_d_window,
+    Rast_open_block_cache,
+    Rast_open_old,
+)
+
+# not a multiple of the block size of 64 cells, so that the last blocks of
+# rows and columns are partial
+ROWS = 1000
+COLS = 900
+
+
+def expected(row, col):
+    """Value of the test map at row and col, None outside of the map"""
+    if row < 0 or row >= ROWS or col < 0 or col >= COLS:
+        return None
+    return (row + 1) * 1000 + col + 1
+
+
+class BlockCacheTestCase(TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.map = tempname(10)
+        cls.use_temp_region()
+        cls.runModule("g.region", n=ROWS, s=0, e=COLS, w=0, res=1)
+        cls.runModule(
+            "r.mapcalc", expression=f"{cls.map} = double(row() * 1000 + col())"
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.map)
+
+    def setUp(self):
+        self.fd = Rast_open_old(self.map, "")
+
+    def tearDown(self):
+        Rast_close(self.fd)
+
+    def assertWindow(self, cache, row, col, nrows, ncols):
+        """Window read from the cache has the values of the map"""
+        buf = (DCELL * (nrows * ncols))()
+        Rast_get_block_cache_d_window(cache, row, col, nrows, ncols, buf)
+        for r in range(nrows):
+            for c in range(ncols):
+                value = buf[r * ncols + c]
+                ref = expected(row + r, col + c)
+                if ref is None:
+                    self.assertTrue(math.isnan(value), (row + r, col + c))
+                else:
+                    self.assertEqual(value, ref, (row + r, col + c))
+
+    def test_window_block_edges(self):
+        """Windows crossing edges of blocks and of the map"""
+        cache = Rast_open_block_cache(self.fd, 0)
+        try:
+            # inside of one block, across two and four blocks
+            self.assertWindow(cache, 10, 10, 5, 5)
+            self.assertWindow(cache, 60, 10, 8, 5)
+            self.assertWindow(cache, 10, 60, 5, 8)
+            self.assertWindow(cache, 60, 60, 8, 8)
+            # larger than a block
+            self.assertWindow(cache, 100, 100, 70, 130)
+            # partial blocks at the end of rows and columns
+            self.assertWindow(cache, ROWS - 5, COLS - 5, 5, 5)
+            # partly outside of the map
+            self.assertWindow(cache, -3, -3, 6, 6)
+            self.assertWindow(cache, ROWS - 3, COLS - 3, 6, 6)
+            # completely outside
+            self.assertWindow(cache, ROWS + 10, 0, 2, 2)
+        finally:
+            Rast_close_block_cache(cache)
+
+    def test_eviction(self):
+        """Random access with a cache smaller than the map
+
+        With 1 MB the cache keeps 32 of the 240 blocks of the map, so blocks
+        are replaced and read again.
+        """
+        cache = Rast_open_block_cache(self.fd, 1)
+        rng = random.Random(1)
+        try:
+            for _ in range(5000):
+                row = rng.randrange(ROWS)
+                col = rng.randrange(COLS)
+                self.assertEqual(
+                    Rast_get_block_cache_d_value(cache, row, col),
+                    expected(row, col),
+                    (row, col),
+                )
+            # row by row, as r.proj and i.rectify read
+            for row in range(0, ROWS, 7):
+                self.assertWindow(cache, row, 0, 1, COLS)
+            # windows after the cache was filled
+            for _ in range(200):
+                row = rng.randrange(-2, ROWS)
+                col = rng.randrange(-2, COLS)
+                self.assertWindow(cache, row, col, 4, 4)
+        finally:
+            Rast_close_block_cache(cache)
+
+
+if __name__ == "__main__":
+    test()
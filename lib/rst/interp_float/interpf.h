@@ -178,6 +178,7 @@ int IL_matrix_create(struct interp_params *, struct triple *, int, double **,
                      int *);
 int IL_matrix_create_alloc(struct interp_params *, struct triple *, int,
                            double **, int *, double *);
+int IL_matrix_cv_errors(int, double **, int *, double *, double *, double *);
 /* minmax.c */
 int min1(int, int);
 int max1(int, int);
@@ -234,6 +235,10 @@ int IL_interp_segments_2d_parallel(struct interp_params *, struct tree_info *,
                                    double, double *, double *, double *,
                                    double *, double *, double *, double *,
                                    double *, double *, int, off_t, double, int);
+int IL_cv_sweep_2d_parallel(struct interp_params *, struct tree_info *,
+                            struct multtree *, int, double, int,
+                            const double *, int, const double *, double *,
+                            double *, int *, int);
 /* vinput2d.c */
 int IL_vector_input_data_2d(struct interp_params *, struct Map_info *, int,
                             char *, char *, struct tree_info *, double *,
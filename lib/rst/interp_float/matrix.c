@@ -180,3 +180,41 @@ int IL_matrix_create_alloc(struct interp_params *params,
     /* G_free_vector(A); */
     return 1;
 }
+
+/*!
+ * \brief Computes leave-one-out cross-validation errors
+ *
+ * The error at a point is the value interpolated at the point by the
+ * system of all other points minus the value at the point. The errors
+ * of all points are computed from the system of all points (Rippa
+ * 1999), which is equal to but much faster than solving the system
+ * again for each point left out.
+ *
+ * \param n_points number of points
+ * \param matrix LU decomposition of the matrix of all points created by
+ * IL_matrix_create_alloc()
+ * \param indx permutation of the LU decomposition
+ * \param b solution of the system of all points
+ * \param work vector with n_points + 1 elements
+ * \param[out] err errors at points
+ *
+ * \return -1 on failure, 1 on success
+ */
+int IL_matrix_cv_errors(int n_points, double **matrix, int *indx, double *b,
+                        double *work, double *err)
+{
+    int i, j;
+
+    for (i = 1; i <= n_points; i++) {
+        /* diagonal element of the inverse matrix */
+        for (j = 0; j <= n_points; j++)
+            work[j] = 0.;
+        work[i] = 1.;
+        G_lubksb(matrix, n_points + 1, indx, work);
+        if (work[i] == 0.)
+            return -1;
+        err[i - 1] = -b[i] / work[i];
+    }
+
+    return 1;
+}
@@ -22,6 +22,15 @@
 #include <grass/interpf.h>
 #include <grass/gmath.h>
 
+/* free vectors of cross-validation errors of one segment */
+static void free_cv(double *cv_err, double *cv_work)
+{
+    if (cv_err)
+        G_free_vector(cv_err);
+    if (cv_work)
+        G_free_vector(cv_work);
+}
+
 /*!
  * Interpolate recursively a tree of segments
  *
@@ -72,7 +81,7 @@ int IL_interp_segments_2d(
     double pr;
     struct triple *point = NULL;
     struct triple skip_point;
-    int m_skip, skip_index, j, k, segtest;
+    double *cv_err = NULL, *cv_work = NULL;
     double xx, yy /*, zz */;
 
     /* find the size of the smallest segment once */
@@ -209,6 +218,8 @@ int IL_interp_segments_2d(
         }
         /* allocate memory for CV points only if cv is performed */
         if (params->cv) {
+            cv_err = G_alloc_vector(data->n_points);
+            cv_work = G_alloc_vector(data->n_points + 1);
             if (!(point = (struct triple *)G_malloc(sizeof(struct triple) *
                                                     data->n_points))) {
                 G_warning(_("Out of memory"));
@@ -237,76 +248,50 @@ int IL_interp_segments_2d(
              */
         }
 
-        /* cv stuff */
-        if (params->cv)
-            m_skip = data->n_points;
-        else
-            m_skip = 1;
-
-        /* remove after cleanup - this is just for testing */
-        skip_point.x = 0.;
-        skip_point.y = 0.;
-        skip_point.z = 0.;
+        if (params->matrix_create(params, data->points, data->n_points, matrix,
+                                  indx) < 0) {
+            G_free(point);
+            free_cv(cv_err, cv_work);
+            return -1;
+        }
+        for (i = 0; i < data->n_points; i++)
+            b[i + 1] = data->points[i].z;
+        b[0] = 0.;
+        G_lubksb(matrix, data->n_points + 1, indx, b);
 
-        /*** TODO: parallelize this loop instead of the LU solver! ***/
-        for (skip_index = 0; skip_index < m_skip; skip_index++) {
-            if (params->cv) {
-                segtest = 0;
-                j = 0;
-                xx =
-                    point[skip_index].x * dnorm + data->x_orig + params->x_orig;
-                yy =
-                    point[skip_index].y * dnorm + data->y_orig + params->y_orig;
-                /* zz = point[skip_index].z; */
+        if (!params->cv) {
+            /* put here condition to skip error if not needed */
+            skip_point.x = 0.;
+            skip_point.y = 0.;
+            skip_point.z = 0.;
+            params->check_points(params, data, b, ertot, zmin, dnorm,
+                                 &skip_point);
+        }
+        else {
+            /* errors of all points from one solution, see
+             * IL_matrix_cv_errors() */
+            if (IL_matrix_cv_errors(data->n_points, matrix, indx, b, cv_work,
+                                    cv_err) < 0) {
+                G_free(point);
+                free_cv(cv_err, cv_work);
+                return -1;
+            }
+            for (i = 0; i < data->n_points; i++) {
+                xx = point[i].x * dnorm + data->x_orig + params->x_orig;
+                yy = point[i].y * dnorm + data->y_orig + params->y_orig;
                 if (xx >= data->x_orig + params->x_orig &&
                     xx <= data->xmax + params->x_orig &&
                     yy >= data->y_orig + params->y_orig &&
                     yy <= data->ymax + params->y_orig) {
-                    segtest = 1;
-                    skip_point.x = point[skip_index].x;
-                    skip_point.y = point[skip_index].y;
-                    skip_point.z = point[skip_index].z;
-                    for (k = 0; k < m_skip; k++) {
-                        if (k != skip_index && params->cv) {
-                            data->points[j].x = point[k].x;
-                            data->points[j].y = point[k].y;
-                            data->points[j].z = point[k].z;
-                            j++;
-                        }
-                    }
-                } /* segment area test */
-            }
-            if (!params->cv) {
-                if (params->matrix_create(params, data->points, data->n_points,
-                                          matrix, indx) < 0)
-                    return -1;
-            }
-            else if (segtest == 1) {
-                if (params->matrix_create(params, data->points,
-                                          data->n_points - 1, matrix,
-                                          indx) < 0) {
-                    G_free(point);
-                    return -1;
+                    skip_point.x = xx;
+                    skip_point.y = yy;
+                    skip_point.z = point[i].z + zmin;
+                    IL_write_point_2d(skip_point, cv_err[i]);
+                    (*ertot) += cv_err[i] * cv_err[i];
                 }
             }
-            if (!params->cv) {
-                for (i = 0; i < data->n_points; i++)
-                    b[i + 1] = data->points[i].z;
-                b[0] = 0.;
-                G_lubksb(matrix, data->n_points + 1, indx, b);
-                /* put here condition to skip error if not needed */
-                params->check_points(params, data, b, ertot, zmin, dnorm,
-                                     &skip_point);
-            }
-            else if (segtest == 1) {
-                for (i = 0; i < data->n_points - 1; i++)
-                    b[i + 1] = data->points[i].z;
-                b[0] = 0.;
-                G_lubksb(matrix, data->n_points, indx, b);
-                params->check_points(params, data, b, ertot, zmin, dnorm,
-                                     &skip_point);
-            }
-        } /*end of cv loop */
+            free_cv(cv_err, cv_work);
+        }
 
         if (!params->cv)
             if ((params->Tmp_fd_z != NULL) || (params->Tmp_fd_dx != NULL) ||
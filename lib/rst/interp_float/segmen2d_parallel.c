@@ -29,9 +29,158 @@
 
 static int cut_tree(struct multtree *, struct multtree **, int *);
 
+/*
+ * Finds points for interpolation of a segment: the segment window is
+ * enlarged or shrunk until it contains the number of points derived
+ * from the segment size. Returns new data with the points normalized
+ * by dnorm, NULL if the segment has no points.
+ */
+static struct quaddata *segment_data(struct interp_params *params,
+                                     struct tree_info *info,
+                                     struct multtree *tree,
+                                     struct multtree *leaf, double smseg,
+                                     double dnorm)
+{
+    struct quaddata *leaf_data = (struct quaddata *)leaf->data;
+    struct quaddata *data;
+    double xmn, xmx, ymn, ymx, distx, disty, distxp, distyp, temp1, temp2;
+    double ew_res, ns_res, pr;
+    int i, npt, MAXENC, MINPTS;
+
+    if (leaf_data->points == NULL)
+        return NULL;
+
+    ns_res = (((struct quaddata *)(tree->data))->ymax -
+              ((struct quaddata *)(tree->data))->y_orig) /
+             params->nsizr;
+    ew_res = (((struct quaddata *)(tree->data))->xmax -
+              ((struct quaddata *)(tree->data))->x_orig) /
+             params->nsizc;
+
+    distx = (leaf_data->n_cols * ew_res) * 0.1;
+    disty = (leaf_data->n_rows * ns_res) * 0.1;
+    distxp = 0;
+    distyp = 0;
+    xmn = leaf_data->x_orig;
+    xmx = leaf_data->xmax;
+    ymn = leaf_data->y_orig;
+    ymx = leaf_data->ymax;
+    i = 0;
+    MAXENC = 0;
+    /* data is a window with zero points; some fields don't make
+       sense in this case so they are zero (like
+       resolution,dimensions */
+    /* CHANGE */
+    /* Calcutaing kmin for surrent segment (depends on the size) */
+
+    /*****if (smseg <= 0.00001) MINPTS=params->kmin; else {} ***/
+    pr = pow(2., (xmx - xmn) / smseg - 1.);
+    MINPTS = params->kmin * (pr / (1 + params->kmin * pr / params->KMAX2));
+    /* fprintf(stderr,"MINPTS=%d, KMIN=%d, KMAX=%d, pr=%lf,
+     * smseg=%lf, DX=%lf \n",
+     * MINPTS,params->kmin,params->KMAX2,pr,smseg,xmx-xmn); */
+
+    data = (struct quaddata *)quad_data_new(xmn - distx, ymn - disty,
+                                            xmx + distx, ymx + disty, 0, 0, 0,
+                                            params->KMAX2);
+    npt = MT_region_data(info, tree, data, params->KMAX2, 4);
+
+    while ((npt < MINPTS) || (npt > params->KMAX2)) {
+        if (i >= 70) {
+            G_warning(_("Taking too long to find points for "
+                        "interpolation - "
+                        "please change the region to area where "
+                        "your points are. "
+                        "Continuing calculations..."));
+            break;
+        }
+        i++;
+        if (npt > params->KMAX2)
+        /* decrease window */
+        {
+            MAXENC = 1;
+            temp1 = distxp;
+            distxp = distx;
+            distx = distxp - fabs(distx - temp1) * 0.5;
+            temp2 = distyp;
+            distyp = disty;
+            disty = distyp - fabs(disty - temp2) * 0.5;
+            /* decrease by 50% of a previous change in window */
+        }
+        else {
+            temp1 = distyp;
+            distyp = disty;
+            temp2 = distxp;
+            distxp = distx;
+            if (MAXENC) {
+                disty = fabs(disty - temp1) * 0.5 + distyp;
+                distx = fabs(distx - temp2) * 0.5 + distxp;
+            }
+            else {
+                distx += distx;
+                disty += disty;
+            }
+            /* decrease by 50% of extra distance */
+        }
+        data->x_orig = xmn - distx; /* update window */
+        data->y_orig = ymn - disty;
+        data->xmax = xmx + distx;
+        data->ymax = ymx + disty;
+        data->n_points = 0;
+        npt = MT_region_data(info, tree, data, params->KMAX2, 4);
+    }
+
+    data->n_rows = leaf_data->n_rows;
+    data->n_cols = leaf_data->n_cols;
+
+    /* for printing out overlapping segments */
+    leaf_data->x_orig = xmn - distx;
+    leaf_data->y_orig = ymn - disty;
+    leaf_data->xmax = xmx + distx;
+    leaf_data->ymax = ymx + disty;
+
+    data->x_orig = xmn;
+    data->y_orig = ymn;
+    data->xmax = xmx;
+    data->ymax = ymx;
+
+    /*normalize the data so that the side of average segment is
+     * about 1m */
+    for (i = 0; i < data->n_points; i++) {
+        data->points[i].x = (data->points[i].x - data->x_orig) / dnorm;
+        data->points[i].y = (data->points[i].y - data->y_orig) / dnorm;
+
+        /* commented out by Helena january 1997 as this is not
+           necessary although it may be useful to put normalization
+           of z back? data->points[i].z = data->points[i].z / dnorm;
+           this made smoothing self-adjusting  based on dnorm
+           if (params->rsm < 0.) data->points[i].sm =
+           data->points[i].sm / dnorm;
+         */
+    }
+
+    return data;
+}
+
+/* is the point of the segment inside of the segment (not in overlap) */
+static int inside_segment(struct interp_params *params, struct quaddata *data,
+                          struct triple *point, double dnorm)
+{
+    double xx = point->x * dnorm + data->x_orig + params->x_orig;
+    double yy = point->y * dnorm + data->y_orig + params->y_orig;
+
+    return xx >= data->x_orig + params->x_orig &&
+           xx <= data->xmax + params->x_orig &&
+           yy >= data->y_orig + params->y_orig &&
+           yy <= data->ymax + params->y_orig;
+}
+
 /*!
  * See documentation for IL_interp_segments_2d.
  * This is a parallel processing implementation.
+ *
+ * Cross-validation errors of all points of a segment are computed from
+ * one solution of the segment system, see IL_matrix_cv_errors().
  */
 int IL_interp_segments_2d_parallel(
     struct interp_params *params,
@@ -51,7 +200,6 @@ int IL_interp_segments_2d_parallel(
     int some_thread_failed = 0;
     int tid = 0;
     int i = 0;
-    int j = 0;
     int i_cnt;
     int cursegm = 0;
     double smseg;
@@ -59,6 +207,8 @@ int IL_interp_segments_2d_parallel(
     int **indx = NULL;
     double **b = NULL;
     double **A = NULL;
+    double **cv_err = NULL;
+    double *ertot_thread = NULL;
     struct quaddata **data_local;
     struct multtree **all_leafs;
 
@@ -70,6 +220,9 @@ int IL_interp_segments_2d_parallel(
     indx = (int **)G_malloc(sizeof(int *) * threads);
     b = (double **)G_malloc(sizeof(double *) * threads);
     A = (double **)G_malloc(sizeof(double *) * threads);
+    cv_err = (double **)G_calloc(threads, sizeof(double *));
+    /* errors of each thread, summed after the parallel region */
+    ertot_thread = (double *)G_calloc(threads, sizeof(double));
 
     for (i_cnt = 0; i_cnt < threads; i_cnt++) {
         if (!(matrix[i_cnt] =
@@ -101,13 +254,20 @@ int IL_interp_segments_2d_parallel(
         }
     }
 
+    /* errors and work vector for cross-validation */
+    if (params->cv) {
+        for (i_cnt = 0; i_cnt < threads; i_cnt++)
+            cv_err[i_cnt] = G_alloc_vector(2 * (params->KMAX2 + 2));
+    }
+
     smseg = smallest_segment(tree, 4);
     cut_tree(tree, all_leafs, &i);
 
     G_message(_("Starting parallel work"));
-#pragma omp parallel firstprivate(                                            \
-        tid, i, j, zmin, zmax, tree, totsegm, offset1, dnorm, smseg, ertot,   \
-            params, info, all_leafs, bitmask, b, indx, matrix, data_local, A) \
+#pragma omp parallel firstprivate(tid, i, zmin, zmax, tree, totsegm, offset1, \
+                                      dnorm, smseg, ertot, params, info,      \
+                                      all_leafs, bitmask, b, indx, matrix,    \
+                                      data_local, A, cv_err, ertot_thread)    \
     shared(cursegm, threads, some_thread_failed, zminac, zmaxac, gmin, gmax,  \
                c1min, c1max, c2min, c2max) default(none)
     {
@@ -118,26 +278,9 @@ int IL_interp_segments_2d_parallel(
             tid = omp_get_thread_num();
 #endif
 
-            double xmn, xmx, ymn, ymx, distx, disty, distxp, distyp, temp1,
-                temp2;
-            int npt, MAXENC;
-            double ew_res, ns_res;
-            int MINPTS;
-            double pr;
-            struct triple *point;
             struct triple target_point;
-            int npoints, point_index, k;
-            double xx, yy /*, zz */;
-            double xmm, ymm, err, pointz;
-
-            // struct quaddata *data_local;
-
-            ns_res = (((struct quaddata *)(tree->data))->ymax -
-                      ((struct quaddata *)(tree->data))->y_orig) /
-                     params->nsizr;
-            ew_res = (((struct quaddata *)(tree->data))->xmax -
-                      ((struct quaddata *)(tree->data))->x_orig) /
-                     params->nsizc;
+            int npoints, point_index, inside;
+            double err, pointz;
 
             if (all_leafs[i_cnt] == NULL) {
                 some_thread_failed = -1;
@@ -147,316 +290,146 @@ int IL_interp_segments_2d_parallel(
                 some_thread_failed = -1;
                 continue;
             }
-            if (((struct quaddata *)(all_leafs[i_cnt]->data))->points == NULL) {
+
+            data_local[tid] = segment_data(params, info, tree,
+                                           all_leafs[i_cnt], smseg, dnorm);
+            if (data_local[tid] == NULL)
                 continue;
+
+            if (totsegm != 0 && tid == 0) {
+                G_percent(cursegm, totsegm, 1);
             }
-            else {
-                distx = (((struct quaddata *)(all_leafs[i_cnt]->data))->n_cols *
-                         ew_res) *
-                        0.1;
-                disty = (((struct quaddata *)(all_leafs[i_cnt]->data))->n_rows *
-                         ns_res) *
-                        0.1;
-                distxp = 0;
-                distyp = 0;
-                xmn = ((struct quaddata *)(all_leafs[i_cnt]->data))->x_orig;
-                xmx = ((struct quaddata *)(all_leafs[i_cnt]->data))->xmax;
-                ymn = ((struct quaddata *)(all_leafs[i_cnt]->data))->y_orig;
-                ymx = ((struct quaddata *)(all_leafs[i_cnt]->data))->ymax;
-                i = 0;
-                MAXENC = 0;
-                /* data is a window with zero points; some fields don't make
-                   sense in this case so they are zero (like
-                   resolution,dimensions */
-                /* CHANGE */
-                /* Calcutaing kmin for surrent segment (depends on the size) */
-
-                /*****if (smseg <= 0.00001) MINPTS=params->kmin; else {} ***/
-                pr = pow(2., (xmx - xmn) / smseg - 1.);
-                MINPTS = params->kmin *
-                         (pr / (1 + params->kmin * pr / params->KMAX2));
-                /* fprintf(stderr,"MINPTS=%d, KMIN=%d, KMAX=%d, pr=%lf,
-                 * smseg=%lf, DX=%lf \n",
-                 * MINPTS,params->kmin,params->KMAX2,pr,smseg,xmx-xmn); */
-
-                data_local[tid] = (struct quaddata *)quad_data_new(
-                    xmn - distx, ymn - disty, xmx + distx, ymx + disty, 0, 0, 0,
-                    params->KMAX2);
-                npt = MT_region_data(info, tree, data_local[tid], params->KMAX2,
-                                     4);
-
-                while ((npt < MINPTS) || (npt > params->KMAX2)) {
-                    if (i >= 70) {
-                        G_warning(_("Taking too long to find points for "
-                                    "interpolation - "
-                                    "please change the region to area where "
-                                    "your points are. "
-                                    "Continuing calculations..."));
-                        break;
-                    }
-                    i++;
-                    if (npt > params->KMAX2)
-                    /* decrease window */
-                    {
-                        MAXENC = 1;
-                        temp1 = distxp;
-                        distxp = distx;
-                        distx = distxp - fabs(distx - temp1) * 0.5;
-                        temp2 = distyp;
-                        distyp = disty;
-                        disty = distyp - fabs(disty - temp2) * 0.5;
-                        /* decrease by 50% of a previous change in window */
-                    }
-                    else {
-                        temp1 = distyp;
-                        distyp = disty;
-                        temp2 = distxp;
-                        distxp = distx;
-                        if (MAXENC) {
-                            disty = fabs(disty - temp1) * 0.5 + distyp;
-                            distx = fabs(distx - temp2) * 0.5 + distxp;
-                        }
-                        else {
-                            distx += distx;
-                            disty += disty;
-                        }
-                        /* decrease by 50% of extra distance */
-                    }
-                    data_local[tid]->x_orig = xmn - distx; /* update window */
-                    data_local[tid]->y_orig = ymn - disty;
-                    data_local[tid]->xmax = xmx + distx;
-                    data_local[tid]->ymax = ymx + disty;
-                    data_local[tid]->n_points = 0;
-                    npt = MT_region_data(info, tree, data_local[tid],
-                                         params->KMAX2, 4);
-                }
 
-                if (totsegm != 0 && tid == 0) {
-                    G_percent(cursegm, totsegm, 1);
-                }
-                data_local[tid]->n_rows =
-                    ((struct quaddata *)(all_leafs[i_cnt]->data))->n_rows;
-                data_local[tid]->n_cols =
-                    ((struct quaddata *)(all_leafs[i_cnt]->data))->n_cols;
-
-                /* for printing out overlapping segments */
-                ((struct quaddata *)(all_leafs[i_cnt]->data))->x_orig =
-                    xmn - distx;
-                ((struct quaddata *)(all_leafs[i_cnt]->data))->y_orig =
-                    ymn - disty;
-                ((struct quaddata *)(all_leafs[i_cnt]->data))->xmax =
-                    xmx + distx;
-                ((struct quaddata *)(all_leafs[i_cnt]->data))->ymax =
-                    ymx + disty;
-
-                data_local[tid]->x_orig = xmn;
-                data_local[tid]->y_orig = ymn;
-                data_local[tid]->xmax = xmx;
-                data_local[tid]->ymax = ymx;
-
-                /* allocate memory for CV points only if cv is performed */
-                if (params->cv) {
-                    if (!(point = (struct triple *)G_malloc(
-                              sizeof(struct triple) *
-                              data_local[tid]->n_points))) {
-                        G_warning(_("Out of memory"));
-                        some_thread_failed = -1;
-                        continue;
-                    }
-                }
+            target_point.x = 0;
+            target_point.y = 0;
+            target_point.z = 0;
 
-                /*normalize the data so that the side of average segment is
-                 * about 1m */
-                /* put data_points into point only if CV is performed */
-
-                for (i = 0; i < data_local[tid]->n_points; i++) {
-                    data_local[tid]->points[i].x =
-                        (data_local[tid]->points[i].x -
-                         data_local[tid]->x_orig) /
-                        dnorm;
-                    data_local[tid]->points[i].y =
-                        (data_local[tid]->points[i].y -
-                         data_local[tid]->y_orig) /
-                        dnorm;
-                    if (params->cv) {
-                        point[i].x = data_local[tid]->points[i].x; /*cv stuff */
-                        point[i].y = data_local[tid]->points[i].y; /*cv stuff */
-                        point[i].z = data_local[tid]->points[i].z; /*cv stuff */
-                    }
+            if (/* params */
+                IL_matrix_create_alloc(params, data_local[tid]->points,
+                                       data_local[tid]->n_points, matrix[tid],
+                                       indx[tid], A[tid]) < 0) {
+                some_thread_failed = -1;
+                G_free(data_local[tid]->points);
+                G_free(data_local[tid]);
+                continue;
+            }
 
-                    /* commented out by Helena january 1997 as this is not
-                       necessary although it may be useful to put normalization
-                       of z back? data->points[i].z = data->points[i].z / dnorm;
-                       this made smoothing self-adjusting  based on dnorm
-                       if (params->rsm < 0.) data->points[i].sm =
-                       data->points[i].sm / dnorm;
-                     */
-                }
+            for (i = 0; i < data_local[tid]->n_points; i++) {
+                b[tid][i + 1] = data_local[tid]->points[i].z;
+            }
+            b[tid][0] = 0.;
+            G_lubksb(matrix[tid], data_local[tid]->n_points + 1, indx[tid],
+                     b[tid]);
+            /* put here condition to skip error if not needed */
+
+            /* one time interpolation */
+            if (!params->cv && !params->create_devi) {
+                params->check_points(params, data_local[tid], b[tid],
+                                     &ertot_thread[tid], zmin, dnorm,
+                                     &target_point);
+            }
 
-                target_point.x = 0;
-                target_point.y = 0;
-                target_point.z = 0;
-
-                /* one time interpolation and devi */
-                if (!params->cv) {
-                    if (/* params */
-                        IL_matrix_create_alloc(params, data_local[tid]->points,
-                                               data_local[tid]->n_points,
-                                               matrix[tid], indx[tid],
-                                               A[tid]) < 0) {
-                        some_thread_failed = -1;
-                        continue;
-                    }
+            if (params->cv &&
+                IL_matrix_cv_errors(data_local[tid]->n_points, matrix[tid],
+                                    indx[tid], b[tid],
+                                    cv_err[tid] + params->KMAX2 + 2,
+                                    cv_err[tid]) < 0) {
+                some_thread_failed = -1;
+                G_free(data_local[tid]->points);
+                G_free(data_local[tid]);
+                continue;
+            }
 
-                    for (i = 0; i < data_local[tid]->n_points; i++) {
-                        b[tid][i + 1] = data_local[tid]->points[i].z;
-                    }
-                    b[tid][0] = 0.;
-                    G_lubksb(matrix[tid], data_local[tid]->n_points + 1,
-                             indx[tid], b[tid]);
-                    /* put here condition to skip error if not needed */
-
-                    if (!params->create_devi) { /* check_points only for one
-                                                   time interpolation */
-                        params->check_points(params, data_local[tid], b[tid],
-                                             ertot, zmin, dnorm, &target_point);
-                    }
+            npoints = (params->cv || params->create_devi)
+                          ? data_local[tid]->n_points
+                          : 0;
+            for (point_index = 0; point_index < npoints;
+                 point_index++) { /* loop only for cv or devi*/
+                target_point = data_local[tid]->points[point_index];
+                inside = inside_segment(params, data_local[tid],
+                                        &target_point, dnorm);
+
+                /* x, y, z is required input, while xmm, ymm, err output*/
+                pointz = target_point.z;
+                if (params->cv) {
+                    /* only points inside of the segment are validated */
+                    if (!inside)
+                        continue;
+                    err = cv_err[tid][point_index];
+                    ertot_thread[tid] += err * err;
+                    target_point.x = target_point.x * dnorm + params->x_orig +
+                                     data_local[tid]->x_orig;
+                    target_point.y = target_point.y * dnorm + params->y_orig +
+                                     data_local[tid]->y_orig;
                 }
+                else {
+                    params->check_points(params, data_local[tid], b[tid],
+                                         &ertot_thread[tid], zmin, dnorm,
+                                         &target_point);
+                    err = target_point.z;
+                }
+                target_point.z = pointz + zmin;
 
-                npoints = (params->cv || params->create_devi)
-                              ? data_local[tid]->n_points
-                              : 0;
-                for (point_index = 0; point_index < npoints;
-                     point_index++) { /* loop only for cv or devi*/
-                    if (params->cv) { /* cv: skip one point */
-                        /* skip point for cv */
-                        target_point.x = point[point_index].x;
-                        target_point.y = point[point_index].y;
-                        target_point.z = point[point_index].z;
-
-                        xx = target_point.x * dnorm + data_local[tid]->x_orig +
-                             params->x_orig;
-                        yy = target_point.y * dnorm + data_local[tid]->y_orig +
-                             params->y_orig;
-                        /* zz = point[point_index].z; */
-
-                        if (xx >= data_local[tid]->x_orig + params->x_orig &&
-                            xx <= data_local[tid]->xmax + params->x_orig &&
-                            yy >= data_local[tid]->y_orig + params->y_orig &&
-                            yy <= data_local[tid]->ymax + params->y_orig) {
-
-                            j = 0;
-                            for (k = 0; k < npoints; k++) {
-                                if (k != point_index) {
-                                    data_local[tid]->points[j].x = point[k].x;
-                                    data_local[tid]->points[j].y = point[k].y;
-                                    data_local[tid]->points[j].z = point[k].z;
-                                    j++;
-                                }
-                            }
-
-                            /* segment area test for cv */
-                            if (/* params */
-                                IL_matrix_create_alloc(
-                                    params, data_local[tid]->points,
-                                    data_local[tid]->n_points - 1, matrix[tid],
-                                    indx[tid], A[tid]) < 0) {
-                                some_thread_failed = -1;
-                                continue;
-                            }
-
-                            for (i = 0; i < data_local[tid]->n_points - 1;
-                                 i++) {
-                                b[tid][i + 1] = data_local[tid]->points[i].z;
-                            }
-                            b[tid][0] = 0.;
-                            G_lubksb(matrix[tid], data_local[tid]->n_points,
-                                     indx[tid], b[tid]);
-                        }
-                        else {
-                            continue;
-                        }
-                    } /* cv: skip one point */
-
-                    if (params->create_devi) {
-                        target_point.x = data_local[tid]->points[point_index].x;
-                        target_point.y = data_local[tid]->points[point_index].y;
-                        target_point.z = data_local[tid]->points[point_index].z;
-                    }
-
-                    /* x, y, z is required input, while xmm, ymm, err output*/
-                    pointz = target_point.z;
-                    params->check_points(params, data_local[tid], b[tid], ertot,
-                                         zmin, dnorm, &target_point);
+                /* write out vector (point), if the point is inside the
+                 * region*/
+                if (!inside)
+                    continue;
 
-                    err = target_point.z;
-                    target_point.z = pointz + zmin;
-                    xmm = target_point.x;
-                    ymm = target_point.y;
-
-                    /* write out vector (point), if the point is inside the
-                     * region*/
-                    if (xmm >= data_local[tid]->x_orig + params->x_orig &&
-                        xmm <= data_local[tid]->xmax + params->x_orig &&
-                        ymm >= data_local[tid]->y_orig + params->y_orig &&
-                        ymm <= data_local[tid]->ymax + params->y_orig) {
-                        /* vect append, count, vect_write, db_execute will have
-                         * conflicts between threads */
+                /* vect append, count, vect_write, db_execute will have
+                 * conflicts between threads */
 #pragma omp critical
-                        {
-                            params->check_points(params, NULL, NULL, &err, 0.0,
-                                                 0.0, &target_point);
-                        }
-                    }
-                } /* end of computations for every point in cv or devi*/
-
-                /* write out grid*/
-                if (!params->cv) {
-                    if ((params->Tmp_fd_z != NULL) ||
-                        (params->Tmp_fd_dx != NULL) ||
-                        (params->Tmp_fd_dy != NULL) ||
-                        (params->Tmp_fd_xx != NULL) ||
-                        (params->Tmp_fd_yy != NULL) ||
-                        (params->Tmp_fd_xy != NULL)) {
+                {
+                    params->check_points(params, NULL, NULL, &err, 0.0, 0.0,
+                                         &target_point);
+                }
+            } /* end of computations for every point in cv or devi*/
+
+            /* write out grid*/
+            if (!params->cv) {
+                if ((params->Tmp_fd_z != NULL) ||
+                    (params->Tmp_fd_dx != NULL) ||
+                    (params->Tmp_fd_dy != NULL) ||
+                    (params->Tmp_fd_xx != NULL) ||
+                    (params->Tmp_fd_yy != NULL) ||
+                    (params->Tmp_fd_xy != NULL)) {
 #pragma omp critical
-                        {
-                            if (params->grid_calc(params, data_local[tid],
-                                                  bitmask, zmin, zmax, zminac,
-                                                  zmaxac, gmin, gmax, c1min,
-                                                  c1max, c2min, c2max, ertot,
-                                                  b[tid], offset1, dnorm) < 0) {
-                                some_thread_failed = -1;
-                            }
+                    {
+                        if (params->grid_calc(params, data_local[tid], bitmask,
+                                              zmin, zmax, zminac, zmaxac, gmin,
+                                              gmax, c1min, c1max, c2min, c2max,
+                                              ertot, b[tid], offset1,
+                                              dnorm) < 0) {
+                            some_thread_failed = -1;
                         }
                     }
                 }
+            }
 
-                /* show after to catch 100% */
+            /* show after to catch 100% */
 #pragma omp atomic
-                cursegm++;
-                if (totsegm < cursegm) {
-                    G_debug(1, "%d %d", totsegm, cursegm);
-                }
+            cursegm++;
+            if (totsegm < cursegm) {
+                G_debug(1, "%d %d", totsegm, cursegm);
+            }
 
-                if (totsegm != 0 && tid == 0) {
-                    G_percent(cursegm, totsegm, 1);
-                }
-                /*
-                   G_free_matrix(matrix);
-                   G_free_ivector(indx);
-                   G_free_vector(b);
-                 */
-                G_free(data_local[tid]->points);
-                G_free(data_local[tid]);
+            if (totsegm != 0 && tid == 0) {
+                G_percent(cursegm, totsegm, 1);
             }
+            G_free(data_local[tid]->points);
+            G_free(data_local[tid]);
         }
     } /* All threads join master thread and terminate */
 
+    for (i_cnt = 0; i_cnt < threads; i_cnt++)
+        *ertot += ertot_thread[i_cnt];
+
     for (i_cnt = 0; i_cnt < threads; i_cnt++) {
         G_free(matrix[i_cnt]);
         G_free(indx[i_cnt]);
         G_free(b[i_cnt]);
         G_free(A[i_cnt]);
+        if (cv_err[i_cnt])
+            G_free_vector(cv_err[i_cnt]);
     }
     G_free(all_leafs);
     G_free(data_local);
@@ -464,6 +437,8 @@ int IL_interp_segments_2d_parallel(
     G_free(indx);
     G_free(b);
     G_free(A);
+    G_free(cv_err);
+    G_free(ertot_thread);
 
     if (some_thread_failed != 0) {
         return -1;
@@ -471,6 +446,139 @@ int IL_interp_segments_2d_parallel(
     return 1;
 }
 
+/*!
+ * \brief Cross-validation for combinations of tension and smoothing
+ *
+ * Segments and their points are found once, the system of every segment
+ * is then created and solved for each combination of tension and
+ * smoothing and the cross-validation errors of all points inside of the
+ * segment are obtained from that single solution.
+ *
+ * Sums of errors and of squared errors are stored in \p sum and \p sumsq
+ * of size nfi * nrsm, combination (tension i, smoothing j) has index
+ * i * nrsm + j. Tensions are used as given, i.e., already rescaled
+ * if required.
+ *
+ * \return 1 on success, -1 on failure
+ */
+int IL_cv_sweep_2d_parallel(
+    struct interp_params *params, struct tree_info *info,
+    struct multtree *tree, /*!< quad tree */
+    int totsegm,           /*!< total number of segments */
+    double dnorm, int nfi, /*!< number of tensions */
+    const double *fi,      /*!< tensions */
+    int nrsm,              /*!< number of smoothings */
+    const double *rsm,     /*!< smoothings */
+    double *sum,           /*!< sums of errors */
+    double *sumsq,         /*!< sums of squared errors */
+    int *n,                /*!< number of validated points */
+    int threads)
+{
+    struct multtree **all_leafs;
+    double smseg;
+    int i = 0, ncomb = nfi * nrsm, failed = 0, cursegm = 0, npoints = 0;
+
+    all_leafs =
+        (struct multtree **)G_malloc(sizeof(struct multtree *) * totsegm);
+    smseg = smallest_segment(tree, 4);
+    cut_tree(tree, all_leafs, &i);
+
+    for (i = 0; i < ncomb; i++)
+        sum[i] = sumsq[i] = 0.;
+
+#pragma omp parallel num_threads(threads) if (threads > 1)                   \
+    firstprivate(params) shared(all_leafs, info, tree, smseg, dnorm, fi,     \
+                                    rsm, sum, sumsq, failed, cursegm,        \
+                                    npoints) default(none)                   \
+    shared(totsegm, nfi, nrsm, ncomb)
+    {
+        struct interp_params p = *params;
+        double **matrix = G_alloc_matrix(p.KMAX2 + 1, p.KMAX2 + 1);
+        int *indx = G_alloc_ivector(p.KMAX2 + 1);
+        double *b = G_alloc_vector(p.KMAX2 + 3);
+        double *A = G_alloc_vector((p.KMAX2 + 2) * (p.KMAX2 + 2) + 1);
+        double *err = G_alloc_vector(2 * (p.KMAX2 + 2));
+        double *tsum = G_calloc(2 * ncomb, sizeof(double));
+        double *tsumsq = tsum + ncomb;
+        char *inside = G_malloc(p.KMAX2 + 1);
+        int s, k, j, c, tnpoints = 0;
+
+#pragma omp for schedule(dynamic)
+        for (s = 0; s < totsegm; s++) {
+            struct quaddata *data;
+            int ninside = 0;
+
+            if (failed || all_leafs[s] == NULL || all_leafs[s]->data == NULL)
+                continue;
+            data = segment_data(&p, info, tree, all_leafs[s], smseg, dnorm);
+            if (data == NULL)
+                continue;
+
+            for (k = 0; k < data->n_points; k++) {
+                inside[k] = inside_segment(&p, data, &data->points[k], dnorm);
+                ninside += inside[k];
+            }
+
+            for (c = 0; c < ncomb && ninside; c++) {
+                p.fi = fi[c / nrsm];
+                p.rsm = rsm[c % nrsm];
+                if (IL_matrix_create_alloc(&p, data->points, data->n_points,
+                                           matrix, indx, A) < 0) {
+                    failed = 1;
+                    break;
+                }
+                for (k = 0; k < data->n_points; k++)
+                    b[k + 1] = data->points[k].z;
+                b[0] = 0.;
+                G_lubksb(matrix, data->n_points + 1, indx, b);
+                if (IL_matrix_cv_errors(data->n_points, matrix, indx, b,
+                                        err + p.KMAX2 + 2, err) < 0) {
+                    failed = 1;
+                    break;
+                }
+                for (k = 0; k < data->n_points; k++) {
+                    if (!inside[k])
+                        continue;
+                    tsum[c] += err[k];
+                    tsumsq[c] += err[k] * err[k];
+                }
+            }
+            tnpoints += ninside;
+            G_free(data->points);
+            G_free(data);
+
+#pragma omp atomic
+            cursegm++;
+#if defined(_OPENMP)
+            if (omp_get_thread_num() == 0)
+#endif
+                G_percent(cursegm, totsegm, 1);
+        }
+
+#pragma omp critical
+        {
+            for (j = 0; j < ncomb; j++) {
+                sum[j] += tsum[j];
+                sumsq[j] += tsumsq[j];
+            }
+            npoints += tnpoints;
+        }
+
+        G_free_matrix(matrix);
+        G_free_ivector(indx);
+        G_free_vector(b);
+        G_free_vector(A);
+        G_free_vector(err);
+        G_free(tsum);
+        G_free(inside);
+    }
+    G_percent(1, 1, 1);
+    G_free(all_leafs);
+    *n = npoints;
+
+    return failed ? -1 : 1;
+}
+
 /* cut given tree into separate leafs */
 int cut_tree(struct multtree *tree,       /* tree we want to cut */
              struct multtree **cut_leafs, /* array of leafs */
@@ -34,6 +34,11 @@ int Vect__copy_areas(struct Map_info *, int, struct Map_info *);
 /* map.c */
 int Vect__delete(const char *, int);
 
+/* net_build.c */
+int Vect__net_read_costs(struct Map_info *, int, int, int, const char *,
+                         const char *, const char *, int,
+                         int (*)(void *, int, int, int, int), void *);
+
 /* open.c */
 int Vect__open_old(struct Map_info *, const char *, const char *, const char *,
                    int, int, int);
@@ -135,6 +135,82 @@ static int ttb_convert_dgl_shortest_path_result(struct Map_info *Map,
     return 0;
 }
 
+/*!
+   \brief Finds shortest path on network using contraction hierarchy
+   (see Vect_net_build_ch())
+ */
+static int find_shortest_path_ch(struct Map_info *Map, int from, int to,
+                                 struct ilist *List, double *cost)
+{
+    dglCHQuery_s *query;
+    dglInt64_t nDistance;
+    int i, nRet;
+
+    query = Map->dgraph.ch_query;
+    nRet = dglCHShortestPath(query, (dglInt32_t)from, (dglInt32_t)to,
+                             &nDistance, List != NULL);
+
+    if (nRet == 0) {
+        if (cost != NULL)
+            *cost = PORT_DOUBLE_MAX;
+        return -1;
+    }
+    else if (nRet < 0) {
+        Map->dgraph.graph_s.iErrno = query->iErrno;
+        G_warning(_("dglCHShortestPath error: %s"),
+                  dglStrerror(&(Map->dgraph.graph_s)));
+        return -1;
+    }
+
+    if (List != NULL) {
+        for (i = 0; i < query->cEdge; i++)
+            Vect_list_append(List, (int)query->pnEdge[i]);
+    }
+
+    if (cost != NULL)
+        *cost = (double)nDistance / Map->dgraph.cost_multip;
+
+    return List != NULL ? query->cEdge : 0;
+}
+
+/*!
+   \brief Finds shortest path on network using compressed sparse row graph
+   (see Vect_net_build_csr())
+ */
+static int find_shortest_path_csr(struct Map_info *Map, int from, int to,
+                                  struct ilist *List, double *cost)
+{
+    dglCSRQuery_s *query;
+    dglInt64_t nDistance;
+    int i, nRet;
+
+    query = Map->dgraph.csr_query;
+    nRet = dglCSRShortestPath(query, (dglInt32_t)from, (dglInt32_t)to,
+                              &nDistance, List != NULL);
+
+    if (nRet == 0) {
+        if (cost != NULL)
+            *cost = PORT_DOUBLE_MAX;
+        return -1;
+    }
+    else if (nRet < 0) {
+        Map->dgraph.graph_s.iErrno = query->iErrno;
+        G_warning(_("dglCSRShortestPath error: %s"),
+                  dglStrerror(&(Map->dgraph.graph_s)));
+        return -1;
+    }
+
+    if (List != NULL) {
+        for (i = 0; i < query->cEdge; i++)
+            Vect_list_append(List, (int)query->pnEdge[i]);
+    }
+
+    if (cost != NULL)
+        *cost = (double)nDistance / Map->dgraph.cost_multip;
+
+    return List != NULL ? query->cEdge : 0;
+}
+
 /*!
    \brief Finds shortest path on network using DGLib
 
@@ -171,6 +247,11 @@ static int find_shortest_path(struct Map_info *Map, int from, int to,
         return 0;
     }
 
+    if (!UseTtb && Map->dgraph.ch_query)
+        return find_shortest_path_ch(Map, from, to, List, cost);
+    if (!UseTtb && Map->dgraph.csr_query)
+        return find_shortest_path_csr(Map, from, to, List, cost);
+
     From_node = from;
     pclip = NULL;
     if (List != NULL) {
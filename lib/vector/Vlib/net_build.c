@@ -18,6 +18,8 @@
 #include <grass/vector.h>
 #include <grass/glocale.h>
 
+#include "local_proto.h"
+
 /*!
    \brief Build network graph with turntable.
 
@@ -96,6 +98,9 @@ int Vect_net_ttb_build_graph(struct Map_info *Map, int ltype, int afield,
 
     G_message(_("Building graph..."));
 
+    /* contraction hierarchy of previous graph is not valid */
+    Vect_net_free_ch(Map);
+    Vect_net_free_csr(Map);
     Map->dgraph.line_type = ltype;
 
     Points = Vect_new_line_struct();
@@ -678,44 +683,34 @@ int Vect_net_ttb_build_graph(struct Map_info *Map, int ltype, int afield,
     return 0;
 }
 
+static int add_graph_arc(void *data, int from, int to, int cost, int id)
+{
+    return dglAddEdge((dglGraph_s *)data, (dglInt32_t)from, (dglInt32_t)to,
+                      (dglInt32_t)cost, (dglInt32_t)id);
+}
+
 /*!
-   \brief Build network graph.
+   \brief Read costs of network arcs and nodes (internal use only)
 
-   Internal format for edge costs is integer, costs are multiplied
-   before conversion to int by 1000 and for lengths LL without geo flag by
-   1000000. The same multiplication factor is used for nodes. Costs in database
-   column may be 'integer' or 'double precision' number >= 0 or -1 for infinity
-   i.e. arc or node is closed and cannot be traversed If record in table is not
-   found for arcs, arc is skip. If record in table is not found for node, costs
-   for node are set to 0.
+   Arcs are passed to add_arc() with their from and to node, cost
+   multiplied by Map->dgraph.cost_multip and arc id (line id, negative
+   for backward direction). Costs are stored in Map->dgraph as by
+   Vect_net_build_graph().
 
-   \param Map vector map
-   \param ltype line type for arcs
-   \param afield arc costs field (if 0, use length)
-   \param nfield node costs field (if 0, do not use node costs)
-   \param afcol column with forward costs for arc
-   \param abcol column with backward costs for arc (if NULL, back costs =
-   forward costs), \param ncol column with costs for nodes (if NULL, do not use
-   node costs), \param geo use geodesic calculation for length (LL), \param
-   version graph version to create (1, 2, 3)
-
-   \return 0 on success, 1 on error
+   \return 0 on success
  */
-int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
+int Vect__net_read_costs(struct Map_info *Map, int ltype, int afield,
                          int nfield, const char *afcol, const char *abcol,
-                         const char *ncol, int geo, int version)
+                         const char *ncol, int geo,
+                         int (*add_arc)(void *, int, int, int, int),
+                         void *data)
 {
-    /* TODO long function, split into smaller ones */
     int i, j, from, to, line, nlines, nnodes, ret, type, cat, skipped, cfound;
     int dofw, dobw;
     struct line_pnts *Points;
     struct line_cats *Cats;
     double dcost, bdcost, ll;
     int cost, bcost;
-    dglGraph_s *gr;
-    dglInt32_t dgl_cost;
-    dglInt32_t opaqueset[16] = {360000, 0, 0, 0, 0, 0, 0, 0,
-                                0,      0, 0, 0, 0, 0, 0, 0};
     struct field_info *Fi = NULL;
     dbDriver *driver = NULL;
     dbHandle handle;
@@ -724,13 +719,6 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
     dbCatValArray fvarr, bvarr;
     int fctype = 0, bctype = 0, nrec;
 
-    /* TODO int costs -> double (waiting for dglib) */
-    G_debug(1, "Vect_net_build_graph(): ltype = %d, afield = %d, nfield = %d",
-            ltype, afield, nfield);
-    G_debug(1, "    afcol = %s, abcol = %s, ncol = %s", afcol, abcol, ncol);
-
-    G_message(_("Building graph..."));
-
     Map->dgraph.line_type = ltype;
 
     Points = Vect_new_line_struct();
@@ -748,13 +736,14 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
     nlines = Vect_get_num_lines(Map);
     nnodes = Vect_get_num_nodes(Map);
 
-    gr = &(Map->dgraph.graph_s);
-
     /* Allocate space for costs, later replace by functions reading costs from
-     * graph */
-    Map->dgraph.edge_fcosts = (double *)G_malloc((nlines + 1) * sizeof(double));
-    Map->dgraph.edge_bcosts = (double *)G_malloc((nlines + 1) * sizeof(double));
-    Map->dgraph.node_costs = (double *)G_malloc((nnodes + 1) * sizeof(double));
+     * graph, costs of a graph built before are replaced */
+    Map->dgraph.edge_fcosts = (double *)G_realloc(
+        Map->dgraph.edge_fcosts, (nlines + 1) * sizeof(double));
+    Map->dgraph.edge_bcosts = (double *)G_realloc(
+        Map->dgraph.edge_bcosts, (nlines + 1) * sizeof(double));
+    Map->dgraph.node_costs = (double *)G_realloc(Map->dgraph.node_costs,
+                                                 (nnodes + 1) * sizeof(double));
     /* Set to -1 initially */
     for (i = 1; i <= nlines; i++) {
         Map->dgraph.edge_fcosts[i] = -1; /* forward */
@@ -764,19 +753,6 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
         Map->dgraph.node_costs[i] = 0;
     }
 
-    if (version < 1 || version > 3)
-        version = 1;
-
-    if (ncol != NULL)
-        dglInitialize(gr, (dglByte_t)version, sizeof(dglInt32_t), (dglInt32_t)0,
-                      opaqueset);
-    else
-        dglInitialize(gr, (dglByte_t)version, (dglInt32_t)0, (dglInt32_t)0,
-                      opaqueset);
-
-    if (gr == NULL)
-        G_fatal_error(_("Unable to build network graph"));
-
     db_init_handle(&handle);
     db_init_string(&stmt);
 
@@ -917,8 +893,7 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
         if (dofw && dcost != -1) {
             cost = (dglInt32_t)Map->dgraph.cost_multip * dcost;
             G_debug(5, "Add arc %d from %d to %d cost = %d", i, from, to, cost);
-            ret = dglAddEdge(gr, (dglInt32_t)from, (dglInt32_t)to,
-                             (dglInt32_t)cost, (dglInt32_t)i);
+            ret = add_arc(data, from, to, cost, i);
             Map->dgraph.edge_fcosts[i] = dcost;
             if (ret < 0)
                 G_fatal_error("Cannot add network arc");
@@ -930,8 +905,7 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
             bcost = (dglInt32_t)Map->dgraph.cost_multip * bdcost;
             G_debug(5, "Add arc %d from %d to %d bcost = %d", -i, to, from,
                     bcost);
-            ret = dglAddEdge(gr, (dglInt32_t)to, (dglInt32_t)from,
-                             (dglInt32_t)bcost, (dglInt32_t)-i);
+            ret = add_arc(data, to, from, bcost, -i);
             Map->dgraph.edge_bcosts[i] = bdcost;
             if (ret < 0)
                 G_fatal_error(_("Cannot add network arc"));
@@ -1045,17 +1019,7 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
                     "(costs set to 0)",
                     nfield, i);
             }
-            if (dcost == -1) { /* closed */
-                cost = -1;
-            }
-            else {
-                cost = (dglInt32_t)Map->dgraph.cost_multip * dcost;
-            }
-
-            dgl_cost = cost;
-            G_debug(3, "Set node's cost to %d", cost);
-
-            dglNodeSet_Attr(gr, dglGetNode(gr, (dglInt32_t)i), &dgl_cost);
+            G_debug(3, "Set node's cost to %f", dcost);
 
             Map->dgraph.node_costs[i] = dcost;
         }
@@ -1065,6 +1029,87 @@ int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
         Vect_destroy_boxlist(List);
     }
 
+    return 0;
+}
+
+/*!
+   \brief Build network graph.
+
+   Internal format for edge costs is integer, costs are multiplied
+   before conversion to int by 1000 and for lengths LL without geo flag by
+   1000000. The same multiplication factor is used for nodes. Costs in database
+   column may be 'integer' or 'double precision' number >= 0 or -1 for infinity
+   i.e. arc or node is closed and cannot be traversed If record in table is not
+   found for arcs, arc is skip. If record in table is not found for node, costs
+   for node are set to 0.
+
+   \param Map vector map
+   \param ltype line type for arcs
+   \param afield arc costs field (if 0, use length)
+   \param nfield node costs field (if 0, do not use node costs)
+   \param afcol column with forward costs for arc
+   \param abcol column with backward costs for arc (if NULL, back costs =
+   forward costs), \param ncol column with costs for nodes (if NULL, do not use
+   node costs), \param geo use geodesic calculation for length (LL), \param
+   version graph version to create (1, 2, 3)
+
+   \return 0 on success, 1 on error
+ */
+int Vect_net_build_graph(struct Map_info *Map, int ltype, int afield,
+                         int nfield, const char *afcol, const char *abcol,
+                         const char *ncol, int geo, int version)
+{
+    int i, nnodes, ret;
+    dglGraph_s *gr;
+    dglInt32_t dgl_cost;
+    dglInt32_t opaqueset[16] = {360000, 0, 0, 0, 0, 0, 0, 0,
+                                0,      0, 0, 0, 0, 0, 0, 0};
+
+    /* TODO int costs -> double (waiting for dglib) */
+    G_debug(1, "Vect_net_build_graph(): ltype = %d, afield = %d, nfield = %d",
+            ltype, afield, nfield);
+    G_debug(1, "    afcol = %s, abcol = %s, ncol = %s", afcol, abcol, ncol);
+
+    G_message(_("Building graph..."));
+
+    /* contraction hierarchy of previous graph is not valid */
+    Vect_net_free_ch(Map);
+    Vect_net_free_csr(Map);
+
+    gr = &(Map->dgraph.graph_s);
+
+    if (version < 1 || version > 3)
+        version = 1;
+
+    if (ncol != NULL)
+        dglInitialize(gr, (dglByte_t)version, sizeof(dglInt32_t), (dglInt32_t)0,
+                      opaqueset);
+    else
+        dglInitialize(gr, (dglByte_t)version, (dglInt32_t)0, (dglInt32_t)0,
+                      opaqueset);
+
+    if (gr == NULL)
+        G_fatal_error(_("Unable to build network graph"));
+
+    Vect__net_read_costs(Map, ltype, afield, nfield, afcol, abcol, ncol, geo,
+                         add_graph_arc, gr);
+
+    /* Set node attributes */
+    if (ncol != NULL) {
+        nnodes = Vect_get_num_nodes(Map);
+        for (i = 1; i <= nnodes; i++) {
+            /* TODO: what happens if we set attributes of not existing node
+             * (skipped lines, nodes without lines) */
+            if (Map->dgraph.node_costs[i] == -1) /* closed */
+                dgl_cost = -1;
+            else
+                dgl_cost = (int)(Map->dgraph.cost_multip *
+                                 Map->dgraph.node_costs[i]);
+
+            dglNodeSet_Attr(gr, dglGetNode(gr, (dglInt32_t)i), &dgl_cost);
+        }
+    }
+
     G_message(_("Flattening the graph..."));
     ret = dglFlatten(gr);
     if (ret < 0)
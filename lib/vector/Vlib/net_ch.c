@@ -0,0 +1,169 @@
+/*!
+ * \file lib/vector/Vlib/net_ch.c
+ *
+ * \brief Vector library - contraction hierarchy of network graph
+ *
+ * Higher level functions for reading/writing/manipulating vectors.
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <grass/vector.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* read index from map directory if it was built for the same graph */
+static int read_ch(struct Map_info *Map, uint64_t checksum, dglCHIndex_s *ch)
+{
+    char file_path[GPATH_MAX], path[GPATH_MAX];
+    int fd, ret;
+
+    Vect__get_path(path, Map);
+    Vect__get_element_path(file_path, Map, GV_CH_ELEMENT);
+
+    if (access(file_path, F_OK) != 0) /* does not exist */
+        return -1;
+
+    fd = G_open_old(path, GV_CH_ELEMENT, Map->mapset);
+    if (fd < 0)
+        return -1;
+    ret = dglCHRead(ch, fd);
+    close(fd);
+
+    if (ret < 0) {
+        G_debug(1, "Unable to read contraction hierarchy");
+        return -1;
+    }
+    if (ch->nnChecksum != checksum) {
+        G_debug(1, "Contraction hierarchy built for different graph");
+        dglCHRelease(ch);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* write index to map directory */
+static void write_ch(struct Map_info *Map, dglCHIndex_s *ch)
+{
+    char path[GPATH_MAX];
+    int fd, ret;
+
+    Vect__get_path(path, Map);
+    fd = G_open_new(path, GV_CH_ELEMENT);
+    if (fd < 0) {
+        G_warning(_("Unable to save contraction hierarchy of vector map <%s>"),
+                  Vect_get_full_name(Map));
+        return;
+    }
+    ret = dglCHWrite(ch, fd);
+    close(fd);
+
+    if (ret < 0) {
+        G_warning(_("Unable to save contraction hierarchy of vector map <%s>"),
+                  Vect_get_full_name(Map));
+        G_remove(path, GV_CH_ELEMENT);
+    }
+}
+
+/*!
+   \brief Build contraction hierarchy of network graph
+
+   The contraction hierarchy is an index speeding up shortest path
+   queries on the graph built by Vect_net_build_graph(). Once built,
+   Vect_net_shortest_path() and Vect_net_shortest_path_coor() use it
+   instead of searching the graph. Paths of equal costs may differ from
+   those found without the index.
+
+   Building the index takes longer than a single search, it pays off
+   when many paths are searched on the same graph. The index is saved
+   in the directory of the vector map if the map is in the current
+   mapset and reused as long as the graph (lines, costs and node costs)
+   does not change.
+
+   Graphs with turntable are not supported.
+
+   \param Map vector map with graph built by Vect_net_build_graph()
+
+   \return 0 on success
+   \return 1 on error
+ */
+int Vect_net_build_ch(struct Map_info *Map)
+{
+    dglGraph_s *gr;
+    dglCHIndex_s *ch;
+    uint64_t checksum;
+    int ret;
+
+    G_debug(1, "Vect_net_build_ch()");
+
+    gr = &(Map->dgraph.graph_s);
+    Vect_net_free_ch(Map);
+
+    if (dglCHChecksum(gr, DGL_CH_NODECOST, &checksum) < 0) {
+        G_warning(_("Unable to build contraction hierarchy: %s"),
+                  dglStrerror(gr));
+        return 1;
+    }
+
+    ch = G_malloc(sizeof(dglCHIndex_s));
+    if (read_ch(Map, checksum, ch) == 0) {
+        G_verbose_message(_("Using contraction hierarchy of vector map <%s>"),
+                          Vect_get_full_name(Map));
+    }
+    else {
+        G_message(_("Building contraction hierarchy..."));
+        ret = dglCHBuild(gr, ch, DGL_CH_NODECOST);
+        if (ret < 0) {
+            G_warning(_("Unable to build contraction hierarchy: %s"),
+                      dglStrerror(gr));
+            G_free(ch);
+            return 1;
+        }
+        G_debug(1, "  %d nodes, %d arcs", (int)ch->cNode, (int)ch->cArc);
+
+        if (strcmp(Map->mapset, G_mapset()) == 0 &&
+            Map->format == GV_FORMAT_NATIVE)
+            write_ch(Map, ch);
+    }
+
+    Map->dgraph.ch = ch;
+    Map->dgraph.ch_query = G_malloc(sizeof(dglCHQuery_s));
+    ret = dglCHQueryInitialize(ch, Map->dgraph.ch_query);
+    if (ret < 0) {
+        gr->iErrno = -ret;
+        G_warning(_("Unable to build contraction hierarchy: %s"),
+                  dglStrerror(gr));
+        Vect_net_free_ch(Map);
+        return 1;
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Free contraction hierarchy built by Vect_net_build_ch()
+
+   Shortest paths are searched on the graph afterwards.
+
+   \param Map vector map
+ */
+void Vect_net_free_ch(struct Map_info *Map)
+{
+    if (Map->dgraph.ch_query) {
+        dglCHQueryRelease(Map->dgraph.ch_query);
+        G_free(Map->dgraph.ch_query);
+        Map->dgraph.ch_query = NULL;
+    }
+    if (Map->dgraph.ch) {
+        dglCHRelease(Map->dgraph.ch);
+        G_free(Map->dgraph.ch);
+        Map->dgraph.ch = NULL;
+    }
+}
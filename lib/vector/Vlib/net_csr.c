@@ -0,0 +1,397 @@
+/*!
+ * \file lib/vector/Vlib/net_csr.c
+ *
+ * \brief Vector library - compressed sparse row network graph
+ *
+ * Higher level functions for reading/writing/manipulating vectors.
+ *
+ * (C) 2026 by the GRASS Development Team
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <grass/vector.h>
+#include <grass/dbmi.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* costs of Map->dgraph saved with the graph */
+struct csr_costs {
+    int cost_multip;
+    int nlines;
+    int nnodes;
+};
+
+static uint64_t hash(uint64_t key, const void *p, size_t size)
+{
+    const unsigned char *b = p;
+
+    /* FNV-1a */
+    while (size--) {
+        key ^= *b++;
+        key *= 0x100000001b3ULL;
+    }
+
+    return key;
+}
+
+static uint64_t hash_string(uint64_t key, const char *s)
+{
+    return s ? hash(key, s, strlen(s) + 1) : hash(key, "", 1);
+}
+
+/* hash of file size and content, the modification time alone is not
+   reliable (resolution of one second, copied or restored files) */
+static int hash_file(uint64_t *key, struct Map_info *Map, const char *element)
+{
+    char path[GPATH_MAX];
+    unsigned char buf[65536];
+    FILE *fp;
+    size_t n;
+    long long size;
+
+    Vect__get_element_path(path, Map, element);
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+        return -1;
+    size = 0;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        *key = hash(*key, buf, n);
+        size += n;
+    }
+    if (ferror(fp)) {
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    *key = hash(*key, &size, sizeof(size));
+
+    return 0;
+}
+
+/* hash of cost column values */
+static int hash_column(uint64_t *key, struct Map_info *Map, int field,
+                       const char *col)
+{
+    struct field_info *Fi;
+    dbDriver *driver;
+    dbCatValArray cvarr;
+    int i, nrec;
+
+    Fi = Vect_get_field(Map, field);
+    if (Fi == NULL)
+        return -1;
+    driver = db_start_driver_open_database(Fi->driver, Fi->database);
+    if (driver == NULL) {
+        Vect_destroy_field_info(Fi);
+        return -1;
+    }
+
+    db_CatValArray_init(&cvarr);
+    nrec = db_select_CatValArray(driver, Fi->table, Fi->key, col, NULL, &cvarr);
+    db_close_database_shutdown_driver(driver);
+    Vect_destroy_field_info(Fi);
+    if (nrec < 0 || (cvarr.ctype != DB_C_TYPE_INT &&
+                     cvarr.ctype != DB_C_TYPE_DOUBLE)) {
+        db_CatValArray_free(&cvarr);
+        return -1;
+    }
+
+    *key = hash_string(*key, col);
+    for (i = 0; i < cvarr.n_values; i++) {
+        dbCatVal *cv = &cvarr.value[i];
+
+        *key = hash(*key, &cv->cat, sizeof(int));
+        *key = hash(*key, &cv->isNull, sizeof(int));
+        if (cvarr.ctype == DB_C_TYPE_INT)
+            *key = hash(*key, &cv->val.i, sizeof(int));
+        else
+            *key = hash(*key, &cv->val.d, sizeof(double));
+    }
+    db_CatValArray_free(&cvarr);
+
+    return 0;
+}
+
+/* identifies the graph built from the map with given parameters */
+static int graph_key(uint64_t *key, struct Map_info *Map, int ltype,
+                     int afield, int nfield, const char *afcol,
+                     const char *abcol, const char *ncol, int geo)
+{
+    int n[6];
+
+    if (Map->format != GV_FORMAT_NATIVE)
+        return -1;
+
+    *key = 0xcbf29ce484222325ULL;
+    n[0] = ltype;
+    n[1] = afcol ? afield : 0;
+    n[2] = ncol ? nfield : 0;
+    n[3] = geo;
+    n[4] = G_projection() == PROJECTION_LL;
+    n[5] = Vect_get_num_lines(Map);
+    *key = hash(*key, n, sizeof(n));
+    *key = hash_string(*key, afcol);
+    *key = hash_string(*key, abcol);
+    *key = hash_string(*key, ncol);
+
+    /* node ids depend on topology */
+    if (hash_file(key, Map, GV_COOR_ELEMENT) < 0 ||
+        hash_file(key, Map, GV_TOPO_ELEMENT) < 0)
+        return -1;
+
+    if ((afcol && hash_column(key, Map, afield, afcol) < 0) ||
+        (abcol && hash_column(key, Map, afield, abcol) < 0) ||
+        (ncol && hash_column(key, Map, nfield, ncol) < 0))
+        return -1;
+
+    return 0;
+}
+
+/* store costs of Map->dgraph with graph */
+static int save_costs(struct Map_info *Map, dglCSRGraph_s *csr)
+{
+    struct csr_costs head;
+    size_t nl, nn, size;
+    char *data;
+    int ret;
+
+    head.cost_multip = Map->dgraph.cost_multip;
+    head.nlines = Vect_get_num_lines(Map);
+    head.nnodes = Vect_get_num_nodes(Map);
+    nl = (head.nlines + 1) * sizeof(double);
+    nn = (head.nnodes + 1) * sizeof(double);
+    size = sizeof(head) + 2 * nl + nn;
+    if (size > INT32_MAX)
+        return -1;
+
+    data = G_malloc(size);
+    memcpy(data, &head, sizeof(head));
+    memcpy(data + sizeof(head), Map->dgraph.edge_fcosts, nl);
+    memcpy(data + sizeof(head) + nl, Map->dgraph.edge_bcosts, nl);
+    memcpy(data + sizeof(head) + 2 * nl, Map->dgraph.node_costs, nn);
+    ret = dglCSRSetUserData(csr, data, (int32_t)size);
+    G_free(data);
+
+    return ret;
+}
+
+/* restore costs of Map->dgraph saved with graph */
+static int restore_costs(struct Map_info *Map, dglCSRGraph_s *csr)
+{
+    struct csr_costs head;
+    size_t nl, nn;
+    const char *data = csr->pvUser;
+
+    if (csr->cbUser < (int32_t)sizeof(head))
+        return -1;
+    memcpy(&head, data, sizeof(head));
+    if (head.nlines != Vect_get_num_lines(Map) ||
+        head.nnodes != Vect_get_num_nodes(Map))
+        return -1;
+    nl = (head.nlines + 1) * sizeof(double);
+    nn = (head.nnodes + 1) * sizeof(double);
+    if ((size_t)csr->cbUser != sizeof(head) + 2 * nl + nn)
+        return -1;
+
+    /* replace costs of a graph built before */
+    Map->dgraph.cost_multip = head.cost_multip;
+    Map->dgraph.edge_fcosts = G_realloc(Map->dgraph.edge_fcosts, nl);
+    Map->dgraph.edge_bcosts = G_realloc(Map->dgraph.edge_bcosts, nl);
+    Map->dgraph.node_costs = G_realloc(Map->dgraph.node_costs, nn);
+    memcpy(Map->dgraph.edge_fcosts, data + sizeof(head), nl);
+    memcpy(Map->dgraph.edge_bcosts, data + sizeof(head) + nl, nl);
+    memcpy(Map->dgraph.node_costs, data + sizeof(head) + 2 * nl, nn);
+
+    return 0;
+}
+
+/* read graph from map directory if it was built from the same data */
+static int read_csr(struct Map_info *Map, uint64_t key, dglCSRGraph_s *csr)
+{
+    char file_path[GPATH_MAX], path[GPATH_MAX];
+    int fd, ret;
+
+    Vect__get_path(path, Map);
+    Vect__get_element_path(file_path, Map, GV_CSR_ELEMENT);
+
+    if (access(file_path, F_OK) != 0) /* does not exist */
+        return -1;
+
+    fd = G_open_old(path, GV_CSR_ELEMENT, Map->mapset);
+    if (fd < 0)
+        return -1;
+    ret = dglCSRRead(csr, fd);
+    close(fd);
+
+    if (ret < 0) {
+        G_debug(1, "Unable to read compressed sparse row graph");
+        return -1;
+    }
+    if (csr->nnKey != key || restore_costs(Map, csr) < 0) {
+        G_debug(1, "Compressed sparse row graph built from different data");
+        dglCSRRelease(csr);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* write graph to map directory */
+static void write_csr(struct Map_info *Map, dglCSRGraph_s *csr)
+{
+    char path[GPATH_MAX];
+    int fd, ret;
+
+    Vect__get_path(path, Map);
+    fd = G_open_new(path, GV_CSR_ELEMENT);
+    if (fd < 0) {
+        G_warning(_("Unable to save graph of vector map <%s>"),
+                  Vect_get_full_name(Map));
+        return;
+    }
+    ret = dglCSRWrite(csr, fd);
+    close(fd);
+
+    if (ret < 0) {
+        G_warning(_("Unable to save graph of vector map <%s>"),
+                  Vect_get_full_name(Map));
+        G_remove(path, GV_CSR_ELEMENT);
+    }
+}
+
+static int add_csr_arc(void *data, int from, int to, int cost, int id)
+{
+    return dglCSRAddEdge((dglCSRGraph_s *)data, (dglInt32_t)from,
+                         (dglInt32_t)to, (dglInt32_t)cost, (dglInt32_t)id);
+}
+
+/*!
+   \brief Build compressed sparse row network graph
+
+   The graph is an alternative to the graph built by
+   Vect_net_build_graph() with the same parameters and costs, it needs
+   less memory and is built faster. Vect_net_shortest_path() and
+   Vect_net_shortest_path_coor() use it instead of the graph built by
+   Vect_net_build_graph(); functions which need that graph, e.g.
+   Vect_net_get_graph() and Vect_net_build_ch(), do not work with it.
+   Paths of equal costs may differ from those found on that graph.
+
+   The graph is saved in the directory of the vector map if the map is
+   in the current mapset and native. A saved graph is reused as long as
+   the parameters, geometry, topology and cost columns of the map do not
+   change.
+
+   \param Map vector map
+   \param ltype line type for arcs
+   \param afield arc costs field (if 0, use length)
+   \param nfield node costs field (if 0, do not use node costs)
+   \param afcol column with forward costs for arc
+   \param abcol column with backward costs for arc (if NULL, back costs =
+   forward costs)
+   \param ncol column with costs for nodes (if NULL, do not use node costs)
+   \param geo use geodesic calculation for length (LL)
+
+   \return 0 on success
+   \return 1 on error
+ */
+int Vect_net_build_csr(struct Map_info *Map, int ltype, int afield,
+                       int nfield, const char *afcol, const char *abcol,
+                       const char *ncol, int geo)
+{
+    dglCSRGraph_s *csr;
+    uint64_t key = 0;
+    int i, nnodes, have_key, ret;
+
+    G_debug(1, "Vect_net_build_csr(): ltype = %d, afield = %d, nfield = %d",
+            ltype, afield, nfield);
+    G_debug(1, "    afcol = %s, abcol = %s, ncol = %s", afcol, abcol, ncol);
+
+    Vect_net_free_ch(Map);
+    Vect_net_free_csr(Map);
+
+    have_key =
+        graph_key(&key, Map, ltype, afield, nfield, afcol, abcol, ncol, geo) ==
+        0;
+
+    csr = G_malloc(sizeof(dglCSRGraph_s));
+    if (have_key && read_csr(Map, key, csr) == 0) {
+        G_verbose_message(_("Using graph saved with vector map <%s>"),
+                          Vect_get_full_name(Map));
+        Map->dgraph.line_type = ltype;
+    }
+    else {
+        G_message(_("Building graph..."));
+
+        dglCSRInitialize(csr, ncol ? DGL_CSR_NODECOST : 0);
+        Vect__net_read_costs(Map, ltype, afield, nfield, afcol, abcol, ncol,
+                             geo, add_csr_arc, csr);
+        if (dglCSRFinalize(csr) < 0) {
+            G_warning(_("Unable to build graph"));
+            dglCSRRelease(csr);
+            G_free(csr);
+            return 1;
+        }
+
+        if (ncol != NULL) {
+            nnodes = Vect_get_num_nodes(Map);
+            for (i = 1; i <= nnodes; i++) {
+                dglInt32_t cost;
+
+                if (Map->dgraph.node_costs[i] == -1) /* closed */
+                    cost = -1;
+                else
+                    cost = (int)(Map->dgraph.cost_multip *
+                                 Map->dgraph.node_costs[i]);
+                /* nodes without arcs are not in the graph */
+                dglCSRSetNodeCost(csr, i, cost);
+            }
+        }
+        G_debug(1, "  %d nodes, %d arcs", (int)csr->cNode, (int)csr->cEdge);
+
+        if (have_key && strcmp(Map->mapset, G_mapset()) == 0) {
+            csr->nnKey = key;
+            if (save_costs(Map, csr) == 0)
+                write_csr(Map, csr);
+        }
+    }
+
+    Map->dgraph.csr = csr;
+    Map->dgraph.csr_query = G_malloc(sizeof(dglCSRQuery_s));
+    ret = dglCSRQueryInitialize(csr, Map->dgraph.csr_query);
+    if (ret < 0) {
+        G_warning(_("Unable to build graph: %s"), "out of memory");
+        G_free(Map->dgraph.csr_query);
+        Map->dgraph.csr_query = NULL;
+        Vect_net_free_csr(Map);
+        return 1;
+    }
+
+    G_message(_("Graph was built"));
+
+    return 0;
+}
+
+/*!
+   \brief Free graph built by Vect_net_build_csr()
+
+   \param Map vector map
+ */
+void Vect_net_free_csr(struct Map_info *Map)
+{
+    if (Map->dgraph.csr_query) {
+        dglCSRQueryRelease(Map->dgraph.csr_query);
+        G_free(Map->dgraph.csr_query);
+        Map->dgraph.csr_query = NULL;
+    }
+    if (Map->dgraph.csr) {
+        dglCSRRelease(Map->dgraph.csr);
+        G_free(Map->dgraph.csr);
+        Map->dgraph.csr = NULL;
+    }
+}
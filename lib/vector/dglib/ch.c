@@ -0,0 +1,1127 @@
+/* LIBDGL -- a Directed Graph Library implementation
+ * Copyright (C) 2002 Roberto Micarelli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Contraction hierarchy (Geisberger et al. 2008) built from a flat graph.
+ *
+ * Nodes are contracted one by one in the order of their edge difference.
+ * When a node is contracted, a shortcut replaces every path over the
+ * node which is a shortest path between its remaining neighbours (a
+ * limited local search looks for a witness path avoiding the node). A
+ * query runs a bidirectional Dijkstra search which only goes up in the
+ * hierarchy, so it settles few nodes whatever the size of the graph.
+ * Shortcuts are unpacked to the graph edges when the path is requested.
+ *
+ * Node costs following the convention of the vector library are
+ * supported by adding the cost of leaving a node to its out edges;
+ * closed nodes get a cost larger than any path, so that paths over them
+ * are recognized by their distance.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <grass/gis.h>
+#include "type.h"
+#include "tree.h"
+#include "graph.h"
+#include "ch.h"
+
+#define CH_MAGIC        "DGLCH001"
+#define CH_BYTE_ORDER   0x01020304
+#define CH_SETTLE_LIMIT 500             /* nodes settled by witness search */
+#define CH_CLOSED       ((int64_t)1 << 40) /* cost of leaving closed node */
+#define CH_UNREACHED    INT64_MAX
+
+typedef struct {
+    int32_t *pn;
+    int32_t cn, nAlloc;
+} list_s;
+
+typedef struct {
+    int32_t cNode;
+    dglCHArc_s *pArc;
+    int32_t cArc, nArcAlloc;
+    list_s *pOut, *pIn; /* arcs by node */
+    char *pContracted;
+    int32_t *pnDeleted; /* number of contracted neighbours */
+    /* witness search */
+    int64_t *pnnDist;
+    int32_t *pnTouched;
+    int32_t cTouched;
+    dglCHHeapItem_s *pHeap;
+    int32_t cHeap, nHeapAlloc;
+} builder_s;
+
+static int list_add(list_s *pList, int32_t n)
+{
+    int32_t *pn;
+
+    if (pList->cn == pList->nAlloc) {
+        pList->nAlloc = pList->nAlloc ? pList->nAlloc * 2 : 4;
+        pn = realloc(pList->pn, pList->nAlloc * sizeof(int32_t));
+        if (pn == NULL)
+            return -1;
+        pList->pn = pn;
+    }
+    pList->pn[pList->cn++] = n;
+
+    return 0;
+}
+
+/* binary min-heap, stale items are skipped by the caller */
+static int heap_push(dglCHHeapItem_s **ppHeap, int32_t *pcHeap,
+                     int32_t *pnAlloc, int64_t nnKey, int32_t iNode)
+{
+    dglCHHeapItem_s *pHeap;
+    int32_t i, parent;
+
+    if (*pcHeap == *pnAlloc) {
+        *pnAlloc = *pnAlloc ? *pnAlloc * 2 : 256;
+        pHeap = realloc(*ppHeap, *pnAlloc * sizeof(dglCHHeapItem_s));
+        if (pHeap == NULL)
+            return -1;
+        *ppHeap = pHeap;
+    }
+    pHeap = *ppHeap;
+
+    for (i = (*pcHeap)++; i > 0; i = parent) {
+        parent = (i - 1) / 2;
+        if (pHeap[parent].nnKey <= nnKey)
+            break;
+        pHeap[i] = pHeap[parent];
+    }
+    pHeap[i].nnKey = nnKey;
+    pHeap[i].iNode = iNode;
+
+    return 0;
+}
+
+static void heap_pop(dglCHHeapItem_s *pHeap, int32_t *pcHeap,
+                     dglCHHeapItem_s *pItem)
+{
+    dglCHHeapItem_s last;
+    int32_t i, child, n;
+
+    *pItem = pHeap[0];
+    n = --(*pcHeap);
+    last = pHeap[n];
+
+    for (i = 0; (child = 2 * i + 1) < n; i = child) {
+        if (child + 1 < n && pHeap[child + 1].nnKey < pHeap[child].nnKey)
+            child++;
+        if (last.nnKey <= pHeap[child].nnKey)
+            break;
+        pHeap[i] = pHeap[child];
+    }
+    pHeap[i] = last;
+}
+
+static int compare_id(const void *pa, const void *pb)
+{
+    int32_t a = *(const int32_t *)pa, b = *(const int32_t *)pb;
+
+    return (a > b) - (a < b);
+}
+
+static int compare_arc(const void *pa, const void *pb)
+{
+    const dglCHArc_s *a = pa, *b = pb;
+
+    if (a->nFrom != b->nFrom)
+        return a->nFrom < b->nFrom ? -1 : 1;
+    if (a->nTo != b->nTo)
+        return a->nTo < b->nTo ? -1 : 1;
+    if (a->nnCost != b->nnCost)
+        return a->nnCost < b->nnCost ? -1 : 1;
+
+    return 0;
+}
+
+static int32_t node_index(dglCHIndex_s *pCH, dglInt32_t nId)
+{
+    int32_t id = nId;
+    int32_t *pn;
+
+    pn = bsearch(&id, pCH->pnNodeId, pCH->cNode, sizeof(int32_t), compare_id);
+
+    return pn ? (int32_t)(pn - pCH->pnNodeId) : -1;
+}
+
+static uint64_t hash(uint64_t nnHash, const void *pv, size_t cb)
+{
+    const unsigned char *pb = pv;
+
+    /* FNV-1a */
+    while (cb--) {
+        nnHash ^= *pb++;
+        nnHash *= 0x100000001b3ULL;
+    }
+
+    return nnHash;
+}
+
+/*
+ * read nodes and edges of flat graph, parallel edges are reduced to the
+ * cheapest one
+ */
+static int read_graph(dglGraph_s *pGraph, int nFlags, dglCHIndex_s *pCH,
+                      dglCHArc_s **ppArc, int32_t *pcArc)
+{
+    dglNodeTraverser_s nt;
+    dglEdgesetTraverser_s et;
+    dglInt32_t *pnNode, *pnEdgeset, *pnEdge;
+    dglCHArc_s *pArc;
+    int32_t i, j, cArc, nAlloc, iFrom, iTo;
+    int64_t nnCost;
+    uint64_t nnHash;
+
+    if (!(pGraph->Flags & DGL_GS_FLAT)) {
+        pGraph->iErrno = DGL_ERR_BadOnTreeGraph;
+        return -pGraph->iErrno;
+    }
+    if (dglGet_NodeAttrSize(pGraph) < (int)sizeof(dglInt32_t))
+        nFlags &= ~DGL_CH_NODECOST;
+
+    memset(pCH, 0, sizeof(dglCHIndex_s));
+    pCH->nFlags = nFlags;
+    pCH->cNode = dglGet_NodeCount(pGraph);
+    pCH->pnNodeId = malloc((pCH->cNode + 1) * sizeof(int32_t));
+    if (pCH->pnNodeId == NULL)
+        goto nomem;
+
+    i = 0;
+    dglNode_T_Initialize(&nt, pGraph);
+    for (pnNode = dglNode_T_First(&nt); pnNode && i < pCH->cNode;
+         pnNode = dglNode_T_Next(&nt))
+        pCH->pnNodeId[i++] = dglNodeGet_Id(pGraph, pnNode);
+    dglNode_T_Release(&nt);
+    pCH->cNode = i;
+    qsort(pCH->pnNodeId, pCH->cNode, sizeof(int32_t), compare_id);
+
+    if (nFlags & DGL_CH_NODECOST) {
+        pCH->pnnNodeCost = malloc((pCH->cNode + 1) * sizeof(int64_t));
+        if (pCH->pnnNodeCost == NULL)
+            goto nomem;
+        for (i = 0; i < pCH->cNode; i++) {
+            pnNode = dglGetNode(pGraph, pCH->pnNodeId[i]);
+            nnCost = *dglNodeGet_Attr(pGraph, pnNode);
+            pCH->pnnNodeCost[i] = nnCost == -1 ? CH_CLOSED : nnCost;
+        }
+    }
+
+    cArc = 0;
+    nAlloc = dglGet_EdgeCount(pGraph) + 1;
+    pArc = malloc(nAlloc * sizeof(dglCHArc_s));
+    if (pArc == NULL)
+        goto nomem;
+
+    for (iFrom = 0; iFrom < pCH->cNode; iFrom++) {
+        pnNode = dglGetNode(pGraph, pCH->pnNodeId[iFrom]);
+        pnEdgeset = dglNodeGet_OutEdgeset(pGraph, pnNode);
+        if (pnEdgeset == NULL)
+            continue;
+
+        dglEdgeset_T_Initialize(&et, pGraph, pnEdgeset);
+        for (pnEdge = dglEdgeset_T_First(&et); pnEdge;
+             pnEdge = dglEdgeset_T_Next(&et)) {
+            iTo = node_index(pCH,
+                             dglNodeGet_Id(pGraph, dglEdgeGet_Tail(pGraph,
+                                                                   pnEdge)));
+            if (iTo < 0 || iTo == iFrom)
+                continue;
+            if (cArc == nAlloc) {
+                dglCHArc_s *p;
+
+                nAlloc *= 2;
+                p = realloc(pArc, nAlloc * sizeof(dglCHArc_s));
+                if (p == NULL) {
+                    free(pArc);
+                    dglEdgeset_T_Release(&et);
+                    goto nomem;
+                }
+                pArc = p;
+            }
+            pArc[cArc].nFrom = iFrom;
+            pArc[cArc].nTo = iTo;
+            pArc[cArc].nnCost = dglEdgeGet_Cost(pGraph, pnEdge);
+            if (pCH->pnnNodeCost)
+                pArc[cArc].nnCost += pCH->pnnNodeCost[iFrom];
+            pArc[cArc].iMid = -1;
+            pArc[cArc].nA = dglEdgeGet_Id(pGraph, pnEdge);
+            pArc[cArc].nB = -1;
+            cArc++;
+        }
+        dglEdgeset_T_Release(&et);
+    }
+
+    qsort(pArc, cArc, sizeof(dglCHArc_s), compare_arc);
+    for (i = j = 0; i < cArc; i++) {
+        if (j > 0 && pArc[i].nFrom == pArc[j - 1].nFrom &&
+            pArc[i].nTo == pArc[j - 1].nTo)
+            continue;
+        pArc[j++] = pArc[i];
+    }
+    cArc = j;
+
+    /* checksum of the reduced graph */
+    nnHash = 0xcbf29ce484222325ULL;
+    nnHash = hash(nnHash, &nFlags, sizeof(nFlags));
+    nnHash = hash(nnHash, pCH->pnNodeId, pCH->cNode * sizeof(int32_t));
+    for (i = 0; i < cArc; i++) {
+        nnHash = hash(nnHash, &pArc[i].nFrom, sizeof(int32_t));
+        nnHash = hash(nnHash, &pArc[i].nTo, sizeof(int32_t));
+        nnHash = hash(nnHash, &pArc[i].nnCost, sizeof(int64_t));
+        nnHash = hash(nnHash, &pArc[i].nA, sizeof(int32_t));
+    }
+    pCH->nnChecksum = nnHash;
+
+    *ppArc = pArc;
+    *pcArc = cArc;
+
+    return 0;
+
+nomem:
+    dglCHRelease(pCH);
+    pGraph->iErrno = DGL_ERR_MemoryExhausted;
+    return -pGraph->iErrno;
+}
+
+/*
+ * Dijkstra search from iSource over not contracted nodes except iSkip,
+ * limited by cost and number of settled nodes
+ */
+static int witness_search(builder_s *pB, int32_t iSource, int32_t iSkip,
+                          int64_t nnMax)
+{
+    dglCHHeapItem_s item;
+    dglCHArc_s *pArc;
+    list_s *pOut;
+    int32_t i, cSettled;
+    int64_t nnDist;
+
+    pB->cHeap = 0;
+    pB->pnnDist[iSource] = 0;
+    pB->pnTouched[pB->cTouched++] = iSource;
+    if (heap_push(&pB->pHeap, &pB->cHeap, &pB->nHeapAlloc, 0, iSource) < 0)
+        return -1;
+
+    cSettled = 0;
+    while (pB->cHeap > 0 && cSettled < CH_SETTLE_LIMIT) {
+        heap_pop(pB->pHeap, &pB->cHeap, &item);
+        if (item.nnKey > pB->pnnDist[item.iNode])
+            continue;
+        if (item.nnKey > nnMax)
+            break;
+        cSettled++;
+
+        pOut = &pB->pOut[item.iNode];
+        for (i = 0; i < pOut->cn; i++) {
+            pArc = &pB->pArc[pOut->pn[i]];
+            if (pArc->nTo == iSkip || pB->pContracted[pArc->nTo])
+                continue;
+            nnDist = item.nnKey + pArc->nnCost;
+            if (nnDist < pB->pnnDist[pArc->nTo]) {
+                if (pB->pnnDist[pArc->nTo] == CH_UNREACHED)
+                    pB->pnTouched[pB->cTouched++] = pArc->nTo;
+                pB->pnnDist[pArc->nTo] = nnDist;
+                if (heap_push(&pB->pHeap, &pB->cHeap, &pB->nHeapAlloc, nnDist,
+                              pArc->nTo) < 0)
+                    return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void witness_reset(builder_s *pB)
+{
+    int32_t i;
+
+    for (i = 0; i < pB->cTouched; i++)
+        pB->pnnDist[pB->pnTouched[i]] = CH_UNREACHED;
+    pB->cTouched = 0;
+}
+
+/* add shortcut iFrom -> iTo over iMid or lower cost of existing arc */
+static int add_shortcut(builder_s *pB, int32_t iFrom, int32_t iTo,
+                        int64_t nnCost, int32_t iMid, int32_t nA, int32_t nB)
+{
+    dglCHArc_s *pArc;
+    list_s *pOut;
+    int32_t i;
+
+    pOut = &pB->pOut[iFrom];
+    for (i = 0; i < pOut->cn; i++) {
+        pArc = &pB->pArc[pOut->pn[i]];
+        if (pArc->nTo != iTo)
+            continue;
+        /* arcs between not contracted nodes are not part of any shortcut
+           yet and can be replaced */
+        if (pArc->nnCost > nnCost) {
+            pArc->nnCost = nnCost;
+            pArc->iMid = iMid;
+            pArc->nA = nA;
+            pArc->nB = nB;
+        }
+        return 0;
+    }
+
+    if (pB->cArc == pB->nArcAlloc) {
+        pB->nArcAlloc *= 2;
+        pArc = realloc(pB->pArc, pB->nArcAlloc * sizeof(dglCHArc_s));
+        if (pArc == NULL)
+            return -1;
+        pB->pArc = pArc;
+    }
+    pArc = &pB->pArc[pB->cArc];
+    pArc->nFrom = iFrom;
+    pArc->nTo = iTo;
+    pArc->nnCost = nnCost;
+    pArc->iMid = iMid;
+    pArc->nA = nA;
+    pArc->nB = nB;
+    if (list_add(&pB->pOut[iFrom], pB->cArc) < 0 ||
+        list_add(&pB->pIn[iTo], pB->cArc) < 0)
+        return -1;
+    pB->cArc++;
+
+    return 0;
+}
+
+/*
+ * contract node (fAdd != 0) or only count the shortcuts needed, returns
+ * number of shortcuts or -1 on error
+ */
+static int32_t contract(builder_s *pB, int32_t iNode, int fAdd)
+{
+    list_s *pIn, *pOut;
+    dglCHArc_s *pArcIn, *pArcOut;
+    int32_t i, j, aIn, aOut, iFrom, iTo, cShortcut;
+    int64_t nnMax, nnCost;
+
+    pIn = &pB->pIn[iNode];
+    pOut = &pB->pOut[iNode];
+    cShortcut = 0;
+
+    for (i = 0; i < pIn->cn; i++) {
+        aIn = pIn->pn[i];
+        iFrom = pB->pArc[aIn].nFrom;
+        if (pB->pContracted[iFrom])
+            continue;
+
+        nnMax = -1;
+        for (j = 0; j < pOut->cn; j++) {
+            pArcOut = &pB->pArc[pOut->pn[j]];
+            if (pArcOut->nTo == iFrom || pB->pContracted[pArcOut->nTo])
+                continue;
+            if (pArcOut->nnCost > nnMax)
+                nnMax = pArcOut->nnCost;
+        }
+        if (nnMax < 0)
+            continue;
+        nnMax += pB->pArc[aIn].nnCost;
+
+        if (witness_search(pB, iFrom, iNode, nnMax) < 0)
+            return -1;
+
+        for (j = 0; j < pOut->cn; j++) {
+            aOut = pOut->pn[j];
+            pArcIn = &pB->pArc[aIn];
+            pArcOut = &pB->pArc[aOut];
+            iTo = pArcOut->nTo;
+            if (iTo == iFrom || pB->pContracted[iTo])
+                continue;
+            nnCost = pArcIn->nnCost + pArcOut->nnCost;
+            if (pB->pnnDist[iTo] <= nnCost)
+                continue; /* witness found */
+            cShortcut++;
+            if (fAdd &&
+                add_shortcut(pB, iFrom, iTo, nnCost, iNode, aIn, aOut) < 0)
+                return -1;
+        }
+        witness_reset(pB);
+    }
+
+    return cShortcut;
+}
+
+/* edge difference plus number of contracted neighbours */
+static int64_t priority(builder_s *pB, int32_t iNode)
+{
+    int32_t i, cShortcut, cRemoved;
+
+    cShortcut = contract(pB, iNode, 0);
+    if (cShortcut < 0)
+        return CH_UNREACHED;
+
+    cRemoved = 0;
+    for (i = 0; i < pB->pIn[iNode].cn; i++)
+        if (!pB->pContracted[pB->pArc[pB->pIn[iNode].pn[i]].nFrom])
+            cRemoved++;
+    for (i = 0; i < pB->pOut[iNode].cn; i++)
+        if (!pB->pContracted[pB->pArc[pB->pOut[iNode].pn[i]].nTo])
+            cRemoved++;
+
+    return (int64_t)cShortcut - cRemoved + pB->pnDeleted[iNode];
+}
+
+static void builder_release(builder_s *pB)
+{
+    int32_t i;
+
+    if (pB->pOut && pB->pIn) {
+        for (i = 0; i < pB->cNode; i++) {
+            free(pB->pOut[i].pn);
+            free(pB->pIn[i].pn);
+        }
+    }
+    free(pB->pOut);
+    free(pB->pIn);
+    free(pB->pContracted);
+    free(pB->pnDeleted);
+    free(pB->pnnDist);
+    free(pB->pnTouched);
+    free(pB->pHeap);
+}
+
+/* build arrays of up and down arcs for queries */
+static int index_arcs(dglCHIndex_s *pCH)
+{
+    dglCHArc_s *pArc;
+    int32_t i, *pnUp, *pnDown;
+
+    pCH->pnUp = calloc(pCH->cNode + 1, sizeof(int32_t));
+    pCH->pnDown = calloc(pCH->cNode + 1, sizeof(int32_t));
+    pCH->pnUpArc = malloc((pCH->cArc + 1) * sizeof(int32_t));
+    pCH->pnDownArc = malloc((pCH->cArc + 1) * sizeof(int32_t));
+    pnUp = calloc(pCH->cNode + 1, sizeof(int32_t));
+    pnDown = calloc(pCH->cNode + 1, sizeof(int32_t));
+    if (!pCH->pnUp || !pCH->pnDown || !pCH->pnUpArc || !pCH->pnDownArc ||
+        !pnUp || !pnDown) {
+        free(pnUp);
+        free(pnDown);
+        return -1;
+    }
+
+    for (i = 0; i < pCH->cArc; i++) {
+        pArc = &pCH->pArc[i];
+        if (pCH->pnRank[pArc->nTo] > pCH->pnRank[pArc->nFrom])
+            pCH->pnUp[pArc->nFrom + 1]++;
+        else
+            pCH->pnDown[pArc->nTo + 1]++;
+    }
+    for (i = 0; i < pCH->cNode; i++) {
+        pCH->pnUp[i + 1] += pCH->pnUp[i];
+        pCH->pnDown[i + 1] += pCH->pnDown[i];
+    }
+    for (i = 0; i < pCH->cArc; i++) {
+        pArc = &pCH->pArc[i];
+        if (pCH->pnRank[pArc->nTo] > pCH->pnRank[pArc->nFrom])
+            pCH->pnUpArc[pCH->pnUp[pArc->nFrom] + pnUp[pArc->nFrom]++] = i;
+        else
+            pCH->pnDownArc[pCH->pnDown[pArc->nTo] + pnDown[pArc->nTo]++] = i;
+    }
+    free(pnUp);
+    free(pnDown);
+
+    return 0;
+}
+
+/*!
+ * \brief Build contraction hierarchy of a flat graph
+ *
+ * \param pGraph flat graph
+ * \param pCH index to be initialized
+ * \param nFlags DGL_CH_NODECOST to consider node costs
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCHBuild(dglGraph_s *pGraph, dglCHIndex_s *pCH, int nFlags)
+{
+    builder_s b;
+    dglCHHeapItem_s item;
+    int32_t i, iNode, iOther, nRank;
+    int64_t nnPriority;
+    dglCHHeapItem_s *pQueue = NULL;
+    int32_t cQueue = 0, nQueueAlloc = 0;
+    int nRet;
+
+    memset(&b, 0, sizeof(b));
+    nRet = read_graph(pGraph, nFlags, pCH, &b.pArc, &b.cArc);
+    if (nRet < 0)
+        return nRet;
+
+    b.cNode = pCH->cNode;
+    b.nArcAlloc = b.cArc > 0 ? b.cArc : 1;
+    b.pOut = calloc(b.cNode + 1, sizeof(list_s));
+    b.pIn = calloc(b.cNode + 1, sizeof(list_s));
+    b.pContracted = calloc(b.cNode + 1, 1);
+    b.pnDeleted = calloc(b.cNode + 1, sizeof(int32_t));
+    b.pnnDist = malloc((b.cNode + 1) * sizeof(int64_t));
+    b.pnTouched = malloc((b.cNode + 1) * sizeof(int32_t));
+    pCH->pnRank = malloc((b.cNode + 1) * sizeof(int32_t));
+    if (!b.pOut || !b.pIn || !b.pContracted || !b.pnDeleted || !b.pnnDist ||
+        !b.pnTouched || !pCH->pnRank)
+        goto nomem;
+
+    for (i = 0; i < b.cNode; i++)
+        b.pnnDist[i] = CH_UNREACHED;
+    for (i = 0; i < b.cArc; i++) {
+        if (list_add(&b.pOut[b.pArc[i].nFrom], i) < 0 ||
+            list_add(&b.pIn[b.pArc[i].nTo], i) < 0)
+            goto nomem;
+    }
+
+    /* initial order */
+    for (i = 0; i < b.cNode; i++) {
+        nnPriority = priority(&b, i);
+        if (nnPriority == CH_UNREACHED ||
+            heap_push(&pQueue, &cQueue, &nQueueAlloc, nnPriority, i) < 0)
+            goto nomem;
+    }
+
+    /* contract nodes, priorities are updated lazily */
+    nRank = 0;
+    while (cQueue > 0) {
+        heap_pop(pQueue, &cQueue, &item);
+        iNode = item.iNode;
+        if (b.pContracted[iNode])
+            continue;
+
+        nnPriority = priority(&b, iNode);
+        if (nnPriority == CH_UNREACHED)
+            goto nomem;
+        if (cQueue > 0 && nnPriority > pQueue[0].nnKey) {
+            if (heap_push(&pQueue, &cQueue, &nQueueAlloc, nnPriority, iNode) <
+                0)
+                goto nomem;
+            continue;
+        }
+
+        if (contract(&b, iNode, 1) < 0)
+            goto nomem;
+        b.pContracted[iNode] = 1;
+        pCH->pnRank[iNode] = nRank++;
+
+        for (i = 0; i < b.pIn[iNode].cn; i++) {
+            iOther = b.pArc[b.pIn[iNode].pn[i]].nFrom;
+            if (!b.pContracted[iOther])
+                b.pnDeleted[iOther]++;
+        }
+        for (i = 0; i < b.pOut[iNode].cn; i++) {
+            iOther = b.pArc[b.pOut[iNode].pn[i]].nTo;
+            if (!b.pContracted[iOther])
+                b.pnDeleted[iOther]++;
+        }
+    }
+    free(pQueue);
+    pQueue = NULL;
+
+    pCH->pArc = b.pArc;
+    pCH->cArc = b.cArc;
+    b.pArc = NULL;
+    builder_release(&b);
+
+    if (index_arcs(pCH) < 0)
+        goto nomem;
+
+    return 0;
+
+nomem:
+    free(pQueue);
+    free(b.pArc);
+    builder_release(&b);
+    dglCHRelease(pCH);
+    pGraph->iErrno = DGL_ERR_MemoryExhausted;
+    return -pGraph->iErrno;
+}
+
+/*!
+ * \brief Checksum of the graph as used by dglCHBuild()
+ *
+ * An index read by dglCHRead() is valid for the graph if the checksums
+ * are equal.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCHChecksum(dglGraph_s *pGraph, int nFlags, uint64_t *pnnChecksum)
+{
+    dglCHIndex_s ch;
+    dglCHArc_s *pArc;
+    int32_t cArc;
+    int nRet;
+
+    nRet = read_graph(pGraph, nFlags, &ch, &pArc, &cArc);
+    if (nRet < 0)
+        return nRet;
+
+    *pnnChecksum = ch.nnChecksum;
+    free(pArc);
+    dglCHRelease(&ch);
+
+    return 0;
+}
+
+/*!
+ * \brief Release contraction hierarchy
+ */
+void dglCHRelease(dglCHIndex_s *pCH)
+{
+    free(pCH->pnNodeId);
+    free(pCH->pnRank);
+    free(pCH->pnnNodeCost);
+    free(pCH->pArc);
+    free(pCH->pnUp);
+    free(pCH->pnUpArc);
+    free(pCH->pnDown);
+    free(pCH->pnDownArc);
+    memset(pCH, 0, sizeof(dglCHIndex_s));
+}
+
+static int write_all(int fd, const void *pv, size_t cb)
+{
+    const char *pb = pv;
+    ssize_t n;
+
+    while (cb > 0) {
+        n = write(fd, pb, cb);
+        if (n <= 0)
+            return -1;
+        pb += n;
+        cb -= n;
+    }
+
+    return 0;
+}
+
+static int read_all(int fd, void *pv, size_t cb)
+{
+    char *pb = pv;
+    ssize_t n;
+
+    while (cb > 0) {
+        n = read(fd, pb, cb);
+        if (n <= 0)
+            return -1;
+        pb += n;
+        cb -= n;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Write contraction hierarchy to file descriptor
+ *
+ * The index is written in native byte order.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCHWrite(dglCHIndex_s *pCH, int fd)
+{
+    uint32_t nByteOrder = CH_BYTE_ORDER;
+    int32_t i;
+
+    if (write_all(fd, CH_MAGIC, 8) < 0 ||
+        write_all(fd, &nByteOrder, sizeof(nByteOrder)) < 0 ||
+        write_all(fd, &pCH->nFlags, sizeof(int)) < 0 ||
+        write_all(fd, &pCH->nnChecksum, sizeof(uint64_t)) < 0 ||
+        write_all(fd, &pCH->cNode, sizeof(int32_t)) < 0 ||
+        write_all(fd, &pCH->cArc, sizeof(int32_t)) < 0 ||
+        write_all(fd, pCH->pnNodeId, pCH->cNode * sizeof(int32_t)) < 0 ||
+        write_all(fd, pCH->pnRank, pCH->cNode * sizeof(int32_t)) < 0)
+        goto error;
+    if (pCH->pnnNodeCost &&
+        write_all(fd, pCH->pnnNodeCost, pCH->cNode * sizeof(int64_t)) < 0)
+        goto error;
+    for (i = 0; i < pCH->cArc; i++) {
+        dglCHArc_s *pArc = &pCH->pArc[i];
+
+        if (write_all(fd, &pArc->nFrom, sizeof(int32_t)) < 0 ||
+            write_all(fd, &pArc->nTo, sizeof(int32_t)) < 0 ||
+            write_all(fd, &pArc->nnCost, sizeof(int64_t)) < 0 ||
+            write_all(fd, &pArc->iMid, sizeof(int32_t)) < 0 ||
+            write_all(fd, &pArc->nA, sizeof(int32_t)) < 0 ||
+            write_all(fd, &pArc->nB, sizeof(int32_t)) < 0)
+            goto error;
+    }
+
+    return 0;
+
+error:
+    pCH->iErrno = DGL_ERR_Write;
+    return -pCH->iErrno;
+}
+
+/*!
+ * \brief Read contraction hierarchy written by dglCHWrite()
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCHRead(dglCHIndex_s *pCH, int fd)
+{
+    char achMagic[8];
+    uint32_t nByteOrder;
+    int32_t i;
+
+    memset(pCH, 0, sizeof(dglCHIndex_s));
+
+    if (read_all(fd, achMagic, 8) < 0 || memcmp(achMagic, CH_MAGIC, 8) ||
+        read_all(fd, &nByteOrder, sizeof(nByteOrder)) < 0)
+        goto error;
+    if (nByteOrder != CH_BYTE_ORDER) {
+        pCH->iErrno = DGL_ERR_UnknownByteOrder;
+        return -pCH->iErrno;
+    }
+    if (read_all(fd, &pCH->nFlags, sizeof(int)) < 0 ||
+        read_all(fd, &pCH->nnChecksum, sizeof(uint64_t)) < 0 ||
+        read_all(fd, &pCH->cNode, sizeof(int32_t)) < 0 ||
+        read_all(fd, &pCH->cArc, sizeof(int32_t)) < 0 || pCH->cNode < 0 ||
+        pCH->cArc < 0)
+        goto error;
+
+    pCH->pnNodeId = malloc((pCH->cNode + 1) * sizeof(int32_t));
+    pCH->pnRank = malloc((pCH->cNode + 1) * sizeof(int32_t));
+    pCH->pArc = malloc((pCH->cArc + 1) * sizeof(dglCHArc_s));
+    if (!pCH->pnNodeId || !pCH->pnRank || !pCH->pArc)
+        goto nomem;
+    if (read_all(fd, pCH->pnNodeId, pCH->cNode * sizeof(int32_t)) < 0 ||
+        read_all(fd, pCH->pnRank, pCH->cNode * sizeof(int32_t)) < 0)
+        goto error;
+    if (pCH->nFlags & DGL_CH_NODECOST) {
+        pCH->pnnNodeCost = malloc((pCH->cNode + 1) * sizeof(int64_t));
+        if (!pCH->pnnNodeCost)
+            goto nomem;
+        if (read_all(fd, pCH->pnnNodeCost, pCH->cNode * sizeof(int64_t)) < 0)
+            goto error;
+    }
+    for (i = 0; i < pCH->cArc; i++) {
+        dglCHArc_s *pArc = &pCH->pArc[i];
+
+        if (read_all(fd, &pArc->nFrom, sizeof(int32_t)) < 0 ||
+            read_all(fd, &pArc->nTo, sizeof(int32_t)) < 0 ||
+            read_all(fd, &pArc->nnCost, sizeof(int64_t)) < 0 ||
+            read_all(fd, &pArc->iMid, sizeof(int32_t)) < 0 ||
+            read_all(fd, &pArc->nA, sizeof(int32_t)) < 0 ||
+            read_all(fd, &pArc->nB, sizeof(int32_t)) < 0)
+            goto error;
+        if (pArc->nFrom < 0 || pArc->nFrom >= pCH->cNode || pArc->nTo < 0 ||
+            pArc->nTo >= pCH->cNode)
+            goto error;
+    }
+
+    if (index_arcs(pCH) < 0)
+        goto nomem;
+
+    return 0;
+
+error:
+    dglCHRelease(pCH);
+    pCH->iErrno = DGL_ERR_Read;
+    return -pCH->iErrno;
+
+nomem:
+    dglCHRelease(pCH);
+    pCH->iErrno = DGL_ERR_MemoryExhausted;
+    return -pCH->iErrno;
+}
+
+/*!
+ * \brief Initialize workspace for queries on contraction hierarchy
+ *
+ * Queries with different workspaces may run in parallel.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCHQueryInitialize(dglCHIndex_s *pCH, dglCHQuery_s *pQuery)
+{
+    int32_t i, d;
+
+    memset(pQuery, 0, sizeof(dglCHQuery_s));
+    pQuery->pCH = pCH;
+
+    for (d = 0; d < 2; d++) {
+        pQuery->pnnDist[d] = malloc((pCH->cNode + 1) * sizeof(int64_t));
+        pQuery->pnPred[d] = malloc((pCH->cNode + 1) * sizeof(int32_t));
+        pQuery->pnTouched[d] = malloc((pCH->cNode + 1) * sizeof(int32_t));
+        if (!pQuery->pnnDist[d] || !pQuery->pnPred[d] ||
+            !pQuery->pnTouched[d]) {
+            dglCHQueryRelease(pQuery);
+            return -DGL_ERR_MemoryExhausted;
+        }
+        for (i = 0; i < pCH->cNode; i++)
+            pQuery->pnnDist[d][i] = CH_UNREACHED;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Release workspace for queries
+ */
+void dglCHQueryRelease(dglCHQuery_s *pQuery)
+{
+    int d;
+
+    for (d = 0; d < 2; d++) {
+        free(pQuery->pnnDist[d]);
+        free(pQuery->pnPred[d]);
+        free(pQuery->pnTouched[d]);
+        free(pQuery->pHeap[d]);
+    }
+    free(pQuery->pnStack);
+    free(pQuery->pnEdge);
+    memset(pQuery, 0, sizeof(dglCHQuery_s));
+}
+
+static int push_stack(dglCHQuery_s *pQuery, int32_t *pcStack, int32_t iArc)
+{
+    int32_t *pn;
+
+    if (*pcStack == pQuery->nStackAlloc) {
+        pQuery->nStackAlloc =
+            pQuery->nStackAlloc ? pQuery->nStackAlloc * 2 : 64;
+        pn = realloc(pQuery->pnStack, pQuery->nStackAlloc * sizeof(int32_t));
+        if (pn == NULL)
+            return -1;
+        pQuery->pnStack = pn;
+    }
+    pQuery->pnStack[(*pcStack)++] = iArc;
+
+    return 0;
+}
+
+/* append graph edges of arc to the path */
+static int unpack_arc(dglCHQuery_s *pQuery, int32_t iArc)
+{
+    dglCHArc_s *pArc;
+    dglInt32_t *pn;
+    int32_t cStack;
+
+    cStack = 0;
+    if (push_stack(pQuery, &cStack, iArc) < 0)
+        return -1;
+
+    while (cStack > 0) {
+        pArc = &pQuery->pCH->pArc[pQuery->pnStack[--cStack]];
+        if (pArc->iMid >= 0) {
+            if (push_stack(pQuery, &cStack, pArc->nB) < 0 ||
+                push_stack(pQuery, &cStack, pArc->nA) < 0)
+                return -1;
+            continue;
+        }
+        if (pQuery->cEdge == pQuery->nEdgeAlloc) {
+            pQuery->nEdgeAlloc = pQuery->nEdgeAlloc ? pQuery->nEdgeAlloc * 2
+                                                    : 64;
+            pn = realloc(pQuery->pnEdge,
+                         pQuery->nEdgeAlloc * sizeof(dglInt32_t));
+            if (pn == NULL)
+                return -1;
+            pQuery->pnEdge = pn;
+        }
+        pQuery->pnEdge[pQuery->cEdge++] = pArc->nA;
+    }
+
+    return 0;
+}
+
+/* collect path from the meeting node */
+static int unpack_path(dglCHQuery_s *pQuery, int32_t iSource, int32_t iMeet,
+                       int32_t iTarget)
+{
+    dglCHIndex_s *pCH = pQuery->pCH;
+    int32_t i, iNode, cArc, *pnArc;
+
+    /* forward arcs are collected backwards */
+    cArc = 0;
+    for (iNode = iMeet; iNode != iSource;
+         iNode = pCH->pArc[pQuery->pnPred[0][iNode]].nFrom)
+        cArc++;
+    pnArc = malloc((cArc + 1) * sizeof(int32_t));
+    if (pnArc == NULL)
+        return -1;
+    i = cArc;
+    for (iNode = iMeet; iNode != iSource;
+         iNode = pCH->pArc[pQuery->pnPred[0][iNode]].nFrom)
+        pnArc[--i] = pQuery->pnPred[0][iNode];
+
+    pQuery->cEdge = 0;
+    for (i = 0; i < cArc; i++) {
+        if (unpack_arc(pQuery, pnArc[i]) < 0) {
+            free(pnArc);
+            return -1;
+        }
+    }
+    free(pnArc);
+
+    for (iNode = iMeet; iNode != iTarget;
+         iNode = pCH->pArc[pQuery->pnPred[1][iNode]].nTo) {
+        if (unpack_arc(pQuery, pQuery->pnPred[1][iNode]) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Shortest path on contraction hierarchy
+ *
+ * With fPath != 0 the edge ids of the path are stored in pQuery->pnEdge
+ * (pQuery->cEdge edges) until the next query.
+ *
+ * \param pQuery workspace initialized by dglCHQueryInitialize()
+ * \param nFrom from node id
+ * \param nTo to node id
+ * \param[out] pnDistance path cost
+ * \param fPath collect the edges of the path
+ *
+ * \return 1 if path was found
+ * \return 0 if nTo is unreachable
+ * \return negative error code on failure
+ */
+int dglCHShortestPath(dglCHQuery_s *pQuery, dglInt32_t nFrom, dglInt32_t nTo,
+                      dglInt64_t *pnDistance, int fPath)
+{
+    dglCHIndex_s *pCH = pQuery->pCH;
+    dglCHHeapItem_s item;
+    dglCHArc_s *pArc;
+    int32_t iSource, iTarget, iMeet, iNode, iArc, i, d;
+    int64_t nnBest, nnDist, nnStart;
+    int nRet;
+
+    pQuery->cEdge = 0;
+    iSource = node_index(pCH, nFrom);
+    iTarget = node_index(pCH, nTo);
+    if (iSource < 0 || iTarget < 0) {
+        pQuery->iErrno = DGL_ERR_NodeNotFound;
+        return -pQuery->iErrno;
+    }
+
+    if (iSource == iTarget) {
+        *pnDistance = 0;
+        return 1;
+    }
+
+    /* the cost of leaving the source is included in the forward distances
+       to keep them positive, it is subtracted from the result */
+    nnStart = pCH->pnnNodeCost ? pCH->pnnNodeCost[iSource] : 0;
+
+    pQuery->pnnDist[0][iSource] = 0;
+    pQuery->pnnDist[1][iTarget] = 0;
+    pQuery->pnTouched[0][0] = iSource;
+    pQuery->pnTouched[1][0] = iTarget;
+    pQuery->cTouched[0] = pQuery->cTouched[1] = 1;
+    pQuery->cHeap[0] = pQuery->cHeap[1] = 0;
+    if (heap_push(&pQuery->pHeap[0], &pQuery->cHeap[0],
+                  &pQuery->nHeapAlloc[0], 0, iSource) < 0 ||
+        heap_push(&pQuery->pHeap[1], &pQuery->cHeap[1],
+                  &pQuery->nHeapAlloc[1], 0, iTarget) < 0)
+        goto nomem;
+
+    nnBest = CH_UNREACHED;
+    iMeet = -1;
+    d = 1;
+    while (pQuery->cHeap[0] > 0 || pQuery->cHeap[1] > 0) {
+        /* alternate directions */
+        if (pQuery->cHeap[1 - d] > 0)
+            d = 1 - d;
+
+        heap_pop(pQuery->pHeap[d], &pQuery->cHeap[d], &item);
+        iNode = item.iNode;
+        if (item.nnKey > pQuery->pnnDist[d][iNode])
+            continue;
+        if (item.nnKey >= nnBest) {
+            pQuery->cHeap[d] = 0; /* this direction is done */
+            continue;
+        }
+
+        if (pQuery->pnnDist[1 - d][iNode] != CH_UNREACHED &&
+            item.nnKey + pQuery->pnnDist[1 - d][iNode] < nnBest) {
+            nnBest = item.nnKey + pQuery->pnnDist[1 - d][iNode];
+            iMeet = iNode;
+        }
+
+        if (d == 0) {
+            for (i = pCH->pnUp[iNode]; i < pCH->pnUp[iNode + 1]; i++) {
+                iArc = pCH->pnUpArc[i];
+                pArc = &pCH->pArc[iArc];
+                nnDist = item.nnKey + pArc->nnCost;
+                if (nnDist < pQuery->pnnDist[0][pArc->nTo]) {
+                    if (pQuery->pnnDist[0][pArc->nTo] == CH_UNREACHED)
+                        pQuery->pnTouched[0][pQuery->cTouched[0]++] =
+                            pArc->nTo;
+                    pQuery->pnnDist[0][pArc->nTo] = nnDist;
+                    pQuery->pnPred[0][pArc->nTo] = iArc;
+                    if (heap_push(&pQuery->pHeap[0], &pQuery->cHeap[0],
+                                  &pQuery->nHeapAlloc[0], nnDist,
+                                  pArc->nTo) < 0)
+                        goto nomem;
+                }
+            }
+        }
+        else {
+            for (i = pCH->pnDown[iNode]; i < pCH->pnDown[iNode + 1]; i++) {
+                iArc = pCH->pnDownArc[i];
+                pArc = &pCH->pArc[iArc];
+                nnDist = item.nnKey + pArc->nnCost;
+                if (nnDist < pQuery->pnnDist[1][pArc->nFrom]) {
+                    if (pQuery->pnnDist[1][pArc->nFrom] == CH_UNREACHED)
+                        pQuery->pnTouched[1][pQuery->cTouched[1]++] =
+                            pArc->nFrom;
+                    pQuery->pnnDist[1][pArc->nFrom] = nnDist;
+                    pQuery->pnPred[1][pArc->nFrom] = iArc;
+                    if (heap_push(&pQuery->pHeap[1], &pQuery->cHeap[1],
+                                  &pQuery->nHeapAlloc[1], nnDist,
+                                  pArc->nFrom) < 0)
+                        goto nomem;
+                }
+            }
+        }
+    }
+
+    /* paths over closed nodes are not valid */
+    nRet = 0;
+    if (iMeet >= 0 && nnBest - nnStart < CH_CLOSED) {
+        nRet = 1;
+        *pnDistance = nnBest - nnStart;
+        if (fPath && unpack_path(pQuery, iSource, iMeet, iTarget) < 0)
+            goto nomem;
+    }
+
+    for (d = 0; d < 2; d++) {
+        for (i = 0; i < pQuery->cTouched[d]; i++)
+            pQuery->pnnDist[d][pQuery->pnTouched[d][i]] = CH_UNREACHED;
+        pQuery->cTouched[d] = 0;
+    }
+
+    return nRet;
+
+nomem:
+    for (d = 0; d < 2; d++) {
+        for (i = 0; i < pQuery->cTouched[d]; i++)
+            pQuery->pnnDist[d][pQuery->pnTouched[d][i]] = CH_UNREACHED;
+        pQuery->cTouched[d] = 0;
+    }
+    pQuery->iErrno = DGL_ERR_MemoryExhausted;
+    return -pQuery->iErrno;
+}
@@ -0,0 +1,97 @@
+/* LIBDGL -- a Directed Graph Library implementation
+ * Copyright (C) 2002 Roberto Micarelli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Contraction hierarchy index for shortest path queries
+ */
+
+#ifndef _DGL_CH_H_
+#define _DGL_CH_H_
+
+#include <stdint.h>
+
+/*
+ * build flags
+ */
+#define DGL_CH_NODECOST 0x1 /* the first dglInt32_t of node attributes is
+                               the cost of passing through the node, -1
+                               means closed node (Vlib convention) */
+
+/*
+ * arc of the hierarchy, either an edge of the graph or a shortcut over a
+ * contracted node
+ */
+typedef struct _dglCHArc {
+    int32_t nFrom, nTo; /* node indexes */
+    int64_t nnCost;
+    int32_t iMid; /* -1 for graph edge, index of contracted node otherwise */
+    int32_t nA;   /* graph edge: edge id; shortcut: arc nFrom -> iMid */
+    int32_t nB;   /* shortcut: arc iMid -> nTo */
+} dglCHArc_s;
+
+typedef struct _dglCHIndex {
+    int iErrno;
+    int nFlags;
+    uint64_t nnChecksum; /* checksum of the graph the index was built for */
+    int32_t cNode;
+    int32_t *pnNodeId; /* node ids by index, ascending */
+    int32_t *pnRank;   /* contraction order by index */
+    int64_t *pnnNodeCost; /* cost of leaving node, NULL without node costs */
+    int32_t cArc;
+    dglCHArc_s *pArc;
+    int32_t *pnUp;      /* cNode + 1 offsets to pnUpArc */
+    int32_t *pnUpArc;   /* arcs to nodes of higher rank */
+    int32_t *pnDown;    /* cNode + 1 offsets to pnDownArc */
+    int32_t *pnDownArc; /* arcs from nodes of higher rank */
+} dglCHIndex_s;
+
+typedef struct _dglCHHeapItem {
+    int64_t nnKey;
+    int32_t iNode;
+} dglCHHeapItem_s;
+
+/*
+ * workspace of queries, each thread needs its own
+ */
+typedef struct _dglCHQuery {
+    dglCHIndex_s *pCH;
+    int iErrno;
+    int64_t *pnnDist[2]; /* forward and backward distances */
+    int32_t *pnPred[2];  /* arc reaching the node */
+    int32_t *pnTouched[2];
+    int32_t cTouched[2];
+    dglCHHeapItem_s *pHeap[2];
+    int32_t cHeap[2], nHeapAlloc[2];
+    int32_t *pnStack;
+    int32_t nStackAlloc;
+    dglInt32_t *pnEdge; /* edge ids of the last path */
+    int32_t cEdge, nEdgeAlloc;
+} dglCHQuery_s;
+
+int dglCHBuild(dglGraph_s *pGraph, dglCHIndex_s *pCH, int nFlags);
+int dglCHChecksum(dglGraph_s *pGraph, int nFlags, uint64_t *pnnChecksum);
+void dglCHRelease(dglCHIndex_s *pCH);
+int dglCHWrite(dglCHIndex_s *pCH, int fd);
+int dglCHRead(dglCHIndex_s *pCH, int fd);
+
+int dglCHQueryInitialize(dglCHIndex_s *pCH, dglCHQuery_s *pQuery);
+void dglCHQueryRelease(dglCHQuery_s *pQuery);
+int dglCHShortestPath(dglCHQuery_s *pQuery, dglInt32_t nFrom, dglInt32_t nTo,
+                      dglInt64_t *pnDistance, int fPath);
+
+#endif
@@ -0,0 +1,757 @@
+/* LIBDGL -- a Directed Graph Library implementation
+ * Copyright (C) 2002 Roberto Micarelli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Compressed sparse row (CSR) graph.
+ *
+ * Edges are collected in plain arrays and sorted by their from node with
+ * a counting sort when the graph is finalized. The out edges of the node
+ * with index i are then pnOut[i] ... pnOut[i + 1] - 1 in the edge arrays,
+ * nodes are referenced by their index. Unlike the tree based graphs, no
+ * per node or per edge allocations are made, which keeps building fast
+ * and the memory footprint small for large networks. The arrays are
+ * written to and read from a file as they are.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <grass/gis.h>
+#include "type.h"
+#include "tree.h"
+#include "graph.h"
+#include "csr.h"
+
+#define CSR_MAGIC      "DGLCSR01"
+#define CSR_BYTE_ORDER 0x01020304
+#define CSR_UNREACHED  INT64_MAX
+
+/* binary min-heap, stale items are skipped by the caller */
+static int heap_push(dglCSRQuery_s *pQuery, int64_t nnKey, int32_t iNode)
+{
+    dglCSRHeapItem_s *pHeap;
+    int32_t i, parent;
+
+    if (pQuery->cHeap == pQuery->nHeapAlloc) {
+        pQuery->nHeapAlloc = pQuery->nHeapAlloc ? pQuery->nHeapAlloc * 2 : 256;
+        pHeap = realloc(pQuery->pHeap,
+                        pQuery->nHeapAlloc * sizeof(dglCSRHeapItem_s));
+        if (pHeap == NULL)
+            return -1;
+        pQuery->pHeap = pHeap;
+    }
+    pHeap = pQuery->pHeap;
+
+    for (i = pQuery->cHeap++; i > 0; i = parent) {
+        parent = (i - 1) / 2;
+        if (pHeap[parent].nnKey <= nnKey)
+            break;
+        pHeap[i] = pHeap[parent];
+    }
+    pHeap[i].nnKey = nnKey;
+    pHeap[i].iNode = iNode;
+
+    return 0;
+}
+
+static void heap_pop(dglCSRQuery_s *pQuery, dglCSRHeapItem_s *pItem)
+{
+    dglCSRHeapItem_s *pHeap = pQuery->pHeap, last;
+    int32_t i, child, n;
+
+    *pItem = pHeap[0];
+    n = --pQuery->cHeap;
+    last = pHeap[n];
+
+    for (i = 0; (child = 2 * i + 1) < n; i = child) {
+        if (child + 1 < n && pHeap[child + 1].nnKey < pHeap[child].nnKey)
+            child++;
+        if (last.nnKey <= pHeap[child].nnKey)
+            break;
+        pHeap[i] = pHeap[child];
+    }
+    pHeap[i] = last;
+}
+
+static int compare_id(const void *pa, const void *pb)
+{
+    int32_t a = *(const int32_t *)pa, b = *(const int32_t *)pb;
+
+    return (a > b) - (a < b);
+}
+
+/*!
+ * \brief Initialize empty graph
+ *
+ * Edges are added by dglCSRAddEdge(), the graph can be used after
+ * dglCSRFinalize().
+ *
+ * \param pCSR graph
+ * \param nFlags DGL_CSR_NODECOST or 0
+ *
+ * \return 0 on success
+ */
+int dglCSRInitialize(dglCSRGraph_s *pCSR, int nFlags)
+{
+    memset(pCSR, 0, sizeof(dglCSRGraph_s));
+    pCSR->nFlags = nFlags;
+
+    return 0;
+}
+
+/*!
+ * \brief Add edge to graph which is not finalized
+ *
+ * Parallel edges are kept, their order is preserved.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRAddEdge(dglCSRGraph_s *pCSR, dglInt32_t nFrom, dglInt32_t nTo,
+                  dglInt32_t nCost, dglInt32_t nId)
+{
+    int32_t nAlloc;
+    void *p;
+
+    if (pCSR->pnOut) {
+        pCSR->iErrno = DGL_ERR_BadOnFlatGraph;
+        return -pCSR->iErrno;
+    }
+
+    if (pCSR->cEdge == pCSR->nEdgeAlloc) {
+        nAlloc = pCSR->nEdgeAlloc ? pCSR->nEdgeAlloc * 2 : 1024;
+        if ((p = realloc(pCSR->pnFrom, nAlloc * sizeof(int32_t))) == NULL)
+            goto nomem;
+        pCSR->pnFrom = p;
+        if ((p = realloc(pCSR->pnTo, nAlloc * sizeof(int32_t))) == NULL)
+            goto nomem;
+        pCSR->pnTo = p;
+        if ((p = realloc(pCSR->pnCost, nAlloc * sizeof(int32_t))) == NULL)
+            goto nomem;
+        pCSR->pnCost = p;
+        if ((p = realloc(pCSR->pnEdgeId, nAlloc * sizeof(int32_t))) == NULL)
+            goto nomem;
+        pCSR->pnEdgeId = p;
+        pCSR->nEdgeAlloc = nAlloc;
+    }
+
+    pCSR->pnFrom[pCSR->cEdge] = nFrom;
+    pCSR->pnTo[pCSR->cEdge] = nTo;
+    pCSR->pnCost[pCSR->cEdge] = nCost;
+    pCSR->pnEdgeId[pCSR->cEdge] = nId;
+    pCSR->cEdge++;
+
+    return 0;
+
+nomem:
+    pCSR->iErrno = DGL_ERR_MemoryExhausted;
+    return -pCSR->iErrno;
+}
+
+/* sorted unique node ids of all edges */
+static int collect_nodes(dglCSRGraph_s *pCSR, int32_t **ppnMap,
+                         int32_t *pnMinId)
+{
+    int32_t i, j, nMin, nMax, *pnMap, *pnId;
+
+    *ppnMap = NULL;
+    nMin = nMax = pCSR->cEdge > 0 ? pCSR->pnFrom[0] : 0;
+    for (i = 0; i < pCSR->cEdge; i++) {
+        if (pCSR->pnFrom[i] < nMin)
+            nMin = pCSR->pnFrom[i];
+        if (pCSR->pnFrom[i] > nMax)
+            nMax = pCSR->pnFrom[i];
+        if (pCSR->pnTo[i] < nMin)
+            nMin = pCSR->pnTo[i];
+        if (pCSR->pnTo[i] > nMax)
+            nMax = pCSR->pnTo[i];
+    }
+
+    if ((int64_t)nMax - nMin < 4 * (int64_t)pCSR->cEdge + 1024) {
+        /* dense ids (vector map nodes): map id to index directly */
+        pnMap = calloc((size_t)(nMax - nMin) + 1, sizeof(int32_t));
+        if (pnMap == NULL)
+            return -1;
+        for (i = 0; i < pCSR->cEdge; i++) {
+            pnMap[pCSR->pnFrom[i] - nMin] = 1;
+            pnMap[pCSR->pnTo[i] - nMin] = 1;
+        }
+        pCSR->cNode = 0;
+        for (i = 0; i <= nMax - nMin; i++)
+            pCSR->cNode += pnMap[i];
+        pCSR->pnNodeId = malloc((pCSR->cNode + 1) * sizeof(int32_t));
+        if (pCSR->pnNodeId == NULL) {
+            free(pnMap);
+            return -1;
+        }
+        for (i = j = 0; i <= nMax - nMin; i++) {
+            if (pnMap[i]) {
+                pCSR->pnNodeId[j] = nMin + i;
+                pnMap[i] = j++;
+            }
+        }
+        *ppnMap = pnMap;
+        *pnMinId = nMin;
+
+        return 0;
+    }
+
+    /* sparse ids: sort */
+    pnId = malloc(((size_t)pCSR->cEdge * 2 + 1) * sizeof(int32_t));
+    if (pnId == NULL)
+        return -1;
+    memcpy(pnId, pCSR->pnFrom, pCSR->cEdge * sizeof(int32_t));
+    memcpy(pnId + pCSR->cEdge, pCSR->pnTo, pCSR->cEdge * sizeof(int32_t));
+    qsort(pnId, (size_t)pCSR->cEdge * 2, sizeof(int32_t), compare_id);
+    for (i = j = 0; i < 2 * pCSR->cEdge; i++) {
+        if (j > 0 && pnId[i] == pnId[j - 1])
+            continue;
+        pnId[j++] = pnId[i];
+    }
+    pCSR->cNode = j;
+    pCSR->pnNodeId = realloc(pnId, (j + 1) * sizeof(int32_t));
+    if (pCSR->pnNodeId == NULL) {
+        pCSR->pnNodeId = pnId;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Finalize graph
+ *
+ * Nodes are the from and to nodes of the added edges. Edges are sorted
+ * by their from node, edges cannot be added afterwards.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRFinalize(dglCSRGraph_s *pCSR)
+{
+    int32_t i, iFrom, nMinId, *pnMap, *pnPos;
+    int32_t *pnTo, *pnCost, *pnEdgeId;
+
+    if (pCSR->pnOut) {
+        pCSR->iErrno = DGL_ERR_BadOnFlatGraph;
+        return -pCSR->iErrno;
+    }
+
+    if (collect_nodes(pCSR, &pnMap, &nMinId) < 0)
+        goto nomem;
+
+    /* node ids to indexes */
+    for (i = 0; i < pCSR->cEdge; i++) {
+        if (pnMap) {
+            pCSR->pnFrom[i] = pnMap[pCSR->pnFrom[i] - nMinId];
+            pCSR->pnTo[i] = pnMap[pCSR->pnTo[i] - nMinId];
+        }
+        else {
+            pCSR->pnFrom[i] = dglCSRNodeIndex(pCSR, pCSR->pnFrom[i]);
+            pCSR->pnTo[i] = dglCSRNodeIndex(pCSR, pCSR->pnTo[i]);
+        }
+    }
+    free(pnMap);
+
+    /* counting sort by from node */
+    pCSR->pnOut = calloc(pCSR->cNode + 1, sizeof(int32_t));
+    pnPos = malloc((pCSR->cNode + 1) * sizeof(int32_t));
+    pnTo = malloc((pCSR->cEdge + 1) * sizeof(int32_t));
+    pnCost = malloc((pCSR->cEdge + 1) * sizeof(int32_t));
+    pnEdgeId = malloc((pCSR->cEdge + 1) * sizeof(int32_t));
+    if (!pCSR->pnOut || !pnPos || !pnTo || !pnCost || !pnEdgeId) {
+        free(pnPos);
+        free(pnTo);
+        free(pnCost);
+        free(pnEdgeId);
+        goto nomem;
+    }
+    for (i = 0; i < pCSR->cEdge; i++)
+        pCSR->pnOut[pCSR->pnFrom[i] + 1]++;
+    for (i = 0; i < pCSR->cNode; i++) {
+        pCSR->pnOut[i + 1] += pCSR->pnOut[i];
+        pnPos[i] = pCSR->pnOut[i];
+    }
+    for (i = 0; i < pCSR->cEdge; i++) {
+        iFrom = pCSR->pnFrom[i];
+        pnTo[pnPos[iFrom]] = pCSR->pnTo[i];
+        pnCost[pnPos[iFrom]] = pCSR->pnCost[i];
+        pnEdgeId[pnPos[iFrom]] = pCSR->pnEdgeId[i];
+        pnPos[iFrom]++;
+    }
+    free(pnPos);
+    free(pCSR->pnFrom);
+    free(pCSR->pnTo);
+    free(pCSR->pnCost);
+    free(pCSR->pnEdgeId);
+    pCSR->pnFrom = NULL;
+    pCSR->nEdgeAlloc = 0;
+    pCSR->pnTo = pnTo;
+    pCSR->pnCost = pnCost;
+    pCSR->pnEdgeId = pnEdgeId;
+
+    if (pCSR->nFlags & DGL_CSR_NODECOST) {
+        pCSR->pnNodeCost = calloc(pCSR->cNode + 1, sizeof(int32_t));
+        if (pCSR->pnNodeCost == NULL)
+            goto nomem;
+    }
+
+    return 0;
+
+nomem:
+    pCSR->iErrno = DGL_ERR_MemoryExhausted;
+    return -pCSR->iErrno;
+}
+
+/*!
+ * \brief Set cost of node of finalized graph
+ *
+ * \param pCSR graph initialized with DGL_CSR_NODECOST
+ * \param nNode node id
+ * \param nCost cost of passing through the node, -1 for closed node
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRSetNodeCost(dglCSRGraph_s *pCSR, dglInt32_t nNode, dglInt32_t nCost)
+{
+    int32_t i;
+
+    if (pCSR->pnNodeCost == NULL) {
+        pCSR->iErrno = DGL_ERR_BadArgument;
+        return -pCSR->iErrno;
+    }
+    i = dglCSRNodeIndex(pCSR, nNode);
+    if (i < 0) {
+        pCSR->iErrno = DGL_ERR_NodeNotFound;
+        return -pCSR->iErrno;
+    }
+    pCSR->pnNodeCost[i] = nCost;
+
+    return 0;
+}
+
+/*!
+ * \brief Index of node
+ *
+ * \return index of node, -1 if the node is not in the graph
+ */
+int32_t dglCSRNodeIndex(dglCSRGraph_s *pCSR, dglInt32_t nNode)
+{
+    int32_t id = nNode;
+    int32_t *pn;
+
+    if (nNode != (dglInt32_t)id || pCSR->cNode == 0)
+        return -1;
+    pn = bsearch(&id, pCSR->pnNodeId, pCSR->cNode, sizeof(int32_t),
+                 compare_id);
+
+    return pn ? (int32_t)(pn - pCSR->pnNodeId) : -1;
+}
+
+/*!
+ * \brief Set data saved together with the graph
+ *
+ * The data are copied, they are written and read as they are.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRSetUserData(dglCSRGraph_s *pCSR, const void *pv, int32_t cb)
+{
+    void *p = NULL;
+
+    if (cb > 0) {
+        if ((p = malloc(cb)) == NULL) {
+            pCSR->iErrno = DGL_ERR_MemoryExhausted;
+            return -pCSR->iErrno;
+        }
+        memcpy(p, pv, cb);
+    }
+    free(pCSR->pvUser);
+    pCSR->pvUser = p;
+    pCSR->cbUser = cb > 0 ? cb : 0;
+
+    return 0;
+}
+
+/*!
+ * \brief Release graph
+ */
+void dglCSRRelease(dglCSRGraph_s *pCSR)
+{
+    free(pCSR->pnNodeId);
+    free(pCSR->pnNodeCost);
+    free(pCSR->pnOut);
+    free(pCSR->pnFrom);
+    free(pCSR->pnTo);
+    free(pCSR->pnCost);
+    free(pCSR->pnEdgeId);
+    free(pCSR->pvUser);
+    memset(pCSR, 0, sizeof(dglCSRGraph_s));
+}
+
+static int write_all(int fd, const void *pv, size_t cb)
+{
+    const char *pb = pv;
+    ssize_t n;
+
+    while (cb > 0) {
+        n = write(fd, pb, cb);
+        if (n <= 0)
+            return -1;
+        pb += n;
+        cb -= n;
+    }
+
+    return 0;
+}
+
+static int read_all(int fd, void *pv, size_t cb)
+{
+    char *pb = pv;
+    ssize_t n;
+
+    while (cb > 0) {
+        n = read(fd, pb, cb);
+        if (n <= 0)
+            return -1;
+        pb += n;
+        cb -= n;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Write finalized graph to file descriptor
+ *
+ * The graph is written in native byte order.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRWrite(dglCSRGraph_s *pCSR, int fd)
+{
+    uint32_t nByteOrder = CSR_BYTE_ORDER;
+    size_t cbNode, cbEdge;
+
+    if (pCSR->pnOut == NULL) {
+        pCSR->iErrno = DGL_ERR_BadOnTreeGraph;
+        return -pCSR->iErrno;
+    }
+
+    cbNode = (size_t)pCSR->cNode * sizeof(int32_t);
+    cbEdge = (size_t)pCSR->cEdge * sizeof(int32_t);
+    if (write_all(fd, CSR_MAGIC, 8) < 0 ||
+        write_all(fd, &nByteOrder, sizeof(nByteOrder)) < 0 ||
+        write_all(fd, &pCSR->nFlags, sizeof(int)) < 0 ||
+        write_all(fd, &pCSR->nnKey, sizeof(uint64_t)) < 0 ||
+        write_all(fd, &pCSR->cNode, sizeof(int32_t)) < 0 ||
+        write_all(fd, &pCSR->cEdge, sizeof(int32_t)) < 0 ||
+        write_all(fd, &pCSR->cbUser, sizeof(int32_t)) < 0 ||
+        write_all(fd, pCSR->pnNodeId, cbNode) < 0 ||
+        write_all(fd, pCSR->pnOut, cbNode + sizeof(int32_t)) < 0 ||
+        write_all(fd, pCSR->pnTo, cbEdge) < 0 ||
+        write_all(fd, pCSR->pnCost, cbEdge) < 0 ||
+        write_all(fd, pCSR->pnEdgeId, cbEdge) < 0)
+        goto error;
+    if (pCSR->pnNodeCost && write_all(fd, pCSR->pnNodeCost, cbNode) < 0)
+        goto error;
+    if (pCSR->cbUser > 0 && write_all(fd, pCSR->pvUser, pCSR->cbUser) < 0)
+        goto error;
+
+    return 0;
+
+error:
+    pCSR->iErrno = DGL_ERR_Write;
+    return -pCSR->iErrno;
+}
+
+/*!
+ * \brief Read graph written by dglCSRWrite()
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRRead(dglCSRGraph_s *pCSR, int fd)
+{
+    char achMagic[8];
+    uint32_t nByteOrder;
+    size_t cbNode, cbEdge;
+    int32_t i;
+
+    memset(pCSR, 0, sizeof(dglCSRGraph_s));
+
+    if (read_all(fd, achMagic, 8) < 0 || memcmp(achMagic, CSR_MAGIC, 8) ||
+        read_all(fd, &nByteOrder, sizeof(nByteOrder)) < 0)
+        goto error;
+    if (nByteOrder != CSR_BYTE_ORDER) {
+        pCSR->iErrno = DGL_ERR_UnknownByteOrder;
+        return -pCSR->iErrno;
+    }
+    if (read_all(fd, &pCSR->nFlags, sizeof(int)) < 0 ||
+        read_all(fd, &pCSR->nnKey, sizeof(uint64_t)) < 0 ||
+        read_all(fd, &pCSR->cNode, sizeof(int32_t)) < 0 ||
+        read_all(fd, &pCSR->cEdge, sizeof(int32_t)) < 0 ||
+        read_all(fd, &pCSR->cbUser, sizeof(int32_t)) < 0 ||
+        pCSR->cNode < 0 || pCSR->cEdge < 0 || pCSR->cbUser < 0)
+        goto error;
+
+    cbNode = (size_t)pCSR->cNode * sizeof(int32_t);
+    cbEdge = (size_t)pCSR->cEdge * sizeof(int32_t);
+    pCSR->pnNodeId = malloc(cbNode + sizeof(int32_t));
+    pCSR->pnOut = malloc(cbNode + sizeof(int32_t));
+    pCSR->pnTo = malloc(cbEdge + sizeof(int32_t));
+    pCSR->pnCost = malloc(cbEdge + sizeof(int32_t));
+    pCSR->pnEdgeId = malloc(cbEdge + sizeof(int32_t));
+    if (!pCSR->pnNodeId || !pCSR->pnOut || !pCSR->pnTo || !pCSR->pnCost ||
+        !pCSR->pnEdgeId)
+        goto nomem;
+    if (read_all(fd, pCSR->pnNodeId, cbNode) < 0 ||
+        read_all(fd, pCSR->pnOut, cbNode + sizeof(int32_t)) < 0 ||
+        read_all(fd, pCSR->pnTo, cbEdge) < 0 ||
+        read_all(fd, pCSR->pnCost, cbEdge) < 0 ||
+        read_all(fd, pCSR->pnEdgeId, cbEdge) < 0)
+        goto error;
+    if (pCSR->nFlags & DGL_CSR_NODECOST) {
+        pCSR->pnNodeCost = malloc(cbNode + sizeof(int32_t));
+        if (pCSR->pnNodeCost == NULL)
+            goto nomem;
+        if (read_all(fd, pCSR->pnNodeCost, cbNode) < 0)
+            goto error;
+    }
+    if (pCSR->cbUser > 0) {
+        pCSR->pvUser = malloc(pCSR->cbUser);
+        if (pCSR->pvUser == NULL)
+            goto nomem;
+        if (read_all(fd, pCSR->pvUser, pCSR->cbUser) < 0)
+            goto error;
+    }
+
+    /* a damaged file must not crash queries */
+    if (pCSR->pnOut[0] != 0 || pCSR->pnOut[pCSR->cNode] != pCSR->cEdge)
+        goto error;
+    for (i = 0; i < pCSR->cNode; i++) {
+        if (pCSR->pnOut[i + 1] < pCSR->pnOut[i] ||
+            (i > 0 && pCSR->pnNodeId[i] <= pCSR->pnNodeId[i - 1]))
+            goto error;
+    }
+    for (i = 0; i < pCSR->cEdge; i++) {
+        if (pCSR->pnTo[i] < 0 || pCSR->pnTo[i] >= pCSR->cNode)
+            goto error;
+    }
+
+    return 0;
+
+error:
+    dglCSRRelease(pCSR);
+    pCSR->iErrno = DGL_ERR_Read;
+    return -pCSR->iErrno;
+
+nomem:
+    dglCSRRelease(pCSR);
+    pCSR->iErrno = DGL_ERR_MemoryExhausted;
+    return -pCSR->iErrno;
+}
+
+/*!
+ * \brief Initialize workspace for queries on finalized graph
+ *
+ * Queries with different workspaces may run in parallel.
+ *
+ * \return 0 on success, negative error code on failure
+ */
+int dglCSRQueryInitialize(dglCSRGraph_s *pCSR, dglCSRQuery_s *pQuery)
+{
+    int32_t i;
+
+    memset(pQuery, 0, sizeof(dglCSRQuery_s));
+    pQuery->pCSR = pCSR;
+
+    pQuery->pnnDist = malloc((pCSR->cNode + 1) * sizeof(int64_t));
+    pQuery->pnPred = malloc((pCSR->cNode + 1) * sizeof(int32_t));
+    pQuery->pnTouched = malloc((pCSR->cNode + 1) * sizeof(int32_t));
+    if (!pQuery->pnnDist || !pQuery->pnPred || !pQuery->pnTouched) {
+        dglCSRQueryRelease(pQuery);
+        return -DGL_ERR_MemoryExhausted;
+    }
+    for (i = 0; i < pCSR->cNode; i++)
+        pQuery->pnnDist[i] = CSR_UNREACHED;
+
+    return 0;
+}
+
+/*!
+ * \brief Release workspace for queries
+ */
+void dglCSRQueryRelease(dglCSRQuery_s *pQuery)
+{
+    free(pQuery->pnnDist);
+    free(pQuery->pnPred);
+    free(pQuery->pnTouched);
+    free(pQuery->pHeap);
+    free(pQuery->pnEdge);
+    memset(pQuery, 0, sizeof(dglCSRQuery_s));
+}
+
+/* from node of edge */
+static int32_t edge_from(dglCSRGraph_s *pCSR, int32_t iEdge)
+{
+    int32_t lo = 0, hi = pCSR->cNode - 1, mid;
+
+    /* last node with pnOut[node] <= iEdge */
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (pCSR->pnOut[mid] <= iEdge)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    return lo;
+}
+
+/* collect edge ids of the path to iTarget */
+static int collect_path(dglCSRQuery_s *pQuery, int32_t iSource,
+                        int32_t iTarget)
+{
+    dglCSRGraph_s *pCSR = pQuery->pCSR;
+    int32_t i, iNode, cEdge;
+    dglInt32_t *pn;
+
+    cEdge = 0;
+    for (iNode = iTarget; iNode != iSource;
+         iNode = edge_from(pCSR, pQuery->pnPred[iNode]))
+        cEdge++;
+
+    if (cEdge > pQuery->nEdgeAlloc) {
+        pn = realloc(pQuery->pnEdge, cEdge * sizeof(dglInt32_t));
+        if (pn == NULL)
+            return -1;
+        pQuery->pnEdge = pn;
+        pQuery->nEdgeAlloc = cEdge;
+    }
+
+    i = cEdge;
+    for (iNode = iTarget; iNode != iSource;
+         iNode = edge_from(pCSR, pQuery->pnPred[iNode]))
+        pQuery->pnEdge[--i] = pCSR->pnEdgeId[pQuery->pnPred[iNode]];
+    pQuery->cEdge = cEdge;
+
+    return 0;
+}
+
+/*!
+ * \brief Shortest path on finalized graph
+ *
+ * With node costs, the cost of a node is added when the path leaves the
+ * node, except for the start node. Paths do not go through closed
+ * nodes, but they may start or end in a closed node.
+ *
+ * With fPath != 0 the edge ids of the path are stored in pQuery->pnEdge
+ * (pQuery->cEdge edges) until the next query.
+ *
+ * \param pQuery workspace initialized by dglCSRQueryInitialize()
+ * \param nFrom from node id
+ * \param nTo to node id
+ * \param[out] pnDistance path cost
+ * \param fPath collect the edges of the path
+ *
+ * \return 1 if path was found
+ * \return 0 if nTo is unreachable
+ * \return negative error code on failure
+ */
+int dglCSRShortestPath(dglCSRQuery_s *pQuery, dglInt32_t nFrom,
+                       dglInt32_t nTo, dglInt64_t *pnDistance, int fPath)
+{
+    dglCSRGraph_s *pCSR = pQuery->pCSR;
+    dglCSRHeapItem_s item;
+    int32_t iSource, iTarget, iNode, iTo, i;
+    int64_t nnDist, nnLeave;
+    int nRet;
+
+    pQuery->cEdge = 0;
+    iSource = dglCSRNodeIndex(pCSR, nFrom);
+    iTarget = dglCSRNodeIndex(pCSR, nTo);
+    if (iSource < 0 || iTarget < 0) {
+        pQuery->iErrno = DGL_ERR_NodeNotFound;
+        return -pQuery->iErrno;
+    }
+
+    if (iSource == iTarget) {
+        *pnDistance = 0;
+        return 1;
+    }
+
+    pQuery->pnnDist[iSource] = 0;
+    pQuery->pnTouched[0] = iSource;
+    pQuery->cTouched = 1;
+    pQuery->cHeap = 0;
+    if (heap_push(pQuery, 0, iSource) < 0)
+        goto nomem;
+
+    nRet = 0;
+    while (pQuery->cHeap > 0) {
+        heap_pop(pQuery, &item);
+        iNode = item.iNode;
+        if (item.nnKey > pQuery->pnnDist[iNode])
+            continue;
+        if (iNode == iTarget) {
+            nRet = 1;
+            break;
+        }
+
+        nnLeave = 0;
+        if (pCSR->pnNodeCost && iNode != iSource) {
+            /* do not go through closed nodes */
+            if (pCSR->pnNodeCost[iNode] < 0)
+                continue;
+            nnLeave = pCSR->pnNodeCost[iNode];
+        }
+
+        for (i = pCSR->pnOut[iNode]; i < pCSR->pnOut[iNode + 1]; i++) {
+            iTo = pCSR->pnTo[i];
+            nnDist = item.nnKey + nnLeave + pCSR->pnCost[i];
+            if (nnDist < pQuery->pnnDist[iTo]) {
+                if (pQuery->pnnDist[iTo] == CSR_UNREACHED)
+                    pQuery->pnTouched[pQuery->cTouched++] = iTo;
+                pQuery->pnnDist[iTo] = nnDist;
+                pQuery->pnPred[iTo] = i;
+                if (heap_push(pQuery, nnDist, iTo) < 0)
+                    goto nomem;
+            }
+        }
+    }
+
+    if (nRet) {
+        *pnDistance = pQuery->pnnDist[iTarget];
+        if (fPath && collect_path(pQuery, iSource, iTarget) < 0)
+            goto nomem;
+    }
+
+    for (i = 0; i < pQuery->cTouched; i++)
+        pQuery->pnnDist[pQuery->pnTouched[i]] = CSR_UNREACHED;
+    pQuery->cTouched = 0;
+
+    return nRet;
+
+nomem:
+    for (i = 0; i < pQuery->cTouched; i++)
+        pQuery->pnnDist[pQuery->pnTouched[i]] = CSR_UNREACHED;
+    pQuery->cTouched = 0;
+    pQuery->iErrno = DGL_ERR_MemoryExhausted;
+    return -pQuery->iErrno;
+}
@@ -0,0 +1,92 @@
+/* LIBDGL -- a Directed Graph Library implementation
+ * Copyright (C) 2002 Roberto Micarelli
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Compressed sparse row graph
+ */
+
+#ifndef _DGL_CSR_H_
+#define _DGL_CSR_H_
+
+#include <stdint.h>
+
+/*
+ * flags
+ */
+#define DGL_CSR_NODECOST 0x1 /* nodes have the cost of passing through the
+                                node, -1 means closed node (Vlib convention) */
+
+typedef struct _dglCSRGraph {
+    int iErrno;
+    int nFlags;
+    uint64_t nnKey; /* set by the caller, identifies the data the graph was
+                       built from */
+    int32_t cNode;
+    int32_t *pnNodeId;   /* node ids by index, ascending */
+    int32_t *pnNodeCost; /* cost of leaving node, NULL without node costs */
+    int32_t *pnOut;      /* cNode + 1 offsets to edge arrays */
+    int32_t cEdge;
+    int32_t *pnTo;     /* index of the node the edge goes to */
+    int32_t *pnCost;   /* edge costs */
+    int32_t *pnEdgeId; /* edge ids */
+    void *pvUser;      /* data saved with the graph */
+    int32_t cbUser;
+    /* edges added before dglCSRFinalize() */
+    int32_t *pnFrom;
+    int32_t nEdgeAlloc;
+} dglCSRGraph_s;
+
+typedef struct _dglCSRHeapItem {
+    int64_t nnKey;
+    int32_t iNode;
+} dglCSRHeapItem_s;
+
+/*
+ * workspace of queries, each thread needs its own
+ */
+typedef struct _dglCSRQuery {
+    dglCSRGraph_s *pCSR;
+    int iErrno;
+    int64_t *pnnDist;
+    int32_t *pnPred; /* edge reaching the node */
+    int32_t *pnTouched;
+    int32_t cTouched;
+    dglCSRHeapItem_s *pHeap;
+    int32_t cHeap, nHeapAlloc;
+    dglInt32_t *pnEdge; /* edge ids of the last path */
+    int32_t cEdge, nEdgeAlloc;
+} dglCSRQuery_s;
+
+int dglCSRInitialize(dglCSRGraph_s *pCSR, int nFlags);
+int dglCSRAddEdge(dglCSRGraph_s *pCSR, dglInt32_t nFrom, dglInt32_t nTo,
+                  dglInt32_t nCost, dglInt32_t nId);
+int dglCSRFinalize(dglCSRGraph_s *pCSR);
+int dglCSRSetNodeCost(dglCSRGraph_s *pCSR, dglInt32_t nNode,
+                      dglInt32_t nCost);
+int32_t dglCSRNodeIndex(dglCSRGraph_s *pCSR, dglInt32_t nNode);
+int dglCSRSetUserData(dglCSRGraph_s *pCSR, const void *pv, int32_t cb);
+void dglCSRRelease(dglCSRGraph_s *pCSR);
+int dglCSRWrite(dglCSRGraph_s *pCSR, int fd);
+int dglCSRRead(dglCSRGraph_s *pCSR, int fd);
+
+int dglCSRQueryInitialize(dglCSRGraph_s *pCSR, dglCSRQuery_s *pQuery);
+void dglCSRQueryRelease(dglCSRQuery_s *pQuery);
+int dglCSRShortestPath(dglCSRQuery_s *pQuery, dglInt32_t nFrom,
+                       dglInt32_t nTo, dglInt64_t *pnDistance, int fPath);
+
+#endif
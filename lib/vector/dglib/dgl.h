@@ -4,3 +4,5 @@
 #include <grass/dgl/graph.h>
 /* #include <dgl/heap.h> */
 #include <grass/dgl/tree.h>
+#include <grass/dgl/ch.h>
+#include <grass/dgl/csr.h>
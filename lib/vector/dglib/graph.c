@@ -150,6 +150,24 @@ int dglFlatten(dglGraph_s *pGraph)
     return -pGraph->iErrno;
 }
 
+/*
+ * A view is a shallow copy of a flat graph sharing its buffers. Reading
+ * functions store their error code in the graph, threads reading the same
+ * graph concurrently must each use their own view. A view must not be
+ * modified nor released and becomes invalid when the graph is released.
+ */
+int dglFlatView(dglGraph_s *pGraph, dglGraph_s *pView)
+{
+    if (!(pGraph->Flags & DGL_GS_FLAT)) {
+        pGraph->iErrno = DGL_ERR_BadOnTreeGraph;
+        return -pGraph->iErrno;
+    }
+    *pView = *pGraph;
+    pView->iErrno = 0;
+
+    return 0;
+}
+
 dglInt32_t *dglGetNode(dglGraph_s *pGraph, dglInt32_t nNodeId)
 {
     switch (pGraph->Version) {
@@ -282,6 +282,7 @@ int dglInitialize(dglGraph_s *pGraph, dglByte_t Version,
 int dglRelease(dglGraph_s *pGraph);
 int dglUnflatten(dglGraph_s *pGraph);
 int dglFlatten(dglGraph_s *pGraph);
+int dglFlatView(dglGraph_s *pGraph, dglGraph_s *pView);
 void dglResetStats(dglGraph_s *pgraph);
 
 /*
@@ -5,7 +5,7 @@
 
    Centrality measures
 
-   (C) 2009-2010 by Daniel Bundala, and the GRASS Development Team
+   (C) 2009-2026 by Daniel Bundala, and the GRASS Development Team
 
    This program is free software under the GNU General Public License
    (>=v2). Read the file COPYING that comes with GRASS for details.
@@ -13,6 +13,10 @@
    \author Daniel Bundala (Google Summer of Code 2009)
  */
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <grass/gis.h>
@@ -113,40 +117,41 @@ int NetA_eigenvector_centrality(dglGraph_s *graph, int iterations, double error,
    algorithm.
 
    Edge costs must be nonnegative. If some edge costs are negative then
-   the behaviour of this method is undefined.
+   the behaviour of this method is undefined. The searches from the
+   nodes run in parallel, the graph must be flat.
 
    \param graph input graph
    \param[out] betweenness betweenness values
    \param[out] closeness cloneness values
+   \param nprocs number of threads
 
    \return 0 on success
    \return -1 on failure
  */
 int NetA_betweenness_closeness(dglGraph_s *graph, double *betweenness,
-                               double *closeness)
+                               double *closeness, int nprocs)
 {
-    int i, j, nnodes, stack_size, count;
-    dglInt32_t *dst, *node, *stack, *cnt, *delta;
+    int i, nnodes, nsources, count;
+    dglInt32_t *node, *sources;
     dglNodeTraverser_s nt;
-    dglEdgesetTraverser_s et;
-    dglHeap_s heap;
-    struct ilist **prev;
+    dglGraph_s view;
 
     nnodes = dglGet_NodeCount(graph);
 
-    dst = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
-    prev = (struct ilist **)G_calloc(nnodes + 1, sizeof(struct ilist *));
-    stack = (dglInt32_t *)G_calloc(nnodes, sizeof(dglInt32_t));
-    cnt = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
-    delta = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
-
-    if (!dst || !prev || !stack || !cnt || !delta) {
-        G_fatal_error(_("Out of memory"));
+    if (dglFlatView(graph, &view) < 0) {
+        G_warning(_("Graph must be flat for NetA_betweenness_closeness()"));
         return -1;
     }
 
+    sources = (dglInt32_t *)G_calloc(nnodes, sizeof(dglInt32_t));
+    nsources = 0;
+    dglNode_T_Initialize(&nt, graph);
+    for (node = dglNode_T_First(&nt); node && nsources < nnodes;
+         node = dglNode_T_Next(&nt))
+        sources[nsources++] = dglNodeGet_Id(graph, node);
+    dglNode_T_Release(&nt);
+
     for (i = 1; i <= nnodes; i++) {
-        prev[i] = Vect_new_list();
         if (closeness)
             closeness[i] = 0;
         if (betweenness)
@@ -155,89 +160,137 @@ int NetA_betweenness_closeness(dglGraph_s *graph, double *betweenness,
 
     count = 0;
     G_percent_reset();
-    dglNode_T_Initialize(&nt, graph);
-    for (node = dglNode_T_First(&nt); node; node = dglNode_T_Next(&nt)) {
-        G_percent(count++, nnodes, 1);
-        dglInt32_t s = dglNodeGet_Id(graph, node);
-        dglHeapData_u heap_data;
-        dglHeapNode_s heap_node;
-
-        stack_size = 0;
-        for (i = 1; i <= nnodes; i++)
-            Vect_reset_list(prev[i]);
-        for (i = 1; i <= nnodes; i++) {
-            cnt[i] = 0;
-            dst[i] = -1;
-        }
-        dst[s] = 0;
-        cnt[s] = 1;
-        dglHeapInit(&heap);
-        heap_data.ul = s;
-        dglHeapInsertMin(&heap, 0, ' ', heap_data);
-        while (1) {
-            dglInt32_t v, dist;
-
-            if (!dglHeapExtractMin(&heap, &heap_node))
-                break;
-            v = heap_node.value.ul;
-            dist = heap_node.key;
-            if (dst[v] < dist)
-                continue;
-            stack[stack_size++] = v;
 
-            dglInt32_t *edge;
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+    {
+        int i, j, k, t_id, stack_size;
+        dglInt32_t *dst, *stack, *cnt, *delta;
+        double *tbetweenness;
+        dglEdgesetTraverser_s et;
+        dglHeap_s heap;
+        dglGraph_s tview;
+        struct ilist **prev;
+
+        t_id = 0;
+#if defined(_OPENMP)
+        t_id = omp_get_thread_num();
+#endif
+        /* reading functions store error codes in the graph */
+        dglFlatView(graph, &tview);
+
+        dst = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
+        prev = (struct ilist **)G_calloc(nnodes + 1, sizeof(struct ilist *));
+        stack = (dglInt32_t *)G_calloc(nnodes, sizeof(dglInt32_t));
+        cnt = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
+        delta = (dglInt32_t *)G_calloc(nnodes + 1, sizeof(dglInt32_t));
+        /* betweenness is summed up over all threads */
+        tbetweenness = NULL;
+        if (betweenness)
+            tbetweenness = (double *)G_calloc(nnodes + 1, sizeof(double));
 
-            dglEdgeset_T_Initialize(
-                &et, graph, dglNodeGet_OutEdgeset(graph, dglGetNode(graph, v)));
-            for (edge = dglEdgeset_T_First(&et); edge;
-                 edge = dglEdgeset_T_Next(&et)) {
-                dglInt32_t *to = dglEdgeGet_Tail(graph, edge);
-                dglInt32_t to_id = dglNodeGet_Id(graph, to);
-                dglInt32_t d = dglEdgeGet_Cost(graph, edge);
-
-                if (dst[to_id] == -1 || dst[to_id] > dist + d) {
-                    dst[to_id] = dist + d;
-                    Vect_reset_list(prev[to_id]);
-                    heap_data.ul = to_id;
-                    dglHeapInsertMin(&heap, dist + d, ' ', heap_data);
-                }
-                if (dst[to_id] == dist + d) {
-                    cnt[to_id] += cnt[v];
-                    Vect_list_append(prev[to_id], v);
+        for (i = 1; i <= nnodes; i++)
+            prev[i] = Vect_new_list();
+
+#pragma omp for schedule(dynamic)
+        for (k = 0; k < nsources; k++) {
+            dglInt32_t s = sources[k];
+            dglHeapData_u heap_data;
+            dglHeapNode_s heap_node;
+
+            if (t_id == 0)
+                G_percent(count, nnodes, 1);
+#pragma omp atomic update
+            count++;
+
+            stack_size = 0;
+            for (i = 1; i <= nnodes; i++)
+                Vect_reset_list(prev[i]);
+            for (i = 1; i <= nnodes; i++) {
+                cnt[i] = 0;
+                dst[i] = -1;
+            }
+            dst[s] = 0;
+            cnt[s] = 1;
+            dglHeapInit(&heap);
+            heap_data.ul = s;
+            dglHeapInsertMin(&heap, 0, ' ', heap_data);
+            while (1) {
+                dglInt32_t v, dist;
+
+                if (!dglHeapExtractMin(&heap, &heap_node))
+                    break;
+                v = heap_node.value.ul;
+                dist = heap_node.key;
+                if (dst[v] < dist)
+                    continue;
+                stack[stack_size++] = v;
+
+                dglInt32_t *edge;
+
+                dglEdgeset_T_Initialize(
+                    &et, &tview,
+                    dglNodeGet_OutEdgeset(&tview, dglGetNode(&tview, v)));
+                for (edge = dglEdgeset_T_First(&et); edge;
+                     edge = dglEdgeset_T_Next(&et)) {
+                    dglInt32_t *to = dglEdgeGet_Tail(&tview, edge);
+                    dglInt32_t to_id = dglNodeGet_Id(&tview, to);
+                    dglInt32_t d = dglEdgeGet_Cost(&tview, edge);
+
+                    if (dst[to_id] == -1 || dst[to_id] > dist + d) {
+                        dst[to_id] = dist + d;
+                        Vect_reset_list(prev[to_id]);
+                        heap_data.ul = to_id;
+                        dglHeapInsertMin(&heap, dist + d, ' ', heap_data);
+                    }
+                    if (dst[to_id] == dist + d) {
+                        cnt[to_id] += cnt[v];
+                        Vect_list_append(prev[to_id], v);
+                    }
                 }
+
+                dglEdgeset_T_Release(&et);
             }
+            dglHeapFree(&heap, NULL);
+            for (i = 1; i <= nnodes; i++)
+                delta[i] = 0;
+            for (i = stack_size - 1; i >= 0; i--) {
+                dglInt32_t w = stack[i];
 
-            dglEdgeset_T_Release(&et);
-        }
-        dglHeapFree(&heap, NULL);
-        for (i = 1; i <= nnodes; i++)
-            delta[i] = 0;
-        for (i = stack_size - 1; i >= 0; i--) {
-            dglInt32_t w = stack[i];
+                if (closeness)
+                    closeness[s] += dst[w];
 
-            if (closeness)
-                closeness[s] += dst[w];
+                for (j = 0; j < prev[w]->n_values; j++) {
+                    dglInt32_t v = prev[w]->value[j];
 
-            for (j = 0; j < prev[w]->n_values; j++) {
-                dglInt32_t v = prev[w]->value[j];
+                    delta[v] += (cnt[v] / (double)cnt[w]) * (1.0 + delta[w]);
+                }
+                if (w != s && betweenness)
+                    tbetweenness[w] += delta[w];
+            }
+            if (closeness)
+                closeness[s] /= (double)stack_size;
+        }
 
-                delta[v] += (cnt[v] / (double)cnt[w]) * (1.0 + delta[w]);
+        if (betweenness) {
+#pragma omp critical
+            {
+                for (i = 1; i <= nnodes; i++)
+                    betweenness[i] += tbetweenness[i];
             }
-            if (w != s && betweenness)
-                betweenness[w] += delta[w];
+            G_free(tbetweenness);
         }
-        if (closeness)
-            closeness[s] /= (double)stack_size;
+
+        for (i = 1; i <= nnodes; i++)
+            Vect_destroy_list(prev[i]);
+        G_free(delta);
+        G_free(cnt);
+        G_free(stack);
+        G_free(prev);
+        G_free(dst);
     }
-    dglNode_T_Release(&nt);
+    G_percent(1, 1, 1);
 
-    for (i = 1; i <= nnodes; i++)
-        Vect_destroy_list(prev[i]);
-    G_free(delta);
-    G_free(cnt);
-    G_free(stack);
-    G_free(prev);
-    G_free(dst);
+    G_free(sources);
 
     return 0;
 }
@@ -0,0 +1,153 @@
+/*!
+   \file lib/vector/neta/matrix.c
+
+   \brief Network Analysis library - distance matrices
+
+   Shortest path searches from many nodes run in parallel
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2). Read the file COPYING that comes with GRASS for details.
+ */
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/vector.h>
+#include <grass/glocale.h>
+#include <grass/dgl/graph.h>
+#include <grass/neta.h>
+
+/*
+   search from one node with the costs of NetA_distance_from_points(),
+   graph is a view used by the calling thread only
+ */
+static void search(dglGraph_s *graph, int from, int nnodes, dglInt32_t *dst,
+                   dglInt32_t **prev)
+{
+    int i, have_node_costs;
+    dglHeap_s heap;
+    dglHeapData_u heap_data;
+    dglHeapNode_s heap_node;
+    dglEdgesetTraverser_s et;
+    dglInt32_t v, dist, ncost;
+    dglInt32_t *node, *edgeset, *edge;
+
+    for (i = 1; i <= nnodes; i++) {
+        dst[i] = -1;
+        if (prev)
+            prev[i] = NULL;
+    }
+
+    if (from < 1 || from > nnodes)
+        return;
+
+    have_node_costs = dglGet_NodeAttrSize(graph);
+
+    dglHeapInit(&heap);
+    dst[from] = 0;
+    heap_data.ul = from;
+    dglHeapInsertMin(&heap, 0, ' ', heap_data);
+
+    while (dglHeapExtractMin(&heap, &heap_node)) {
+        v = heap_node.value.ul;
+        dist = heap_node.key;
+        if (dst[v] < dist)
+            continue;
+
+        node = dglGetNode(graph, v);
+        if (node == NULL)
+            continue;
+
+        if (have_node_costs && v != from) {
+            memcpy(&ncost, dglNodeGet_Attr(graph, node), sizeof(ncost));
+            if (ncost > 0)
+                dist += ncost;
+            /* do not go through closed nodes */
+            if (ncost < 0)
+                continue;
+        }
+
+        edgeset = dglNodeGet_OutEdgeset(graph, node);
+        if (edgeset == NULL)
+            continue;
+
+        dglEdgeset_T_Initialize(&et, graph, edgeset);
+        for (edge = dglEdgeset_T_First(&et); edge;
+             edge = dglEdgeset_T_Next(&et)) {
+            dglInt32_t *to = dglEdgeGet_Tail(graph, edge);
+            dglInt32_t to_id = dglNodeGet_Id(graph, to);
+            dglInt32_t d = dglEdgeGet_Cost(graph, edge);
+
+            if (to_id < 1 || to_id > nnodes)
+                continue;
+            if (dst[to_id] < 0 || dst[to_id] > dist + d) {
+                dst[to_id] = dist + d;
+                if (prev)
+                    prev[to_id] = edge;
+                heap_data.ul = to_id;
+                dglHeapInsertMin(&heap, dist + d, ' ', heap_data);
+            }
+        }
+        dglEdgeset_T_Release(&et);
+    }
+
+    dglHeapFree(&heap, NULL);
+}
+
+/*!
+   \brief Computes shortest paths to every node from each node in "from".
+
+   One search is run for each node in "from", the searches run in
+   parallel and give the same costs as NetA_distance_from_points() with
+   a single 'from' node. The graph must be flat (built by
+   Vect_net_build_graph()) and is only read.
+
+   Arrays dst[i] and prev[i] belong to the i-th node in "from" and must
+   have nnodes + 1 elements. Array dst[i] contains the cost of the path
+   or -1 if the node is not reachable, prev[i] contains edges from
+   predecessor along the shortest path.
+
+   \param graph input graph
+   \param nnodes largest node id (number of nodes of the vector map)
+   \param from list of 'from' positions
+   \param[out] dst arrays of costs to reach nodes
+   \param[out] prev arrays of edges from predecessor along the shortest
+   path or NULL
+   \param nprocs number of threads
+
+   \return 0 on success
+   \return -1 on failure
+ */
+int NetA_distance_matrix(dglGraph_s *graph, int nnodes, struct ilist *from,
+                         dglInt32_t **dst, dglInt32_t ***prev, int nprocs)
+{
+    dglGraph_s view;
+
+    if (dglFlatView(graph, &view) < 0) {
+        G_warning(_("Graph must be flat for NetA_distance_matrix()"));
+        return -1;
+    }
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1 && from->n_values > 1)
+    {
+        dglGraph_s tview;
+        int i;
+
+        /* reading functions store error codes in the graph */
+        dglFlatView(graph, &tview);
+
+#pragma omp for schedule(dynamic)
+        for (i = 0; i < from->n_values; i++)
+            search(&tview, from->value[i], nnodes, dst[i],
+                   prev ? prev[i] : NULL);
+    }
+
+    return 0;
+}
@@ -21,6 +21,7 @@
 extern "C" {
 #include "lidar.h"
 #include "point_binning.h"
+#include "point_tiles.h"
 }
 
 extern "C" {
@@ -43,16 +44,10 @@ public:
 
     std::string getName() const { return "writers.grassbinning"; }
 
-    void set_binning(struct Cell_head *region,
-                     struct PointBinning *point_binning,
-                     struct BinIndex *bin_index_nodes, RASTER_MAP_TYPE rtype,
-                     int cols)
+    void set_binning(struct Cell_head *region, struct PointTiles *tiles)
     {
         region_ = region;
-        point_binning_ = point_binning;
-        bin_index_nodes_ = bin_index_nodes;
-        rtype_ = rtype;
-        cols_ = cols;
+        tiles_ = tiles;
     }
 
     void dim_to_import(pdal::Dimension::Id dim_to_import)
@@ -110,8 +105,7 @@ public:
             return false;
         }
 
-        update_value(point_binning_, bin_index_nodes_, cols_, arr_row, arr_col,
-                     rtype_, x, y, z);
+        point_tiles_add(tiles_, x, y, z, arr_row, arr_col);
         n_processed++;
         return true;
     }
@@ -120,10 +114,7 @@ public:
 
 private:
     struct Cell_head *region_;
-    struct PointBinning *point_binning_;
-    struct BinIndex *bin_index_nodes_;
-    RASTER_MAP_TYPE rtype_;
-    int cols_;
+    struct PointTiles *tiles_;
     double scale_;
 
     pdal::Dimension::Id dim_to_import_;
@@ -9,7 +9,7 @@
  * PURPOSE:   Imports LAS LiDAR point clouds to a raster map using
  *            aggregate statistics.
  *
- * COPYRIGHT: (C) 2019-2024 by Vaclav Petras and the GRASS Development Team
+ * COPYRIGHT: (C) 2019-2026 by Vaclav Petras and the GRASS Development Team
  *
  *            This program is free software under the GNU General Public
  *            License (>=v2). Read the file COPYING that comes with
@@ -75,11 +75,7 @@ int main(int argc, char *argv[])
 
     char buff[BUFFSIZE];
 
-    struct BinIndex bin_index_nodes;
-
-    bin_index_nodes.num_nodes = 0;
-    bin_index_nodes.max_nodes = 0;
-    bin_index_nodes.nodes = NULL;
+    struct PointTiles point_tiles;
 
     struct Cell_head loc_wind = {};
 
@@ -94,6 +90,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("conversion"));
     G_add_keyword(_("aggregation"));
     G_add_keyword(_("binning"));
+    G_add_keyword(_("parallel"));
     module->description = _("Creates a raster map from LAS LiDAR points using "
                             "univariate statistics.");
 
@@ -371,6 +368,16 @@ int main(int argc, char *argv[])
     user_dimension_opt->description = _("PDAL dimension name");
     user_dimension_opt->guisection = _("Selection");
 
+    Option *memory_opt = G_define_standard_option(G_OPT_MEMORYMB);
+
+    memory_opt->answer = NULL;
+    memory_opt->description =
+        _("Maximum memory to be used for binning (in MB); if the region "
+          "needs more, points are binned by bands of rows using temporary "
+          "files");
+
+    Option *nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     Flag *extents_flag = G_define_flag();
 
     extents_flag->key = 'e';
@@ -432,6 +439,8 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv))
         return EXIT_FAILURE;
 
+    int nprocs = G_set_omp_num_threads(nprocs_opt);
+
     /* Get input file list. Needs to be done before printing extent. */
     struct StringList infiles;
 
@@ -703,9 +712,10 @@ int main(int argc, char *argv[])
                           &base_raster_data_type);
     }
 
-    // TODO: use memory requirements supplied by user
-    // TODO: use segment library for binning
-    point_binning_allocate(&point_binning, rows, cols, rtype);
+    /* points are binned in parallel by bands of rows, out-of-core when
+     * the region does not fit into memory */
+    point_tiles_init(&point_tiles, &point_binning, rows, cols, rtype, nprocs,
+                     memory_opt->answer ? atoi(memory_opt->answer) : 0);
 
     /* open output map */
     out_fd = Rast_open_new(outmap, rtype);
@@ -871,8 +881,7 @@ int main(int argc, char *argv[])
                       pdal::Dimension::name(dim_to_import).c_str());
 
     // TODO: add percentage printing to one of the filters
-    binning_writer.set_binning(&region, &point_binning, &bin_index_nodes, rtype,
-                               cols);
+    binning_writer.set_binning(&region, &point_tiles);
     binning_writer.dim_to_import(dim_to_import);
     if (base_raster_opt->answer)
         binning_writer.set_base_raster(&base_segment, &input_region,
@@ -884,21 +893,13 @@ int main(int argc, char *argv[])
 
     /* calc stats and output */
     G_message(_("Writing output raster map..."));
-    for (int row = 0; row < rows; row++) {
-        /* assemble final values into a row */
-        write_values(&point_binning, &bin_index_nodes, raster_row, row, cols,
-                     rtype);
-        G_percent(row, rows, 10);
-
-        /* write out line of raster data */
-        Rast_put_row(out_fd, raster_row, rtype);
-    }
+    point_tiles_write(&point_tiles, out_fd, raster_row);
+
     /* free memory */
-    point_binning_free(&point_binning, &bin_index_nodes);
+    point_tiles_free(&point_tiles);
     if (base_raster_opt->answer)
         Segment_close(&base_segment);
 
-    G_percent(1, 1, 1); /* flush */
     G_free(raster_row);
 
     G_message(_(GPOINT_COUNT_FORMAT " points found in input file(s)"),
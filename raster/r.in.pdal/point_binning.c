@@ -286,6 +286,30 @@ void point_binning_free(struct PointBinning *point_binning,
     }
 }
 
+/* memory needed for one cell by the arrays of the method, without the nodes
+ * of methods using linked lists */
+size_t point_binning_cell_size(struct PointBinning *point_binning,
+                               RASTER_MAP_TYPE rtype)
+{
+    size_t size = 0;
+
+    if (point_binning->bin_n)
+        size += Rast_cell_size(CELL_TYPE);
+    if (point_binning->bin_min)
+        size += Rast_cell_size(rtype);
+    if (point_binning->bin_max)
+        size += Rast_cell_size(rtype);
+    if (point_binning->bin_sum)
+        size += 2 * Rast_cell_size(rtype);
+    if (point_binning->bin_m2)
+        size += 2 * Rast_cell_size(rtype) + Rast_cell_size(CELL_TYPE);
+    if (point_binning->bin_z_index || point_binning->bin_cnt_index ||
+        point_binning->bin_eigenvalues)
+        size += Rast_cell_size(CELL_TYPE);
+
+    return size;
+}
+
 void write_values(struct PointBinning *point_binning,
                   struct BinIndex *bin_index_nodes, void *raster_row, int row,
                   int cols, RASTER_MAP_TYPE rtype)
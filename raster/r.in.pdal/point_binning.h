@@ -98,6 +98,7 @@ int blank_array(void *, int, int, RASTER_MAP_TYPE, int);
 void point_binning_set(struct PointBinning *, char *, char *, char *);
 void point_binning_allocate(struct PointBinning *, int, int, RASTER_MAP_TYPE);
 void point_binning_free(struct PointBinning *, struct BinIndex *);
+size_t point_binning_cell_size(struct PointBinning *, RASTER_MAP_TYPE);
 
 void write_values(struct PointBinning *, struct BinIndex *, void *, int, int,
                   RASTER_MAP_TYPE);
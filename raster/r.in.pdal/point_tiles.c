@@ -0,0 +1,290 @@
+/****************************************************************************
+ *
+ * MODULE:    r.in.pdal
+ *
+ * AUTHOR(S): GRASS Development Team
+ *
+ * PURPOSE:   Routing of points to bands of rows binned by threads
+ *            and out-of-core binning of large regions
+ *
+ * COPYRIGHT: (C) 2026 by the GRASS Development Team
+ *
+ *            This program is free software under the GNU General Public
+ *            License (>=v2). Read the file COPYING that comes with
+ *            GRASS for details.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/raster.h>
+
+#include "point_tiles.h"
+
+/* points binned at once */
+#define CHUNK_POINTS (1 << 20)
+/* limit of temporary files open at the same time */
+#define MAX_BANDS    256
+
+/* point in temporary file when coordinates are not needed */
+struct SpillPoint {
+    double z;
+    int row, col;
+};
+
+/*!
+   \brief Prepare binning of points
+
+   Points are binned in chunks, each thread bins the points of its own
+   part of the rows, so the order of the points in a cell is the same
+   as with one thread. If the arrays of the method for the whole region
+   need more than memory_mb, points are written to temporary files by
+   bands of rows and the bands are binned one by one at the end, i.e.,
+   the input is read only once.
+
+   \param memory_mb memory for the arrays in MB, 0 for no limit
+ */
+void point_tiles_init(struct PointTiles *tiles,
+                      struct PointBinning *point_binning, int rows, int cols,
+                      RASTER_MAP_TYPE rtype, int nprocs, int memory_mb)
+{
+    size_t cell_size, band_rows;
+    int i;
+
+    G_zero(tiles, sizeof(struct PointTiles));
+    tiles->point_binning = point_binning;
+    tiles->rtype = rtype;
+    tiles->rows = rows;
+    tiles->cols = cols;
+    tiles->band_rows = rows;
+    tiles->nbands = 1;
+
+    cell_size = point_binning_cell_size(point_binning, rtype);
+    if (memory_mb > 0 && cell_size > 0) {
+        band_rows = ((size_t)memory_mb << 20) / (cell_size * (cols + 1));
+        if (band_rows < 1)
+            band_rows = 1;
+        if (band_rows < (size_t)rows) {
+            if ((rows + band_rows - 1) / band_rows > MAX_BANDS) {
+                band_rows = (rows + MAX_BANDS - 1) / MAX_BANDS;
+                G_warning(_("Not enough memory, using %d MB"),
+                          (int)((band_rows * cell_size * (cols + 1)) >> 20) +
+                              1);
+            }
+            tiles->band_rows = band_rows;
+            tiles->nbands = (rows + band_rows - 1) / band_rows;
+        }
+    }
+
+    if (nprocs > tiles->band_rows)
+        nprocs = tiles->band_rows;
+    if (nprocs < 1)
+        nprocs = 1;
+    tiles->nprocs = nprocs;
+    tiles->part_rows = (tiles->band_rows + nprocs - 1) / nprocs;
+    tiles->bin_index = G_calloc(nprocs, sizeof(struct BinIndex));
+
+    tiles->max_points = CHUNK_POINTS;
+    tiles->points = G_malloc(tiles->max_points * sizeof(struct BinPoint));
+    if (nprocs > 1)
+        tiles->sorted = G_malloc(tiles->max_points * sizeof(struct BinPoint));
+    tiles->counts = G_malloc((nprocs + 1) * sizeof(size_t));
+
+    if (tiles->nbands == 1) {
+        point_binning_allocate(point_binning, rows, cols, rtype);
+        return;
+    }
+
+    G_message(_("Region does not fit into memory, points are binned in %d "
+                "bands of rows using temporary files"),
+              tiles->nbands);
+    tiles->record_size = point_binning->bin_eigenvalues
+                             ? sizeof(struct BinPoint)
+                             : sizeof(struct SpillPoint);
+    tiles->spill = G_malloc(tiles->nbands * sizeof(FILE *));
+    tiles->spill_names = G_malloc(tiles->nbands * sizeof(char *));
+    for (i = 0; i < tiles->nbands; i++) {
+        tiles->spill_names[i] = G_tempfile();
+        tiles->spill[i] = fopen(tiles->spill_names[i], "w+b");
+        if (!tiles->spill[i])
+            G_fatal_error(_("Unable to create temporary file <%s>"),
+                          tiles->spill_names[i]);
+    }
+}
+
+/* bin buffered points of band starting at row0 */
+static void bin_points(struct PointTiles *tiles, int row0)
+{
+    struct BinPoint *points = tiles->points;
+    size_t *counts = tiles->counts;
+    size_t i;
+    int t, nprocs = tiles->nprocs;
+
+    if (nprocs > 1) {
+        /* stable partition by parts of threads */
+        memset(counts, 0, (nprocs + 1) * sizeof(size_t));
+        for (i = 0; i < tiles->npoints; i++)
+            counts[(points[i].row - row0) / tiles->part_rows + 1]++;
+        for (t = 1; t <= nprocs; t++)
+            counts[t] += counts[t - 1];
+        for (i = 0; i < tiles->npoints; i++) {
+            t = (points[i].row - row0) / tiles->part_rows;
+            tiles->sorted[counts[t]++] = points[i];
+        }
+        points = tiles->sorted;
+    }
+    else
+        counts[0] = tiles->npoints;
+
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) private(i)
+    for (t = 0; t < nprocs; t++) {
+        for (i = t > 0 ? counts[t - 1] : 0; i < counts[t]; i++) {
+            update_value(tiles->point_binning, &tiles->bin_index[t],
+                         tiles->cols, points[i].row - row0, points[i].col,
+                         tiles->rtype, points[i].x, points[i].y, points[i].z);
+        }
+    }
+
+    tiles->npoints = 0;
+}
+
+void point_tiles_add(struct PointTiles *tiles, double x, double y, double z,
+                     int row, int col)
+{
+    struct BinPoint *point;
+
+    if (tiles->nbands > 1) {
+        FILE *fp = tiles->spill[row / tiles->band_rows];
+        struct BinPoint bp;
+        struct SpillPoint sp;
+        void *rec = &sp;
+
+        if (tiles->record_size == sizeof(struct BinPoint)) {
+            bp.x = x;
+            bp.y = y;
+            bp.z = z;
+            bp.row = row;
+            bp.col = col;
+            rec = &bp;
+        }
+        else {
+            sp.z = z;
+            sp.row = row;
+            sp.col = col;
+        }
+        if (fwrite(rec, tiles->record_size, 1, fp) != 1)
+            G_fatal_error(_("Unable to write to temporary file"));
+        return;
+    }
+
+    point = &tiles->points[tiles->npoints++];
+    point->x = x;
+    point->y = y;
+    point->z = z;
+    point->row = row;
+    point->col = col;
+    if (tiles->npoints == tiles->max_points)
+        bin_points(tiles, 0);
+}
+
+/* read points of band from its temporary file and bin them */
+static void bin_spilled(struct PointTiles *tiles, int band)
+{
+    FILE *fp = tiles->spill[band];
+    int row0 = band * tiles->band_rows;
+
+    if (fflush(fp) != 0 || fseek(fp, 0L, SEEK_SET) != 0)
+        G_fatal_error(_("Unable to read temporary file"));
+
+    if (tiles->record_size == sizeof(struct BinPoint)) {
+        while ((tiles->npoints = fread(tiles->points, sizeof(struct BinPoint),
+                                       tiles->max_points, fp)) > 0)
+            bin_points(tiles, row0);
+    }
+    else {
+        struct SpillPoint *sp = (struct SpillPoint *)tiles->sorted;
+        size_t i, n;
+
+        /* read into the end of the buffer and expand in place */
+        if (!sp)
+            sp = (struct SpillPoint *)(tiles->points + tiles->max_points / 2);
+        while ((n = fread(sp, sizeof(struct SpillPoint), tiles->max_points / 2,
+                          fp)) > 0) {
+            for (i = 0; i < n; i++) {
+                tiles->points[i].x = tiles->points[i].y = 0.;
+                tiles->points[i].z = sp[i].z;
+                tiles->points[i].row = sp[i].row;
+                tiles->points[i].col = sp[i].col;
+            }
+            tiles->npoints = n;
+            bin_points(tiles, row0);
+        }
+    }
+    if (ferror(fp))
+        G_fatal_error(_("Unable to read temporary file"));
+
+    fclose(fp);
+    unlink(tiles->spill_names[band]);
+}
+
+static void free_band(struct PointTiles *tiles)
+{
+    int t;
+
+    point_binning_free(tiles->point_binning, &tiles->bin_index[0]);
+    for (t = 1; t < tiles->nprocs; t++) {
+        G_free(tiles->bin_index[t].nodes);
+        tiles->bin_index[t].nodes = NULL;
+        tiles->bin_index[t].num_nodes = 0;
+        tiles->bin_index[t].max_nodes = 0;
+    }
+}
+
+/*!
+   \brief Bin the remaining points and write the raster map
+ */
+void point_tiles_write(struct PointTiles *tiles, int out_fd, void *raster_row)
+{
+    int band, row, row0, nrows;
+
+    for (band = 0; band < tiles->nbands; band++) {
+        row0 = band * tiles->band_rows;
+        nrows = tiles->rows - row0;
+        if (nrows > tiles->band_rows)
+            nrows = tiles->band_rows;
+
+        if (tiles->nbands > 1) {
+            point_binning_allocate(tiles->point_binning, nrows, tiles->cols,
+                                   tiles->rtype);
+            bin_spilled(tiles, band);
+        }
+        else if (tiles->npoints > 0)
+            bin_points(tiles, 0);
+
+        for (row = 0; row < nrows; row++) {
+            write_values(tiles->point_binning,
+                         &tiles->bin_index[row / tiles->part_rows], raster_row,
+                         row, tiles->cols, tiles->rtype);
+            G_percent(row0 + row, tiles->rows, 10);
+            Rast_put_row(out_fd, raster_row, tiles->rtype);
+        }
+        free_band(tiles);
+    }
+    G_percent(1, 1, 1);
+}
+
+void point_tiles_free(struct PointTiles *tiles)
+{
+    G_free(tiles->points);
+    G_free(tiles->sorted);
+    G_free(tiles->counts);
+    G_free(tiles->bin_index);
+    if (tiles->spill) {
+        G_free(tiles->spill);
+        G_free(tiles->spill_names);
+    }
+}
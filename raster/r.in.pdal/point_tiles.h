@@ -0,0 +1,59 @@
+/****************************************************************************
+ *
+ * MODULE:    r.in.pdal
+ *
+ * AUTHOR(S): GRASS Development Team
+ *
+ * PURPOSE:   Routing of points to bands of rows binned by threads
+ *            and out-of-core binning of large regions
+ *
+ * COPYRIGHT: (C) 2026 by the GRASS Development Team
+ *
+ *            This program is free software under the GNU General Public
+ *            License (>=v2). Read the file COPYING that comes with
+ *            GRASS for details.
+ *
+ *****************************************************************************/
+
+#ifndef __POINT_TILES_H__
+#define __POINT_TILES_H__
+
+#include <stdio.h>
+#include <grass/raster.h>
+
+#include "point_binning.h"
+
+struct BinPoint {
+    double x, y, z;
+    int row, col;
+};
+
+struct PointTiles {
+    struct PointBinning *point_binning;
+    RASTER_MAP_TYPE rtype;
+    int rows, cols; /* output region */
+    int nprocs;
+
+    /* bands of rows binned at once, more than one band only out-of-core */
+    int band_rows, nbands;
+    int part_rows;              /* rows of one thread within a band */
+    struct BinIndex *bin_index; /* node pools of threads */
+
+    /* points buffered for binning */
+    struct BinPoint *points, *sorted;
+    size_t npoints, max_points;
+    size_t *counts;
+
+    /* out-of-core: points of bands in temporary files */
+    FILE **spill;
+    char **spill_names;
+    size_t record_size;
+};
+
+void point_tiles_init(struct PointTiles *, struct PointBinning *, int, int,
+                      RASTER_MAP_TYPE, int, int);
+void point_tiles_add(struct PointTiles *, double, double, double, int, int);
+void point_tiles_write(struct PointTiles *, int, void *);
+void point_tiles_free(struct PointTiles *);
+
+#endif /* __POINT_TILES_H__ */
@@ -0,0 +1,119 @@
+"""
+Name:      r.in.pdal parallel and out-of-core binning test
+Purpose:   Validates that binning with several threads and binning by
+           bands of rows from temporary files give the default result
+
+Author:    GRASS Development Team
+Copyright: (C) 2026 by the GRASS Development Team
+Licence:   This program is free software under the GNU General Public
+           License (>=v2). Read the file COPYING that comes with GRASS
+           for details.
+"""
+
+import os
+import pathlib
+import unittest
+import shutil
+from tempfile import TemporaryDirectory
+
+from grass.script import core as grass
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+
+METHODS = ["n", "min", "max", "sum", "mean", "stddev", "median", "mode", "sidnmax"]
+
+
+class ParallelBinningTest(TestCase):
+    """Test binning with nprocs and memory against the default
+
+    This test requires pdal CLI util to be available.
+    """
+
+    reference = "pdal_parallel_reference"
+    output = "pdal_parallel_output"
+
+    @classmethod
+    @unittest.skipIf(shutil.which("pdal") is None, "Cannot find pdal utility")
+    def setUpClass(cls):
+        """Ensures expected computational region and generated data
+
+        The binning arrays of the region need several MB, so with memory=1
+        the points are binned in bands of rows from temporary files.
+        """
+        cls.use_temp_region()
+        cls.runModule("g.region", n=18, s=0, e=18, w=0, res=0.02)
+
+        cls.data_dir = os.path.join(pathlib.Path(__file__).parent.absolute(), "data")
+        cls.point_file = os.path.join(cls.data_dir, "points.csv")
+        cls.tmp_dir = TemporaryDirectory()
+        cls.las_file = os.path.join(cls.tmp_dir.name, "points.las")
+        grass.call(
+            [
+                "pdal",
+                "translate",
+                "-i",
+                cls.point_file,
+                "-o",
+                cls.las_file,
+                "-r",
+                "text",
+                "-w",
+                "las",
+                "--writers.las.format=0",
+                "--writers.las.extra_dims=all",
+                "--writers.las.minor_version=4",
+            ]
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        """Remove the temporary region and generated data"""
+        cls.tmp_dir.cleanup()
+        cls.del_temp_region()
+
+    @unittest.skipIf(shutil.which("r.in.pdal") is None, "Cannot find r.in.pdal")
+    def tearDown(self):
+        """Remove the outputs created by the import"""
+        self.runModule(
+            "g.remove", flags="f", type="raster", name=(self.reference, self.output)
+        )
+
+    def import_points(self, output, method, **kwargs):
+        self.assertModule(
+            "r.in.pdal",
+            input=self.las_file,
+            output=output,
+            flags="o",
+            quiet=True,
+            method=method,
+            overwrite=True,
+            **kwargs,
+        )
+
+    def compare(self, **kwargs):
+        for method in METHODS:
+            with self.subTest(method=method):
+                self.import_points(self.reference, method)
+                self.import_points(self.output, method, **kwargs)
+                self.assertRastersNoDifference(
+                    self.output, reference=self.reference, precision=0
+                )
+
+    @unittest.skipIf(shutil.which("r.in.pdal") is None, "Cannot find r.in.pdal")
+    def test_nprocs(self):
+        """Binning with nprocs=4 gives the default result"""
+        self.compare(nprocs=4)
+
+    @unittest.skipIf(shutil.which("r.in.pdal") is None, "Cannot find r.in.pdal")
+    def test_memory(self):
+        """Binning by bands of rows from temporary files gives the default"""
+        self.compare(memory=1)
+
+    @unittest.skipIf(shutil.which("r.in.pdal") is None, "Cannot find r.in.pdal")
+    def test_memory_nprocs(self):
+        """Binning by bands of rows with nprocs=4 gives the default result"""
+        self.compare(memory=1, nprocs=4)
+
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,246 @@
+/*
+ * r.in.xyz input fns.
+ *   Copyright 2026 by the GRASS Development Team
+ *
+ *   This program is free software licensed under the GPL (>=v2).
+ *   Read the COPYING file that comes with GRASS for details.
+ *
+ *   Buffered line reader, in-place tokenizer and number parser replacing
+ *   G_getl2(), G_tokenize() and sscanf() in the main loop.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+#define READ_BUFFSIZE (1 << 20)
+
+/* largest integer exactly representable in a double */
+#define MAX_EXACT_INT 9007199254740992ULL
+
+static const double exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+void xyz_input_init(struct xyz_input *input, FILE *fp)
+{
+    input->fp = fp;
+    input->size = READ_BUFFSIZE;
+    input->buf = G_malloc(input->size + 1);
+    input->pos = input->end = 0;
+    input->eof = FALSE;
+    input->nread = 0;
+}
+
+void xyz_input_free(struct xyz_input *input)
+{
+    G_free(input->buf);
+}
+
+/* refill buffer keeping the unread part, returns FALSE at end of file */
+static int fill(struct xyz_input *input)
+{
+    size_t n;
+
+    if (input->eof)
+        return FALSE;
+
+    if (input->pos > 0) {
+        memmove(input->buf, input->buf + input->pos, input->end - input->pos);
+        input->end -= input->pos;
+        input->pos = 0;
+    }
+    n = fread(input->buf + input->end, 1, input->size - input->end,
+              input->fp);
+    if (n == 0) {
+        if (ferror(input->fp))
+            G_fatal_error(_("Error reading input file"));
+        input->eof = TRUE;
+        return FALSE;
+    }
+    input->end += n;
+
+    return TRUE;
+}
+
+/*
+ * Read next line like G_getl2(): "\n", "\r\n" and "\r" end a line, the
+ * line is returned without them. The line is valid until the next call.
+ * Returns NULL at end of file.
+ */
+char *xyz_getl(struct xyz_input *input)
+{
+    char *line, *p, *end;
+    size_t scanned = 0;
+
+    for (;;) {
+        line = input->buf + input->pos;
+        end = input->buf + input->end;
+        for (p = line + scanned; p < end; p++) {
+            if (*p == '\n' || *p == '\r')
+                break;
+        }
+        /* a \r at the end of the buffer may be followed by \n */
+        if (p < end && (*p == '\n' || p + 1 < end || input->eof))
+            break;
+        scanned = p - line;
+        if (input->pos == 0 && input->end == input->size)
+            break; /* line longer than buffer is split */
+        if (!fill(input)) {
+            line = input->buf + input->pos;
+            end = input->buf + input->end;
+            p = line + scanned;
+            if (p == end && p == line)
+                return NULL;
+            break;
+        }
+    }
+
+    input->pos = p - input->buf;
+    if (p < end) {
+        input->pos++;
+        if (*p == '\r' && p + 1 < end && p[1] == '\n')
+            input->pos++;
+    }
+    input->nread += input->pos - (line - input->buf);
+    *p = '\0';
+
+    return line;
+}
+
+/*
+ * Find the fields of a line like G_tokenize() does, each character of fs
+ * is a delimiter. Pointers to the first max_tokens fields are stored in
+ * tokens, the line is not modified. Returns number of fields.
+ */
+int xyz_tokenize(const char *line, const char *fs, const char **tokens,
+                 int max_tokens)
+{
+    const char *p;
+    int n = 1;
+
+    if (max_tokens > 0)
+        tokens[0] = line;
+
+    if (fs[0] != '\0' && fs[1] == '\0') {
+        char c = fs[0];
+
+        for (p = line; *p; p++) {
+            if (*p == c) {
+                if (n < max_tokens)
+                    tokens[n] = p + 1;
+                n++;
+            }
+        }
+    }
+    else {
+        for (p = line; *p; p++) {
+            if (strchr(fs, *p)) {
+                if (n < max_tokens)
+                    tokens[n] = p + 1;
+                n++;
+            }
+        }
+    }
+
+    return n;
+}
+
+static int is_delim(int c, const char *fs)
+{
+    return c != '\0' && strchr(fs, c) != NULL;
+}
+
+/* copy field to buf, e.g. for messages */
+char *xyz_token_string(const char *token, const char *fs, char *buf,
+                       int size)
+{
+    int i;
+
+    for (i = 0; i < size - 1 && !is_delim(token[i], fs) && token[i]; i++)
+        buf[i] = token[i];
+    buf[i] = '\0';
+
+    return buf;
+}
+
+/*
+ * Parse a number from a field, with the same result as sscanf("%lf").
+ * Decimal numbers with up to 17 significant digits and a decimal exponent
+ * of at most 22 are converted exactly without sscanf(), anything else is
+ * handed over to sscanf(). Returns 1 on success, 0 otherwise.
+ */
+int xyz_scan_double(const char *token, const char *fs, double *value)
+{
+    const char *p = token;
+    unsigned long long m = 0;
+    int neg = FALSE, ndigits = 0, exp10 = 0, inexact = FALSE;
+    double v;
+    char buf[256];
+
+    while (isspace((unsigned char)*p) && !is_delim(*p, fs))
+        p++;
+    if (*p == '-' || *p == '+')
+        neg = *p++ == '-';
+
+    for (; *p >= '0' && *p <= '9'; p++, ndigits++) {
+        if (m < 100000000000000000ULL)
+            m = 10 * m + (*p - '0');
+        else {
+            exp10++;
+            if (*p != '0')
+                inexact = TRUE;
+        }
+    }
+    if (*p == '.') {
+        for (p++; *p >= '0' && *p <= '9'; p++, ndigits++) {
+            if (m < 100000000000000000ULL) {
+                m = 10 * m + (*p - '0');
+                exp10--;
+            }
+            else if (*p != '0')
+                inexact = TRUE;
+        }
+    }
+    if (ndigits == 0 || inexact)
+        goto slow;
+
+    if (*p == 'e' || *p == 'E') {
+        int e = 0, eneg = FALSE;
+
+        p++;
+        if (*p == '-' || *p == '+')
+            eneg = *p++ == '-';
+        if (!(*p >= '0' && *p <= '9'))
+            goto slow;
+        for (; *p >= '0' && *p <= '9'; p++) {
+            if (e < 10000)
+                e = 10 * e + (*p - '0');
+        }
+        exp10 += eneg ? -e : e;
+    }
+    /* hexadecimal numbers and the like */
+    if (isalnum((unsigned char)*p) || *p == '.')
+        goto slow;
+
+    if (m > MAX_EXACT_INT || exp10 < -22 || exp10 > 22)
+        goto slow;
+
+    v = (double)m;
+    if (exp10 < 0)
+        v /= exact_pow10[-exp10];
+    else
+        v *= exact_pow10[exp10];
+    *value = neg ? -v : v;
+
+    return 1;
+
+slow:
+    xyz_token_string(token, fs, buf, sizeof(buf));
+
+    return sscanf(buf, "%lf", value);
+}
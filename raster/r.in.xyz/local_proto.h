@@ -17,6 +17,8 @@
 #ifndef __LOCAL_PROTO_H__
 #define __LOCAL_PROTO_H__
 
+#include <stdio.h>
+#include <sys/types.h>
 #include <grass/gis.h>
 
 #define BUFFSIZE          1024
@@ -35,8 +37,26 @@
 #define METHOD_SKEWNESS   12
 #define METHOD_TRIMMEAN   13
 
+/* buffered reading of the input */
+struct xyz_input {
+    FILE *fp;
+    char *buf;
+    size_t size, pos, end;
+    int eof;
+    off_t nread; /* bytes consumed */
+};
+
 /* main.c */
-int scan_bounds(FILE *, int, int, int, int, char *, int, int, double, double);
+int scan_bounds(struct xyz_input *, int, int, int, int, char *, int, int,
+                double, double);
+
+/* input.c */
+void xyz_input_init(struct xyz_input *, FILE *);
+void xyz_input_free(struct xyz_input *);
+char *xyz_getl(struct xyz_input *);
+int xyz_tokenize(const char *, const char *, const char **, int);
+char *xyz_token_string(const char *, const char *, char *, int);
+int xyz_scan_double(const char *, const char *, double *);
 
 /* support.c */
 int blank_array(void *, int, int, RASTER_MAP_TYPE, int);
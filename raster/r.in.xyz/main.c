@@ -4,7 +4,7 @@
  *   Calculates univariate statistics from the non-null cells of a GRASS
  *   raster map
  *
- *   Copyright 2006-2014 by M. Hamish Bowman, and the GRASS Development Team
+ *   Copyright 2006-2026 by M. Hamish Bowman, and the GRASS Development Team
  *   Author: M. Hamish Bowman, University of Otago, Dunedin, New Zealand
  *
  *   Extended 2007 by Volker Wichmann to support the aggregate functions
@@ -23,11 +23,18 @@
 #include <string.h>
 #include <math.h>
 #include <sys/types.h>
+#include <unistd.h>
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/glocale.h>
 #include "local_proto.h"
 
+/* point of a band of rows waiting in a temporary file */
+struct spill_point {
+    double z;
+    int row, col;
+};
+
 struct node {
     int next;
     double z;
@@ -89,6 +96,48 @@ int add_node(int head, double z)
     }
 }
 
+/* add z of a point to the bin of row and col of the arrays of the
+ * statistics of the current band of rows, arrays not needed are NULL */
+static void bin_point(int row, int col, double z, int cols,
+                      RASTER_MAP_TYPE rtype, char *n_array, char *min_array,
+                      char *max_array, char *sum_array, char *sumsq_array,
+                      char *index_array)
+{
+    void *ptr;
+    int head_id;
+
+    if (n_array)
+        update_n(n_array, cols, row, col);
+    if (min_array)
+        update_min(min_array, cols, row, col, rtype, z);
+    if (max_array)
+        update_max(max_array, cols, row, col, rtype, z);
+    if (sum_array)
+        update_sum(sum_array, cols, row, col, rtype, z);
+    if (sumsq_array)
+        update_sumsq(sumsq_array, cols, row, col, rtype, z);
+    if (index_array) {
+        ptr = index_array;
+        ptr = G_incr_void_ptr(ptr, ((row * cols) + col) *
+                                       Rast_cell_size(CELL_TYPE));
+
+        if (Rast_is_null_value(ptr, CELL_TYPE)) { /* first node */
+            head_id = new_node();
+            nodes[head_id].next = -1;
+            nodes[head_id].z = z;
+            Rast_set_c_value(ptr, head_id, CELL_TYPE); /* store index to head */
+        }
+        else { /* head is already there */
+
+            head_id = Rast_get_c_value(ptr, CELL_TYPE); /* get index to head */
+            head_id = add_node(head_id, z);
+            if (head_id != -1)
+                Rast_set_c_value(ptr, head_id,
+                                 CELL_TYPE); /* store index to head */
+        }
+    }
+}
+
 int main(int argc, char *argv[])
 {
 
@@ -100,26 +149,31 @@ int main(int argc, char *argv[])
     int bin_n, bin_min, bin_max, bin_sum, bin_sumsq, bin_index;
     double zrange_min, zrange_max, vrange_min, vrange_max, d_tmp;
     char *fs; /* field delim */
-    off_t filesize;
-    int linesize = 0;
-    unsigned long estimated_lines, line;
+    off_t filesize = 0;
+    unsigned long line;
     int from_stdin;
     int can_seek;
+    struct xyz_input input;
+    FILE **spill_fp = NULL;
+    char **spill_names = NULL;
+    struct spill_point point;
+    int band, band_rows;
 
     RASTER_MAP_TYPE rtype;
     struct History history;
     char title[64];
-    char *n_array, *min_array, *max_array, *sum_array, *sumsq_array,
-        *index_array;
+    char *n_array = NULL, *min_array = NULL, *max_array = NULL,
+        *sum_array = NULL, *sumsq_array = NULL, *index_array = NULL;
     void *raster_row, *ptr;
     struct Cell_head region = {0};
-    int rows, last_rows, row0, cols; /* scan box size */
+    int rows, last_rows, cols; /* scan box size */
     int row, col;                    /* counters */
 
     int pass, npasses;
-    char buff[BUFFSIZE];
+    char *buff;
+    char tok[BUFFSIZE];
     double x, y, z;
-    char **tokens;
+    const char **tokens;
     int ntokens; /* number of tokens */
     int arr_row, arr_col;
     unsigned long count, count_total;
@@ -587,17 +641,16 @@ int main(int argc, char *argv[])
     }
 
     can_seek = fseek(in_fp, 0L, SEEK_SET) == 0;
-
-    /* can't rewind() non-files */
-    if (!can_seek && npasses != 1) {
-        G_warning(_("If input is not from a file it is only possible to "
-                    "perform a single pass."));
-        npasses = 1;
+    if (can_seek) {
+        G_fseek(in_fp, 0L, SEEK_END);
+        filesize = G_ftell(in_fp);
+        rewind(in_fp);
     }
+    xyz_input_init(&input, in_fp);
 
     /* skip past header lines */
     for (line = 0; line < (unsigned long)skip_lines; line++) {
-        if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
+        if (!xyz_getl(&input))
             break;
     }
 
@@ -606,10 +659,11 @@ int main(int argc, char *argv[])
             G_warning(
                 _("Range filters will not be taken into account during scan"));
 
-        scan_bounds(in_fp, xcol, ycol, zcol, vcol, fs, shell_style->answer,
+        scan_bounds(&input, xcol, ycol, zcol, vcol, fs, shell_style->answer,
                     skipline->answer, zscale, vscale);
 
         /* close input file */
+        xyz_input_free(&input);
         if (!from_stdin)
             fclose(in_fp);
 
@@ -619,28 +673,25 @@ int main(int argc, char *argv[])
     /* open output map */
     out_fd = Rast_open_new(outmap, rtype);
 
-    if (can_seek) {
-        /* guess at number of lines in the file without actually reading it all
-         * in */
-        for (line = 0; line < 10;
-             line++) { /* arbitrarily use 10th line for guess */
-            if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
-                break;
-            linesize = strlen(buff) + 1;
-        }
-        G_fseek(in_fp, 0L, SEEK_END);
-        filesize = G_ftell(in_fp);
-        rewind(in_fp);
-        if (linesize < 6) /* min possible: "0,0,0\n" */
-            linesize = 6;
-        estimated_lines = filesize / linesize;
-        G_debug(2, "estimated number of lines in file: %lu", estimated_lines);
-    }
-    else
-        estimated_lines = -1;
-
     /* allocate memory for a single row of output data */
     raster_row = Rast_allocate_buf(rtype);
+    tokens = G_malloc(max_col * sizeof(char *));
+
+    /* The input is parsed only once. With several passes, the points of
+     * the bands of rows of later passes are written to temporary files
+     * in binary form and binned from there. */
+    band_rows = rows;
+    if (npasses > 1) {
+        spill_fp = G_calloc(npasses, sizeof(FILE *));
+        spill_names = G_calloc(npasses, sizeof(char *));
+        for (band = 1; band < npasses; band++) {
+            spill_names[band] = G_tempfile();
+            spill_fp[band] = fopen(spill_names[band], "w+b");
+            if (!spill_fp[band])
+                G_fatal_error(_("Unable to create temporary file <%s>"),
+                              spill_names[band]);
+        }
+    }
 
     G_message(_("Reading input data..."));
 
@@ -651,18 +702,14 @@ int main(int argc, char *argv[])
         if (npasses > 1)
             G_message(_("Pass #%d (of %d) ..."), pass, npasses);
 
-        if (can_seek) {
-            rewind(in_fp);
-
-            /* skip past header lines again */
-            for (line = 0; line < (unsigned long)skip_lines; line++) {
-                if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
-                    break;
-            }
+        if (pass > 1) {
+            if (fflush(spill_fp[pass - 1]) != 0 ||
+                fseek(spill_fp[pass - 1], 0L, SEEK_SET) != 0)
+                G_fatal_error(_("Unable to read temporary file <%s>"),
+                              spill_names[pass - 1]);
         }
 
         /* figure out segmentation */
-        row0 = (pass - 1) * rows;
         if (pass == npasses) {
             rows = last_rows;
         }
@@ -711,14 +758,28 @@ int main(int argc, char *argv[])
         count = 0;
         G_percent_reset();
 
-        while (0 != G_getl2(buff, BUFFSIZE - 1, in_fp)) {
+        while (1) {
+            if (pass > 1) {
+                /* points of this band from the temporary file */
+                if (fread(&point, sizeof(struct spill_point), 1,
+                          spill_fp[pass - 1]) != 1)
+                    break;
+                count++;
+                bin_point(point.row, point.col, point.z, cols, rtype, n_array,
+                          min_array, max_array, sum_array, sumsq_array,
+                          index_array);
+                continue;
+            }
+
+            if (!(buff = xyz_getl(&input)))
+                break;
             line++;
 
             if (line % 100000 == 0) { /* mod for speed */
                 if (!can_seek)
                     G_clicker();
-                else if (line < estimated_lines)
-                    G_percent(line, estimated_lines, 3);
+                else
+                    G_percent(input.nread, filesize, 3);
             }
 
             if ((buff[0] == '#') || (buff[0] == '\0')) {
@@ -727,8 +788,7 @@ int main(int argc, char *argv[])
 
             G_chop(buff); /* remove leading and trailing whitespace from the
                              string.  unneeded?? */
-            tokens = G_tokenize(buff, fs);
-            ntokens = G_number_of_tokens(tokens);
+            ntokens = xyz_tokenize(buff, fs, tokens, max_col);
 
             if ((ntokens < 3) || (max_col > ntokens)) {
                 if (skipline->answer) {
@@ -756,101 +816,89 @@ int main(int argc, char *argv[])
                }
                else {
              */
-            if (1 != sscanf(tokens[ycol - 1], "%lf", &y))
-                G_fatal_error(_("Bad y-coordinate line %lu column %d. <%s>"),
-                              line, ycol, tokens[ycol - 1]);
+            if (1 != xyz_scan_double(tokens[ycol - 1], fs, &y))
+                G_fatal_error(
+                    _("Bad y-coordinate line %lu column %d. <%s>"), line, ycol,
+                    xyz_token_string(tokens[ycol - 1], fs, tok, BUFFSIZE));
             if (y <= region.south || y > region.north) {
-                G_free_tokens(tokens);
                 continue;
             }
-            if (1 != sscanf(tokens[xcol - 1], "%lf", &x))
-                G_fatal_error(_("Bad x-coordinate line %lu column %d. <%s>"),
-                              line, xcol, tokens[xcol - 1]);
+            if (1 != xyz_scan_double(tokens[xcol - 1], fs, &x))
+                G_fatal_error(
+                    _("Bad x-coordinate line %lu column %d. <%s>"), line, xcol,
+                    xyz_token_string(tokens[xcol - 1], fs, tok, BUFFSIZE));
             if (x < region.west || x >= region.east) {
-                G_free_tokens(tokens);
                 continue;
             }
 
-            /* find the bin in the current array box */
-            arr_row = (int)((region.north - y) / region.ns_res) - row0;
-            if (arr_row < 0 || arr_row >= rows) {
-                G_free_tokens(tokens);
+            /* find the bin in the region */
+            arr_row = (int)((region.north - y) / region.ns_res);
+            if (arr_row < 0 || arr_row >= region.rows) {
                 continue;
             }
             arr_col = (int)((x - region.west) / region.ew_res);
 
             /* G_debug(5, "arr_row: %d   arr_col: %d", arr_row, arr_col); */
 
-            if (1 != sscanf(tokens[zcol - 1], "%lf", &z))
-                G_fatal_error(_("Bad z-coordinate line %lu column %d. <%s>"),
-                              line, zcol, tokens[zcol - 1]);
+            if (1 != xyz_scan_double(tokens[zcol - 1], fs, &z))
+                G_fatal_error(
+                    _("Bad z-coordinate line %lu column %d. <%s>"), line, zcol,
+                    xyz_token_string(tokens[zcol - 1], fs, tok, BUFFSIZE));
             z = z * zscale;
 
             if (zrange_opt->answer) {
                 if (z < zrange_min || z > zrange_max) {
-                    G_free_tokens(tokens);
                     continue;
                 }
             }
 
             if (vcol) {
-                if (1 != sscanf(tokens[vcol - 1], "%lf", &z))
-                    G_fatal_error(_("Bad data value line %lu column %d. <%s>"),
-                                  line, vcol, tokens[vcol - 1]);
+                if (1 != xyz_scan_double(tokens[vcol - 1], fs, &z))
+                    G_fatal_error(
+                        _("Bad data value line %lu column %d. <%s>"), line,
+                        vcol,
+                        xyz_token_string(tokens[vcol - 1], fs, tok, BUFFSIZE));
                 /* we're past the zrange check, so pass over control of the
                  * variable */
                 z = z * vscale;
 
                 if (vrange_opt->answer) {
                     if (z < vrange_min || z > vrange_max) {
-                        G_free_tokens(tokens);
                         continue;
                     }
                 }
             }
 
+            /* points of later passes go to the temporary file of their band */
+            band = arr_row / band_rows;
+            arr_row -= band * band_rows;
+            if (band > 0) {
+                point.z = z;
+                point.row = arr_row;
+                point.col = arr_col;
+                if (fwrite(&point, sizeof(struct spill_point), 1,
+                           spill_fp[band]) != 1)
+                    G_fatal_error(_("Unable to write to temporary file <%s>"),
+                                  spill_names[band]);
+                continue;
+            }
+
             count++;
             /* G_debug(5, "x: %f, y: %f, z: %f", x, y, z); */
-            G_free_tokens(tokens);
-
-            if (bin_n)
-                update_n(n_array, cols, arr_row, arr_col);
-            if (bin_min)
-                update_min(min_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_max)
-                update_max(max_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_sum)
-                update_sum(sum_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_sumsq)
-                update_sumsq(sumsq_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_index) {
-                ptr = index_array;
-                ptr = G_incr_void_ptr(ptr, ((arr_row * cols) + arr_col) *
-                                               Rast_cell_size(CELL_TYPE));
-
-                if (Rast_is_null_value(ptr, CELL_TYPE)) { /* first node */
-                    head_id = new_node();
-                    nodes[head_id].next = -1;
-                    nodes[head_id].z = z;
-                    Rast_set_c_value(ptr, head_id,
-                                     CELL_TYPE); /* store index to head */
-                }
-                else { /* head is already there */
-
-                    head_id = Rast_get_c_value(
-                        ptr, CELL_TYPE); /* get index to head */
-                    head_id = add_node(head_id, z);
-                    if (head_id != -1)
-                        Rast_set_c_value(ptr, head_id,
-                                         CELL_TYPE); /* store index to head */
-                }
-            }
+            bin_point(arr_row, arr_col, z, cols, rtype, n_array, min_array,
+                      max_array, sum_array, sumsq_array, index_array);
         } /* while !EOF */
 
         G_percent(1, 1, 1); /* flush */
         G_debug(2, "pass %d finished, %lu coordinates in box", pass, count);
         count_total += count;
-        G_message(_("%lu points found in input file"), line);
+        if (pass == 1)
+            G_message(_("%lu points found in input file"), line);
+        else {
+            fclose(spill_fp[pass - 1]);
+            unlink(spill_names[pass - 1]);
+            G_free(spill_names[pass - 1]);
+        }
 
         /* calc stats and output */
         G_message(_("Writing to output raster map..."));
@@ -1185,8 +1233,14 @@ int main(int argc, char *argv[])
 
     G_percent(1, 1, 1); /* flush */
     G_free(raster_row);
+    G_free(tokens);
+    if (npasses > 1) {
+        G_free(spill_fp);
+        G_free(spill_names);
+    }
 
     /* close input file */
+    xyz_input_free(&input);
     if (!from_stdin)
         fclose(in_fp);
 
@@ -1208,12 +1262,14 @@ int main(int argc, char *argv[])
     exit(EXIT_SUCCESS);
 }
 
-int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
-                int shell_style, int skipline, double zscale, double vscale)
+int scan_bounds(struct xyz_input *input, int xcol, int ycol, int zcol,
+                int vcol, char *fs, int shell_style, int skipline,
+                double zscale, double vscale)
 {
     unsigned long line;
     int first, max_col;
-    char buff[BUFFSIZE];
+    char *buff;
+    char tok[BUFFSIZE];
     double min_x = 0.0;
     double max_x = 0.0;
     double min_y = 0.0;
@@ -1222,7 +1278,7 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
     double max_z = 0.0;
     double min_v = 0.0;
     double max_v = 0.0;
-    char **tokens;
+    const char **tokens;
     int ntokens; /* number of tokens */
     double x, y, z, v;
 
@@ -1230,13 +1286,14 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
     max_col = (zcol > max_col) ? zcol : max_col;
     if (vcol)
         max_col = (vcol > max_col) ? vcol : max_col;
+    tokens = G_malloc(max_col * sizeof(char *));
 
     line = 0;
     first = TRUE;
 
     G_verbose_message(_("Scanning data ..."));
 
-    while (0 != G_getl2(buff, BUFFSIZE - 1, fp)) {
+    while ((buff = xyz_getl(input))) {
         line++;
 
         if ((buff[0] == '#') || (buff[0] == '\0')) {
@@ -1244,8 +1301,7 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
         }
 
         G_chop(buff); /* remove leading and trailing whitespace. unneeded?? */
-        tokens = G_tokenize(buff, fs);
-        ntokens = G_number_of_tokens(tokens);
+        ntokens = xyz_tokenize(buff, fs, tokens, max_col);
 
         if ((ntokens < 3) || (max_col > ntokens)) {
             if (skipline) {
@@ -1273,9 +1329,10 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
            }
            else {
          */
-        if (1 != sscanf(tokens[xcol - 1], "%lf", &x))
-            G_fatal_error(_("Bad x-coordinate line %lu column %d. <%s>"), line,
-                          xcol, tokens[xcol - 1]);
+        if (1 != xyz_scan_double(tokens[xcol - 1], fs, &x))
+            G_fatal_error(
+                _("Bad x-coordinate line %lu column %d. <%s>"), line, xcol,
+                xyz_token_string(tokens[xcol - 1], fs, tok, BUFFSIZE));
 
         if (first) {
             min_x = x;
@@ -1288,9 +1345,10 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
                 max_x = x;
         }
 
-        if (1 != sscanf(tokens[ycol - 1], "%lf", &y))
-            G_fatal_error(_("Bad y-coordinate line %lu column %d. <%s>"), line,
-                          ycol, tokens[ycol - 1]);
+        if (1 != xyz_scan_double(tokens[ycol - 1], fs, &y))
+            G_fatal_error(
+                _("Bad y-coordinate line %lu column %d. <%s>"), line, ycol,
+                xyz_token_string(tokens[ycol - 1], fs, tok, BUFFSIZE));
 
         if (first) {
             min_y = y;
@@ -1303,9 +1361,10 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
                 max_y = y;
         }
 
-        if (1 != sscanf(tokens[zcol - 1], "%lf", &z))
-            G_fatal_error(_("Bad z-coordinate line %lu column %d. <%s>"), line,
-                          zcol, tokens[zcol - 1]);
+        if (1 != xyz_scan_double(tokens[zcol - 1], fs, &z))
+            G_fatal_error(
+                _("Bad z-coordinate line %lu column %d. <%s>"), line, zcol,
+                xyz_token_string(tokens[zcol - 1], fs, tok, BUFFSIZE));
 
         if (first) {
             min_z = z;
@@ -1321,9 +1380,10 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
         }
 
         if (vcol) {
-            if (1 != sscanf(tokens[vcol - 1], "%lf", &v))
-                G_fatal_error(_("Bad data value line %lu column %d. <%s>"),
-                              line, vcol, tokens[vcol - 1]);
+            if (1 != xyz_scan_double(tokens[vcol - 1], fs, &v))
+                G_fatal_error(
+                    _("Bad data value line %lu column %d. <%s>"), line, vcol,
+                    xyz_token_string(tokens[vcol - 1], fs, tok, BUFFSIZE));
 
             if (first) {
                 min_v = v;
@@ -1337,9 +1397,8 @@ int scan_bounds(FILE *fp, int xcol, int ycol, int zcol, int vcol, char *fs,
                     max_v = v;
             }
         }
-
-        G_free_tokens(tokens);
     }
+    G_free(tokens);
 
     if (!shell_style) {
         fprintf(stderr, _("Range:     min         max\n"));
@@ -0,0 +1,182 @@
+"""
+Name:      r.in.xyz test
+Purpose:   Validates parsing of numbers and binning in several passes
+
+Author:    GRASS Development Team
+Copyright: (C) 2026 by the GRASS Development Team
+Licence:   This program is free software under the GNU General Public
+           License (>=v2). Read the file COPYING that comes with GRASS
+           for details.
+"""
+
+import os
+import random
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import tempfile
+
+# values as written in the input and the same values in plain notation
+NUMBERS = [
+    ("150", 150.0),
+    ("+150", 150.0),
+    ("-150", -150.0),
+    ("1.5e2", 150.0),
+    ("1.5E+2", 150.0),
+    ("15000e-2", 150.0),
+    ("-0.15E3", -150.0),
+    (".5", 0.5),
+    ("5.", 5.0),
+    ("-1.25e-3", -1.25e-3),
+    ("0.1", 0.1),
+    ("123.456789", 123.456789),
+    ("1e22", 1e22),
+    ("1e23", 1e23),
+    ("1e-22", 1e-22),
+    ("1e-300", 1e-300),
+    ("123456789012345678901", 123456789012345678901.0),
+    ("0.12345678901234567890123", 0.12345678901234567890123),
+    ("9007199254740993", 9007199254740993.0),
+    ("00000000000000000000123", 123.0),
+    ("  42.5", 42.5),
+    ("\t-7.25", -7.25),
+    ("3.75  ", 3.75),
+    ("0", 0.0),
+    ("-0.0", -0.0),
+]
+
+SEPARATORS = {"pipe": "|", "comma": ",", "space": " ", "tab": "\t"}
+
+
+class TestParsing(TestCase):
+    """Numbers in any notation give the values of the plain notation"""
+
+    output = "test_r_in_xyz_output"
+    reference = "test_r_in_xyz_reference"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=5, s=0, e=5, w=0, res=1)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+
+    def setUp(self):
+        self.files = []
+
+    def tearDown(self):
+        for name in self.files:
+            os.remove(name)
+        self.runModule(
+            "g.remove", flags="f", type="raster", name=[self.output, self.reference]
+        )
+
+    def write(self, lines):
+        name = tempfile()
+        with open(name, "w") as fp:
+            fp.write("\n".join(lines) + "\n")
+        self.files.append(name)
+        return name
+
+    def import_points(self, name, output, separator):
+        self.assertModule(
+            "r.in.xyz",
+            input=name,
+            output=output,
+            separator=separator,
+            method="max",
+            type="DCELL",
+            overwrite=True,
+        )
+
+    def compare(self, separator, text, plain):
+        """One point per cell, value of the point in each cell"""
+        sep = SEPARATORS[separator]
+        lines = []
+        reference = []
+        for i, (z, value) in enumerate(zip(text, plain)):
+            # coordinates in a different notation as well
+            x = f"{(i % 5 + 0.5) * 10:.1f}e-1"
+            y = f"+{i // 5 + 0.5}"
+            if separator in {"space", "tab"}:
+                z = z.strip(" \t")
+            lines.append(sep.join([x, y, z]))
+            reference.append(
+                sep.join([repr(i % 5 + 0.5), repr(i // 5 + 0.5), repr(value)])
+            )
+        self.import_points(self.write(lines), self.output, separator)
+        self.import_points(self.write(reference), self.reference, separator)
+        self.assertRastersNoDifference(
+            self.output, reference=self.reference, precision=0
+        )
+
+    def test_notations(self):
+        """Exponents, signs, leading zeros, digits beyond double precision"""
+        text, plain = zip(*NUMBERS)
+        self.compare("pipe", text, plain)
+
+    def test_separators(self):
+        """Fields between different separators"""
+        text, plain = zip(*NUMBERS)
+        for separator in SEPARATORS:
+            with self.subTest(separator=separator):
+                self.compare(separator, text, plain)
+
+    def test_bad_number(self):
+        """Field which is not a number fails"""
+        name = self.write(["0.5|0.5|1", "1.5|0.5|abc"])
+        self.assertModuleFail(
+            "r.in.xyz", input=name, output=self.output, separator="pipe"
+        )
+
+
+class TestPercent(TestCase):
+    """Binning in several passes gives the result of a single pass"""
+
+    output = "test_r_in_xyz_percent"
+    reference = "test_r_in_xyz_single"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=50, s=0, e=40, w=0, res=1)
+        rng = random.Random(1)
+        cls.points = tempfile()
+        with open(cls.points, "w") as fp:
+            for _ in range(20000):
+                x = rng.uniform(0, 40)
+                y = rng.uniform(0, 50)
+                z = rng.gauss(100, 20)
+                fp.write(f"{x:.6f}|{y:.6f}|{z:.4f}\n")
+
+    @classmethod
+    def tearDownClass(cls):
+        os.remove(cls.points)
+        cls.runModule(
+            "g.remove", flags="f", type="raster", name=[cls.output, cls.reference]
+        )
+        cls.del_temp_region()
+
+    def test_percent(self):
+        """percent=25 equals percent=100 for several methods"""
+        for method in ("n", "min", "max", "sum", "mean", "stddev", "median"):
+            with self.subTest(method=method):
+                for output, percent in ((self.reference, 100), (self.output, 25)):
+                    self.assertModule(
+                        "r.in.xyz",
+                        input=self.points,
+                        output=output,
+                        method=method,
+                        type="DCELL",
+                        percent=percent,
+                        overwrite=True,
+                    )
+                self.assertRastersNoDifference(
+                    self.output, reference=self.reference, precision=0
+                )
+
+
+if __name__ == "__main__":
+    test()
@@ -15,12 +15,12 @@
 #include <grass/raster.h>
 #include "r.proj.h"
 
-void p_bilinear(struct cache *ibuffer,   /* input buffer                  */
-                void *obufptr,           /* ptr in output buffer          */
-                int cell_type,           /* raster map type of obufptr    */
-                double col_idx,          /* column index          */
-                double row_idx,          /* row index                     */
-                struct Cell_head *cellhd /* information of output map     */
+void p_bilinear(struct R_block_cache *ibuffer, /* input buffer */
+                void *obufptr,                 /* ptr in output buffer */
+                int cell_type,                 /* raster map type of obufptr */
+                double col_idx,                /* column index */
+                double row_idx,                /* row index */
+                struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
@@ -29,6 +29,7 @@ void p_bilinear(struct cache *ibuffer,   /* input buffer                  */
     FCELL t, u;   /* intermediate slope            */
     FCELL result; /* result of interpolation       */
     FCELL c[2][2];
+    DCELL w[4];
 
     /* cut indices to integer */
     row = (int)floor(row_idx - 0.5);
@@ -41,11 +42,12 @@ void p_bilinear(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
+    Rast_get_block_cache_d_window(ibuffer, row, col, 2, 2, w);
     for (i = 0; i < 2; i++)
         for (j = 0; j < 2; j++) {
-            const FCELL cell = CVAL(ibuffer, row + i, col + j);
+            const DCELL cell = w[i * 2 + j];
 
-            if (Rast_is_f_null_value(&cell)) {
+            if (Rast_is_d_null_value(&cell)) {
                 Rast_set_null_value(obufptr, 1, cell_type);
                 return;
             }
@@ -17,12 +17,12 @@
 #include <math.h>
 #include "r.proj.h"
 
-void p_cubic(struct cache *ibuffer,   /* input buffer                  */
-             void *obufptr,           /* ptr in output buffer          */
-             int cell_type,           /* raster map type of obufptr    */
-             double col_idx,          /* column index (decimal)        */
-             double row_idx,          /* row index (decimal)           */
-             struct Cell_head *cellhd /* information of output map     */
+void p_cubic(struct R_block_cache *ibuffer, /* input buffer */
+             void *obufptr,                 /* ptr in output buffer */
+             int cell_type,                 /* raster map type of obufptr */
+             double col_idx,                /* column index (decimal) */
+             double row_idx,                /* row index (decimal) */
+             struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
@@ -32,6 +32,7 @@ void p_cubic(struct cache *ibuffer,   /* input buffer                  */
     FCELL result; /* result of interpolation       */
     FCELL val[4]; /* buffer for temporary values   */
     FCELL c[4][4];
+    DCELL w[16];
 
     /* cut indices to integer */
     row = (int)floor(row_idx - 0.5);
@@ -44,11 +45,12 @@ void p_cubic(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
+    Rast_get_block_cache_d_window(ibuffer, row - 1, col - 1, 4, 4, w);
     for (i = 0; i < 4; i++)
         for (j = 0; j < 4; j++) {
-            const FCELL cell = CVAL(ibuffer, row - 1 + i, col - 1 + j);
+            const DCELL cell = w[i * 4 + j];
 
-            if (Rast_is_f_null_value(&cell)) {
+            if (Rast_is_d_null_value(&cell)) {
                 Rast_set_null_value(obufptr, 1, cell_type);
                 return;
             }
@@ -13,17 +13,17 @@
 #include <grass/raster.h>
 #include "r.proj.h"
 
-void p_cubic_f(struct cache *ibuffer,   /* input buffer                  */
-               void *obufptr,           /* ptr in output buffer          */
-               int cell_type,           /* raster map type of obufptr    */
-               double col_idx,          /* column index          */
-               double row_idx,          /* row index                     */
-               struct Cell_head *cellhd /* cell header of input layer    */
+void p_cubic_f(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double col_idx,                /* column index */
+               double row_idx,                /* row index */
+               struct Cell_head *cellhd       /* cell header of input layer */
 )
 {
     /* start nearest neighbor to do some basic tests */
     int row, col; /* row/col of nearest neighbor   */
-    FCELL cell;
+    DCELL cell;
 
     /* cut indices to integer */
     row = (int)floor(row_idx);
@@ -35,9 +35,9 @@ void p_cubic_f(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    cell = CVAL(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
     /* if nearest is null, all the other interps will be null */
-    if (Rast_is_f_null_value(&cell)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
@@ -48,6 +48,6 @@ void p_cubic_f(struct cache *ibuffer,   /* input buffer                  */
         p_bilinear(ibuffer, obufptr, cell_type, col_idx, row_idx, cellhd);
         /* fallback to nearest if bilinear is null */
         if (Rast_is_f_null_value(obufptr))
-            Rast_set_f_value(obufptr, cell, cell_type);
+            Rast_set_d_value(obufptr, cell, cell_type);
     }
 }
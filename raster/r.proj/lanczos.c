@@ -17,17 +17,17 @@
 #include <math.h>
 #include "r.proj.h"
 
-void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
-               void *obufptr,           /* ptr in output buffer          */
-               int cell_type,           /* raster map type of obufptr    */
-               double col_idx,          /* column index (decimal)        */
-               double row_idx,          /* row index (decimal)           */
-               struct Cell_head *cellhd /* information of output map     */
+void p_lanczos(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double col_idx,                /* column index (decimal) */
+               double row_idx,                /* row index (decimal) */
+               struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
     int col; /* column indices for interp     */
-    int i, j, k;
+    int k;
     double t, u;  /* intermediate slope            */
     FCELL result; /* result of interpolation       */
     DCELL c[25];
@@ -43,17 +43,14 @@ void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    k = 0;
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 5; j++) {
-            const FCELL cell = CVAL(ibuffer, row - 2 + i, col - 2 + j);
-
-            if (Rast_is_f_null_value(&cell)) {
-                Rast_set_null_value(obufptr, 1, cell_type);
-                return;
-            }
-            c[k++] = cell;
+    Rast_get_block_cache_d_window(ibuffer, row - 2, col - 2, 5, 5, c);
+    for (k = 0; k < 25; k++) {
+        /* values were read as FCELL */
+        if (Rast_is_d_null_value(&c[k])) {
+            Rast_set_null_value(obufptr, 1, cell_type);
+            return;
         }
+        c[k] = (FCELL)c[k];
     }
 
     /* do the interpolation  */
@@ -65,17 +62,17 @@ void p_lanczos(struct cache *ibuffer,   /* input buffer                  */
     Rast_set_f_value(obufptr, result, cell_type);
 }
 
-void p_lanczos_f(struct cache *ibuffer,   /* input buffer                  */
-                 void *obufptr,           /* ptr in output buffer          */
-                 int cell_type,           /* raster map type of obufptr    */
-                 double col_idx,          /* column index (decimal)        */
-                 double row_idx,          /* row index (decimal)           */
-                 struct Cell_head *cellhd /* information of output map     */
+void p_lanczos_f(struct R_block_cache *ibuffer, /* input buffer */
+                 void *obufptr,                 /* ptr in output buffer */
+                 int cell_type,                 /* raster map type of obufptr */
+                 double col_idx,                /* column index (decimal) */
+                 double row_idx,                /* row index (decimal) */
+                 struct Cell_head *cellhd       /* information of output map */
 )
 {
     int row; /* row indices for interp        */
     int col; /* column indices for interp     */
-    FCELL cell;
+    DCELL cell;
 
     /* cut indices to integer */
     row = (int)floor(row_idx);
@@ -87,9 +84,9 @@ void p_lanczos_f(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    cell = CVAL(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
     /* if nearest is null, all the other interps will be null */
-    if (Rast_is_f_null_value(&cell)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
@@ -103,7 +100,7 @@ void p_lanczos_f(struct cache *ibuffer,   /* input buffer                  */
             p_bilinear(ibuffer, obufptr, cell_type, col_idx, row_idx, cellhd);
             /* fallback to nearest if bilinear is null */
             if (Rast_is_f_null_value(obufptr))
-                Rast_set_f_value(obufptr, cell, cell_type);
+                Rast_set_d_value(obufptr, cell, cell_type);
         }
     }
 }
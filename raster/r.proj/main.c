@@ -16,7 +16,7 @@
 *                one of three different methods: nearest neighbor, bilinear and
 *                cubic convolution.
 *
-* COPYRIGHT:     (C) 2001, 2011 by the GRASS Development Team
+* COPYRIGHT:     (C) 2001-2026 by the GRASS Development Team
 *
 *                This program is free software under the GNU General Public
 *                License (>=v2). Read the file COPYING that comes with GRASS
@@ -51,9 +51,15 @@
 *                the entire map into memory.
 *                Markus Metz 2010: lanczos and lanczos fallback interpolation
 *                methods
+*                2026: tiles of the output map projected in parallel, optional
+*                approximate transformation
 
 *****************************************************************************/
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -77,8 +83,28 @@ struct menu menu[] = {
     {p_lanczos_f, "lanczos_f", "lanczos filter with fallback"},
     {NULL, NULL, NULL}};
 
+/* output rows projected at once, rows and columns of a tile projected by
+ * one thread */
+#define BAND_ROWS 64
+#define TILE_ROWS 16
+#define TILE_COLS 64
+
+/* settings shared by the threads */
+struct projection {
+    const struct pj_info *iproj, *oproj;
+    struct Cell_head *incellhd;
+    const struct Cell_head *outcellhd;
+    struct R_block_cache *ibuffer;
+    func interpolate;
+    int cell_type;
+    size_t cell_size;
+    double tolerance; /* maximum error in input cells, 0 for exact */
+};
+
 static char *make_ipol_list(void);
 static char *make_ipol_desc(void);
+static void project_tile(const struct projection *, const struct pj_info *,
+                         void *, int, int, int, int);
 
 int main(int argc, char **argv)
 {
@@ -92,20 +118,19 @@ int main(int argc, char **argv)
         permissions,               /* mapset permissions           */
         cell_type,                 /* output celltype              */
         cell_size,                 /* size of a cell in bytes      */
-        row, col,                  /* counters                     */
+        row, i,                    /* counters                     */
         irows, icols,              /* original rows, cols          */
         orows, ocols, have_colors, /* Input map has a colour table */
         overwrite,                 /* Overwrite                    */
-        curr_proj;                 /* output projection (see gis.h) */
+        curr_proj,                 /* output projection (see gis.h) */
+        nprocs;                    /* number of threads            */
 
-    void *obuffer; /* buffer that holds one output row     */
+    void *obuffer; /* buffer that holds a band of output rows */
 
-    struct cache *ibuffer; /* buffer that holds the input map      */
-    func interpolate;      /* interpolation routine        */
+    struct R_block_cache *ibuffer; /* blocks of the input map      */
+    func interpolate;              /* interpolation routine        */
 
-    double xcoord2,     /* temporary x coordinates      */
-        ycoord2,        /* temporary y coordinates      */
-        onorth, osouth, /* save original border coords  */
+    double onorth, osouth, /* save original border coords  */
         oeast, owest, inorth, isouth, ieast, iwest;
     char north_str[30], south_str[30], east_str[30], west_str[30];
 
@@ -114,7 +139,9 @@ int main(int argc, char **argv)
 
     struct pj_info iproj, /* input map proj parameters    */
         oproj,            /* output map proj parameters   */
-        tproj;            /* transformation parameters   */
+        tproj,            /* transformation parameters   */
+        **ttproj;         /* transformation of each thread */
+    struct projection proj; /* settings shared by the threads */
 
     struct Key_Value *in_proj_info, /* projection information of    */
         *in_unit_info,              /* input and output mapsets     */
@@ -134,6 +161,8 @@ int main(int argc, char **argv)
         *indbase,           /* name of input database       */
         *interpol,          /* interpolation method         */
         *memory,            /* amount of memory for cache   */
+        *nprocs_opt,        /* number of threads            */
+        *tolerance,         /* error of approximation       */
         *res,               /* resolution of target map     */
         *format;            /* output format                */
 
@@ -152,6 +181,7 @@ int main(int argc, char **argv)
     G_add_keyword(_("projection"));
     G_add_keyword(_("transformation"));
     G_add_keyword(_("import"));
+    G_add_keyword(_("parallel"));
     module->description = _("Re-projects a raster map from given project to "
                             "the current project.");
 
@@ -193,6 +223,20 @@ int main(int argc, char **argv)
 
     memory = G_define_standard_option(G_OPT_MEMORYMB);
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
+    tolerance = G_define_option();
+    tolerance->key = "tolerance";
+    tolerance->type = TYPE_DOUBLE;
+    tolerance->required = NO;
+    tolerance->answer = "0";
+    tolerance->label = _("Maximum error of approximate coordinate "
+                         "transformation in input cells");
+    tolerance->description =
+        _("Coordinates are projected exactly on a coarse grid and linearly "
+          "interpolated in between, 0 projects each cell exactly");
+    tolerance->guisection = _("Target");
+
     res = G_define_option();
     res->key = "resolution";
     res->type = TYPE_DOUBLE;
@@ -248,6 +292,8 @@ int main(int argc, char **argv)
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     if (strcmp(format->answer, "json") == 0) {
         outputFormat = JSON;
     }
@@ -672,13 +718,13 @@ int main(int argc, char **argv)
     G_message(_("NS-res: %f"), outcellhd.ns_res);
     G_message(" ");
 
-    /* open and read the relevant parts of the input map and close it */
+    /* open the relevant parts of the input map, blocks are read when they
+     * are needed */
     G_switch_env();
     Rast_set_input_window(&incellhd);
     fdi = Rast_open_old(inmap->answer, setname);
     cell_type = Rast_get_map_type(fdi);
-    ibuffer = readcell(fdi, memory->answer);
-    Rast_close(fdi);
+    ibuffer = Rast_open_block_cache(fdi, atoi(memory->answer));
 
     /* And switch back to original location */
     G_switch_env();
@@ -697,73 +743,89 @@ int main(int argc, char **argv)
     if (GPJ_init_transform(&oproj, &iproj, &tproj) < 0)
         G_fatal_error(_("Unable to initialize coordinate transformation"));
 
+    /* each thread needs its own PROJ transformation object */
+    ttproj = G_malloc(nprocs * sizeof(struct pj_info *));
+    ttproj[0] = &tproj;
+    for (i = 1; i < nprocs; i++) {
+        if (!(ttproj[i] = GPJ_copy_transform(&tproj))) {
+            G_warning(_("Unable to copy coordinate transformation, "
+                        "using one thread"));
+            while (--i > 0)
+                GPJ_free_transform_copy(ttproj[i]);
+            nprocs = 1;
+            break;
+        }
+    }
+
     if (strcmp(interpol->answer, "nearest") == 0) {
         fdo = Rast_open_new(mapname, cell_type);
-        obuffer = (CELL *)Rast_allocate_output_buf(cell_type);
     }
     else {
         fdo = Rast_open_fp_new(mapname);
         cell_type = FCELL_TYPE;
-        obuffer = (FCELL *)Rast_allocate_output_buf(cell_type);
     }
 
     cell_size = Rast_cell_size(cell_type);
-
-    xcoord2 = outcellhd.west + (outcellhd.ew_res / 2);
-    ycoord2 = outcellhd.north - (outcellhd.ns_res / 2);
+    obuffer = G_malloc((size_t)BAND_ROWS * outcellhd.cols * cell_size);
+
+    proj.iproj = &iproj;
+    proj.oproj = &oproj;
+    proj.incellhd = &incellhd;
+    proj.outcellhd = &outcellhd;
+    proj.ibuffer = ibuffer;
+    proj.interpolate = interpolate;
+    proj.cell_type = cell_type;
+    proj.cell_size = cell_size;
+    proj.tolerance = atof(tolerance->answer);
+    if (proj.tolerance < 0)
+        proj.tolerance = 0;
 
     G_important_message(_("Projecting..."));
-    for (row = 0; row < outcellhd.rows; row++) {
-        /* obufptr = obuffer */;
-
-        G_percent(row, outcellhd.rows - 1, 2);
-
-#if 0
-        /* parallelization does not always work,
-         * segfaults in the interpolation functions
-         * can happen */
-#pragma omp parallel for schedule(static)
+    for (row = 0; row < outcellhd.rows; row += BAND_ROWS) {
+        int nrows = outcellhd.rows - row < BAND_ROWS ? outcellhd.rows - row
+                                                     : BAND_ROWS;
+        int ntilecols = (outcellhd.cols + TILE_COLS - 1) / TILE_COLS;
+        int ntiles = ((nrows + TILE_ROWS - 1) / TILE_ROWS) * ntilecols;
+
+        G_percent(row, outcellhd.rows, 2);
+
+        /* tiles of the band are projected in parallel, the input blocks
+         * are shared through the thread-safe block cache */
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic)
+        for (i = 0; i < ntiles; i++) {
+            int t = 0;
+            int r0 = (i / ntilecols) * TILE_ROWS;
+            int c0 = (i % ntilecols) * TILE_COLS;
+
+#if defined(_OPENMP)
+            t = omp_get_thread_num();
 #endif
-
-        for (col = 0; col < outcellhd.cols; col++) {
-            void *obufptr =
-                (void *)((const unsigned char *)obuffer + col * cell_size);
-
-            double xcoord1 = xcoord2 + (col)*outcellhd.ew_res;
-            double ycoord1 = ycoord2;
-
-            /* project coordinates in output matrix to       */
-            /* coordinates in input matrix                   */
-            if (GPJ_transform(&oproj, &iproj, &tproj, PJ_FWD, &xcoord1,
-                              &ycoord1, NULL) < 0) {
-                G_fatal_error(_("Error in %s"), "GPJ_transform()");
-                Rast_set_null_value(obufptr, 1, cell_type);
-            }
-            else {
-                /* convert to row/column indices of input matrix */
-
-                /* column index in input matrix */
-                double col_idx = (xcoord1 - incellhd.west) / incellhd.ew_res;
-
-                /* row index in input matrix    */
-                double row_idx = (incellhd.north - ycoord1) / incellhd.ns_res;
-
-                /* and resample data point               */
-                interpolate(ibuffer, obufptr, cell_type, col_idx, row_idx,
-                            &incellhd);
-            }
-
-            /* obufptr = G_incr_void_ptr(obufptr, cell_size); */
+            project_tile(&proj, ttproj[t],
+                         (unsigned char *)obuffer +
+                             ((size_t)r0 * outcellhd.cols + c0) * cell_size,
+                         row + r0,
+                         nrows - r0 < TILE_ROWS ? nrows - r0 : TILE_ROWS, c0,
+                         outcellhd.cols - c0 < TILE_COLS ? outcellhd.cols - c0
+                                                         : TILE_COLS);
         }
 
-        Rast_put_row(fdo, obuffer, cell_type);
-
-        xcoord2 = outcellhd.west + (outcellhd.ew_res / 2);
-        ycoord2 -= outcellhd.ns_res;
+        for (i = 0; i < nrows; i++)
+            Rast_put_row(fdo,
+                         (unsigned char *)obuffer +
+                             (size_t)i * outcellhd.cols * cell_size,
+                         cell_type);
     }
+    G_percent(1, 1, 1);
+
+    for (i = 1; i < nprocs; i++)
+        GPJ_free_transform_copy(ttproj[i]);
+    G_free(ttproj);
+    G_free(obuffer);
 
     Rast_close(fdo);
-    release_cache(ibuffer);
+    Rast_close_block_cache(ibuffer);
+    Rast_close(fdi);
 
     if (have_colors > 0) {
         Rast_write_colors(mapname, G_mapset(), &colr);
@@ -778,6 +840,98 @@ int main(int argc, char **argv)
     exit(EXIT_SUCCESS);
 }
 
+/* project points from output to input coordinates */
+static void transform(const struct projection *p, const struct pj_info *trans,
+                      double *x, double *y, int n)
+{
+    if (GPJ_transform_array(p->oproj, p->iproj, trans, PJ_FWD, x, y, NULL,
+                            n) < 0)
+        G_fatal_error(_("Error in %s"), "GPJ_transform_array()");
+}
+
+/* the points a and b of a row are projected, the points in between are
+ * interpolated linearly if the error at the middle point is within the
+ * tolerance, otherwise both halves are approximated the same way */
+static void approximate(const struct projection *p,
+                        const struct pj_info *trans, double *x, double *y,
+                        int a, int b)
+{
+    int i, m = (a + b) / 2;
+    double t;
+
+    if (b - a < 2)
+        return;
+
+    transform(p, trans, &x[m], &y[m], 1);
+
+    t = (double)(m - a) / (b - a);
+    if (x[a] != HUGE_VAL && x[b] != HUGE_VAL && x[m] != HUGE_VAL &&
+        fabs(x[a] + t * (x[b] - x[a]) - x[m]) <=
+            p->tolerance * p->incellhd->ew_res &&
+        fabs(y[a] + t * (y[b] - y[a]) - y[m]) <=
+            p->tolerance * p->incellhd->ns_res) {
+        for (i = a + 1; i < b; i++) {
+            if (i == m)
+                continue;
+            t = (double)(i - a) / (b - a);
+            x[i] = x[a] + t * (x[b] - x[a]);
+            y[i] = y[a] + t * (y[b] - y[a]);
+        }
+        return;
+    }
+
+    approximate(p, trans, x, y, a, m);
+    approximate(p, trans, x, y, m, b);
+}
+
+/* project and resample the cells of a tile of the output map, obuf is the
+ * first cell of the tile in a buffer of output rows */
+static void project_tile(const struct projection *p,
+                         const struct pj_info *trans, void *obuf, int row0,
+                         int nrows, int col0, int ncols)
+{
+    struct Cell_head *in = p->incellhd;
+    const struct Cell_head *out = p->outcellhd;
+    double x[TILE_COLS], y[TILE_COLS];
+    int row, col;
+
+    for (row = row0; row < row0 + nrows; row++) {
+        unsigned char *obufptr =
+            (unsigned char *)obuf +
+            (size_t)(row - row0) * out->cols * p->cell_size;
+
+        /* coordinates of the cell centers in the output map */
+        for (col = 0; col < ncols; col++) {
+            x[col] = out->west + (col0 + col + 0.5) * out->ew_res;
+            y[col] = out->north - (row + 0.5) * out->ns_res;
+        }
+
+        /* project coordinates in output matrix to
+         * coordinates in input matrix */
+        if (p->tolerance > 0 && ncols > 2) {
+            transform(p, trans, &x[0], &y[0], 1);
+            transform(p, trans, &x[ncols - 1], &y[ncols - 1], 1);
+            approximate(p, trans, x, y, 0, ncols - 1);
+        }
+        else
+            transform(p, trans, x, y, ncols);
+
+        for (col = 0; col < ncols; col++, obufptr += p->cell_size) {
+            /* the point can not be projected */
+            if (x[col] == HUGE_VAL || y[col] == HUGE_VAL) {
+                Rast_set_null_value(obufptr, 1, p->cell_type);
+                continue;
+            }
+
+            /* convert to row/column indices of input matrix and
+             * resample data point */
+            p->interpolate(p->ibuffer, obufptr, p->cell_type,
+                           (x[col] - in->west) / in->ew_res,
+                           (in->north - y[col]) / in->ns_res, in);
+        }
+    }
+}
+
 char *make_ipol_list(void)
 {
     int size = 0;
@@ -8,16 +8,16 @@
 #include <grass/raster.h>
 #include "r.proj.h"
 
-void p_nearest(struct cache *ibuffer,   /* input buffer                  */
-               void *obufptr,           /* ptr in output buffer          */
-               int cell_type,           /* raster map type of obufptr    */
-               double col_idx,          /* column index in input matrix  */
-               double row_idx,          /* row index in input matrix     */
-               struct Cell_head *cellhd /* cell header of input layer    */
+void p_nearest(struct R_block_cache *ibuffer, /* input buffer */
+               void *obufptr,                 /* ptr in output buffer */
+               int cell_type,                 /* raster map type of obufptr */
+               double col_idx,                /* column index in input matrix */
+               double row_idx,                /* row index in input matrix */
+               struct Cell_head *cellhd       /* cell header of input layer */
 )
 {
     int row, col; /* row/col of nearest neighbor   */
-    FCELL cell;
+    DCELL cell;
 
     /* cut indices to integer */
     row = (int)floor(row_idx);
@@ -29,12 +29,12 @@ void p_nearest(struct cache *ibuffer,   /* input buffer                  */
         return;
     }
 
-    cell = CVAL(ibuffer, row, col);
+    cell = Rast_get_block_cache_d_value(ibuffer, row, col);
 
-    if (Rast_is_f_null_value(&cell)) {
+    if (Rast_is_d_null_value(&cell)) {
         Rast_set_null_value(obufptr, 1, cell_type);
         return;
     }
 
-    Rast_set_f_value(obufptr, cell, cell_type);
+    Rast_set_d_value(obufptr, cell, cell_type);
 }
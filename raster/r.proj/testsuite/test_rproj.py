@@ -56,7 +56,7 @@ class TestRasterreport(TestCase):
         dbase = call_module("g.gisenv", get="GISDBASE")
         shutil.rmtree(f"{dbase}/{dst_project}")
 
-    def run_rproj_test(self, method, statics):
+    def run_rproj_test(self, method, statics, precision=1e-7, **kwargs):
         """The main function to run r.proj check rsults according to the method
 
         Parameters
@@ -65,6 +65,10 @@ class TestRasterreport(TestCase):
             The method to be used for r.proj
         statics : str
             The expected statics of the output raster
+        precision : float
+            The precision of the expected statics
+        kwargs : dict
+            Other options of r.proj
         """
         output = method
         # Get the boundary and set up region for the projected map
@@ -111,10 +115,12 @@ class TestRasterreport(TestCase):
             output=output,
             method=method,
             quiet=True,
+            overwrite=True,
+            **kwargs,
         )
 
         # Validate the output
-        self.assertRasterFitsUnivar(output, reference=statics, precision=1e-7)
+        self.assertRasterFitsUnivar(output, reference=statics, precision=precision)
         self.assertRasterFitsInfo(output, reference=raster_info, precision=1e-7)
 
     def test_nearest(self):
@@ -201,6 +207,29 @@ class TestRasterreport(TestCase):
 
         self.run_rproj_test(method, statics)
 
+    def test_bicubic_nprocs(self):
+        """Testing method bicubic with several threads"""
+        # Results must not depend on the number of threads
+        method = "bicubic"
+        statics = """n=40677
+        min=56.2407836914062
+        max=156.061599731445
+        mean=110.41701776258
+        variance=411.382636894393"""
+
+        self.run_rproj_test(method, statics, nprocs=4)
+
+    def test_bilinear_tolerance(self):
+        """Testing method bilinear with approximate transformation"""
+        # An error of 1/100 cell changes the values only slightly
+        method = "bilinear"
+        statics = """min=56.39
+        max=156.05
+        mean=110.389
+        variance=411.49"""
+
+        self.run_rproj_test(method, statics, precision=0.01, tolerance=0.01, nprocs=2)
+
     def test_list_output_plain(self):
         """Test plain output of available raster maps in input mapset ."""
         result = call_module(
@@ -0,0 +1,71 @@
+"""Benchmarking of in-process SQLite driver with v.db.select and v.to.db
+
+Each module is run with the driver started as a child process (default)
+and loaded into the module process (GRASS_DB_DRIVER_INPROCESS=1).
+"""
+
+import os
+from subprocess import DEVNULL
+
+from grass.pygrass.modules import Module
+
+import grass.benchmark as bm
+
+
+def main():
+    results = []
+
+    # Users can add more or modify existing reference maps
+    for npoints in (250_000, 500_000, 1_000_000):
+        benchmark(npoints, f"{int(npoints / 1e3)}k", results)
+
+    for result in results:
+        print(f"{result.label}: {result.time}s")
+
+
+def benchmark(npoints, label, results):
+    reference = "v_db_select_reference_map"
+
+    generate_map(npoints=npoints, fname=reference)
+
+    for mode in ("0", "1"):
+        env = os.environ.copy()
+        env["GRASS_DB_DRIVER_INPROCESS"] = mode
+        name = "inprocess" if mode == "1" else "pipe"
+
+        module = Module(
+            "v.db.select",
+            map=reference,
+            run_=False,
+            stdout_=DEVNULL,
+            env_=env,
+        )
+        results.append(
+            bm.benchmark_single(module, label=f"v.db.select_{name}_{label}", repeat=3)
+        )
+
+        module = Module(
+            "v.to.db",
+            map=reference,
+            option="coor",
+            columns=("x", "y"),
+            run_=False,
+            stdout_=DEVNULL,
+            env_=env,
+        )
+        results.append(
+            bm.benchmark_single(module, label=f"v.to.db_{name}_{label}", repeat=3)
+        )
+
+    Module("g.remove", quiet=True, flags="f", type="vector", name=reference)
+
+
+def generate_map(npoints, fname):
+    print("Generating reference map using v.random...")
+    Module("g.region", flags="p", rows=1000, cols=1000, res=1)
+    Module("v.random", output=fname, npoints=npoints, overwrite=True)
+    Module("v.db.addtable", map=fname, columns="x double precision, y double precision")
+
+
+if __name__ == "__main__":
+    main()
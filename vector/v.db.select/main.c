@@ -80,8 +80,9 @@ int main(int argc, char **argv)
     dbTable *table;
     dbColumn *column;
     dbValue *value;
+    dbBatch batch;
     struct field_info *Fi;
-    int ncols, col, more;
+    int ncols, col, row, more;
     bool first_rec;
     struct Map_info Map;
     char query[DB_SQL_MAX];
@@ -360,150 +361,160 @@ int main(int argc, char **argv)
     }
 
     /* fetch the data */
-    while (1) {
-        if (db_fetch(&cursor, DB_NEXT, &more) != DB_OK)
+    more = 1;
+    db_init_batch(&batch);
+    while (more) {
+        if (db_fetch_batch(&cursor, DB_FETCH_BATCH_SIZE, &batch, &more) !=
+            DB_OK)
             G_fatal_error(_("Unable to fetch data from table <%s>"), Fi->table);
 
-        if (!more)
-            break;
+        for (row = 0; row < batch.nrows; row++) {
+            if (first_rec)
+                first_rec = false;
+            else if (!flags.region->answer && format == JSON)
+                fprintf(stdout, ",\n");
 
-        if (first_rec)
-            first_rec = false;
-        else if (!flags.region->answer && format == JSON)
-            fprintf(stdout, ",\n");
+            cat = -1;
+            for (col = 0; col < ncols; col++) {
+                column = db_get_table_column(table, col);
+                value = db_get_batch_value(&batch, col, row);
 
-        cat = -1;
-        for (col = 0; col < ncols; col++) {
-            column = db_get_table_column(table, col);
-            value = db_get_column_value(column);
+                if (cat < 0 &&
+                    strcmp(Fi->key, db_get_column_name(column)) == 0) {
+                    cat = db_get_value_int(value);
+                    if (flags.region->answer)
+                        break;
+                }
 
-            if (cat < 0 && strcmp(Fi->key, db_get_column_name(column)) == 0) {
-                cat = db_get_value_int(value);
                 if (flags.region->answer)
-                    break;
-            }
-
-            if (flags.region->answer)
-                continue;
-
-            if (flags.features->answer) {
-                Vect_cidx_find_all(&Map, field_number, ~GV_AREA, cat,
-                                   list_lines);
-                /* if no features are found for this category, don't print
-                 * anything. */
-                if (list_lines->n_values == 0)
-                    break;
-            }
+                    continue;
+
+                if (flags.features->answer) {
+                    Vect_cidx_find_all(&Map, field_number, ~GV_AREA, cat,
+                                       list_lines);
+                    /* if no features are found for this category, don't print
+                     * anything. */
+                    if (list_lines->n_values == 0)
+                        break;
+                }
 
-            db_convert_column_value_to_string(column, &value_string);
+                db_convert_value_to_string(value, db_get_column_sqltype(column),
+                                           &value_string);
 
-            if (!flags.colnames->answer && format == VERTICAL)
-                fprintf(stdout, "%s%s", db_get_column_name(column), fsep);
+                if (!flags.colnames->answer && format == VERTICAL)
+                    fprintf(stdout, "%s%s", db_get_column_name(column), fsep);
 
-            if (col && format != JSON && format != VERTICAL)
-                fprintf(stdout, "%s", fsep);
+                if (col && format != JSON && format != VERTICAL)
+                    fprintf(stdout, "%s", fsep);
 
-            if (format == JSON) {
-                if (!col)
-                    fprintf(stdout, "{");
-                fprintf(stdout, "\"%s\":", db_get_column_name(column));
-            }
+                if (format == JSON) {
+                    if (!col)
+                        fprintf(stdout, "{");
+                    fprintf(stdout, "\"%s\":", db_get_column_name(column));
+                }
 
-            if (db_test_value_isnull(value)) {
-                if (format == JSON)
-                    fprintf(stdout, "null");
-                else if (options.nullval->answer)
-                    fprintf(stdout, "%s", options.nullval->answer);
-            }
-            else {
-                char *str = db_get_string(&value_string);
-
-                /* Escaped characters in different formats
-                 * JSON (mandatory): \" \\ \r \n \t \f \b
-                 * CSV (usually none, here optional): \\ \r \n \t \f \b
-                 * Plain, vertical (optional): v7: \\ \r \n, v8 also: \t \f \b
-                 */
-                if (flags.escape->answer || format == JSON) {
-                    if (strchr(str, '\\'))
-                        str = G_str_replace(str, "\\", "\\\\");
-                    if (strchr(str, '\r'))
-                        str = G_str_replace(str, "\r", "\\r");
-                    if (strchr(str, '\n'))
-                        str = G_str_replace(str, "\n", "\\n");
-                    if (strchr(str, '\t'))
-                        str = G_str_replace(str, "\t", "\\t");
-                    if (format == JSON && strchr(str, '"'))
-                        str = G_str_replace(str, "\"", "\\\"");
-                    if (strchr(str, '\f')) /* form feed, somewhat unlikely */
-                        str = G_str_replace(str, "\f", "\\f");
-                    if (strchr(str, '\b')) /* backspace, quite unlikely */
-                        str = G_str_replace(str, "\b", "\\b");
+                if (db_test_value_isnull(value)) {
+                    if (format == JSON)
+                        fprintf(stdout, "null");
+                    else if (options.nullval->answer)
+                        fprintf(stdout, "%s", options.nullval->answer);
                 }
-                /* Common CSV does not escape, but doubles quotes (and we quote
-                 * all text fields which takes care of a separator character in
-                 * text). */
-                if (format == CSV && strchr(str, '"')) {
-                    str = G_str_replace(str, "\"", "\"\"");
+                else {
+                    char *str = db_get_string(&value_string);
+
+                    /* Escaped characters in different formats
+                     * JSON (mandatory): \" \\ \r \n \t \f \b
+                     * CSV (usually none, here optional): \\ \r \n \t \f \b
+                     * Plain, vertical (optional): v7: \\ \r \n, v8 also: \t
+                     * \f \b
+                     */
+                    if (flags.escape->answer || format == JSON) {
+                        if (strchr(str, '\\'))
+                            str = G_str_replace(str, "\\", "\\\\");
+                        if (strchr(str, '\r'))
+                            str = G_str_replace(str, "\r", "\\r");
+                        if (strchr(str, '\n'))
+                            str = G_str_replace(str, "\n", "\\n");
+                        if (strchr(str, '\t'))
+                            str = G_str_replace(str, "\t", "\\t");
+                        if (format == JSON && strchr(str, '"'))
+                            str = G_str_replace(str, "\"", "\\\"");
+                        /* form feed, somewhat unlikely */
+                        if (strchr(str, '\f'))
+                            str = G_str_replace(str, "\f", "\\f");
+                        /* backspace, quite unlikely */
+                        if (strchr(str, '\b'))
+                            str = G_str_replace(str, "\b", "\\b");
+                    }
+                    /* Common CSV does not escape, but doubles quotes (and we
+                     * quote all text fields which takes care of a separator
+                     * character in text). */
+                    if (format == CSV && strchr(str, '"')) {
+                        str = G_str_replace(str, "\"", "\"\"");
+                    }
+
+                    if (format == JSON || format == CSV) {
+                        int type =
+                            db_sqltype_to_Ctype(db_get_column_sqltype(column));
+
+                        /* Don't quote numbers, quote text and datetime. */
+                        if (type == DB_C_TYPE_INT || type == DB_C_TYPE_DOUBLE)
+                            fprintf(stdout, "%s", str);
+                        else
+                            fprintf(stdout, "\"%s\"", str);
+                    }
+                    else
+                        fprintf(stdout, "%s", str);
                 }
 
-                if (format == JSON || format == CSV) {
-                    int type =
-                        db_sqltype_to_Ctype(db_get_column_sqltype(column));
-
-                    /* Don't quote numbers, quote text and datetime. */
-                    if (type == DB_C_TYPE_INT || type == DB_C_TYPE_DOUBLE)
-                        fprintf(stdout, "%s", str);
+                if (format == VERTICAL)
+                    fprintf(stdout, "\n");
+                else if (format == JSON) {
+                    if (col < ncols - 1)
+                        fprintf(stdout, ",");
                     else
-                        fprintf(stdout, "\"%s\"", str);
+                        fprintf(stdout, "}");
                 }
-                else
-                    fprintf(stdout, "%s", str);
             }
 
-            if (format == VERTICAL)
-                fprintf(stdout, "\n");
-            else if (format == JSON) {
-                if (col < ncols - 1)
-                    fprintf(stdout, ",");
-                else
-                    fprintf(stdout, "}");
-            }
-        }
+            if (flags.features->answer && col < ncols)
+                continue;
 
-        if (flags.features->answer && col < ncols)
-            continue;
-
-        if (flags.region->answer) {
-            /* get minimal region extent */
-            Vect_cidx_find_all(&Map, field_number, ~GV_AREA, cat, list_lines);
-            for (i = 0; i < list_lines->n_values; i++) {
-                line = list_lines->value[i];
-                if (Vect_get_line_type(&Map, line) == GV_CENTROID) {
-                    area = Vect_get_centroid_area(&Map, line);
-                    if (area > 0 && !Vect_get_area_box(&Map, area, line_box))
+            if (flags.region->answer) {
+                /* get minimal region extent */
+                Vect_cidx_find_all(&Map, field_number, ~GV_AREA, cat,
+                                   list_lines);
+                for (i = 0; i < list_lines->n_values; i++) {
+                    line = list_lines->value[i];
+                    if (Vect_get_line_type(&Map, line) == GV_CENTROID) {
+                        area = Vect_get_centroid_area(&Map, line);
+                        if (area > 0 &&
+                            !Vect_get_area_box(&Map, area, line_box))
+                            G_fatal_error(
+                                _("Unable to get bounding box of area %d"),
+                                area);
+                    }
+                    else if (!Vect_get_line_box(&Map, line, line_box))
                         G_fatal_error(
-                            _("Unable to get bounding box of area %d"), area);
-                }
-                else if (!Vect_get_line_box(&Map, line, line_box))
-                    G_fatal_error(_("Unable to get bounding box of line %d"),
-                                  line);
-                if (init_box) {
-                    Vect_box_copy(min_box, line_box);
-                    init_box = false;
+                            _("Unable to get bounding box of line %d"), line);
+                    if (init_box) {
+                        Vect_box_copy(min_box, line_box);
+                        init_box = false;
+                    }
+                    else
+                        Vect_box_extend(min_box, line_box);
                 }
-                else
-                    Vect_box_extend(min_box, line_box);
             }
-        }
-        else {
-            /* End of record in attribute printing */
-            if (format != JSON && format != VERTICAL)
-                fprintf(stdout, "\n");
-            else if (vsep) {
-                if (vsep_needs_newline)
-                    fprintf(stdout, "%s\n", vsep);
-                else
-                    fprintf(stdout, "%s", vsep);
+            else {
+                /* End of record in attribute printing */
+                if (format != JSON && format != VERTICAL)
+                    fprintf(stdout, "\n");
+                else if (vsep) {
+                    if (vsep_needs_newline)
+                        fprintf(stdout, "%s\n", vsep);
+                    else
+                        fprintf(stdout, "%s", vsep);
+                }
             }
         }
     }
@@ -555,6 +566,7 @@ int main(int argc, char **argv)
         Vect_destroy_list(list_lines);
     }
 
+    db_free_batch(&batch);
     db_close_cursor(&cursor);
     db_close_database_shutdown_driver(driver);
     Vect_close(&Map);
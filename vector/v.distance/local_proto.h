@@ -68,4 +68,11 @@ int line2area(struct Map_info *To, struct line_pnts *Points, int type, int area,
 int print_upload(NEAR *, UPLOAD *, int, dbCatValArray *, dbCatVal *, char *,
                  enum OutputFormat, JSON_Object *);
 
+/* upload.c */
+int prepare_upload(dbDriver *, const char *, const char *, UPLOAD *, int, int,
+                   int, dbBulk *);
+int insert_upload(dbBulk *, int, int, NEAR *, UPLOAD *, dbCatValArray *,
+                  dbCatVal *);
+int update_upload(dbBulk *, NEAR *, UPLOAD *, dbCatValArray *, dbCatVal *);
+
 #endif
@@ -103,7 +103,7 @@ int main(int argc, char *argv[])
     double tmp_tx, tmp_ty, tmp_tz, tmp_talong, tmp_tangle;
     int geodesic;
     struct field_info *Fi, *toFi;
-    dbString stmt, dbstr;
+    dbString stmt;
     dbDriver *driver, *to_driver;
     int *catexist, ncatexist, *cex;
     char buf1[2000], buf2[2000], to_attr_sqltype[256];
@@ -112,6 +112,7 @@ int main(int argc, char *argv[])
     struct boxlist *lList, *aList;
     struct bound_box fbox, box;
     dbCatValArray cvarr;
+    dbBulk bulk;
     dbColumn *column;
     char *sep;
     enum OutputFormat format;
@@ -538,7 +539,6 @@ int main(int argc, char *argv[])
 
     /* Open database driver */
     db_init_string(&stmt);
-    db_init_string(&dbstr);
     driver = NULL;
     Fi = NULL;
     column = NULL;
@@ -1491,6 +1491,14 @@ int main(int argc, char *argv[])
     if (driver)
         db_begin_transaction(driver);
 
+    /* statement executed for each record */
+    if ((update_table || create_table) &&
+        prepare_upload(driver, create_table ? opt.table->answer : Fi->table,
+                       update_table ? Fi->key : NULL, Upload,
+                       opt.to_column->answer ? cvarr.ctype : DB_C_TYPE_INT,
+                       create_table, Outp != NULL, &bulk) != DB_OK)
+        G_fatal_error(_("Unable to prepare statement"));
+
     if (!print) /* no printing */
         G_message("Update vector attributes...");
 
@@ -1579,94 +1587,10 @@ int main(int argc, char *argv[])
             if (Near[i].count == 0) /* no nearest found */
                 continue;
 
-            if (!Outp)
-                snprintf(buf1, sizeof(buf1), "insert into %s values ( %d ",
-                         opt.table->answer, Near[i].from_cat);
-            else
-                snprintf(buf1, sizeof(buf1), "insert into %s values ( %d, %d ",
-                         opt.table->answer, i, Near[i].from_cat);
-
-            db_set_string(&stmt, buf1);
-
-            j = 0;
-            while (Upload[j].upload != END) {
-                db_append_string(&stmt, ",");
-
-                switch (Upload[j].upload) {
-                case CAT:
-                    snprintf(buf2, sizeof(buf2), " %d", Near[i].to_cat);
-                    break;
-                case DIST:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].dist);
-                    break;
-                case FROM_X:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].from_x);
-                    break;
-                case FROM_Y:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].from_y);
-                    break;
-                case TO_X:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_x);
-                    break;
-                case TO_Y:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_y);
-                    break;
-                case FROM_ALONG:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].from_along);
-                    break;
-                case TO_ALONG:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_along);
-                    break;
-                case TO_ANGLE:
-                    snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_angle);
-                    break;
-                case TO_ATTR:
-                    if (catval) {
-                        switch (cvarr.ctype) {
-                        case DB_C_TYPE_INT:
-                            snprintf(buf2, sizeof(buf2), " %d", catval->val.i);
-                            break;
-
-                        case DB_C_TYPE_DOUBLE:
-                            snprintf(buf2, sizeof(buf2), " %.17g",
-                                     catval->val.d);
-                            break;
-
-                        case DB_C_TYPE_STRING:
-                            db_set_string(&dbstr, db_get_string(catval->val.s));
-                            db_double_quote_string(&dbstr);
-                            snprintf(buf2, sizeof(buf2), " '%s'",
-                                     db_get_string(&dbstr));
-                            break;
-
-                        case DB_C_TYPE_DATETIME:
-                            /* TODO: formatting datetime */
-                            snprintf(buf2, sizeof(buf2), " null");
-                            break;
-                        }
-                    }
-                    else {
-                        snprintf(buf2, sizeof(buf2), " null");
-                    }
-                    break;
-                default:
-                    break;
-                }
-                db_append_string(&stmt, buf2);
-                j++;
-            }
-            db_append_string(&stmt, " )");
-            G_debug(3, "SQL: %s", db_get_string(&stmt));
-            if (db_execute_immediate(driver, &stmt) == DB_OK) {
-                update_ok++;
-            }
-            else {
-                update_err++;
-            }
+            insert_upload(&bulk, i, Outp != NULL, &Near[i], Upload, &cvarr,
+                          catval);
         }
         else if (update_table) { /* update table */
-            int do_update = 0;
-
             /* check if exists in table */
             cex = (int *)bsearch((void *)&(Near[i].from_cat), catexist,
                                  ncatexist, sizeof(int), cmp_exist);
@@ -1676,110 +1600,18 @@ int main(int argc, char *argv[])
             }
             update_exist++;
 
-            snprintf(buf1, sizeof(buf1), "update %s set", Fi->table);
-            db_set_string(&stmt, buf1);
-
-            j = 0;
-            while (Upload[j].upload != END) {
-                if (j > 0)
-                    db_append_string(&stmt, ",");
-
-                snprintf(buf2, sizeof(buf2), " %s =", Upload[j].column);
-                db_append_string(&stmt, buf2);
-
-                if (Near[i].count == 0) { /* no nearest found */
-                    /* really clear existing records if no nearest found ? */
-                    db_append_string(&stmt, " null");
-                }
-                else {
-                    do_update = 1;
-                    switch (Upload[j].upload) {
-                    case CAT:
-                        if (Near[i].to_cat > 0)
-                            snprintf(buf2, sizeof(buf2), " %d", Near[i].to_cat);
-                        else
-                            snprintf(buf2, sizeof(buf2), " null");
-                        break;
-                    case DIST:
-                        snprintf(buf2, sizeof(buf2), " %.17g", Near[i].dist);
-                        break;
-                    case FROM_X:
-                        snprintf(buf2, sizeof(buf2), " %.17g", Near[i].from_x);
-                        break;
-                    case FROM_Y:
-                        snprintf(buf2, sizeof(buf2), " %.17g", Near[i].from_y);
-                        break;
-                    case TO_X:
-                        snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_x);
-                        break;
-                    case TO_Y:
-                        snprintf(buf2, sizeof(buf2), " %.17g", Near[i].to_y);
-                        break;
-                    case FROM_ALONG:
-                        snprintf(buf2, sizeof(buf2), " %.17g",
-                                 Near[i].from_along);
-                        break;
-                    case TO_ALONG:
-                        snprintf(buf2, sizeof(buf2), " %.17g",
-                                 Near[i].to_along);
-                        break;
-                    case TO_ANGLE:
-                        snprintf(buf2, sizeof(buf2), " %.17g",
-                                 Near[i].to_angle);
-                        break;
-                    case TO_ATTR:
-                        if (catval) {
-                            switch (cvarr.ctype) {
-                            case DB_C_TYPE_INT:
-                                snprintf(buf2, sizeof(buf2), " %d",
-                                         catval->val.i);
-                                break;
-
-                            case DB_C_TYPE_DOUBLE:
-                                snprintf(buf2, sizeof(buf2), " %.17g",
-                                         catval->val.d);
-                                break;
-
-                            case DB_C_TYPE_STRING:
-                                db_set_string(&dbstr,
-                                              db_get_string(catval->val.s));
-                                db_double_quote_string(&dbstr);
-                                snprintf(buf2, sizeof(buf2), " '%s'",
-                                         db_get_string(&dbstr));
-                                break;
-
-                            case DB_C_TYPE_DATETIME:
-                                /* TODO: formatting datetime */
-                                snprintf(buf2, sizeof(buf2), " null");
-                                break;
-                            }
-                        }
-                        else {
-                            snprintf(buf2, sizeof(buf2), " null");
-                        }
-                        break;
-                    default:
-                        break;
-                    }
-                    db_append_string(&stmt, buf2);
-                }
-                j++;
-            }
-            if (do_update) {
-                snprintf(buf2, sizeof(buf2), " where %s = %d", Fi->key,
-                         Near[i].from_cat);
-                db_append_string(&stmt, buf2);
-                G_debug(2, "SQL: %s", db_get_string(&stmt));
-                if (db_execute_immediate(driver, &stmt) == DB_OK) {
-                    update_ok++;
-                }
-                else {
-                    update_err++;
-                }
-            }
+            /* existing records are not cleared if no nearest found */
+            if (Near[i].count > 0)
+                update_upload(&bulk, &Near[i], Upload, &cvarr, catval);
         }
     }
 
+    if (update_table || create_table) {
+        db_close_bulk(&bulk);
+        update_ok = bulk.n_ok;
+        update_err = bulk.n_failed;
+    }
+
     if (format == JSON) {
         char *serialized_string = json_serialize_to_string_pretty(root_value);
         if (serialized_string == NULL) {
@@ -0,0 +1,172 @@
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* C type of statement parameter for upload value */
+static int upload_ctype(enum Code upload, int attr_ctype)
+{
+    switch (upload) {
+    case CAT:
+        return DB_C_TYPE_INT;
+    case TO_ATTR:
+        if (attr_ctype == DB_C_TYPE_INT || attr_ctype == DB_C_TYPE_DOUBLE)
+            return attr_ctype;
+        return DB_C_TYPE_STRING;
+    default:
+        return DB_C_TYPE_DOUBLE;
+    }
+}
+
+/*
+   prepare statement inserting a record into new table (insert != 0) or
+   updating upload columns of existing record, values are set by
+   set_upload()
+ */
+int prepare_upload(dbDriver *driver, const char *table, const char *key,
+                   UPLOAD *Upload, int attr_ctype, int insert, int with_cat,
+                   dbBulk *bulk)
+{
+    int j, n, ret;
+    int *ctype;
+    dbString stmt;
+
+    db_init_string(&stmt);
+
+    for (j = 0; Upload[j].upload != END; j++)
+        ;
+    ctype = (int *)G_malloc((j + 2) * sizeof(int));
+    n = 0;
+
+    if (insert) {
+        db_set_string(&stmt, "insert into ");
+        db_append_string(&stmt, table);
+        db_append_string(&stmt, " values ( ?");
+        if (with_cat) {
+            db_append_string(&stmt, ", ?");
+            ctype[n++] = DB_C_TYPE_INT;
+        }
+        ctype[n++] = DB_C_TYPE_INT;
+        for (j = 0; Upload[j].upload != END; j++) {
+            db_append_string(&stmt, ", ?");
+            ctype[n++] = upload_ctype(Upload[j].upload, attr_ctype);
+        }
+        db_append_string(&stmt, " )");
+    }
+    else {
+        db_set_string(&stmt, "update ");
+        db_append_string(&stmt, table);
+        db_append_string(&stmt, " set");
+        for (j = 0; Upload[j].upload != END; j++) {
+            if (j > 0)
+                db_append_string(&stmt, ",");
+            db_append_string(&stmt, " ");
+            db_append_string(&stmt, Upload[j].column);
+            db_append_string(&stmt, " = ?");
+            ctype[n++] = upload_ctype(Upload[j].upload, attr_ctype);
+        }
+        db_append_string(&stmt, " where ");
+        db_append_string(&stmt, key);
+        db_append_string(&stmt, " = ?");
+        ctype[n++] = DB_C_TYPE_INT;
+    }
+    G_debug(3, "SQL: %s", db_get_string(&stmt));
+
+    ret = db_prepare_bulk(driver, &stmt, n, ctype, bulk);
+    if (ret != DB_OK)
+        G_warning(_("Unable to prepare statement: %s"), db_get_string(&stmt));
+
+    db_free_string(&stmt);
+    G_free(ctype);
+
+    return ret;
+}
+
+/*
+   set values of upload columns of i-th record for statement prepared by
+   prepare_upload(), the first parameter is n
+ */
+static void set_values(dbBulk *bulk, int n, NEAR *Near, UPLOAD *Upload,
+                       dbCatValArray *cvarr, dbCatVal *catval, int insert)
+{
+    int j;
+    dbValue *value;
+
+    for (j = 0; Upload[j].upload != END; j++, n++) {
+        value = db_get_bulk_param(bulk, n);
+
+        switch (Upload[j].upload) {
+        case CAT:
+            if (insert || Near->to_cat > 0)
+                db_set_value_int(value, Near->to_cat);
+            else
+                db_set_value_null(value);
+            break;
+        case DIST:
+            db_set_value_double(value, Near->dist);
+            break;
+        case FROM_X:
+            db_set_value_double(value, Near->from_x);
+            break;
+        case FROM_Y:
+            db_set_value_double(value, Near->from_y);
+            break;
+        case TO_X:
+            db_set_value_double(value, Near->to_x);
+            break;
+        case TO_Y:
+            db_set_value_double(value, Near->to_y);
+            break;
+        case FROM_ALONG:
+            db_set_value_double(value, Near->from_along);
+            break;
+        case TO_ALONG:
+            db_set_value_double(value, Near->to_along);
+            break;
+        case TO_ANGLE:
+            db_set_value_double(value, Near->to_angle);
+            break;
+        case TO_ATTR:
+            if (catval && cvarr->ctype == DB_C_TYPE_INT)
+                db_set_value_int(value, catval->val.i);
+            else if (catval && cvarr->ctype == DB_C_TYPE_DOUBLE)
+                db_set_value_double(value, catval->val.d);
+            else if (catval && cvarr->ctype == DB_C_TYPE_STRING)
+                db_set_value_string(value, db_get_string(catval->val.s));
+            else
+                /* TODO: formatting datetime */
+                db_set_value_null(value);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* add record inserted into new table, cat is used if with_cat != 0 */
+int insert_upload(dbBulk *bulk, int cat, int with_cat, NEAR *Near,
+                  UPLOAD *Upload, dbCatValArray *cvarr, dbCatVal *catval)
+{
+    int n;
+
+    n = 0;
+    if (with_cat)
+        db_set_value_int(db_get_bulk_param(bulk, n++), cat);
+    db_set_value_int(db_get_bulk_param(bulk, n++), Near->from_cat);
+    set_values(bulk, n, Near, Upload, cvarr, catval, 1);
+
+    return db_add_bulk_row(bulk);
+}
+
+/* add update of existing record */
+int update_upload(dbBulk *bulk, NEAR *Near, UPLOAD *Upload,
+                  dbCatValArray *cvarr, dbCatVal *catval)
+{
+    int n;
+
+    for (n = 0; Upload[n].upload != END; n++)
+        ;
+    set_values(bulk, 0, Near, Upload, cvarr, catval, 0);
+    db_set_value_int(db_get_bulk_param(bulk, n), Near->from_cat);
+
+    return db_add_bulk_row(bulk);
+}
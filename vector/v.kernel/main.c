@@ -7,7 +7,7 @@
  * PURPOSE:      Generates a raster density map from vector points data using
  *               a moving kernel function or optionally generates a vector
  *               density map on vector network with a 1D kernel
- * COPYRIGHT:    (C) 2004-2011 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2004-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with
@@ -73,19 +73,15 @@ int main(int argc, char **argv)
 {
     struct Option *in_opt, *net_opt, *out_opt, *net_out_opt;
     struct Option *radius_opt, *dsize_opt, *segmax_opt, *netmax_opt,
-        *multip_opt, *node_opt, *kernel_opt;
+        *multip_opt, *node_opt, *kernel_opt, *nprocs_opt;
     struct Flag *flag_o, *flag_q, *flag_normalize, *flag_multiply;
     char *desc;
 
     struct Map_info In, Net, Out;
-    int fdout = -1, maskfd = -1;
-    int node_method, kernel_function;
-    int row, col;
+    int fdout = -1;
+    int node_method, kernel_function, nprocs;
     struct Cell_head window;
     double gaussian;
-    double N, E;
-    CELL *mask = NULL;
-    DCELL *output_cell = NULL;
     double sigma, dmax, segmax, netmax, multip;
     char *tmpstr1, *tmpstr2;
     struct History history;
@@ -108,6 +104,7 @@ int main(int argc, char **argv)
     G_add_keyword(_("point density"));
     G_add_keyword(_("heatmap"));
     G_add_keyword(_("hotspot"));
+    G_add_keyword(_("parallel"));
     module->label = _("Generates a raster density map from vector points map.");
     module->description =
         _("Density is computed using a moving kernel. "
@@ -150,7 +147,10 @@ int main(int argc, char **argv)
     dsize_opt->key = "dsize";
     dsize_opt->type = TYPE_DOUBLE;
     dsize_opt->required = NO;
-    dsize_opt->description = _("Discretization error in map units");
+    dsize_opt->label = _("Discretization error in map units");
+    dsize_opt->description =
+        _("If at least half of the cell diagonal, points may be moved to "
+          "cell centers to compute the density by FFT");
     dsize_opt->answer = "0.";
 
     segmax_opt = G_define_option();
@@ -199,6 +199,8 @@ int main(int argc, char **argv)
         "uniform,triangular,epanechnikov,quartic,triweight,gaussian,cosine";
     kernel_opt->answer = "gaussian";
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     flag_o = G_define_flag();
     flag_o->key = 'o';
     flag_o->description = _("Try to calculate an optimal radius with given "
@@ -231,6 +233,8 @@ int main(int argc, char **argv)
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     if (net_opt->answer && out_opt->answer) {
         G_warning(
             _("Use option net_output if you compute network density. "
@@ -369,15 +373,6 @@ int main(int argc, char **argv)
         /* check and open the name of output map */
         if (!flag_q->answer) {
             fdout = Rast_open_new(out_opt->answer, DCELL_TYPE);
-
-            /* open mask file */
-            if ((maskfd = Rast_maskfd()) >= 0)
-                mask = Rast_allocate_c_buf();
-            else
-                mask = NULL;
-
-            /* allocate output raster */
-            output_cell = Rast_allocate_buf(DCELL_TYPE);
         }
     }
 
@@ -565,60 +560,13 @@ int main(int argc, char **argv)
         Vect_close(&Out);
     }
     else {
-        /* spatial index handling, borrowed from lib/vector/Vlib/find.c */
-        struct bound_box box;
-        struct boxlist *NList = Vect_new_boxlist(1);
-
         G_verbose_message(
             _("Writing output raster map using smooth parameter %f"), sigma);
         G_verbose_message(_("Normalising factor %f"),
                           1. / gaussianFunction(sigma / 4., sigma, dimension));
 
-        for (row = 0; row < window.rows; row++) {
-            G_percent(row, window.rows, 2);
-            if (mask)
-                Rast_get_c_row(maskfd, mask, row);
-
-            for (col = 0; col < window.cols; col++) {
-                /* don't interpolate outside of the mask */
-                if (mask && Rast_is_c_null_value(&mask[col])) {
-                    Rast_set_d_null_value(&output_cell[col], 1);
-                    continue;
-                }
-
-                N = Rast_row_to_northing(row + 0.5, &window);
-                E = Rast_col_to_easting(col + 0.5, &window);
-
-                if ((col & 31) == 0) {
-
-                    /* create bounding box 32x2*dmax size from the current cell
-                     * center */
-                    box.N = N + dmax;
-                    box.S = N - dmax;
-                    box.E = E + dmax + 32 * window.ew_res;
-                    box.W = E - dmax;
-                    box.T = HUGE_VAL;
-                    box.B = -HUGE_VAL;
-
-                    Vect_select_lines_by_box(&In, &box, GV_POINT, NList);
-                }
-                box.N = N + dmax;
-                box.S = N - dmax;
-                box.E = E + dmax;
-                box.W = E - dmax;
-                box.T = HUGE_VAL;
-                box.B = -HUGE_VAL;
-                /* compute_distance(N, E, &In, sigma, term, &gaussian, dmax); */
-                compute_distance(N, E, sigma, term, &gaussian, dmax, &box,
-                                 NList);
-
-                output_cell[col] = multip * gaussian;
-                if (gaussian > gausmax)
-                    gausmax = gaussian;
-            }
-            Rast_put_row(fdout, output_cell, DCELL_TYPE);
-        }
-        G_percent(1, 1, 1);
+        gausmax = density_raster(&In, &window, fdout, sigma, term, dmax,
+                                 multip, dsize, nprocs);
 
         Rast_close(fdout);
 
@@ -886,35 +834,3 @@ void compute_net_distance(double x, double y, struct Map_info *In,
         G_debug(3, "  dist = %f gaussian = %f", dist, *gaussian);
     }
 }
-
-void compute_distance(double N, double E, double sigma, double term,
-                      double *gaussian, double dmax, struct bound_box *box,
-                      struct boxlist *NList)
-{
-    int line, nlines;
-    double a[2], b[2];
-    double dist;
-
-    a[0] = E;
-    a[1] = N;
-
-    /* number of lines within dmax box  */
-    nlines = NList->n_values;
-
-    *gaussian = .0;
-
-    for (line = 0; line < nlines; line++) {
-
-        b[0] = NList->box[line].E;
-        b[1] = NList->box[line].N;
-
-        if (b[0] <= box->E && b[0] >= box->W && b[1] <= box->N &&
-            b[1] >= box->S) {
-            dist = euclidean_distance(a, b, 2);
-
-            if (dist <= dmax)
-                /* *gaussian += gaussianKernel(dist / sigma, term); */
-                *gaussian += kernelFunction(term, sigma, dist);
-        }
-    }
-}
@@ -0,0 +1,298 @@
+#include <grass/config.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/vector.h>
+#include <grass/gmath.h>
+#include <grass/kdtree.h>
+#include <grass/glocale.h>
+#include "global.h"
+
+#if defined(HAVE_FFTW3_H) || defined(HAVE_FFTW_H) || defined(HAVE_DFFTW_H)
+#define HAVE_FFT
+#endif
+
+/* rows of one block evaluated by one thread */
+#define BLOCK_ROWS    16
+/* kernel radius in cells from which convolution by FFT is used */
+#define FFT_MIN_CELLS 8
+
+/* points within the radius of the region */
+static int select_points(struct Map_info *In, const struct Cell_head *window,
+                         double dmax, struct boxlist *List)
+{
+    struct bound_box box;
+
+    box.N = window->north + dmax;
+    box.S = window->south - dmax;
+    box.E = window->east + dmax;
+    box.W = window->west - dmax;
+    box.T = HUGE_VAL;
+    box.B = -HUGE_VAL;
+
+    return Vect_select_lines_by_box(In, &box, GV_POINT, List);
+}
+
+/* sum of kernel values of the points within dmax of c */
+static double kernel_sum(const struct kdflat *tree, const double *c,
+                         double sigma, double term, double dmax,
+                         struct kdscratch *s)
+{
+    int i, n;
+    double sum = 0.;
+
+    n = kdflat_dnn(tree, c, dmax, NULL, s);
+    for (i = 0; i < n; i++)
+        sum += kernelFunction(term, sigma, sqrt(s->d[i]));
+
+    return sum;
+}
+
+/* kernel density from the points found by a k-d tree, blocks of rows are
+ * evaluated in parallel */
+static double density_kdtree(const struct boxlist *List,
+                             const struct Cell_head *window, int fdout,
+                             double sigma, double term, double dmax,
+                             double multip, int nprocs)
+{
+    int i, row, row0, nblocks, maskfd;
+    size_t block_size;
+    double *c, gausmax = 0.;
+    struct kdflat *tree;
+    struct kdscratch *scratch;
+    CELL *mask = NULL;
+    DCELL *out;
+
+    c = G_malloc((List->n_values ? List->n_values : 1) * 2 * sizeof(double));
+    for (i = 0; i < List->n_values; i++) {
+        c[2 * i] = List->box[i].E;
+        c[2 * i + 1] = List->box[i].N;
+    }
+    tree = kdflat_build(2, c, NULL, List->n_values, nprocs);
+    G_free(c);
+
+    nblocks = 4 * nprocs;
+    block_size = (size_t)BLOCK_ROWS * window->cols;
+    out = G_malloc(nblocks * block_size * sizeof(DCELL));
+    if ((maskfd = Rast_maskfd()) >= 0)
+        mask = G_malloc(nblocks * block_size * sizeof(CELL));
+    scratch = G_malloc(nblocks * sizeof(struct kdscratch));
+    for (i = 0; i < nblocks; i++)
+        kdscratch_init(&scratch[i]);
+
+    for (row0 = 0; row0 < window->rows; row0 += nblocks * BLOCK_ROWS) {
+        int n = (window->rows - row0 + BLOCK_ROWS - 1) / BLOCK_ROWS;
+
+        if (n > nblocks)
+            n = nblocks;
+
+        G_percent(row0, window->rows, 2);
+
+        /* reading rows is not thread-safe */
+        if (mask) {
+            for (row = row0;
+                 row < row0 + n * BLOCK_ROWS && row < window->rows; row++)
+                Rast_get_c_row(maskfd,
+                               mask + (size_t)(row - row0) * window->cols,
+                               row);
+        }
+
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic) private(row) reduction(max : gausmax)
+        for (i = 0; i < n; i++) {
+            int r, col;
+            double p[2], gaussian;
+
+            for (r = 0; r < BLOCK_ROWS; r++) {
+                size_t offset = (size_t)(i * BLOCK_ROWS + r) * window->cols;
+
+                row = row0 + i * BLOCK_ROWS + r;
+                if (row >= window->rows)
+                    break;
+                p[1] = Rast_row_to_northing(row + 0.5, window);
+
+                for (col = 0; col < window->cols; col++) {
+                    /* don't interpolate outside of the mask */
+                    if (mask && Rast_is_c_null_value(&mask[offset + col])) {
+                        Rast_set_d_null_value(&out[offset + col], 1);
+                        continue;
+                    }
+                    p[0] = Rast_col_to_easting(col + 0.5, window);
+                    gaussian =
+                        kernel_sum(tree, p, sigma, term, dmax, &scratch[i]);
+                    out[offset + col] = multip * gaussian;
+                    if (gaussian > gausmax)
+                        gausmax = gaussian;
+                }
+            }
+        }
+
+        for (row = row0; row < row0 + n * BLOCK_ROWS && row < window->rows;
+             row++)
+            Rast_put_d_row(fdout, out + (size_t)(row - row0) * window->cols);
+    }
+    G_percent(1, 1, 1);
+
+    G_free(out);
+    G_free(mask);
+    for (i = 0; i < nblocks; i++)
+        kdscratch_free(&scratch[i]);
+    G_free(scratch);
+    kdflat_destroy(tree);
+
+    return gausmax;
+}
+
+#ifdef HAVE_FFT
+/* kernel density by convolution of the point counts of the cells with the
+ * kernel, points are moved to the centers of their cells */
+static double density_fft(const struct boxlist *List,
+                          const struct Cell_head *window, int fdout,
+                          double sigma, double term, double dmax,
+                          double multip)
+{
+    int i, row, col, rr, rc, prows, pcols, maskfd, dr, dc;
+    size_t NN;
+    double (*data)[2], (*kern)[2], re, im, scale, kmax, eps, gaussian;
+    double gausmax = 0.;
+    CELL *mask = NULL;
+    DCELL *out;
+
+    /* grid padded by the kernel radius, the density in the region is then
+     * not affected by the wrap around of the circular convolution */
+    rr = (int)ceil(dmax / window->ns_res);
+    rc = (int)ceil(dmax / window->ew_res);
+    prows = window->rows + 2 * rr;
+    pcols = window->cols + 2 * rc;
+    NN = (size_t)prows * pcols;
+
+    G_verbose_message(_("Convolution by FFT on %d x %d cells"), prows, pcols);
+
+    data = G_calloc(NN, sizeof(*data));
+    kern = G_calloc(NN, sizeof(*kern));
+
+    for (i = 0; i < List->n_values; i++) {
+        row = (int)floor((window->north - List->box[i].N) / window->ns_res) +
+              rr;
+        col = (int)floor((List->box[i].E - window->west) / window->ew_res) +
+              rc;
+        if (row < 0 || row >= prows || col < 0 || col >= pcols)
+            continue;
+        data[(size_t)row * pcols + col][0] += 1.;
+    }
+
+    kmax = 0.;
+    for (dr = -rr; dr <= rr; dr++) {
+        for (dc = -rc; dc <= rc; dc++) {
+            double dist = hypot(dr * window->ns_res, dc * window->ew_res);
+
+            if (dist > dmax)
+                continue;
+            row = (dr + prows) % prows;
+            col = (dc + pcols) % pcols;
+            kern[(size_t)row * pcols + col][0] =
+                kernelFunction(term, sigma, dist);
+            if (kern[(size_t)row * pcols + col][0] > kmax)
+                kmax = kern[(size_t)row * pcols + col][0];
+        }
+    }
+
+    fft2(-1, data, (int)NN, pcols, prows);
+    fft2(-1, kern, (int)NN, pcols, prows);
+    for (i = 0; (size_t)i < NN; i++) {
+        re = data[i][0] * kern[i][0] - data[i][1] * kern[i][1];
+        im = data[i][0] * kern[i][1] + data[i][1] * kern[i][0];
+        data[i][0] = re;
+        data[i][1] = im;
+    }
+    G_free(kern);
+    fft2(1, data, (int)NN, pcols, prows);
+
+    /* fft2() scales both transforms by 1 / sqrt(NN) */
+    scale = sqrt((double)NN);
+    /* round-off below this is zero */
+    eps = 1e3 * DBL_EPSILON * kmax * (List->n_values + 1);
+
+    out = Rast_allocate_d_buf();
+    if ((maskfd = Rast_maskfd()) >= 0)
+        mask = Rast_allocate_c_buf();
+
+    for (row = 0; row < window->rows; row++) {
+        G_percent(row, window->rows, 2);
+        if (mask)
+            Rast_get_c_row(maskfd, mask, row);
+
+        for (col = 0; col < window->cols; col++) {
+            if (mask && Rast_is_c_null_value(&mask[col])) {
+                Rast_set_d_null_value(&out[col], 1);
+                continue;
+            }
+            gaussian = data[(size_t)(row + rr) * pcols + col + rc][0] * scale;
+            if (gaussian < eps)
+                gaussian = 0.;
+            out[col] = multip * gaussian;
+            if (gaussian > gausmax)
+                gausmax = gaussian;
+        }
+        Rast_put_d_row(fdout, out);
+    }
+    G_percent(1, 1, 1);
+
+    G_free(data);
+    G_free(out);
+    G_free(mask);
+
+    return gausmax;
+}
+#endif
+
+/*!
+   \brief Write kernel density of the points to the raster map
+
+   With a discretization error dsize at least half of the cell diagonal and
+   a radius of several cells, points are moved to cell centers and the
+   density is computed by convolution with FFT. Otherwise the points within
+   the radius of each cell are searched in a k-d tree.
+
+   \return maximum density (without multiplier)
+ */
+double density_raster(struct Map_info *In, const struct Cell_head *window,
+                      int fdout, double sigma, double term, double dmax,
+                      double multip, double dsize, int nprocs)
+{
+    struct boxlist *List;
+    double gausmax;
+
+    List = Vect_new_boxlist(1);
+    select_points(In, window, dmax, List);
+    G_verbose_message(_("%d points within the radius of the region"),
+                      List->n_values);
+
+#ifdef HAVE_FFT
+    if (dsize > 0 && dsize >= 0.5 * hypot(window->ew_res, window->ns_res) &&
+        dmax >= FFT_MIN_CELLS * fmin(window->ew_res, window->ns_res) &&
+        (double)(window->rows + 2 * ceil(dmax / window->ns_res)) *
+                (window->cols + 2 * ceil(dmax / window->ew_res)) <
+            INT_MAX) {
+        gausmax = density_fft(List, window, fdout, sigma, term, dmax, multip);
+        Vect_destroy_boxlist(List);
+
+        return gausmax;
+    }
+#else
+    (void)dsize;
+#endif
+
+    gausmax = density_kdtree(List, window, fdout, sigma, term, dmax, multip,
+                             nprocs);
+    Vect_destroy_boxlist(List);
+
+    return gausmax;
+}
@@ -0,0 +1,154 @@
+"""
+Name:      v.kernel test
+Purpose:   Compares the density computed by FFT with the exact density,
+           the exact density with the sum over all points in each cell
+           and the density computed with several threads
+
+Author:    GRASS Development Team
+Copyright: (C) 2026 by the GRASS Development Team
+Licence:   This program is free software under the GNU General Public
+           License (>=v2). Read the file COPYING that comes with GRASS
+           for details.
+"""
+
+import math
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import parse_command
+
+# points off the cell centers of the region of TestCellSum
+POINTS = [(130.5, 870.2), (455.3, 610.9), (520.1, 560.4), (1010.7, 140.6)]
+
+
+class TestVKernel(TestCase):
+    exact = "test_v_kernel_exact"
+    output = "test_v_kernel_output"
+    diff = "test_v_kernel_diff"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", vector="schools", res=100, flags="a")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove", flags="f", type="raster", name=[cls.exact, cls.output, cls.diff]
+        )
+        cls.del_temp_region()
+
+    def kernel(self, output, **kwargs):
+        self.assertModule(
+            "v.kernel",
+            input="schools",
+            output=output,
+            radius=2000,
+            overwrite=True,
+            **kwargs,
+        )
+
+    def test_nprocs(self):
+        """Density with nprocs=4 equals nprocs=1"""
+        self.kernel(self.exact, nprocs=1)
+        self.kernel(self.output, nprocs=4)
+        self.assertRastersNoDifference(self.output, reference=self.exact, precision=0)
+
+    def test_fft(self):
+        """Density by FFT is within the discretization error of the exact one
+
+        With dsize of the cell diagonal points move by at most 71 m, which
+        changes the kernels with a radius of 2000 m by a few percent of
+        their maximum.
+        """
+        for kernel in ("gaussian", "epanechnikov"):
+            with self.subTest(kernel=kernel):
+                self.kernel(self.exact, kernel=kernel)
+                self.kernel(self.output, kernel=kernel, dsize=142)
+                self.runModule(
+                    "r.mapcalc",
+                    expression=f"{self.diff} = abs({self.output} - {self.exact})",
+                    overwrite=True,
+                )
+                exact = parse_command("r.univar", map=self.exact, flags="g")
+                output = parse_command("r.univar", map=self.output, flags="g")
+                diff = parse_command("r.univar", map=self.diff, flags="g")
+                self.assertLess(float(diff["max"]), 0.1 * float(exact["max"]))
+                self.assertAlmostEqual(
+                    float(output["mean"]),
+                    float(exact["mean"]),
+                    delta=0.02 * float(exact["mean"]),
+                )
+
+
+class TestCellSum(TestCase):
+    """Density of the k-d tree search equals the sum of the kernels of all
+    points within the radius of each cell center, as computed cell by cell
+    before the search was introduced"""
+
+    points = "test_v_kernel_points"
+    output = "test_v_kernel_output"
+    reference = "test_v_kernel_reference"
+    radius = 450
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=1000, s=0, e=1200, w=0, res=100)
+        cls.runModule(
+            "v.in.ascii",
+            input="-",
+            output=cls.points,
+            separator="pipe",
+            stdin_="\n".join(f"{x}|{y}" for x, y in POINTS),
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule("g.remove", flags="f", type="vector", name=cls.points)
+        cls.runModule(
+            "g.remove", flags="f", type="raster", name=[cls.output, cls.reference]
+        )
+        cls.del_temp_region()
+
+    def cell_sum(self, kernel):
+        """r.mapcalc expression summing the kernel over all points"""
+        if kernel == "gaussian":
+            sigma = self.radius / 4
+            term = 1 / (sigma**2 * 2 * math.pi)
+            value = "{term} * exp(-({d} / {sigma})^2 / 2)"
+        else:
+            sigma = self.radius
+            term = 2 / (math.pi * sigma**2)
+            value = "{term} * (1 - ({d} / {sigma})^2)"
+        terms = []
+        for x, y in POINTS:
+            d = f"sqrt((x() - {x})^2 + (y() - {y})^2)"
+            kernel_value = value.format(term=term, d=d, sigma=sigma)
+            terms.append(f"if({d} <= {self.radius}, {kernel_value}, 0)")
+        return " + ".join(terms)
+
+    def test_cell_sum(self):
+        """Density equals the sum over all points in each cell"""
+        for kernel in ("gaussian", "epanechnikov"):
+            with self.subTest(kernel=kernel):
+                self.assertModule(
+                    "v.kernel",
+                    input=self.points,
+                    output=self.output,
+                    radius=self.radius,
+                    kernel=kernel,
+                    overwrite=True,
+                )
+                self.runModule(
+                    "r.mapcalc",
+                    expression=f"{self.reference} = {self.cell_sum(kernel)}",
+                    overwrite=True,
+                )
+                self.assertRastersNoDifference(
+                    self.output, reference=self.reference, precision=1e-12
+                )
+
+
+if __name__ == "__main__":
+    test()
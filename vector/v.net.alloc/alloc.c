@@ -4,164 +4,208 @@
 #include <grass/gis.h>
 #include <grass/vector.h>
 #include <grass/dbmi.h>
-#include <grass/dgl/graph.h>
+#include <grass/dgl.h>
 #include <grass/glocale.h>
 #include "alloc.h"
 
-int alloc_from_centers_loop_tt(struct Map_info *Map, NODE *Nodes,
-                               CENTER *Centers, int ncenters, int tucfield)
+/* unique category of the point on node, as Vect_net_ttb_shortest_path() */
+static int node_ucat(struct Map_info *Map, int node, int tucfield,
+                     struct boxlist *List, struct line_cats *Cats)
 {
-    int center, line, nlines, i;
-    int node1;
-    int cat;
-    struct line_cats *Cats;
-    struct line_pnts *Points;
-    double cost, n1cost, n2cost;
-    int ret;
-
-    Cats = Vect_new_cats_struct();
-    Points = Vect_new_line_struct();
-
-    nlines = Vect_get_num_lines(Map);
-
-    for (i = 2; i <= (nlines * 2 + 2); i++) {
-        Nodes[i].center = -1; /* NOTE: first two items of Nodes are not used */
-        Nodes[i].cost = -1;
-        Nodes[i].edge = 0;
+    int i, cat;
+    double x, y, z;
+    struct bound_box box;
+
+    Vect_get_node_coor(Map, node, &x, &y, &z);
+    box.E = box.W = x;
+    box.N = box.S = y;
+    box.T = box.B = z;
+    Vect_select_lines_by_box(Map, &box, GV_POINT, List);
+
+    for (i = 0; i < List->n_values; i++) {
+        if (!(Vect_read_line(Map, NULL, Cats, List->id[i]) & GV_POINT))
+            continue;
+        if (Vect_cat_get(Cats, tucfield, &cat))
+            return cat;
     }
+    G_fatal_error(
+        _("Unable to find point with defined unique category for node <%d>."),
+        node);
 
-    for (center = 0; center < ncenters; center++) {
-        G_percent(center, ncenters, 1);
-        node1 = Centers[center].node;
-        Vect_net_get_node_cost(Map, node1, &n1cost);
-        G_debug(2, "center = %d node = %d cat = %d", center, node1,
-                Centers[center].cat);
+    return -1;
+}
 
-        for (line = 1; line <= nlines; line++) {
-            G_debug(5, "  node1 = %d line = %d", node1, line);
-            Vect_net_get_node_cost(Map, line, &n2cost);
-            /* closed, left it as not attached */
+/* copy of the flat turntable graph, edges reversed for costs to centers */
+static void copy_graph(dglGraph_s *graph, dglCSRGraph_s *csr, int reverse)
+{
+    dglNodeTraverser_s nt;
+    dglEdgesetTraverser_s et;
+    dglInt32_t *node, *edge, *edgeset, from, to, ncost;
 
-            if (Vect_read_line(Map, Points, Cats, line) < 0)
-                continue;
-            if (Vect_get_line_type(Map, line) != GV_LINE)
-                continue;
-            if (!Vect_cat_get(Cats, tucfield, &cat))
-                continue;
+    dglCSRInitialize(csr, DGL_CSR_NODECOST);
 
-            for (i = 0; i < 2; i++) {
-                if (i == 1)
-                    cat *= -1;
-
-                ret = Vect_net_ttb_shortest_path(Map, node1, 0, cat, 1,
-                                                 tucfield, NULL, &cost);
-                if (ret == -1) {
-                    continue;
-                } /* node unreachable */
-
-                /* We must add center node costs (not calculated by
-                 * Vect_net_shortest_path() ), but only if center and node are
-                 * not identical, because at the end node cost is add later */
-                if (ret != 1)
-                    cost += n1cost;
-
-                G_debug(5,
-                        "Arc nodes: %d %d cost: %f (x old cent: %d old cost %f",
-                        node1, line, cost, Nodes[line * 2 + i].center,
-                        Nodes[line * 2 + i].cost);
-                if (Nodes[line * 2 + i].center == -1 ||
-                    Nodes[line * 2 + i].cost > cost) {
-                    Nodes[line * 2 + i].cost = cost;
-                    Nodes[line * 2 + i].center = center;
-                }
-            }
+    dglNode_T_Initialize(&nt, graph);
+    for (node = dglNode_T_First(&nt); node; node = dglNode_T_Next(&nt)) {
+        edgeset = dglNodeGet_OutEdgeset(graph, node);
+        if (edgeset == NULL)
+            continue;
+        from = dglNodeGet_Id(graph, node);
+        dglEdgeset_T_Initialize(&et, graph, edgeset);
+        for (edge = dglEdgeset_T_First(&et); edge;
+             edge = dglEdgeset_T_Next(&et)) {
+            to = dglNodeGet_Id(graph, dglEdgeGet_Tail(graph, edge));
+            if (dglCSRAddEdge(csr, reverse ? to : from, reverse ? from : to,
+                              dglEdgeGet_Cost(graph, edge),
+                              dglEdgeGet_Id(graph, edge)) < 0)
+                G_fatal_error(_("Out of memory"));
         }
+        dglEdgeset_T_Release(&et);
     }
-    G_percent(1, 1, 1);
-
-    Vect_destroy_cats_struct(Cats);
-    Vect_destroy_line_struct(Points);
+    if (dglCSRFinalize(csr) < 0)
+        G_fatal_error(_("Out of memory"));
 
-    return 0;
+    for (node = dglNode_T_First(&nt); node; node = dglNode_T_Next(&nt)) {
+        memcpy(&ncost, dglNodeGet_Attr(graph, node), sizeof(ncost));
+        dglCSRSetNodeCost(csr, dglNodeGet_Id(graph, node), ncost);
+    }
+    dglNode_T_Release(&nt);
 }
 
-int alloc_to_centers_loop_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
-                             int ncenters, int tucfield)
+/*
+   Nearest center for both directions of lines on the graph with
+   turntable, one search from all centers.
+
+   The cost of a line direction is the cost of the shortest path from the
+   center point (or to the center point) plus the costs of the center node,
+   as the sum of Vect_net_ttb_shortest_path() and Vect_net_get_node_cost()
+   with one path search for each center and line direction.
+ */
+static int alloc_centers_tt(struct Map_info *Map, NODE *Nodes,
+                            CENTER *Centers, int ncenters, int tucfield,
+                            int from_centers)
 {
-    int center, line, nlines, i;
-    int node1;
-    int cat;
+    int i, j, line, nlines, cat, multip;
+    int32_t v, s, e;
+    dglCSRGraph_s csr;
+    dglHeap_s heap;
+    dglHeapData_u heap_data;
+    dglHeapNode_s heap_node;
+    dglInt32_t *dist, *offset, d;
+    int *center, *is_source;
+    double n1cost;
+    struct boxlist *List;
     struct line_cats *Cats;
-    struct line_pnts *Points;
-    double cost, n1cost, n2cost;
-    int ret;
-
-    Cats = Vect_new_cats_struct();
-    Points = Vect_new_line_struct();
 
     nlines = Vect_get_num_lines(Map);
+    multip = Map->dgraph.cost_multip;
 
-    for (i = 2; i <= (nlines * 2 + 2); i++) {
+    for (i = 2; i < nlines * 2 + 2; i++) {
         Nodes[i].center = -1; /* NOTE: first two items of Nodes are not used */
         Nodes[i].cost = -1;
         Nodes[i].edge = 0;
     }
 
-    for (line = 1; line <= nlines; line++) {
-        G_debug(5, "  line = %d", line);
-        Vect_net_get_node_cost(Map, line, &n2cost);
-        /* closed, left it as not attached */
+    copy_graph(Vect_net_get_graph(Map), &csr, !from_centers);
 
-        if (Vect_read_line(Map, Points, Cats, line) < 0)
+    dist = G_malloc(csr.cNode * sizeof(dglInt32_t));
+    center = G_malloc(csr.cNode * sizeof(int));
+    is_source = G_calloc(csr.cNode, sizeof(int));
+    for (v = 0; v < csr.cNode; v++)
+        dist[v] = -1;
+    offset = G_malloc((ncenters + 1) * sizeof(dglInt32_t));
+
+    List = Vect_new_boxlist(0);
+    Cats = Vect_new_cats_struct();
+
+    dglHeapInit(&heap);
+
+    /* paths start at the point of the center, node costs of the center
+     * are added, the first center wins equal costs */
+    for (i = 0; i < ncenters; i++) {
+        cat = node_ucat(Map, Centers[i].node, tucfield, List, Cats);
+        Vect_net_get_node_cost(Map, Centers[i].node, &n1cost);
+        offset[i] = (dglInt32_t)(multip * n1cost);
+        s = dglCSRNodeIndex(&csr, from_centers ? cat * 2 : cat * 2 + 1);
+        if (s < 0)
             continue;
+        if (dist[s] != -1 && dist[s] <= offset[i])
+            continue;
+        dist[s] = offset[i];
+        center[s] = i;
+        is_source[s] = 1;
+        heap_data.l = s;
+        dglHeapInsertMin(&heap, offset[i], ' ', heap_data);
+    }
+
+    while (dglHeapExtractMin(&heap, &heap_node)) {
+        v = heap_node.value.l;
+        d = heap_node.key;
+        if (dist[v] < d)
+            continue;
+
+        /* cost of leaving the node, do not go through closed nodes */
+        if (!is_source[v]) {
+            if (csr.pnNodeCost[v] < 0)
+                continue;
+            d += csr.pnNodeCost[v];
+        }
+
+        for (e = csr.pnOut[v]; e < csr.pnOut[v + 1]; e++) {
+            int32_t to = csr.pnTo[e];
+
+            if (dist[to] == -1 || dist[to] > d + csr.pnCost[e]) {
+                dist[to] = d + csr.pnCost[e];
+                center[to] = center[v];
+                heap_data.l = to;
+                dglHeapInsertMin(&heap, dist[to], ' ', heap_data);
+            }
+        }
+    }
+    dglHeapFree(&heap, NULL);
+
+    /* directions of lines are nodes of the graph */
+    for (line = 1; line <= nlines; line++) {
         if (Vect_get_line_type(Map, line) != GV_LINE)
             continue;
+        Vect_read_line(Map, NULL, Cats, line);
         if (!Vect_cat_get(Cats, tucfield, &cat))
             continue;
 
-        for (center = 0; center < ncenters; center++) {
-            G_percent(center, ncenters, 1);
-            node1 = Centers[center].node;
-            Vect_net_get_node_cost(Map, node1, &n1cost);
-            G_debug(2, "center = %d node = %d cat = %d", center, node1,
-                    Centers[center].cat);
-
-            for (i = 0; i < 2; i++) {
-                if (i == 1)
-                    cat *= -1;
-
-                ret = Vect_net_ttb_shortest_path(Map, cat, 1, node1, 0,
-                                                 tucfield, NULL, &cost);
-                if (ret == -1) {
-                    continue;
-                } /* node unreachable */
-
-                /* We must add center node costs (not calculated by
-                 * Vect_net_shortest_path() ), but only if center and node are
-                 * not identical, because at the end node cost is add later */
-                if (ret != 1)
-                    cost += n1cost;
-
-                G_debug(5,
-                        "Arc nodes: %d %d cost: %f (x old cent: %d old cost %f",
-                        node1, line, cost, Nodes[line * 2 + i].center,
-                        Nodes[line * 2 + i].cost);
-                if (Nodes[line * 2 + i].center == -1 ||
-                    Nodes[line * 2 + i].cost > cost) {
-                    Nodes[line * 2 + i].cost = cost;
-                    Nodes[line * 2 + i].center = center;
-                }
-            }
+        for (j = 0; j < 2; j++) {
+            v = dglCSRNodeIndex(&csr, cat * 2 + j);
+            if (v < 0 || dist[v] == -1 || is_source[v])
+                continue;
+            i = center[v];
+            Vect_net_get_node_cost(Map, Centers[i].node, &n1cost);
+            Nodes[line * 2 + j].center = i;
+            Nodes[line * 2 + j].cost =
+                (double)(dist[v] - offset[i]) / multip + n1cost;
         }
     }
-    G_percent(1, 1, 1);
 
+    Vect_destroy_boxlist(List);
     Vect_destroy_cats_struct(Cats);
-    Vect_destroy_line_struct(Points);
+    G_free(dist);
+    G_free(center);
+    G_free(is_source);
+    G_free(offset);
+    dglCSRRelease(&csr);
 
     return 0;
 }
 
+int alloc_from_centers_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
+                          int ncenters, int tucfield)
+{
+    return alloc_centers_tt(Map, Nodes, Centers, ncenters, tucfield, 1);
+}
+
+int alloc_to_centers_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
+                        int ncenters, int tucfield)
+{
+    return alloc_centers_tt(Map, Nodes, Centers, ncenters, tucfield, 0);
+}
+
 int alloc_from_centers(dglGraph_s *graph, NODE *Nodes, CENTER *Centers,
                        int ncenters)
 {
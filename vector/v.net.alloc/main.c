@@ -249,7 +249,7 @@ int main(int argc, char **argv)
         /* if turntable is used we are looking for lines as destinations,
          * instead of the intersections (nodes) */
         Nodes = (NODE *)G_calloc((nlines * 2 + 2), sizeof(NODE));
-        for (i = 2; i <= (nlines * 2 + 2); i++) {
+        for (i = 2; i < (nlines * 2 + 2); i++) {
             Nodes[i].center =
                 -1; /* NOTE: first two items of Nodes are not used */
         }
@@ -266,12 +266,11 @@ int main(int argc, char **argv)
     if (turntable_f->answer) {
         if (from_centers) {
             G_message(_("Calculating costs from centers ..."));
-            alloc_from_centers_loop_tt(&Map, Nodes, Centers, ncenters,
-                                       tucfield);
+            alloc_from_centers_tt(&Map, Nodes, Centers, ncenters, tucfield);
         }
         else {
             G_message(_("Calculating costs to centers ..."));
-            alloc_to_centers_loop_tt(&Map, Nodes, Centers, ncenters, tucfield);
+            alloc_to_centers_tt(&Map, Nodes, Centers, ncenters, tucfield);
         }
     }
     else {
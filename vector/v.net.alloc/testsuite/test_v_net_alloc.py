@@ -0,0 +1,90 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import read_command
+
+
+def lengths(name):
+    """Total length of network allocated to each center"""
+    rows = read_command(
+        "v.to.db", map=name, option="length", flags="p", separator="pipe"
+    ).splitlines()
+    result = {}
+    for row in rows[1:]:
+        cat, length = row.split("|")
+        result[int(cat)] = float(length)
+    return result
+
+
+class TestVNetAllocTurntable(TestCase):
+    """Search from all centers on the turntable against the search without it
+
+    The turntable of v.net allows every turn at no cost, so the allocation
+    must be the same as without the turntable.
+    """
+
+    network = "test_vnet_alloc"
+    turntable = "test_vnet_alloc_tt"
+    output = "test_vnet_alloc_out"
+    output_tt = "test_vnet_alloc_out_tt"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "v.net",
+            input="streets",
+            points="schools",
+            output=cls.network,
+            operation="connect",
+            threshold=1000,
+        )
+        cls.runModule(
+            "v.net", input=cls.network, output=cls.turntable, operation="turntable"
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove", flags="f", type="vector", name=[cls.network, cls.turntable]
+        )
+        cls.del_temp_region()
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove", flags="f", type="vector", name=[self.output, self.output_tt]
+        )
+
+    def compare(self, method):
+        self.assertModule(
+            "v.net.alloc",
+            input=self.network,
+            output=self.output,
+            center_cats="1-20",
+            method=method,
+        )
+        self.assertModule(
+            "v.net.alloc",
+            input=self.turntable,
+            output=self.output_tt,
+            center_cats="1-20",
+            method=method,
+            flags="t",
+        )
+        reference = lengths(self.output)
+        result = lengths(self.output_tt)
+        self.assertGreater(len(reference), 1)
+        self.assertEqual(reference.keys(), result.keys())
+        for cat, length in reference.items():
+            self.assertAlmostEqual(result[cat], length, delta=1e-6 * length)
+
+    def test_from_centers(self):
+        """Costs from centers"""
+        self.compare("from")
+
+    def test_to_centers(self):
+        """Costs to centers"""
+        self.compare("to")
+
+
+if __name__ == "__main__":
+    test()
@@ -7,7 +7,7 @@
  *
  * PURPOSE:    Shortest paths between all nodes
  *
- * COPYRIGHT:  (C) 2002-2005 by the GRASS Development Team
+ * COPYRIGHT:  (C) 2002-2026 by the GRASS Development Team
  *
  *             This program is free software under the
  *             GNU General Public License (>=v2).
@@ -33,18 +33,21 @@ int main(int argc, char *argv[])
     struct Map_info In, Out;
     static struct line_pnts *Points, *aPoints;
     struct line_cats *Cats, **FCats, **BCats;
-    struct ilist *List;
+    struct ilist *List, *From;
     struct GModule *module; /* GRASS module for parsing arguments */
     struct Option *map_in, *map_out;
     struct Option *cat_opt, *afield_opt, *nfield_opt, *where_opt, *abcol,
-        *afcol, *ncol;
-    struct Flag *geo_f;
+        *afcol, *ncol, *nprocs_opt;
+    struct Flag *geo_f, *ch_f;
     int afield, nfield;
     int chcat, with_z;
     int mask_type;
     struct varray *varray;
     struct _spnode *spnode;
     int i, j, k, geo, nnodes, line, nlines, cat;
+    int nprocs, nblock, nmapnodes, i0, b;
+    dglGraph_s *graph;
+    dglInt32_t **dst, ***prev;
     char buf[2000];
 
     /* Attribute table */
@@ -61,6 +64,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("vector"));
     G_add_keyword(_("network"));
     G_add_keyword(_("shortest path"));
+    G_add_keyword(_("parallel"));
     module->description = _("Computes the shortest path between all pairs of "
                             "nodes in the network.");
 
@@ -106,14 +110,24 @@ int main(int argc, char *argv[])
     ncol->description = _("Node cost column (number)");
     ncol->guisection = _("Cost");
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     geo_f = G_define_flag();
     geo_f->key = 'g';
     geo_f->description =
         _("Use geodesic calculation for longitude-latitude projects");
 
+    ch_f = G_define_flag();
+    ch_f->key = 'c';
+    ch_f->label = _("Use contraction hierarchy");
+    ch_f->description = _("Faster for many points, the index is saved with "
+                          "the input map and reused");
+
     /* options and flags parser */
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     /* TODO: make an option for this */
     mask_type = GV_LINE | GV_BOUNDARY;
 
@@ -190,6 +204,8 @@ int main(int argc, char *argv[])
 
     Vect_net_build_graph(&In, mask_type, afield, nfield, afcol->answer,
                          abcol->answer, ncol->answer, geo, 0);
+    if (ch_f->answer && Vect_net_build_ch(&In) != 0)
+        G_warning(_("Searching paths without contraction hierarchy"));
 
     nnodes = Vect_get_num_primitives(&In, GV_POINT);
 
@@ -243,53 +259,117 @@ int main(int argc, char *argv[])
     G_percent_reset();
     cat = 1;
     List = Vect_new_list();
-    for (i = 0; i < nnodes; i++) {
-        G_percent(i, nnodes, 1);
 
-        for (j = 0; j < nnodes; j++) {
-            double cost;
-            int ret;
+    /* without contraction hierarchy, searches from a block of nodes run
+     * in parallel, each giving the paths to all other nodes */
+    graph = &(In.dgraph.graph_s);
+    nblock = In.dgraph.ch_query ? 1 : 4 * nprocs;
+    nmapnodes = Vect_get_num_nodes(&In);
+    From = G_new_ilist();
+    dst = NULL;
+    prev = NULL;
+    if (!In.dgraph.ch_query) {
+        dst = G_malloc(nblock * sizeof(dglInt32_t *));
+        prev = G_malloc(nblock * sizeof(dglInt32_t **));
+        for (b = 0; b < nblock; b++) {
+            dst[b] = G_malloc((nmapnodes + 1) * sizeof(dglInt32_t));
+            prev[b] = G_malloc((nmapnodes + 1) * sizeof(dglInt32_t *));
+        }
+    }
 
-            if (i == j)
-                continue;
+    for (i0 = 0; i0 < nnodes; i0 += nblock) {
+        int n = MIN(nblock, nnodes - i0);
 
-            ret = Vect_net_shortest_path(&In, spnode[i].node, spnode[j].node,
-                                         List, &cost);
+        G_percent(i0, nnodes, 1);
 
-            if (ret == -1) {
-                /* unreachable */
-                continue;
-            }
+        if (!In.dgraph.ch_query) {
+            Vect_reset_list(From);
+            for (b = 0; b < n; b++)
+                G_ilist_add(From, spnode[i0 + b].node);
+            if (NetA_distance_matrix(graph, nmapnodes, From, dst, prev,
+                                     nprocs) != 0)
+                G_fatal_error(_("Unable to compute shortest paths"));
+        }
 
-            snprintf(buf, sizeof(buf), "insert into %s values (%d, %d, %d, %f)",
-                     Fi->table, cat, spnode[i].cat, spnode[j].cat, cost);
-            db_set_string(&sql, buf);
-            G_debug(3, "%s", db_get_string(&sql));
+        for (b = 0; b < n; b++) {
+            i = i0 + b;
 
-            if (db_execute_immediate(driver, &sql) != DB_OK) {
-                db_close_database_shutdown_driver(driver);
-                G_fatal_error(_("Cannot insert new record: %s"),
-                              db_get_string(&sql));
-            }
+            for (j = 0; j < nnodes; j++) {
+                double cost;
 
-            for (k = 0; k < List->n_values; k++) {
-                line = List->value[k];
-                if (line > 0) {
-                    if (!FCats[line])
-                        FCats[line] = Vect_new_cats_struct();
-                    Vect_cat_set(FCats[line], afield, cat);
+                if (i == j)
+                    continue;
+
+                if (In.dgraph.ch_query) {
+                    if (Vect_net_shortest_path(&In, spnode[i].node,
+                                               spnode[j].node, List,
+                                               &cost) == -1) {
+                        /* unreachable */
+                        continue;
+                    }
                 }
                 else {
-                    if (!BCats[abs(line)])
-                        BCats[abs(line)] = Vect_new_cats_struct();
-                    Vect_cat_set(BCats[abs(line)], afield, cat);
+                    int node = spnode[j].node;
+
+                    if (dst[b][node] < 0) {
+                        /* unreachable */
+                        continue;
+                    }
+                    cost = dst[b][node] / (double)In.dgraph.cost_multip;
+
+                    /* trace back the path */
+                    Vect_reset_list(List);
+                    while (node != spnode[i].node && prev[b][node]) {
+                        dglInt32_t *edge = prev[b][node];
+
+                        G_ilist_add(List, dglEdgeGet_Id(graph, edge));
+                        node = dglNodeGet_Id(graph,
+                                             dglEdgeGet_Head(graph, edge));
+                    }
                 }
+
+                snprintf(buf, sizeof(buf),
+                         "insert into %s values (%d, %d, %d, %f)", Fi->table,
+                         cat, spnode[i].cat, spnode[j].cat, cost);
+                db_set_string(&sql, buf);
+                G_debug(3, "%s", db_get_string(&sql));
+
+                if (db_execute_immediate(driver, &sql) != DB_OK) {
+                    db_close_database_shutdown_driver(driver);
+                    G_fatal_error(_("Cannot insert new record: %s"),
+                                  db_get_string(&sql));
+                }
+
+                for (k = 0; k < List->n_values; k++) {
+                    line = List->value[k];
+                    if (line > 0) {
+                        if (!FCats[line])
+                            FCats[line] = Vect_new_cats_struct();
+                        Vect_cat_set(FCats[line], afield, cat);
+                    }
+                    else {
+                        if (!BCats[abs(line)])
+                            BCats[abs(line)] = Vect_new_cats_struct();
+                        Vect_cat_set(BCats[abs(line)], afield, cat);
+                    }
+                }
+                cat++;
             }
-            cat++;
         }
     }
     G_percent(1, 1, 1);
 
+    if (dst) {
+        for (b = 0; b < nblock; b++) {
+            G_free(dst[b]);
+            G_free(prev[b]);
+        }
+        G_free(dst);
+        G_free(prev);
+    }
+    G_free_ilist(From);
+    Vect_destroy_list(List);
+
     db_commit_transaction(driver);
     db_close_database_shutdown_driver(driver);
 
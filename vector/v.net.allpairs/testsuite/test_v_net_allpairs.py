@@ -0,0 +1,89 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import read_command
+
+
+class TestVNetAllpairs(TestCase):
+    network = "test_vnet_allpairs"
+    output = "test_vnet_allpairs_out"
+    output_ch = "test_vnet_allpairs_out_ch"
+    output_nprocs = "test_vnet_allpairs_out_nprocs"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "v.net",
+            input="streets",
+            points="schools",
+            output=cls.network,
+            operation="connect",
+            threshold=1000,
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule("g.remove", flags="f", type="vector", name=cls.network)
+        cls.del_temp_region()
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove",
+            flags="f",
+            type="vector",
+            name=[self.output, self.output_ch, self.output_nprocs],
+        )
+
+    def costs(self, name):
+        """Costs of paths sorted by from and to category"""
+        rows = read_command(
+            "v.db.select", map=name, columns="from_cat,to_cat,cost", flags="c"
+        ).splitlines()
+        return "\n".join(sorted(rows, key=lambda row: row.split("|")[:2]))
+
+    def test_contraction_hierarchy(self):
+        """Costs with contraction hierarchy equal costs of graph search"""
+        self.assertModule(
+            "v.net.allpairs", input=self.network, output=self.output, cats="1-15"
+        )
+        self.assertModule(
+            "v.net.allpairs",
+            input=self.network,
+            output=self.output_ch,
+            cats="1-15",
+            flags="c",
+        )
+        reference = self.costs(self.output)
+        self.assertTrue(reference)
+        self.assertMultiLineEqual(reference, self.costs(self.output_ch))
+
+        # the saved index is reused
+        self.runModule("g.remove", flags="f", type="vector", name=self.output_ch)
+        self.assertModule(
+            "v.net.allpairs",
+            input=self.network,
+            output=self.output_ch,
+            cats="1-15",
+            flags="c",
+        )
+        self.assertMultiLineEqual(reference, self.costs(self.output_ch))
+
+    def test_nprocs(self):
+        """Costs with nprocs>1 equal costs with nprocs=1"""
+        self.assertModule(
+            "v.net.allpairs", input=self.network, output=self.output, cats="1-15"
+        )
+        self.assertModule(
+            "v.net.allpairs",
+            input=self.network,
+            output=self.output_nprocs,
+            cats="1-15",
+            nprocs=4,
+        )
+        reference = self.costs(self.output)
+        self.assertTrue(reference)
+        self.assertMultiLineEqual(reference, self.costs(self.output_nprocs))
+
+
+if __name__ == "__main__":
+    test()
@@ -6,7 +6,7 @@
  *
  * PURPOSE:    This module computes various centrality measures
  *
- * COPYRIGHT:  (C) 2002-2005 by the GRASS Development Team
+ * COPYRIGHT:  (C) 2002-2026 by the GRASS Development Team
  *
  *             This program is free software under the
  *             GNU General Public License (>=v2).
@@ -78,13 +78,13 @@ int main(int argc, char *argv[])
     struct Option *map_in, *map_out;
     struct Option *cat_opt, *where_opt, *afield_opt, *nfield_opt, *abcol,
         *afcol, *ncol;
-    struct Option *iter_opt, *error_opt;
+    struct Option *iter_opt, *error_opt, *nprocs_opt;
     struct Flag *geo_f, *add_f;
     int chcat, with_z;
     int afield, nfield, mask_type;
     struct varray *varray;
     dglGraph_s *graph;
-    int i, geo, nnodes, nlines, j, max_cat;
+    int i, geo, nnodes, nlines, j, max_cat, nprocs;
     char buf[2000], *covered;
 
     /* initialize GIS environment */
@@ -96,6 +96,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("vector"));
     G_add_keyword(_("network"));
     G_add_keyword(_("centrality measures"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Computes degree, centrality, betweeness, closeness and eigenvector "
           "centrality measures in the network.");
@@ -182,6 +183,8 @@ int main(int argc, char *argv[])
     error_opt->description =
         _("Cumulative error tolerance for eigenvector centrality");
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     geo_f = G_define_flag();
     geo_f->key = 'g';
     geo_f->description =
@@ -194,6 +197,8 @@ int main(int argc, char *argv[])
     /* options and flags parser */
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     /* TODO: make an option for this */
     mask_type = GV_LINE | GV_BOUNDARY;
 
@@ -322,7 +327,7 @@ int main(int argc, char *argv[])
     if (betw_opt->answer || close_opt->answer) {
         G_message(
             _("Computing betweenness and/or closeness centrality measure"));
-        NetA_betweenness_closeness(graph, betw, closeness);
+        NetA_betweenness_closeness(graph, betw, closeness, nprocs);
         if (closeness)
             for (i = 1; i <= nnodes; i++)
                 closeness[i] /= (double)In.dgraph.cost_multip;
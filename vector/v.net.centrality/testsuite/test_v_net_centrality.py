@@ -0,0 +1,62 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import read_command
+
+
+class TestVNetCentrality(TestCase):
+    network = "test_vnet_centrality"
+    outputs = ["test_vnet_centrality_1", "test_vnet_centrality_4"]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("v.net", input="streets", output=cls.network, operation="nodes")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove", flags="f", type="vector", name=[cls.network, *cls.outputs]
+        )
+        cls.del_temp_region()
+
+    def centrality(self, output, nprocs):
+        """Betweenness and closeness by category"""
+        self.assertModule(
+            "v.net.centrality",
+            input=self.network,
+            output=output,
+            betweenness="betw",
+            closeness="close",
+            nprocs=nprocs,
+            overwrite=True,
+        )
+        rows = read_command(
+            "v.db.select", map=output, columns="cat,betw,close", flags="c"
+        ).splitlines()
+        values = {}
+        for row in rows:
+            cat, betw, close = row.split("|")
+            values[int(cat)] = (float(betw), float(close))
+        return values
+
+    def test_nprocs(self):
+        """Betweenness and closeness with nprocs>1 equal nprocs=1
+
+        Per-thread sums are added in a different order, so the values are
+        compared with a relative tolerance.
+        """
+        serial = self.centrality(self.outputs[0], nprocs=1)
+        parallel = self.centrality(self.outputs[1], nprocs=4)
+        self.assertTrue(serial)
+        self.assertEqual(serial.keys(), parallel.keys())
+        for cat, (betw, close) in serial.items():
+            self.assertAlmostEqual(
+                parallel[cat][0], betw, delta=1e-9 * max(1, abs(betw))
+            )
+            self.assertAlmostEqual(
+                parallel[cat][1], close, delta=1e-9 * max(1, abs(close))
+            )
+
+
+if __name__ == "__main__":
+    test()
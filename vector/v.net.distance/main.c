@@ -8,7 +8,7 @@
  * PURPOSE:    Computes shortest distance via the network between
  *             two given sets of features.
  *
- * COPYRIGHT:  (C) 2009-2010, 2012 by Daniel Bundala, and the GRASS
+ * COPYRIGHT:  (C) 2009-2010, 2012, 2026 by Daniel Bundala, and the GRASS
  *             Development Team
  *
  *             This program is free software under the
@@ -20,12 +20,119 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <grass/gis.h>
 #include <grass/vector.h>
 #include <grass/glocale.h>
 #include <grass/dbmi.h>
 #include <grass/neta.h>
 
+/* write costs between all 'from' and 'to' features, the searches from
+ * a block of 'from' nodes run in parallel */
+static void write_matrix(struct Map_info *In, dglGraph_s *graph,
+                         struct varray *varrayf, int flayer,
+                         struct ilist *nodest, int *nodes_to_features,
+                         int tlayer, FILE *fp, const char *sep, int nprocs)
+{
+    struct line_pnts *Points = Vect_new_line_struct();
+    struct line_cats *Cats = Vect_new_cats_struct();
+    struct ilist *fnodes = G_new_ilist(), *fcats = G_new_ilist();
+    struct ilist *block = G_new_ilist();
+    int i, j, b, nblock, nnodes, nlines, ntf;
+    int *tfeature, *tcat, *tindex;
+    dglInt32_t **dst, *best;
+
+    nnodes = Vect_get_num_nodes(In);
+    nlines = Vect_get_num_lines(In);
+
+    /* 'from' features */
+    for (i = 1; i <= nlines; i++) {
+        int node, cat;
+
+        if (!varrayf->c[i])
+            continue;
+        if (Vect_read_line(In, Points, Cats, i) & GV_POINTS)
+            node = Vect_find_node(In, Points->x[0], Points->y[0],
+                                  Points->z[0], 0, 0);
+        else
+            Vect_get_line_nodes(In, i, &node, NULL);
+        if (node < 1 || !Vect_cat_get(Cats, flayer, &cat))
+            continue;
+        G_ilist_add(fnodes, node);
+        G_ilist_add(fcats, cat);
+    }
+
+    /* 'to' features and their nodes */
+    tfeature = G_malloc((nlines + 1) * sizeof(int));
+    tcat = G_malloc(nodest->n_values * sizeof(int));
+    tindex = G_malloc(nodest->n_values * sizeof(int));
+    for (i = 1; i <= nlines; i++)
+        tfeature[i] = -1;
+    ntf = 0;
+    for (j = 0; j < nodest->n_values; j++) {
+        int line = nodes_to_features[nodest->value[j]];
+
+        if (tfeature[line] < 0) {
+            Vect_read_line(In, NULL, Cats, line);
+            if (!Vect_cat_get(Cats, tlayer, &tcat[ntf]))
+                tcat[ntf] = -1;
+            tfeature[line] = ntf++;
+        }
+        tindex[j] = tfeature[line];
+    }
+    best = G_malloc(ntf * sizeof(dglInt32_t));
+
+    nblock = 4 * nprocs;
+    dst = G_malloc(nblock * sizeof(dglInt32_t *));
+    for (b = 0; b < nblock; b++)
+        dst[b] = G_malloc((nnodes + 1) * sizeof(dglInt32_t));
+
+    G_message(_("Distances between all 'from' and 'to' features..."));
+    for (i = 0; i < fnodes->n_values; i += nblock) {
+        int n = MIN(nblock, fnodes->n_values - i);
+
+        G_percent(i, fnodes->n_values, 2);
+
+        Vect_reset_list(block);
+        for (b = 0; b < n; b++)
+            G_ilist_add(block, fnodes->value[i + b]);
+        if (NetA_distance_matrix(graph, nnodes, block, dst, NULL, nprocs) != 0)
+            G_fatal_error(_("Unable to compute distances"));
+
+        for (b = 0; b < n; b++) {
+            for (j = 0; j < ntf; j++)
+                best[j] = -1;
+            /* a line is reached at the nearer of its nodes */
+            for (j = 0; j < nodest->n_values; j++) {
+                dglInt32_t d = dst[b][nodest->value[j]];
+
+                if (d >= 0 && (best[tindex[j]] < 0 || d < best[tindex[j]]))
+                    best[tindex[j]] = d;
+            }
+            for (j = 0; j < ntf; j++) {
+                if (best[j] < 0 || tcat[j] < 0)
+                    continue;
+                fprintf(fp, "%d%s%d%s%f\n", fcats->value[i + b], sep, tcat[j],
+                        sep, best[j] / (double)In->dgraph.cost_multip);
+            }
+        }
+    }
+    G_percent(1, 1, 1);
+
+    for (b = 0; b < nblock; b++)
+        G_free(dst[b]);
+    G_free(dst);
+    G_free(best);
+    G_free(tindex);
+    G_free(tcat);
+    G_free(tfeature);
+    G_free_ilist(block);
+    G_free_ilist(fcats);
+    G_free_ilist(fnodes);
+    Vect_destroy_cats_struct(Cats);
+    Vect_destroy_line_struct(Points);
+}
+
 int main(int argc, char *argv[])
 {
     struct Map_info In, Out;
@@ -37,9 +144,10 @@ int main(int argc, char *argv[])
     struct Option *catf_opt, *fieldf_opt, *wheref_opt;
     struct Option *catt_opt, *fieldt_opt, *wheret_opt, *typet_opt;
     struct Option *afield_opt, *nfield_opt, *abcol, *afcol, *ncol, *atype_opt;
+    struct Option *matrix_opt, *sep_opt, *nprocs_opt;
     struct Flag *geo_f, *segments_f;
     int with_z, geo, segments;
-    int atype, ttype;
+    int atype, ttype, nprocs;
     struct varray *varrayf, *varrayt;
     int flayer, tlayer;
     int afield, nfield;
@@ -67,6 +175,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("vector"));
     G_add_keyword(_("network"));
     G_add_keyword(_("shortest path"));
+    G_add_keyword(_("parallel"));
     module->label = _("Computes shortest distance via the network between "
                       "the given sets of features.");
     module->description = _("Finds the shortest paths from each 'from' point "
@@ -155,6 +264,23 @@ int main(int argc, char *argv[])
     ncol->description = _("Node cost column (number)");
     ncol->guisection = _("Cost");
 
+    matrix_opt = G_define_standard_option(G_OPT_F_OUTPUT);
+    matrix_opt->key = "matrix";
+    matrix_opt->required = NO;
+    matrix_opt->label =
+        _("Name for output file of distances between all 'from' and 'to' "
+          "features");
+    matrix_opt->description = _("'-' for standard output");
+    matrix_opt->guisection = _("Matrix");
+
+    sep_opt = G_define_standard_option(G_OPT_F_SEP);
+    sep_opt->guisection = _("Matrix");
+
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+    nprocs_opt->description =
+        _("Number of threads for parallel computing, used only with matrix");
+    nprocs_opt->guisection = _("Matrix");
+
     geo_f = G_define_flag();
     geo_f->key = 'g';
     geo_f->description =
@@ -176,6 +302,8 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     atype = Vect_option_to_types(atype_opt);
     ttype = Vect_option_to_types(typet_opt);
 
@@ -407,6 +535,22 @@ int main(int argc, char *argv[])
     db_commit_transaction(driver);
     db_close_database_shutdown_driver(driver);
 
+    if (matrix_opt->answer) {
+        FILE *fp;
+        char *sep = G_option_to_separator(sep_opt);
+
+        if (strcmp(matrix_opt->answer, "-") == 0)
+            fp = stdout;
+        else if ((fp = fopen(matrix_opt->answer, "w")) == NULL)
+            G_fatal_error(_("Unable to open file <%s> for writing"),
+                          matrix_opt->answer);
+        write_matrix(&In, graph, varrayf, flayer, nodest, nodes_to_features,
+                     tlayer, fp, sep, nprocs);
+        if (fp != stdout)
+            fclose(fp);
+        G_free(sep);
+    }
+
     Vect_build(&Out);
 
     Vect_close(&In);
@@ -0,0 +1,75 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.gunittest.gmodules import SimpleModule
+from grass.script.core import read_command
+
+
+class TestVNetDistanceMatrix(TestCase):
+    network = "test_vnet_distance"
+    output = "test_vnet_distance_out"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "v.net",
+            input="streets",
+            points="schools",
+            output=cls.network,
+            operation="connect",
+            threshold=1000,
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove", flags="f", type="vector", name=[cls.network, cls.output]
+        )
+        cls.del_temp_region()
+
+    def matrix(self, nprocs):
+        """Rows of the matrix output as (from_cat, to_cat, cost)"""
+        module = SimpleModule(
+            "v.net.distance",
+            input=self.network,
+            output=self.output,
+            from_layer=2,
+            from_cats="1-20",
+            to_layer=2,
+            to_cats="100-200",
+            matrix="-",
+            nprocs=nprocs,
+            overwrite=True,
+        )
+        self.assertModule(module)
+        rows = []
+        for line in module.outputs.stdout.splitlines():
+            fcat, tcat, cost = line.split("|")
+            rows.append((int(fcat), int(tcat), float(cost)))
+        return sorted(rows)
+
+    def test_matrix_nearest(self):
+        """The smallest cost in the matrix is the cost to the nearest feature"""
+        rows = self.matrix(nprocs=1)
+        self.assertTrue(rows)
+        nearest = {}
+        for fcat, tcat, cost in rows:
+            self.assertIn(tcat, range(100, 201))
+            if fcat not in nearest or cost < nearest[fcat]:
+                nearest[fcat] = cost
+
+        table = read_command(
+            "v.db.select", map=self.output, columns="cat,dist", flags="c"
+        ).splitlines()
+        self.assertEqual(len(table), len(nearest))
+        for line in table:
+            cat, dist = line.split("|")
+            self.assertAlmostEqual(nearest[int(cat)], float(dist), places=4)
+
+    def test_matrix_nprocs(self):
+        """Matrix with nprocs>1 equals the matrix with nprocs=1"""
+        self.assertEqual(self.matrix(nprocs=4), self.matrix(nprocs=1))
+
+
+if __name__ == "__main__":
+    test()
@@ -9,10 +9,10 @@ typedef struct {
     int edge;    /* edge to follow from this node */
 } NODE;
 
-int alloc_from_centers_loop_tt(struct Map_info *Map, NODE *Nodes,
-                               CENTER *Centers, int ncenters, int tucfield);
-int alloc_to_centers_loop_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
-                             int ncenters, int tucfield);
+int alloc_from_centers_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
+                          int ncenters, int tucfield);
+int alloc_to_centers_tt(struct Map_info *Map, NODE *Nodes, CENTER *Centers,
+                        int ncenters, int tucfield);
 
 int alloc_from_centers(dglGraph_s *graph, NODE *Nodes, CENTER *Centers,
                        int ncenters);
@@ -0,0 +1,18 @@
+#include <grass/gis.h>
+#include <grass/vector.h>
+
+/* segments of iso bands to be written to raster map */
+struct iso_raster {
+    int nlines, alines;
+    int *band;         /* number of iso band (category) of segment */
+    int *first;        /* index of first point of segment, nlines + 1 */
+    double *ymin, *ymax;
+    int npoints, apoints;
+    double *x, *y;
+};
+
+/* raster.c */
+void iso_raster_init(struct iso_raster *);
+void iso_raster_add(struct iso_raster *, const struct line_pnts *, int);
+void iso_raster_write(struct iso_raster *, const char *, int, char **, int);
+void iso_raster_free(struct iso_raster *);
@@ -8,7 +8,7 @@
  *
  * PURPOSE:      Split net to bands between isolines.
  *
- * COPYRIGHT:    (C) 2001-2008,2014,2017 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2001-2008,2014,2017,2026 by the GRASS Development Team
  *
  *               This program is free software under the
  *               GNU General Public License (>=v2).
@@ -24,6 +24,7 @@
 #include <grass/dbmi.h>
 #include <grass/glocale.h>
 #include "alloc.h"
+#include "local_proto.h"
 
 typedef struct {     /* iso point along the line */
     int iso;         /* index of iso line in iso array of costs */
@@ -41,7 +42,8 @@ int main(int argc, char **argv)
     double e1cost, e2cost, n1cost, n2cost, s1cost, s2cost, l, l1;
     struct Option *map, *output, *method_opt;
     struct Option *afield_opt, *nfield_opt, *afcol, *abcol, *ncol, *type_opt,
-        *term_opt, *cost_opt, *tfield_opt, *tucfield_opt;
+        *term_opt, *cost_opt, *tfield_opt, *tucfield_opt, *raster_opt,
+        *nprocs_opt;
     struct Flag *geo_f, *turntable_f, *ucat_f;
     struct GModule *module;
     struct Map_info Map, Out;
@@ -59,6 +61,8 @@ int main(int argc, char **argv)
     int npnts1, apnts1 = 0, npnts2, apnts2 = 0;
     ISOPOINT *pnts1 = NULL, *pnts2 = NULL;
     int next_iso;
+    int nprocs;
+    struct iso_raster rast;
 
     /* Attribute table */
     int unique_cats, ucat, ocat, n;
@@ -76,6 +80,7 @@ int main(int argc, char **argv)
     G_add_keyword(_("network"));
     G_add_keyword(_("cost allocation"));
     G_add_keyword(_("isolines"));
+    G_add_keyword(_("parallel"));
     module->label = _("Splits subnets for nearest centers by cost isolines.");
     module->description =
         _("Splits net to bands between cost isolines (direction from center). "
@@ -168,6 +173,15 @@ int main(int argc, char **argv)
     geo_f->description =
         _("Use geodesic calculation for longitude-latitude projects");
 
+    raster_opt = G_define_standard_option(G_OPT_R_OUTPUT);
+    raster_opt->key = "raster";
+    raster_opt->required = NO;
+    raster_opt->label = _("Name for output raster map with iso bands");
+    raster_opt->description =
+        _("Cells on the network get the category of the iso band");
+
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     ucat_f = G_define_flag();
     ucat_f->key = 'u';
     ucat_f->label = _("Create unique categories and attribute table");
@@ -176,6 +190,8 @@ int main(int argc, char **argv)
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     Vect_check_input_output_name(map->answer, output->answer, G_FATAL_EXIT);
 
     Cats = Vect_new_cats_struct();
@@ -309,7 +325,7 @@ int main(int argc, char **argv)
         /* if turntable is used we are looking for lines as destinations,
          * instead of the intersections (nodes) */
         Nodes = (NODE *)G_calloc((nlines * 2 + 2), sizeof(NODE));
-        for (i = 2; i <= (nlines * 2 + 2); i++) {
+        for (i = 2; i < (nlines * 2 + 2); i++) {
             Nodes[i].center =
                 -1; /* NOTE: first two items of Nodes are not used */
         }
@@ -326,12 +342,11 @@ int main(int argc, char **argv)
     if (turntable_f->answer) {
         if (from_centers) {
             G_message(_("Calculating costs from centers ..."));
-            alloc_from_centers_loop_tt(&Map, Nodes, Centers, ncenters,
-                                       tucfield);
+            alloc_from_centers_tt(&Map, Nodes, Centers, ncenters, tucfield);
         }
         else {
             G_message(_("Calculating costs to centers ..."));
-            alloc_to_centers_loop_tt(&Map, Nodes, Centers, ncenters, tucfield);
+            alloc_to_centers_tt(&Map, Nodes, Centers, ncenters, tucfield);
         }
     }
     else {
@@ -399,6 +414,9 @@ int main(int argc, char **argv)
         db_begin_transaction(driver);
     }
 
+    if (raster_opt->answer)
+        iso_raster_init(&rast);
+
     G_message(_("Generating isolines..."));
     apnts1 = 1;
     pnts1 = (ISOPOINT *)G_malloc(apnts1 * sizeof(ISOPOINT));
@@ -727,6 +745,8 @@ int main(int argc, char **argv)
                     else
                         Vect_cat_set(Cats, 1, cat);
                     Vect_write_line(&Out, ltype, SPoints, Cats);
+                    if (raster_opt->answer)
+                        iso_raster_add(&rast, SPoints, cat);
                 }
             }
         }
@@ -767,6 +787,11 @@ int main(int argc, char **argv)
 
     Vect_build(&Out);
 
+    if (raster_opt->answer) {
+        iso_raster_write(&rast, raster_opt->answer, niso, isolbl, nprocs);
+        iso_raster_free(&rast);
+    }
+
     /* Free, ... */
     G_free(Nodes);
     G_free(Centers);
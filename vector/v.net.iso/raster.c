@@ -0,0 +1,185 @@
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <math.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* rows of one block rasterized by one thread */
+#define BLOCK_ROWS 64
+
+void iso_raster_init(struct iso_raster *rast)
+{
+    G_zero(rast, sizeof(struct iso_raster));
+    rast->alines = 1024;
+    rast->band = G_malloc(rast->alines * sizeof(int));
+    rast->first = G_malloc((rast->alines + 1) * sizeof(int));
+    rast->ymin = G_malloc(rast->alines * sizeof(double));
+    rast->ymax = G_malloc(rast->alines * sizeof(double));
+    rast->first[0] = 0;
+}
+
+/* keep segment of iso band */
+void iso_raster_add(struct iso_raster *rast, const struct line_pnts *Points,
+                    int band)
+{
+    int i, n;
+
+    if (Points->n_points < 1)
+        return;
+
+    if (rast->nlines == rast->alines) {
+        rast->alines *= 2;
+        rast->band = G_realloc(rast->band, rast->alines * sizeof(int));
+        rast->first =
+            G_realloc(rast->first, (rast->alines + 1) * sizeof(int));
+        rast->ymin = G_realloc(rast->ymin, rast->alines * sizeof(double));
+        rast->ymax = G_realloc(rast->ymax, rast->alines * sizeof(double));
+    }
+    if (rast->npoints + Points->n_points > rast->apoints) {
+        rast->apoints = 2 * (rast->npoints + Points->n_points);
+        rast->x = G_realloc(rast->x, rast->apoints * sizeof(double));
+        rast->y = G_realloc(rast->y, rast->apoints * sizeof(double));
+    }
+
+    n = rast->nlines;
+    rast->band[n] = band;
+    rast->ymin[n] = rast->ymax[n] = Points->y[0];
+    for (i = 0; i < Points->n_points; i++) {
+        rast->x[rast->npoints + i] = Points->x[i];
+        rast->y[rast->npoints + i] = Points->y[i];
+        if (Points->y[i] < rast->ymin[n])
+            rast->ymin[n] = Points->y[i];
+        if (Points->y[i] > rast->ymax[n])
+            rast->ymax[n] = Points->y[i];
+    }
+    rast->npoints += Points->n_points;
+    rast->nlines++;
+    rast->first[rast->nlines] = rast->npoints;
+}
+
+/* set cells of rows row0 to row1 - 1 touched by the segments, lower iso
+ * bands (nearer to centers) win */
+static void plot_block(const struct iso_raster *rast,
+                       const struct Cell_head *window, int row0, int row1,
+                       CELL *buf)
+{
+    int i, j, k, nsteps, row, col;
+    double north, south, x0, y0, x1, y1, t;
+    CELL *cell;
+
+    Rast_set_c_null_value(buf, (row1 - row0) * window->cols);
+
+    north = window->north - row0 * window->ns_res;
+    south = window->north - row1 * window->ns_res;
+
+    for (i = 0; i < rast->nlines; i++) {
+        if (rast->ymax[i] < south || rast->ymin[i] > north)
+            continue;
+
+        for (j = rast->first[i]; j < rast->first[i + 1]; j++) {
+            x0 = x1 = rast->x[j];
+            y0 = y1 = rast->y[j];
+            if (j + 1 < rast->first[i + 1]) {
+                x1 = rast->x[j + 1];
+                y1 = rast->y[j + 1];
+            }
+            else if (j > rast->first[i])
+                break; /* last point was plotted with previous piece */
+            if ((y0 < south && y1 < south) || (y0 > north && y1 > north))
+                continue;
+
+            /* sample the piece at least twice per cell */
+            nsteps = 2 * (int)ceil(fmax(fabs(x1 - x0) / window->ew_res,
+                                        fabs(y1 - y0) / window->ns_res));
+            for (k = 0; k <= nsteps; k++) {
+                t = nsteps > 0 ? (double)k / nsteps : 0;
+                row = (int)floor((window->north - (y0 + t * (y1 - y0))) /
+                                 window->ns_res);
+                col = (int)floor((x0 + t * (x1 - x0) - window->west) /
+                                 window->ew_res);
+                if (row < row0 || row >= row1 || col < 0 ||
+                    col >= window->cols)
+                    continue;
+                cell = &buf[(size_t)(row - row0) * window->cols + col];
+                if (Rast_is_c_null_value(cell) || *cell > rast->band[i])
+                    *cell = rast->band[i];
+            }
+        }
+    }
+}
+
+/* write iso bands to raster map in the current region, blocks of rows are
+ * rasterized in parallel */
+void iso_raster_write(struct iso_raster *rast, const char *name, int niso,
+                      char **isolbl, int nprocs)
+{
+    int fd, row, row0, nblocks, i;
+    size_t block_size;
+    struct Cell_head window;
+    struct Categories cats;
+    struct History history;
+    CELL *buf;
+
+    G_message(_("Writing raster map <%s>..."), name);
+
+    Rast_get_window(&window);
+    fd = Rast_open_c_new(name);
+
+    nblocks = 4 * nprocs;
+    block_size = (size_t)BLOCK_ROWS * window.cols;
+    buf = G_malloc(nblocks * block_size * sizeof(CELL));
+
+    for (row0 = 0; row0 < window.rows; row0 += nblocks * BLOCK_ROWS) {
+        int n = (window.rows - row0 + BLOCK_ROWS - 1) / BLOCK_ROWS;
+
+        if (n > nblocks)
+            n = nblocks;
+
+        G_percent(row0, window.rows, 2);
+
+#pragma omp parallel for num_threads(nprocs) if (nprocs > 1) \
+    schedule(dynamic)
+        for (i = 0; i < n; i++) {
+            int r0 = row0 + i * BLOCK_ROWS;
+            int r1 = r0 + BLOCK_ROWS;
+
+            if (r1 > window.rows)
+                r1 = window.rows;
+            plot_block(rast, &window, r0, r1, buf + i * block_size);
+        }
+
+        for (row = row0; row < row0 + nblocks * BLOCK_ROWS; row++) {
+            if (row >= window.rows)
+                break;
+            Rast_put_c_row(fd, buf + (size_t)(row - row0) * window.cols);
+        }
+    }
+    G_percent(1, 1, 1);
+
+    G_free(buf);
+    Rast_close(fd);
+
+    Rast_init_cats(NULL, &cats);
+    for (i = 1; i <= niso; i++)
+        Rast_set_c_cat(&i, &i, isolbl[i - 1], &cats);
+    Rast_write_cats(name, &cats);
+    Rast_free_cats(&cats);
+
+    Rast_short_history(name, "raster", &history);
+    Rast_command_history(&history);
+    Rast_write_history(name, &history);
+}
+
+void iso_raster_free(struct iso_raster *rast)
+{
+    G_free(rast->band);
+    G_free(rast->first);
+    G_free(rast->ymin);
+    G_free(rast->ymax);
+    G_free(rast->x);
+    G_free(rast->y);
+}
@@ -0,0 +1,128 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import parse_command, read_command
+
+COSTS = "1000,2000,5000"
+
+
+def lengths(name):
+    """Total length of network in each iso band"""
+    rows = read_command(
+        "v.to.db", map=name, option="length", flags="p", separator="pipe"
+    ).splitlines()
+    result = {}
+    for row in rows[1:]:
+        cat, length = row.split("|")
+        result[int(cat)] = float(length)
+    return result
+
+
+class TestVNetIso(TestCase):
+    network = "test_vnet_iso"
+    turntable = "test_vnet_iso_tt"
+    output = "test_vnet_iso_out"
+    output_tt = "test_vnet_iso_out_tt"
+    rasters = [
+        "test_vnet_iso_rast",
+        "test_vnet_iso_rast_tt",
+        "test_vnet_iso_rast_nprocs",
+        "test_vnet_iso_rast_ref",
+        "test_vnet_iso_rast_diff",
+    ]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "v.net",
+            input="streets",
+            points="schools",
+            output=cls.network,
+            operation="connect",
+            threshold=1000,
+        )
+        cls.runModule(
+            "v.net", input=cls.network, output=cls.turntable, operation="turntable"
+        )
+        cls.runModule("g.region", vector=cls.network, res=20, flags="a")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove",
+            flags="f",
+            type="vector",
+            name=[cls.network, cls.turntable, cls.output, cls.output_tt],
+        )
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.rasters)
+        cls.del_temp_region()
+
+    def iso(self, output, raster, flags="", nprocs=1):
+        self.assertModule(
+            "v.net.iso",
+            input=self.turntable if "t" in flags else self.network,
+            output=output,
+            center_cats="1-20",
+            costs=COSTS,
+            raster=raster,
+            flags=flags,
+            nprocs=nprocs,
+            overwrite=True,
+        )
+
+    def test_turntable(self):
+        """Search from all centers on the turntable gives the same bands
+
+        The turntable of v.net allows every turn at no cost, so the bands
+        must be the same as without the turntable.
+        """
+        self.iso(self.output, self.rasters[0])
+        self.iso(self.output_tt, self.rasters[1], flags="t")
+        reference = lengths(self.output)
+        result = lengths(self.output_tt)
+        self.assertEqual(len(reference), 4)
+        self.assertEqual(reference.keys(), result.keys())
+        for cat, length in reference.items():
+            self.assertAlmostEqual(result[cat], length, delta=1e-6 * length)
+        self.assertRastersNoDifference(
+            self.rasters[1], reference=self.rasters[0], precision=0
+        )
+
+    def test_raster(self):
+        """Raster output against the rasterized vector output"""
+        self.iso(self.output, self.rasters[0])
+        self.assertRasterMinMax(self.rasters[0], refmin=1, refmax=4)
+
+        # the same in parallel
+        self.iso(self.output, self.rasters[2], nprocs=4)
+        self.assertRastersNoDifference(
+            self.rasters[2], reference=self.rasters[0], precision=0
+        )
+
+        # cells of the network, v.to.rast keeps the last band written to a
+        # cell while the raster output keeps the lowest one, and lines are
+        # rasterized in a different way, so allow a few cells to differ
+        self.runModule(
+            "v.to.rast",
+            input=self.output,
+            output=self.rasters[3],
+            use="cat",
+            type="line",
+            overwrite=True,
+        )
+        self.runModule(
+            "r.mapcalc",
+            expression=f"{self.rasters[4]} = "
+            f"if(isnull({self.rasters[0]}) != isnull({self.rasters[3]}), 1, "
+            f"if(!isnull({self.rasters[0]}) && "
+            f"{self.rasters[0]} > {self.rasters[3]}, 2, 0))",
+            overwrite=True,
+        )
+        stats = parse_command("r.univar", map=self.rasters[4], flags="g")
+        cells = int(parse_command("r.univar", map=self.rasters[3], flags="g")["n"])
+        differ = float(stats["mean"]) * int(stats["n"])
+        self.assertLess(differ, 0.02 * cells)
+
+
+if __name__ == "__main__":
+    test()
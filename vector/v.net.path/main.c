@@ -7,7 +7,7 @@
  *
  * PURPOSE:      Shortest path on vector network
  *
- * COPYRIGHT:    (C) 2002, 2014 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2002-2026 by the GRASS Development Team
  *
  *               This program is free software under the
  *               GNU General Public License (>=v2).
@@ -28,7 +28,7 @@ int main(int argc, char **argv)
     struct Option *input_opt, *output_opt, *afield_opt, *nfield_opt,
         *tfield_opt, *tucfield_opt, *afcol, *abcol, *ncol, *type_opt;
     struct Option *max_dist, *file_opt;
-    struct Flag *geo_f, *segments_f, *turntable_f;
+    struct Flag *geo_f, *segments_f, *turntable_f, *ch_f, *csr_f;
     struct GModule *module;
     struct Map_info In, Out;
     int type, afield, nfield, tfield, tucfield, geo;
@@ -135,6 +135,20 @@ int main(int argc, char **argv)
     segments_f->description = _("Write output as original input segments, "
                                 "not each path as one line.");
 
+    ch_f = G_define_flag();
+    ch_f->key = 'c';
+    ch_f->label = _("Use contraction hierarchy");
+    ch_f->description = _("Faster for many paths, the index is saved with "
+                          "the input map and reused");
+
+    csr_f = G_define_flag();
+    csr_f->key = 'r';
+    csr_f->label = _("Use compact graph");
+    csr_f->description = _("Needs less memory, the graph is saved with the "
+                           "input map and reused");
+
+    G_option_exclusive(turntable_f, ch_f, csr_f, NULL);
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
@@ -172,9 +186,17 @@ int main(int argc, char **argv)
         Vect_net_ttb_build_graph(&In, type, afield, nfield, tfield, tucfield,
                                  afcol->answer, abcol->answer, ncol->answer,
                                  geo, 0);
-    else
+    else if (csr_f->answer) {
+        if (Vect_net_build_csr(&In, type, afield, nfield, afcol->answer,
+                               abcol->answer, ncol->answer, geo) != 0)
+            G_fatal_error(_("Unable to build graph"));
+    }
+    else {
         Vect_net_build_graph(&In, type, afield, nfield, afcol->answer,
                              abcol->answer, ncol->answer, geo, 0);
+        if (ch_f->answer && Vect_net_build_ch(&In) != 0)
+            G_warning(_("Searching paths without contraction hierarchy"));
+    }
 
     path(&In, &Out, file_opt->answer, nfield, maxdist, segments_f->answer,
          tucfield, turntable_f->answer);
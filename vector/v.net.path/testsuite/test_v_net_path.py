@@ -0,0 +1,70 @@
+import os
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.script.core import read_command, tempfile
+
+
+class TestVNetPathCSR(TestCase):
+    network = "test_vnet_path"
+    output = "test_vnet_path_out"
+    output_csr = "test_vnet_path_out_csr"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "v.net",
+            input="streets",
+            points="schools",
+            output=cls.network,
+            operation="connect",
+            threshold=1000,
+        )
+        # paths between pairs of schools, id from_cat to_cat
+        cls.pairs = tempfile()
+        with open(cls.pairs, "w") as fp:
+            for i in range(1, 21):
+                fp.write(f"{i} {i} {i + 40}\n")
+
+    @classmethod
+    def tearDownClass(cls):
+        os.remove(cls.pairs)
+        cls.runModule("g.remove", flags="f", type="vector", name=cls.network)
+        cls.del_temp_region()
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove", flags="f", type="vector", name=[self.output, self.output_csr]
+        )
+
+    def path(self, output, flags=""):
+        """Costs and lengths of paths by id"""
+        self.assertModule(
+            "v.net.path",
+            input=self.network,
+            output=output,
+            file=self.pairs,
+            flags=flags,
+            overwrite=True,
+        )
+        costs = read_command(
+            "v.db.select", map=output, columns="id,fcat,tcat,sp,cost", flags="c"
+        ).splitlines()
+        lengths = read_command(
+            "v.to.db", map=output, option="length", flags="p", separator="pipe"
+        ).splitlines()
+        return sorted(costs), sorted(lengths)
+
+    def test_csr(self):
+        """Compact graph gives the same costs and paths as the default graph"""
+        costs, lengths = self.path(self.output)
+        self.assertEqual(len(costs), 20)
+        self.assertEqual(self.path(self.output_csr, flags="r"), (costs, lengths))
+
+        # the saved graph is reused
+        self.assertEqual(self.path(self.output_csr, flags="r"), (costs, lengths))
+
+
+if __name__ == "__main__":
+    test()
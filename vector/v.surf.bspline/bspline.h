@@ -41,6 +41,21 @@ struct SubZone {
     int col;
 };
 
+/* least squares problem of one subregion */
+struct Subregion {
+    int row, col;         /* position in the grid of subregions */
+    struct Cell_head reg; /* elaboration region */
+    struct bound_box general, overlap;
+    int nsplx, nsply;
+    int npoints;      /* observations */
+    double **obsVect; /* x, y, z - mean */
+    int *lineVect;    /* primitive ids of observations */
+    double mean;
+    int npoints_ext; /* points to interpolate, if not on the grid */
+    struct Point *observ_ext;
+    double *parVect; /* spline parameters, solution */
+};
+
 /*-------------------------------------------------------------------------------------------*/
 /*FUNCTIONS*/
 /* CrossCorrelation.c */
@@ -79,3 +94,7 @@ int align_elaboration_box(struct Cell_head *, struct Cell_head *, int);
 int align_interp_boxes(struct bound_box *, struct bound_box *,
                        struct Cell_head *, struct bound_box, struct bound_box,
                        int);
+
+/* solve.c */
+void solve_subregions(struct Subregion *, int, int, double, double, double,
+                      int, int, double, int);
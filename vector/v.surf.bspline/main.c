@@ -7,8 +7,9 @@
  *
  * PURPOSE:      Spline Interpolation
  *
- * COPYRIGHT:    (C) 2006 by Politecnico di Milano -
+ * COPYRIGHT:    (C) 2006-2026 by Politecnico di Milano -
  *                             Polo Regionale di Como
+ *                             and the GRASS Development Team
  *
  *               This program is free software under the
  *               GNU General Public License (>=v2).
@@ -33,6 +34,27 @@
 int bspline_field;
 char *bspline_column;
 
+/* write rows from row to endrow - 1 of the output segment, they are not
+ * touched by the remaining subregions, returns the next row to write */
+static int write_rows(SEGMENT *out_seg, int fd, int row, int endrow, int nrows)
+{
+    DCELL *drastbuf;
+
+    if (endrow > nrows)
+        endrow = nrows;
+    if (row >= endrow)
+        return row;
+
+    drastbuf = Rast_allocate_d_buf();
+    for (; row < endrow; row++) {
+        Segment_get_row(out_seg, drastbuf, row);
+        Rast_put_d_row(fd, drastbuf);
+    }
+    G_free(drastbuf);
+
+    return row;
+}
+
 /*--------------------------------------------------------------------*/
 int main(int argc, char *argv[])
 {
@@ -49,10 +71,11 @@ int main(int argc, char *argv[])
     char table_name[GNAME_MAX + 64], title[64];
     char xname[GNAME_MAX], xmapset[GMAPSET_MAX];
 
-    int dim_vect, nparameters, BW;
-    int *lineVect;            /* Vector restoring primitive's ID */
-    double *TN, *Q, *parVect; /* Interpolating and least-square vectors */
-    double **N, **obsVect;    /* Interpolation and least-square matrix */
+    int dim_vect;
+    int *lineVect;    /* Vector restoring primitive's ID */
+    double **obsVect; /* Observations */
+    struct Subregion *subs;
+    int asub, out_row, nprocs;
 
     SEGMENT out_seg, mask_seg;
     char *out_file, *mask_file;
@@ -68,7 +91,7 @@ int main(int argc, char *argv[])
     struct GModule *module;
     struct Option *in_opt, *in_ext_opt, *out_opt, *out_map_opt, *stepE_opt,
         *stepN_opt, *lambda_f_opt, *type_opt, *dfield_opt, *col_opt, *mask_opt,
-        *memory_opt, *solver, *error, *iter;
+        *memory_opt, *solver, *error, *iter, *nprocs_opt;
     struct Flag *cross_corr_flag, *spline_step_flag;
 
     struct Reg_dimens dims;
@@ -91,6 +114,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("surface"));
     G_add_keyword(_("interpolation"));
     G_add_keyword(_("LIDAR"));
+    G_add_keyword(_("parallel"));
     module->description = _("Performs bicubic or bilinear spline interpolation "
                             "with Tykhonov regularization.");
 
@@ -190,12 +214,16 @@ int main(int argc, char *argv[])
 
     memory_opt = G_define_standard_option(G_OPT_MEMORYMB);
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     /*----------------------------------------------------------------*/
     /* Parsing */
     G_gisinit(argv[0]);
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     vector = out_opt->answer;
     map = out_map_opt->answer;
 
@@ -571,11 +599,18 @@ int main(int argc, char *argv[])
     Cats = Vect_new_cats_struct();
     Vect_cat_set(Cats, 1, 0);
 
+    /* subregions of one row */
+    asub = nsubregion_col > 0 ? nsubregion_col : 1;
+    subs = G_malloc(asub * sizeof(struct Subregion));
+
     subregion_row = 0;
     elaboration_reg.south = original_reg.north;
     last_row = FALSE;
+    out_row = 0;
 
     while (last_row == FALSE) { /* For each subregion row */
+        int nsub = 0;
+
         subregion_row++;
         P_set_regions(&elaboration_reg, &general_box, &overlap_box, dims,
                       GENERAL_ROW);
@@ -593,6 +628,17 @@ int main(int argc, char *argv[])
             last_row = TRUE;
         }
 
+        /* rows north of this subregion row are complete */
+        if (grid == TRUE) {
+            int row = 0;
+
+            if (original_reg.north > general_box.N)
+                row = (original_reg.north - general_box.N) /
+                          original_reg.ns_res -
+                      1;
+            out_row = write_rows(&out_seg, raster, out_row, row, nrows);
+        }
+
         nsply =
             ceil((elaboration_reg.north - elaboration_reg.south) / stepN) + 0.5;
         G_debug(1, "Interpolation: nsply = %d", nsply);
@@ -604,23 +650,20 @@ int main(int argc, char *argv[])
         last_column = FALSE;
         subregion_col = 0;
 
-        /* TODO: process each subregion using its own thread (via OpenMP or
-         * pthreads) */
-        /*     I'm not sure about pthreads, but you can tell OpenMP to start all
-           at the same time and it will keep num_workers supplied with the next
-           job as free cpus become available */
+        /* read the observations of all subregions of this row, solve them
+         * in parallel and write results in the order of subregions
+         * because of the overlaps */
         while (last_column == FALSE) { /* For each subregion column */
             int npoints = 0;
 
             /* needed for sparse points interpolation */
-            int npoints_ext, *lineVect_ext = NULL;
-            double **obsVect_ext; /*, mean_ext = .0; */
+            int npoints_ext;
             struct Point *observ_ext;
 
             subregion_col++;
             subregion++;
             if (nsubregions > 1)
-                G_message(_("Processing subregion %d of %d..."), subregion,
+                G_message(_("Reading subregion %d of %d..."), subregion,
                           nsubregions);
 
             P_set_regions(&elaboration_reg, &general_box, &overlap_box, dims,
@@ -709,23 +752,31 @@ int main(int argc, char *argv[])
             /* only interpolate if there are any points in current subregion */
             if (npoints > 0 && npoints_ext > 0) {
                 int i;
+                struct Subregion *sub;
 
-                nparameters = nsplx * nsply;
-                BW = P_get_BandWidth(bilin, nsply);
-
-                /* Least Squares system */
-                N = G_alloc_matrix(nparameters, BW);   /* Normal matrix */
-                TN = G_alloc_vector(nparameters);      /* vector */
-                parVect = G_alloc_vector(nparameters); /* Parameters vector */
-                obsVect = G_alloc_matrix(npoints, 3);  /* Observation vector */
-                Q = G_alloc_vector(npoints); /* "a priori" var-cov matrix */
-                lineVect = G_alloc_ivector(npoints); /*  */
-
-                for (i = 0; i < npoints;
-                     i++) { /* Setting obsVect vector & Q matrix */
+                if (nsub == asub) {
+                    asub *= 2;
+                    subs = G_realloc(subs, asub * sizeof(struct Subregion));
+                }
+                sub = &subs[nsub++];
+                sub->row = subregion_row;
+                sub->col = subregion_col;
+                sub->reg = elaboration_reg;
+                sub->general = general_box;
+                sub->overlap = overlap_box;
+                sub->nsplx = nsplx;
+                sub->nsply = nsply;
+                sub->npoints = npoints;
+                sub->npoints_ext = npoints_ext;
+                sub->observ_ext = observ_ext;
+                sub->parVect = NULL;
+
+                obsVect = G_alloc_matrix(npoints, 3); /* Observation vector */
+                lineVect = G_alloc_ivector(npoints);  /*  */
+
+                for (i = 0; i < npoints; i++) { /* Setting obsVect vector */
                     double dval;
 
-                    Q[i] = 1; /* Q=I */
                     lineVect[i] = observ[i].lineID;
                     obsVect[i][0] = observ[i].coordX;
                     obsVect[i][1] = observ[i].coordY;
@@ -774,115 +825,9 @@ int main(int argc, char *argv[])
                 for (i = 0; i < npoints; i++)
                     obsVect[i][2] -= mean;
 
-                /* Bilinear interpolation */
-                if (bilin) {
-                    G_debug(1,
-                            "Interpolation: (%d,%d): Bilinear interpolation...",
-                            subregion_row, subregion_col);
-                    normalDefBilin(N, TN, Q, obsVect, stepE, stepN, nsplx,
-                                   nsply, elaboration_reg.west,
-                                   elaboration_reg.south, npoints, nparameters,
-                                   BW);
-                    nCorrectGrad(N, lambda, nsplx, nsply, stepE, stepN);
-                }
-                /* Bicubic interpolation */
-                else {
-                    G_debug(1,
-                            "Interpolation: (%d,%d): Bicubic interpolation...",
-                            subregion_row, subregion_col);
-                    normalDefBicubic(N, TN, Q, obsVect, stepE, stepN, nsplx,
-                                     nsply, elaboration_reg.west,
-                                     elaboration_reg.south, npoints,
-                                     nparameters, BW);
-                    nCorrectGrad(N, lambda, nsplx, nsply, stepE, stepN);
-                }
-
-                if (G_strncasecmp(solver->answer, "cg", 2) == 0)
-                    G_math_solver_cg_sband(N, parVect, TN, nparameters, BW,
-                                           atoi(iter->answer),
-                                           atof(error->answer));
-                else
-                    G_math_solver_cholesky_sband(N, parVect, TN, nparameters,
-                                                 BW);
-
-                G_free_matrix(N);
-                G_free_vector(TN);
-                G_free_vector(Q);
-
-                if (grid == TRUE) { /* GRID INTERPOLATION ==> INTERPOLATION INTO
-                                       A RASTER */
-                    G_debug(1, "Interpolation: (%d,%d): Regular_Points...",
-                            subregion_row, subregion_col);
-
-                    if (!have_mask) {
-                        P_Regular_Points(&elaboration_reg, &original_reg,
-                                         general_box, overlap_box, &out_seg,
-                                         parVect, stepN, stepE, dims.overlap,
-                                         mean, nsplx, nsply, nrows, ncols,
-                                         bilin);
-                    }
-                    else {
-                        P_Sparse_Raster_Points(
-                            &out_seg, &elaboration_reg, &original_reg,
-                            general_box, overlap_box, observ_ext, parVect,
-                            stepE, stepN, dims.overlap, nsplx, nsply,
-                            npoints_ext, bilin, mean);
-                    }
-                }
-                else { /* OBSERVATION POINTS INTERPOLATION */
-                    if (ext == FALSE) {
-                        G_debug(1, "Interpolation: (%d,%d): Sparse_Points...",
-                                subregion_row, subregion_col);
-                        P_Sparse_Points(&Out, &elaboration_reg, general_box,
-                                        overlap_box, obsVect, parVect, lineVect,
-                                        stepE, stepN, dims.overlap, nsplx,
-                                        nsply, npoints, bilin, Cats, driver,
-                                        mean, table_name);
-                    }
-                    else { /* FLAG_EXT == TRUE */
-
-                        /* done that earlier */
-                        /*
-                           int npoints_ext, *lineVect_ext = NULL;
-                           double **obsVect_ext;
-                           struct Point *observ_ext;
-
-                           observ_ext =
-                           P_Read_Vector_Region_Map(&In_ext,
-                           &elaboration_reg,
-                           &npoints_ext, dim_vect,
-                           1);
-                         */
-
-                        obsVect_ext = G_alloc_matrix(
-                            npoints_ext, 3); /* Observation vector_ext */
-                        lineVect_ext = G_alloc_ivector(npoints_ext);
-
-                        for (i = 0; i < npoints_ext;
-                             i++) { /* Setting obsVect_ext vector & Q matrix */
-                            obsVect_ext[i][0] = observ_ext[i].coordX;
-                            obsVect_ext[i][1] = observ_ext[i].coordY;
-                            obsVect_ext[i][2] = observ_ext[i].coordZ - mean;
-                            lineVect_ext[i] = observ_ext[i].lineID;
-                        }
-
-                        G_free(observ_ext);
-
-                        G_debug(1, "Interpolation: (%d,%d): Sparse_Points...",
-                                subregion_row, subregion_col);
-                        P_Sparse_Points(&Out, &elaboration_reg, general_box,
-                                        overlap_box, obsVect_ext, parVect,
-                                        lineVect_ext, stepE, stepN,
-                                        dims.overlap, nsplx, nsply, npoints_ext,
-                                        bilin, Cats, driver, mean, table_name);
-
-                        G_free_matrix(obsVect_ext);
-                        G_free_ivector(lineVect_ext);
-                    } /* END FLAG_EXT == TRUE */
-                } /* END GRID == FALSE */
-                G_free_vector(parVect);
-                G_free_matrix(obsVect);
-                G_free_ivector(lineVect);
+                sub->obsVect = obsVect;
+                sub->lineVect = lineVect;
+                sub->mean = mean;
             }
             else {
                 if (observ)
@@ -894,28 +839,93 @@ int main(int argc, char *argv[])
                                 "Consider increasing spline step values."));
             }
         } /*! END WHILE; last_column = TRUE */
+
+        if (nsub > 0)
+            G_message(_("Solving %d subregions..."), nsub);
+        solve_subregions(subs, nsub, bilin, lambda, stepE, stepN,
+                         G_strncasecmp(solver->answer, "cg", 2) == 0,
+                         atoi(iter->answer), atof(error->answer), nprocs);
+
+        for (subregion_col = 0; subregion_col < nsub; subregion_col++) {
+            struct Subregion *sub = &subs[subregion_col];
+
+            if (grid == TRUE) { /* GRID INTERPOLATION ==> INTERPOLATION INTO
+                                   A RASTER */
+                G_debug(1, "Interpolation: (%d,%d): Regular_Points...",
+                        sub->row, sub->col);
+
+                if (!have_mask) {
+                    P_Regular_Points(&sub->reg, &original_reg, sub->general,
+                                     sub->overlap, &out_seg, sub->parVect,
+                                     stepN, stepE, dims.overlap, sub->mean,
+                                     sub->nsplx, sub->nsply, nrows, ncols,
+                                     bilin);
+                }
+                else {
+                    P_Sparse_Raster_Points(
+                        &out_seg, &sub->reg, &original_reg, sub->general,
+                        sub->overlap, sub->observ_ext, sub->parVect, stepE,
+                        stepN, dims.overlap, sub->nsplx, sub->nsply,
+                        sub->npoints_ext, bilin, sub->mean);
+                    G_free(sub->observ_ext);
+                }
+            }
+            else { /* OBSERVATION POINTS INTERPOLATION */
+                if (ext == FALSE) {
+                    G_debug(1, "Interpolation: (%d,%d): Sparse_Points...",
+                            sub->row, sub->col);
+                    P_Sparse_Points(&Out, &sub->reg, sub->general,
+                                    sub->overlap, sub->obsVect, sub->parVect,
+                                    sub->lineVect, stepE, stepN, dims.overlap,
+                                    sub->nsplx, sub->nsply, sub->npoints, bilin,
+                                    Cats, driver, sub->mean, table_name);
+                }
+                else { /* FLAG_EXT == TRUE */
+                    int i, npoints_ext = sub->npoints_ext, *lineVect_ext;
+                    double **obsVect_ext;
+
+                    obsVect_ext = G_alloc_matrix(
+                        npoints_ext, 3); /* Observation vector_ext */
+                    lineVect_ext = G_alloc_ivector(npoints_ext);
+
+                    for (i = 0; i < npoints_ext;
+                         i++) { /* Setting obsVect_ext vector */
+                        obsVect_ext[i][0] = sub->observ_ext[i].coordX;
+                        obsVect_ext[i][1] = sub->observ_ext[i].coordY;
+                        obsVect_ext[i][2] =
+                            sub->observ_ext[i].coordZ - sub->mean;
+                        lineVect_ext[i] = sub->observ_ext[i].lineID;
+                    }
+
+                    G_free(sub->observ_ext);
+
+                    G_debug(1, "Interpolation: (%d,%d): Sparse_Points...",
+                            sub->row, sub->col);
+                    P_Sparse_Points(&Out, &sub->reg, sub->general,
+                                    sub->overlap, obsVect_ext, sub->parVect,
+                                    lineVect_ext, stepE, stepN, dims.overlap,
+                                    sub->nsplx, sub->nsply, npoints_ext, bilin,
+                                    Cats, driver, sub->mean, table_name);
+
+                    G_free_matrix(obsVect_ext);
+                    G_free_ivector(lineVect_ext);
+                } /* END FLAG_EXT == TRUE */
+            } /* END GRID == FALSE */
+            G_free_vector(sub->parVect);
+            G_free_matrix(sub->obsVect);
+            G_free_ivector(sub->lineVect);
+        }
     } /*! END WHILE; last_row = TRUE */
+    G_free(subs);
 
     G_verbose_message(_("Writing output..."));
     /* Writing the output raster map */
     if (grid == TRUE) {
-        int row, col;
-        DCELL *drastbuf, dval;
-
         if (have_mask) {
             Segment_close(&mask_seg); /* close segment structure  */
         }
 
-        drastbuf = Rast_allocate_buf(DCELL_TYPE);
-        for (row = 0; row < nrows; row++) {
-            G_percent(row, nrows, 2);
-            for (col = 0; col < ncols; col++) {
-                Segment_get(&out_seg, &dval, row, col);
-                drastbuf[col] = dval;
-            }
-            Rast_put_d_row(raster, drastbuf);
-        }
-
+        write_rows(&out_seg, raster, out_row, nrows, nrows);
         Rast_close(raster);
 
         Segment_close(&out_seg); /* close segment structure  */
@@ -0,0 +1,110 @@
+/**********************************************************************
+ *
+ * MODULE:       v.surf.bspline
+ *
+ * AUTHOR(S):    Roberto Antolin & Gonzalo Moreno
+ *               update for grass7 by Markus Metz
+ *
+ * PURPOSE:      Spline Interpolation
+ *
+ * COPYRIGHT:    (C) 2006-2026 by Politecnico di Milano -
+ *                             Polo Regionale di Como
+ *                             and the GRASS Development Team
+ *
+ *               This program is free software under the
+ *               GNU General Public License (>=v2).
+ *               Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ **********************************************************************/
+
+#include <stdlib.h>
+#include "bspline.h"
+
+/* wider bands are solved in sparse format by the cg solver */
+#define SPARSE_BW 32
+
+static int no_percent(int n UNUSED)
+{
+    return 0;
+}
+
+/* set up and solve the normal system of one subregion */
+static void solve(struct Subregion *sub, int bilin, double lambda,
+                  double stepE, double stepN, int cg, int maxit, double err)
+{
+    int i, nparameters, BW;
+    double **N, *TN, *Q;
+
+    nparameters = sub->nsplx * sub->nsply;
+    BW = P_get_BandWidth(bilin, sub->nsply);
+
+    N = G_alloc_matrix(nparameters, BW); /* Normal matrix */
+    TN = G_alloc_vector(nparameters);    /* vector */
+    Q = G_alloc_vector(sub->npoints);    /* "a priori" var-cov matrix */
+    sub->parVect = G_alloc_vector(nparameters);
+
+    for (i = 0; i < sub->npoints; i++)
+        Q[i] = 1; /* Q=I */
+
+    if (bilin) {
+        G_debug(1, "Interpolation: (%d,%d): Bilinear interpolation...",
+                sub->row, sub->col);
+        normalDefBilin(N, TN, Q, sub->obsVect, stepE, stepN, sub->nsplx,
+                       sub->nsply, sub->reg.west, sub->reg.south, sub->npoints,
+                       nparameters, BW);
+    }
+    else {
+        G_debug(1, "Interpolation: (%d,%d): Bicubic interpolation...",
+                sub->row, sub->col);
+        normalDefBicubic(N, TN, Q, sub->obsVect, stepE, stepN, sub->nsplx,
+                         sub->nsply, sub->reg.west, sub->reg.south,
+                         sub->npoints, nparameters, BW);
+    }
+    nCorrectGrad(N, lambda, sub->nsplx, sub->nsply, stepE, stepN);
+
+    if (cg && BW > SPARSE_BW) {
+        G_math_spvector **Nsp = normalToSparse(N, nparameters, BW);
+
+        G_free_matrix(N);
+        N = NULL;
+        G_math_solver_sparse_pcg(Nsp, sub->parVect, TN, nparameters, maxit,
+                                 err, G_MATH_DIAGONAL_PRECONDITION);
+        G_math_free_spmatrix(Nsp, nparameters);
+    }
+    else if (cg)
+        G_math_solver_cg_sband(N, sub->parVect, TN, nparameters, BW, maxit,
+                               err);
+    else
+        G_math_solver_cholesky_sband(N, sub->parVect, TN, nparameters, BW);
+
+    if (N)
+        G_free_matrix(N);
+    G_free_vector(TN);
+    G_free_vector(Q);
+}
+
+/*!
+ * \brief Solve the least squares problems of subregions in parallel
+ *
+ * The subregions are independent, results are combined in the overlaps
+ * afterwards in the order of the subregions.
+ */
+void solve_subregions(struct Subregion *sub, int nsub, int bilin,
+                      double lambda, double stepE, double stepN, int cg,
+                      int maxit, double err, int nprocs)
+{
+    int i;
+
+    /* progress of the solvers of different threads would be mixed */
+    if (nprocs > 1 && nsub > 1)
+        G_set_percent_routine(no_percent);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nprocs) \
+    if (nprocs > 1 && nsub > 1)
+    for (i = 0; i < nsub; i++)
+        solve(&sub[i], bilin, lambda, stepE, stepN, cg, maxit, err);
+
+    if (nprocs > 1 && nsub > 1)
+        G_unset_percent_routine();
+}
@@ -0,0 +1,81 @@
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.gunittest.gmodules import SimpleModule
+
+
+class TestVSurfBsplineParallel(TestCase):
+    """Subregions solved in parallel give the serial result
+
+    With steps of 2 m the region is split into several rows and columns of
+    subregions, whose results are combined in the overlaps.
+    """
+
+    points = "test_v_surf_bspline_points"
+    serial = "test_v_surf_bspline_serial"
+    parallel = "test_v_surf_bspline_parallel"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", vector="elev_lid792_randpts", res=1)
+        cls.runModule(
+            "v.to.3d",
+            input="elev_lid792_randpts",
+            type="point",
+            output=cls.points,
+            column="value",
+            overwrite=True,
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove",
+            flags="f",
+            type=["raster", "vector"],
+            name=[cls.points, cls.serial, cls.parallel],
+        )
+        cls.del_temp_region()
+
+    def bspline(self, nprocs, **kwargs):
+        module = SimpleModule(
+            "v.surf.bspline",
+            input=self.points,
+            ew_step=2,
+            ns_step=2,
+            method="bicubic",
+            nprocs=nprocs,
+            overwrite=True,
+            **kwargs,
+        )
+        self.assertModule(module)
+
+    def test_raster_cholesky(self):
+        """Raster output with nprocs=4 equals nprocs=1"""
+        self.bspline(nprocs=1, raster_output=self.serial)
+        self.bspline(nprocs=4, raster_output=self.parallel)
+        self.assertRastersNoDifference(
+            self.parallel, reference=self.serial, precision=0
+        )
+
+    def test_raster_cg(self):
+        """Raster output with solver=cg and nprocs=4 equals nprocs=1"""
+        self.bspline(nprocs=1, raster_output=self.serial, solver="cg")
+        self.bspline(nprocs=4, raster_output=self.parallel, solver="cg")
+        self.assertRastersNoDifference(
+            self.parallel, reference=self.serial, precision=0
+        )
+
+    def test_sparse_points(self):
+        """Values interpolated at points with nprocs=4 equal nprocs=1"""
+        self.bspline(nprocs=1, sparse_input=self.points, output=self.serial)
+        self.bspline(nprocs=4, sparse_input=self.points, output=self.parallel)
+        serial = SimpleModule("v.out.ascii", input=self.serial, precision=12)
+        parallel = SimpleModule("v.out.ascii", input=self.parallel, precision=12)
+        self.assertModule(serial)
+        self.assertModule(parallel)
+        self.assertMultiLineEqual(parallel.outputs.stdout, serial.outputs.stdout)
+
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,56 @@
+"""Benchmarking of cross-validation sweeps of tension and smoothing in v.surf.rst
+
+@author GRASS Development Team
+"""
+
+from grass.pygrass.modules import Module
+import grass.benchmark as bm
+from subprocess import DEVNULL
+
+
+def main():
+    results = []
+    # Users can add more or modify existing reference maps
+    npoints = [5000, 10000, 20000, 40000]
+    for n in npoints:
+        benchmark(n, f"v.surf.rst_sweep_{int(n / 1e3)}k", results)
+    bm.nprocs_plot(results)
+
+
+def benchmark(npoints, label, results):
+    reference = "v_surf_rst_reference_map"
+
+    generate_map(npoints=npoints, fname=reference)
+
+    module = Module(
+        "v.surf.rst",
+        input=reference,
+        npmin=100,
+        tension=(20, 40, 80, 160),
+        smooth=(0.1, 0.5, 1),
+        stdout_=DEVNULL,
+        c=True,
+        run_=False,
+    )
+
+    results.append(bm.benchmark_nprocs(module, label=label, max_nprocs=8, repeat=3))
+    Module("g.remove", quiet=True, flags="f", type="vector", name=reference)
+
+
+def generate_map(npoints, fname):
+    Module("g.region", flags="p", rows=1000, cols=1000, res=1)
+    print("Generating reference map using v.random...")
+    Module(
+        "v.random",
+        flags="z",
+        output=fname,
+        npoints=npoints,
+        zmin=0,
+        zmax=100,
+        seed=1,
+        overwrite=True,
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -13,6 +13,7 @@
  *               cross-validation -v flag by Jaro Hofierka 2004
  *               Stanislav Zubal, Michal Lacko 2015 (OpenMP version)
  *               Anna Petrasova (OpenMP version GRASS integration)
+ *               cross-validation sweeps of tension and smoothing 2026
  *
  * PURPOSE:      Surface interpolation from vector point data by splines
  * COPYRIGHT:    (C) 2003-2009, 2013 by the GRASS Development Team
@@ -61,6 +62,7 @@ static struct tree_info *info;
 
 static void create_temp_files(void);
 static void clean(void);
+static void cv_sweep(const double *, int, const double *, int, double, int);
 
 static double *az = NULL, *adx = NULL, *ady = NULL, *adxx = NULL, *adyy = NULL,
               *adxy = NULL;
@@ -128,6 +130,8 @@ int main(int argc, char *argv[])
     int open_check, with_z;
     char buf[1024];
     int threads;
+    int nfi, nrsm, sweep;
+    double *fis, *rsms;
 
     struct GModule *module;
     struct {
@@ -278,16 +282,21 @@ int main(int argc, char *argv[])
     parm.fi->type = TYPE_DOUBLE;
     parm.fi->answer = TENSION;
     parm.fi->required = NO;
-    parm.fi->description = _("Tension parameter");
+    parm.fi->multiple = YES;
+    parm.fi->label = _("Tension parameter");
+    parm.fi->description =
+        _("Multiple values with -c flag compare cross-validation errors");
     parm.fi->guisection = _("Parameters");
 
     parm.rsm = G_define_option();
     parm.rsm->key = "smooth";
     parm.rsm->type = TYPE_DOUBLE;
     parm.rsm->required = NO;
+    parm.rsm->multiple = YES;
     parm.rsm->label = _("Smoothing parameter");
     parm.rsm->description =
-        _("Smoothing is by default 0.5 unless smooth_column is specified");
+        _("Smoothing is by default 0.5 unless smooth_column is specified. "
+          "Multiple values with -c flag compare cross-validation errors");
     parm.rsm->guisection = _("Parameters");
 
     parm.scol = G_define_option();
@@ -454,21 +463,39 @@ int main(int argc, char *argv[])
        if (overfile)
        Vect_check_input_output_name(input, overfile, G_FATAL_EXIT);
      */
-    if ((elev == NULL) && (pcurv == NULL) && (tcurv == NULL) &&
-        (mcurv == NULL) && (slope == NULL) && (aspect == NULL) &&
-        (devi == NULL) && (cvdev == NULL))
-        G_warning(_("You are not outputting any raster or vector maps"));
-
     cond2 = ((pcurv != NULL) || (tcurv != NULL) || (mcurv != NULL));
     cond1 = ((slope != NULL) || (aspect != NULL) || cond2);
     deriv = flag.deriv->answer;
     dtens = flag.cprght->answer;
     cv = flag.cv->answer;
 
-    if ((cv && cvdev == NULL) || (!(cv) && cvdev != NULL))
+    /* more tensions or smoothings: table of cross-validation errors */
+    for (nfi = 0; parm.fi->answers[nfi]; nfi++)
+        ;
+    nrsm = 0;
+    if (parm.rsm->answer)
+        for (; parm.rsm->answers[nrsm]; nrsm++)
+            ;
+    sweep = nfi > 1 || nrsm > 1;
+
+    if (sweep) {
+        if (!cv)
+            G_fatal_error(_("Multiple values of tension or smoothing "
+                            "require cross-validation (-c flag)"));
+        if (cvdev != NULL)
+            G_fatal_error(_("Option <%s> cannot be used with multiple values "
+                            "of tension or smoothing"),
+                          parm.cvdev->key);
+    }
+    else if ((cv && cvdev == NULL) || (!(cv) && cvdev != NULL))
         G_fatal_error(_("Both cross-validation options (-c flag and cvdev "
                         "vector output) must be specified"));
 
+    if (!sweep && (elev == NULL) && (pcurv == NULL) && (tcurv == NULL) &&
+        (mcurv == NULL) && (slope == NULL) && (aspect == NULL) &&
+        (devi == NULL) && (cvdev == NULL))
+        G_warning(_("You are not outputting any raster or vector maps"));
+
     if ((elev != NULL || cond1 || cond2 || devi != NULL) && cv)
         G_fatal_error(_("The cross-validation cannot be computed "
                         "simultaneously with output raster or devi file"));
@@ -476,7 +503,10 @@ int main(int argc, char *argv[])
     ertre = 0.1;
     sscanf(parm.dmax->answer, "%lf", &dmax);
     sscanf(parm.dmin->answer, "%lf", &dmin);
-    sscanf(parm.fi->answer, "%lf", &fi);
+    fis = G_malloc(nfi * sizeof(double));
+    for (ii = 0; ii < nfi; ii++)
+        sscanf(parm.fi->answers[ii], "%lf", &fis[ii]);
+    fi = fis[0];
     sscanf(parm.segmax->answer, "%d", &KMAX);
     sscanf(parm.npmin->answer, "%d", &npmin);
     sscanf(parm.zmult->answer, "%lf", &zmult);
@@ -494,9 +524,13 @@ int main(int argc, char *argv[])
     }
 
     if (parm.rsm->answer) {
-        sscanf(parm.rsm->answer, "%lf", &rsm);
-        if (rsm < 0.0)
-            G_fatal_error("Smoothing must be a positive value");
+        rsms = G_malloc(nrsm * sizeof(double));
+        for (ii = 0; ii < nrsm; ii++) {
+            sscanf(parm.rsm->answers[ii], "%lf", &rsms[ii]);
+            if (rsms[ii] < 0.0)
+                G_fatal_error("Smoothing must be a positive value");
+        }
+        rsm = rsms[0];
         if (scol != NULL)
             G_warning(
                 _("Both smatt and smooth options specified - using constant"));
@@ -505,6 +539,8 @@ int main(int argc, char *argv[])
         sscanf(SMOOTH, "%lf", &rsm);
         if (scol != NULL)
             rsm = -1; /* used in InterpLib to indicate variable smoothing */
+        nrsm = 1;
+        rsms = &rsm;
     }
 
     if (npmin > MAXPOINTS - 50) {
@@ -751,6 +787,12 @@ int main(int argc, char *argv[])
                           params.fi);
     }
 
+    if (sweep) {
+        cv_sweep(fis, nfi, rsms, nrsm, dnorm, threads);
+        clean();
+        exit(EXIT_SUCCESS);
+    }
+
     bitmask = IL_create_bitmask(&params);
 
     if (totsegm <= 0) {
@@ -932,6 +974,50 @@ static void create_temp_files(void)
     Tmp_fd_xy = create_temp_file(mcurv, &Tmp_file_xy);
 }
 
+/* print table of cross-validation errors for all combinations of
+ * tension and smoothing, tensions are printed as given by the user */
+static void cv_sweep(const double *fis, int nfi, const double *rsms, int nrsm,
+                     double dnorm, int threads)
+{
+    double *sum, *sumsq, *tensions, rms, best = -1;
+    int i, n, ibest = 0;
+
+    /* tensions used for interpolation */
+    tensions = G_malloc(nfi * sizeof(double));
+    for (i = 0; i < nfi; i++)
+        tensions[i] = dtens ? fis[i] * dnorm / 1000. : fis[i];
+    sum = G_malloc(2 * nfi * nrsm * sizeof(double));
+    sumsq = sum + nfi * nrsm;
+
+    G_message(_("Cross-validation of %d combinations of tension and "
+                "smoothing..."),
+              nfi * nrsm);
+    if (IL_cv_sweep_2d_parallel(&params, info, info->root, totsegm, dnorm, nfi,
+                                tensions, nrsm, rsms, sum, sumsq, &n,
+                                threads) < 0 ||
+        n == 0) {
+        clean();
+        G_fatal_error(_("Cross-validation failed"));
+    }
+
+    fprintf(stdout, "tension|smooth|mean|rms\n");
+    for (i = 0; i < nfi * nrsm; i++) {
+        rms = sqrt(sumsq[i] / n);
+        fprintf(stdout, "%.*g|%.*g|%.*g|%.*g\n", 10, fis[i / nrsm], 10,
+                rsms[i % nrsm], 10, sum[i] / n, 10, rms);
+        if (best < 0 || rms < best) {
+            best = rms;
+            ibest = i;
+        }
+    }
+    G_message(_("Lowest RMS error %g for tension %g and smoothing %g "
+                "(%d points)"),
+              best, fis[ibest / nrsm], rsms[ibest % nrsm], n);
+
+    G_free(sum);
+    G_free(tensions);
+}
+
 static void clean(void)
 {
     if (Tmp_fd_z)
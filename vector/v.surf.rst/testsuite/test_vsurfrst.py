@@ -1,6 +1,9 @@
+import math
+
 from grass.gunittest.case import TestCase
 from grass.gunittest.main import test
 from grass.gunittest.gmodules import SimpleModule
+from grass.script.core import read_command
 
 
 class TestVsurfrst(TestCase):
@@ -200,6 +203,40 @@ class TestVsurfrst(TestCase):
             map=self.cvdev, column="flt1", reference=values, precision=1e-8
         )
 
+    def test_cv_sweep(self):
+        """Table of cross-validation errors for tension and smoothing"""
+        self.vsurfrst_cv.outputs.cvdev = self.cvdev
+        self.assertModule(self.vsurfrst_cv)
+        values = read_command(
+            "v.db.select", map=self.cvdev, columns="flt1", flags="c"
+        ).split()
+        rms = math.sqrt(sum(float(value) ** 2 for value in values) / len(values))
+
+        for flags in ("c", "ct"):
+            sweep = SimpleModule(
+                "v.surf.rst",
+                input="elev_points3d",
+                npmin=100,
+                tension=[20, 40],
+                smooth=[0.1, 0.5],
+                flags=flags,
+                nprocs=2,
+            )
+            self.assertModule(sweep)
+            rows = sweep.outputs.stdout.splitlines()
+            self.assertEqual(rows[0], "tension|smooth|mean|rms")
+            table = {}
+            for row in rows[1:]:
+                tension, smooth, mean, error = map(float, row.split("|"))
+                table[tension, smooth] = error
+            # tensions as given by the user, also with scale dependent tension
+            self.assertEqual(
+                sorted(table), [(20, 0.1), (20, 0.5), (40, 0.1), (40, 0.5)]
+            )
+            if flags == "c":
+                # the defaults tension=40 and smooth=0.1 as the cvdev map
+                self.assertAlmostEqual(table[40, 0.1], rms, delta=1e-6 * rms)
+
 
 if __name__ == "__main__":
     test()
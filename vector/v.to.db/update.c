@@ -7,14 +7,19 @@
 #include "global.h"
 
 static int srch(const void *, const void *);
+static int prepare_update(dbDriver *, struct field_info *, dbBulk *);
+static void set_params(dbBulk *, struct value *);
+static void sql_statement(char *, size_t, const char *, struct field_info *,
+                          struct value *, dbString *);
 
 int update(struct Map_info *Map)
 {
     int i, *catexst, *cex, upd, fcat;
-    char buf1[2000], buf2[2500], left[20], right[20];
+    char buf1[2000], buf2[2500];
     struct field_info *qFi, *Fi;
-    dbString stmt, strval;
+    dbString strval;
     dbDriver *driver;
+    dbBulk bulk;
 
     vstat.dupl = 0;
     vstat.exist = 0;
@@ -22,7 +27,6 @@ int update(struct Map_info *Map)
     vstat.update = 0;
     vstat.error = 0;
 
-    db_init_string(&stmt);
     db_init_string(&strval);
 
     /* layer to find table to read from */
@@ -61,77 +65,54 @@ int update(struct Map_info *Map)
     vstat.select = db_select_int(driver, Fi->table, Fi->key, NULL, &catexst);
     G_debug(3, "Existing categories: %d", vstat.select);
 
-    /* create beginning of stmt */
-    switch (options.option) {
-    case O_CAT:
-        snprintf(buf1, sizeof(buf1), "insert into %s ( %s ) values ", Fi->table,
-                 Fi->key);
-        break;
-    case O_COUNT:
-    case O_LENGTH:
-    case O_AREA:
-    case O_QUERY:
-    case O_COMPACT:
-    case O_FD:
-    case O_PERIMETER:
-    case O_SLOPE:
-    case O_SINUOUS:
-    case O_AZIMUTH:
-        snprintf(buf1, sizeof(buf1), "update %s set %s =", Fi->table,
-                 options.col[0]);
-        break;
-    case O_COOR:
-    case O_START:
-    case O_END:
-    case O_SIDES:
-    case O_BBOX:
-        snprintf(buf1, sizeof(buf1), "update %s set ", Fi->table);
-        break;
-    }
-
-    /* update */
-    G_message(_("Updating database..."));
-    for (i = 0; i < vstat.rcat; i++) {
-        G_percent(i, vstat.rcat, 2);
+    /* statement executed with values of each category */
+    if (!options.sql && prepare_update(driver, Fi, &bulk) != DB_OK)
+        G_fatal_error(_("Unable to prepare statement for table <%s>"),
+                      Fi->table);
 
-        fcat = Values[i].cat;
-        if (fcat < 0)
-            continue;
+    /* beginning of printed statements */
+    if (options.sql) {
         switch (options.option) {
         case O_CAT:
-            snprintf(buf2, sizeof(buf2), "%s ( %d )", buf1, Values[i].cat);
+            snprintf(buf1, sizeof(buf1), "insert into %s ( %s ) values ",
+                     Fi->table, Fi->key);
             break;
-
         case O_COUNT:
-            snprintf(buf2, sizeof(buf2), "%s %d where %s = %d", buf1,
-                     Values[i].count1, Fi->key, Values[i].cat);
-            break;
-
         case O_LENGTH:
         case O_AREA:
+        case O_QUERY:
+        case O_COMPACT:
+        case O_FD:
         case O_PERIMETER:
         case O_SLOPE:
         case O_SINUOUS:
         case O_AZIMUTH:
-            snprintf(buf2, sizeof(buf2), "%s %f where %s = %d", buf1,
-                     Values[i].d1, Fi->key, Values[i].cat);
+            snprintf(buf1, sizeof(buf1), "update %s set %s =", Fi->table,
+                     options.col[0]);
             break;
-
+        case O_COOR:
+        case O_START:
+        case O_END:
+        case O_SIDES:
         case O_BBOX:
-            snprintf(buf2, sizeof(buf2),
-                     "%s %s = %.15g, %s = %.15g, %s = %.15g, %s = %.15g where "
-                     "%s = %d",
-                     buf1, options.col[0], Values[i].d1, options.col[1],
-                     Values[i].d2, options.col[2], Values[i].d3, options.col[3],
-                     Values[i].d4, Fi->key, Values[i].cat);
+            snprintf(buf1, sizeof(buf1), "update %s set ", Fi->table);
             break;
+        }
+    }
+
+    /* update */
+    G_message(_("Updating database..."));
+    for (i = 0; i < vstat.rcat; i++) {
+        G_percent(i, vstat.rcat, 2);
 
+        fcat = Values[i].cat;
+        if (fcat < 0)
+            continue;
+        switch (options.option) {
         case O_COMPACT:
             /* perimeter / perimeter of equivalent circle
              *   perimeter of equivalent circle: 2.0 * sqrt(M_PI * area) */
             Values[i].d1 = Values[i].d2 / (2.0 * sqrt(M_PI * Values[i].d1));
-            snprintf(buf2, sizeof(buf2), "%s %f where %s = %d", buf1,
-                     Values[i].d1, Fi->key, Values[i].cat);
             break;
 
         case O_FD:
@@ -148,8 +129,6 @@ int update(struct Map_info *Map)
             if (Values[i].d1 == 1) /* log(1) == 0 */
                 Values[i].d1 += 0.000001;
             Values[i].d1 = 2.0 * log(Values[i].d2) / log(Values[i].d1);
-            snprintf(buf2, sizeof(buf2), "%s %f where %s = %d", buf1,
-                     Values[i].d1, Fi->key, Values[i].cat);
             break;
 
         case O_COOR:
@@ -165,90 +144,9 @@ int update(struct Map_info *Map)
             if (Values[i].count1 < 1) { /* No points */
                 continue;
             }
-            if (options.col[2]) {
-                snprintf(buf2, sizeof(buf2),
-                         "%s %s = %.15g, %s = %.15g, %s = %.15g where %s = %d",
-                         buf1, options.col[0], Values[i].d1, options.col[1],
-                         Values[i].d2, options.col[2], Values[i].d3, Fi->key,
-                         Values[i].cat);
-            }
-            else {
-                snprintf(buf2, sizeof(buf2),
-                         "%s %s = %.15g, %s = %.15g  where %s = %d", buf1,
-                         options.col[0], Values[i].d1, options.col[1],
-                         Values[i].d2, Fi->key, Values[i].cat);
-            }
             break;
-
-        case O_SIDES:
-            if (Values[i].count1 == 1) {
-                if (Values[i].i1 >= 0)
-                    snprintf(left, sizeof(left), "%d", Values[i].i1);
-                else
-                    snprintf(left, sizeof(left), "-1"); /* NULL, no area/cat */
-            }
-            else if (Values[i].count1 > 1) {
-                snprintf(left, sizeof(left), "null");
-            }
-            else { /* Values[i].count1 == 0 */
-                /* It can be OK if the category is assigned to an element
-                   type which is not GV_BOUNDARY */
-                /* -> TODO: print only if there is boundary with that cat */
-                snprintf(left, sizeof(left), "null");
-            }
-
-            if (Values[i].count2 == 1) {
-                if (Values[i].i2 >= 0)
-                    snprintf(right, sizeof(right), "%d", Values[i].i2);
-                else
-                    snprintf(right, sizeof(right),
-                             "-1"); /* NULL, no area/cat */
-            }
-            else if (Values[i].count2 > 1) {
-                snprintf(right, sizeof(right), "null");
-            }
-            else { /* Values[i].count1 == 0 */
-                snprintf(right, sizeof(right), "null");
-            }
-
-            snprintf(buf2, sizeof(buf2), "%s %s = %s, %s = %s  where %s = %d",
-                     buf1, options.col[0], left, options.col[1], right, Fi->key,
-                     Values[i].cat);
-
-            break;
-
-        case O_QUERY:
-            if (Values[i].null) {
-                snprintf(buf2, sizeof(buf2), "%s null where %s = %d", buf1,
-                         Fi->key, Values[i].cat);
-            }
-            else {
-                switch (vstat.qtype) {
-                case (DB_C_TYPE_INT):
-                    snprintf(buf2, sizeof(buf2), "%s %d where %s = %d", buf1,
-                             Values[i].i1, Fi->key, Values[i].cat);
-                    break;
-                case (DB_C_TYPE_DOUBLE):
-                    snprintf(buf2, sizeof(buf2), "%s %f where %s = %d", buf1,
-                             Values[i].d1, Fi->key, Values[i].cat);
-                    break;
-                case (DB_C_TYPE_STRING):
-                    db_set_string(&strval, Values[i].str1);
-                    db_double_quote_string(&strval);
-                    snprintf(buf2, sizeof(buf2), "%s '%s' where %s = %d", buf1,
-                             db_get_string(&strval), Fi->key, Values[i].cat);
-                    break;
-                case (DB_C_TYPE_DATETIME):
-                    snprintf(buf2, sizeof(buf2), "%s '%s' where %s = %d", buf1,
-                             Values[i].str1, Fi->key, Values[i].cat);
-                    break;
-                }
-            }
         }
 
-        G_debug(3, "SQL: %s", buf2);
-        db_set_string(&stmt, buf2);
-
         /* category exist in DB table ? */
         cex = (int *)bsearch((void *)&fcat, catexst, vstat.select, sizeof(int),
                              srch);
@@ -280,34 +178,180 @@ int update(struct Map_info *Map)
 
         if (upd == 1) {
             if (options.sql) {
-                fprintf(stdout, "%s\n", db_get_string(&stmt));
+                sql_statement(buf2, sizeof(buf2), buf1, Fi, &Values[i],
+                              &strval);
+                G_debug(3, "SQL: %s", buf2);
+                fprintf(stdout, "%s\n", buf2);
             }
             else {
-                if (db_execute_immediate(driver, &stmt) == DB_OK) {
-                    vstat.update++;
-                }
-                else {
-                    G_warning(_("Cannot update table: %s"),
-                              db_get_string(&stmt));
-                    vstat.error++;
-                }
+                set_params(&bulk, &Values[i]);
+                db_add_bulk_row(&bulk);
             }
         }
     }
     G_percent(1, 1, 1);
 
+    if (!options.sql) {
+        db_close_bulk(&bulk);
+        vstat.update = bulk.n_ok;
+        vstat.error = bulk.n_failed;
+        if (vstat.error > 0)
+            G_warning(_("Cannot update table <%s> for %d categories"),
+                      Fi->table, vstat.error);
+    }
+
     db_commit_transaction(driver);
 
     G_free(catexst);
 
     db_close_database_shutdown_driver(driver);
-    db_free_string(&stmt);
+    db_free_string(&strval);
     Vect_destroy_field_info(Fi);
     Vect_destroy_field_info(qFi);
 
     return 0;
 }
 
+/* prepare statement with the values of one category as parameters, the
+   last parameter is the category */
+static int prepare_update(dbDriver *driver, struct field_info *Fi,
+                          dbBulk *bulk)
+{
+    int ret, nparams, ctype[5];
+    char buf[2000];
+    dbString stmt;
+
+    switch (options.option) {
+    case O_CAT:
+        snprintf(buf, sizeof(buf), "insert into %s ( %s ) values ( ? )",
+                 Fi->table, Fi->key);
+        nparams = 0;
+        break;
+    case O_COUNT:
+    case O_LENGTH:
+    case O_AREA:
+    case O_QUERY:
+    case O_COMPACT:
+    case O_FD:
+    case O_PERIMETER:
+    case O_SLOPE:
+    case O_SINUOUS:
+    case O_AZIMUTH:
+        snprintf(buf, sizeof(buf), "update %s set %s = ? where %s = ?",
+                 Fi->table, options.col[0], Fi->key);
+        nparams = 1;
+        if (options.option == O_COUNT)
+            ctype[0] = DB_C_TYPE_INT;
+        else if (options.option == O_QUERY && vstat.qtype == DB_C_TYPE_INT)
+            ctype[0] = DB_C_TYPE_INT;
+        else if (options.option == O_QUERY &&
+                 vstat.qtype != DB_C_TYPE_DOUBLE)
+            ctype[0] = DB_C_TYPE_STRING;
+        else
+            ctype[0] = DB_C_TYPE_DOUBLE;
+        break;
+    case O_BBOX:
+        snprintf(buf, sizeof(buf),
+                 "update %s set %s = ?, %s = ?, %s = ?, %s = ? where %s = ?",
+                 Fi->table, options.col[0], options.col[1], options.col[2],
+                 options.col[3], Fi->key);
+        nparams = 4;
+        ctype[0] = ctype[1] = ctype[2] = ctype[3] = DB_C_TYPE_DOUBLE;
+        break;
+    case O_COOR:
+    case O_START:
+    case O_END:
+        if (options.col[2]) {
+            snprintf(buf, sizeof(buf),
+                     "update %s set %s = ?, %s = ?, %s = ? where %s = ?",
+                     Fi->table, options.col[0], options.col[1], options.col[2],
+                     Fi->key);
+            nparams = 3;
+        }
+        else {
+            snprintf(buf, sizeof(buf),
+                     "update %s set %s = ?, %s = ? where %s = ?", Fi->table,
+                     options.col[0], options.col[1], Fi->key);
+            nparams = 2;
+        }
+        ctype[0] = ctype[1] = ctype[2] = DB_C_TYPE_DOUBLE;
+        break;
+    case O_SIDES:
+        snprintf(buf, sizeof(buf), "update %s set %s = ?, %s = ? where %s = ?",
+                 Fi->table, options.col[0], options.col[1], Fi->key);
+        nparams = 2;
+        ctype[0] = ctype[1] = DB_C_TYPE_INT;
+        break;
+    default:
+        return DB_FAILED;
+    }
+    ctype[nparams++] = DB_C_TYPE_INT;
+
+    G_debug(3, "SQL: %s", buf);
+    db_init_string(&stmt);
+    db_set_string(&stmt, buf);
+    ret = db_prepare_bulk(driver, &stmt, nparams, ctype, bulk);
+    db_free_string(&stmt);
+
+    return ret;
+}
+
+/* set side (area category) of boundary, NULL if not unique */
+static void set_side(dbValue *value, int count, int cat)
+{
+    if (count == 1)
+        db_set_value_int(value, cat >= 0 ? cat : -1); /* -1: no area/cat */
+    else
+        db_set_value_null(value);
+}
+
+/* set parameters of statement prepared by prepare_update() */
+static void set_params(dbBulk *bulk, struct value *v)
+{
+    int n;
+
+    n = 0;
+    switch (options.option) {
+    case O_CAT:
+        break;
+    case O_COUNT:
+        db_set_value_int(db_get_bulk_param(bulk, n++), v->count1);
+        break;
+    case O_QUERY:
+        if (v->null)
+            db_set_value_null(db_get_bulk_param(bulk, n++));
+        else if (vstat.qtype == DB_C_TYPE_INT)
+            db_set_value_int(db_get_bulk_param(bulk, n++), v->i1);
+        else if (vstat.qtype == DB_C_TYPE_DOUBLE)
+            db_set_value_double(db_get_bulk_param(bulk, n++), v->d1);
+        else
+            db_set_value_string(db_get_bulk_param(bulk, n++), v->str1);
+        break;
+    case O_SIDES:
+        set_side(db_get_bulk_param(bulk, n++), v->count1, v->i1);
+        set_side(db_get_bulk_param(bulk, n++), v->count2, v->i2);
+        break;
+    case O_BBOX:
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d1);
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d2);
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d3);
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d4);
+        break;
+    case O_COOR:
+    case O_START:
+    case O_END:
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d1);
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d2);
+        if (options.col[2])
+            db_set_value_double(db_get_bulk_param(bulk, n++), v->d3);
+        break;
+    default:
+        db_set_value_double(db_get_bulk_param(bulk, n++), v->d1);
+        break;
+    }
+    db_set_value_int(db_get_bulk_param(bulk, n), v->cat);
+}
+
 int srch(const void *pa, const void *pb)
 {
     int *p1 = (int *)pa;
@@ -319,3 +363,123 @@ int srch(const void *pa, const void *pb)
         return 1;
     return 0;
 }
+
+/* SQL statement with the values of one category, printed instead of
+   executed */
+static void sql_statement(char *buf, size_t size, const char *buf1,
+                          struct field_info *Fi, struct value *v,
+                          dbString *strval)
+{
+    char left[20], right[20];
+
+    switch (options.option) {
+    case O_CAT:
+        snprintf(buf, size, "%s ( %d )", buf1, v->cat);
+        break;
+
+    case O_COUNT:
+        snprintf(buf, size, "%s %d where %s = %d", buf1, v->count1, Fi->key,
+                 v->cat);
+        break;
+
+    case O_LENGTH:
+    case O_AREA:
+    case O_PERIMETER:
+    case O_SLOPE:
+    case O_SINUOUS:
+    case O_AZIMUTH:
+    case O_COMPACT:
+    case O_FD:
+        snprintf(buf, size, "%s %f where %s = %d", buf1, v->d1, Fi->key,
+                 v->cat);
+        break;
+
+    case O_BBOX:
+        snprintf(buf, size,
+                 "%s %s = %.15g, %s = %.15g, %s = %.15g, %s = %.15g where "
+                 "%s = %d",
+                 buf1, options.col[0], v->d1, options.col[1], v->d2,
+                 options.col[2], v->d3, options.col[3], v->d4, Fi->key,
+                 v->cat);
+        break;
+
+    case O_COOR:
+    case O_START:
+    case O_END:
+        if (options.col[2]) {
+            snprintf(buf, size,
+                     "%s %s = %.15g, %s = %.15g, %s = %.15g where %s = %d",
+                     buf1, options.col[0], v->d1, options.col[1], v->d2,
+                     options.col[2], v->d3, Fi->key, v->cat);
+        }
+        else {
+            snprintf(buf, size, "%s %s = %.15g, %s = %.15g  where %s = %d",
+                     buf1, options.col[0], v->d1, options.col[1], v->d2,
+                     Fi->key, v->cat);
+        }
+        break;
+
+    case O_SIDES:
+        if (v->count1 == 1) {
+            if (v->i1 >= 0)
+                snprintf(left, sizeof(left), "%d", v->i1);
+            else
+                snprintf(left, sizeof(left), "-1"); /* NULL, no area/cat */
+        }
+        else if (v->count1 > 1) {
+            snprintf(left, sizeof(left), "null");
+        }
+        else { /* v->count1 == 0 */
+            /* It can be OK if the category is assigned to an element
+               type which is not GV_BOUNDARY */
+            /* -> TODO: print only if there is boundary with that cat */
+            snprintf(left, sizeof(left), "null");
+        }
+
+        if (v->count2 == 1) {
+            if (v->i2 >= 0)
+                snprintf(right, sizeof(right), "%d", v->i2);
+            else
+                snprintf(right, sizeof(right), "-1"); /* NULL, no area/cat */
+        }
+        else if (v->count2 > 1) {
+            snprintf(right, sizeof(right), "null");
+        }
+        else { /* v->count1 == 0 */
+            snprintf(right, sizeof(right), "null");
+        }
+
+        snprintf(buf, size, "%s %s = %s, %s = %s  where %s = %d", buf1,
+                 options.col[0], left, options.col[1], right, Fi->key, v->cat);
+        break;
+
+    case O_QUERY:
+        if (v->null) {
+            snprintf(buf, size, "%s null where %s = %d", buf1, Fi->key,
+                     v->cat);
+        }
+        else {
+            switch (vstat.qtype) {
+            case (DB_C_TYPE_INT):
+                snprintf(buf, size, "%s %d where %s = %d", buf1, v->i1,
+                         Fi->key, v->cat);
+                break;
+            case (DB_C_TYPE_DOUBLE):
+                snprintf(buf, size, "%s %f where %s = %d", buf1, v->d1,
+                         Fi->key, v->cat);
+                break;
+            case (DB_C_TYPE_STRING):
+                db_set_string(strval, v->str1);
+                db_double_quote_string(strval);
+                snprintf(buf, size, "%s '%s' where %s = %d", buf1,
+                         db_get_string(strval), Fi->key, v->cat);
+                break;
+            case (DB_C_TYPE_DATETIME):
+                snprintf(buf, size, "%s '%s' where %s = %d", buf1, v->str1,
+                         Fi->key, v->cat);
+                break;
+            }
+        }
+        break;
+    }
+}
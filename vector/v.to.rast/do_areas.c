@@ -1,4 +1,8 @@
 #include <stdlib.h>
+#include <math.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/vector.h>
@@ -14,8 +18,44 @@ static struct list {
 
 static int nareas;
 
+/* edge of area crossing the centers of rows ystart to ystop, in cell
+   coordinates of the region */
+struct edge {
+    double x; /* column at ystart */
+    double m; /* column increment per row */
+    int ystart, ystop;
+    int area; /* index to list, areas are plotted in the order of list */
+};
+
+/* edge crossing the center of row */
+struct crossing {
+    double x;
+    int row;
+    int area;
+};
+
+static struct edge_table {
+    struct Cell_head window;
+    double xconv, yconv;
+    struct edge *edges;
+    size_t nedges, nalloc;
+    size_t next;             /* first edge not yet active */
+    size_t *active;          /* edges crossing current page */
+    size_t nactive, nalloc_active;
+    struct value {
+        DCELL val;
+        int null;
+    } *values;
+} et;
+
 /* function prototypes */
 static int compare(const void *, const void *);
+static int compare_edges(const void *, const void *);
+static int compare_crossings(const void *, const void *);
+static int get_value(CELL, dbCatValArray *, int, int, double, int, CELL *,
+                     DCELL *);
+static void add_area_edges(struct line_pnts *, int);
+static void add_edge(double, double, double, double, int);
 
 int do_areas(struct Map_info *Map, struct line_pnts *Points,
              dbCatValArray *Cvarr, int ctype, int use, double value,
@@ -37,41 +77,11 @@ int do_areas(struct Map_info *Map, struct line_pnts *Points,
         cat = list[i].cat;
         G_debug(3, "Area cat = %d", cat);
 
-        if (ISNULL(&cat)) { /* No centroid or no category */
-            set_cat(cat);
-        }
-        else {
-            if (use == USE_ATTR) {
-                if (ctype == DB_C_TYPE_INT) {
-                    if ((db_CatValArray_get_value_int(Cvarr, cat, &cval)) !=
-                        DB_OK) {
-                        G_warning(_("No record for area (cat = %d)"), cat);
-                        SETNULL(&cval);
-                    }
-                    set_cat(cval);
-                }
-                else if (ctype == DB_C_TYPE_DOUBLE) {
-                    if ((db_CatValArray_get_value_double(Cvarr, cat, &dval)) !=
-                        DB_OK) {
-                        G_warning(_("No record for area (cat = %d)"), cat);
-                        SETDNULL(&dval);
-                    }
-                    set_dcat(dval);
-                }
-                else {
-                    G_fatal_error(_("Unable to use column specified"));
-                }
-            }
-            else if (use == USE_CAT) {
-                set_cat(cat);
-            }
-            else {
-                if (value_type == CELL_TYPE)
-                    set_cat((int)value);
-                else
-                    set_dcat(value);
-            }
-        }
+        if (get_value(cat, Cvarr, ctype, use, value, value_type, &cval,
+                      &dval) == CELL_TYPE)
+            set_cat(cval);
+        else
+            set_dcat(dval);
 
         if (Vect_get_area_points(Map, list[i].index, Points) <= 0) {
             G_warning(_("Get area %d failed"), list[i].index);
@@ -86,10 +96,60 @@ int do_areas(struct Map_info *Map, struct line_pnts *Points,
     return nareas;
 }
 
+/* raster value of area with category cat, returns CELL_TYPE if the value
+   was stored in cval, DCELL_TYPE if in dval */
+static int get_value(CELL cat, dbCatValArray *Cvarr, int ctype, int use,
+                     double value, int value_type, CELL *cval, DCELL *dval)
+{
+    if (ISNULL(&cat)) { /* No centroid or no category */
+        *cval = cat;
+        return CELL_TYPE;
+    }
+
+    if (use == USE_ATTR) {
+        if (ctype == DB_C_TYPE_INT) {
+            if ((db_CatValArray_get_value_int(Cvarr, cat, cval)) != DB_OK) {
+                G_warning(_("No record for area (cat = %d)"), cat);
+                SETNULL(cval);
+            }
+            return CELL_TYPE;
+        }
+        else if (ctype == DB_C_TYPE_DOUBLE) {
+            if ((db_CatValArray_get_value_double(Cvarr, cat, dval)) !=
+                DB_OK) {
+                G_warning(_("No record for area (cat = %d)"), cat);
+                SETDNULL(dval);
+            }
+            return DCELL_TYPE;
+        }
+        else {
+            G_fatal_error(_("Unable to use column specified"));
+        }
+    }
+    else if (use == USE_CAT) {
+        *cval = cat;
+        return CELL_TYPE;
+    }
+
+    if (value_type == CELL_TYPE) {
+        *cval = (int)value;
+        return CELL_TYPE;
+    }
+    *dval = value;
+
+    return DCELL_TYPE;
+}
+
+/*
+   sort areas by size, if scan != 0 also build the table of area edges
+   used by scan_areas() instead of do_areas()
+ */
 int sort_areas(struct Map_info *Map, struct line_pnts *Points, int field,
-               struct cat_list *cat_list)
+               struct cat_list *cat_list, int scan)
 {
     int i, centroid, nareas_selected;
+    size_t e;
+    int *rank;
     struct line_cats *Cats;
     CELL cat;
 
@@ -100,6 +160,12 @@ int sort_areas(struct Map_info *Map, struct line_pnts *Points, int field,
     if (nareas == 0)
         return 0;
 
+    if (scan) {
+        G_get_set_window(&et.window);
+        et.xconv = et.window.cols / (et.window.east - et.window.west);
+        et.yconv = et.window.rows / (et.window.north - et.window.south);
+    }
+
     Cats = Vect_new_cats_struct();
 
     /* allocate list to hold valid area info */
@@ -151,6 +217,11 @@ int sort_areas(struct Map_info *Map, struct line_pnts *Points, int field,
             G_area_of_polygon(Points->x, Points->y, Points->n_points);
 
         list[i].cat = cat;
+
+        /* geometry is read only once, edges refer to area index until
+           the list is sorted */
+        if (scan)
+            add_area_edges(Points, i);
     }
     if (nareas_selected > 0) {
         /* sort the list by size */
@@ -158,9 +229,216 @@ int sort_areas(struct Map_info *Map, struct line_pnts *Points, int field,
     }
     Vect_destroy_cats_struct(Cats);
 
+    if (scan && nareas_selected > 0) {
+        rank = (int *)G_malloc(nareas * sizeof(int));
+        for (i = 0; i < nareas; i++)
+            rank[list[i].index - 1] = i;
+        for (e = 0; e < et.nedges; e++)
+            et.edges[e].area = rank[et.edges[e].area];
+        G_free(rank);
+
+        qsort(et.edges, et.nedges, sizeof(struct edge), compare_edges);
+        G_debug(1, "%zu area edges", et.nedges);
+    }
+    else if (scan) {
+        G_free(et.edges);
+        et.edges = NULL;
+        et.nedges = et.nalloc = 0;
+    }
+
     return nareas_selected;
 }
 
+/* add edges of area polygon to edge table */
+static void add_area_edges(struct line_pnts *Points, int area)
+{
+    int i;
+    double x0, y0, x1, y1, xmin, xmax;
+
+    if (Points->n_points < 3)
+        return;
+
+    /* skip areas left or right of the region */
+    xmin = xmax = Points->x[0];
+    for (i = 1; i < Points->n_points; i++) {
+        if (Points->x[i] < xmin)
+            xmin = Points->x[i];
+        if (Points->x[i] > xmax)
+            xmax = Points->x[i];
+    }
+    if (et.xconv * (xmax - et.window.west) - 0.5 < 0 ||
+        et.xconv * (xmin - et.window.west) - 0.5 > et.window.cols - 1)
+        return;
+
+    /* same transformation as G_setup_plot() by raster.c */
+    x0 = et.xconv * (Points->x[Points->n_points - 1] - et.window.west) - 0.5;
+    y0 = et.yconv * (et.window.north - Points->y[Points->n_points - 1]) - 0.5;
+    for (i = 0; i < Points->n_points; i++) {
+        x1 = et.xconv * (Points->x[i] - et.window.west) - 0.5;
+        y1 = et.yconv * (et.window.north - Points->y[i]) - 0.5;
+        add_edge(x0, y0, x1, y1, area);
+        x0 = x1;
+        y0 = y1;
+    }
+}
+
+/* add edge crossing row centers, follows G_plot_polygon() */
+static void add_edge(double x0, double y0, double x1, double y1, int area)
+{
+    double d, lo, hi;
+    int ystart, ystop, exp;
+    struct edge *edge;
+
+    /* tolerance to avoid FPE */
+    d = GRASS_EPSILON;
+    if (y0 != y1) {
+        d = frexp(fabs(y0) > fabs(y1) ? fabs(y0) : fabs(y1), &exp);
+        d = ldexp(d, exp - 53);
+    }
+    if (fabs(y0 - y1) < d)
+        return;
+
+    lo = y0 < y1 ? y0 : y1;
+    hi = y0 < y1 ? y1 : y0;
+    if (hi < 0 || lo > et.window.rows - 1)
+        return;
+
+    ystart = lo < 0 ? 0 : (int)ceil(lo);
+    if (hi > et.window.rows - 1)
+        ystop = et.window.rows - 1;
+    else {
+        ystop = (int)floor(hi);
+        if (ystop == hi)
+            ystop--; /* if line stops at row center, don't include point */
+    }
+    if (ystart > ystop)
+        return; /* does not cross center line of row */
+
+    if (et.nedges == et.nalloc) {
+        et.nalloc = et.nalloc ? et.nalloc * 2 : 1024;
+        et.edges = G_realloc(et.edges, et.nalloc * sizeof(struct edge));
+    }
+    edge = &et.edges[et.nedges++];
+    edge->m = (x0 - x1) / (y0 - y1);
+    edge->x = edge->m * (ystart - y0) + x0;
+    edge->ystart = ystart;
+    edge->ystop = ystop;
+    edge->area = area;
+}
+
+/* set values of areas plotted by scan_areas() */
+int set_area_values(dbCatValArray *Cvarr, int ctype, int use, double value,
+                    int value_type)
+{
+    int i;
+    CELL cval;
+    DCELL dval;
+
+    et.values = G_malloc(nareas * sizeof(struct value));
+    for (i = 0; i < nareas; i++) {
+        if (get_value(list[i].cat, Cvarr, ctype, use, value, value_type,
+                      &cval, &dval) == CELL_TYPE) {
+            et.values[i].null = ISNULL(&cval);
+            et.values[i].val = cval;
+        }
+        else {
+            et.values[i].null = ISDNULL(&dval);
+            et.values[i].val = dval;
+        }
+    }
+
+    return 0;
+}
+
+/*
+   plot areas into current page from the edge table, the rows of the
+   page are split among threads
+ */
+int scan_areas(int nprocs)
+{
+    int first, nrows;
+    size_t i, j;
+
+    nrows = page_rows(&first);
+
+    /* activate edges starting in this page, drop edges ending above it */
+    while (et.next < et.nedges && et.edges[et.next].ystart < first + nrows) {
+        if (et.nactive == et.nalloc_active) {
+            et.nalloc_active = et.nalloc_active ? et.nalloc_active * 2 : 1024;
+            et.active =
+                G_realloc(et.active, et.nalloc_active * sizeof(size_t));
+        }
+        et.active[et.nactive++] = et.next++;
+    }
+    for (i = j = 0; i < et.nactive; i++) {
+        if (et.edges[et.active[i]].ystop >= first)
+            et.active[j++] = et.active[i];
+    }
+    et.nactive = j;
+
+    G_important_message(_("Plotting areas..."));
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+    {
+        int t_id = 0, nthreads = 1;
+        int row, row0, row1, col1, col2;
+        size_t k, ncross, nalloc;
+        struct crossing *cross;
+        struct edge *edge;
+        struct value *value;
+
+#if defined(_OPENMP)
+        t_id = omp_get_thread_num();
+        nthreads = omp_get_num_threads();
+#endif
+        row0 = first + (int)((long)nrows * t_id / nthreads);
+        row1 = first + (int)((long)nrows * (t_id + 1) / nthreads);
+
+        /* crossings of row centers of this thread */
+        cross = NULL;
+        ncross = nalloc = 0;
+        for (k = 0; k < et.nactive; k++) {
+            edge = &et.edges[et.active[k]];
+            for (row = edge->ystart > row0 ? edge->ystart : row0;
+                 row <= edge->ystop && row < row1; row++) {
+                if (ncross == nalloc) {
+                    nalloc = nalloc ? nalloc * 2 : 1024;
+                    cross = G_realloc(cross, nalloc * sizeof(struct crossing));
+                }
+                cross[ncross].x = edge->x + edge->m * (row - edge->ystart);
+                cross[ncross].row = row;
+                cross[ncross++].area = edge->area;
+            }
+        }
+
+        /* larger areas first, fill between pairs of crossings */
+        qsort(cross, ncross, sizeof(struct crossing), compare_crossings);
+        k = 0;
+        while (k + 1 < ncross) {
+            if (cross[k].row != cross[k + 1].row ||
+                cross[k].area != cross[k + 1].area) {
+                k++;
+                continue;
+            }
+            if (cross[k].x < et.window.cols && cross[k + 1].x > -1) {
+                col1 = cross[k].x < 0 ? 0 : (int)ceil(cross[k].x);
+                col2 = cross[k + 1].x > et.window.cols - 1
+                           ? et.window.cols - 1
+                           : (int)floor(cross[k + 1].x);
+                value = &et.values[cross[k].area];
+                if (col1 <= col2)
+                    fill_row(cross[k].row - first, col1, col2, value->val,
+                             value->null);
+            }
+            k += 2;
+        }
+
+        G_free(cross);
+    }
+
+    return nareas;
+}
+
 static int compare(const void *aa, const void *bb)
 {
     const struct list *a = aa, *b = bb;
@@ -172,3 +450,31 @@ static int compare(const void *aa, const void *bb)
 
     return 0;
 }
+
+static int compare_edges(const void *aa, const void *bb)
+{
+    const struct edge *a = aa, *b = bb;
+
+    if (a->ystart < b->ystart)
+        return -1;
+    if (a->ystart > b->ystart)
+        return 1;
+
+    return 0;
+}
+
+static int compare_crossings(const void *aa, const void *bb)
+{
+    const struct crossing *a = aa, *b = bb;
+
+    if (a->row != b->row)
+        return a->row < b->row ? -1 : 1;
+    if (a->area != b->area)
+        return a->area < b->area ? -1 : 1;
+    if (a->x < b->x)
+        return -1;
+    if (a->x > b->x)
+        return 1;
+
+    return 0;
+}
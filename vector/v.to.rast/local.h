@@ -23,7 +23,10 @@
 /* do_areas.c */
 int do_areas(struct Map_info *, struct line_pnts *, dbCatValArray *, int, int,
              double, int);
-int sort_areas(struct Map_info *, struct line_pnts *, int, struct cat_list *);
+int sort_areas(struct Map_info *, struct line_pnts *, int, struct cat_list *,
+               int);
+int set_area_values(dbCatValArray *, int, int, double, int);
+int scan_areas(int);
 
 /* do_lines.c */
 int do_lines(struct Map_info *, struct line_pnts *, dbCatValArray *, int, int,
@@ -35,6 +38,8 @@ void setup_plot(double, double, double, double, int (*dot)(int, int));
 /* raster.c */
 int begin_rasterization(int, int, int);
 int output_raster(int);
+int page_rows(int *);
+void fill_row(int, int, int, DCELL, int);
 int set_cat(CELL);
 int set_dcat(DCELL);
 
@@ -49,6 +54,6 @@ int update_cats(const char *);
 /* vect2rast.c */
 int vect_to_rast(const char *, const char *, const char *, const char *, int,
                  int, double, int, const char *, const char *, int, char *,
-                 char *, int);
+                 char *, int, int);
 
 #endif
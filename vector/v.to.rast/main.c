@@ -12,7 +12,7 @@
  *               OGR support by Martin Landa <landa.martin gmail.com>
  *               Markus Metz (labelcol, cats, where options)
  * PURPOSE:      Converts vector map to raster map
- * COPYRIGHT:    (C) 2003-2024 by the GRASS Development Team
+ * COPYRIGHT:    (C) 2003-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -33,9 +33,10 @@ int main(int argc, char *argv[])
 {
     struct GModule *module;
     struct Option *input, *output, *memory, *col, *use_opt, *val_opt,
-        *field_opt, *type_opt, *where_opt, *cats_opt, *rgbcol_opt, *label_opt;
+        *field_opt, *type_opt, *where_opt, *cats_opt, *rgbcol_opt, *label_opt,
+        *nprocs_opt;
     struct Flag *dense_flag;
-    int cache_mb, use, value_type, type;
+    int cache_mb, use, value_type, type, nprocs;
     double value;
     char *desc;
 
@@ -46,6 +47,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("conversion"));
     G_add_keyword(_("raster"));
     G_add_keyword(_("rasterization"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Converts (rasterize) a vector map into a raster map.");
 
@@ -108,6 +110,8 @@ int main(int argc, char *argv[])
 
     memory = G_define_standard_option(G_OPT_MEMORYMB);
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     dense_flag = G_define_flag();
     dense_flag->key = 'd';
     dense_flag->label = _("Create densified lines (default: thin lines)");
@@ -119,6 +123,8 @@ int main(int argc, char *argv[])
 
     type = Vect_option_to_types(type_opt);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+
     cache_mb = atoi(memory->answer);
     if (cache_mb < 1) {
         G_warning(_("Cache size must be at least 1 MiB, changing %d to 1"),
@@ -165,7 +171,8 @@ int main(int argc, char *argv[])
     if (vect_to_rast(input->answer, output->answer, field_opt->answer,
                      col->answer, cache_mb, use, value, value_type,
                      rgbcol_opt->answer, label_opt->answer, type,
-                     where_opt->answer, cats_opt->answer, dense_flag->answer)) {
+                     where_opt->answer, cats_opt->answer, dense_flag->answer,
+                     nprocs)) {
         exit(EXIT_FAILURE);
     }
 
@@ -169,6 +169,42 @@ int output_raster(int fd)
     return configure_plot();
 }
 
+/* first row and number of rows of the current page */
+int page_rows(int *first)
+{
+    *first = at_row;
+
+    return page.rows;
+}
+
+/* set cells col1 to col2 of page row, may be called from several threads
+   for different rows */
+void fill_row(int row, int col1, int col2, DCELL val, int null)
+{
+    int col;
+
+    if (col1 < 0)
+        col1 = 0;
+    if (col2 >= page.cols)
+        col2 = page.cols - 1;
+    if (null)
+        val = 0;
+
+    switch (format) {
+    case CELL_TYPE:
+        for (col = col1; col <= col2; col++)
+            raster.cell[row][col] = (CELL)val;
+        break;
+    case DCELL_TYPE:
+        for (col = col1; col <= col2; col++)
+            raster.dcell[row][col] = val;
+        break;
+    }
+
+    for (col = col1; col <= col2; col++)
+        null_flags[row][col] = null;
+}
+
 int set_cat(CELL x)
 {
     cat = x;
@@ -71,6 +71,7 @@ int update_dbcolors(const char *rast_name, const char *vector_map, int field,
     struct field_info *Fi;
     dbDriver *Driver;
     dbCatValArray cvarr;
+    dbAttrCache cache;
 
     /* colors */
     int cat;
@@ -119,6 +120,12 @@ int update_dbcolors(const char *rast_name, const char *vector_map, int field,
 
     G_debug(3, "nrec = %d", nrec);
 
+    /* colors of all records, looked up by category */
+    if (db_select_attr_cache(Driver, Fi->table, Fi->key, rgb_column, NULL,
+                             &cache) < 0)
+        G_fatal_error(_("Unknown column <%s> in table <%s>"), rgb_column,
+                      Fi->table);
+
     /* allocate space for color rules */
     my_color_rules =
         (struct My_color_rule *)G_malloc(sizeof(struct My_color_rule) * nrec);
@@ -126,16 +133,17 @@ int update_dbcolors(const char *rast_name, const char *vector_map, int field,
     /* for each attribute */
     for (i = 0; i < cvarr.n_values; i++) {
         char colorstring[12];
-        dbValue value;
+        dbValue *value;
 
         /* selecect color attribute and category */
         cat = cvarr.value[i].cat;
-        if (db_select_value(Driver, Fi->table, Fi->key, cat, rgb_column,
-                            &value) < 0) {
+        if (!(value = db_attr_cache_get_value(&cache, cat, 1))) {
             G_warning(_("No records selected"));
             continue;
         }
-        snprintf(colorstring, sizeof(colorstring), "%s", value.s.string);
+        snprintf(colorstring, sizeof(colorstring), "%s",
+                 db_test_value_isnull(value) ? ""
+                                             : db_get_value_string(value));
 
         /* convert color string to three color integers */
         if (*colorstring != '\0') {
@@ -173,6 +181,8 @@ int update_dbcolors(const char *rast_name, const char *vector_map, int field,
         }
     } /* /for each value in database */
 
+    db_free_attr_cache(&cache);
+
     /* close the database driver */
     db_close_database_shutdown_driver(Driver);
 
@@ -239,6 +249,7 @@ int update_labels(const char *rast_name, const char *vector_map, int field,
     struct field_info *Fi;
     dbDriver *Driver;
     dbCatValArray cvarr;
+    dbAttrCache cache;
     int col_type;
 
     /* labels */
@@ -297,14 +308,19 @@ int update_labels(const char *rast_name, const char *vector_map, int field,
             G_fatal_error(_("Column <%s> not found"), label_column);
         }
 
+        /* labels of all records, looked up by category */
+        if (db_select_attr_cache(Driver, Fi->table, Fi->key, label_column,
+                                 NULL, &cache) < 0)
+            G_fatal_error(_("Unknown column <%s> in table <%s>"),
+                          label_column, Fi->table);
+
         /* for each attribute */
         for (i = 0; i < cvarr.n_values; i++) {
             char tmp[64];
-            dbValue value;
+            dbValue *value;
             int cat = cvarr.value[i].cat;
 
-            if (db_select_value(Driver, Fi->table, Fi->key, cat, label_column,
-                                &value) < 0) {
+            if (!(value = db_attr_cache_get_value(&cache, cat, 1))) {
                 G_warning(_("No records selected"));
                 continue;
             }
@@ -316,16 +332,18 @@ int update_labels(const char *rast_name, const char *vector_map, int field,
             /* switch the column type */
             switch (col_type) {
             case DB_C_TYPE_DOUBLE:
-                snprintf(tmp, sizeof(tmp), "%lf", db_get_value_double(&value));
+                snprintf(tmp, sizeof(tmp), "%lf", db_get_value_double(value));
                 db_set_string(&my_labels_rules[i].label, tmp);
                 break;
             case DB_C_TYPE_INT:
-                snprintf(tmp, sizeof(tmp), "%d", db_get_value_int(&value));
+                snprintf(tmp, sizeof(tmp), "%d", db_get_value_int(value));
                 db_set_string(&my_labels_rules[i].label, tmp);
                 break;
             case DB_C_TYPE_STRING:
                 db_set_string(&my_labels_rules[i].label,
-                              db_get_value_string(&value));
+                              db_test_value_isnull(value)
+                                  ? ""
+                                  : db_get_value_string(value));
                 break;
             default:
                 G_warning(_("Column type (%s) not supported"),
@@ -339,6 +357,8 @@ int update_labels(const char *rast_name, const char *vector_map, int field,
                 my_labels_rules[i].i = cvarr.value[i].val.i;
         } /* for each value in database */
 
+        db_free_attr_cache(&cache);
+
         /* close the database driver */
         db_close_database_shutdown_driver(Driver);
 
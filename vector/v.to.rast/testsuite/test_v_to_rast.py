@@ -12,8 +12,11 @@ Licence:    This program is free software under the GNU General Public
             for details.
 """
 
+import math
+
 from grass.gunittest.case import TestCase
 from grass.gunittest.main import test
+from grass.script.core import read_command
 
 
 class TestParameters(TestCase):
@@ -55,5 +58,238 @@ class TestParameters(TestCase):
         self.assertRasterFitsInfo(raster=self.output, reference={"min": 1, "max": 1})
 
 
+class TestAreas(TestCase):
+    """Test rasterization of areas in row bands and threads"""
+
+    output = "zipcodes_cat"
+    reference = "zipcodes_cat_ref"
+
+    @classmethod
+    def setUpClass(cls):
+        """Specify region for raster creation for this class"""
+        cls.use_temp_region()
+        cls.runModule("g.region", vector="zipcodes", res=10, flags="a")
+        cls.runModule("v.to.rast", input="zipcodes", output=cls.reference, use="cat")
+
+    @classmethod
+    def tearDownClass(cls):
+        """Remove temporary region and reference map"""
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.reference)
+
+    def tearDown(self):
+        """Remove maps after each test method"""
+        self.runModule(
+            "g.remove",
+            flags="f",
+            type="raster",
+            name=[self.output],
+        )
+
+    def test_row_bands(self):
+        """Check that areas split into many row bands give the same map"""
+        self.assertModule(
+            "v.to.rast", input="zipcodes", output=self.output, use="cat", memory=1
+        )
+        self.assertRastersNoDifference(
+            actual=self.output, reference=self.reference, precision=0
+        )
+
+    def test_nprocs(self):
+        """Check that areas plotted by threads give the same map"""
+        self.assertModule(
+            "v.to.rast",
+            input="zipcodes",
+            output=self.output,
+            use="cat",
+            memory=1,
+            nprocs=4,
+        )
+        self.assertRastersNoDifference(
+            actual=self.output, reference=self.reference, precision=0
+        )
+
+
+# area with category 1 and, inside it, the area of its island with
+# category 2, vertices are off the cell centers of the region of
+# TestAreaCells
+OUTER = [
+    (10.33, 10.71),
+    (390.27, 5.43),
+    (395.61, 60.12),
+    (200.42, 95.38),
+    (4.93, 70.24),
+]
+INNER = [(100.21, 30.64), (300.77, 35.31), (150.13, 75.86)]
+RES = 0.1
+ROWS = 1000
+COLS = 4000
+
+
+def count_cells(polygon):
+    """Count cells whose centers are inside of a polygon
+
+    Crossings of the polygon with each row of cell centers are paired
+    and the columns between them are counted.
+    """
+    # cell coordinates, cell centers are at whole numbers
+    points = [(x / RES - 0.5, (ROWS * RES - y) / RES - 0.5) for x, y in polygon]
+    count = 0
+    for row in range(ROWS):
+        crossings = []
+        x0, y0 = points[-1]
+        for x1, y1 in points:
+            if (y0 > row) != (y1 > row):
+                crossings.append(x0 + (row - y0) * (x1 - x0) / (y1 - y0))
+            x0, y0 = x1, y1
+        crossings.sort()
+        for left, right in zip(crossings[::2], crossings[1::2]):
+            first = max(math.floor(left) + 1, 0)
+            last = min(math.ceil(right) - 1, COLS - 1)
+            count += max(last - first + 1, 0)
+    return count
+
+
+def boundary(polygon):
+    """Closed boundary in the standard vector ASCII format"""
+    points = [*polygon, polygon[0]]
+    return f"B {len(points)}\n" + "".join(f" {x} {y}\n" for x, y in points)
+
+
+class TestAreaCells(TestCase):
+    """Test that areas fill the cells whose centers they contain, smaller
+    areas over larger ones, against counts of cells computed here"""
+
+    vector = "test_v_to_rast_areas"
+    output = "test_v_to_rast_areas"
+
+    @classmethod
+    def setUpClass(cls):
+        """Create the areas and count the cell centers of each category"""
+        cls.use_temp_region()
+        cls.runModule("g.region", n=ROWS * RES, s=0, e=COLS * RES, w=0, res=RES)
+        data = (
+            boundary(OUTER)
+            + boundary(INNER)
+            + "C 1 1\n 20 40\n 1 1\n"
+            + "C 1 1\n 180 45\n 1 2\n"
+        )
+        cls.runModule(
+            "v.in.ascii",
+            input="-",
+            output=cls.vector,
+            format="standard",
+            flags="n",
+            stdin_=data,
+        )
+        # the island is inside of the outer area and plotted over it
+        inner = count_cells(INNER)
+        cls.counts = {1: count_cells(OUTER) - inner, 2: inner}
+
+    @classmethod
+    def tearDownClass(cls):
+        """Remove temporary region and vector map"""
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="vector", name=cls.vector)
+
+    def tearDown(self):
+        """Remove maps after each test method"""
+        self.runModule("g.remove", flags="f", type="raster", name=self.output)
+
+    def assertCellCounts(self):
+        """Check the number of cells of each category"""
+        counts = {}
+        for line in read_command("r.stats", flags="cn", input=self.output).splitlines():
+            if line:
+                cat, count = line.split()
+                counts[int(cat)] = int(count)
+        self.assertEqual(counts, self.counts)
+
+    def test_cells(self):
+        """Check cells of areas plotted in one band"""
+        self.assertModule("v.to.rast", input=self.vector, output=self.output, use="cat")
+        self.assertCellCounts()
+
+    def test_row_bands_nprocs(self):
+        """Check cells of areas plotted in row bands by threads"""
+        self.assertModule(
+            "v.to.rast",
+            input=self.vector,
+            output=self.output,
+            use="cat",
+            memory=1,
+            nprocs=4,
+        )
+        self.assertCellCounts()
+
+
+class TestAttributes(TestCase):
+    """Test labels and colors looked up by category"""
+
+    vector = "zipcodes_attr"
+    output = "zipcodes_attr"
+
+    @classmethod
+    def setUpClass(cls):
+        """Copy zipcodes with label and color columns"""
+        cls.use_temp_region()
+        cls.runModule("g.region", vector="zipcodes", res=10, flags="a")
+        cls.runModule("g.copy", vector=("zipcodes", cls.vector))
+        cls.runModule("v.db.addcolumn", map=cls.vector, columns="label text,rgb text")
+        cls.runModule(
+            "v.db.update", map=cls.vector, column="label", query_column="'zip' || cat"
+        )
+        cls.runModule(
+            "v.db.update",
+            map=cls.vector,
+            column="rgb",
+            query_column="(cat % 256) || ':' || (cat * 7 % 256) || ':0'",
+        )
+        cls.runModule(
+            "v.to.rast",
+            input=cls.vector,
+            output=cls.output,
+            use="attr",
+            attribute_column="cat",
+            label_column="label",
+            rgb_column="rgb",
+        )
+        cls.cats = [
+            int(cat)
+            for cat in read_command(
+                "v.db.select", map=cls.vector, columns="cat", flags="c"
+            ).split()
+        ]
+
+    @classmethod
+    def tearDownClass(cls):
+        """Remove temporary region and maps"""
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.output)
+        cls.runModule("g.remove", flags="f", type="vector", name=cls.vector)
+
+    def test_labels(self):
+        """Each category has the label of its record"""
+        labels = dict(
+            line.split("|", 1)
+            for line in read_command(
+                "r.category", map=self.output, separator="pipe"
+            ).splitlines()
+        )
+        for cat in self.cats:
+            self.assertEqual(labels[str(cat)], f"zip{cat}")
+
+    def test_colors(self):
+        """Each category has the color of its record"""
+        colors = dict(
+            line.split(": ", 1)
+            for line in read_command(
+                "r.what.color", input=self.output, value=self.cats
+            ).splitlines()
+        )
+        for cat in self.cats:
+            self.assertEqual(colors[str(cat)], f"{cat % 256}:{cat * 7 % 256}:0")
+
+
 if __name__ == "__main__":
     test()
@@ -10,7 +10,7 @@ int vect_to_rast(const char *vector_map, const char *raster_map,
                  const char *field_name, const char *column, int cache_mb,
                  int use, double value, int value_type, const char *rgbcolumn,
                  const char *labelcolumn, int ftype, char *where, char *cats,
-                 int dense)
+                 int dense, int nprocs)
 {
     struct Map_info Map;
     struct line_pnts *Points;
@@ -22,6 +22,7 @@ int vect_to_rast(const char *vector_map, const char *raster_map,
     int stat;
     int format;
     int pass, npasses;
+    int scan;
 
     /* Attributes */
     int nrec;
@@ -137,11 +138,16 @@ int vect_to_rast(const char *vector_map, const char *raster_map,
 
     Points = Vect_new_line_struct();
 
+    /* areas are plotted from a table of their edges built once, except
+       for latlon where G_plot_polygon() handles the wrap-around */
+    scan = G_projection() != PROJECTION_LL;
     if (use != USE_Z && use != USE_D && (ftype & GV_AREA)) {
-        nareas = sort_areas(&Map, Points, field, cat_list);
+        nareas = sort_areas(&Map, Points, field, cat_list, scan);
         G_verbose_message(
             _("Number of areas selected from vector map <%s>: %d"), vector_map,
             nareas);
+        if (scan && nareas > 0)
+            set_area_values(&cvarr, ctype, use, value, value_type);
     }
     if (nareas > 0 && dense) {
         G_warning(_("Area conversion and line densification are mutually "
@@ -185,7 +191,9 @@ int vect_to_rast(const char *vector_map, const char *raster_map,
 
         stat = 0;
 
-        if ((use != USE_Z && use != USE_D) && nareas) {
+        if ((use != USE_Z && use != USE_D) && nareas && scan)
+            scan_areas(nprocs);
+        else if ((use != USE_Z && use != USE_D) && nareas) {
             if (do_areas(&Map, Points, &cvarr, ctype, use, value, value_type) <
                 0) {
                 G_warning(_("Problem processing areas from vector map <%s>, "
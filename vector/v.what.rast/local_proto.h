@@ -1,4 +1,5 @@
 #include <grass/gis.h>
+#include <grass/raster.h>
 
 struct order {
     int cat;   /* point category */
@@ -6,10 +7,20 @@ struct order {
     int row;
     int col;
     double x, y; /* used with interp flag */
-    CELL value;
-    DCELL dvalue; /* used for FCELL and DCELL */
 };
 
+/* queried raster map */
+struct rmap {
+    const char *name;
+    const char *column;    /* column to be updated */
+    RASTER_MAP_TYPE type;
+    int width;             /* number of significant digits of values */
+};
+
+/* sample.c */
+void sample_rasters(struct order *, int, struct rmap *, int,
+                    const struct Cell_head *, int, int, DCELL *);
+
 /* search.c */
 int by_row(const void *, const void *);
 int by_cat(const void *, const void *);
@@ -9,7 +9,7 @@
  *
  *  PURPOSE:     Query raster map
  *
- *  COPYRIGHT:   (C) 2001-2015 by the GRASS Development Team
+ *  COPYRIGHT:   (C) 2001-2026 by the GRASS Development Team
  *
  *               This program is free software under the GNU General
  *               Public License (>=v2).  Read the file COPYING that
@@ -28,24 +28,21 @@
 
 int main(int argc, char *argv[])
 {
-    int i, j, type, field, cat, vtype, open_level;
-    int fd;
+    int i, j, m, type, field, cat, vtype, open_level;
+    int nmaps, nprocs;
 
     /* struct Categories RCats; */ /* TODO */
     struct Cell_head window;
-    RASTER_MAP_TYPE out_type;
-    CELL *cell_row, *prev_c_row, *next_c_row;
-    DCELL *dcell_row, *prev_d_row, *next_d_row;
-    int width;
+    struct rmap *rmaps;
+    DCELL *values, *val;
     int row, col;
     char buf[DB_SQL_MAX];
     struct {
-        struct Option *vect, *rast, *field, *type, *col, *where;
+        struct Option *vect, *rast, *field, *type, *col, *where, *nprocs;
     } opt;
     struct Flag *interp_flag, *print_flag;
     int Cache_size;
     struct order *cache;
-    int cur_row;
     struct GModule *module;
 
     struct Map_info Map;
@@ -62,7 +59,10 @@ int main(int argc, char *argv[])
     struct field_info *Fi;
     dbString stmt;
     dbDriver *driver;
+    dbBulk bulk;
+    dbValue *value;
     int select, norec_cnt, update_cnt, upderr_cnt, col_type;
+    int *ctype;
 
     G_gisinit(argv[0]);
 
@@ -74,6 +74,7 @@ int main(int argc, char *argv[])
     G_add_keyword(_("querying"));
     G_add_keyword(_("attribute table"));
     G_add_keyword(_("surface information"));
+    G_add_keyword(_("parallel"));
     module->description =
         _("Uploads raster values at positions of vector points to the table.");
 
@@ -87,18 +88,21 @@ int main(int argc, char *argv[])
     opt.type->options = "point,centroid";
     opt.type->answer = "point";
 
-    opt.rast = G_define_standard_option(G_OPT_R_MAP);
+    opt.rast = G_define_standard_option(G_OPT_R_MAPS);
     opt.rast->key = "raster";
-    opt.rast->description = _("Name of existing raster map to be queried");
+    opt.rast->description = _("Name of existing raster map(s) to be queried");
 
-    opt.col = G_define_standard_option(G_OPT_DB_COLUMN);
+    opt.col = G_define_standard_option(G_OPT_DB_COLUMNS);
+    opt.col->key = "column";
     opt.col->required =
         NO; /* YES, but suppress_required only for this option */
-    opt.col->description =
-        _("Name of attribute column to be updated with the query result");
+    opt.col->description = _("Name of attribute column(s) to be updated with "
+                             "the query result (one per raster map)");
 
     opt.where = G_define_standard_option(G_OPT_DB_WHERE);
 
+    opt.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     interp_flag = G_define_flag();
     interp_flag->key = 'i';
     interp_flag->description =
@@ -112,12 +116,30 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(opt.nprocs);
+    if (nprocs > 1 && Rast_mask_is_present()) {
+        G_warning(_("Parallel processing disabled due to active mask."));
+        nprocs = 1;
+    }
+
     db_init_string(&stmt);
     Points = Vect_new_line_struct();
     Cats = Vect_new_cats_struct();
 
-    if (!print_flag->answer && !opt.col->answer)
-        G_fatal_error(_("Required parameter <%s> not set"), opt.col->key);
+    for (nmaps = 0; opt.rast->answers[nmaps]; nmaps++)
+        ;
+
+    if (!print_flag->answer) {
+        if (!opt.col->answer)
+            G_fatal_error(_("Required parameter <%s> not set"), opt.col->key);
+
+        for (i = 0; opt.col->answers[i]; i++)
+            ;
+        if (i != nmaps)
+            G_fatal_error(_("Number of columns (%d) does not match number of "
+                            "raster maps (%d)"),
+                          i, nmaps);
+    }
 
     G_get_window(&window);
     Vect_region_box(&window, &box); /* T and B set to +/- PORT_DOUBLE_MAX */
@@ -146,14 +168,20 @@ int main(int argc, char *argv[])
         db_set_error_handler_driver(driver);
     }
 
-    /* Open raster */
-    fd = Rast_open_old(opt.rast->answer, "");
-
-    out_type = Rast_get_map_type(fd);
-
-    width = 15;
-    if (out_type == FCELL_TYPE)
-        width = 7;
+    /* Check rasters */
+    rmaps = G_calloc(nmaps, sizeof(struct rmap));
+    for (m = 0; m < nmaps; m++) {
+        rmaps[m].name = opt.rast->answers[m];
+        rmaps[m].type = Rast_map_type(rmaps[m].name, "");
+        if (rmaps[m].type < 0)
+            G_fatal_error(_("Raster map <%s> not found"), rmaps[m].name);
+
+        rmaps[m].width = 15;
+        if (rmaps[m].type == FCELL_TYPE)
+            rmaps[m].width = 7;
+        if (!print_flag->answer)
+            rmaps[m].column = opt.col->answers[m];
+    }
 
     /* TODO: Later possibly category labels */
     /*
@@ -161,32 +189,33 @@ int main(int argc, char *argv[])
        G_fatal_error ( "Cannot read category file");
      */
 
-    if (!print_flag->answer) {
-        col_type = db_column_Ctype(driver, Fi->table, opt.col->answer);
+    for (m = 0; m < nmaps && !print_flag->answer; m++) {
+        col_type = db_column_Ctype(driver, Fi->table, rmaps[m].column);
 
         if (col_type == -1) {
             /* column doesn't exist, create it */
             G_important_message(
                 _("Column <%s> not found in the table <%s>. Creating..."),
-                opt.col->answer, Fi->table);
+                rmaps[m].column, Fi->table);
             snprintf(buf, sizeof(buf),
                      "ALTER TABLE \"%s\" ADD COLUMN \"%s\" %s", Fi->table,
-                     opt.col->answer,
-                     out_type == CELL_TYPE ? "INTEGER" : "DOUBLE PRECISION");
+                     rmaps[m].column,
+                     rmaps[m].type == CELL_TYPE ? "INTEGER"
+                                                : "DOUBLE PRECISION");
             db_set_string(&stmt, buf);
             if (db_execute_immediate(driver, &stmt) != DB_OK)
                 G_fatal_error(_("Unable to add column <%s> to table <%s>"),
-                              opt.col->answer, Fi->table);
+                              rmaps[m].column, Fi->table);
         }
         else {
             /* check column type */
             if (col_type != DB_C_TYPE_INT && col_type != DB_C_TYPE_DOUBLE)
                 G_fatal_error(_("Column type not supported"));
 
-            if (out_type == CELL_TYPE && col_type == DB_C_TYPE_DOUBLE)
+            if (rmaps[m].type == CELL_TYPE && col_type == DB_C_TYPE_DOUBLE)
                 G_warning(_("Raster type is integer and column type is float"));
 
-            if (out_type != CELL_TYPE && col_type == DB_C_TYPE_INT)
+            if (rmaps[m].type != CELL_TYPE && col_type == DB_C_TYPE_INT)
                 G_warning(_("Raster type is float and column type is integer, "
                             "some data lost!!"));
         }
@@ -307,280 +336,49 @@ int main(int argc, char *argv[])
     /* Sort cache by current region row */
     qsort(cache, point_cnt, sizeof(struct order), by_row);
 
-    /* Allocate space for raster row */
-    if (out_type == CELL_TYPE)
-        cell_row = Rast_allocate_c_buf();
-    else
-        dcell_row = Rast_allocate_d_buf();
-
-    if (interp_flag->answer) {
-        if (out_type == CELL_TYPE) {
-            prev_c_row = Rast_allocate_c_buf();
-            next_c_row = Rast_allocate_c_buf();
-        }
-        else {
-            prev_d_row = Rast_allocate_d_buf();
-            next_d_row = Rast_allocate_d_buf();
-        }
-
+    if (interp_flag->answer)
         G_begin_distance_calculations();
-    }
 
-    /* Extract raster values from file and store in cache */
+    /* Extract raster values from files */
     G_debug(1, "Extracting raster values");
+    G_message(n_("Sampling %d raster map...", "Sampling %d raster maps...",
+                 nmaps),
+              nmaps);
 
-    cur_row = -1;
+    values = G_malloc((size_t)point_cnt * nmaps * sizeof(DCELL));
+    sample_rasters(cache, point_cnt, rmaps, nmaps, &window,
+                   interp_flag->answer, nprocs, values);
 
+    dupl_cnt = 0;
     for (point = 0; point < point_cnt; point++) {
-        if (cache[point].count > 1)
-            continue; /* duplicate cats */
-
-        if (cur_row != cache[point].row) {
-            if (out_type == CELL_TYPE) {
-                Rast_get_c_row(fd, cell_row, cache[point].row);
-
-                if (interp_flag->answer) {
-                    if (cache[point].row <= 0)
-                        Rast_set_null_value(prev_c_row, window.cols, out_type);
-                    else
-                        Rast_get_c_row(fd, prev_c_row, cache[point].row - 1);
-
-                    if (cache[point].row + 1 > window.rows - 1)
-                        Rast_set_null_value(next_c_row, window.cols, out_type);
-                    else
-                        Rast_get_c_row(fd, next_c_row, cache[point].row + 1);
-                }
-            }
-            else {
-                Rast_get_d_row(fd, dcell_row, cache[point].row);
-
-                if (interp_flag->answer) {
-                    if (cache[point].row <= 0)
-                        Rast_set_null_value(prev_d_row, window.cols,
-                                            DCELL_TYPE);
-                    else
-                        Rast_get_d_row(fd, prev_d_row, cache[point].row - 1);
-
-                    if (cache[point].row + 1 > window.rows - 1)
-                        Rast_set_null_value(next_d_row, window.cols,
-                                            DCELL_TYPE);
-                    else
-                        Rast_get_d_row(fd, next_d_row, cache[point].row + 1);
-                }
-            }
-        }
-        cur_row = cache[point].row;
-
-        if (!interp_flag->answer) {
-            if (out_type == CELL_TYPE)
-                cache[point].value = cell_row[cache[point].col];
-            else
-                cache[point].dvalue = dcell_row[cache[point].col];
-        }
-        else {
-            /* do four-way IDW */
-            /* TODO: optimize, parallelize, and function-ize! */
-            double distance[4], weight[4];
-            double weightsum, valweight;
-            int col_offset, row_offset;
-
-            weightsum = valweight = 0;
-
-            if (cache[point].x <
-                Rast_col_to_easting(cache[point].col, &window) +
-                    window.ew_res / 2)
-                col_offset = -1;
-            else
-                col_offset = +1;
-
-            if (cache[point].y >
-                Rast_row_to_northing(cache[point].row, &window) -
-                    window.ns_res / 2)
-                row_offset = -1;
-            else
-                row_offset = +1;
-
-            distance[0] =
-                G_distance(cache[point].x, cache[point].y,
-                           Rast_col_to_easting(cache[point].col, &window) +
-                               window.ew_res / 2,
-                           Rast_row_to_northing(cache[point].row, &window) -
-                               window.ns_res / 2);
-
-            distance[1] = G_distance(
-                cache[point].x, cache[point].y,
-                Rast_col_to_easting(cache[point].col + col_offset, &window) +
-                    window.ew_res / 2,
-                Rast_row_to_northing(cache[point].row, &window) -
-                    window.ns_res / 2);
-
-            if (row_offset == -1) {
-                distance[2] = G_distance(
-                    cache[point].x, cache[point].y,
-                    Rast_col_to_easting(cache[point].col + col_offset,
-                                        &window) +
-                        window.ew_res / 2,
-                    Rast_row_to_northing(cache[point].row - 1, &window) -
-                        window.ns_res / 2);
-                distance[3] = G_distance(
-                    cache[point].x, cache[point].y,
-                    Rast_col_to_easting(cache[point].col, &window) +
-                        window.ew_res / 2,
-                    Rast_row_to_northing(cache[point].row - 1, &window) -
-                        window.ns_res / 2);
-            }
-            else {
-                distance[2] = G_distance(
-                    cache[point].x, cache[point].y,
-                    Rast_col_to_easting(cache[point].col + col_offset,
-                                        &window) +
-                        window.ew_res / 2,
-                    Rast_row_to_northing(cache[point].row + 1, &window) -
-                        window.ns_res / 2);
-                distance[3] = G_distance(
-                    cache[point].x, cache[point].y,
-                    Rast_col_to_easting(cache[point].col, &window) +
-                        window.ew_res / 2,
-                    Rast_row_to_northing(cache[point].row + 1, &window) -
-                        window.ns_res / 2);
-            }
-
-            if (out_type == CELL_TYPE) {
-
-                CELL nearby_c_val[4];
-
-                /* avoid infinite weights */
-                if (distance[0] < GRASS_EPSILON) {
-                    cache[point].value = cell_row[cache[point].col];
-                    continue;
-                }
-
-                nearby_c_val[0] = cell_row[cache[point].col];
-
-                if (cache[point].col + col_offset < 0 ||
-                    cache[point].col + col_offset >= window.cols) /* UNTESTED */
-                    Rast_set_null_value(&nearby_c_val[1], 1,
-                                        out_type); /* UNTESTED */
-                else
-                    nearby_c_val[1] = cell_row[cache[point].col + col_offset];
-
-                if (row_offset == -1) {
-                    if (cache[point].col + col_offset < 0 ||
-                        cache[point].col + col_offset >= window.cols)
-                        Rast_set_null_value(&nearby_c_val[2], 1, out_type);
-                    else
-                        nearby_c_val[2] =
-                            prev_c_row[cache[point].col + col_offset];
-
-                    nearby_c_val[3] = prev_c_row[cache[point].col];
-                }
-                else {
-                    if (cache[point].col + col_offset < 0 ||
-                        cache[point].col + col_offset >= window.cols)
-                        Rast_set_null_value(&nearby_c_val[2], 1, out_type);
-                    else
-                        nearby_c_val[2] =
-                            next_c_row[cache[point].col + col_offset];
-
-                    nearby_c_val[3] = next_c_row[cache[point].col];
-                }
-
-                for (i = 0; i < 4; i++) {
-                    if (!Rast_is_null_value(&nearby_c_val[i], out_type)) {
-                        weight[i] = 1.0 / (distance[i] * distance[i]);
-                        weightsum += weight[i];
-                        valweight += weight[i] * nearby_c_val[i];
-                    }
-                }
-
-                cache[point].value = valweight / weightsum;
-            }
-            else {
-                DCELL nearby_d_val[4];
-
-                /* avoid infinite weights */
-                if (distance[0] < GRASS_EPSILON) {
-                    cache[point].dvalue = dcell_row[cache[point].col];
-                    continue;
-                }
-
-                nearby_d_val[0] = dcell_row[cache[point].col];
-
-                if (cache[point].col + col_offset < 0 ||
-                    cache[point].col + col_offset >= window.cols)
-                    Rast_set_null_value(&nearby_d_val[1], 1, out_type);
-                else
-                    nearby_d_val[1] = dcell_row[cache[point].col + col_offset];
-
-                if (row_offset == -1) {
-                    if (cache[point].col + col_offset < 0 ||
-                        cache[point].col + col_offset >= window.cols)
-                        Rast_set_null_value(&nearby_d_val[2], 1, out_type);
-                    else
-                        nearby_d_val[2] =
-                            prev_d_row[cache[point].col + col_offset];
-
-                    nearby_d_val[3] = prev_d_row[cache[point].col];
-                }
-                else {
-                    if (cache[point].col + col_offset < 0 ||
-                        cache[point].col + col_offset >= window.cols)
-                        Rast_set_null_value(&nearby_d_val[2], 1, out_type);
-                    else
-                        nearby_d_val[2] =
-                            next_d_row[cache[point].col + col_offset];
-
-                    nearby_d_val[3] = next_d_row[cache[point].col];
-                }
-
-                for (i = 0; i < 4; i++) {
-                    if (!Rast_is_null_value(&nearby_d_val[i], out_type)) {
-                        weight[i] = 1.0 / (distance[i] * distance[i]);
-                        weightsum += weight[i];
-                        valweight += weight[i] * nearby_d_val[i];
-                    }
-                }
-
-                cache[point].dvalue = valweight / weightsum;
-            }
+        if (cache[point].count > 1) {
+            G_warning(_("Multiple points (%d) of category %d, value set to "
+                        "'NULL'"),
+                      cache[point].count,
+                      cache[point].cat); /* TODO: improve message */
+            dupl_cnt++;
         }
-    } /* point loop */
-    Rast_close(fd);
+    }
 
     if (print_flag->answer) {
-        dupl_cnt = 0;
-
-        if (Fi)
-            G_message("%s|value", Fi->key);
-        else
-            G_message("cat|value");
+        db_set_string(&stmt, Fi ? Fi->key : "cat");
+        for (m = 0; m < nmaps; m++) {
+            db_append_string(&stmt, "|");
+            db_append_string(&stmt, nmaps == 1 ? "value" : rmaps[m].name);
+        }
+        G_message("%s", db_get_string(&stmt));
 
         for (point = 0; point < point_cnt; point++) {
-            if (cache[point].count > 1) {
-                G_warning(_("Multiple points (%d) of category %d, value set to "
-                            "'NULL'"),
-                          cache[point].count,
-                          cache[point].cat); /* TODO: improve message */
-                dupl_cnt++;
-            }
-
-            fprintf(stdout, "%d|", cache[point].cat);
-
-            if (out_type == CELL_TYPE) {
-                if (cache[point].count > 1 ||
-                    Rast_is_c_null_value(&cache[point].value)) {
-                    fprintf(stdout, "*");
-                }
-                else
-                    fprintf(stdout, "%d", cache[point].value);
-            }
-            else { /* FCELL or DCELL */
-                if (cache[point].count > 1 ||
-                    Rast_is_d_null_value(&cache[point].dvalue)) {
-                    fprintf(stdout, "*");
-                }
-                else
-                    fprintf(stdout, "%.*g", width, cache[point].dvalue);
+            fprintf(stdout, "%d", cache[point].cat);
+
+            for (m = 0; m < nmaps; m++) {
+                val = &values[(size_t)point * nmaps + m];
+                if (Rast_is_d_null_value(val))
+                    fprintf(stdout, "|*");
+                else if (rmaps[m].type == CELL_TYPE)
+                    fprintf(stdout, "|%d", (CELL)*val);
+                else /* FCELL or DCELL */
+                    fprintf(stdout, "|%.*g", rmaps[m].width, *val);
             }
             fprintf(stdout, "\n");
         }
@@ -594,17 +392,35 @@ int main(int argc, char *argv[])
 
         db_begin_transaction(driver);
 
-        norec_cnt = update_cnt = upderr_cnt = dupl_cnt = 0;
+        /* prepare statement, the values and category are parameters */
+        ctype = G_malloc((nmaps + 1) * sizeof(int));
+        snprintf(buf, sizeof(buf), "update %s set", Fi->table);
+        db_set_string(&stmt, buf);
+        for (m = 0; m < nmaps; m++) {
+            snprintf(buf, sizeof(buf), "%s %s = ?", m > 0 ? "," : "",
+                     rmaps[m].column);
+            db_append_string(&stmt, buf);
+            ctype[m] =
+                rmaps[m].type == CELL_TYPE ? DB_C_TYPE_INT : DB_C_TYPE_DOUBLE;
+        }
+        ctype[nmaps] = DB_C_TYPE_INT;
+        snprintf(buf, sizeof(buf), " where %s = ?", Fi->key);
+        db_append_string(&stmt, buf);
+        /* user provides where condition: */
+        if (opt.where->answer) {
+            snprintf(buf, sizeof(buf), " AND %s", opt.where->answer);
+            db_append_string(&stmt, buf);
+        }
+        G_debug(3, "%s", db_get_string(&stmt));
+
+        if (db_prepare_bulk(driver, &stmt, nmaps + 1, ctype, &bulk) != DB_OK)
+            G_fatal_error(_("Unable to prepare statement: %s"),
+                          db_get_string(&stmt));
+
+        norec_cnt = 0;
 
         G_message("Update vector attributes...");
         for (point = 0; point < point_cnt; point++) {
-            if (cache[point].count > 1) {
-                G_warning(_("Multiple points (%d) of category %d, value set to "
-                            "'NULL'"),
-                          cache[point].count, cache[point].cat);
-                dupl_cnt++;
-            }
-
             G_percent(point, point_cnt, 2);
 
             /* category exist in DB ? */
@@ -617,58 +433,40 @@ int main(int argc, char *argv[])
                 continue;
             }
 
-            snprintf(buf, sizeof(buf), "update %s set %s = ", Fi->table,
-                     opt.col->answer);
-
-            db_set_string(&stmt, buf);
-
-            if (out_type == CELL_TYPE) {
-                if (cache[point].count > 1 ||
-                    Rast_is_c_null_value(&cache[point].value)) {
-                    snprintf(buf, sizeof(buf), "NULL");
-                }
-                else
-                    snprintf(buf, sizeof(buf), "%d ", cache[point].value);
-            }
-            else { /* FCELL or DCELL */
-                if (cache[point].count > 1 ||
-                    Rast_is_d_null_value(&cache[point].dvalue)) {
-                    snprintf(buf, sizeof(buf), "NULL");
+            for (m = 0; m < nmaps; m++) {
+                val = &values[(size_t)point * nmaps + m];
+                value = db_get_bulk_param(&bulk, m);
+                if (Rast_is_d_null_value(val))
+                    db_set_value_null(value);
+                else if (rmaps[m].type == CELL_TYPE)
+                    db_set_value_int(value, (CELL)*val);
+                else { /* FCELL or DCELL */
+                    /* keep the precision of the raster type */
+                    snprintf(buf, sizeof(buf), "%.*g", rmaps[m].width, *val);
+                    db_set_value_double(value, atof(buf));
                 }
-                else
-                    snprintf(buf, sizeof(buf), "%.*g", width,
-                             cache[point].dvalue);
-            }
-            db_append_string(&stmt, buf);
-
-            snprintf(buf, sizeof(buf), " where %s = %d", Fi->key,
-                     cache[point].cat);
-            db_append_string(&stmt, buf);
-            /* user provides where condition: */
-            if (opt.where->answer) {
-                snprintf(buf, sizeof(buf), " AND %s", opt.where->answer);
-                db_append_string(&stmt, buf);
             }
-            G_debug(3, "%s", db_get_string(&stmt));
+            db_set_value_int(db_get_bulk_param(&bulk, nmaps), cache[point].cat);
 
             /* Update table */
-            if (db_execute_immediate(driver, &stmt) == DB_OK) {
-                update_cnt++;
-            }
-            else {
-                upderr_cnt++;
-            }
+            db_add_bulk_row(&bulk);
         }
+        db_close_bulk(&bulk);
+        update_cnt = bulk.n_ok;
+        upderr_cnt = bulk.n_failed;
         G_percent(1, 1, 1);
 
         G_debug(1, "Committing DB transaction");
         db_commit_transaction(driver);
 
+        G_free(ctype);
         G_free(catexst);
         db_close_database_shutdown_driver(driver);
         db_free_string(&stmt);
     }
 
+    G_free(values);
+
     /* Report */
     G_verbose_message(_("%d categories loaded from vector"), point_cnt);
     if (dupl_cnt > 0)
@@ -0,0 +1,256 @@
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* rows of one raster map kept by one thread: the current row and with
+   interpolation also the previous and the next one */
+struct rows {
+    int row[3];
+    DCELL *buf[3];
+};
+
+/* get raster row, reading it only if not already kept */
+static DCELL *get_row(int fd, struct rows *rows, int row,
+                      const struct Cell_head *window)
+{
+    int i, oldest;
+
+    if (row < 0 || row >= window->rows)
+        return NULL;
+
+    oldest = 0;
+    for (i = 0; i < 3; i++) {
+        if (rows->row[i] == row)
+            return rows->buf[i];
+        /* rows are visited in increasing order, replace the lowest one */
+        if (rows->row[i] < rows->row[oldest])
+            oldest = i;
+    }
+
+    Rast_get_d_row(fd, rows->buf[oldest], row);
+    rows->row[oldest] = row;
+
+    return rows->buf[oldest];
+}
+
+/* value of cell, NULL outside of region */
+static void get_cell(DCELL *buf, int col, int cols, DCELL *val)
+{
+    if (buf == NULL || col < 0 || col >= cols)
+        Rast_set_d_null_value(val, 1);
+    else
+        *val = buf[col];
+}
+
+/* four-way IDW */
+static DCELL interpolate(const struct order *point, DCELL *prev, DCELL *cur,
+                         DCELL *next, const struct Cell_head *window)
+{
+    double distance[4], weight, weightsum, valweight;
+    double east, north;
+    DCELL nearby[4], result;
+    int col_offset, row_offset, i;
+
+    east = Rast_col_to_easting(point->col, window) + window->ew_res / 2;
+    north = Rast_row_to_northing(point->row, window) - window->ns_res / 2;
+
+    col_offset = point->x < east ? -1 : +1;
+    row_offset = point->y > north ? -1 : +1;
+
+    distance[0] = G_distance(point->x, point->y, east, north);
+
+    /* avoid infinite weights */
+    if (distance[0] < GRASS_EPSILON)
+        return cur[point->col];
+
+    distance[1] = G_distance(point->x, point->y,
+                             east + col_offset * window->ew_res, north);
+    distance[2] = G_distance(point->x, point->y,
+                             east + col_offset * window->ew_res,
+                             north - row_offset * window->ns_res);
+    distance[3] = G_distance(point->x, point->y, east,
+                             north - row_offset * window->ns_res);
+
+    get_cell(cur, point->col, window->cols, &nearby[0]);
+    get_cell(cur, point->col + col_offset, window->cols, &nearby[1]);
+    get_cell(row_offset == -1 ? prev : next, point->col + col_offset,
+             window->cols, &nearby[2]);
+    get_cell(row_offset == -1 ? prev : next, point->col, window->cols,
+             &nearby[3]);
+
+    weightsum = valweight = 0;
+    for (i = 0; i < 4; i++) {
+        if (!Rast_is_d_null_value(&nearby[i])) {
+            weight = 1.0 / (distance[i] * distance[i]);
+            weightsum += weight;
+            valweight += weight * nearby[i];
+        }
+    }
+
+    if (weightsum == 0)
+        Rast_set_d_null_value(&result, 1);
+    else
+        result = valweight / weightsum;
+
+    return result;
+}
+
+/* number of threads for which all raster maps can be kept open, each
+   thread opens every map and an open map may use two file descriptors
+   (data and null file) */
+static int max_threads(int nmaps, int nprocs)
+{
+#ifndef _WIN32
+    struct rlimit lim;
+    rlim_t per_thread, avail;
+    int n;
+
+    if (nprocs == 1 || getrlimit(RLIMIT_NOFILE, &lim) != 0 ||
+        lim.rlim_cur == RLIM_INFINITY)
+        return nprocs;
+
+    /* keep some descriptors for vector map, database driver and stdio */
+    if (lim.rlim_cur <= 64)
+        return 1;
+    avail = lim.rlim_cur - 64;
+    per_thread = 2 * (rlim_t)nmaps;
+    n = avail / per_thread < (rlim_t)nprocs ? (int)(avail / per_thread)
+                                            : nprocs;
+    if (n < 1)
+        n = 1;
+    if (n < nprocs)
+        G_warning(_("Number of threads reduced from %d to %d to stay within "
+                    "the limit of %d open files"),
+                  nprocs, n, (int)lim.rlim_cur);
+
+    return n;
+#else
+    return nprocs;
+#endif
+}
+
+/*!
+   \brief Sample raster maps at points
+
+   Points must be sorted by row. The rows are split among threads in
+   contiguous blocks, each thread reads the rows of its block in
+   increasing order with its own file descriptors, so that every row is
+   read once (up to the rows shared by neighbouring blocks when
+   interpolating). The number of threads is reduced if the maps opened
+   by all threads would exceed the limit of open files.
+
+   \param cache points sorted by row
+   \param point_cnt number of points
+   \param rmaps raster maps to be sampled
+   \param nmaps number of raster maps
+   \param window current region
+   \param interp interpolate from the nearest four cells
+   \param nprocs number of threads
+   \param[out] values sampled values, values[point * nmaps + map]
+ */
+void sample_rasters(struct order *cache, int point_cnt, struct rmap *rmaps,
+                    int nmaps, const struct Cell_head *window, int interp,
+                    int nprocs, DCELL *values)
+{
+    int *first, ngroups, done;
+    int *fd;
+    int i, t;
+
+    /* group points by row */
+    first = G_malloc((point_cnt + 1) * sizeof(int));
+    ngroups = 0;
+    for (i = 0; i < point_cnt; i++) {
+        if (i == 0 || cache[i].row != cache[i - 1].row)
+            first[ngroups++] = i;
+    }
+    first[ngroups] = point_cnt;
+
+    nprocs = max_threads(nmaps, nprocs);
+
+    /* opening raster maps is not thread-safe */
+    fd = G_malloc(nprocs * nmaps * sizeof(int));
+    for (t = 0; t < nprocs; t++) {
+        for (i = 0; i < nmaps; i++)
+            fd[t * nmaps + i] = Rast_open_old(rmaps[i].name, "");
+    }
+
+    done = 0;
+
+#pragma omp parallel num_threads(nprocs) if (nprocs > 1)
+    {
+        int t_id = 0;
+        int g, p, m, k;
+        struct rows *rows;
+        DCELL *prev, *cur, *next;
+
+#if defined(_OPENMP)
+        t_id = omp_get_thread_num();
+#endif
+        rows = G_malloc(nmaps * sizeof(struct rows));
+        for (m = 0; m < nmaps; m++) {
+            for (k = 0; k < 3; k++) {
+                rows[m].row[k] = -1;
+                rows[m].buf[k] = Rast_allocate_d_buf();
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (g = 0; g < ngroups; g++) {
+            int row = cache[first[g]].row;
+
+            for (m = 0; m < nmaps; m++) {
+                int mfd = fd[t_id * nmaps + m];
+
+                prev = next = NULL;
+                if (interp)
+                    prev = get_row(mfd, &rows[m], row - 1, window);
+                cur = get_row(mfd, &rows[m], row, window);
+                if (interp)
+                    next = get_row(mfd, &rows[m], row + 1, window);
+
+                for (p = first[g]; p < first[g + 1]; p++) {
+                    DCELL *val = &values[(size_t)p * nmaps + m];
+
+                    if (cache[p].count > 1) /* duplicate cats */
+                        Rast_set_d_null_value(val, 1);
+                    else if (!interp)
+                        *val = cur[cache[p].col];
+                    else {
+                        *val = interpolate(&cache[p], prev, cur, next, window);
+                        /* integer maps give integer values */
+                        if (rmaps[m].type == CELL_TYPE &&
+                            !Rast_is_d_null_value(val))
+                            *val = (CELL)*val;
+                    }
+                }
+            }
+
+            if (t_id == 0)
+                G_percent(done, ngroups, 2);
+#pragma omp atomic update
+            done++;
+        }
+
+        for (m = 0; m < nmaps; m++) {
+            for (k = 0; k < 3; k++)
+                G_free(rows[m].buf[k]);
+        }
+        G_free(rows);
+    }
+    G_percent(1, 1, 1);
+
+    for (t = 0; t < nprocs; t++) {
+        for (i = 0; i < nmaps; i++)
+            Rast_close(fd[t * nmaps + i]);
+    }
+    G_free(fd);
+    G_free(first);
+}
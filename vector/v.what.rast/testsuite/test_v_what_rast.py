@@ -0,0 +1,100 @@
+"""
+Name:       v.what.rast test
+Purpose:    Tests sampling of several raster maps with v.what.rast,
+            serial and in parallel.
+
+Author:     GRASS Development Team
+Copyright:  (C) 2026 by the GRASS Development Team
+Licence:    This program is free software under the GNU General Public
+            License (>=v2). Read the file COPYING that comes with GRASS
+            for details.
+"""
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+from grass.gunittest.gmodules import SimpleModule
+
+RASTERS = ["elevation", "aspect", "landclass96"]
+
+
+class TestVWhatRast(TestCase):
+    points = "test_v_what_rast_points"
+    copies = ["test_v_what_rast_serial", "test_v_what_rast_parallel"]
+    columns = ["elev", "asp", "land"]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", raster="elevation")
+        cls.runModule(
+            "v.random", output=cls.points, npoints=2000, seed=1, overwrite=True
+        )
+        for name in cls.copies:
+            cls.runModule("g.copy", vector=(cls.points, name), overwrite=True)
+            cls.runModule(
+                "v.db.addtable",
+                map=name,
+                columns="elev double precision, asp double precision, land integer",
+            )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.runModule(
+            "g.remove", flags="f", type="vector", name=[cls.points, *cls.copies]
+        )
+        cls.del_temp_region()
+
+    def sample(self, nprocs, flags="p", raster=RASTERS):
+        module = SimpleModule(
+            "v.what.rast",
+            map=self.points,
+            raster=raster,
+            flags=flags,
+            nprocs=nprocs,
+        )
+        self.assertModule(module)
+        return module.outputs.stdout
+
+    def test_parallel_print(self):
+        """Several rasters with nprocs>1 give the same values as nprocs=1"""
+        serial = self.sample(nprocs=1)
+        self.assertEqual(len(serial.splitlines()), 2000)
+        self.assertEqual(self.sample(nprocs=4), serial)
+
+    def test_parallel_interpolation(self):
+        """Interpolated values with nprocs>1 equal nprocs=1"""
+        self.assertEqual(
+            self.sample(nprocs=4, flags="pi"), self.sample(nprocs=1, flags="pi")
+        )
+
+    def test_multiple_as_single(self):
+        """Each map sampled together with others equals the map sampled alone"""
+        rows = [line.split("|") for line in self.sample(nprocs=4).splitlines()]
+        for i, raster in enumerate(RASTERS):
+            single = [
+                line.split("|")
+                for line in self.sample(nprocs=1, raster=raster).splitlines()
+            ]
+            self.assertEqual([row[i + 1] for row in rows], [row[1] for row in single])
+
+    def test_parallel_update(self):
+        """Columns updated with nprocs>1 equal columns updated with nprocs=1"""
+        tables = []
+        for name, nprocs in zip(self.copies, (1, 4)):
+            self.assertModule(
+                "v.what.rast",
+                map=name,
+                raster=RASTERS,
+                column=self.columns,
+                nprocs=nprocs,
+            )
+            select = SimpleModule(
+                "v.db.select", map=name, columns=["cat", *self.columns]
+            )
+            self.assertModule(select)
+            tables.append(select.outputs.stdout)
+        self.assertEqual(tables[1], tables[0])
+
+
+if __name__ == "__main__":
+    test()